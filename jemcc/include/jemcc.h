@@ -2438,6 +2438,67 @@ JNIEXPORT void JNICALL JEMCC_ReleaseZipFileEntry(JNIEnv *env,
                                                  JEMCC_ZipFile *zipFile,
                                                  JEMCC_ZipFileEntry *zipEntry);
 
+/**
+ * Callback method to enumerate the entries of a directory within a Zip
+ * file.  The provided entry is released when the callback returns (the
+ * entry contents may be read or streamed during the callback).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance which is being scanned
+ *     zipEntry - the currently scanned entry of the directory
+ *     userData - the caller provided information attached to the scan
+ *                request
+ *
+ * Returns:
+ *     JNI_OK - continue with scanning of the directory
+ *     JNI_ERR - terminate scanning of the directory
+ */
+typedef jint (*JEMCC_ZipEntryScanCB)(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                                     JEMCC_ZipFileEntry *zipEntry,
+                                     void *userData);
+
+/**
+ * Scan the entries which are contained within a specific directory of an
+ * open Zip/Jar file (not including the entries of subdirectories).  Uses
+ * a directory index, so the cost is proportional to the number of entries
+ * in the directory and not the size of the archive (supports resource
+ * and package enumeration).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance to be scanned
+ *     dirName - the name of the directory to scan, including the trailing
+ *               separator (e.g. "java/lang/"), or "" for the root directory
+ *     entryCB - a function reference which is called for each entry in the
+ *               directory
+ *     userData - a caller provided data set which is included in the
+ *                scan arguments
+ *     quietMode - if JNI_TRUE, no exceptions other than OutOfMemory will
+ *                 be thrown (used for classloaders, etc.)
+ *
+ * Returns:
+ *     JNI_OK - the directory was found and the entries were scanned
+ *     JNI_ERR - an error occurred reading/parsing the Zip file directory
+ *               (an exception will have been thrown in the current
+ *               environment if quietMode is false)
+ *     JNI_ENOMEM - an memory allocation failed and an OutOfMemoryError has
+ *                  been thrown in the current environment
+ *     JNI_EINVAL - no entries exist in the requested directory
+ *
+ * Exceptions
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     OutOfMemoryError - a memory allocation for the file structures failed
+ */
+JNIEXPORT jint JNICALL JEMCC_ScanZipFileDirectory(JNIEnv *env,
+                                                  JEMCC_ZipFile *zipFile,
+                                                  const char *dirName,
+                                                  JEMCC_ZipEntryScanCB entryCB,
+                                                  void *userData,
+                                                  jboolean quietMode);
+
 /**
  * Load the contents of a Zip file entry (fully inflated if required).
  * NOTE: this method does not allow for exception suppression - if a Zip
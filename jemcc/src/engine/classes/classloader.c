@@ -297,7 +297,7 @@ fprintf(stderr, "DEFINING CLASS offset %i length %i\n", offset, length);
 /* TODO CHECK ARRAY REGION */
     /* Pretty straightforward: parse it, check the name and link it! */
     pData = JEM_ParseClassData(env, ((jbyte *) byteArray->arrayData) + offset,
-                               length);
+                               length, JNI_FALSE);
     if (pData == NULL) return JEMCC_ERR;
     retClass = JEM_DefineAndResolveClass(env, (JEMCC_Object *) thisObj, pData);
     if (retClass == NULL) return JEMCC_ERR;
@@ -78,6 +78,7 @@ static jint JEMCC_ArrayIndexOutOfBoundsException_init_String(JNIEnv *env,
 
     /* Store the message locally */
     data->message = msgObj;
+    JEMCC_MarkNonLocalObject(env, msgObj);
 
     return rc;
 }
@@ -152,6 +153,7 @@ static jint JEMCC_StringIndexOutOfBoundsException_init_String(JNIEnv *env,
 
     /* Store the message locally */
     data->message = msgObj;
+    JEMCC_MarkNonLocalObject(env, msgObj);
 
     return rc;
 }
@@ -205,6 +207,7 @@ static jint JEMCC_ExceptionInInitializerError_init_String(JNIEnv *env,
 
     /* Store the message locally */
     data->message = msgObj;
+    JEMCC_MarkNonLocalObject(env, msgObj);
 
     return rc;
 }
@@ -223,7 +226,9 @@ static jint JEMCC_ExceptionInInitializerError_init_Throwable(JNIEnv *env,
 
     /* Add the local details */
     data->message = cData->message;
+    JEMCC_MarkNonLocalObject(env, cData->message);
     data->causeThrowable = (JEMCC_Object *) cause;
+    JEMCC_MarkNonLocalObject(env, (JEMCC_Object *) cause);
 
     return rc;
 }
@@ -315,7 +315,10 @@ extern JEMCC_MethodData JEMCC_RunnableMethods[];
 extern JEMCC_MethodData JEMCC_ClassLoaderMethods[];
 extern JEMCC_FieldData JEMCC_ClassLoaderFields[];
 extern JEMCC_MethodData JEMCC_StringMethods[];
+extern JEMCC_ObjMgmtFn JEMCC_StringObjMgmtFn;
 extern JEMCC_MethodData JEMCC_StringBufferMethods[];
+extern JEMCC_ObjMgmtFn JEMCC_StringBufferObjMgmtFn;
+extern JEM_GCScanFn JEMCC_StringBufferGCScanFn;
 
 extern JEMCC_MethodData JEMCC_ThrowableMethods[];
 extern JEMCC_FieldData JEMCC_ThrowableFields[];
@@ -337,6 +340,7 @@ static jint JEM_InitializeSystemClasses(JNIEnv *env) {
     JEMCC_Class *indexOutOfBoundsExceptionClass;
     JEMCC_Class *linkageErrorClass, *incClassChangeErrorClass;
     JEMCC_Class *vmErrorClass, *classFormatErrorClass;
+    JEMCC_Class *stringBufferClass;
     jint rc;
 
     /* Interfaces */
@@ -366,7 +370,8 @@ static jint JEM_InitializeSystemClasses(JNIEnv *env) {
                               ACC_PUBLIC | ACC_FINAL | ACC_NATIVE_DATA,
                               "java.lang.String",
                               objectClass, interfaces, 1,
-                              JEMCC_StringMethods, 66, NULL,
+                              JEMCC_StringMethods, 66,
+                              &JEMCC_StringObjMgmtFn,
                               NULL, 0, NULL, 0, NULL, 
                               &(JVM_CLASS(JEMCC_Class_String)));
     if (rc != JNI_OK) return rc;
@@ -376,9 +381,11 @@ static jint JEM_InitializeSystemClasses(JNIEnv *env) {
                               ACC_PUBLIC | ACC_FINAL | ACC_NATIVE_DATA,
                               "java.lang.StringBuffer",
                               objectClass, interfaces, 1,
-                              JEMCC_StringBufferMethods, 43, NULL,
-                              NULL, 0, NULL, 0, NULL, NULL);
+                              JEMCC_StringBufferMethods, 43,
+                              &JEMCC_StringBufferObjMgmtFn,
+                              NULL, 0, NULL, 0, NULL, &stringBufferClass);
     if (rc != JNI_OK) return rc;
+    stringBufferClass->classData->gcScanFn = JEMCC_StringBufferGCScanFn;
 
     /* Throwables/Errors/Exceptions */
 
@@ -704,6 +711,7 @@ static jint JEM_InitializeCoreInstances(JNIEnv *env) {
         return JNI_ENOMEM;
     }
     jvm->systemClassLoader = sysClassLoaderInst;
+    JEMCC_MarkNonLocalObject(env, sysClassLoaderInst);
 
     return JNI_OK;
 }
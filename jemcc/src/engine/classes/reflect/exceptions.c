@@ -59,6 +59,7 @@ static jint JEMCC_InvocationTargetException_init_Throwable(JNIEnv *env,
 
     /* Add the local details */
     data->causeThrowable = exObj;
+    JEMCC_MarkNonLocalObject(env, exObj);
 
     return rc;
 }
@@ -77,7 +78,9 @@ static jint JEMCC_InvocationTargetException_init_ThrowableString(JNIEnv *env,
 
     /* Add the local details */
     data->message = msgObj;
+    JEMCC_MarkNonLocalObject(env, msgObj);
     data->causeThrowable = exObj;
+    JEMCC_MarkNonLocalObject(env, exObj);
 
     return rc;
 }
@@ -28,6 +28,15 @@
 #include "jnifunc.h"
 #include "numerics.h"
 
+/**
+ * Sealed segment of a large StringBuffer (see below).  Each chunk retains
+ * its own ASCII/Unicode representation, per the StringData convention.
+ */
+typedef struct StringBufferChunk {
+    struct StringBufferChunk *next;
+    JEMCC_StringData *strData;
+} StringBufferChunk;
+
 /**
  * Structure used to contain StringBuffer working data (in the object
  * attachment record).  The capacity reflects the number of ASCII or
@@ -36,6 +45,12 @@
  * The length indicates the number of characters currently in the buffer,
  * according to the StringData convention (negative indicates pure ASCII
  * data in the buffer).
+ *
+ * Large buffers are extended by sealing the current buffer onto the
+ * chunk list and starting a new one, rather than copying (or widening)
+ * the entire contents.  In this case, the buffer contents are the chunks
+ * in order followed by the (always local) working buffer, which is
+ * flattened back into a single buffer when shared or modified in place.
  */
 typedef struct StringBufferData {
     jsize capacity;
@@ -44,6 +59,10 @@ typedef struct StringBufferData {
         JEMCC_ObjectExt *strInst;
         JEMCC_StringData *strData;
     } buffer;
+
+    StringBufferChunk *chunkHead, *chunkTail;
+    jsize chunkLength;
+    jboolean chunkUnicode;
 } StringBufferData;
 
 static jint JEMCC_String_init(JNIEnv *env,
@@ -179,9 +198,15 @@ static jint JEMCC_String_charAt_I(JNIEnv *env,
 static jint JEMCC_String_compareTo_String(JNIEnv *env,
                                           JEMCC_VMFrame *frame,
                                           JEMCC_ReturnValue *retVal) {
-    JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_Throwable,
-                               NULL, "TODO - not implemented");
-    return JEMCC_ERR;
+    JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
+    JEMCC_StringData *strData = (JEMCC_StringData *) thisObj->objectData;
+    JEMCC_ObjectExt *strObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 1);
+
+    /* Compare and return the result */
+    if (strObj == NULL) return JEMCC_NULL_EXCEPTION;
+    retVal->intVal = JEM_StringCompare(strData, (JEMCC_StringData *)
+                                                   strObj->objectData);
+    return JEMCC_RET_INT;
 }
 
 static jint JEMCC_String_concat_String(JNIEnv *env,
@@ -661,6 +686,21 @@ static jint JEMCC_String_valueOf_CharArrayII(JNIEnv *env,
     return JEMCC_ERR;
 }
 
+/**
+ * Object management method for String instances, which own their (native)
+ * string data.
+ */
+static jint JEMCC_String_ObjMgmt(JNIEnv *env, jint action,
+                                 JEMCC_Object *obj,
+                                 JEMCC_Object *exObj) {
+    if (action != JEMCC_OM_GC_COLLECT) return JNI_EINVAL;
+
+    JEMCC_Free(((JEMCC_ObjectExt *) obj)->objectData);
+    return JNI_OK;
+}
+
+JEMCC_ObjMgmtFn JEMCC_StringObjMgmtFn = JEMCC_String_ObjMgmt;
+
 JEMCC_MethodData JEMCC_StringMethods[] = {
     { ACC_PUBLIC,
          "<init>", "()V",
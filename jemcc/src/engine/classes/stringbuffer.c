@@ -26,6 +26,15 @@
 
 #define STRINGBUFFER_DEFAULT_SIZE 16
 
+/* Buffers beyond this (character) length are extended by chunks */
+#define STRINGBUFFER_CHUNK_SIZE 65536
+
+/* Upper limits on the decimal text length of the numerics (with sign/NUL) */
+#define INT_TEXT_LENGTH 12
+#define LONG_TEXT_LENGTH 21
+#define FLOAT_TEXT_LENGTH 16
+#define DOUBLE_TEXT_LENGTH 25
+
 #define BUFFER_LENGTH(data) \
     (((data)->capacity < 0) ? \
         ((JEMCC_StringData *) ((data)->buffer.strInst->objectData))->length : \
@@ -98,6 +107,7 @@ static jint JEMCC_StringBuffer_init_String(JNIEnv *env,
     data = (StringBufferData *) thisObj->objectData;
     if (data == NULL) return JEMCC_ERR;
 
+    JEMCC_MarkNonLocalObject(env, (JEMCC_Object *) strVal);
     data->buffer.strInst = strVal;
     data->capacity = ((strLen > 0) ? -strLen : strLen) -
                              STRINGBUFFER_DEFAULT_SIZE; /* Add as per JLS */
@@ -121,8 +131,6 @@ static jint StringBuffer_EnsureCapacity(JNIEnv *env, StringBufferData *data,
     JEMCC_StringData *strData, *origStrData;
     unsigned int strDataSize, charLen = (expandAscii == JNI_TRUE) ? 2 : 1;
     jint bufferLen = BUFFER_LENGTH(data);
-    jchar *jptr;
-    char *ptr;
 
     /* StringBuffer javadoc indicates this unique sizing rule */
     newCapacity = 2 * abs(oldCapacity) + 2;
@@ -136,8 +144,8 @@ static jint StringBuffer_EnsureCapacity(JNIEnv *env, StringBufferData *data,
     if ((expandAscii == JNI_TRUE) || (data->capacity < 0)) {
         /* ASCII-Unicode expansion or currently sharing dataspace */
         /* Force reallocation, resizing only if required */
-        if (requestedCapacity <= oldCapacity) {
-            newCapacity = oldCapacity;
+        if (requestedCapacity <= abs(oldCapacity)) {
+            newCapacity = abs(oldCapacity);
         }
     } else {
         /* Do nothing if sufficient room (capacity -ve for shared copy) */
@@ -162,9 +170,8 @@ static jint StringBuffer_EnsureCapacity(JNIEnv *env, StringBufferData *data,
                           sizeof(JEMCC_StringData) + 
                                     ((unsigned int) abs(bufferLen)) * charLen);
         } else {
-            ptr = (char *) &(origStrData->data);
-            jptr = (jchar *) &(strData->data);
-            while (*ptr != '\0') *(jptr++) = (jchar) *(ptr++);
+            JEM_StrWiden((jchar *) &(strData->data),
+                         (jubyte *) &(origStrData->data), -bufferLen);
             strData->length = -bufferLen;
         }
     } else {
@@ -173,9 +180,8 @@ static jint StringBuffer_EnsureCapacity(JNIEnv *env, StringBufferData *data,
                           sizeof(JEMCC_StringData) + 
                                     ((unsigned int) abs(bufferLen)) * charLen);
         } else {
-            ptr = (char *) &(data->buffer.strData->data);
-            jptr = (jchar *) &(strData->data);
-            while (*ptr != '\0') *(jptr++) = (jchar) *(ptr++);
+            JEM_StrWiden((jchar *) &(strData->data),
+                         (jubyte *) &(data->buffer.strData->data), -bufferLen);
             strData->length = -bufferLen;
         }
         JEMCC_Free(data->buffer.strData);
@@ -186,11 +192,149 @@ static jint StringBuffer_EnsureCapacity(JNIEnv *env, StringBufferData *data,
     return JNI_OK;
 }
 
+/**
+ * Convenience method to start a new working buffer for a large StringBuffer,
+ * when the pending append would otherwise require the reallocation (and
+ * copy or Unicode expansion) of the entire current buffer.  The current
+ * buffer is sealed onto the chunk list as is and the new buffer is sized
+ * for at least one chunk.  Returns JNI_OK (whether or not the buffer was
+ * split) or JNI_ENOMEM if the new buffer could not be allocated.
+ *
+ * NOTE: This method is not synchronized - all callers must be (most are
+ *       through the method definition)
+ */
+static jint StringBuffer_SealBuffer(JNIEnv *env, StringBufferData *data,
+                                    jint txtLen) {
+    jint bufferLen, absLen, newCapacity = abs(txtLen);
+    StringBufferChunk *chunk;
+    JEMCC_StringData *strData;
+
+    /* Only split local buffers which are large enough to be worth it */
+    if (data->capacity < 0) return JNI_OK;
+    bufferLen = data->buffer.strData->length;
+    absLen = abs(bufferLen);
+    if (absLen < STRINGBUFFER_CHUNK_SIZE) return JNI_OK;
+    if ((absLen + abs(txtLen) <= data->capacity) &&
+            ((bufferLen > 0) || (txtLen <= 0))) return JNI_OK;
+
+    /* Allocate everything before making any changes */
+    if (newCapacity < STRINGBUFFER_CHUNK_SIZE) {
+        newCapacity = STRINGBUFFER_CHUNK_SIZE;
+    }
+    chunk = (StringBufferChunk *) JEMCC_Malloc(env, sizeof(StringBufferChunk));
+    if (chunk == NULL) return JNI_ENOMEM;
+    strData = (JEMCC_StringData *) JEMCC_Malloc(env,
+                                                sizeof(JEMCC_StringData) +
+                                                newCapacity);
+    if (strData == NULL) {
+        JEMCC_Free(chunk);
+        return JNI_ENOMEM;
+    }
+
+    /* Seal the current buffer and start afresh (as ASCII) */
+    chunk->strData = data->buffer.strData;
+    if (data->chunkTail == NULL) {
+        data->chunkHead = chunk;
+    } else {
+        data->chunkTail->next = chunk;
+    }
+    data->chunkTail = chunk;
+    data->chunkLength += absLen;
+    if (bufferLen > 0) data->chunkUnicode = JNI_TRUE;
+
+    strData->length = 0;
+    data->buffer.strData = strData;
+    data->capacity = newCapacity;
+
+    return JNI_OK;
+}
+
+/**
+ * Convenience method to copy the contents of a buffer chunk into the given
+ * flattened storage area, which is Unicode if indicated (expanding ASCII
+ * chunk data as required).  Returns the location following the copied
+ * characters.
+ */
+static char *StringBuffer_CopyChunk(char *dest, JEMCC_StringData *strData,
+                                    jboolean isUnicode) {
+    jint len = strData->length;
+
+    if (isUnicode == JNI_FALSE) {
+        (void) memcpy(dest, &(strData->data), -len);
+        return dest - len;
+    }
+    if (len <= 0) {
+        JEM_StrWiden((jchar *) dest, (jubyte *) &(strData->data), -len);
+        return (char *) (((jchar *) dest) - len);
+    }
+    (void) memcpy(dest, &(strData->data), len * sizeof(jchar));
+    return (char *) (((jchar *) dest) + len);
+}
+
+/**
+ * Convenience method to reassemble a chunked StringBuffer into a single
+ * working buffer, for sharing with a String or for operations which
+ * modify the contents in place.  Each chunk is copied (or widened) exactly
+ * once.  Returns JNI_OK or JNI_ENOMEM if the flattened buffer could not
+ * be allocated (the chunks are unchanged in this case).
+ *
+ * NOTE: This method is not synchronized - all callers must be (most are
+ *       through the method definition)
+ */
+static jint StringBuffer_Flatten(JNIEnv *env, StringBufferData *data) {
+    JEMCC_StringData *strData, *tailData = data->buffer.strData;
+    jboolean isUnicode = data->chunkUnicode;
+    StringBufferChunk *chunk, *next;
+    unsigned int charLen;
+    jint length;
+    char *ptr;
+
+    /* Nothing to do if not chunked */
+    if (data->chunkHead == NULL) return JNI_OK;
+
+    /* Construct the combined buffer storage area */
+    if (tailData->length > 0) isUnicode = JNI_TRUE;
+    charLen = (isUnicode == JNI_TRUE) ? 2 : 1;
+    length = data->chunkLength + abs(tailData->length);
+    strData = (JEMCC_StringData *) JEMCC_Malloc(env,
+                                       sizeof(JEMCC_StringData) +
+                                       ((unsigned int) length) * charLen);
+    if (strData == NULL) return JNI_ENOMEM;
+
+    /* Copy and release the chunks and working buffer, in order */
+    ptr = &(strData->data);
+    chunk = data->chunkHead;
+    while (chunk != NULL) {
+        ptr = StringBuffer_CopyChunk(ptr, chunk->strData, isUnicode);
+        next = chunk->next;
+        JEMCC_Free(chunk->strData);
+        JEMCC_Free(chunk);
+        chunk = next;
+    }
+    ptr = StringBuffer_CopyChunk(ptr, tailData, isUnicode);
+    JEMCC_Free(tailData);
+    if (isUnicode == JNI_TRUE) {
+        strData->length = length;
+    } else {
+        strData->length = -length;
+        *ptr = '\0';
+    }
+
+    data->buffer.strData = strData;
+    data->capacity = length;
+    data->chunkHead = data->chunkTail = NULL;
+    data->chunkLength = 0;
+    data->chunkUnicode = JNI_FALSE;
+
+    return JNI_OK;
+}
+
 /**
  * Central method to append text to the StringBuffer.  Accepts ASCII (char *)
  * values or Unicode buffers (jchar *), based on the sign of the append
  * length.  Automatically reallocates storage and internally converts
- * from ASCII to Unicode as required.  Returns JNI_OK or JNI_ENOMEM depending
+ * from ASCII to Unicode as required (only the working buffer of a chunked
+ * StringBuffer is converted).  Returns JNI_OK or JNI_ENOMEM depending
  * on the results of the expansion.
  *
  * NOTE: This method is not synchronized - all callers must be (most are
@@ -199,13 +343,19 @@ static jint StringBuffer_EnsureCapacity(JNIEnv *env, StringBufferData *data,
 static jint StringBuffer_Append(JNIEnv *env, StringBufferData *data,
                                 char *text, jint txtLen, jboolean fromJChar) {
     jchar *jptr, *jstr = (jchar *) text;
-    char *ptr, *str = text;
+    char *ptr;
     jint newLen, bufferLen = BUFFER_LENGTH(data);
     jboolean expandAscii = JNI_FALSE;
 
     /* Quick exit */
     if (txtLen == 0) return JNI_OK;
 
+    /* Large buffers start a new chunk instead of copying everything */
+    if (StringBuffer_SealBuffer(env, data, txtLen) != JNI_OK) {
+        return JNI_ENOMEM;
+    }
+    bufferLen = BUFFER_LENGTH(data);
+
     /* Perform the expansion (as required), with sign corrections */
     if (bufferLen <= 0) {
         newLen = -bufferLen;
@@ -230,56 +380,83 @@ static jint StringBuffer_Append(JNIEnv *env, StringBufferData *data,
             ptr = &(data->buffer.strData->data) - bufferLen;
             data->buffer.strData->length = -newLen;
             if (fromJChar == JNI_FALSE) {
-                while (txtLen < 0) {
-                    *(ptr++) = *(str++);
-                    txtLen++;
-                }
+                (void) memcpy(ptr, text, -txtLen);
             } else {
-                while (txtLen < 0) {
-                    *(ptr++) = (char) *(jstr++);
-                    txtLen++;
-                }
+                JEM_StrNarrow((jubyte *) ptr, jstr, -txtLen);
             }
-            *ptr = '\0';
+            ptr[-txtLen] = '\0';
         } else {
             /* Unicode addition (conversion occurred above) */
             jptr = ((jchar *) &(data->buffer.strData->data)) - bufferLen;
             data->buffer.strData->length = newLen;
-            while (txtLen > 0) {
-                *(jptr++) = *(jstr++);
-                txtLen--;
-            }
+            (void) memcpy(jptr, jstr, txtLen * sizeof(jchar));
         }
     } else {
         /* Unicode base, no conversion required */
         data->buffer.strData->length = newLen;
+        jptr = ((jchar *) &(data->buffer.strData->data)) + bufferLen;
         if (txtLen <= 0) {
             /* Append ASCII to Unicode (convert on the fly) */
-            jptr = ((jchar *) &(data->buffer.strData->data)) + bufferLen;
             if (fromJChar == JNI_FALSE) {
-                while (txtLen < 0) {
-                    *(jptr++) = (jchar) *(str++);
-                    txtLen++;
-                }
+                JEM_StrWiden(jptr, (jubyte *) text, -txtLen);
             } else {
-                while (txtLen < 0) {
-                    *(jptr++) = *(jstr++);
-                    txtLen++;
-                }
+                (void) memcpy(jptr, jstr, -txtLen * sizeof(jchar));
             }
         } else {
             /* Simple Unicode addition */
-            jptr = ((jchar *) &(data->buffer.strData->data)) + bufferLen;
-            while (txtLen > 0) {
-                *(jptr++) = *(jstr++);
-                txtLen--;
-            }
+            (void) memcpy(jptr, jstr, txtLen * sizeof(jchar));
         }
     }
 
     return JNI_OK;
 }
 
+/**
+ * Convenience method to obtain the location for the direct formatting of
+ * ASCII (numeric) text onto the end of the StringBuffer, avoiding the
+ * temporary copy.  Ensures that there is room for txtLen characters
+ * (including the terminator) in an ASCII working buffer and returns the
+ * end of the buffer, or the provided scratch buffer if the working buffer
+ * is Unicode.  Returns NULL if a memory allocation failed.  Completed with
+ * StringBuffer_CommitText.
+ *
+ * NOTE: This method is not synchronized - all callers must be (most are
+ *       through the method definition)
+ */
+static char *StringBuffer_ReserveText(JNIEnv *env, StringBufferData *data,
+                                      jint txtLen, char *scratch) {
+    jint bufferLen;
+
+    if (StringBuffer_SealBuffer(env, data, -txtLen) != JNI_OK) return NULL;
+    bufferLen = BUFFER_LENGTH(data);
+    if (bufferLen > 0) return scratch;
+
+    /* Note that the StringData allocation includes the terminator */
+    if (StringBuffer_EnsureCapacity(env, data, txtLen - bufferLen - 1,
+                                    JNI_FALSE) != JNI_OK) return NULL;
+    return &(data->buffer.strData->data) - bufferLen;
+}
+
+/**
+ * Complete the direct append of the ASCII text at the indicated location,
+ * as obtained from StringBuffer_ReserveText.  Returns JNI_OK or JNI_ENOMEM
+ * if the scratch buffer could not be appended to the Unicode buffer.
+ *
+ * NOTE: This method is not synchronized - all callers must be (most are
+ *       through the method definition)
+ */
+static jint StringBuffer_CommitText(JNIEnv *env, StringBufferData *data,
+                                    char *text, char *scratch) {
+    jint txtLen = strlen(text);
+
+    if (text == scratch) {
+        return StringBuffer_Append(env, data, text, -txtLen, JNI_FALSE);
+    }
+    data->buffer.strData->length -= txtLen;
+
+    return JNI_OK;
+}
+
 static jint JEMCC_StringBuffer_append_C(JNIEnv *env,
                                         JEMCC_VMFrame *frame,
                                         JEMCC_ReturnValue *retVal) {
@@ -309,13 +486,15 @@ static jint JEMCC_StringBuffer_append_D(JNIEnv *env,
                                         JEMCC_VMFrame *frame,
                                         JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
+    StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jdouble dval = JEMCC_LOAD_DOUBLE(frame, 1);
-    char dbuff[64];
+    char dbuff[DOUBLE_TEXT_LENGTH], *ptr;
 
-    /* Convert to ASCII text and append */
-    JEMCC_DoubleToText(dval, dbuff);
-    if (StringBuffer_Append(env, (StringBufferData *) thisObj->objectData,
-                            dbuff, -strlen(dbuff), JNI_FALSE) != JNI_OK) {
+    /* Convert to ASCII text directly onto the buffer */
+    ptr = StringBuffer_ReserveText(env, data, DOUBLE_TEXT_LENGTH, dbuff);
+    if (ptr == NULL) return JEMCC_ERR;
+    JEMCC_DoubleToText(dval, ptr);
+    if (StringBuffer_CommitText(env, data, ptr, dbuff) != JNI_OK) {
         return JEMCC_ERR;
     }
 
@@ -328,13 +507,15 @@ static jint JEMCC_StringBuffer_append_F(JNIEnv *env,
                                         JEMCC_VMFrame *frame,
                                         JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
+    StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jdouble fval = JEMCC_LOAD_FLOAT(frame, 1);
-    char fbuff[64];
+    char fbuff[FLOAT_TEXT_LENGTH], *ptr;
 
-    /* Convert to ASCII text and append */
-    JEMCC_FloatToText(fval, fbuff);
-    if (StringBuffer_Append(env, (StringBufferData *) thisObj->objectData,
-                            fbuff, -strlen(fbuff), JNI_FALSE) != JNI_OK) {
+    /* Convert to ASCII text directly onto the buffer */
+    ptr = StringBuffer_ReserveText(env, data, FLOAT_TEXT_LENGTH, fbuff);
+    if (ptr == NULL) return JEMCC_ERR;
+    JEMCC_FloatToText(fval, ptr);
+    if (StringBuffer_CommitText(env, data, ptr, fbuff) != JNI_OK) {
         return JEMCC_ERR;
     }
 
@@ -347,13 +528,15 @@ static jint JEMCC_StringBuffer_append_I(JNIEnv *env,
                                         JEMCC_VMFrame *frame,
                                         JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
+    StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jint ival = JEMCC_LOAD_INT(frame, 1);
-    char ibuff[64];
+    char ibuff[INT_TEXT_LENGTH], *ptr;
 
-    /* Convert to ASCII text and append */
-    JEMCC_IntegerToText(ival, 10, ibuff);
-    if (StringBuffer_Append(env, (StringBufferData *) thisObj->objectData,
-                            ibuff, -strlen(ibuff), JNI_FALSE) != JNI_OK) {
+    /* Convert to ASCII text directly onto the buffer */
+    ptr = StringBuffer_ReserveText(env, data, INT_TEXT_LENGTH, ibuff);
+    if (ptr == NULL) return JEMCC_ERR;
+    JEMCC_IntegerToText(ival, 10, ptr);
+    if (StringBuffer_CommitText(env, data, ptr, ibuff) != JNI_OK) {
         return JEMCC_ERR;
     }
 
@@ -366,13 +549,15 @@ static jint JEMCC_StringBuffer_append_J(JNIEnv *env,
                                         JEMCC_VMFrame *frame,
                                         JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
+    StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jlong lval = JEMCC_LOAD_LONG(frame, 1);
-    char lbuff[64];
+    char lbuff[LONG_TEXT_LENGTH], *ptr;
 
-    /* Convert to ASCII text and append */
-    JEMCC_LongToText(lval, 10, lbuff);
-    if (StringBuffer_Append(env, (StringBufferData *) thisObj->objectData,
-                            lbuff, -strlen(lbuff), JNI_FALSE) != JNI_OK) {
+    /* Convert to ASCII text directly onto the buffer */
+    ptr = StringBuffer_ReserveText(env, data, LONG_TEXT_LENGTH, lbuff);
+    if (ptr == NULL) return JEMCC_ERR;
+    JEMCC_LongToText(lval, 10, ptr);
+    if (StringBuffer_CommitText(env, data, ptr, lbuff) != JNI_OK) {
         return JEMCC_ERR;
     }
 
@@ -480,9 +665,7 @@ static jint JEMCC_StringBuffer_append_CharArray(JNIEnv *env,
                                                 JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
     JEMCC_ArrayObject *arr = (JEMCC_ArrayObject *) JEMCC_LOAD_OBJECT(frame, 1);
-    jboolean isAscii = JNI_TRUE;
-    jchar jch, *jptr;
-    jint i;
+    jboolean isAscii;
 
     /* Make a quick exit where necessary */
     if (arr->arrayLength == 0) {
@@ -491,13 +674,8 @@ static jint JEMCC_StringBuffer_append_CharArray(JNIEnv *env,
     }
 
     /* Determine Unicode/ASCII array status */
-    for (i = 0, jptr = (jchar *) arr->arrayData; i < arr->arrayLength; i++) {
-        jch = *(jptr++);
-        if ((jch == 0) || (jch > 255)) {
-            isAscii = JNI_FALSE;
-            break;
-        }
-    }
+    isAscii = JEMCC_UnicodeStrIsAscii((jchar *) arr->arrayData,
+                                      arr->arrayLength);
 
     /* Make the approprate append */
     if (isAscii == JNI_FALSE) {
@@ -525,9 +703,8 @@ static jint JEMCC_StringBuffer_append_CharArrayII(JNIEnv *env,
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
     JEMCC_ArrayObject *arr = (JEMCC_ArrayObject *) JEMCC_LOAD_OBJECT(frame, 1);
     jint offset = JEMCC_LOAD_INT(frame, 2), len = JEMCC_LOAD_INT(frame, 3);
-    jboolean isAscii = JNI_TRUE;
-    jchar jch, *jptr;
-    jint i;
+    jboolean isAscii;
+    jchar *jptr;
 
     /* Check region and make a quick exit where necessary */
     if (JEMCC_CheckArrayRegion(env, arr, offset, len,
@@ -541,16 +718,9 @@ static jint JEMCC_StringBuffer_append_CharArrayII(JNIEnv *env,
 
     /* Determine Unicode/ASCII array status */
     jptr = ((jchar *) arr->arrayData) + offset;
-    for (i = 0; i < len; i++) {
-        jch = *(jptr++);
-        if ((jch == 0) || (jch > 255)) {
-            isAscii = JNI_FALSE;
-            break;
-        }
-    }
+    isAscii = JEMCC_UnicodeStrIsAscii(jptr, len);
 
     /* Make the approprate append */
-    jptr = ((jchar *) arr->arrayData) + offset;
     if (isAscii == JNI_FALSE) {
         if (StringBuffer_Append(env, (StringBufferData *) thisObj->objectData,
                                 (char *) jptr, len, JNI_FALSE) != JNI_OK) {
@@ -572,9 +742,10 @@ static jint JEMCC_StringBuffer_capacity(JNIEnv *env,
                                         JEMCC_VMFrame *frame,
                                         JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
-    jint cap = ((StringBufferData *) thisObj->objectData)->capacity;
+    StringBufferData *data = (StringBufferData *) thisObj->objectData;
+    jint cap = data->capacity;
 
-    retVal->intVal = (cap < 0) ? -cap : cap;
+    retVal->intVal = ((cap < 0) ? -cap : cap) + data->chunkLength;
     return JEMCC_RET_INT;
 }
 
@@ -584,10 +755,29 @@ static jint JEMCC_StringBuffer_charAt_I(JNIEnv *env,
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
     StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jint index = JEMCC_LOAD_INT(frame, 1);
+    StringBufferChunk *chunk = data->chunkHead;
     JEMCC_StringData *strData;
 
+    /* Locate the containing chunk, flattening to report invalid indices */
+    if (chunk != NULL) {
+        if ((index < 0) ||
+                (index >= data->chunkLength +
+                              abs(data->buffer.strData->length))) {
+            if (StringBuffer_Flatten(env, data) != JNI_OK) return JEMCC_ERR;
+            chunk = NULL;
+        } else {
+            while ((chunk != NULL) &&
+                       (index >= abs(chunk->strData->length))) {
+                index -= abs(chunk->strData->length);
+                chunk = chunk->next;
+            }
+        }
+    }
+
     /* Make the extract from the appropriate location */
-    if (data->capacity < 0) {
+    if (chunk != NULL) {
+        strData = chunk->strData;
+    } else if (data->capacity < 0) {
         strData = (JEMCC_StringData *) data->buffer.strInst->objectData;
     } else {
         strData = data->buffer.strData;
@@ -600,7 +790,7 @@ static jint JEMCC_StringBuffer_charAt_I(JNIEnv *env,
 
     /* Pull the character as requested */
     if (strData->length < 0) {
-        retVal->intVal = (int) *(&(strData->data) + index);
+        retVal->intVal = (int) *(((jubyte *) &(strData->data)) + index);
     } else {
         retVal->intVal = (int) *(((jchar *) &(strData->data)) + index);
     }
@@ -614,27 +804,16 @@ static jint JEMCC_StringBuffer_charAt_I(JNIEnv *env,
  * operation.
  */
 static void StringBuffer_CollapseIfAscii(JEMCC_StringData *strData) {
-    jchar jch, *jptr = (jchar *) &(strData->data);
+    jchar *jptr = (jchar *) &(strData->data);
     jint len = strData->length;
-    char *ptr;
 
     /* Check for remaining Unicode characters */
-    while (len > 0) {
-        jch = *(jptr++);
-        if ((jch == 0) || (jch > 255)) return;
-        len--;
-    }
+    if (JEM_StrFindWideChar(jptr, len) != len) return;
 
-    /* All ASCII, reduce appropriately */
-    jptr = (jchar *) &(strData->data);
-    len = strData->length;
+    /* All ASCII, reduce appropriately (in place) */
     strData->length = -len;
-    ptr = (char *) jptr;
-    while (len > 0) {
-        *(ptr++) = (char) *(jptr++);
-        len--;
-    }
-    *ptr = '\0';
+    JEM_StrNarrow((jubyte *) jptr, jptr, len);
+    *(((char *) jptr) + len) = '\0';
 }
 
 static jint JEMCC_StringBuffer_ensureCapacity_I(JNIEnv *env,
@@ -644,6 +823,9 @@ static jint JEMCC_StringBuffer_ensureCapacity_I(JNIEnv *env,
     StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jint capacity = JEMCC_LOAD_INT(frame, 1);
 
+    /* Chunked buffers are extended without copying, nothing to prepare */
+    if (data->chunkHead != NULL) return JEMCC_RET_VOID;
+
     /* Just do it */
     if (StringBuffer_EnsureCapacity(env, data, capacity, JNI_FALSE) != JNI_OK) {
         return JEMCC_ERR;
@@ -663,6 +845,7 @@ static jint JEMCC_StringBuffer_getChars_IICharArrayI(JNIEnv *env,
     JEMCC_StringData *strData;
 
     /* Make the extract from the appropriate location */
+    if (StringBuffer_Flatten(env, data) != JNI_OK) return JEMCC_ERR;
     if (data->capacity < 0) {
         strData = (JEMCC_StringData *) data->buffer.strInst->objectData;
     } else {
@@ -699,11 +882,15 @@ static jint JEMCC_StringBuffer_getChars_IICharArrayI(JNIEnv *env,
  */
 static jint StringBuffer_Insert(JNIEnv *env, StringBufferData *data, jint index,
                                 char *text, jint txtLen, jboolean fromJChar) {
-    jint newLen, bufferLen = BUFFER_LENGTH(data), absLen, tailLen;
+    jint newLen, bufferLen, absLen, tailLen;
     jchar *jptr, *jstr;
     char msg[128], *ptr, *str;
     jboolean expandAscii = JNI_FALSE;
 
+    /* Inserts are only made against a single buffer */
+    if (StringBuffer_Flatten(env, data) != JNI_OK) return JNI_ENOMEM;
+    bufferLen = BUFFER_LENGTH(data);
+
     /* Capture the quick exit cases and check the insert position */
     if (bufferLen <= 0) {
         absLen = newLen = -bufferLen;
@@ -1019,9 +1206,7 @@ static jint JEMCC_StringBuffer_insert_ICharArray(JNIEnv *env,
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
     jint index = JEMCC_LOAD_INT(frame, 1);
     JEMCC_ArrayObject *arr = (JEMCC_ArrayObject *) JEMCC_LOAD_OBJECT(frame, 2);
-    jboolean isAscii = JNI_TRUE;
-    jchar jch, *jptr;
-    jint i;
+    jboolean isAscii;
 
     /* Make a quick exit where necessary */
     if (arr->arrayLength == 0) {
@@ -1030,13 +1215,8 @@ static jint JEMCC_StringBuffer_insert_ICharArray(JNIEnv *env,
     }
 
     /* Determine Unicode/ASCII array status */
-    for (i = 0, jptr = (jchar *) arr->arrayData; i < arr->arrayLength; i++) {
-        jch = *(jptr++);
-        if ((jch == 0) || (jch > 255)) {
-            isAscii = JNI_FALSE;
-            break;
-        }
-    }
+    isAscii = JEMCC_UnicodeStrIsAscii((jchar *) arr->arrayData,
+                                      arr->arrayLength);
 
     /* Make the approprate insert */
     if (isAscii == JNI_FALSE) {
@@ -1065,7 +1245,7 @@ static jint JEMCC_StringBuffer_length(JNIEnv *env,
     StringBufferData *data = (StringBufferData *) thisObj->objectData;
     jint length = BUFFER_LENGTH(data);
 
-    retVal->intVal = (length < 0) ? -length : length;
+    retVal->intVal = ((length < 0) ? -length : length) + data->chunkLength;
     return JEMCC_RET_INT;
 }
 
@@ -1079,7 +1259,8 @@ static jint JEMCC_StringBuffer_reverse(JNIEnv *env,
     char ch, *ptr, *str;
     jint halfLen;
 
-    /* Ensure that there is a local working buffer */
+    /* Ensure that there is a local (single) working buffer */
+    if (StringBuffer_Flatten(env, data) != JNI_OK) return JEMCC_ERR;
     if (data->capacity < 0) {
         if (StringBuffer_EnsureCapacity(env, data, -data->capacity,
                                         JNI_FALSE) != JNI_OK) return JEMCC_ERR;
@@ -1119,11 +1300,15 @@ static jint JEMCC_StringBuffer_setCharAt_IC(JNIEnv *env,
                                             JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
     StringBufferData *data = (StringBufferData *) thisObj->objectData;
-    jint bufferLen = BUFFER_LENGTH(data), index = JEMCC_LOAD_INT(frame, 1);
+    jint bufferLen, index = JEMCC_LOAD_INT(frame, 1);
     jchar jch = (jchar) JEMCC_LOAD_INT(frame, 2);
     jboolean expAscii = JNI_FALSE;
     JEMCC_StringData *strData;
 
+    /* Changes are only made against a single buffer */
+    if (StringBuffer_Flatten(env, data) != JNI_OK) return JEMCC_ERR;
+    bufferLen = BUFFER_LENGTH(data);
+
     /* May need to convert to Unicode */
     if ((bufferLen < 0) && ((jch == 0) || (jch > 255))) expAscii = JNI_TRUE;
 
@@ -1159,7 +1344,7 @@ static jint JEMCC_StringBuffer_setLength_I(JNIEnv *env,
                                            JEMCC_ReturnValue *retVal) {
     JEMCC_ObjectExt *thisObj = (JEMCC_ObjectExt *) JEMCC_LOAD_OBJECT(frame, 0);
     StringBufferData *data = (StringBufferData *) thisObj->objectData;
-    jint bufferLen = BUFFER_LENGTH(data), newLen = JEMCC_LOAD_INT(frame, 1);
+    jint bufferLen, newLen = JEMCC_LOAD_INT(frame, 1);
     jboolean expAscii = JNI_FALSE;
     JEMCC_StringData *strData;
     jchar *jptr;
@@ -1172,6 +1357,10 @@ static jint JEMCC_StringBuffer_setLength_I(JNIEnv *env,
         return JEMCC_ERR;
     }
 
+    /* Changes are only made against a single buffer */
+    if (StringBuffer_Flatten(env, data) != JNI_OK) return JEMCC_ERR;
+    bufferLen = BUFFER_LENGTH(data);
+
     /* May need to convert to Unicode (bigger length) */
     if ((bufferLen < 0) && ((-bufferLen) < newLen)) expAscii = JNI_TRUE;
 
@@ -1215,6 +1404,9 @@ static jint JEMCC_StringBuffer_toString(JNIEnv *env,
         /* Already converted to a string value, return it */
         retVal->objVal = (JEMCC_Object *) data->buffer.strInst;
     } else {
+        /* Reassemble chunked contents (the String shares a single buffer) */
+        if (StringBuffer_Flatten(env, data) != JNI_OK) return JEMCC_ERR;
+
         /* Create the returned string instance and assign local buffer ref */
         retStr = (JEMCC_ObjectExt *) JEMCC_AllocateObjectIdx(env,
                                                              JEMCC_Class_String,
@@ -1222,7 +1414,9 @@ static jint JEMCC_StringBuffer_toString(JNIEnv *env,
         if (retStr == NULL) return JEMCC_ERR;
         retStr->objectData = data->buffer.strData;
 
-        /* Mark the local buffer as a shared String copy */
+        /* Mark the local buffer as a shared String copy (the String must */
+        /* outlive the frame region, as the buffer may escape it) */
+        JEMCC_MarkNonLocalObject(env, (JEMCC_Object *) retStr);
         data->capacity = -data->capacity;
         data->buffer.strInst = retStr;
 
@@ -1233,6 +1427,47 @@ static jint JEMCC_StringBuffer_toString(JNIEnv *env,
     return JEMCC_RET_OBJECT;
 }
 
+/**
+ * Object management method for StringBuffer instances, releasing the chunks
+ * and working buffer (unless it is shared with a String, which owns it).
+ */
+static jint JEMCC_StringBuffer_ObjMgmt(JNIEnv *env, jint action,
+                                       JEMCC_Object *obj,
+                                       JEMCC_Object *exObj) {
+    StringBufferData *data = (StringBufferData *)
+                                     ((JEMCC_ObjectExt *) obj)->objectData;
+    StringBufferChunk *chunk, *next;
+
+    if (action != JEMCC_OM_GC_COLLECT) return JNI_EINVAL;
+
+    chunk = data->chunkHead;
+    while (chunk != NULL) {
+        next = chunk->next;
+        JEMCC_Free(chunk->strData);
+        JEMCC_Free(chunk);
+        chunk = next;
+    }
+    if (data->capacity >= 0) JEMCC_Free(data->buffer.strData);
+    JEMCC_Free(data);
+
+    return JNI_OK;
+}
+
+JEMCC_ObjMgmtFn JEMCC_StringBufferObjMgmtFn = JEMCC_StringBuffer_ObjMgmt;
+
+static void JEMCC_StringBuffer_GCScan(JEMCC_Object *obj, JEM_GCMarkFn markFn,
+                                      void *markData) {
+    StringBufferData *data = (StringBufferData *)
+                                     ((JEMCC_ObjectExt *) obj)->objectData;
+
+    /* Only a shared buffer (negative capacity) references a String */
+    if ((data != NULL) && (data->capacity < 0)) {
+        (*markFn)(markData, (JEMCC_Object *) data->buffer.strInst);
+    }
+}
+
+JEM_GCScanFn JEMCC_StringBufferGCScanFn = JEMCC_StringBuffer_GCScan;
+
 JEMCC_MethodData JEMCC_StringBufferMethods[] = {
     { ACC_PUBLIC,
          "<init>", "()V",
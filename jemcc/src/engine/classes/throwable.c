@@ -34,12 +34,14 @@
 
 /**
  * Local definition of the raw information for the Throwable stack trace.
- * The steInstance is not defined until such time that the stack trace
- * set is explicitly requested.
+ * Only the method and PC of each frame is captured, the line number is
+ * not resolved until the stack trace is actually output (the majority of
+ * throwables are caught and discarded without ever being printed).  The
+ * PC is -1 for non-bytecode frames.
  */
 typedef struct JEMCC_StackTraceEntryData {
     jmethodID invokedMethod;
-    jint lineNumber;
+    jint pc;
 } JEMCC_StackTraceEntryData;
 
 /**
@@ -88,8 +90,7 @@ jint JEM_Throwable_InitStackTrace(JNIEnv *env, JEMCC_Object *throwable,
     JEMCC_ThrowableData *data = (JEMCC_ThrowableData *) &(throwObj->objectData);
     JEMCC_StackTraceEntryData *stePtr;
     JEM_VMFrameExt *wrkFrame;
-    JEM_BCMethod *bcMethod;
-    int i, cnt, lineNum;
+    int cnt;
 
     /* First, flush the existing trace if found */
     if (data->stackTrace != NULL) {
@@ -99,15 +100,10 @@ jint JEM_Throwable_InitStackTrace(JNIEnv *env, JEMCC_Object *throwable,
         data->stackTraceDepth = 0;
     }
 
-    /* Count the number of active frame instances */
-    cnt = 0;
+    /* Frame depth gives the number of active frames above the root */
     wrkFrame = jenv->topFrame;
     if (fromConstructor == JNI_TRUE) wrkFrame = wrkFrame->previousFrame;
-    while (wrkFrame != NULL) {
-        if ((wrkFrame->opFlags & FRAME_TYPE_MASK) == FRAME_ROOT) break;
-        cnt++;
-        wrkFrame = wrkFrame->previousFrame;
-    }
+    cnt = wrkFrame->frameDepth - 1;
 
     /* Allocate stack storage area */
     data->stackTrace = (JEMCC_StackTraceEntryData *)
@@ -115,25 +111,15 @@ jint JEM_Throwable_InitStackTrace(JNIEnv *env, JEMCC_Object *throwable,
     if (data->stackTrace == NULL) return JNI_ENOMEM;
     data->stackTraceDepth = cnt;
 
-    /* Fill in the stack trace instance */
+    /* Capture the raw method/pc of each frame, no line resolution here */
     stePtr = data->stackTrace;
-    wrkFrame = jenv->topFrame;
-    if (fromConstructor == JNI_TRUE) wrkFrame = wrkFrame->previousFrame;
-    while (wrkFrame != NULL) {
-        if ((wrkFrame->opFlags & FRAME_TYPE_MASK) == FRAME_ROOT) break;
+    while (cnt-- > 0) {
         stePtr->invokedMethod = (jmethodID) wrkFrame->currentMethod;
-        lineNum = -1;
-#ifndef NO_JVM_DEBUG
         if ((wrkFrame->opFlags & FRAME_TYPE_MASK) == FRAME_BYTECODE) {
-            bcMethod = wrkFrame->currentMethod->method.bcMethod;
-            for (i = 0; i < bcMethod->lineNumberTableLength; i++) {
-                if (bcMethod->lineNumberTable[i].startPC < wrkFrame->pc) {
-                    lineNum = bcMethod->lineNumberTable[i].lineNumber;
-                }
-            }
+            stePtr->pc = wrkFrame->lastPC;
+        } else {
+            stePtr->pc = -1;
         }
-#endif
-        stePtr->lineNumber = lineNum;
         wrkFrame = wrkFrame->previousFrame;
         stePtr++;
     }
@@ -141,6 +127,39 @@ jint JEM_Throwable_InitStackTrace(JNIEnv *env, JEMCC_Object *throwable,
     return JNI_OK;
 }
 
+/**
+ * Resolve the source line number for a captured stack trace element, from
+ * the line number table of the method.  The table is not necessarily in PC
+ * order, so the entry with the closest starting PC is selected.
+ *
+ * Parameters:
+ *     method - the method which was executing in the traced frame
+ *     pc - the captured PC of the frame, -1 for non-bytecode methods
+ *
+ * Returns:
+ *     The source line number or -1 if it is not available.
+ */
+static jint resolveLineNumber(JEM_ClassMethodData *method, jint pc) {
+    jint lineNum = -1;
+#ifndef NO_JVM_DEBUG
+    JEM_BCMethod *bcMethod;
+    jint bestPC = -1;
+    int i;
+
+    if (pc < 0) return -1;
+    bcMethod = method->method.bcMethod;
+    for (i = 0; i < bcMethod->lineNumberTableLength; i++) {
+        if ((bcMethod->lineNumberTable[i].startPC <= pc) &&
+                (bcMethod->lineNumberTable[i].startPC > bestPC)) {
+            bestPC = bcMethod->lineNumberTable[i].startPC;
+            lineNum = bcMethod->lineNumberTable[i].lineNumber;
+        }
+    }
+#endif
+
+    return lineNum;
+}
+
 /**
  * Central method for Throwable toString() action (used in main method as
  * well as in the stackTrace dump methods.
@@ -228,6 +247,7 @@ void JEM_Throwable_PrintStackTrace(JNIEnv *env, JEMCC_Object *throwable,
     JEM_ClassMethodData *method;
     JEMCC_Object *lineStr;
     char *ptr, buff[32];
+    jint lineNum;
     int i;
 
     /* Dump the String representation of the exception */
@@ -255,9 +275,10 @@ void JEM_Throwable_PrintStackTrace(JNIEnv *env, JEMCC_Object *throwable,
             } else if ((method->accessFlags & ACC_JEMCC) != 0) {
                 ptr = JEMCC_EnvStrBufferAppendSet(env, "(Native Method)", NULL);
             } else if (method->parentClass->classData->sourceFile != NULL) {
-                if (throwData->stackTrace[i].lineNumber >= 0) {
-                    (void) sprintf(buff, "%i", 
-                                   throwData->stackTrace[i].lineNumber);
+                lineNum = resolveLineNumber(method,
+                                            throwData->stackTrace[i].pc);
+                if (lineNum >= 0) {
+                    (void) sprintf(buff, "%i", lineNum);
                     ptr = JEMCC_EnvStrBufferAppendSet(env, "(", 
                                     method->parentClass->classData->sourceFile,
                                     ":", buff, ")", NULL);
@@ -313,6 +334,7 @@ static jint JEMCC_Throwable_init_String(JNIEnv *env,
 
     /* Have a message to define */
     data->message = msgObj;
+    JEMCC_MarkNonLocalObject(env, msgObj);
     data->stackTrace = NULL;
     data->stackTraceDepth = -1;
 
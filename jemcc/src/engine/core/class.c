@@ -107,8 +107,11 @@ static void JEM_WaitOnClassLoader(JNIEnv *env, JEMCC_Object *loader) {
     JEM_JavaVM *jvm = (JEM_JavaVM *) ((JEM_JNIEnv *) env)->parentVM;
 
     if (loader == NULL) {
+        /* Collections may proceed while waiting (as for object monitors) */
+        JEM_GCEnterSafeRegion(env);
         if (JEMCC_SysMonitorMilliWait(jvm->monitor, 
                                       200) == JEMCC_MONITOR_NOT_OWNER) abort();
+        JEM_GCLeaveSafeRegion(env);
     } else {
         /* TODO - add 'quiet' mode when interrupts are supported */
         if (JEMCC_ObjMonitorMilliWait(env, (jobject) loader, 
@@ -239,17 +242,280 @@ jint JEM_RetrieveClass(JNIEnv *env, JEMCC_Object *loader,
 /* Read package methods, which rely on ClassLoader lock methods above */
 #include "package.c"
 
+/* Hash of an (interned) name/descriptor pair, based on symbol addresses */
+#define MEMBER_HASH(name, desc) \
+            memberHashMix((juint) (((size_t) (name)) >> 3) ^ \
+                          ((juint) (((size_t) (desc)) >> 3) * 31))
+
+static juint memberHashMix(juint hashCode) {
+    hashCode ^= hashCode >> 11;
+    hashCode *= 0x9E3779B1;
+    return hashCode ^ (hashCode >> 16);
+}
+
+/**
+ * Allocate an empty member index large enough to hold the given number of
+ * members (the index is kept at most half full to keep probes short).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     count - the maximum number of members to be stored in the index
+ *
+ * Returns:
+ *     NULL if a memory allocation failed (an OutOfMemoryError will have
+ *     been thrown in the current environment), otherwise the empty index.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+static JEM_MemberIndex *JEM_CreateMemberIndex(JNIEnv *env, jsize count) {
+    JEM_MemberIndex *index;
+    juint size = 4;
+
+    while (size < 2 * (juint) count) size <<= 1;
+    index = (JEM_MemberIndex *) JEMCC_Malloc(env, sizeof(JEM_MemberIndex) +
+                                  (size - 1) * sizeof(JEM_MemberIndexEntry));
+    if (index == NULL) return NULL;
+    index->mask = size - 1;
+
+    return index;
+}
+
+/**
+ * Add a member to an index being constructed.  If a member with the same
+ * name and descriptor is already present, the index is unchanged (the
+ * first definition takes precedence, matching the lookup sequences).
+ */
+static void JEM_MemberIndexInsert(JEM_MemberIndex *index, char *name,
+                                  char *descriptor, void *member) {
+    juint slot = MEMBER_HASH(name, descriptor) & index->mask;
+    JEM_MemberIndexEntry *entry = &(index->entries[slot]);
+
+    while (entry->name != NULL) {
+        if ((entry->name == name) && (entry->descriptor == descriptor)) return;
+        slot = (slot + 1) & index->mask;
+        entry = &(index->entries[slot]);
+    }
+    entry->name = name;
+    entry->descriptor = descriptor;
+    entry->member = member;
+}
+
+/**
+ * Retrieve the member for the given (interned) name and descriptor from
+ * the index, or NULL if there is no such member.
+ */
+static void *JEM_MemberIndexFind(JEM_MemberIndex *index, const char *name,
+                                 const char *descriptor) {
+    juint slot = MEMBER_HASH(name, descriptor) & index->mask;
+    JEM_MemberIndexEntry *entry = &(index->entries[slot]);
+
+    while (entry->name != NULL) {
+        if ((entry->name == name) && (entry->descriptor == descriptor)) {
+            return entry->member;
+        }
+        slot = (slot + 1) & index->mask;
+        entry = &(index->entries[slot]);
+    }
+
+    return NULL;
+}
+
+/**
+ * Count the fields visible through the given class definition (local,
+ * superinterface and superclass fields), as an upper bound for the size
+ * of the flattened field index.
+ */
+static jsize JEM_CountVisibleFields(JEM_ClassData *classData) {
+    jsize count = classData->localFieldCount;
+    int i;
+
+    if (classData->fieldIndex != NULL) {
+        return (jsize) ((classData->fieldIndex->mask + 1) / 2);
+    }
+    if (classData->assignmentCount != 0) {
+        for (i = 0; i <= classData->interfaceCount; i++) {
+            if (classData->assignList[i] == NULL) continue;
+            count += JEM_CountVisibleFields(
+                                   classData->assignList[i]->classData);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Add all of the fields visible through the given class definition to the
+ * field index, in the resolution sequence of the JVM specification (local
+ * fields, then the direct superinterfaces in declaration order, then the
+ * superclass).  A class with its own (flattened) field index contributes
+ * that index directly.  Note that the assignment list holds the superclass
+ * first, followed by the declared interfaces.
+ */
+static void JEM_IndexVisibleFields(JEM_MemberIndex *index,
+                                   JEM_ClassData *classData) {
+    JEM_MemberIndexEntry *entry;
+    JEM_ClassFieldData *fieldPtr;
+    juint slot;
+    int i;
+
+    if (classData->fieldIndex != NULL) {
+        entry = classData->fieldIndex->entries;
+        for (slot = 0; slot <= classData->fieldIndex->mask; slot++, entry++) {
+            if (entry->name == NULL) continue;
+            JEM_MemberIndexInsert(index, entry->name, entry->descriptor,
+                                  entry->member);
+        }
+        return;
+    }
+
+    fieldPtr = classData->localFields;
+    for (i = classData->localFieldCount; i > 0; i--, fieldPtr++) {
+        JEM_MemberIndexInsert(index, fieldPtr->name, fieldPtr->descriptorStr,
+                              fieldPtr);
+    }
+    if (classData->assignmentCount != 0) {
+        for (i = 1; i <= classData->interfaceCount; i++) {
+            JEM_IndexVisibleFields(index, classData->assignList[i]->classData);
+        }
+        if (classData->assignList[0] != NULL) {
+            JEM_IndexVisibleFields(index, classData->assignList[0]->classData);
+        }
+    }
+}
+
+/**
+ * Determine if the source class definition has the target (non-array)
+ * class or interface as a supertype, using the supertype display for
+ * classes and the superinterface list for interfaces.
+ */
+static jboolean JEM_IsSuperType(JEM_ClassData *sourceData,
+                                JEMCC_Class *target) {
+    JEM_ClassData *targetData = target->classData;
+    JEMCC_Class **ifPtr;
+    jsize depth;
+
+    /* Superclass is always at the same depth in the display */
+    if ((targetData->accessFlags & ACC_INTERFACE) == 0) {
+        depth = targetData->superDepth;
+        if ((depth <= sourceData->superDepth) &&
+            (sourceData->superDisplay[depth] == target)) return JNI_TRUE;
+        return JNI_FALSE;
+    }
+
+    /* Interfaces require a scan, but repeated checks hit the cache */
+    if (sourceData->interfaceCache == target) return JNI_TRUE;
+    for (ifPtr = sourceData->superInterfaces; *ifPtr != NULL; ifPtr++) {
+        if (*ifPtr == target) {
+            sourceData->interfaceCache = target;
+            return JNI_TRUE;
+        }
+    }
+
+    return JNI_FALSE;
+}
+
+/**
+ * Determine if the source class is assignable to an array type, defined
+ * by the array type/depth information and the reference (leaf component)
+ * class of the array.
+ */
+static jboolean JEM_IsAssignableArray(JEMCC_Class *source,
+                                      juint targetTypeDepth,
+                                      JEMCC_Class *targetRef) {
+    JEMCC_ArrayClass *sourceArray = (JEMCC_ArrayClass *) source;
+    juint sourceDepth, targetDepth;
+
+    /* Array targets only accept arrays, primitive arrays are exact */
+    if ((source->classData->accessFlags & ACC_ARRAY) == 0) return JNI_FALSE;
+    if ((targetTypeDepth & PRIMITIVE_TYPE_MASK) != 0) {
+        return (sourceArray->typeDepthInfo == targetTypeDepth) ?
+                                                   JNI_TRUE : JNI_FALSE;
+    }
+    sourceDepth = sourceArray->typeDepthInfo & ARRAY_DEPTH_MASK;
+    targetDepth = targetTypeDepth & ARRAY_DEPTH_MASK;
+    if (sourceDepth == targetDepth) {
+        if ((sourceArray->typeDepthInfo & PRIMITIVE_TYPE_MASK) != 0) {
+            return JNI_FALSE;
+        }
+        return JEM_IsAssignableClass(sourceArray->referenceClass, targetRef);
+    }
+
+    /* Deeper source, the component is an array and must fit as an object */
+    if (sourceDepth > targetDepth) {
+        return JEM_IsSuperType(source->classData, targetRef);
+    }
+
+    return JNI_FALSE;
+}
+
+/**
+ * Determine if instances of the source class may be assigned to references
+ * of the target class (the instanceof/checkcast relationship, including
+ * the array covariance rules).  Superclass targets are resolved in constant
+ * time through the supertype display, interface targets through a scan of
+ * the superinterface list (with a single entry cache of the last match).
+ *
+ * Parameters:
+ *     source - the class of the instance being assigned
+ *     target - the class of the reference being assigned to
+ *
+ * Returns:
+ *     JNI_TRUE if the assignment is valid, JNI_FALSE otherwise.
+ */
+jboolean JEM_IsAssignableClass(JEMCC_Class *source, JEMCC_Class *target) {
+    JEMCC_ArrayClass *targetArray;
+
+    if (source == target) return JNI_TRUE;
+    if ((target->classData->accessFlags & ACC_ARRAY) == 0) {
+        /* Arrays share the supertypes (Object, Cloneable, Serializable) */
+        return JEM_IsSuperType(source->classData, target);
+    }
+
+    targetArray = (JEMCC_ArrayClass *) target;
+    return JEM_IsAssignableArray(source, targetArray->typeDepthInfo,
+                                 targetArray->referenceClass);
+}
+
+/**
+ * Determine if instances of the source class may be stored as elements of
+ * an array of the given (object or nested array) class, as required for
+ * the aastore operation.
+ *
+ * Parameters:
+ *     source - the class of the instance being stored
+ *     arrayClass - the class of the array receiving the instance
+ *
+ * Returns:
+ *     JNI_TRUE if the element store is valid, JNI_FALSE otherwise.
+ */
+jboolean JEM_IsAssignableArrayElement(JEMCC_Class *source,
+                                      JEMCC_ArrayClass *arrayClass) {
+    juint componentTypeDepth = arrayClass->typeDepthInfo - 1;
+
+    if ((componentTypeDepth & ARRAY_DEPTH_MASK) == 0) {
+        return JEM_IsAssignableClass(source, arrayClass->referenceClass);
+    }
+
+    return JEM_IsAssignableArray(source, componentTypeDepth,
+                                 arrayClass->referenceClass);
+}
+
 /**
  * Locate a method instance in the given class definition, using the
  * name and descriptor of the method in question.  Only scans the primary
  * linked method table (inheritance and interfaces accounted for), not
  * the local method table (in other words, this method will not locate 
- * the <init> or <clinit> methods).
+ * the <init> or <clinit> methods).  Member names and descriptors are
+ * interned, so the provided name and descriptor must be the interned
+ * symbols (see JEM_LookupSymbol) and are compared by reference.  Uses the
+ * hashed method index once the class hierarchy has been built, a linear
+ * scan before that (while the method table is being constructed).
  *
  * Parameters:
  *     classData - the class definition to search for the method
- *     name - the name of the method to find
- *     descriptor - the descriptor of the method to find
+ *     name - the (interned) name of the method to find
+ *     descriptor - the (interned) descriptor of the method to find
  *
  * Returns:
  *     The method definition reference if the method was found, NULL otherwise.
@@ -257,12 +523,19 @@ jint JEM_RetrieveClass(JNIEnv *env, JEMCC_Object *loader,
 JEM_ClassMethodData *JEM_LocateClassMethod(JEM_ClassData *classData,
                                            const char *name,
                                            const char *descriptor) {
-    JEM_ClassMethodData **retRef = classData->methodLinkTables[0];
+    JEM_ClassMethodData **retRef;
     int i;
 
+    if (classData->methodIndex != NULL) {
+        return (JEM_ClassMethodData *)
+                    JEM_MemberIndexFind(classData->methodIndex,
+                                        name, descriptor);
+    }
+
+    retRef = classData->methodLinkTables[0];
     for (i = classData->classMethodCount; i > 0; i--, retRef++) {
-        if ((strcmp(name, (*retRef)->name) == 0) &&
-                   (strcmp(descriptor, (*retRef)->descriptorStr) == 0)) {
+        if (((*retRef)->name == name) &&
+                   ((*retRef)->descriptorStr == descriptor)) {
             return *retRef;
         }
     }
@@ -274,12 +547,15 @@ JEM_ClassMethodData *JEM_LocateClassMethod(JEM_ClassData *classData,
  * Locate a field instance in the given class definition, using the
  * name and descriptor of the field in question.  Will scan local field
  * definitions, then recurse over superinterfaces and superclasses
- * according to the sequence defined in the Java VM specification.
+ * according to the sequence defined in the Java VM specification.  As
+ * with methods, the name and descriptor must be the interned symbols.
+ * Once the fields are packed, the flattened field index of the class
+ * (which captures the result of that sequence) is used instead.
  *
  * Parameters:
  *     classData - the class definition to search for the field
- *     name - the name of the field to find
- *     descriptor - the descriptor of the field to find
+ *     name - the (interned) name of the field to find
+ *     descriptor - the (interned) descriptor of the field to find
  *
  * Returns:
  *     The method definition reference if the method was found, NULL otherwise.
@@ -290,21 +566,66 @@ JEM_ClassFieldData *JEM_LocateClassField(JEM_ClassData *classData,
     JEM_ClassFieldData *retRef = classData->localFields;
     int i;
 
+    if (classData->fieldIndex != NULL) {
+        return (JEM_ClassFieldData *)
+                    JEM_MemberIndexFind(classData->fieldIndex,
+                                        name, descriptor);
+    }
+
     /* First try the local definitions */
     for (i = classData->localFieldCount; i > 0; i--, retRef++) {
-        if ((strcmp(name, retRef->name) == 0) &&
-                   (strcmp(descriptor, retRef->descriptorStr) == 0)) {
+        if ((retRef->name == name) &&
+                   (retRef->descriptorStr == descriptor)) {
             return retRef;
         }
     }
 
-    /* Recursively scan immediate interfaces and superclass */
+    /* Recursively scan immediate interfaces (in order) then superclass */
     if (classData->assignmentCount != 0) {
-        for (i = classData->interfaceCount; i >= 0; i--) {
+        for (i = 1; i <= classData->interfaceCount; i++) {
             retRef = JEM_LocateClassField(classData->assignList[i]->classData,
                                           name, descriptor);
             if (retRef != NULL) return retRef;
         }
+        if (classData->assignList[0] != NULL) {
+            return JEM_LocateClassField(classData->assignList[0]->classData,
+                                        name, descriptor);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Locate a method instance in the local method table of the given class
+ * definition (the methods declared by the class itself, including the
+ * <init> and <clinit> methods).  As above, the name and descriptor must be
+ * the interned symbols.
+ *
+ * Parameters:
+ *     classData - the class definition to search for the method
+ *     name - the (interned) name of the method to find
+ *     descriptor - the (interned) descriptor of the method to find
+ *
+ * Returns:
+ *     The method definition reference if the method was found, NULL otherwise.
+ */
+JEM_ClassMethodData *JEM_LocateLocalMethod(JEM_ClassData *classData,
+                                           const char *name,
+                                           const char *descriptor) {
+    JEM_ClassMethodData *retRef = classData->localMethods;
+    int i;
+
+    if (classData->localMethodIndex != NULL) {
+        return (JEM_ClassMethodData *)
+                    JEM_MemberIndexFind(classData->localMethodIndex,
+                                        name, descriptor);
+    }
+
+    for (i = classData->localMethodCount; i > 0; i--, retRef++) {
+        if ((retRef->name == name) && (retRef->descriptorStr == descriptor)) {
+            return retRef;
+        }
     }
 
     return NULL;
@@ -390,7 +711,7 @@ jint JEM_BuildClassHierData(JNIEnv *env, JEMCC_Class *classInst,
                             JEMCC_Class *superClass,
                             JEMCC_Class **interfaces, jsize interfaceCount,
                             JEM_ClassMethodData *methods, jsize methodCount) {
-    int i, j, tag, index, recordCount, argCount, classInitMethodIdx;
+    int i, j, tag, index, recordCount, argCount, classInitMethodIdx, depth;
     JEM_ClassData *classData = classInst->classData;
     JEM_ClassData *superClassData, *baseClassData, *ifClassData, *tClassData;
     JEM_ClassMethodData *methodPtr, methodSwap;
@@ -635,6 +956,29 @@ jint JEM_BuildClassHierData(JNIEnv *env, JEMCC_Class *classInst,
     }
     classData->assignmentCount = recordCount;
 
+    /* Supertype display is the superclass display plus this class */
+    depth = (superClass == NULL) ? 0 : superClassData->superDepth + 1;
+    classData->superDisplay = (JEMCC_Class **)
+                     JEMCC_Malloc(env, (depth + 1) * sizeof(JEMCC_Class *));
+    if (classData->superDisplay == NULL) return JNI_ENOMEM;
+    if (depth != 0) {
+        (void) memcpy(classData->superDisplay, superClassData->superDisplay,
+                      depth * sizeof(JEMCC_Class *));
+    }
+    classData->superDisplay[depth] = classInst;
+    classData->superDepth = depth;
+
+    /* Secondary (interface) supertypes are extracted from assignment list */
+    classData->superInterfaces = (JEMCC_Class **)
+                 JEMCC_Malloc(env, (recordCount + 1) * sizeof(JEMCC_Class *));
+    if (classData->superInterfaces == NULL) return JNI_ENOMEM;
+    for (lptr = classData->assignList, tptr = classData->superInterfaces;
+                                                  *lptr != NULL; lptr++) {
+        if (((*lptr)->classData->accessFlags & ACC_INTERFACE) != 0) {
+            *(tptr++) = *lptr;
+        }
+    }
+
     /* Common method point to define the stack argument consumption length */
     for (i = 0; i < methodCount; i++) {
         argDesc = methods[i].descriptor->method_info.paramDescriptor;
@@ -667,6 +1011,22 @@ jint JEM_BuildClassHierData(JNIEnv *env, JEMCC_Class *classInst,
     /* Finally, save the provided local method tables */
     classData->localMethods = methods;
     classData->localMethodCount = methodCount;
+
+    /* And build the hashed lookups over the completed method tables */
+    classData->methodIndex =
+                    JEM_CreateMemberIndex(env, classData->classMethodCount);
+    if (classData->methodIndex == NULL) return JNI_ENOMEM;
+    for (i = 0; i < classData->classMethodCount; i++) {
+        methodPtr = classData->methodLinkTables[0][i];
+        JEM_MemberIndexInsert(classData->methodIndex, methodPtr->name,
+                              methodPtr->descriptorStr, methodPtr);
+    }
+    classData->localMethodIndex = JEM_CreateMemberIndex(env, methodCount);
+    if (classData->localMethodIndex == NULL) return JNI_ENOMEM;
+    for (i = 0; i < methodCount; i++) {
+        JEM_MemberIndexInsert(classData->localMethodIndex, methods[i].name,
+                              methods[i].descriptorStr, &(methods[i]));
+    }
     
     return JNI_OK;
 }
@@ -859,6 +1219,7 @@ jint JEM_PackClassFieldData(JNIEnv *env, JEMCC_Class *classInst,
                             JEM_ClassFieldData *fields, jsize fieldCount) {
     int i, j, offset;
     JEM_ClassData *classData = classInst->classData;
+    JEM_MemberIndex *index;
 
     /* First, pack the instance fields and update class size */
     offset = packFields(env, classData->className, classData->packedFieldSize, 
@@ -886,6 +1247,12 @@ jint JEM_PackClassFieldData(JNIEnv *env, JEMCC_Class *classInst,
     /* Finally, save the provided local field tables */
     classData->localFields = fields;
     classData->localFieldCount = fieldCount;
+
+    /* Flatten all visible fields into the index, in resolution order */
+    index = JEM_CreateMemberIndex(env, JEM_CountVisibleFields(classData));
+    if (index == NULL) return JNI_ENOMEM;
+    JEM_IndexVisibleFields(index, classData);
+    classData->fieldIndex = index;
     
     return JNI_OK;
 }
@@ -1145,7 +1512,6 @@ jint JEMCC_RegisterClasses(JNIEnv *env, JEMCC_Object *loader,
 void JEM_DestroyClassInstance(JNIEnv *env, JEMCC_Class *classInst) {
     JEM_ClassData *classData = classInst->classData;
     JEM_ClassMethodData *methodPtr;
-    JEM_ClassFieldData *fieldPtr;
     juint accessFlags = classData->accessFlags;
     int i, isRawThrowable = JNI_FALSE;
 
@@ -1182,6 +1548,7 @@ void JEM_DestroyClassInstance(JNIEnv *env, JEMCC_Class *classInst) {
     /* Same idea for standard throwable instances */
     if (((accessFlags & ACC_STD_THROW) != 0) && (isRawThrowable != JNI_TRUE)) { 
         JEMCC_Free(classData->assignList);
+        JEMCC_Free(classData->superDisplay);
         JEMCC_Free(classData->methodLinkTables);
         JEMCC_Free(classData);
         JEMCC_Free(classInst);
@@ -1190,6 +1557,11 @@ void JEM_DestroyClassInstance(JNIEnv *env, JEMCC_Class *classInst) {
 
     /* Delete the reference tables - note that synthetic entries are managed */
     JEMCC_Free(classData->assignList);
+    JEMCC_Free(classData->superDisplay);
+    JEMCC_Free(classData->superInterfaces);
+    JEMCC_Free(classData->methodIndex);
+    JEMCC_Free(classData->localMethodIndex);
+    JEMCC_Free(classData->fieldIndex);
     if (classData->methodLinkTables != NULL) {
         for (i = classData->classMethodCount - classData->syntheticMethodCount;
                         i < classData->classMethodCount; i++) {
@@ -1210,14 +1582,10 @@ void JEM_DestroyClassInstance(JNIEnv *env, JEMCC_Class *classInst) {
     /* Release static class data if applicable */
     JEMCC_Free(classInst->staticData);
 
-    /* Delete local method and field information */
+    /* Delete local method and field information (names/descriptors are */
+    /* interned and shared, only the method code is per-class) */
     methodPtr = classData->localMethods;
     for (i = 0; i < classData->localMethodCount; i++) {
-        if ((accessFlags & ACC_JEMCC) == 0) {
-            JEMCC_Free(methodPtr->name);
-            JEMCC_Free(methodPtr->descriptorStr);
-        }
-        JEM_DestroyDescriptor(methodPtr->descriptor, JNI_TRUE);
         if (((methodPtr->accessFlags & ACC_JEMCC) == 0) &&
             (methodPtr->method.bcMethod != NULL)) {
             JEM_DestroyMethodCode(methodPtr->method.bcMethod);
@@ -1225,15 +1593,6 @@ void JEM_DestroyClassInstance(JNIEnv *env, JEMCC_Class *classInst) {
         methodPtr++;
     }
     JEMCC_Free(classData->localMethods);
-    fieldPtr = classData->localFields;
-    for (i = 0; i < classData->localFieldCount; i++) {
-        if ((accessFlags & ACC_JEMCC) == 0) {
-            JEMCC_Free(fieldPtr->name);
-            JEMCC_Free(fieldPtr->descriptorStr);
-        }
-        JEM_DestroyDescriptor(fieldPtr->descriptor, JNI_TRUE);
-        fieldPtr++;
-    }
     JEMCC_Free(classData->localFields);
 
     /* External references and constants are simple arrays */
@@ -1359,6 +1718,15 @@ void JEM_DumpDebugClass(JNIEnv *env, JEMCC_Class *dbgClass) {
                                    "%s[Stack: %i Locals: %i Code: %i]\n",
                                    "            ", methodPtr->maxStack,
                                    methodPtr->maxLocals, methodPtr->codeLength);
+#ifdef ENABLE_CALLSITE_STATS
+                        if (methodPtr->callSiteCount != 0) {
+                            (void) fprintf(stderr,
+                                   "%s[Call sites: %i Hits: %u Misses: %u]\n",
+                                   "            ", methodPtr->callSiteCount,
+                                   methodPtr->callSiteHits,
+                                   methodPtr->callSiteMisses);
+                        }
+#endif
                     } else {
                         (void) fprintf(stderr,
                                    "            [No code defined]\n");
@@ -0,0 +1,1006 @@
+/**
+ * Persistent (shareable) archive of parsed system class data.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU Lesser General Public
+ * License, as well as further clarification on your rights to use this
+ * software.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+#include "jeminc.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#include <fcntl.h>
+
+/* Read the VM structure/method definitions */
+#include "jem.h"
+
+/*
+ * The class archive is a single image containing the parsed class data
+ * (constant pool, interfaces, fields, methods and attribute information) of
+ * the system classes loaded from the classpath Zip/Jar files.  All internal
+ * references are offsets from the start of the data blob, so the image is
+ * relocatable and is mapped read-only (shared by all VM processes using
+ * the same archive).  Only the small, mutable pointer tables of the parsed
+ * class data are constructed on loading.  Records are stored in the native
+ * layout, the header identifies the layout and is validated on opening.
+ *
+ * The archive records the size and modification time of each source Zip/Jar
+ * file (validated when the archive is opened) and the size and CRC of each
+ * class entry from the Zip/Jar central directory (validated when the class
+ * is loaded, along with the classpath precedence of the source).
+ */
+#define ARCHIVE_MAGIC "JEMCCCDS"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_BYTE_ORDER 0x01020304
+#define ARCHIVE_LAYOUT ((sizeof(JEM_ConstantPoolData) << 16) | \
+                        (sizeof(void *) << 8) | sizeof(jlong))
+
+/* Alignment of the records within the image */
+#define ARCHIVE_ALIGN(x) (((x) + 7) & ~7)
+
+typedef struct JEM_ArchiveHeader {
+    char magic[8];
+    juint version, layout, byteOrder, imageLength;
+    juint sourceCount, sourceOffset;
+    juint classCount, classOffset;
+    juint blobOffset, blobLength;
+} JEM_ArchiveHeader;
+
+/* Source Zip/Jar file record (path is a blob offset) */
+typedef struct JEM_ArchiveSource {
+    juint pathOffset;
+    jint fileSize;
+    jlong modTime;
+} JEM_ArchiveSource;
+
+/* Class directory record, sorted by class name (blob offsets) */
+typedef struct JEM_ArchiveClass {
+    juint nameOffset, sourceIndex, crc32, dataOffset;
+    jint classSize, reserved;
+} JEM_ArchiveClass;
+
+/* Class data record, blob offsets reference the subsidiary records */
+typedef struct JEM_ArchiveClassData {
+    jint classAccessFlags, classIndex, superClassIndex;
+    jsize constantPoolCount, interfacesCount, fieldsCount, methodsCount;
+    jsize attributesCount, totalAttributesCount;
+    juint poolOffset, interfacesOffset, membersOffset, attributesOffset;
+} JEM_ArchiveClassData;
+
+/* Field or method record (fields are first in the member set) */
+typedef struct JEM_ArchiveMember {
+    jint accessFlags, nameIndex, descIndex;
+    jsize attributesCount;
+    juint attributesOffset;
+} JEM_ArchiveMember;
+
+typedef struct JEM_ArchiveAttribute {
+    jint attributeNameIndex;
+    juint attributeLength, infoOffset;
+} JEM_ArchiveAttribute;
+
+/* Opened (read-only) class archive */
+typedef struct JEM_ClassArchive {
+    jbyte *image;
+    juint imageLength;
+    jboolean isMapped;
+
+    JEM_ArchiveHeader *header;
+    JEM_ArchiveSource *sources;
+    JEM_ArchiveClass *classes;
+    jbyte *blob;
+
+    /* Classpath entry index of each source (-1 if the source is stale) */
+    jint *sourcePathIndex;
+} JEM_ClassArchive;
+
+/* Class archive under construction (recorded as classes are loaded) */
+typedef struct JEM_ClassArchiveWriter {
+    char *fileName;
+    JEMCC_SysMonitor *monitor;
+
+    /* Data blob and the class directory */
+    jbyte *blob;
+    juint blobLength, blobCapacity;
+    JEM_ArchiveClass *classes;
+    juint classCount, classCapacity;
+
+    /* Sources, with the source index of each classpath entry (or -1) */
+    JEM_ArchiveSource *sources;
+    juint sourceCount;
+    jint *pathSourceIndex;
+} JEM_ClassArchiveWriter;
+
+/**
+ * Determine the size and modification time of a source file.  Returns
+ * JNI_OK if successful or JNI_ERR if the file could not be examined.
+ */
+static jint JEM_ArchiveSourceStamp(const char *fileName, jint *fileSize,
+                                   jlong *modTime) {
+    struct stat stBuff;
+
+    if (stat(fileName, &stBuff) < 0) return JNI_ERR;
+    *fileSize = (jint) stBuff.st_size;
+    *modTime = (jlong) stBuff.st_mtime;
+
+    return JNI_OK;
+}
+
+/**
+ * Determine (overflow-safe) whether a table of count records of the given
+ * size, starting at offset, lies within the provided limit.
+ */
+static jboolean JEM_ArchiveRangeValid(juint offset, juint count, juint size,
+                                      juint limit) {
+    if (offset > limit) return JNI_FALSE;
+    if ((size != 0) && (count > (limit - offset) / size)) return JNI_FALSE;
+    return JNI_TRUE;
+}
+
+/**
+ * Determine whether a table of count (aligned) records of the given size
+ * lies within the data blob of the archive.
+ */
+static jboolean JEM_ArchiveRecordsValid(JEM_ClassArchive *archive,
+                                        juint offset, jsize count,
+                                        juint size) {
+    if ((count < 0) || (ARCHIVE_ALIGN(offset) != offset)) return JNI_FALSE;
+    return JEM_ArchiveRangeValid(offset, (juint) count, size,
+                                 archive->header->blobLength);
+}
+
+/**
+ * Determine whether a blob offset references a (terminated) string which
+ * lies within the data blob of the archive.
+ */
+static jboolean JEM_ArchiveStringValid(JEM_ClassArchive *archive,
+                                       juint offset) {
+    juint length = archive->header->blobLength;
+
+    if (offset >= length) return JNI_FALSE;
+    if (memchr(archive->blob + offset, 0, length - offset) == NULL) {
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+/**
+ * Validate the attribute records (and information blocks) of an attribute
+ * set against the data blob of the archive.
+ */
+static jboolean JEM_ArchiveAttributesValid(JEM_ClassArchive *archive,
+                                           juint offset, jsize count) {
+    JEM_ArchiveAttribute *attr;
+    jint i;
+
+    if (JEM_ArchiveRecordsValid(archive, offset, count,
+                                sizeof(JEM_ArchiveAttribute)) == JNI_FALSE) {
+        return JNI_FALSE;
+    }
+    attr = (JEM_ArchiveAttribute *) (archive->blob + offset);
+    for (i = 0; i < count; i++) {
+        if (JEM_ArchiveRangeValid(attr[i].infoOffset, attr[i].attributeLength,
+                                  1, archive->header->blobLength) ==
+                                                               JNI_FALSE) {
+            return JNI_FALSE;
+        }
+    }
+    return JNI_TRUE;
+}
+
+/**
+ * Validate all of the blob references (and counts) of an archived class
+ * data record, prior to the construction of the parsed class data.
+ */
+static jboolean JEM_ArchiveClassDataValid(JEM_ClassArchive *archive,
+                                          JEM_ArchiveClassData *cData) {
+    JEM_ConstantPoolData *pool;
+    JEM_ArchiveMember *member;
+    jint i, attrCount;
+
+    if ((cData->constantPoolCount < 1) ||
+        (cData->totalAttributesCount < 0)) return JNI_FALSE;
+
+    /* Constant pool and the referenced utf8 strings */
+    if (JEM_ArchiveRecordsValid(archive, cData->poolOffset,
+                                cData->constantPoolCount - 1,
+                                sizeof(JEM_ConstantPoolData)) == JNI_FALSE) {
+        return JNI_FALSE;
+    }
+    pool = (JEM_ConstantPoolData *) (archive->blob + cData->poolOffset);
+    for (i = 0; i < cData->constantPoolCount - 1; i++) {
+        if ((pool[i].generic.tag == CONSTANT_Utf8) &&
+            (JEM_ArchiveStringValid(archive, (juint) (size_t)
+                               pool[i].utf8_info.bytes) == JNI_FALSE)) {
+            return JNI_FALSE;
+        }
+    }
+
+    if (JEM_ArchiveRecordsValid(archive, cData->interfacesOffset,
+                                cData->interfacesCount,
+                                sizeof(jint)) == JNI_FALSE) {
+        return JNI_FALSE;
+    }
+
+    /* Members and the attribute sets, which must match the total */
+    if ((JEM_ArchiveRecordsValid(archive, 0, cData->fieldsCount,
+                                 sizeof(JEM_ArchiveMember)) == JNI_FALSE) ||
+        (JEM_ArchiveRecordsValid(archive, 0, cData->methodsCount,
+                                 sizeof(JEM_ArchiveMember)) == JNI_FALSE) ||
+        (JEM_ArchiveRecordsValid(archive, cData->membersOffset,
+                                 cData->fieldsCount + cData->methodsCount,
+                                 sizeof(JEM_ArchiveMember)) == JNI_FALSE)) {
+        return JNI_FALSE;
+    }
+    member = (JEM_ArchiveMember *) (archive->blob + cData->membersOffset);
+    attrCount = cData->totalAttributesCount;
+    for (i = 0; i < cData->fieldsCount + cData->methodsCount; i++) {
+        if ((JEM_ArchiveAttributesValid(archive, member[i].attributesOffset,
+                                   member[i].attributesCount) == JNI_FALSE) ||
+            (member[i].attributesCount > attrCount)) return JNI_FALSE;
+        attrCount -= member[i].attributesCount;
+    }
+    if (JEM_ArchiveAttributesValid(archive, cData->attributesOffset,
+                                   cData->attributesCount) == JNI_FALSE) {
+        return JNI_FALSE;
+    }
+
+    return (attrCount == cData->attributesCount) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Release the image and tables of an opened class archive.
+ */
+static void JEM_ArchiveDestroy(JEM_ClassArchive *archive) {
+    if (archive->image != NULL) {
+#ifdef HAVE_MMAP
+        if (archive->isMapped != JNI_FALSE) {
+            (void) munmap(archive->image, archive->imageLength);
+        } else {
+            JEMCC_Free(archive->image);
+        }
+#else
+        JEMCC_Free(archive->image);
+#endif
+    }
+    if (archive->sourcePathIndex != NULL) {
+        JEMCC_Free(archive->sourcePathIndex);
+    }
+    JEMCC_Free(archive);
+}
+
+/**
+ * Open a class data archive for use by the system classloader.  The archive
+ * is mapped read-only (where available) and validated against the current
+ * VM layout and classpath.  Classes whose source Zip/Jar file has changed
+ * are ignored, an invalid or missing archive is ignored entirely (an archive
+ * is only an accelerator).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     fileName - the name of the archive file to open
+ *
+ * Returns:
+ *     JNI_OK - the archive was opened and validated
+ *     JNI_EINVAL - the archive is missing or is not valid for this VM (no
+ *                  exception is thrown)
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_OpenClassArchive(JNIEnv *env, const char *fileName) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    JEM_PathEntryList *classPath = &(jvm->classPath);
+    JEM_ClassArchive *archive;
+    JEM_ArchiveHeader *header;
+    JEM_ArchiveSource *source;
+    JEM_ArchiveClass *cls;
+    char *path;
+    jint i, fileSize, fd;
+    jlong modTime;
+    juint s;
+
+    fileSize = JEMCC_GetFileSize(fileName);
+    if (fileSize < (jint) sizeof(JEM_ArchiveHeader)) return JNI_EINVAL;
+    archive = (JEM_ClassArchive *) JEMCC_Malloc(env, sizeof(JEM_ClassArchive));
+    if (archive == NULL) return JNI_ENOMEM;
+    archive->imageLength = fileSize;
+
+    /* Map (or read) the archive image */
+    if ((fd = open(fileName, O_RDONLY)) < 0) {
+        JEMCC_Free(archive);
+        return JNI_EINVAL;
+    }
+#ifdef HAVE_MMAP
+    archive->image = (jbyte *) mmap(NULL, fileSize, PROT_READ, MAP_SHARED,
+                                    fd, 0);
+    if (archive->image == (jbyte *) MAP_FAILED) {
+        archive->image = NULL;
+        (void) close(fd);
+        JEM_ArchiveDestroy(archive);
+        return JNI_EINVAL;
+    }
+    archive->isMapped = JNI_TRUE;
+#else
+    archive->image = (jbyte *) JEMCC_Malloc(env, fileSize);
+    if (archive->image == NULL) {
+        (void) close(fd);
+        JEM_ArchiveDestroy(archive);
+        return JNI_ENOMEM;
+    }
+    if (read(fd, archive->image, fileSize) != fileSize) {
+        (void) close(fd);
+        JEM_ArchiveDestroy(archive);
+        return JNI_EINVAL;
+    }
+#endif
+    (void) close(fd);
+
+    /* Validate the header and the table locations */
+    header = archive->header = (JEM_ArchiveHeader *) archive->image;
+    if ((memcmp(header->magic, ARCHIVE_MAGIC, 8) != 0) ||
+        (header->version != ARCHIVE_VERSION) ||
+        (header->layout != ARCHIVE_LAYOUT) ||
+        (header->byteOrder != ARCHIVE_BYTE_ORDER) ||
+        (header->imageLength != (juint) fileSize) ||
+        (ARCHIVE_ALIGN(header->sourceOffset) != header->sourceOffset) ||
+        (ARCHIVE_ALIGN(header->classOffset) != header->classOffset) ||
+        (ARCHIVE_ALIGN(header->blobOffset) != header->blobOffset) ||
+        (header->sourceOffset < sizeof(JEM_ArchiveHeader)) ||
+        (header->classOffset < sizeof(JEM_ArchiveHeader)) ||
+        (JEM_ArchiveRangeValid(header->blobOffset, header->blobLength, 1,
+                               (juint) fileSize) == JNI_FALSE) ||
+        (JEM_ArchiveRangeValid(header->sourceOffset, header->sourceCount,
+                               sizeof(JEM_ArchiveSource),
+                               header->blobOffset) == JNI_FALSE) ||
+        (JEM_ArchiveRangeValid(header->classOffset, header->classCount,
+                               sizeof(JEM_ArchiveClass),
+                               header->blobOffset) == JNI_FALSE)) {
+        JEM_ArchiveDestroy(archive);
+        return JNI_EINVAL;
+    }
+    archive->sources = (JEM_ArchiveSource *)
+                                   (archive->image + header->sourceOffset);
+    archive->classes = (JEM_ArchiveClass *)
+                                   (archive->image + header->classOffset);
+    archive->blob = archive->image + header->blobOffset;
+
+    /* Validate the blob references of the source and class directories */
+    for (s = 0; s < header->sourceCount; s++) {
+        if (JEM_ArchiveStringValid(archive,
+                           archive->sources[s].pathOffset) == JNI_FALSE) {
+            JEM_ArchiveDestroy(archive);
+            return JNI_EINVAL;
+        }
+    }
+    for (s = 0; s < header->classCount; s++) {
+        cls = &(archive->classes[s]);
+        if ((JEM_ArchiveStringValid(archive, cls->nameOffset) == JNI_FALSE) ||
+            (cls->sourceIndex >= header->sourceCount) ||
+            (JEM_ArchiveRecordsValid(archive, cls->dataOffset, 1,
+                           sizeof(JEM_ArchiveClassData)) == JNI_FALSE)) {
+            JEM_ArchiveDestroy(archive);
+            return JNI_EINVAL;
+        }
+    }
+
+    /* Match the sources to the (unchanged) classpath Zip/Jar files */
+    archive->sourcePathIndex = (jint *) JEMCC_Malloc(env,
+                                     (header->sourceCount + 1) * sizeof(jint));
+    if (archive->sourcePathIndex == NULL) {
+        JEM_ArchiveDestroy(archive);
+        return JNI_ENOMEM;
+    }
+    for (s = 0; s < header->sourceCount; s++) {
+        source = &(archive->sources[s]);
+        path = (char *) (archive->blob + source->pathOffset);
+        archive->sourcePathIndex[s] = -1;
+        for (i = 0; i < classPath->entryCount; i++) {
+            if ((classPath->entries[i].type == JEM_PATH_JARZIP) &&
+                (strcmp(classPath->entries[i].path, path) == 0)) break;
+        }
+        if (i >= classPath->entryCount) continue;
+        if ((JEM_ArchiveSourceStamp(path, &fileSize, &modTime) != JNI_OK) ||
+            (fileSize != source->fileSize) ||
+            (modTime != source->modTime)) continue;
+        archive->sourcePathIndex[s] = i;
+    }
+
+    jvm->classArchive = archive;
+
+    return JNI_OK;
+}
+
+/**
+ * Release the class archive of the virtual machine (if opened).  Only to be
+ * used when the virtual machine is destroyed, as the class data constructed
+ * from the archive references the archive image.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+void JEM_CloseClassArchive(JNIEnv *env) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+
+    if (jvm->classArchive == NULL) return;
+    JEM_ArchiveDestroy(jvm->classArchive);
+    jvm->classArchive = NULL;
+}
+
+/**
+ * Obtain the parsed class data for a system class from the class archive,
+ * if the archived class is still valid.  The class must be provided by
+ * the same (unchanged) Zip/Jar file as when archived, with a matching
+ * size and CRC, and no preceding classpath entry may provide the class.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     className - the fully qualified (dotted) name of the class
+ *     fileName - the classpath file name of the class
+ *     pData - the parsed class data reference through which the archived
+ *             class information is returned (if available).  The caller
+ *             takes ownership of the parsed data (the archive contents are
+ *             referenced and not copied)
+ *
+ * Returns:
+ *     JNI_OK - the class data was available and has been returned through
+ *              the pData reference
+ *     JNI_EINVAL - the class is not available from the archive or the
+ *                  archived record is corrupt (no exception is thrown)
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_GetArchivedClassData(JNIEnv *env, const char *className,
+                              const char *fileName,
+                              JEM_ParsedClassData **pData) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    JEM_ClassArchive *archive = jvm->classArchive;
+    JEM_ArchiveClassData *cData;
+    JEM_ArchiveMember *member;
+    JEM_ArchiveAttribute *attr;
+    JEM_ArchiveClass *cls;
+    JEM_ParsedClassData *data;
+    JEM_ConstantPoolData *pool;
+    struct ATTRIBUTE_info *attrs;
+    JEM_ParsedFieldData *members;
+    jint i, j, rc, entryIndex, low, high, mid, cmp;
+    juint size, poolSize, crc32;
+    jsize classSize;
+
+    if (archive == NULL) return JNI_EINVAL;
+
+    /* Binary search of the (sorted) class directory */
+    low = 0;
+    high = archive->header->classCount - 1;
+    cls = NULL;
+    while (low <= high) {
+        mid = (low + high) / 2;
+        cmp = strcmp(className, (char *) (archive->blob +
+                                          archive->classes[mid].nameOffset));
+        if (cmp == 0) {
+            cls = &(archive->classes[mid]);
+            break;
+        }
+        if (cmp < 0) high = mid - 1;
+        else low = mid + 1;
+    }
+    if ((cls == NULL) ||
+        (archive->sourcePathIndex[cls->sourceIndex] < 0)) return JNI_EINVAL;
+
+    /* Validate the provider of the class */
+    rc = JEM_LocatePathFile(env, &(jvm->classPath), fileName, &entryIndex,
+                            &classSize, &crc32);
+    if (rc != JNI_OK) return (rc == JNI_ENOMEM) ? rc : JNI_EINVAL;
+    if ((entryIndex != archive->sourcePathIndex[cls->sourceIndex]) ||
+        (classSize != cls->classSize) ||
+        (crc32 != cls->crc32)) return JNI_EINVAL;
+
+    /* Construct the pointer tables in a single block (if not corrupt) */
+    cData = (JEM_ArchiveClassData *) (archive->blob + cls->dataOffset);
+    if (JEM_ArchiveClassDataValid(archive, cData) == JNI_FALSE) {
+        return JNI_EINVAL;
+    }
+    poolSize = (cData->constantPoolCount - 1) * sizeof(JEM_ConstantPoolData);
+    size = ARCHIVE_ALIGN(sizeof(JEM_ParsedClassData)) + poolSize +
+           (cData->fieldsCount + cData->methodsCount) *
+                                           sizeof(JEM_ParsedFieldData) +
+           cData->totalAttributesCount * sizeof(struct ATTRIBUTE_info);
+    data = (JEM_ParsedClassData *) JEMCC_Malloc(env, size);
+    if (data == NULL) return JNI_ENOMEM;
+    pool = (JEM_ConstantPoolData *)
+             (((jbyte *) data) + ARCHIVE_ALIGN(sizeof(JEM_ParsedClassData)));
+    members = (JEM_ParsedFieldData *) (((jbyte *) pool) + poolSize);
+    attrs = (struct ATTRIBUTE_info *)
+                  (members + cData->fieldsCount + cData->methodsCount);
+
+    data->classAccessFlags = cData->classAccessFlags;
+    data->classIndex = cData->classIndex;
+    data->superClassIndex = cData->superClassIndex;
+    data->isMapped = JNI_TRUE;
+    data->isArchived = JNI_TRUE;
+
+    /* Constant pool is copied (modified by linking), utf8 is referenced */
+    data->constantPoolCount = cData->constantPoolCount;
+    data->constantPool = pool;
+    (void) memcpy(pool, archive->blob + cData->poolOffset, poolSize);
+    for (i = 0; i < cData->constantPoolCount - 1; i++) {
+        if (pool[i].generic.tag == CONSTANT_Utf8) {
+            pool[i].utf8_info.bytes = archive->blob +
+                                      (size_t) pool[i].utf8_info.bytes;
+        }
+    }
+
+    data->interfacesCount = cData->interfacesCount;
+    data->interfaces = (cData->interfacesCount == 0) ? NULL :
+                      (jint *) (archive->blob + cData->interfacesOffset);
+
+    /* Members and their attribute sets */
+    data->fieldsCount = cData->fieldsCount;
+    data->fields = members;
+    data->methodsCount = cData->methodsCount;
+    data->methods = (JEM_ParsedMethodData *) (members + cData->fieldsCount);
+    member = (JEM_ArchiveMember *) (archive->blob + cData->membersOffset);
+    for (i = 0; i < cData->fieldsCount + cData->methodsCount; i++) {
+        members[i].accessFlags = member[i].accessFlags;
+        members[i].nameIndex = member[i].nameIndex;
+        members[i].descIndex = member[i].descIndex;
+        members[i].attributesCount = member[i].attributesCount;
+        members[i].attributes = attrs;
+        attr = (JEM_ArchiveAttribute *)
+                            (archive->blob + member[i].attributesOffset);
+        for (j = 0; j < member[i].attributesCount; j++, attrs++) {
+            attrs->attributeNameIndex = attr[j].attributeNameIndex;
+            attrs->attributeLength = attr[j].attributeLength;
+            attrs->info = archive->blob + attr[j].infoOffset;
+        }
+    }
+
+    data->attributesCount = cData->attributesCount;
+    data->attributes = attrs;
+    attr = (JEM_ArchiveAttribute *) (archive->blob + cData->attributesOffset);
+    for (j = 0; j < cData->attributesCount; j++, attrs++) {
+        attrs->attributeNameIndex = attr[j].attributeNameIndex;
+        attrs->attributeLength = attr[j].attributeLength;
+        attrs->info = archive->blob + attr[j].infoOffset;
+    }
+
+    *pData = data;
+    return JNI_OK;
+}
+
+/**
+ * Begin the recording of a class data archive.  Each system class which is
+ * loaded from a classpath Zip/Jar file is recorded (see
+ * JEM_RecordArchivedClassData) and the archive is written when the
+ * virtual machine is destroyed.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     fileName - the name of the archive file to be written
+ *
+ * Returns:
+ *     JNI_OK - the archive recording has been started
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_CreateClassArchive(JNIEnv *env, const char *fileName) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    JEM_ClassArchiveWriter *writer;
+    jint i;
+
+    writer = (JEM_ClassArchiveWriter *) JEMCC_Malloc(env,
+                                              sizeof(JEM_ClassArchiveWriter));
+    if (writer == NULL) return JNI_ENOMEM;
+    writer->fileName = (char *) JEMCC_StrDupFn(env, (void *) fileName);
+    writer->monitor = JEMCC_CreateSysMonitor(env);
+    writer->sources = (JEM_ArchiveSource *) JEMCC_Malloc(env,
+                 (jvm->classPath.entryCount + 1) * sizeof(JEM_ArchiveSource));
+    writer->pathSourceIndex = (jint *) JEMCC_Malloc(env,
+                   (jvm->classPath.entryCount + 1) * sizeof(jint));
+    if ((writer->fileName == NULL) || (writer->monitor == NULL) ||
+        (writer->sources == NULL) || (writer->pathSourceIndex == NULL)) {
+        if (writer->monitor != NULL) JEMCC_DestroySysMonitor(writer->monitor);
+        JEMCC_Free(writer->fileName);
+        JEMCC_Free(writer->sources);
+        JEMCC_Free(writer->pathSourceIndex);
+        JEMCC_Free(writer);
+        return JNI_ENOMEM;
+    }
+    for (i = 0; i < jvm->classPath.entryCount; i++) {
+        writer->pathSourceIndex[i] = -1;
+    }
+    jvm->classArchiveWriter = writer;
+
+    return JNI_OK;
+}
+
+/**
+ * Append a data block to the archive blob (aligned), returning the blob
+ * offset of the block or -1 if a memory allocation failed.
+ */
+static jint JEM_ArchiveAppend(JNIEnv *env, JEM_ClassArchiveWriter *writer,
+                              const void *data, juint length) {
+    juint offset = ARCHIVE_ALIGN(writer->blobLength);
+    jbyte *blob;
+
+    if (offset + length > writer->blobCapacity) {
+        blob = (jbyte *) JEMCC_Malloc(env, 2 * writer->blobCapacity +
+                                              length + 65536);
+        if (blob == NULL) return -1;
+        if (writer->blob != NULL) {
+            (void) memcpy(blob, writer->blob, writer->blobLength);
+            JEMCC_Free(writer->blob);
+        }
+        writer->blob = blob;
+        writer->blobCapacity = 2 * writer->blobCapacity + length + 65536;
+    }
+    (void) memset(writer->blob + writer->blobLength, 0,
+                  offset - writer->blobLength);
+    if (length != 0) (void) memcpy(writer->blob + offset, data, length);
+    writer->blobLength = offset + length;
+
+    return offset;
+}
+
+/**
+ * Append an attribute set (the information blocks followed by the attribute
+ * records), returning the blob offset of the records or -1 if a memory
+ * allocation failed.
+ */
+static jint JEM_ArchiveAppendAttributes(JNIEnv *env,
+                                        JEM_ClassArchiveWriter *writer,
+                                        struct ATTRIBUTE_info *attributes,
+                                        jsize attributesCount) {
+    JEM_ArchiveAttribute *records;
+    jint i, offset;
+
+    records = (JEM_ArchiveAttribute *) JEMCC_Malloc(env,
+                      (attributesCount + 1) * sizeof(JEM_ArchiveAttribute));
+    if (records == NULL) return -1;
+    for (i = 0; i < attributesCount; i++) {
+        offset = JEM_ArchiveAppend(env, writer, attributes[i].info,
+                                   attributes[i].attributeLength);
+        if (offset < 0) break;
+        records[i].attributeNameIndex = attributes[i].attributeNameIndex;
+        records[i].attributeLength = attributes[i].attributeLength;
+        records[i].infoOffset = offset;
+    }
+    offset = (i < attributesCount) ? -1 :
+                      JEM_ArchiveAppend(env, writer, records,
+                              attributesCount * sizeof(JEM_ArchiveAttribute));
+    JEMCC_Free(records);
+
+    return offset;
+}
+
+/**
+ * Serialize the parsed class data into the archive blob, returning the blob
+ * offset of the class data record or -1 if a memory allocation failed.
+ */
+static jint JEM_ArchiveAppendClass(JNIEnv *env, JEM_ClassArchiveWriter *writer,
+                                   JEM_ParsedClassData *pData) {
+    JEM_ArchiveClassData cData;
+    JEM_ArchiveMember *members;
+    JEM_ParsedFieldData *field;
+    JEM_ConstantPoolData *pool;
+    jint i, offset = -1;
+    juint poolSize;
+
+    poolSize = (pData->constantPoolCount - 1) * sizeof(JEM_ConstantPoolData);
+    pool = (JEM_ConstantPoolData *) JEMCC_Malloc(env, poolSize + 1);
+    members = (JEM_ArchiveMember *) JEMCC_Malloc(env,
+                            (pData->fieldsCount + pData->methodsCount + 1) *
+                                                   sizeof(JEM_ArchiveMember));
+    if ((pool == NULL) || (members == NULL)) goto done;
+    (void) memset(&cData, 0, sizeof(cData));
+
+    /* Utf8 constants are appended and referenced by offset */
+    (void) memcpy(pool, pData->constantPool, poolSize);
+    for (i = 0; i < pData->constantPoolCount - 1; i++) {
+        if (pool[i].generic.tag != CONSTANT_Utf8) continue;
+        offset = JEM_ArchiveAppend(env, writer, pool[i].utf8_info.bytes,
+                               strlen((char *) pool[i].utf8_info.bytes) + 1);
+        if (offset < 0) goto done;
+        pool[i].utf8_info.bytes = (jbyte *) (size_t) offset;
+    }
+    if ((offset = JEM_ArchiveAppend(env, writer, pool, poolSize)) < 0) {
+        goto done;
+    }
+    cData.poolOffset = offset;
+    if ((offset = JEM_ArchiveAppend(env, writer, pData->interfaces,
+                         pData->interfacesCount * sizeof(jint))) < 0) {
+        goto done;
+    }
+    cData.interfacesOffset = offset;
+
+    /* Fields and methods share the member record format */
+    cData.totalAttributesCount = pData->attributesCount;
+    for (i = 0; i < pData->fieldsCount + pData->methodsCount; i++) {
+        field = (i < pData->fieldsCount) ? &(pData->fields[i]) :
+                 (JEM_ParsedFieldData *) &(pData->methods[i -
+                                                         pData->fieldsCount]);
+        offset = JEM_ArchiveAppendAttributes(env, writer, field->attributes,
+                                             field->attributesCount);
+        if (offset < 0) goto done;
+        members[i].accessFlags = field->accessFlags;
+        members[i].nameIndex = field->nameIndex;
+        members[i].descIndex = field->descIndex;
+        members[i].attributesCount = field->attributesCount;
+        members[i].attributesOffset = offset;
+        cData.totalAttributesCount += field->attributesCount;
+    }
+    offset = JEM_ArchiveAppend(env, writer, members,
+                               (pData->fieldsCount + pData->methodsCount) *
+                                                   sizeof(JEM_ArchiveMember));
+    if (offset < 0) goto done;
+    cData.membersOffset = offset;
+    if ((offset = JEM_ArchiveAppendAttributes(env, writer, pData->attributes,
+                                          pData->attributesCount)) < 0) {
+        goto done;
+    }
+    cData.attributesOffset = offset;
+
+    cData.classAccessFlags = pData->classAccessFlags;
+    cData.classIndex = pData->classIndex;
+    cData.superClassIndex = pData->superClassIndex;
+    cData.constantPoolCount = pData->constantPoolCount;
+    cData.interfacesCount = pData->interfacesCount;
+    cData.fieldsCount = pData->fieldsCount;
+    cData.methodsCount = pData->methodsCount;
+    cData.attributesCount = pData->attributesCount;
+    offset = JEM_ArchiveAppend(env, writer, &cData, sizeof(cData));
+
+done:
+    if (pool != NULL) JEMCC_Free(pool);
+    if (members != NULL) JEMCC_Free(members);
+    return offset;
+}
+
+/**
+ * Record the parsed data of a system class in the class archive being
+ * created (if any).  Must be called before the class is linked, as linking
+ * modifies the constant pool.  Only classes provided by classpath Zip/Jar
+ * files are recorded, failures are ignored (the class is not archived).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     className - the fully qualified (dotted) name of the class
+ *     fileName - the classpath file name of the class
+ *     pData - the parsed class data to be recorded (unmodified)
+ */
+void JEM_RecordArchivedClassData(JNIEnv *env, const char *className,
+                                 const char *fileName,
+                                 JEM_ParsedClassData *pData) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_ClassArchiveWriter *writer = jvm->classArchiveWriter;
+    JEM_ArchiveSource *source;
+    JEM_ArchiveClass *classes;
+    jint entryIndex, nameOffset, dataOffset;
+    jsize classSize;
+    juint crc32;
+
+    if ((writer == NULL) || (pData->isArchived != JNI_FALSE)) return;
+    if (JEM_LocatePathFile(env, &(jvm->classPath), fileName, &entryIndex,
+                           &classSize, &crc32) != JNI_OK) {
+        jenv->pendingException = NULL;
+        return;
+    }
+    if (jvm->classPath.entries[entryIndex].type != JEM_PATH_JARZIP) return;
+
+    JEMCC_EnterSysMonitor(writer->monitor);
+
+    /* Register the source Zip/Jar file on first use */
+    if (writer->pathSourceIndex[entryIndex] < 0) {
+        source = &(writer->sources[writer->sourceCount]);
+        if (JEM_ArchiveSourceStamp(jvm->classPath.entries[entryIndex].path,
+                                   &(source->fileSize),
+                                   &(source->modTime)) != JNI_OK) {
+            (void) JEMCC_ExitSysMonitor(writer->monitor);
+            return;
+        }
+        nameOffset = JEM_ArchiveAppend(env, writer,
+                              jvm->classPath.entries[entryIndex].path,
+                              strlen(jvm->classPath.entries[entryIndex].path)
+                                                                      + 1);
+        if (nameOffset < 0) goto nomem;
+        source->pathOffset = nameOffset;
+        writer->pathSourceIndex[entryIndex] = writer->sourceCount++;
+    }
+
+    /* Append the class data and directory entry */
+    if (writer->classCount >= writer->classCapacity) {
+        classes = (JEM_ArchiveClass *) JEMCC_Malloc(env,
+                 (2 * writer->classCapacity + 64) * sizeof(JEM_ArchiveClass));
+        if (classes == NULL) goto nomem;
+        if (writer->classes != NULL) {
+            (void) memcpy(classes, writer->classes,
+                          writer->classCount * sizeof(JEM_ArchiveClass));
+            JEMCC_Free(writer->classes);
+        }
+        writer->classes = classes;
+        writer->classCapacity = 2 * writer->classCapacity + 64;
+    }
+    nameOffset = JEM_ArchiveAppend(env, writer, className,
+                                   strlen(className) + 1);
+    if (nameOffset < 0) goto nomem;
+    if ((dataOffset = JEM_ArchiveAppendClass(env, writer, pData)) < 0) {
+        goto nomem;
+    }
+    classes = &(writer->classes[writer->classCount++]);
+    classes->nameOffset = nameOffset;
+    classes->sourceIndex = writer->pathSourceIndex[entryIndex];
+    classes->crc32 = crc32;
+    classes->classSize = classSize;
+    classes->dataOffset = dataOffset;
+
+    (void) JEMCC_ExitSysMonitor(writer->monitor);
+    return;
+
+nomem:
+    /* Not recording the class is not fatal */
+    (void) JEMCC_ExitSysMonitor(writer->monitor);
+    jenv->pendingException = NULL;
+}
+
+/* Sort index entry for the class directory (name resolved from the blob) */
+typedef struct JEM_ArchiveSortEntry {
+    const char *name;
+    JEM_ArchiveClass *cls;
+} JEM_ArchiveSortEntry;
+
+static int JEM_ArchiveSortCompare(const void *a, const void *b) {
+    return strcmp(((JEM_ArchiveSortEntry *) a)->name,
+                  ((JEM_ArchiveSortEntry *) b)->name);
+}
+
+/**
+ * Sort the recorded class directory by class name for lookup, discarding
+ * any duplicate records.  Returns JNI_OK if successful or JNI_ENOMEM if the
+ * sort index could not be allocated.
+ */
+static jint JEM_ArchiveSortClasses(JNIEnv *env,
+                                   JEM_ClassArchiveWriter *writer) {
+    JEM_ArchiveSortEntry *index;
+    JEM_ArchiveClass *classes;
+    juint i, j;
+
+    if (writer->classCount == 0) return JNI_OK;
+    index = (JEM_ArchiveSortEntry *) JEMCC_Malloc(env,
+                        writer->classCount * sizeof(JEM_ArchiveSortEntry));
+    classes = (JEM_ArchiveClass *) JEMCC_Malloc(env,
+                        writer->classCount * sizeof(JEM_ArchiveClass));
+    if ((index == NULL) || (classes == NULL)) {
+        JEMCC_Free(index);
+        JEMCC_Free(classes);
+        return JNI_ENOMEM;
+    }
+    for (i = 0; i < writer->classCount; i++) {
+        index[i].name = (char *) (writer->blob +
+                                  writer->classes[i].nameOffset);
+        index[i].cls = &(writer->classes[i]);
+    }
+    qsort(index, writer->classCount, sizeof(JEM_ArchiveSortEntry),
+          JEM_ArchiveSortCompare);
+    classes[0] = *(index[0].cls);
+    for (i = 1, j = 1; i < writer->classCount; i++) {
+        if (strcmp(index[i].name, index[i - 1].name) != 0) {
+            classes[j++] = *(index[i].cls);
+        }
+    }
+
+    JEMCC_Free(index);
+    JEMCC_Free(writer->classes);
+    writer->classes = classes;
+    writer->classCount = j;
+
+    return JNI_OK;
+}
+
+/**
+ * Write the class archive recorded during the lifetime of the virtual
+ * machine (if any) and release the recording information.  The archive is
+ * written to a temporary file and renamed, so that concurrently starting
+ * virtual machines never see a partial archive.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *
+ * Returns:
+ *     JNI_OK - the archive was written (or none was being recorded)
+ *     JNI_ERR - the archive file could not be written
+ */
+jint JEM_WriteClassArchive(JNIEnv *env) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    JEM_ClassArchiveWriter *writer = jvm->classArchiveWriter;
+    JEM_ArchiveHeader header;
+    char *tmpName = NULL;
+    jint rc = JNI_ERR;
+    FILE *fp = NULL;
+
+    if (writer == NULL) return JNI_OK;
+    jvm->classArchiveWriter = NULL;
+
+    /* Sort the directory for lookup (no archive if that fails) */
+    if (JEM_ArchiveSortClasses(env, writer) != JNI_OK) {
+        ((JEM_JNIEnv *) env)->pendingException = NULL;
+        goto done;
+    }
+
+    /* Layout is header, sources, directory and then the data blob */
+    (void) memset(&header, 0, sizeof(header));
+    (void) memcpy(header.magic, ARCHIVE_MAGIC, 8);
+    header.version = ARCHIVE_VERSION;
+    header.layout = ARCHIVE_LAYOUT;
+    header.byteOrder = ARCHIVE_BYTE_ORDER;
+    header.sourceCount = writer->sourceCount;
+    header.sourceOffset = ARCHIVE_ALIGN(sizeof(header));
+    header.classCount = writer->classCount;
+    header.classOffset = ARCHIVE_ALIGN(header.sourceOffset +
+                          writer->sourceCount * sizeof(JEM_ArchiveSource));
+    header.blobOffset = ARCHIVE_ALIGN(header.classOffset +
+                          writer->classCount * sizeof(JEM_ArchiveClass));
+    header.blobLength = writer->blobLength;
+    header.imageLength = header.blobOffset + header.blobLength;
+
+    tmpName = JEMCC_StrCatFn(env, writer->fileName, ".tmp", (char *) NULL);
+    if (tmpName != NULL) {
+        fp = fopen(tmpName, "wb");
+    } else {
+        ((JEM_JNIEnv *) env)->pendingException = NULL;
+    }
+    if (fp != NULL) {
+        rc = JNI_OK;
+        if ((fwrite(&header, sizeof(header), 1, fp) != 1) ||
+            (fseek(fp, header.sourceOffset, SEEK_SET) != 0) ||
+            (fwrite(writer->sources, sizeof(JEM_ArchiveSource),
+                    writer->sourceCount, fp) != writer->sourceCount) ||
+            (fseek(fp, header.classOffset, SEEK_SET) != 0) ||
+            (fwrite(writer->classes, sizeof(JEM_ArchiveClass),
+                    writer->classCount, fp) != writer->classCount) ||
+            (fseek(fp, header.blobOffset, SEEK_SET) != 0) ||
+            (fwrite(writer->blob, 1, writer->blobLength,
+                    fp) != writer->blobLength)) rc = JNI_ERR;
+        if (fclose(fp) != 0) rc = JNI_ERR;
+        if ((rc != JNI_OK) || (rename(tmpName, writer->fileName) != 0)) {
+            (void) remove(tmpName);
+            rc = JNI_ERR;
+        }
+    }
+
+done:
+    JEMCC_Free(tmpName);
+    JEMCC_DestroySysMonitor(writer->monitor);
+    JEMCC_Free(writer->fileName);
+    JEMCC_Free(writer->sources);
+    JEMCC_Free(writer->pathSourceIndex);
+    JEMCC_Free(writer->classes);
+    JEMCC_Free(writer->blob);
+    JEMCC_Free(writer);
+
+    return rc;
+}
@@ -297,7 +297,7 @@ static jint JEM_ProcessFieldAttributes(JNIEnv *env, JEM_ParsedClassData *pData,
  *                          loading of an exception class
  */
 jint JEM_LinkClassReferences(JNIEnv *env, JEM_ClassData *classData) {
-    int i, j, tag, count, classIdx, nameIdx, fieldIdx, methodIdx;
+    int i, tag, count, classIdx, nameIdx, fieldIdx, methodIdx;
     JEM_ParsedClassData *pData = classData->parseData;
     JEMCC_Object *loader = classData->classLoader;
     JEM_ClassMethodData *methodPtr;
@@ -306,7 +306,7 @@ jint JEM_LinkClassReferences(JNIEnv *env, JEM_ClassData *classData) {
     JEM_BCMethod *bcMethodPtr;
     JEM_DescriptorData *errDescriptor;
     JEMCC_Class *classRef;
-    char *namePtr, *descPtr;
+    char *namePtr, *descPtr, *nameSym, *descSym;
     jint rc;
 
     /* Convert the class references in the exception handling tables */
@@ -362,7 +362,14 @@ fprintf(stderr, "****** FIELD REFERENCE CLASS NOT FOUND *******\n");
                                   nameandtype_info.nameIndex).utf8_info.bytes;
             descPtr = CL_CONSTANT(pData->constantPool[nameIdx].
                                   nameandtype_info.descIndex).utf8_info.bytes;
-            fieldPtr = JEM_LocateClassField(classRefData, namePtr, descPtr);
+            /* Members are keyed by symbol, no symbol means no member */
+            nameSym = JEM_LookupSymbol(env, namePtr);
+            descSym = JEM_LookupSymbol(env, descPtr);
+            fieldPtr = NULL;
+            if ((nameSym != NULL) && (descSym != NULL)) {
+                fieldPtr = JEM_LocateClassField(classRefData,
+                                                nameSym, descSym);
+            }
             if (fieldPtr == NULL) {
                 errDescriptor = JEM_ParseDescriptor(env, descPtr, NULL, NULL,
                                                     JNI_FALSE);
@@ -436,20 +443,18 @@ fprintf(stderr, "****** INTERFACEMETHOD REFERENCE TO AN METHOD? *******\n");
                                   nameandtype_info.nameIndex).utf8_info.bytes;
             descPtr = CL_CONSTANT(pData->constantPool[nameIdx].
                                   nameandtype_info.descIndex).utf8_info.bytes;
-            /* <init> method must be manual found in local table */
-            if (strcmp(namePtr, "<init>") == 0) {
-                for (j = 0; j < classRefData->localMethodCount; j++) {
-                    if ((strcmp(classRefData->localMethods[j].name, 
-                                namePtr) == 0) &&
-                        (strcmp(classRefData->localMethods[j].descriptorStr, 
-                                descPtr) == 0)) {
-                        methodPtr = &(classRefData->localMethods[j]);
-                        break;
-                    }
-                }
+            nameSym = JEM_LookupSymbol(env, namePtr);
+            descSym = JEM_LookupSymbol(env, descPtr);
+            if ((nameSym == NULL) || (descSym == NULL)) {
+                /* Never interned, cannot be a member of any class */
+                methodPtr = NULL;
+            } else if (strcmp(namePtr, "<init>") == 0) {
+                /* <init> method must be found in the local table */
+                methodPtr = JEM_LocateLocalMethod(classRefData,
+                                                  nameSym, descSym);
             } else {
                 methodPtr = JEM_LocateClassMethod(classRefData, 
-                                                  namePtr, descPtr);
+                                                  nameSym, descSym);
             }
             if (methodPtr == NULL) {
                 errDescriptor = JEM_ParseDescriptor(env, descPtr, NULL, NULL,
@@ -529,12 +534,8 @@ static void JEM_DestroyWorkingMethodData(JEM_ClassMethodData *data,
     JEM_ClassMethodData *methodPtr = data;
     int i;
 
+    /* Note that names and descriptors are interned (not released) */
     for (i = 0; i < methodCount; i++) {
-        JEMCC_Free(methodPtr->name);
-        if (methodPtr->descriptor != NULL) {
-            JEM_DestroyDescriptor(methodPtr->descriptor, JNI_TRUE);
-        }
-        JEMCC_Free(methodPtr->descriptorStr);
         if (methodPtr->method.bcMethod != NULL) {
             JEM_DestroyMethodCode(methodPtr->method.bcMethod);
         }
@@ -545,17 +546,7 @@ static void JEM_DestroyWorkingMethodData(JEM_ClassMethodData *data,
 
 static void JEM_DestroyWorkingFieldData(JEM_ClassFieldData *data,
                                         jint fieldCount) {
-    JEM_ClassFieldData *fieldPtr = data;
-    int i;
-
-    for (i = 0; i < fieldCount; i++) {
-        JEMCC_Free(fieldPtr->name);
-        if (fieldPtr->descriptor != NULL) {
-            JEM_DestroyDescriptor(fieldPtr->descriptor, JNI_TRUE);
-        }
-        JEMCC_Free(fieldPtr->descriptorStr);
-        fieldPtr++;
-    }
+    /* Names and descriptors are interned, only the table is released */
     JEMCC_Free(data);
 }
 
@@ -726,12 +717,13 @@ JEMCC_Class *JEM_DefineAndResolveClass(JNIEnv *env, JEMCC_Object *loader,
         /* Clone/reformat method record information */
         classMethods[i].accessFlags = pData->methods[i].accessFlags;
         ptr = CL_CONSTANT(pData->methods[i].nameIndex).utf8_info.bytes;
-        classMethods[i].name = JEMCC_StrDupFn(env, ptr);
+        classMethods[i].name = JEM_InternSymbol(env, ptr);
         if (classMethods[i].name == NULL) break;
         ptr = CL_CONSTANT(pData->methods[i].descIndex).utf8_info.bytes;
-        classMethods[i].descriptorStr = JEMCC_StrDupFn(env, ptr);
+        classMethods[i].descriptorStr = JEM_InternSymbol(env, ptr);
         if (classMethods[i].descriptorStr == NULL) break;
-        classMethods[i].descriptor = JEM_ParseDescriptor(env, ptr, NULL, NULL,
+        classMethods[i].descriptor = JEM_InternDescriptor(env,
+                 classMethods[i].descriptorStr,
                  ((classMethods[i].accessFlags & ACC_STATIC) != 0) ? JNI_TRUE : 
                                                                      JNI_FALSE);
         if (classMethods[i].descriptor == NULL) break;
@@ -817,13 +809,14 @@ JEMCC_Class *JEM_DefineAndResolveClass(JNIEnv *env, JEMCC_Object *loader,
     for (i = 0; i < pData->fieldsCount; i++) {
         classFields[i].accessFlags = pData->fields[i].accessFlags;
         ptr = CL_CONSTANT(pData->fields[i].nameIndex).utf8_info.bytes;
-        classFields[i].name = (char *) JEMCC_StrDupFn(env, ptr);
+        classFields[i].name = JEM_InternSymbol(env, ptr);
         if (classFields[i].name == NULL) break;
         ptr = CL_CONSTANT(pData->fields[i].descIndex).utf8_info.bytes;
-        classFields[i].descriptorStr = JEMCC_StrDupFn(env, ptr);
+        classFields[i].descriptorStr = JEM_InternSymbol(env, ptr);
         if (classFields[i].descriptorStr == NULL) break;
-        classFields[i].descriptor = JEM_ParseDescriptor(env, ptr, NULL, NULL,
-                                                        JNI_FALSE);
+        classFields[i].descriptor = JEM_InternDescriptor(env,
+                                                 classFields[i].descriptorStr,
+                                                 JNI_FALSE);
         if (classFields[i].descriptor == NULL) break;
         if (classFields[i].descriptor->generic.tag == DESCRIPTOR_MethodType) {
             JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ClassFormatError, NULL,
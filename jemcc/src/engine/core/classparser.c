@@ -81,6 +81,7 @@ static jint readConstantPool(JNIEnv *env, JEM_ParsedClassData *classData,
                              const jubyte **buffPtr, jsize *buffLen) {
     jsize constantPoolCount;
     juint checkLen;
+    jsize validLen;
     u1 constantTag;
     JEM_ConstantPoolData *poolPtr;
     struct { u4 t1; u4 t2; } converter;
@@ -95,9 +96,9 @@ static jint readConstantPool(JNIEnv *env, JEM_ParsedClassData *classData,
         return JNI_ERR;
     }
     classData->constantPool = (JEM_ConstantPoolData *)
-                                  JEMCC_Malloc(env, 
-                                               (constantPoolCount - 1) * 
-                                                sizeof(JEM_ConstantPoolData));
+                                  JEM_ArenaAlloc(env, &(classData->arena),
+                                                 (constantPoolCount - 1) *
+                                                 sizeof(JEM_ConstantPoolData));
     if (classData->constantPool == NULL) {
         classData->constantPoolCount = 0;
         return JNI_ERR;
@@ -174,10 +175,18 @@ static jint readConstantPool(JNIEnv *env, JEM_ParsedClassData *classData,
                                                NULL, endOfDataMsg);
                     return JNI_ERR;
                 }
+                /* Modified UTF-8 cannot contain '\0' or four byte forms */
+                (void) JEM_UTFScan(*buffPtr, checkLen, &validLen, NULL);
+                if ((juint) validLen != checkLen) {
+                    JEMCC_ThrowStdThrowableIdx(env, 
+                                               JEMCC_Class_ClassFormatError,
+                                               NULL, "Invalid UTF-8 constant");
+                    return JNI_ERR;
+                }
                 /* Note that this auto-terminates the utf8 string (if ascii) */
-                poolPtr->utf8_info.bytes = 
-                                 (unsigned char *) JEMCC_Malloc(env, 
-                                                                checkLen + 1);
+                poolPtr->utf8_info.bytes = (unsigned char *)
+                               JEM_ArenaAlloc(env, &(classData->arena),
+                                              checkLen + 1);
                 if (poolPtr->utf8_info.bytes == NULL) return JNI_ERR;
                 (void) memcpy(poolPtr->utf8_info.bytes, *buffPtr, checkLen);
                 *buffLen -= checkLen;
@@ -207,28 +216,6 @@ static jint readConstantPool(JNIEnv *env, JEM_ParsedClassData *classData,
     return JNI_OK;
 }
 
-/**
- * Destroy all constant pool information contained in the parsed class
- * data.  Safe to call at any time during parsing.
- *
- * Parameters:
- *     classData - the parsing structure containing the constant pool
- *                 information to be deleted
- */
-static void destroyConstantPool(JEM_ParsedClassData *classData) {
-    int i;
-
-    /* Free the constant pool internals (utf8 allocations only) */
-    for (i = 0; i < classData->constantPoolCount - 1; i++) {
-        if (classData->constantPool[i].generic.tag == CONSTANT_Utf8) {
-            if (classData->constantPool[i].utf8_info.bytes != NULL) {
-                JEMCC_Free(classData->constantPool[i].utf8_info.bytes);
-            }
-        }
-    }
-    JEMCC_Free(classData->constantPool);
-}
-
 /**
  * Validate the constant pool information at the given index.
  *
@@ -337,9 +324,9 @@ static jint readInterfaces(JNIEnv *env, JEM_ParsedClassData *classData,
     }
 
     if (interfacesCount != 0) {
-        classData->interfaces = (jint *) 
-                                  JEMCC_Malloc(env, 
-                                               interfacesCount * sizeof(jint));
+        classData->interfaces = (jint *)
+                          JEM_ArenaAlloc(env, &(classData->arena),
+                                         interfacesCount * sizeof(jint));
         if (classData->interfaces == NULL) {
             classData->interfacesCount = 0;
             return JNI_ERR;
@@ -358,19 +345,6 @@ static jint readInterfaces(JNIEnv *env, JEM_ParsedClassData *classData,
     return JNI_OK;
 }
 
-/**
- * Destroy the interface references contained in the parsed class
- * data.  Safe to call at any time during parsing.
- *
- * Parameters:
- *     classData - the parsing structure containing the interface
- *                 information to be deleted
- */
-static void destroyInterfaces(JEM_ParsedClassData *classData) {
-    /* Just free the allocated array */
-    JEMCC_Free(classData->interfaces);
-}
-
 /**
  * Read the attribute information from the provided data buffer.  Note that
  * this reader is used for class attributes, method attributes, field
@@ -382,6 +356,9 @@ static void destroyInterfaces(JEM_ParsedClassData *classData) {
  *                be populated
  *     buffPtr - the pointer reference to the binary class data
  *     buffLen - the number of bytes remaining in the binary buffer
+ *     isMapped - if JNI_TRUE, the binary data outlives the attribute set and
+ *                the attribute information references it instead of a copy
+ *     arena - the arena from which the attribute storage is allocated
  *
  * Returns:
  *     JNI_OK if parsing was successful, JNI_ERR otherwise (an exception
@@ -392,7 +369,8 @@ static void destroyInterfaces(JEM_ParsedClassData *classData) {
  *     OutOfMemoryError - a memory allocation failed
  */
 static jint readAttributes(JNIEnv *env, JEM_ParsedAttributeData *attrData, 
-                           const jubyte **buffPtr, jsize *buffLen) {
+                           const jubyte **buffPtr, jsize *buffLen,
+                           jboolean isMapped, JEM_Arena *arena) {
     jsize attributesCount;
     juint attributeLen;
     struct ATTRIBUTE_info *attPtr;
@@ -408,9 +386,9 @@ static jint readAttributes(JNIEnv *env, JEM_ParsedAttributeData *attrData,
     }
 
     if (attributesCount != 0) {
-        attrData->attributes = (struct ATTRIBUTE_info *) 
-                                  JEMCC_Malloc(env, attributesCount *
-                                               sizeof(struct ATTRIBUTE_info));
+        attrData->attributes = (struct ATTRIBUTE_info *)
+                          JEM_ArenaAlloc(env, arena, attributesCount *
+                                         sizeof(struct ATTRIBUTE_info));
         if (attrData->attributes == NULL) {
             attrData->attributesCount = 0;
             return JNI_ERR;
@@ -435,9 +413,15 @@ static jint readAttributes(JNIEnv *env, JEM_ParsedAttributeData *attrData,
                                        NULL, endOfDataMsg);
             return JNI_ERR;
         }
-        attPtr->info = (jbyte *) JEMCC_Malloc(env, attributeLen + 1);
-        if (attPtr->info == NULL) return JNI_ERR;
-        (void) memcpy(attPtr->info, *buffPtr, attributeLen);
+        if (isMapped != JNI_FALSE) {
+            /* Attribute data is never modified, just reference the source */
+            attPtr->info = (jbyte *) *buffPtr;
+        } else {
+            attPtr->info = (jbyte *) JEM_ArenaAlloc(env, arena,
+                                                    attributeLen + 1);
+            if (attPtr->info == NULL) return JNI_ERR;
+            (void) memcpy(attPtr->info, *buffPtr, attributeLen);
+        }
         *buffPtr += attributeLen;
         *buffLen -= attributeLen;
         attPtr++;
@@ -446,24 +430,6 @@ static jint readAttributes(JNIEnv *env, JEM_ParsedAttributeData *attrData,
     return JNI_OK;
 }
 
-/**
- * Destroy the provided attribute information storage.  Safe to call 
- * at any time during parsing.
- *
- * Parameters:
- *     attrData - the parsing structure containing the attribute
- *                information to be deleted
- */
-static void destroyAttributes(JEM_ParsedAttributeData *attrData) {
-    int i;
-
-    /* Free the attribute internals */
-    for (i = 0; i < attrData->attributesCount; i++) {
-        JEMCC_Free(attrData->attributes[i].info);
-    }
-    JEMCC_Free(attrData->attributes);
-}
-
 /**
  * Read the class field definition information from the provided data buffer.
  *
@@ -493,7 +459,8 @@ static jint readFieldInfo(JNIEnv *env, JEM_ParsedClassData *classData,
     *buffLen -= 2;
     if (fieldsCount != 0) {
         classData->fields = (JEM_ParsedFieldData *)
-                 JEMCC_Malloc(env, fieldsCount * sizeof(JEM_ParsedFieldData));
+                 JEM_ArenaAlloc(env, &(classData->arena),
+                                fieldsCount * sizeof(JEM_ParsedFieldData));
         if (classData->fields == NULL) {
             classData->fieldsCount = 0;
             return JNI_ERR;
@@ -519,7 +486,8 @@ static jint readFieldInfo(JNIEnv *env, JEM_ParsedClassData *classData,
         /* Grab the standard attribute data */
         if (readAttributes(env, 
                       (JEM_ParsedAttributeData *) &(fieldPtr->attributesCount),
-                       buffPtr, buffLen) != JNI_OK) {
+                       buffPtr, buffLen, classData->isMapped,
+                       &(classData->arena)) != JNI_OK) {
             return JNI_ERR;
         }
 
@@ -529,25 +497,6 @@ static jint readFieldInfo(JNIEnv *env, JEM_ParsedClassData *classData,
     return JNI_OK;
 }
 
-/**
- * Destroy the field information contained in the parsed class
- * data.  Safe to call at any time during parsing.
- *
- * Parameters:
- *     classData - the parsing structure containing the field
- *                 information to be deleted
- */
-static void destroyFieldInfo(JEM_ParsedClassData *classData) {
-    int i;
-
-    /* Free the field data internals */
-    for (i = 0; i < classData->fieldsCount; i++) {
-        destroyAttributes((JEM_ParsedAttributeData *) 
-                          &(classData->fields[i].attributesCount));
-    }
-    JEMCC_Free(classData->fields);
-}
-
 /**
  * Read the class method definition information from the provided data buffer.
  *
@@ -577,7 +526,8 @@ static jint readMethodInfo(JNIEnv *env, JEM_ParsedClassData *classData,
     *buffLen -= 2;
     if (methodsCount != 0) {
         classData->methods = (JEM_ParsedMethodData *)
-                JEMCC_Malloc(env, methodsCount * sizeof(JEM_ParsedMethodData));
+                JEM_ArenaAlloc(env, &(classData->arena),
+                               methodsCount * sizeof(JEM_ParsedMethodData));
         if (classData->methods == NULL) {
             classData->methodsCount = 0;
             return JNI_ERR;
@@ -603,7 +553,8 @@ static jint readMethodInfo(JNIEnv *env, JEM_ParsedClassData *classData,
         /* Grab the standard attribute data */
         if (readAttributes(env, 
                      (JEM_ParsedAttributeData *) &(methodPtr->attributesCount),
-                     buffPtr, buffLen) != JNI_OK) {
+                     buffPtr, buffLen, classData->isMapped,
+                     &(classData->arena)) != JNI_OK) {
             return JNI_ERR;
         }
 
@@ -613,25 +564,6 @@ static jint readMethodInfo(JNIEnv *env, JEM_ParsedClassData *classData,
     return JNI_OK;
 }
 
-/**
- * Destroy the method information contained in the parsed class
- * data.  Safe to call at any time during parsing.
- *
- * Parameters:
- *     classData - the parsing structure containing the method
- *                 information to be deleted
- */
-static void destroyMethodInfo(JEM_ParsedClassData *classData) {
-    int i;
-
-    /* Free the method data internals */
-    for (i = 0; i < classData->methodsCount; i++) {
-        destroyAttributes((JEM_ParsedAttributeData *) 
-                          &(classData->methods[i].attributesCount));
-    }
-    JEMCC_Free(classData->methods);
-}
-
 /**
  * String comparison function which ignores separator differences in the
  * Java packaging information.
@@ -664,6 +596,10 @@ static int strcmpsep(char *ptr, char *str) {
  *     env - the VM environment which is currently in context
  *     buff - the binary data associated with the class to be parsed
  *     buffLen - the number of bytes in the provided binary data buffer
+ *     isMapped - if JNI_TRUE, the binary data will remain valid and
+ *                unmodified for the lifetime of the parsed class data
+ *                (e.g. mapped archive contents) and the attribute
+ *                information references it directly instead of copying
  *
  * Returns:
  *     NULL if a parsing error occurred, otherwise the structure instance
@@ -677,7 +613,7 @@ static int strcmpsep(char *ptr, char *str) {
  *                                    this VM
  */
 JEM_ParsedClassData *JEM_ParseClassData(JNIEnv *env, const jbyte *buff, 
-                                        jsize buffLen) {
+                                        jsize buffLen, jboolean isMapped) {
     const jubyte *buffPtr = (const jubyte*) buff;
     u2 majorVersion, minorVersion;
     JEM_ParsedClassData *classData;
@@ -716,6 +652,7 @@ JEM_ParsedClassData *JEM_ParseClassData(JNIEnv *env, const jbyte *buff,
                      JEMCC_Malloc(env, sizeof(JEM_ParsedClassData))) == NULL) {
         return NULL;
     }
+    classData->isMapped = isMapped;
 
     /* Read the constant pool information */
     if (readConstantPool(env, classData, &buffPtr, &buffLen) != JNI_OK) {
@@ -800,7 +737,8 @@ JEM_ParsedClassData *JEM_ParseClassData(JNIEnv *env, const jbyte *buff,
     /* Read the attribute information */
     if (readAttributes(env, 
                     (JEM_ParsedAttributeData *) &(classData->attributesCount),
-                    &buffPtr, &buffLen) != JNI_OK) {
+                    &buffPtr, &buffLen, classData->isMapped,
+                    &(classData->arena)) != JNI_OK) {
         JEM_DestroyParsedClassData(classData);
         return NULL;
     }
@@ -1115,16 +1053,104 @@ JEM_ParsedClassData *JEM_ParseClassData(JNIEnv *env, const jbyte *buff,
 void JEM_DestroyParsedClassData(JEM_ParsedClassData *data) {
     if (data == NULL) return;
 
-    destroyConstantPool(data);
-    destroyInterfaces(data);
-    destroyFieldInfo(data);
-    destroyMethodInfo(data);
-    destroyAttributes((JEM_ParsedAttributeData *) &(data->attributesCount));
+    /* All parsed elements are arena allocated (none for archived data) */
+    JEM_ArenaRelease(&(data->arena));
     JEMCC_Free(data);
 }
 
 static char *endOfCodeMsg = "Unexpected end of code attribute information";
 
+/* Sorting comparator for the handler range boundaries */
+static int handlerBoundCompare(const void *a, const void *b) {
+    return *((const jint *) a) - *((const jint *) b);
+}
+
+/**
+ * Construct the sorted range index for the method exception table (see
+ * JEM_HandlerRange).  The boundaries of the handler ranges are sorted to
+ * split the code into disjoint segments, each of which records the set of
+ * handlers covering it in exception table order (which defines precedence).
+ * The range and handler list storage is a single allocation.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     method - the bytecode method containing the parsed exception table
+ *
+ * Returns:
+ *     JNI_OK if the index was constructed, JNI_ENOMEM if a memory allocation
+ *     failure occurred.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+static jint buildHandlerIndex(JNIEnv *env, JEM_BCMethod *method) {
+    JEM_MethodExceptionBlock *exBlocks = method->exceptionTable;
+    int i, j, k, boundCount, rangeCount, handlerCount;
+    JEM_HandlerRange *range;
+    jint *bounds, *handlers;
+
+    bounds = (jint *) JEMCC_Malloc(env, 2 * method->exceptionTableLength *
+                                                              sizeof(jint));
+    if (bounds == NULL) return JNI_ENOMEM;
+    for (i = 0; i < method->exceptionTableLength; i++) {
+        bounds[2 * i] = exBlocks[i].startPC;
+        bounds[2 * i + 1] = exBlocks[i].endPC;
+    }
+    qsort(bounds, 2 * method->exceptionTableLength, sizeof(jint),
+          handlerBoundCompare);
+    for (i = 1, boundCount = 1; i < 2 * method->exceptionTableLength; i++) {
+        if (bounds[i] != bounds[boundCount - 1]) {
+            bounds[boundCount++] = bounds[i];
+        }
+    }
+
+    /* Size the index, ignoring segments with no active handlers */
+    rangeCount = handlerCount = 0;
+    for (k = 0; k < boundCount - 1; k++) {
+        for (i = 0, j = 0; i < method->exceptionTableLength; i++) {
+            if ((exBlocks[i].startPC <= bounds[k]) &&
+                (exBlocks[i].endPC > bounds[k])) j++;
+        }
+        if (j != 0) {
+            rangeCount++;
+            handlerCount += j;
+        }
+    }
+    if (rangeCount == 0) {
+        JEMCC_Free(bounds);
+        return JNI_OK;
+    }
+
+    range = (JEM_HandlerRange *) JEMCC_Malloc(env,
+                                     rangeCount * sizeof(JEM_HandlerRange) +
+                                     handlerCount * sizeof(jint));
+    if (range == NULL) {
+        JEMCC_Free(bounds);
+        return JNI_ENOMEM;
+    }
+    method->handlerRanges = range;
+    method->handlerRangeCount = rangeCount;
+
+    /* Fill in the ranges, handler lists follow the range records */
+    handlers = (jint *) (range + rangeCount);
+    for (k = 0; k < boundCount - 1; k++) {
+        range->handlers = handlers;
+        for (i = 0; i < method->exceptionTableLength; i++) {
+            if ((exBlocks[i].startPC <= bounds[k]) &&
+                (exBlocks[i].endPC > bounds[k])) *(handlers++) = i;
+        }
+        range->handlerCount = handlers - range->handlers;
+        if (range->handlerCount != 0) {
+            range->startPC = bounds[k];
+            range->endPC = bounds[k + 1];
+            range++;
+        }
+    }
+    JEMCC_Free(bounds);
+
+    return JNI_OK;
+}
+
 /* Note: this method appears here due to u2 read dependencies */
 /**
  * Parse the method code attribute information.  This will extract the
@@ -1151,6 +1177,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                                   jsize buffLen, 
                                   JEM_ParsedClassData *classData) {
     JEM_ParsedAttributeData codeAttributes;
+    JEM_Arena codeArena;
     const jubyte *buffPtr = (const jubyte *) buffer;
     JEM_BCMethod *retVal;
     jint index;
@@ -1228,11 +1255,18 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
         }
         retVal->exceptionTable[i].exceptionClass.index = index;
     }
+    if ((retVal->exceptionTableLength != 0) &&
+            (buildHandlerIndex(env, retVal) != JNI_OK)) {
+        JEM_DestroyMethodCode(retVal);
+        return NULL;
+    }
 
-    /* Check/read the attribute information */
-    if (readAttributes(env, &codeAttributes, &buffPtr, &buffLen) != JNI_OK) {
+    /* Check/read the attribute information (transient, locally released) */
+    (void) memset(&codeArena, 0, sizeof(codeArena));
+    if (readAttributes(env, &codeAttributes, &buffPtr, &buffLen,
+                       JNI_TRUE, &codeArena) != JNI_OK) {
         /* Note that the standard parse behaviour leaves cleanup to here */
-        destroyAttributes(&codeAttributes);
+        JEM_ArenaRelease(&codeArena);
         JEM_DestroyMethodCode(retVal);
         return NULL;
     }
@@ -1241,7 +1275,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
         if (checkConstantPoolType(env, classData, index, CONSTANT_Utf8, 
                               "Invalid code attribute name index") != JNI_OK) {
             JEM_DestroyMethodCode(retVal);
-            destroyAttributes(&codeAttributes);
+            JEM_ArenaRelease(&codeArena);
             return NULL;
         }
         ptr = classData->constantPool[index - 1].utf8_info.bytes;
@@ -1251,7 +1285,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                 JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ClassFormatError,
                                            NULL, endOfCodeMsg);
                 JEM_DestroyMethodCode(retVal);
-                destroyAttributes(&codeAttributes);
+                JEM_ArenaRelease(&codeArena);
                 return NULL;
             }
             buffPtr = (jubyte *) codeAttributes.attributes[i].info;
@@ -1263,7 +1297,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                              JEMCC_Class_ClassFormatError, NULL,
                              "Invalid code line number attribute information");
                 JEM_DestroyMethodCode(retVal);
-                destroyAttributes(&codeAttributes);
+                JEM_ArenaRelease(&codeArena);
                 return NULL;
             }
             if (retVal->lineNumberTableLength != 0) {
@@ -1273,7 +1307,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                 if (retVal->lineNumberTable == NULL) {
                     retVal->lineNumberTableLength = 0;
                     JEM_DestroyMethodCode(retVal);
-                    destroyAttributes(&codeAttributes);
+                    JEM_ArenaRelease(&codeArena);
                     return NULL;
                 }
             }
@@ -1286,7 +1320,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                 JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ClassFormatError,
                                            NULL, endOfCodeMsg);
                 JEM_DestroyMethodCode(retVal);
-                destroyAttributes(&codeAttributes);
+                JEM_ArenaRelease(&codeArena);
                 return NULL;
             }
             buffPtr = (jubyte *) codeAttributes.attributes[i].info;
@@ -1298,7 +1332,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                           JEMCC_Class_ClassFormatError, NULL,
                           "Invalid code local variable attribute information");
                 JEM_DestroyMethodCode(retVal);
-                destroyAttributes(&codeAttributes);
+                JEM_ArenaRelease(&codeArena);
                 return NULL;
             }
             if (retVal->localVariableTableLength != 0) {
@@ -1308,7 +1342,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                 if (retVal->localVariableTable == NULL) {
                     retVal->localVariableTableLength = 0;
                     JEM_DestroyMethodCode(retVal);
-                    destroyAttributes(&codeAttributes);
+                    JEM_ArenaRelease(&codeArena);
                     return NULL;
                 }
             }
@@ -1320,14 +1354,15 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                 if (checkConstantPoolType(env, classData, index, CONSTANT_Utf8,
                                "Invalid local variable name index") != JNI_OK) {
                     JEM_DestroyMethodCode(retVal);
-                    destroyAttributes(&codeAttributes);
+                    JEM_ArenaRelease(&codeArena);
                     return NULL;
                 }
                 ptr = classData->constantPool[index - 1].utf8_info.bytes;
-                retVal->localVariableTable[j].name = JEMCC_StrDupFn(env, ptr);
+                retVal->localVariableTable[j].name =
+                                                   JEM_InternSymbol(env, ptr);
                 if (retVal->localVariableTable[j].name == NULL) {
                     JEM_DestroyMethodCode(retVal);
-                    destroyAttributes(&codeAttributes);
+                    JEM_ArenaRelease(&codeArena);
                     return NULL;
                 }
 
@@ -1335,15 +1370,15 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
                 if (checkConstantPoolType(env, classData, index, CONSTANT_Utf8, 
                                "Invalid local variable desc index") != JNI_OK) {
                     JEM_DestroyMethodCode(retVal);
-                    destroyAttributes(&codeAttributes);
+                    JEM_ArenaRelease(&codeArena);
                     return NULL;
                 }
                 ptr = classData->constantPool[index - 1].utf8_info.bytes;
-                retVal->localVariableTable[j].descriptor = 
-                                                   JEMCC_StrDupFn(env, ptr);
+                retVal->localVariableTable[j].descriptor =
+                                                   JEM_InternSymbol(env, ptr);
                 if (retVal->localVariableTable[j].descriptor == NULL) {
                     JEM_DestroyMethodCode(retVal);
-                    destroyAttributes(&codeAttributes);
+                    JEM_ArenaRelease(&codeArena);
                     return NULL;
                 }
 
@@ -1353,7 +1388,7 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
 #endif
         /* Everything else is ignorable */
     }
-    destroyAttributes(&codeAttributes);
+    JEM_ArenaRelease(&codeArena);
 
     /* That should be a perfect fit */
     if (buffLen != 0) {
@@ -1375,18 +1410,20 @@ JEM_BCMethod *JEM_ParseMethodCode(JNIEnv *env, const jbyte *buffer,
  *              to be destroyed
  */
 void JEM_DestroyMethodCode(JEM_BCMethod *method) {
-#ifndef NO_JVM_DEBUG
     int i;
-#endif
 
     JEMCC_Free(method->code);
     JEMCC_Free(method->exceptionTable);
+    JEMCC_Free(method->handlerRanges);
+    JEMCC_Free(method->callSiteCaches);
+    for (i = 0; i < method->switchTableCount; i++) {
+        /* Keys (if any) share the target allocation */
+        JEMCC_Free(method->switchTables[i].targetPCs);
+    }
+    JEMCC_Free(method->switchTables);
 #ifndef NO_JVM_DEBUG
+    /* Note that the local variable names/descriptors are interned */
     JEMCC_Free(method->lineNumberTable);
-    for (i = 0; i < method->localVariableTableLength; i++) {
-        JEMCC_Free(method->localVariableTable[i].name);
-        JEMCC_Free(method->localVariableTable[i].descriptor);
-    }
     JEMCC_Free(method->localVariableTable);
 #endif
 
@@ -62,7 +62,11 @@ static void pack_u2(u2 val, jubyte **ptr) {
 
 #define VALID_OPCODE_FLAG 1
 
-/* Instruction lengths by opcode (including opcode itself) */
+/*
+ * Instruction lengths by opcode (including opcode itself).  Note that the
+ * internal "quick" opcodes (see JEM_QuickenClassByteCode) are marked invalid,
+ * as they may only appear in bytecode that has already been verified.
+ */
 jbyte opInstLengths[] = {
 1 /* 0 - "nop" */,
 1 /* 1 - "aconst_null" */,
@@ -267,22 +271,22 @@ jbyte opInstLengths[] = {
 5 /* 200 - "goto_w" */,
 5 /* 201 - "jsr_w" */,
 -1 /* 202 - "breakpoint" */,
--1 /* 203 - invalid */,
--1 /* 204 - invalid */,
--1 /* 205 - invalid */,
--1 /* 206 - invalid */,
--1 /* 207 - invalid */,
--1 /* 208 - invalid */,
--1 /* 209 - invalid */,
--1 /* 210 - invalid */,
--1 /* 211 - invalid */,
--1 /* 212 - invalid */,
--1 /* 213 - invalid */,
--1 /* 214 - invalid */,
--1 /* 215 - invalid */,
--1 /* 216 - invalid */,
--1 /* 217 - invalid */,
--1 /* 218 - invalid */,
+-1 /* 203 - "getfield_quick_byte" (internal) */,
+-1 /* 204 - "getfield_quick_char" (internal) */,
+-1 /* 205 - "getfield_quick_short" (internal) */,
+-1 /* 206 - "getfield_quick_int" (internal) */,
+-1 /* 207 - "getfield_quick_long" (internal) */,
+-1 /* 208 - "getfield_quick_object" (internal) */,
+-1 /* 209 - "putfield_quick_byte" (internal) */,
+-1 /* 210 - "putfield_quick_char" (internal) */,
+-1 /* 211 - "putfield_quick_short" (internal) */,
+-1 /* 212 - "putfield_quick_int" (internal) */,
+-1 /* 213 - "putfield_quick_long" (internal) */,
+-1 /* 214 - "putfield_quick_object" (internal) */,
+-1 /* 215 - "invokevirtual_quick" (internal) */,
+-1 /* 216 - "invokeinterface_quick" (internal) */,
+-1 /* 217 - "tableswitch_quick" (internal) */,
+-1 /* 218 - "lookupswitch_quick" (internal) */,
 -1 /* 219 - invalid */,
 -1 /* 220 - invalid */,
 -1 /* 221 - invalid */,
@@ -666,6 +670,277 @@ XXXX
     return JNI_OK;
 }
 
+/*
+ * Mapping from the field descriptor type to the corresponding getfield
+ * "quick" opcode.  The putfield equivalents follow at a fixed offset.  As
+ * the quick variants simply copy the storage unit, the int/float and
+ * long/double pairs share the same opcode.
+ */
+#define PUTFIELD_QUICK_OFFSET 6
+
+static int getQuickFieldOpCode(JEM_ClassFieldData *fieldRef) {
+    switch (fieldRef->descriptor->generic.tag) {
+        case BASETYPE_Boolean:
+        case BASETYPE_Byte:
+            return 203; /* getfield_quick_byte */
+        case BASETYPE_Char:
+            return 204; /* getfield_quick_char */
+        case BASETYPE_Short:
+            return 205; /* getfield_quick_short */
+        case BASETYPE_Int:
+        case BASETYPE_Float:
+            return 206; /* getfield_quick_int */
+        case BASETYPE_Long:
+        case BASETYPE_Double:
+            return 207; /* getfield_quick_long */
+        case DESCRIPTOR_ObjectType:
+        case DESCRIPTOR_ArrayType:
+            return 208; /* getfield_quick_object */
+    }
+
+    return -1;
+}
+
+/*
+ * Determine the location of the instruction following the one at the given
+ * program counter.  Only handles the standard opcodes (used prior to any
+ * rewriting of the method code).
+ */
+static int getNextInstructionPC(jubyte *byteCode, int pc) {
+    jubyte opCode = byteCode[pc], *bytePtr;
+    jint tblCount, lowIndex, highIndex;
+
+    if (opInstLengths[(int) opCode] > 0) {
+        pc += opInstLengths[(int) opCode];
+    } else if (opCode == 196) {
+        /* Wide cases, only iinc has the extended form */
+        pc += (byteCode[pc + 1] == 132) ? 6 : 4;
+    } else if (opCode == 170) {
+        /* Table switch - round and jump table list */
+        pc = (((pc + 4) >> 2) << 2) + 4;
+        bytePtr = byteCode + pc;
+        lowIndex = (jint) read_u4((const jubyte **) &bytePtr);
+        highIndex = (jint) read_u4((const jubyte **) &bytePtr);
+        pc += (highIndex - lowIndex + 1) * 4 + 8;
+    } else if (opCode == 171) {
+        /* Lookup switch - round and jump table list */
+        pc = (((pc + 4) >> 2) << 2) + 4;
+        bytePtr = byteCode + pc;
+        tblCount = (jint) read_u4((const jubyte **) &bytePtr);
+        pc += tblCount * 8 + 4;
+    } else {
+        /* Cannot happen with verified code, but don't spin */
+        return -1;
+    }
+
+    return pc;
+}
+
+/*
+ * Determine if the invokevirtual/invokeinterface instruction at the given
+ * location references a resolved method (and can use an inline cache).
+ */
+static JEM_ClassMethodData *getCallSiteMethod(JEM_ClassData *classData,
+                                              jubyte *byteCode, int pc) {
+    JEM_ClassMethodData *methodRef;
+    jubyte *bytePtr = byteCode + pc + 1;
+
+    methodRef = classData->classMethodRefs[
+                                 (int) read_u2((const jubyte **) &bytePtr)];
+    if ((methodRef == NULL) ||
+        ((methodRef->accessFlags & ACC_RESOLVE_ERROR) != 0)) return NULL;
+    return methodRef;
+}
+
+/*
+ * Decode the tableswitch/lookupswitch instruction at the given location into
+ * the provided switch table, converting the jump offsets to absolute program
+ * counter locations.  Returns JNI_OK if decoded, JNI_ERR if the lookupswitch
+ * keys are not in the required ascending order (the instruction is left in
+ * the standard form) or JNI_ENOMEM if the table allocation failed.
+ */
+static jint decodeSwitchTable(JNIEnv *env, JEM_SwitchTable *table,
+                              jubyte *byteCode, int pc) {
+    jubyte opCode = byteCode[pc], *bytePtr;
+    jint i, lowIndex, highIndex, count, offset;
+
+    bytePtr = byteCode + (((pc + 4) >> 2) << 2);
+    table->defaultPC = pc + (jint) read_u4((const jubyte **) &bytePtr);
+    if (opCode == 170) {
+        lowIndex = (jint) read_u4((const jubyte **) &bytePtr);
+        highIndex = (jint) read_u4((const jubyte **) &bytePtr);
+        count = highIndex - lowIndex + 1;
+    } else {
+        lowIndex = 0;
+        count = (jint) read_u4((const jubyte **) &bytePtr);
+    }
+
+    /* Single allocation, lookup keys follow the targets */
+    i = ((count > 0) ? count : 1) * ((opCode == 170) ? 1 : 2);
+    table->targetPCs = (jint *) JEMCC_Malloc(env, i * sizeof(jint));
+    if (table->targetPCs == NULL) return JNI_ENOMEM;
+    table->lowIndex = lowIndex;
+    table->count = count;
+
+    if (opCode == 170) {
+        for (i = 0; i < count; i++) {
+            offset = (jint) read_u4((const jubyte **) &bytePtr);
+            table->targetPCs[i] = pc + offset;
+        }
+    } else {
+        table->keys = table->targetPCs + count;
+        for (i = 0; i < count; i++) {
+            table->keys[i] = (jint) read_u4((const jubyte **) &bytePtr);
+            offset = (jint) read_u4((const jubyte **) &bytePtr);
+            table->targetPCs[i] = pc + offset;
+            if ((i > 0) && (table->keys[i] <= table->keys[i - 1])) {
+                JEMCC_Free(table->targetPCs);
+                table->targetPCs = NULL;
+                table->keys = NULL;
+                table->count = 0;
+                return JNI_ERR;
+            }
+        }
+    }
+
+    return JNI_OK;
+}
+
+/**
+ * Rewrite ("quicken") the verified method bytecode of the given class for
+ * faster interpretation.  Instance field operations (getfield/putfield) whose
+ * references have been successfully resolved are replaced with internal
+ * quick opcodes, where the operand is the object data offset of the field
+ * and the opcode itself encodes the storage type.  This avoids the field
+ * reference table lookup, the resolution test and the descriptor type switch
+ * on every field access.  Similarly, resolved invokevirtual/invokeinterface
+ * calls are replaced with quick opcodes whose operand is the index of an
+ * inline cache for the call site, allocated per method.  Unresolved (error)
+ * references are left as-is, so that the standard opcodes can raise the
+ * appropriate exception.  Switch instructions are decoded into per-method
+ * tables (direct index for tableswitch, sorted keys for a binary search in
+ * lookupswitch) and replaced with quick opcodes whose operand is the table
+ * index, removing the operand alignment and byte order decoding from every
+ * execution.
+ *
+ * Note: this must be called after JEM_VerifyClassByteCode, as it relies on
+ *       the remapped class field/method reference indices and the structural
+ *       validity of the bytecode.  The rewrite is done in place and does not
+ *       alter the instruction lengths (or branch offsets).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     classData - the linked and verified class instance information
+ *
+ * Returns:
+ *     JNI_OK - the class bytecode was quickened
+ *     JNI_ENOMEM - a memory allocation failed for the call site caches and
+ *                  an OutOfMemory error has been thrown in the current
+ *                  environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_QuickenClassByteCode(JNIEnv *env, JEM_ClassData *classData) {
+    JEM_ClassMethodData *methodRef;
+    JEM_ClassFieldData *fieldRef;
+    JEM_BCMethod *bcMethodPtr;
+    jubyte opCode, *byteCode, *bytePtr;
+    int pc, nextPC, len, passIdx, fieldIdx, siteIdx, switchIdx, quickOpCode;
+    jint rc;
+
+    for (passIdx = 0; passIdx < classData->localMethodCount; passIdx++) {
+        bcMethodPtr = classData->localMethods[passIdx].method.bcMethod;
+        if (bcMethodPtr == NULL) continue;
+
+        len = bcMethodPtr->codeLength;
+        byteCode = bcMethodPtr->code;
+
+        /* First pass, count/allocate the call site caches and switches */
+        siteIdx = 0;
+        switchIdx = 0;
+        pc = 0;
+        while ((pc >= 0) && (pc < len)) {
+            opCode = byteCode[pc];
+            if ((opCode == 182) || (opCode == 185)) {
+                if (getCallSiteMethod(classData, byteCode, pc) != NULL) {
+                    siteIdx++;
+                }
+            } else if ((opCode == 170) || (opCode == 171)) {
+                switchIdx++;
+            }
+            pc = getNextInstructionPC(byteCode, pc);
+        }
+        if (siteIdx != 0) {
+            bcMethodPtr->callSiteCaches = (JEM_CallSiteCache *) JEMCC_Malloc(
+                                  env, siteIdx * sizeof(JEM_CallSiteCache));
+            if (bcMethodPtr->callSiteCaches == NULL) return JNI_ENOMEM;
+            bcMethodPtr->callSiteCount = siteIdx;
+        }
+        if ((switchIdx != 0) && (switchIdx <= 0xFFFF)) {
+            bcMethodPtr->switchTables = (JEM_SwitchTable *) JEMCC_Malloc(
+                                  env, switchIdx * sizeof(JEM_SwitchTable));
+            if (bcMethodPtr->switchTables == NULL) return JNI_ENOMEM;
+            bcMethodPtr->switchTableCount = switchIdx;
+        }
+
+        /* Second pass, rewrite the instructions into the quick forms */
+        siteIdx = 0;
+        switchIdx = 0;
+        pc = 0;
+        while ((pc >= 0) && (pc < len)) {
+            opCode = byteCode[pc];
+            nextPC = getNextInstructionPC(byteCode, pc);
+            if ((opCode == 180) || (opCode == 181)) {
+                /* getfield/putfield, only rewrite resolved instance fields */
+                bytePtr = byteCode + pc + 1;
+                fieldIdx = (int) read_u2((const jubyte **) &bytePtr);
+                fieldRef = classData->classFieldRefs[fieldIdx];
+                quickOpCode = -1;
+                if ((fieldRef != NULL) &&
+                    ((fieldRef->accessFlags &
+                              (ACC_RESOLVE_ERROR | ACC_STATIC)) == 0) &&
+                    (fieldRef->fieldOffset >= 0) &&
+                    (fieldRef->fieldOffset <= 0xFFFF)) {
+                    quickOpCode = getQuickFieldOpCode(fieldRef);
+                }
+                if (quickOpCode > 0) {
+                    if (opCode == 181) quickOpCode += PUTFIELD_QUICK_OFFSET;
+                    byteCode[pc] = (jubyte) quickOpCode;
+                    bytePtr = byteCode + pc + 1;
+                    pack_u2((u2) fieldRef->fieldOffset, (jubyte **) &bytePtr);
+                }
+            } else if ((opCode == 182) || (opCode == 185)) {
+                /* invokevirtual/invokeinterface, attach call site cache */
+                methodRef = getCallSiteMethod(classData, byteCode, pc);
+                if (methodRef != NULL) {
+                    bcMethodPtr->callSiteCaches[siteIdx].methodRef = methodRef;
+                    byteCode[pc] = (jubyte) ((opCode == 182) ? 215 : 216);
+                    bytePtr = byteCode + pc + 1;
+                    pack_u2((u2) siteIdx, (jubyte **) &bytePtr);
+                    siteIdx++;
+                }
+            } else if (((opCode == 170) || (opCode == 171)) &&
+                       (switchIdx < bcMethodPtr->switchTableCount)) {
+                /* Switches always have at least two operand bytes to reuse */
+                rc = decodeSwitchTable(env,
+                                       bcMethodPtr->switchTables + switchIdx,
+                                       byteCode, pc);
+                if (rc == JNI_ENOMEM) return JNI_ENOMEM;
+                if (rc == JNI_OK) {
+                    byteCode[pc] = (jubyte) ((opCode == 170) ? 217 : 218);
+                    bytePtr = byteCode + pc + 1;
+                    pack_u2((u2) switchIdx, (jubyte **) &bytePtr);
+                }
+                switchIdx++;
+            }
+            pc = nextPC;
+        }
+    }
+
+    return JNI_OK;
+}
+
 /* For reference purposes, here is the opcode table */
 /* 0 - "nop" */
 /* 1 - "aconst_null" */
@@ -870,22 +1145,22 @@ XXXX
 /* 200 - "goto_w" */
 /* 201 - "jsr_w" */
 /* 202 - "breakpoint" */
-/* 203 - invalid */
-/* 204 - invalid */
-/* 205 - invalid */
-/* 206 - invalid */
-/* 207 - invalid */
-/* 208 - invalid */
-/* 209 - invalid */
-/* 210 - invalid */
-/* 211 - invalid */
-/* 212 - invalid */
-/* 213 - invalid */
-/* 214 - invalid */
-/* 215 - invalid */
-/* 216 - invalid */
-/* 217 - invalid */
-/* 218 - invalid */
+/* 203 - "getfield_quick_byte" (internal) */
+/* 204 - "getfield_quick_char" (internal) */
+/* 205 - "getfield_quick_short" (internal) */
+/* 206 - "getfield_quick_int" (internal) */
+/* 207 - "getfield_quick_long" (internal) */
+/* 208 - "getfield_quick_object" (internal) */
+/* 209 - "putfield_quick_byte" (internal) */
+/* 210 - "putfield_quick_char" (internal) */
+/* 211 - "putfield_quick_short" (internal) */
+/* 212 - "putfield_quick_int" (internal) */
+/* 213 - "putfield_quick_long" (internal) */
+/* 214 - "putfield_quick_object" (internal) */
+/* 215 - "invokevirtual_quick" (internal) */
+/* 216 - "invokeinterface_quick" (internal) */
+/* 217 - "tableswitch_quick" (internal) */
+/* 218 - "lookupswitch_quick" (internal) */
 /* 219 - invalid */
 /* 220 - invalid */
 /* 221 - invalid */
@@ -23,6 +23,9 @@
  */
 #include "jeminc.h"
 #include <math.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /* Read the VM structure/method definitions */
 #include "jem.h"
@@ -32,6 +35,62 @@
 #undef DEBUG_CPU_INTERNALS 
 /* #define DEBUG_CPU_INTERNALS 1 */
 
+#ifdef ENABLE_THREADED_DISPATCH
+/*
+ * Methods for reading opcode arguments from the interpreted method block,
+ * using the local code base and program counter of the threaded interpreter.
+ */
+static jushort read_code_op2(jubyte *code, jint *pc) {
+    jushort ret = ((jushort) code[(*pc)++]) << 8;
+    ret |= (jushort) code[(*pc)++];
+    return ret;
+}
+
+static juint read_code_op4(jubyte *code, jint *pc) {
+    juint ret = ((juint) code[(*pc)++]) << 24;
+    ret |= ((juint) code[(*pc)++]) << 16;
+    ret |= ((juint) code[(*pc)++]) << 8;
+    ret |= (juint) code[(*pc)++];
+    return ret;
+}
+
+/*
+ * Interpreter state accessors for the opcode definitions (opcodes.c).  The
+ * threaded interpreter holds the program counter, code base and operand stack
+ * top in local variables, which are only written back to the frame for the
+ * callout blocks (anything which may throw, invoke, return or allocate) and
+ * are reloaded from the top frame once the callout completes.  The callout
+ * block shadows the local state with the real frame information.
+ */
+#define JEM_PC (*pcPtr)
+#define READ_OP1() (codeBase[(*pcPtr)++])
+#define READ_OP2() read_code_op2(codeBase, pcPtr)
+#define READ_OP4() read_code_op4(codeBase, pcPtr)
+
+#define JEM_SAVE_STATE() \
+    (currentFrameExt->lastPC = lastPC, currentFrameExt->pc = pc, \
+     currentFrameExt->frameVars.operandStackTop = regFrame.operandStackTop)
+
+#define JEM_BEGIN_CALLOUT \
+    { \
+        JEMCC_VMFrame *currentFrame __attribute__ ((unused)) = \
+                  (JEM_SAVE_STATE(), (JEMCC_VMFrame *) currentFrameExt); \
+        jubyte *codeBase __attribute__ ((unused)) = \
+                  currentFrameExt->currentMethod->method.bcMethod->code; \
+        jint *pcPtr __attribute__ ((unused)) = &(currentFrameExt->pc);
+#define JEM_END_CALLOUT \
+    } \
+    goto reloadState;
+
+/* Safepoint poll (backward branches), the frame is made current first */
+#define JEM_SAFEPOINT_POLL() \
+    if (JEM_SAFEPOINT_PENDING(env)) { \
+        JEM_SAVE_STATE(); \
+        JEM_GCSafepoint(env); \
+    }
+
+#else
+
 /* Methods for reading opcodes/arguments from the interpreted method block */
 static jubyte read_op1(JEM_VMFrameExt *frame) {
     jubyte ret = (jubyte) 
@@ -57,6 +116,29 @@ static juint read_op4(JEM_VMFrameExt *frame) {
     return ret;
 }
 
+/* Interpreter state accessors for the opcode definitions (opcodes.c) */
+#define JEM_PC (currentFrameExt->pc)
+#define READ_OP1() read_op1(currentFrameExt)
+#define READ_OP2() read_op2(currentFrameExt)
+#define READ_OP4() read_op4(currentFrameExt)
+
+#define JEM_BEGIN_CALLOUT {
+#define JEM_END_CALLOUT }
+
+/* Safepoint poll (backward branches), the frame is always current */
+#define JEM_SAFEPOINT_POLL() \
+    if (JEM_SAFEPOINT_PENDING(env)) JEM_GCSafepoint(env);
+
+#endif
+
+/* Inline array index test, out of range conditions use the full check */
+#define JEM_ARRAY_INDEX_VALID(array, index) \
+                     (((index) >= 0) && ((index) < (array)->arrayLength))
+
+/* Failed class resolutions leave the (skeleton) throwable in the reference */
+#define JEM_CLASS_REF_RESOLVED(ref) \
+   (((ref) != NULL) && ((ref)->classReference == VM_CLASS(JEMCC_Class_Class)))
+
 /* Convenience sizes (the latter is the number of entries for frame header) */
 static int frameEntrySize = sizeof(JEM_FrameEntry);
 static int frameStructSize = ((int) ((sizeof(JEM_VMFrameExt) + 
@@ -64,6 +146,99 @@ static int frameStructSize = ((int) ((sizeof(JEM_VMFrameExt) +
                                             sizeof(JEM_FrameEntry))) *
                               sizeof(JEM_FrameEntry);
 
+/*
+ * Frame stack sizing.  Where mapping is available, the stack is a virtual
+ * reservation (pages are only committed as the stack reaches them) followed
+ * by an inaccessible guard page, otherwise it is a conventional allocation.
+ * The last part of the stack is held in reserve, for constructing the
+ * StackOverflowError and for VM internal operations (e.g. classloading)
+ * which push beyond the operand stack depth of the top frame.
+ */
+#ifdef HAVE_MMAP
+#define FRAME_STACK_SIZE (1024 * 1024)
+#else
+#define FRAME_STACK_SIZE (128 * 1024)
+#endif
+#define FRAME_STACK_RESERVE (16 * 1024)
+
+#if defined(HAVE_MMAP) && !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if defined(HAVE_MMAP) && !defined(MAP_NORESERVE)
+#define MAP_NORESERVE 0
+#endif
+
+/**
+ * Allocate the frame stack for a new environment and initialize the root
+ * frame.  Called before the environment is otherwise usable, so no
+ * exception is thrown on failure.
+ *
+ * Parameters:
+ *     env - the VM environment to allocate the frame stack for
+ *
+ * Returns:
+ *     JNI_OK - the frame stack was allocated and initialized
+ *     JNI_ENOMEM - the frame stack memory could not be allocated
+ */
+jint JEM_CreateFrameStack(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_VMFrameExt *rootFrame;
+    jbyte *block;
+#ifdef HAVE_MMAP
+    int pageSize = getpagesize();
+
+    block = (jbyte *) mmap(NULL, FRAME_STACK_SIZE + pageSize,
+                           PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (block == (jbyte *) MAP_FAILED) return JNI_ENOMEM;
+    if (mprotect(block + FRAME_STACK_SIZE, pageSize, PROT_NONE) != 0) {
+        (void) munmap(block, FRAME_STACK_SIZE + pageSize);
+        return JNI_ENOMEM;
+    }
+#else
+    block = (jbyte *) calloc(FRAME_STACK_SIZE, 1);
+    if (block == NULL) return JNI_ENOMEM;
+#endif
+    jenv->frameStackBlock = block;
+    jenv->frameStackBlockSize = FRAME_STACK_SIZE;
+    jenv->frameStackLimit = FRAME_STACK_SIZE - FRAME_STACK_RESERVE;
+
+    rootFrame = (JEM_VMFrameExt *) block;
+    rootFrame->frameVars.operandStackTop = NULL;
+    rootFrame->frameVars.localVars = NULL;
+    rootFrame->opFlags = FRAME_ROOT;
+    rootFrame->previousFrame = NULL;
+    rootFrame->frameDepth = 1;
+    rootFrame->currentMethod = NULL;
+    rootFrame->firstAllocObjectRecord = NULL;
+    rootFrame->allocPrevRecord = NULL;
+    rootFrame->allocRegionBlock = NULL;
+    rootFrame->allocRegionPtr = NULL;
+    jenv->topFrame = rootFrame;
+
+    return JNI_OK;
+}
+
+/**
+ * Release the frame stack of an environment.
+ *
+ * Parameters:
+ *     env - the VM environment to release the frame stack for
+ */
+void JEM_DestroyFrameStack(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+
+    if (jenv->frameStackBlock == NULL) return;
+#ifdef HAVE_MMAP
+    (void) munmap(jenv->frameStackBlock,
+                  jenv->frameStackBlockSize + getpagesize());
+#else
+    free(jenv->frameStackBlock);
+#endif
+    jenv->frameStackBlock = NULL;
+    jenv->topFrame = NULL;
+}
+
 /**
  * Debugging method to provide details on the execution state of the 
  * current execution frame.
@@ -158,17 +333,18 @@ void JEM_DumpFrame(JNIEnv *env) {
  *                       for method use
  *
  * Returns:
- *     The new execution frame instance or NULL if a memory allocation
- *     failed (an exception will be thrown in the current environment).
+ *     The new execution frame instance or NULL if the frame could not be
+ *     allocated (an exception will be thrown in the current environment).
  *
  *  Exceptions:
- *     OutOfMemoryError - a memory allocation failed in creating the frame
+ *     StackOverflowError - the new frame has exceeded the frame stack
  */
 JEMCC_VMFrame *JEM_CreateFrame(JNIEnv *env, int frameType, int methodArgCount,
                                int localVarCount, int maxOpStackCount) {
     JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
     JEM_VMFrameExt *newFrame = NULL;
     int offset, lastFrameEndOffset = 0, newFrameBeginOffset = 0;
+    int frameFlags = 0;
 
     /* Ensure consistency of the localVar/opStack data */
     if ((frameType == FRAME_NATIVE) || (frameType == FRAME_ROOT)) {
@@ -177,9 +353,8 @@ JEMCC_VMFrame *JEM_CreateFrame(JNIEnv *env, int frameType, int methodArgCount,
         localVarCount = methodArgCount;
     } 
 
-    /* Ensure sufficient stack space for internal VM operations (classload) */
+    /* Internal VM operations beyond the stack depth use the reserve area */
     if (maxOpStackCount < 0) maxOpStackCount = 0;
-    maxOpStackCount += 16;
 
     /* 
      * Note that the frame support is complicated by the alignment requirements
@@ -228,20 +403,22 @@ JEMCC_VMFrame *JEM_CreateFrame(JNIEnv *env, int frameType, int methodArgCount,
     }
 
     /* Ensure sufficient stack space for new frame */
-#ifdef ENABLE_MEMSWEEP
-/* TODO FIX THIS SO IT ALWAYS MALLOCS! */
     if ((newFrameBeginOffset + frameStructSize + 
-               maxOpStackCount * frameEntrySize) > jenv->frameStackBlockSize) {
-#else
-    if ((newFrameBeginOffset + frameStructSize + 
-               maxOpStackCount * frameEntrySize) > jenv->frameStackBlockSize) {
-#endif
-        /* TODO - reallocate the frame */
-        /* TODO - capture out of stack space error */
-(void) fprintf(stderr, "NEED TO RESIZE FRAME!!!!!\n");
+               maxOpStackCount * frameEntrySize) > jenv->frameStackLimit) {
+        /* Open the reserve area to construct the error (but only once) */
+        if (jenv->frameStackLimit < jenv->frameStackBlockSize) {
+            jenv->frameStackLimit = jenv->frameStackBlockSize;
+            JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_StackOverflowError,
+                                       NULL, "Frame stack depth exceeded");
+            jenv->frameStackLimit = jenv->frameStackBlockSize -
+                                                   FRAME_STACK_RESERVE;
+        }
         return NULL;
     }
 
+    /* Calls from a native method return to the VM (until frame popped) */
+    if (JEM_GCResumeFromSafeRegion(env)) frameFlags = FRAME_SAFE_REGION;
+
     /* Build a new frame record and initialize the localVar/opStack pointers */
     newFrame = (JEM_VMFrameExt *) (((jbyte *) jenv->frameStackBlock) +
                                                            newFrameBeginOffset);
@@ -260,12 +437,18 @@ JEMCC_VMFrame *JEM_CreateFrame(JNIEnv *env, int frameType, int methodArgCount,
                                         localVarCount * frameEntrySize);
             break;
     }
-    newFrame->opFlags = frameType;
+    newFrame->opFlags = frameType | frameFlags;
     newFrame->previousFrame = jenv->topFrame;
     newFrame->frameDepth = jenv->topFrame->frameDepth + 1;
     newFrame->currentMethod = NULL;
     newFrame->pc = 0;
 
+    /* Mark the start of the allocation region for this frame */
+    newFrame->firstAllocObjectRecord = NULL;
+    newFrame->allocPrevRecord = jenv->lastAllocObjectRecord;
+    newFrame->allocRegionBlock = jenv->allocBlockList;
+    newFrame->allocRegionPtr = jenv->allocBlockPtr;
+
     /* Push this new frame onto the environment stack */
     jenv->topFrame = newFrame;
 
@@ -348,7 +531,9 @@ jint JEM_PushFrame(JNIEnv *env, jmethodID methodID, JEMCC_VMFrame **frameRef) {
 /**
  * Pop a method frame from the provided environment stack.  This will also
  * clean up any nested JNI local frames which have been allocated (if
- * within a JNI method instance).
+ * within a JNI method instance).  Bytecode frames flush their local objects
+ * (JEM_FlushLocalFrameAllocations) prior to popping, any objects remaining
+ * in the frame are promoted to the global heap.
  *
  * Parameters:
  *     env - the VM environment from which the frame is to be popped
@@ -356,6 +541,7 @@ jint JEM_PushFrame(JNIEnv *env, jmethodID methodID, JEMCC_VMFrame **frameRef) {
 void JEM_PopFrame(JNIEnv *env) {
     JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
     JEM_ClassMethodData *popMethod = jenv->topFrame->currentMethod;
+    juint popFlags = jenv->topFrame->opFlags;
 
     /* Avoid potential internal error where root frame ejects */
     if ((jenv->topFrame->opFlags & FRAME_TYPE_MASK) == FRAME_ROOT) {
@@ -364,9 +550,14 @@ void JEM_PopFrame(JNIEnv *env) {
     }
 
     /* TODO - handle the synchronize cases */
-    /* TODO - handle the local frame variable cleanup */
     /* TODO - handle pending exceptions stack storage */
 
+    /* Objects not flushed by the frame (native/JEMCC) are promoted */
+    if ((jenv->topFrame->firstAllocObjectRecord != NULL) ||
+        ((jenv->topFrame->opFlags & FRAME_REGION_PINNED) != 0)) {
+        JEM_PromoteLocalFrameAllocations(env);
+    }
+
     /* Eject the top frame record from the environment */
     jenv->topFrame = jenv->topFrame->previousFrame;
 
@@ -377,6 +568,9 @@ void JEM_PopFrame(JNIEnv *env) {
                                              popMethod->stackConsumeCount;
     }
 
+    /* Return to the safe region of a calling native method */
+    if ((popFlags & FRAME_SAFE_REGION) != 0) JEM_GCEnterSafeRegion(env);
+
 #ifdef DEBUG_CPU_INTERNALS
     fprintf(stderr, "<< Frame popped for %s%s\n", 
                     popMethod->name, popMethod->descriptorStr);
@@ -384,6 +578,145 @@ void JEM_PopFrame(JNIEnv *env) {
 #endif
 }
 
+/**
+ * Resolve the target method of a virtual or interface call site for the
+ * given receiver class (the slow path of the quick invoke opcodes, called
+ * when the inline cache does not contain the class).  If successful and the
+ * call site cache has room, the receiver class and target method are
+ * recorded in the next free cache entry.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     bcMethod - the bytecode method containing the call site (for the
+ *                optional call site statistics)
+ *     cache - the inline cache associated with the call site
+ *     receiverClass - the class of the target object of the call
+ *     isInterface - JNI_TRUE if this is an invokeinterface call site
+ *
+ * Returns:
+ *     The target method to be invoked or NULL if the method could not be
+ *     resolved (an exception has been thrown in the current environment).
+ *
+ * Exceptions:
+ *     IncompatibleClassChangeError - the interface was unmappable to the
+ *                                    receiver class
+ *     AbstractMethodError - the interface method is not implemented by
+ *                           the receiver class
+ */
+static JEM_ClassMethodData *JEM_ResolveCallSite(JNIEnv *env,
+                                                JEM_BCMethod *bcMethod,
+                                                JEM_CallSiteCache *cache,
+                                                JEMCC_Class *receiverClass,
+                                                jboolean isInterface) {
+    JEM_ClassData *targetClassData = receiverClass->classData;
+    JEM_ClassMethodData *methodRef = cache->methodRef, *targetMethodData;
+    JEMCC_Class **assignClassPtr;
+    int i;
+
+#ifdef ENABLE_CALLSITE_STATS
+    bcMethod->callSiteMisses++;
+#endif
+
+    if (isInterface == JNI_TRUE) {
+        /* Locate the interface assignment index */
+        assignClassPtr = targetClassData->assignList + 1;
+        for (i = 1; i <= targetClassData->assignmentCount; i++) {
+            if (*assignClassPtr == methodRef->parentClass) break;
+            assignClassPtr++;
+        }
+        if (i > targetClassData->assignmentCount) {
+            JEMCC_ThrowStdThrowableIdx(env,
+                                     JEMCC_Class_IncompatibleClassChangeError,
+                                     NULL, "interface call on invalid object");
+            return NULL;
+        }
+
+        /* Locate the target method based on interface index mapping */
+        targetMethodData = targetClassData->methodLinkTables[i]
+                                                    [methodRef->methodIndex];
+        if (targetMethodData == NULL) {
+            JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_AbstractMethodError,
+                                       NULL, methodRef->name);
+            return NULL;
+        }
+        targetMethodData = targetClassData->methodLinkTables[0]
+                                             [targetMethodData->methodIndex];
+    } else {
+        targetMethodData = targetClassData->methodLinkTables[0]
+                                                    [methodRef->methodIndex];
+    }
+
+    /* Record in the first free cache slot (entries are never replaced) */
+    if (cache->entries[JEM_CALLSITE_CACHE_SIZE - 1].receiverClass == NULL) {
+        if (JEMCC_EnterGlobalMonitor() == JNI_OK) {
+            for (i = 0; i < JEM_CALLSITE_CACHE_SIZE; i++) {
+                if (cache->entries[i].receiverClass == receiverClass) break;
+                if (cache->entries[i].receiverClass == NULL) {
+                    /* Publish the class (barrier) after the method */
+                    cache->entries[i].targetMethod = targetMethodData;
+                    (void) JEM_AtomicSwapPointer(
+                            (void **) &(cache->entries[i].receiverClass),
+                            receiverClass);
+                    break;
+                }
+            }
+            JEMCC_ExitGlobalMonitor();
+        }
+    }
+
+    return targetMethodData;
+}
+
+/**
+ * Determine the target method of a virtual or interface call site for the
+ * given target object, through the inline cache of the call site (falling
+ * back to JEM_ResolveCallSite if the receiver class is not cached).  Common
+ * element of the invokevirtual_quick/invokeinterface_quick opcodes.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     bcMethod - the bytecode method containing the call site
+ *     cache - the inline cache associated with the call site
+ *     targetObj - the target object of the call (may be NULL)
+ *     isInterface - JNI_TRUE if this is an invokeinterface call site
+ *
+ * Returns:
+ *     The target method to be invoked or NULL if the method could not be
+ *     resolved (an exception has been thrown in the current environment).
+ *
+ * Exceptions:
+ *     NullPointerException - the target object was NULL
+ *     As for JEM_ResolveCallSite above.
+ */
+static JEM_ClassMethodData *JEM_CallSiteTarget(JNIEnv *env,
+                                               JEM_BCMethod *bcMethod,
+                                               JEM_CallSiteCache *cache,
+                                               JEMCC_Object *targetObj,
+                                               jboolean isInterface) {
+    JEMCC_Class *receiverClass;
+    int i;
+
+    if (targetObj == NULL) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        return NULL;
+    }
+
+    /* Probe the inline cache before the full method lookup */
+    receiverClass = targetObj->classReference;
+    for (i = 0; i < JEM_CALLSITE_CACHE_SIZE; i++) {
+        if (cache->entries[i].receiverClass == receiverClass) {
+#ifdef ENABLE_CALLSITE_STATS
+            bcMethod->callSiteHits++;
+#endif
+            return cache->entries[i].targetMethod;
+        }
+    }
+
+    return JEM_ResolveCallSite(env, bcMethod, cache, receiverClass,
+                               isInterface);
+}
+
 /**
  * Execute the bytecode method on the top frame of the provided environment.
  *
@@ -393,6 +726,130 @@ void JEM_PopFrame(JNIEnv *env) {
  * Exceptions:
  *     Anything is possible, it is the bytecode interpreter after all.
  */
+#ifdef ENABLE_THREADED_DISPATCH
+/*
+ * Threaded (computed goto) variant of the bytecode interpreter, where the
+ * dispatch jump is replicated at the end of every opcode block (see the
+ * OPCODE macro in opcodes.c).  This gives the processor branch predictor a
+ * separate history for each opcode, rather than funnelling every instruction
+ * through the single indirect jump of the switch statement.  The frame
+ * type/depth tests are only made after callouts, the only point at which
+ * the frame stack can change.  Requires the GCC "labels as values"
+ * extension, hence the configure option.
+ */
+#define JEM_DISPATCH_NEXT() \
+    lastPC = pc; \
+    goto *opCodeTable[codeBase[pc++]]
+
+static void JEM_RunByteCodeInterpreter(JNIEnv *env) {
+    static void *opCodeTable[256] = {
+        [0 ... 255] = &&JEM_OP_UNKNOWN,
+        [0x0] = &&JEM_OP_0x0, [0x01] = &&JEM_OP_0x01, [0x02] = &&JEM_OP_0x02,
+        [0x03] = &&JEM_OP_0x03, [0x04] = &&JEM_OP_0x04, [0x05] = &&JEM_OP_0x05,
+        [0x06] = &&JEM_OP_0x06, [0x07] = &&JEM_OP_0x07, [0x08] = &&JEM_OP_0x08,
+        [0x09] = &&JEM_OP_0x09, [0x0a] = &&JEM_OP_0x0a, [0x0b] = &&JEM_OP_0x0b,
+        [0x0c] = &&JEM_OP_0x0c, [0x0d] = &&JEM_OP_0x0d, [0x0e] = &&JEM_OP_0x0e,
+        [0x0f] = &&JEM_OP_0x0f, [0x10] = &&JEM_OP_0x10, [0x11] = &&JEM_OP_0x11,
+        [0x12] = &&JEM_OP_0x12, [0x13] = &&JEM_OP_0x13, [0x14] = &&JEM_OP_0x14,
+        [0x15] = &&JEM_OP_0x15, [0x16] = &&JEM_OP_0x16, [0x17] = &&JEM_OP_0x17,
+        [0x18] = &&JEM_OP_0x18, [0x19] = &&JEM_OP_0x19, [0x1a] = &&JEM_OP_0x1a,
+        [0x1b] = &&JEM_OP_0x1b, [0x1c] = &&JEM_OP_0x1c, [0x1d] = &&JEM_OP_0x1d,
+        [0x1e] = &&JEM_OP_0x1e, [0x1f] = &&JEM_OP_0x1f, [0x20] = &&JEM_OP_0x20,
+        [0x21] = &&JEM_OP_0x21, [0x22] = &&JEM_OP_0x22, [0x23] = &&JEM_OP_0x23,
+        [0x24] = &&JEM_OP_0x24, [0x25] = &&JEM_OP_0x25, [0x26] = &&JEM_OP_0x26,
+        [0x27] = &&JEM_OP_0x27, [0x28] = &&JEM_OP_0x28, [0x29] = &&JEM_OP_0x29,
+        [0x2a] = &&JEM_OP_0x2a, [0x2b] = &&JEM_OP_0x2b, [0x2c] = &&JEM_OP_0x2c,
+        [0x2d] = &&JEM_OP_0x2d, [0x2e] = &&JEM_OP_0x2e, [0x2f] = &&JEM_OP_0x2f,
+        [0x30] = &&JEM_OP_0x30, [0x31] = &&JEM_OP_0x31, [0x32] = &&JEM_OP_0x32,
+        [0x33] = &&JEM_OP_0x33, [0x34] = &&JEM_OP_0x34, [0x35] = &&JEM_OP_0x35,
+        [0x36] = &&JEM_OP_0x36, [0x37] = &&JEM_OP_0x37, [0x38] = &&JEM_OP_0x38,
+        [0x39] = &&JEM_OP_0x39, [0x3a] = &&JEM_OP_0x3a, [0x3b] = &&JEM_OP_0x3b,
+        [0x3c] = &&JEM_OP_0x3c, [0x3d] = &&JEM_OP_0x3d, [0x3e] = &&JEM_OP_0x3e,
+        [0x3f] = &&JEM_OP_0x3f, [0x40] = &&JEM_OP_0x40, [0x41] = &&JEM_OP_0x41,
+        [0x42] = &&JEM_OP_0x42, [0x43] = &&JEM_OP_0x43, [0x44] = &&JEM_OP_0x44,
+        [0x45] = &&JEM_OP_0x45, [0x46] = &&JEM_OP_0x46, [0x47] = &&JEM_OP_0x47,
+        [0x48] = &&JEM_OP_0x48, [0x49] = &&JEM_OP_0x49, [0x4a] = &&JEM_OP_0x4a,
+        [0x4b] = &&JEM_OP_0x4b, [0x4c] = &&JEM_OP_0x4c, [0x4d] = &&JEM_OP_0x4d,
+        [0x4e] = &&JEM_OP_0x4e, [0x4f] = &&JEM_OP_0x4f, [0x50] = &&JEM_OP_0x50,
+        [0x51] = &&JEM_OP_0x51, [0x52] = &&JEM_OP_0x52, [0x53] = &&JEM_OP_0x53,
+        [0x54] = &&JEM_OP_0x54, [0x55] = &&JEM_OP_0x55, [0x56] = &&JEM_OP_0x56,
+        [0x57] = &&JEM_OP_0x57, [0x58] = &&JEM_OP_0x58, [0x59] = &&JEM_OP_0x59,
+        [0x5a] = &&JEM_OP_0x5a, [0x5b] = &&JEM_OP_0x5b, [0x5c] = &&JEM_OP_0x5c,
+        [0x5d] = &&JEM_OP_0x5d, [0x5e] = &&JEM_OP_0x5e, [0x5f] = &&JEM_OP_0x5f,
+        [0x60] = &&JEM_OP_0x60, [0x61] = &&JEM_OP_0x61, [0x62] = &&JEM_OP_0x62,
+        [0x63] = &&JEM_OP_0x63, [0x64] = &&JEM_OP_0x64, [0x65] = &&JEM_OP_0x65,
+        [0x66] = &&JEM_OP_0x66, [0x67] = &&JEM_OP_0x67, [0x68] = &&JEM_OP_0x68,
+        [0x69] = &&JEM_OP_0x69, [0x6a] = &&JEM_OP_0x6a, [0x6b] = &&JEM_OP_0x6b,
+        [0x6c] = &&JEM_OP_0x6c, [0x6d] = &&JEM_OP_0x6d, [0x6e] = &&JEM_OP_0x6e,
+        [0x6f] = &&JEM_OP_0x6f, [0x70] = &&JEM_OP_0x70, [0x71] = &&JEM_OP_0x71,
+        [0x72] = &&JEM_OP_0x72, [0x73] = &&JEM_OP_0x73, [0x74] = &&JEM_OP_0x74,
+        [0x75] = &&JEM_OP_0x75, [0x76] = &&JEM_OP_0x76, [0x77] = &&JEM_OP_0x77,
+        [0x78] = &&JEM_OP_0x78, [0x79] = &&JEM_OP_0x79, [0x7a] = &&JEM_OP_0x7a,
+        [0x7b] = &&JEM_OP_0x7b, [0x7c] = &&JEM_OP_0x7c, [0x7d] = &&JEM_OP_0x7d,
+        [0x7e] = &&JEM_OP_0x7e, [0x7f] = &&JEM_OP_0x7f, [0x80] = &&JEM_OP_0x80,
+        [0x81] = &&JEM_OP_0x81, [0x82] = &&JEM_OP_0x82, [0x83] = &&JEM_OP_0x83,
+        [0x84] = &&JEM_OP_0x84, [0x85] = &&JEM_OP_0x85, [0x86] = &&JEM_OP_0x86,
+        [0x87] = &&JEM_OP_0x87, [0x88] = &&JEM_OP_0x88, [0x89] = &&JEM_OP_0x89,
+        [0x8a] = &&JEM_OP_0x8a, [0x8b] = &&JEM_OP_0x8b, [0x8c] = &&JEM_OP_0x8c,
+        [0x8d] = &&JEM_OP_0x8d, [0x8e] = &&JEM_OP_0x8e, [0x8f] = &&JEM_OP_0x8f,
+        [0x90] = &&JEM_OP_0x90, [0x91] = &&JEM_OP_0x91, [0x92] = &&JEM_OP_0x92,
+        [0x93] = &&JEM_OP_0x93, [0x94] = &&JEM_OP_0x94, [0x95] = &&JEM_OP_0x95,
+        [0x96] = &&JEM_OP_0x96, [0x97] = &&JEM_OP_0x97, [0x98] = &&JEM_OP_0x98,
+        [0x99] = &&JEM_OP_0x99, [0x9a] = &&JEM_OP_0x9a, [0x9b] = &&JEM_OP_0x9b,
+        [0x9c] = &&JEM_OP_0x9c, [0x9d] = &&JEM_OP_0x9d, [0x9e] = &&JEM_OP_0x9e,
+        [0x9f] = &&JEM_OP_0x9f, [0xa0] = &&JEM_OP_0xa0, [0xa1] = &&JEM_OP_0xa1,
+        [0xa2] = &&JEM_OP_0xa2, [0xa3] = &&JEM_OP_0xa3, [0xa4] = &&JEM_OP_0xa4,
+        [0xa5] = &&JEM_OP_0xa5, [0xa6] = &&JEM_OP_0xa6, [0xa7] = &&JEM_OP_0xa7,
+        [0xa8] = &&JEM_OP_0xa8, [0xa9] = &&JEM_OP_0xa9, [0xaa] = &&JEM_OP_0xaa,
+        [0xab] = &&JEM_OP_0xab, [0xac] = &&JEM_OP_0xac, [0xad] = &&JEM_OP_0xad,
+        [0xae] = &&JEM_OP_0xae, [0xaf] = &&JEM_OP_0xaf, [0xb0] = &&JEM_OP_0xb0,
+        [0xb1] = &&JEM_OP_0xb1, [0xb2] = &&JEM_OP_0xb2, [0xb3] = &&JEM_OP_0xb3,
+        [0xb4] = &&JEM_OP_0xb4, [0xb5] = &&JEM_OP_0xb5, [0xb6] = &&JEM_OP_0xb6,
+        [0xb7] = &&JEM_OP_0xb7, [0xb8] = &&JEM_OP_0xb8, [0xb9] = &&JEM_OP_0xb9,
+        [0xbb] = &&JEM_OP_0xbb, [0xbc] = &&JEM_OP_0xbc, [0xbd] = &&JEM_OP_0xbd,
+        [0xbe] = &&JEM_OP_0xbe, [0xbf] = &&JEM_OP_0xbf, [0xc0] = &&JEM_OP_0xc0,
+        [0xc1] = &&JEM_OP_0xc1, [0xc2] = &&JEM_OP_0xc2, [0xc3] = &&JEM_OP_0xc3,
+        [0xc4] = &&JEM_OP_0xc4, [0xc5] = &&JEM_OP_0xc5, [0xc6] = &&JEM_OP_0xc6,
+        [0xc7] = &&JEM_OP_0xc7, [0xc8] = &&JEM_OP_0xc8, [0xc9] = &&JEM_OP_0xc9,
+        [0xca] = &&JEM_OP_0xca, [0xcb] = &&JEM_OP_0xcb, [0xcc] = &&JEM_OP_0xcc,
+        [0xcd] = &&JEM_OP_0xcd, [0xce] = &&JEM_OP_0xce, [0xcf] = &&JEM_OP_0xcf,
+        [0xd0] = &&JEM_OP_0xd0, [0xd1] = &&JEM_OP_0xd1, [0xd2] = &&JEM_OP_0xd2,
+        [0xd3] = &&JEM_OP_0xd3, [0xd4] = &&JEM_OP_0xd4, [0xd5] = &&JEM_OP_0xd5,
+        [0xd6] = &&JEM_OP_0xd6, [0xd7] = &&JEM_OP_0xd7, [0xd8] = &&JEM_OP_0xd8,
+        [0xd9] = &&JEM_OP_0xd9, [0xda] = &&JEM_OP_0xda,
+        [0xff] = &&JEM_OP_0xff
+    };
+    JEM_VMFrameExt *currentFrameExt;
+    JEMCC_VMFrame regFrame, *const currentFrame = &regFrame;
+    jint pc, lastPC, *const pcPtr = &pc;
+    jubyte *codeBase;
+    juint entryFrameDepth;
+
+    /* Jump through the opcode labels until the bytecode frame exits */
+    entryFrameDepth = ((JEM_JNIEnv *) env)->topFrame->frameDepth;
+
+reloadState:
+    /* Load the local state from the top frame, if still interpreting */
+    currentFrameExt = ((JEM_JNIEnv *) env)->topFrame;
+    if (((currentFrameExt->opFlags & FRAME_TYPE_MASK) != FRAME_BYTECODE) ||
+        (currentFrameExt->frameDepth < entryFrameDepth)) return;
+    regFrame = currentFrameExt->frameVars;
+    codeBase = currentFrameExt->currentMethod->method.bcMethod->code;
+    pc = currentFrameExt->pc;
+    lastPC = pc;
+    if (JEM_SAFEPOINT_PENDING(env)) JEM_GCSafepoint(env);
+    JEM_DISPATCH_NEXT();
+
+JEM_OP_UNKNOWN:
+    /* Undefined or reserved opcode in unverified code, fault the method */
+    JEM_BEGIN_CALLOUT
+    JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError,
+                               NULL, "Unknown bytecode opcode");
+    JEM_END_CALLOUT
+#include "opcodes.c"
+    JEM_DISPATCH_NEXT();
+}
+#else
 static void JEM_RunByteCodeInterpreter(JNIEnv *env) {
     JEM_VMFrameExt *currentFrameExt;
     JEMCC_VMFrame *currentFrame;
@@ -409,14 +866,21 @@ static void JEM_RunByteCodeInterpreter(JNIEnv *env) {
                                         bcMethod->code[currentFrameExt->pc++];
         switch (opCode) {
             default:
-                /* TODO - Ack Barf! */
+                /* Undefined or reserved opcode in unverified code */
+                JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError,
+                                           NULL, "Unknown bytecode opcode");
 #include "opcodes.c"
                 break;
         }
-        currentFrameExt = ((JEM_JNIEnv *) env)->topFrame;
+        if (currentFrameExt != ((JEM_JNIEnv *) env)->topFrame) {
+            /* Frame change (call/return) is also a safepoint */
+            currentFrameExt = ((JEM_JNIEnv *) env)->topFrame;
+            JEM_SAFEPOINT_POLL();
+        }
     } while (((currentFrameExt->opFlags & FRAME_TYPE_MASK) == FRAME_BYTECODE) &&
              (currentFrameExt->frameDepth >= entryFrameDepth));
 }
+#endif
 
 /**
  * Convenience method to mangle the contents of the provided source
@@ -610,11 +1074,17 @@ void JEM_ExecuteCurrentFrame(JNIEnv *env, jboolean fromByteCode) {
 
             /* TODO - need to build argument list */
 
-            /* Make the call */
+            /*
+             * Make the call, in a safe region as the native method cannot
+             * reach a safepoint poll (heap and frame operations through the
+             * JNI interfaces temporarily return to the VM).
+             */
+            JEM_GCEnterSafeRegion(env);
             JEM_CallForeignFunction(env, NULL, 
                                     currentMethod->method.ntvMethod,
                                     currentMethod->descriptor,
                                     NULL, &retVal);
+            JEM_GCLeaveSafeRegion(env);
 
             /* Remove this frame and process any pending native exceptions */
             JEM_PopFrame(env);
@@ -35,6 +35,57 @@ extern void JEM_PopFrame(JNIEnv *env);
 extern jint JEM_Throwable_InitStackTrace(JNIEnv *env, JEMCC_Object *throwable,
                                          jboolean fromConstructor);
 
+/**
+ * Locate the handler range of the method which covers the given PC, through
+ * a binary search of the sorted range index (see JEM_HandlerRange).
+ *
+ * Parameters:
+ *     bcMethod - the bytecode method to search the handler ranges of
+ *     pc - the location of the instruction which raised the throwable
+ *
+ * Returns:
+ *     The range covering the PC or NULL if no handlers are active.
+ */
+static JEM_HandlerRange *findHandlerRange(JEM_BCMethod *bcMethod, jint pc) {
+    JEM_HandlerRange *range;
+    int low = 0, high = bcMethod->handlerRangeCount - 1, mid;
+
+    while (low <= high) {
+        mid = (low + high) >> 1;
+        range = bcMethod->handlerRanges + mid;
+        if (pc < range->startPC) {
+            high = mid - 1;
+        } else if (pc >= range->endPC) {
+            low = mid + 1;
+        } else {
+            return range;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Determine if the given exception handler catches instances of the
+ * specified throwable class.  Throwables are always classes, so this is a
+ * constant time check against the supertype display.
+ *
+ * Parameters:
+ *     exBlock - the (linked) exception handler block to test against
+ *     exClass - the class of the throwable being processed
+ *
+ * Returns:
+ *     JNI_TRUE if the handler catches the throwable, JNI_FALSE otherwise.
+ */
+static jboolean isHandlerMatch(JEM_MethodExceptionBlock *exBlock,
+                               JEMCC_Class *exClass) {
+    JEMCC_Class *compClass = exBlock->exceptionClass.instance;
+
+    /* Finally clauses catch everything, otherwise an assignable parent */
+    if (compClass == NULL) return JNI_TRUE;
+    return JEM_IsAssignableClass(exClass, compClass);
+}
+
 /**
  * Process the specified throwable in the context of the current environment.
  * This will search for an appropriate "catcher" of the exception, be it
@@ -58,8 +109,9 @@ void JEMCC_ProcessThrowable(JNIEnv *env, JEMCC_Object *throwable) {
     JEMCC_VMFrame *currentFrame;
     JEM_BCMethod *bcMethodPtr;
     JEM_MethodExceptionBlock *exBlockPtr;
-    JEMCC_Class **exClassPtr, *compClass, *exClass;
-    int i, pc, mode, throwableCaught = JNI_FALSE, firstFrame = JNI_TRUE;
+    JEM_HandlerRange *range;
+    JEMCC_Class *exClass;
+    int i, mode, throwableCaught = JNI_FALSE, firstFrame = JNI_TRUE;
 
     if (throwable == NULL) {
         throwable = jenv->pendingException;
@@ -96,46 +148,27 @@ void JEMCC_ProcessThrowable(JNIEnv *env, JEMCC_Object *throwable) {
                 }
                 break;
             case FRAME_BYTECODE:
-                /* Scan the method exception table and jump if match found */
-                pc = currentFrameExt->lastPC;
+                /* Locate the handlers covering the PC and jump if matched */
                 bcMethodPtr = currentFrameExt->currentMethod->method.bcMethod;
-                exBlockPtr = bcMethodPtr->exceptionTable;
-                for (i = 0; i < bcMethodPtr->exceptionTableLength; 
-                                                           i++, exBlockPtr++) {
-                    /* Validate that this exception is in the correct block */
-                    if ((exBlockPtr->startPC > pc) ||
-                                   (exBlockPtr->endPC < pc)) continue;
-
-                    /* Verify the class cast directly (don't use JNI method) */
-                    compClass = (JEMCC_Class *) 
-                                     exBlockPtr->exceptionClass.instance;
-                    exClass = throwable->classReference;
-
-                    /* Same class is easy */
-                    if (exClass == compClass) {
+                range = findHandlerRange(bcMethodPtr,
+                                         currentFrameExt->lastPC);
+                exClass = throwable->classReference;
+                for (i = 0; (range != NULL) && (i < range->handlerCount);
+                                                                         i++) {
+                    exBlockPtr = bcMethodPtr->exceptionTable +
+                                                         range->handlers[i];
+                    if (isHandlerMatch(exBlockPtr, exClass) == JNI_TRUE) {
                         currentFrameExt->pc = exBlockPtr->handlerPC;
                         JEMCC_PUSH_STACK_OBJECT(currentFrame, throwable);
                         throwableCaught = JNI_TRUE;
                         break;
                     }
-
-                    /* Perhaps it is an assignable parent */
-                    exClassPtr = exClass->classData->assignList;
-                    while (*exClassPtr != NULL) {
-                        if (*exClassPtr == compClass) {
-                            currentFrameExt->pc = exBlockPtr->handlerPC;
-                            JEMCC_PUSH_STACK_OBJECT(currentFrame, throwable);
-                            throwableCaught = JNI_TRUE;
-                            break;
-                        }
-                        exClassPtr++;
-                    }
-                    if (throwableCaught != JNI_FALSE) break;
                 }
 
                 if (throwableCaught == JNI_FALSE) {
                     /* No match - pop this frame and try the parent */
                     /* NOTE: assign exception to this frame so trace is ok */
+                    JEM_FlushLocalFrameAllocations(env, NULL, throwable);
                     JEM_PopFrame(env);
                 }
                 break;
@@ -147,7 +180,9 @@ void JEMCC_ProcessThrowable(JNIEnv *env, JEMCC_Object *throwable) {
         firstFrame = JNI_FALSE;
     }
 
+#ifdef DEBUG_CPU_INTERNALS
     JEM_DumpFrame(env);
+#endif
 }
 
 /**
@@ -567,5 +602,27 @@ JEMCC_Object *JEM_ExtractSkeletonThrowable(JNIEnv *env) {
     return throwable;
 }
 
-void JEM_ThrowSkeletonThrowable(JEMCC_Object *skeleton) {
+/**
+ * Rethrow the throwable captured from a failed class resolution (see
+ * JEM_ExtractSkeletonThrowable above), for opcodes which reference the
+ * unresolved class.  If no throwable was captured (resolution failed on a
+ * memory error), a generic NoClassDefFoundError is raised instead.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     skeleton - the throwable recorded against the unresolved reference
+ *                (may be NULL)
+ *
+ * Exceptions:
+ *     The captured throwable, or NoClassDefFoundError if there was none.
+ */
+void JEM_ThrowSkeletonThrowable(JNIEnv *env, JEMCC_Object *skeleton) {
+    if (skeleton == NULL) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NoClassDefFoundError,
+                                   NULL, "unresolved class reference");
+        return;
+    }
+
+    /* The resolution failure is permanent, same error each time */
+    JEMCC_ProcessThrowable(env, skeleton);
 }
@@ -26,12 +26,696 @@
 /* Read the VM structure/method definitions */
 #include "jem.h"
 
+/* Group probing uses the SSE2 byte compare/mask operations if supported */
+#ifdef ENABLE_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
 /* Internal object to represent a hashtable entry */
 struct JEM_HashEntry {
     juint hashCode;
     void *key, *object;
 };
 
+/*
+ * Fold the '/' package separators in a four character block to '.' (the
+ * two differ only in the low bit), by locating the bytes which match the
+ * separator exactly (zero after the exclusive-or).
+ */
+#define SEP_MATCH(x) ((~((((x) & 0x7F7F7F7FU) + 0x7F7F7F7FU) | (x))) & \
+                                                           0x80808080U)
+#define CLASS_SEP_FOLD(blk) ((blk) ^ (SEP_MATCH((blk) ^ 0x2F2F2F2FU) >> 7))
+
+#ifndef ENABLE_LEGACY_HASHTABLE
+
+/*
+ * The default hashtable is a group probed ("Swiss") open-addressed table.
+ * Alongside the entry array is an array of control bytes, one per entry,
+ * which hold either the EMPTY/DELETED markers or, for a used entry, a seven
+ * bit fragment of the (mixed) hashcode.  Probing examines the control bytes
+ * for a group of sixteen entries at a time, so that only entries whose hash
+ * fragment matches are ever visited and a probe sequence terminates on the
+ * first group containing an EMPTY marker.  The first GROUP_WIDTH control
+ * bytes are mirrored past the end of the array, so that a group can be
+ * loaded from any starting point without wrapping.
+ */
+#define GROUP_WIDTH 16
+#define CTRL_EMPTY ((jubyte) 0x80)
+#define CTRL_DELETED ((jubyte) 0xFE)
+#define CTRL_ISFULL(ctrl) (((ctrl) & 0x80) == 0)
+
+/* Probe position and control fragment of a mixed hashcode */
+#define HASH_POS(hash) ((hash) >> 7)
+#define HASH_FRAG(hash) ((jubyte) ((hash) & 0x7F))
+
+/* Maximum number of used (full or deleted) entries, 7/8 of capacity */
+#define GROWTH_LIMIT(mask) ((mask) - ((mask) >> 3))
+
+#ifdef ENABLE_ERRORSWEEP
+/* Testsuite always reallocates the hashtable storage */
+#define NEEDS_REBUILD(table) (JNI_TRUE)
+#else
+#define NEEDS_REBUILD(table) (((table)->occupied + 1) > \
+                                          GROWTH_LIMIT((table)->tableMask))
+#endif
+
+/* Control bytes are allocated in the same block, after the entries */
+#define TABLE_ALLOC_SIZE(mask) (((mask) + 1) * sizeof(struct JEM_HashEntry) + \
+                                                  (mask) + 1 + GROUP_WIDTH)
+
+/*
+ * The keyed hash functions are of varying quality (pointer hashes in
+ * particular have little entropy in the low bits), so the hashcode is
+ * remixed before the probe position and fragment are extracted.
+ */
+static juint mixHash(juint hashCode) {
+    hashCode ^= hashCode >> 16;
+    hashCode *= 0x85EBCA6BU;
+    hashCode ^= hashCode >> 13;
+    return hashCode;
+}
+
+/*
+ * Group matching operations, returning a bitmask in which bit N is set if
+ * the control byte at (group + N) matches.  Uses the SSE2 byte compare if
+ * the processor supports it, otherwise a straight byte scan.
+ */
+#ifdef ENABLE_SSE2_KERNELS
+static JEM_SSE2_KERNEL juint groupMatchBlock(jubyte *group, jubyte ctrl) {
+    __m128i grp = _mm_loadu_si128((__m128i *) group);
+
+    return (juint) _mm_movemask_epi8(_mm_cmpeq_epi8(grp,
+                                                    _mm_set1_epi8(ctrl)));
+}
+
+static JEM_SSE2_KERNEL juint groupMatchFreeBlock(jubyte *group) {
+    /* EMPTY and DELETED are the only control values with the high bit */
+    return (juint) _mm_movemask_epi8(_mm_loadu_si128((__m128i *) group));
+}
+#endif
+
+static juint groupMatch(jubyte *group, jubyte ctrl) {
+    juint i, mask = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (JEM_CPU_HAS_SSE2()) return groupMatchBlock(group, ctrl);
+#endif
+    for (i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] == ctrl) mask |= 1 << i;
+    }
+    return mask;
+}
+
+static juint groupMatchFree(jubyte *group) {
+    juint i, mask = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (JEM_CPU_HAS_SSE2()) return groupMatchFreeBlock(group);
+#endif
+    for (i = 0; i < GROUP_WIDTH; i++) {
+        if (!CTRL_ISFULL(group[i])) mask |= 1 << i;
+    }
+    return mask;
+}
+
+/* Index of the lowest/highest set bit in a (non-zero) group mask */
+#ifdef __GNUC__
+#define LOW_BIT(mask) ((juint) __builtin_ctz(mask))
+#define HIGH_BIT(mask) ((juint) (31 - __builtin_clz(mask)))
+#else
+#define LOW_BIT(mask) lowBit(mask)
+#define HIGH_BIT(mask) highBit(mask)
+static juint lowBit(juint mask) {
+    juint idx = 0;
+
+    while ((mask & 1) == 0) { mask >>= 1; idx++; }
+    return idx;
+}
+
+static juint highBit(juint mask) {
+    juint idx = 0;
+
+    while ((mask >>= 1) != 0) idx++;
+    return idx;
+}
+#endif
+
+/* Set a control byte, maintaining the mirrored copy of the first group */
+static void setControl(JEMCC_HashTable *table, juint index, jubyte ctrl) {
+    table->control[index] = ctrl;
+    if (index < GROUP_WIDTH) {
+        table->control[index + table->tableMask + 1] = ctrl;
+    }
+}
+
+/*
+ * Probe sequence for the mixed hashcode, stepping over triangular numbers
+ * of groups.  As the table size is a power of two (and a multiple of the
+ * group width) this visits every group before repeating.
+ */
+#define PROBE_START(table, hash, pos, stride) \
+    pos = HASH_POS(hash) & (table)->tableMask; stride = 0;
+#define PROBE_NEXT(table, pos, stride) \
+    stride += GROUP_WIDTH; pos = (pos + stride) & (table)->tableMask;
+
+/*
+ * Locate the entry for the given key, returning NULL if there is no
+ * matching entry in the table.
+ */
+static struct JEM_HashEntry *findEntry(JNIEnv *env, JEMCC_HashTable *table,
+                                       void *key, juint hashCode,
+                                       JEMCC_KeyEqualsFn keyEqualsFn) {
+    juint mixed = mixHash(hashCode), pos, stride, match;
+    struct JEM_HashEntry *entry;
+    jubyte *group;
+
+    PROBE_START(table, mixed, pos, stride);
+    while (1) {
+        group = table->control + pos;
+        match = groupMatch(group, HASH_FRAG(mixed));
+        while (match != 0) {
+            entry = &(table->entries[(pos + LOW_BIT(match)) & 
+                                                     table->tableMask]);
+            if ((entry->hashCode == hashCode) &&
+                ((*keyEqualsFn)(env, entry->key, key))) return entry;
+            match &= match - 1;
+        }
+        if (groupMatch(group, CTRL_EMPTY) != 0) return NULL;
+        PROBE_NEXT(table, pos, stride);
+    }
+}
+
+/*
+ * Locate the first free (empty or deleted) entry in the probe sequence
+ * for the mixed hashcode.  The occupancy limit guarantees there is one.
+ */
+static juint findFreeSlot(JEMCC_HashTable *table, juint mixed) {
+    juint pos, stride, match;
+
+    PROBE_START(table, mixed, pos, stride);
+    while ((match = groupMatchFree(table->control + pos)) == 0) {
+        PROBE_NEXT(table, pos, stride);
+    }
+    return (pos + LOW_BIT(match)) & table->tableMask;
+}
+
+/**
+ * Initialize a hash table instance to the given number of base hash
+ * points.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - pointer to an existing instance of the hashtable to
+ *             be initialized.  Already existing entries in the table
+ *             will not be cleaned up
+ *     startSize - the number of hash blocks to initially allocate in the
+ *                 table.  If <= 0, an appropriate start size will be selected.
+ *
+ * Returns:
+ *     JNI_OK - hashtable was initialized
+ *     JNI_ENOMEM - a memory allocation failed in creating the tables and
+ *                  an OutOfMemory exception has been thrown in the current
+ *                  environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEMCC_HashInitTable(JNIEnv *env, JEMCC_HashTable *table, jsize startSize) {
+    int i = 1;
+
+    /* Start small, grow big (but always at least two groups) */
+    if (startSize < 0x1F) startSize = 0x1F;
+    while (i <= startSize) i = i << 1;
+    startSize = i - 1;
+
+    /* Initialize the hash specific details */
+    table->entries = JEMCC_Malloc(env, TABLE_ALLOC_SIZE(startSize));
+    if (table->entries == NULL) return JNI_ENOMEM;
+    table->control = (jubyte *) (table->entries + startSize + 1);
+    (void) memset(table->control, CTRL_EMPTY, startSize + 1 + GROUP_WIDTH);
+    table->tableMask = startSize;
+    table->entryCount = 0;
+    table->occupied = 0;
+
+    return JNI_OK;
+}
+
+/**
+ * Destroy the internals of a hashtable instance.  Does NOT destroy the
+ * objects contained in the hashtable or the hashtable structure itself.
+ *
+ * Parameters:
+ *     table - the hashtable instance to be internally destroyed
+ */
+void JEMCC_HashDestroyTable(JEMCC_HashTable *table) {
+    JEMCC_Free(table->entries);
+
+    table->entries = NULL;
+    table->control = NULL;
+    table->tableMask = 0;
+    table->entryCount = 0;
+    table->occupied = 0;
+}
+
+/**
+ * Internal routine to rebuild the table storage when the occupancy limit
+ * is reached.  If the limit is due to accumulated deleted markers, the
+ * table is rebuilt at the same size to discard them, otherwise the table
+ * size is doubled.  The table is not modified if the allocation fails.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to be rebuilt
+ *
+ * Returns:
+ *     JNI_OK - hashtable rebuild succeeded
+ *     JNI_ENOMEM - a memory allocation failed in rebuilding the tables
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+static jint rebuildTable(JNIEnv *env, JEMCC_HashTable *table) {
+    JEMCC_HashTable newTable;
+    struct JEM_HashEntry *entry;
+    juint i, index;
+
+    /* Grow only if the live entries are more than half of the limit */
+    newTable.tableMask = table->tableMask;
+    if ((table->occupied + 1) > GROWTH_LIMIT(table->tableMask)) {
+        if ((table->entryCount + 1) > (GROWTH_LIMIT(table->tableMask) >> 1)) {
+            newTable.tableMask = (table->tableMask << 1) | 1;
+        }
+    }
+
+    newTable.entries = JEMCC_Malloc(env, TABLE_ALLOC_SIZE(newTable.tableMask));
+    if (newTable.entries == NULL) return JNI_ENOMEM;
+    newTable.control = (jubyte *) (newTable.entries + newTable.tableMask + 1);
+    (void) memset(newTable.control, CTRL_EMPTY,
+                  newTable.tableMask + 1 + GROUP_WIDTH);
+
+    for (i = 0; i <= table->tableMask; i++) {
+        if (!CTRL_ISFULL(table->control[i])) continue;
+        entry = &(table->entries[i]);
+        index = findFreeSlot(&newTable, mixHash(entry->hashCode));
+        setControl(&newTable, index, HASH_FRAG(mixHash(entry->hashCode)));
+        newTable.entries[index] = *entry;
+    }
+    JEMCC_Free(table->entries);
+    table->entries = newTable.entries;
+    table->control = newTable.control;
+    table->tableMask = newTable.tableMask;
+    table->occupied = table->entryCount;
+
+    return JNI_OK;
+}
+
+/**
+ * Core method to handle the two models of hashtable entry insertion 
+ * (replace or collide).  See methods below for more information and
+ * parameter/return code descriptions.
+ */
+static jint JEM_HashEntry(JNIEnv *env, JEMCC_HashTable *table,
+                          void *key, void *object,
+                          void **lastKey, void **lastObject,
+                          JEMCC_KeyHashFn keyHashFn, 
+                          JEMCC_KeyEqualsFn keyEqualsFn,
+                          jboolean replaceFlag) {
+    juint hashCode, mixed, index;
+    struct JEM_HashEntry *entry;
+
+    /* Handle the replace/collide case first */
+    hashCode = (*keyHashFn)(env, key);
+    entry = findEntry(env, table, key, hashCode, keyEqualsFn);
+    if (entry != NULL) {
+        if (lastKey != NULL) *lastKey = entry->key;
+        if (lastObject != NULL) *lastObject = entry->object;
+        if (replaceFlag == JNI_FALSE) return JNI_ERR;
+        entry->key = key;
+        entry->object = object;
+        return JNI_OK;
+    }
+
+    /* New entry, reusing the first deleted marker along the probe */
+    mixed = mixHash(hashCode);
+    index = findFreeSlot(table, mixed);
+    if (table->control[index] == CTRL_EMPTY) {
+        if (NEEDS_REBUILD(table)) {
+            /* The tables are not modified if exception is thrown */
+            if (rebuildTable(env, table) != JNI_OK) return JNI_ENOMEM;
+            index = findFreeSlot(table, mixed);
+        }
+        table->occupied++;
+    }
+    setControl(table, index, HASH_FRAG(mixed));
+    entry = &(table->entries[index]);
+    entry->hashCode = hashCode;
+    entry->key = key;
+    entry->object = object;
+    table->entryCount++;
+
+    if (lastKey != NULL) *lastKey = NULL;
+    if (lastObject != NULL) *lastObject = NULL;
+
+    return JNI_OK;
+}
+
+/*
+ * Release the given table entry.  If there is no group-sized window
+ * spanning the entry without an EMPTY marker, no probe sequence can have
+ * continued past it and the entry can be returned directly to EMPTY,
+ * otherwise a DELETED marker must be left in place.  Does not move any
+ * entries, so is safe for use during a scan.
+ */
+static void releaseEntry(JEMCC_HashTable *table, struct JEM_HashEntry *entry) {
+    juint index = entry - table->entries, before, after;
+
+    before = groupMatch(table->control + 
+                           ((index - GROUP_WIDTH) & table->tableMask),
+                        CTRL_EMPTY);
+    after = groupMatch(table->control + index, CTRL_EMPTY);
+    if ((before != 0) && (after != 0) &&
+        ((LOW_BIT(after) + (GROUP_WIDTH - 1 - HIGH_BIT(before))) <
+                                                           GROUP_WIDTH)) {
+        setControl(table, index, CTRL_EMPTY);
+        table->occupied--;
+    } else {
+        setControl(table, index, CTRL_DELETED);
+    }
+    entry->key = entry->object = NULL;
+    table->entryCount--;
+}
+
+/**
+ * Store an object into a hashtable.  Hashtable will expand as necessary,
+ * and object will replace an already existing object with an equal key.
+ * If an existing object is replaced, it is not destroyed but the key/object
+ * pair is returned to allow the caller to clean up.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to put the key->value pair into
+ *     key - the key associated with the entry
+ *     object - the object to store in the hashtable according to the given key
+ *     lastKey - if this pointer is non-NULL, the previous key is returned if
+ *               the put entry replaces one in the hashtable or NULL is
+ *               returned if the entry is new
+ *     lastObject - if this pointer is non-NULL, the previous object is 
+ *                  returned if the put entry replaces one in the hashtable or 
+ *                  NULL is returned if the entry is new
+ *     keyHashFn - a function reference used to generate hashcode values from
+ *                 the table keys
+ *     keyEqualsFn - a function reference used to compare keys in the hashtable
+ *                   entries
+ *
+ * Returns:
+ *     JNI_OK - hashtable insertion was successful
+ *     JNI_ENOMEM - a memory allocation failed in creating the tables and
+ *                  an OutOfMemory exception has been thrown in the current
+ *                  environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEMCC_HashPutEntry(JNIEnv *env, JEMCC_HashTable *table,
+                        void *key, void *object,
+                        void **lastKey, void **lastObject,
+                        JEMCC_KeyHashFn keyHashFn, 
+                        JEMCC_KeyEqualsFn keyEqualsFn) {
+    return JEM_HashEntry(env, table, key, object, lastKey, lastObject,
+                         keyHashFn, keyEqualsFn, JNI_TRUE);
+}
+
+/**
+ * Almost identical to the HashPutEntry method, this method stores an
+ * key->object entry into a hashtable unless there already exists an entry
+ * in the hashtable with an "equal" key (i.e. this method will not replace
+ * already existing hashtable entries where HashPutEntry does).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to put the key->value pair into
+ *     key - the key associated with the entry
+ *     object - the object to store in the hashtable according to the given key
+ *     lastKey - if this pointer is non-NULL, the existing key is returned if
+ *               the insert did not happen (no replace) or NULL if the entry
+ *               is new and was inserted
+ *     lastObject - if this pointer is non-NULL, the existing object is
+ *                  returned if the insert did not happen (no replace) or
+ *                  NULL if the entry is new and was inserted
+ *     keyHashFn - a function reference used to generate hashcode values from
+ *                 the table keys
+ *     keyEqualsFn - a function reference used to compare keys in the hashtable
+ *                   entries
+ *
+ * Returns:
+ *     JNI_OK - hashtable insertion was successful
+ *     JNI_ERR - an entry already exists in the hashtable for the given key
+ *               and no action was taken (no exception has been thrown either)
+ *     JNI_ENOMEM - a memory allocation failed in creating the tables and
+ *                  an OutOfMemory exception has been thrown in the current
+ *                  environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEMCC_HashInsertEntry(JNIEnv *env, JEMCC_HashTable *table,
+                           void *key, void *object,
+                           void **lastKey, void **lastObject,
+                           JEMCC_KeyHashFn keyHashFn, 
+                           JEMCC_KeyEqualsFn keyEqualsFn) {
+    return JEM_HashEntry(env, table, key, object, lastKey, lastObject,
+                         keyHashFn, keyEqualsFn, JNI_FALSE);
+}
+
+/**
+ * Remove an entry from the hashtable.  This does not destroy the removed
+ * object/key, only the reference to them.  The original key/object pair
+ * can be returned to the caller for cleanup purposes.  NOTE: this method
+ * is not "safe" for use during hashtable scanning - use HashScanRemoveEntry
+ * instead.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to remove the entry from
+ *     key - the key of the pair entry to be removed
+ *     origKey - if this pointer is non-NULL and an entry is removed, the
+ *               original key of the entry is returned here
+ *     origObject - if this pointer is non-NULL and an entry is removed, the
+ *                  object associated with the entry is returned here
+ *     keyHashFn - a function reference used to generate hashcode values from
+ *                 the table keys
+ *     keyEqualsFn - a function reference used to compare keys in the hashtable
+ *                   entries
+ *     
+ * Returns:
+ *     JNI_OK - a matching entry was found and has been removed
+ *     JNI_ERR - no entry matching the specified key was found (no exception
+ *               is thrown as it may not really be an error)
+ */
+jint JEMCC_HashRemoveEntry(JNIEnv *env, JEMCC_HashTable *table, void *key,
+                           void **origKey, void **origObject,
+                           JEMCC_KeyHashFn keyHashFn, 
+                           JEMCC_KeyEqualsFn keyEqualsFn) {
+    struct JEM_HashEntry *entry;
+
+    entry = findEntry(env, table, key, (*keyHashFn)(env, key), keyEqualsFn);
+    if (entry == NULL) {
+        if (origKey != NULL) *origKey = NULL;
+        if (origObject != NULL) *origObject = NULL;
+        return JNI_ERR;
+    }
+
+    if (origKey != NULL) *origKey = entry->key;
+    if (origObject != NULL) *origObject = entry->object;
+    releaseEntry(table, entry);
+
+    return JNI_OK;
+}
+
+/**
+ * Retrieve an object from the hashtable according to the specified key.
+ *
+ * Parameters: 
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to retrieve the entry from
+ *     key - the key of the object to be obtained
+ *     keyHashFn - a function reference used to generate hashcode values from
+ *                 the table keys
+ *     keyEqualsFn - a function reference used to compare keys in the hashtable
+ *                   entries
+ *
+ * Returns:
+ *     NULL if no object entry has a matching key, otherwise the matching
+ *     object reference.
+ */
+void *JEMCC_HashGetEntry(JNIEnv *env, JEMCC_HashTable *table, void *key,
+                         JEMCC_KeyHashFn keyHashFn, 
+                         JEMCC_KeyEqualsFn keyEqualsFn) {
+    struct JEM_HashEntry *entry;
+
+    entry = findEntry(env, table, key, (*keyHashFn)(env, key), keyEqualsFn);
+    return (entry != NULL) ? entry->object : NULL;
+}
+
+/**
+ * Similar to the HashGetEntry method, this retrieves entry information
+ * for the provided key, but obtains both the object and the key associated
+ * with the hashtable entry.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to retrieve the entry from
+ *     key - the key of the object to be obtained
+ *     retKey - if non-NULL, the entry key is returned if a matching entry
+ *              was found, otherwise NULL is returned
+ *     retObject - if non-NULL, the entry object is returned if a matching 
+ *                 entry was found, otherwise NULL is returned
+ *     keyHashFn - a function reference used to generate hashcode values from
+ *                 the table keys
+ *     keyEqualsFn - a function reference used to compare keys in the hashtable
+ *                   entries
+ *     
+ * Returns:
+ *     JNI_OK - an entry matching the key was found and the data was returned
+ *     JNI_ERR - no entry matching the key was found 
+ */
+jint JEMCC_HashGetFullEntry(JNIEnv *env, JEMCC_HashTable *table,
+                            void *key, void **retKey, void **retObject,
+                            JEMCC_KeyHashFn keyHashFn, 
+                            JEMCC_KeyEqualsFn keyEqualsFn) {
+    struct JEM_HashEntry *entry;
+
+    entry = findEntry(env, table, key, (*keyHashFn)(env, key), keyEqualsFn);
+    if (retKey != NULL) *retKey = (entry != NULL) ? entry->key : NULL;
+    if (retObject != NULL) *retObject = (entry != NULL) ? entry->object : NULL;
+    return ((entry != NULL) ? JNI_OK : JNI_ERR);
+}
+
+/**
+ * Duplicate the given hashtable.  This will create copies of the internal
+ * management structures of the hashtable and may possibly create duplicates
+ * of the entry keys, if a duplication function is provided.  It does not
+ * duplicate the object instances, only the references to the objects.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     dest - the hashtable to copy information into.  Any entries in this
+ *            table will be lost without any sort of cleanup
+ *     source - the hashtable containing the information to be copied
+ *     keyDupFn - if non-NULL, this function will be called to duplicate
+ *                the key instances between the tables
+ *
+ * Returns:
+ *     JNI_OK - hashtable was duplicated
+ *     JNI_ENOMEM - a memory allocation failed in creating the tables and
+ *                  an OutOfMemory exception has been thrown in the current
+ *                  environment.  The duplicate hashtable may be partially
+ *                  filled, if the memory failure occurred during key
+ *                  duplication.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEMCC_HashDuplicate(JNIEnv *env, JEMCC_HashTable *dest, 
+                         JEMCC_HashTable *source, JEMCC_KeyDupFn keyDupFn) {
+    struct JEM_HashEntry *srcEntry, *dstEntry;
+    juint i;
+
+    /* Duplicate the hash count information */
+    dest->tableMask = source->tableMask;
+    dest->entryCount = source->entryCount;
+    dest->occupied = source->occupied;
+
+    /* Duplicate the hash record information (markers as they are copied) */
+    dest->entries = JEMCC_Malloc(env, TABLE_ALLOC_SIZE(dest->tableMask));
+    if (dest->entries == NULL) {
+        dest->control = NULL;
+        return JNI_ENOMEM;
+    }
+    dest->control = (jubyte *) (dest->entries + dest->tableMask + 1);
+    (void) memset(dest->control, CTRL_EMPTY,
+                  dest->tableMask + 1 + GROUP_WIDTH);
+    srcEntry = source->entries;
+    dstEntry = dest->entries;
+    for (i = 0; i <= dest->tableMask; i++) {
+         if (CTRL_ISFULL(source->control[i])) {
+             if (keyDupFn != NULL) {
+                 dstEntry->key = (*keyDupFn)(env, srcEntry->key);
+             } else {
+                 dstEntry->key = srcEntry->key;
+             }
+             if (dstEntry->key == NULL) return JNI_ENOMEM;
+             dstEntry->object = srcEntry->object;
+             dstEntry->hashCode = srcEntry->hashCode;
+         }
+         if (source->control[i] != CTRL_EMPTY) {
+             setControl(dest, i, source->control[i]);
+         }
+         srcEntry++;
+         dstEntry++;
+    }
+
+    return JNI_OK;
+}
+
+/**
+ * Scan through all entries in a hashtable, calling the specified
+ * callback function for each valid hashtable entry.  NOTE: only the
+ * "safe" methods (such as HashScanRemoveEntry below) should be used while
+ * a hashtable scan is in progress.
+ *
+ * Parameters: 
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable containing the entries to be scanned
+ *     entryCB - a function reference which is called for each valid
+ *               entry in the hashtable
+ *     userData - a caller provided data set which is included in the
+ *                scan arguments
+ */
+void JEMCC_HashScan(JNIEnv *env, JEMCC_HashTable *table,
+                    JEMCC_EntryScanCB entryCB, void *userData) {
+    struct JEM_HashEntry *entry = table->entries;
+    juint i;
+
+    if (entry == NULL) return;
+    for (i = 0; i <= table->tableMask; i++, entry++) {
+        if (!CTRL_ISFULL(table->control[i])) continue;
+        if ((*entryCB)(env, table, entry->key, entry->object,
+                       userData) != JNI_OK) break;
+    }
+}
+
+/**
+ * Identical to the HashRemoveEntry method, this removes an entry from
+ * the hashtable but is "safe" to use while a scan of the hashtable is
+ * in progress.  This does not destroy the removed object/key - only the 
+ * reference to them.  
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the hashtable to remove the entry from
+ *     key - the key of the pair entry to be removed
+ *     keyHashFn - a function reference used to generate hashcode values from
+ *                 the table keys
+ *     keyEqualsFn - a function reference used to compare keys in the hashtable
+ *                   entries
+ */
+void JEMCC_HashScanRemoveEntry(JNIEnv *env, JEMCC_HashTable *table, void *key,
+                               JEMCC_KeyHashFn keyHashFn, 
+                               JEMCC_KeyEqualsFn keyEqualsFn) {
+    struct JEM_HashEntry *entry;
+
+    /* Removal never relocates entries, so nothing special is required */
+    entry = findEntry(env, table, key, (*keyHashFn)(env, key), keyEqualsFn);
+    if (entry != NULL) releaseEntry(table, entry);
+}
+
+#else /* ENABLE_LEGACY_HASHTABLE */
+
+/*
+ * The original double-hashing implementation, retained for comparison
+ * (see the hashbenchlegacy benchmark).  The control array is unused.
+ */
 static void *DummyEntry = (void *) "x";
 
 #define HASHSTART(table, index) ((index) & table->tableMask)
@@ -598,6 +1282,8 @@ void JEMCC_HashScanRemoveEntry(JNIEnv *env, JEMCC_HashTable *table, void *key,
     }
 }
 
+#endif /* ENABLE_LEGACY_HASHTABLE */
+
 /* * * * * * * * * * * Convenience Hash Methods * * * * * * * * * * */
 
 /**
@@ -612,12 +1298,28 @@ void JEMCC_HashScanRemoveEntry(JNIEnv *env, JEMCC_HashTable *table, void *key,
  *     The numerical hashcode associated with the given characters.
  */
 juint JEMCC_StrHashFn(JNIEnv *env, void *key) {
-    unsigned long hashCode = 0;
-    char *ptr = (char *) key;
+    jubyte *ptr = (jubyte *) key;
+    juint hashCode = 0, block;
 
-    while (*ptr != '\0') {
-        hashCode += *(ptr++);
+    /* Gather the characters into four byte blocks, up to the terminator */
+    while ((ptr[0] != '\0') && (ptr[1] != '\0') && 
+           (ptr[2] != '\0') && (ptr[3] != '\0')) {
+        block = ((juint) ptr[0]) | (((juint) ptr[1]) << 8) |
+                (((juint) ptr[2]) << 16) | (((juint) ptr[3]) << 24);
+        JEMCC_HASH_BLOCK(hashCode, block);
+        ptr += 4;
     }
+    if (ptr[0] != '\0') {
+        block = ptr[0];
+        if (ptr[1] != '\0') {
+            block |= ((juint) ptr[1]) << 8;
+            if (ptr[2] != '\0') block |= ((juint) ptr[2]) << 16;
+        }
+        JEMCC_HASH_BLOCK(hashCode, block);
+        while (*ptr != '\0') ptr++;
+    }
+    JEMCC_HASH_FINAL(hashCode, ptr - (jubyte *) key);
+
     return hashCode;
 }
 
@@ -677,17 +1379,28 @@ void *JEMCC_StrDupFn(JNIEnv *env, void *key) {
  *     separators.
  */
 juint JEMCC_ClassNameHashFn(JNIEnv *env, void *key) {
-    char *ptr = (char *) key;
-    juint hashCode = 0;
+    jubyte *ptr = (jubyte *) key;
+    juint hashCode = 0, block;
 
-    while (*ptr != '\0') {
-        if (*ptr == '/') {
-            hashCode += '.';
-            ptr++;
-        } else {
-            hashCode += *(ptr++);
+    /* As above, but with the separators folded to the '.' form */
+    while ((ptr[0] != '\0') && (ptr[1] != '\0') && 
+           (ptr[2] != '\0') && (ptr[3] != '\0')) {
+        block = ((juint) ptr[0]) | (((juint) ptr[1]) << 8) |
+                (((juint) ptr[2]) << 16) | (((juint) ptr[3]) << 24);
+        JEMCC_HASH_BLOCK(hashCode, CLASS_SEP_FOLD(block));
+        ptr += 4;
+    }
+    if (ptr[0] != '\0') {
+        block = ptr[0];
+        if (ptr[1] != '\0') {
+            block |= ((juint) ptr[1]) << 8;
+            if (ptr[2] != '\0') block |= ((juint) ptr[2]) << 16;
         }
+        JEMCC_HASH_BLOCK(hashCode, CLASS_SEP_FOLD(block));
+        while (*ptr != '\0') ptr++;
     }
+    JEMCC_HASH_FINAL(hashCode, ptr - (jubyte *) key);
+
     return hashCode;
 }
 
@@ -26,38 +26,6 @@
 /* Read the VM structure/method definitions */
 #include "jem.h"
 
-/**
- * The following two methods are used to destroy the in-progress allocations
- * of the final class method and field definition tables for JEMCC constructs.
- * They are similar but not identical to those defined in classlinker.c.
- */
-static void JEMCC_DestroyWorkingMethodData(JEM_ClassMethodData *data,
-                                           jint methodCount) {
-    JEM_ClassMethodData *methodPtr = data;
-    int i;
-
-    for (i = 0; i < methodCount; i++) {
-        if (methodPtr->descriptor != NULL) {
-            JEM_DestroyDescriptor(methodPtr->descriptor, JNI_TRUE);
-        }
-        methodPtr++;
-    }
-    JEMCC_Free(data);
-}
-static void JEMCC_DestroyWorkingFieldData(JEM_ClassFieldData *data,
-                                          jint fieldCount) {
-    JEM_ClassFieldData *fieldPtr = data;
-    int i;
-
-    for (i = 0; i < fieldCount; i++) {
-        if (fieldPtr->descriptor != NULL) {
-            JEM_DestroyDescriptor(fieldPtr->descriptor, JNI_TRUE);
-        }
-        fieldPtr++;
-    }
-    JEMCC_Free(data);
-}
-
 /**
  * Build a JEM Compiled Class instance.  The creation of a JEM compiled
  * class is done in three stages - the initial construction of the class
@@ -146,6 +114,7 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
     classData = clInst->classData;
     classData->accessFlags = accessFlags | ACC_JEMCC;
     classData->parseData = NULL;
+    classData->objMgmtFn = (objMgmtFn != NULL) ? *objMgmtFn : NULL;
 
     /* Assemble the local class method definitions */
     if (methodCount != 0) {
@@ -183,11 +152,17 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
                 break;
             }
         }
-        methodSet[i].name = methodInfo[i].name;
-        methodSet[i].descriptorStr = methodInfo[i].descriptor;
-        methodSet[i].descriptor = JEM_ParseDescriptor(env, 
-                                                      methodInfo[i].descriptor,
-                                                      NULL, NULL, JNI_TRUE);
+        methodSet[i].name = JEM_InternSymbol(env, methodInfo[i].name);
+        methodSet[i].descriptorStr =
+                             JEM_InternSymbol(env, methodInfo[i].descriptor);
+        if ((methodSet[i].name == NULL) ||
+            (methodSet[i].descriptorStr == NULL)) {
+            memFailFlag = 1;
+            break;
+        }
+        methodSet[i].descriptor = JEM_InternDescriptor(env,
+                                                  methodSet[i].descriptorStr,
+                                                  JNI_TRUE);
         if (methodSet[i].descriptor == NULL) {
             /* NOTE: assumption made that provided descriptor was valid */
             memFailFlag = 1;
@@ -204,7 +179,8 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
         methodSet[i].method.ccMethod = methodInfo[i].codeBody;
     }
     if (i != methodCount) {
-        JEMCC_DestroyWorkingMethodData(methodSet, methodCount);
+        /* Names and descriptors are interned, only release the table */
+        JEMCC_Free(methodSet);
         JEM_DestroyClassInstance(env, clInst);
         return ((memFailFlag != 0) ? JNI_ENOMEM : JNI_ERR);
     }
@@ -215,7 +191,7 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
                                 interfaces, interfaceCount,
                                 methodSet, methodCount);
     if (rc != JNI_OK) {
-        JEMCC_DestroyWorkingMethodData(methodSet, methodCount);
+        JEMCC_Free(methodSet);
         JEM_DestroyClassInstance(env, clInst);
         return rc;
     }
@@ -233,12 +209,18 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
     }
     for (i = 0, memFailFlag = 0; i < fieldCount; i++) {
         fieldSet[i].accessFlags = fieldInfo[i].accessFlags | ACC_JEMCC;
-        fieldSet[i].name = fieldInfo[i].name;
-        if (fieldSet[i].name != NULL) {
-            fieldSet[i].descriptorStr = fieldInfo[i].descriptor;
-            fieldSet[i].descriptor = JEM_ParseDescriptor(env, 
-                                                      fieldInfo[i].descriptor,
-                                                      NULL, NULL, JNI_FALSE);
+        if (fieldInfo[i].name != NULL) {
+            fieldSet[i].name = JEM_InternSymbol(env, fieldInfo[i].name);
+            fieldSet[i].descriptorStr = JEM_InternSymbol(env,
+                                                      fieldInfo[i].descriptor);
+            if ((fieldSet[i].name == NULL) ||
+                (fieldSet[i].descriptorStr == NULL)) {
+                memFailFlag = 1;
+                break;
+            }
+            fieldSet[i].descriptor = JEM_InternDescriptor(env,
+                                                  fieldSet[i].descriptorStr,
+                                                  JNI_FALSE);
             if (fieldSet[i].descriptor == NULL) {
                 /* NOTE: assumption made that provided descriptor was valid */
                 memFailFlag = 1;
@@ -252,6 +234,7 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
                 break;
             }
         } else {
+            fieldSet[i].name = NULL;
             fieldSet[i].descriptorStr = NULL;
             fieldSet[i].descriptor = NULL;
         }
@@ -259,7 +242,7 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
         fieldSet[i].parentClass = clInst;
     }
     if (i != fieldCount) {
-        JEMCC_DestroyWorkingFieldData(fieldSet, fieldCount);
+        JEMCC_Free(fieldSet);
         JEM_DestroyClassInstance(env, clInst);
         return ((memFailFlag != 0) ? JNI_ENOMEM : JNI_ERR);
     }
@@ -267,7 +250,7 @@ jint JEMCC_BuildClass(JNIEnv *env, JEMCC_Object *loader, juint accessFlags,
     /* Attach fields to class and pack information */
     rc = JEM_PackClassFieldData(env, clInst, fieldSet, fieldCount);
     if (rc != JNI_OK) {
-        JEMCC_DestroyWorkingFieldData(fieldSet, fieldCount);
+        JEMCC_Free(fieldSet);
         JEM_DestroyClassInstance(env, clInst);
         return rc;
     }
@@ -320,10 +303,11 @@ jint JEMCC_LinkClass(JNIEnv *env, JEMCC_Class *linkClass,
                      JEMCC_LinkData *linkInfo, jsize linkCount) {
     JEM_ClassData *classData = linkClass->classData;
     JEM_ClassData *classRefData;
-    int i, j, classRefCount = 0, methodRefCount = 0, fieldRefCount = 0;
+    int i, classRefCount = 0, methodRefCount = 0, fieldRefCount = 0;
     JEM_ClassMethodData *methodRef;
     JEM_ClassFieldData *fieldRef;
     char *lClassName = linkClass->classData->className;
+    char *nameSym, *descSym;
 
     /* Determine/create the class definition linkage tables */
     for (i = 0; i < linkCount; i++) {
@@ -369,21 +353,18 @@ jint JEMCC_LinkClass(JNIEnv *env, JEMCC_Class *linkClass,
             case JEMCC_LINK_METHOD:
                 classRefData = linkInfo[i].extClassRef->classData;
                 methodRef = NULL;
-                if (strcmp(linkInfo[i].fieldMethodName, "<init>") == 0) {
+                /* Symbols which were never interned cannot be members */
+                nameSym = JEM_LookupSymbol(env, linkInfo[i].fieldMethodName);
+                descSym = JEM_LookupSymbol(env, linkInfo[i].fieldMethodDesc);
+                if ((nameSym == NULL) || (descSym == NULL)) {
+                    /* Fall through to error below */
+                } else if (strcmp(nameSym, "<init>") == 0) {
                     /* <init> method must be looked up locally */
-                    for (j = 0; j < classRefData->localMethodCount; j++) {
-                        if ((strcmp(classRefData->localMethods[j].name,
-                                    linkInfo[i].fieldMethodName) == 0) &&
-                            (strcmp(classRefData->localMethods[j].descriptorStr,
-                                    linkInfo[i].fieldMethodDesc) == 0)) {
-                            methodRef = &(classRefData->localMethods[j]);
-                            break;
-                        }
-                    }
+                    methodRef = JEM_LocateLocalMethod(classRefData,
+                                                      nameSym, descSym);
                 } else {
                     methodRef = JEM_LocateClassMethod(classRefData,
-                                                  linkInfo[i].fieldMethodName,
-                                                  linkInfo[i].fieldMethodDesc);
+                                                      nameSym, descSym);
                 }
                 if (methodRef == NULL) {
                     JEMCC_ThrowStdThrowableIdxV(env, JEMCC_Class_LinkageError,
@@ -398,9 +379,13 @@ jint JEMCC_LinkClass(JNIEnv *env, JEMCC_Class *linkClass,
                 break;
             case JEMCC_LINK_FIELD:
                 classRefData = linkInfo[i].extClassRef->classData;
-                fieldRef = JEM_LocateClassField(classRefData,
-                                                linkInfo[i].fieldMethodName,
-                                                linkInfo[i].fieldMethodDesc);
+                fieldRef = NULL;
+                nameSym = JEM_LookupSymbol(env, linkInfo[i].fieldMethodName);
+                descSym = JEM_LookupSymbol(env, linkInfo[i].fieldMethodDesc);
+                if ((nameSym != NULL) && (descSym != NULL)) {
+                    fieldRef = JEM_LocateClassField(classRefData,
+                                                    nameSym, descSym);
+                }
                 if (fieldRef == NULL) {
                     JEMCC_ThrowStdThrowableIdxV(env, JEMCC_Class_LinkageError,
                                                 NULL, lClassName,
@@ -689,6 +674,7 @@ jint JEMCC_CreateStdThrowableClass(JNIEnv *env, JEMCC_Object *loader,
     /* All except the name, assignments and method link tables */
     classData->className = (char *) className;
     classData->assignList = NULL;
+    classData->superDisplay = NULL;
     classData->methodLinkTables = NULL;
 
     /* And superclass/superinterface linkage information */
@@ -705,6 +691,19 @@ jint JEMCC_CreateStdThrowableClass(JNIEnv *env, JEMCC_Object *loader,
     classData->interfaceCount = 0;
     classData->assignmentCount = recordCount;
 
+    /* Extend the supertype display (interfaces are those of superclass) */
+    classData->superDisplay = (JEMCC_Class **) JEMCC_Malloc(env,
+                     (superClassData->superDepth + 2) * sizeof(JEMCC_Class *));
+    if (classData->superDisplay == NULL) {
+        JEM_DestroyClassInstance(env, clInst);
+        return JNI_ENOMEM;
+    }
+    (void) memcpy(classData->superDisplay, superClassData->superDisplay,
+                  (superClassData->superDepth + 1) * sizeof(JEMCC_Class *));
+    classData->superDepth = superClassData->superDepth + 1;
+    classData->superDisplay[classData->superDepth] = clInst;
+    classData->interfaceCache = NULL;
+
     /* Finally, rebuild the method linkage tables (insert newest class) */
     classData->methodLinkTables = (JEM_ClassMethodData ***)
          JEMCC_Malloc(env, (recordCount + 1) * sizeof(JEM_ClassMethodData **));
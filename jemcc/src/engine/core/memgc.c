@@ -22,15 +22,80 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
  */
 #include "jeminc.h"
+#include <sys/time.h>
 
 /* Read the structure/method details */
 #include "jem.h"
 
 /* Bits and bytes */
 #define NONLOCAL_BIT 1
+#define LARGE_RECORD_BIT 2
+#define RECORD_FLAG_MASK 0x03
+
+/*
+ * Collector state bits, carried in the low bits of the record size, along
+ * with the flag for native data allocated by JEMCC_AllocateObject.
+ */
+#define RECORD_MARK_BIT 0x01
+#define RECORD_RECLAIMED_BIT 0x02
+#define RECORD_NATIVE_BIT 0x04
+#define RECORD_SIZE_MASK (~0x07)
+
+/*
+ * Object records are carved from large thread-local (per-environment) blocks
+ * using a simple bump pointer.  Records larger than the large object limit
+ * are given a dedicated block.  Blocks are chained through the header (the
+ * large object blocks are doubly-linked for individual release), the
+ * remainder of the header maintains record alignment.  Each record carries
+ * its aligned size ahead of the tracking link word, which precedes the
+ * object itself.
+ */
+#define ALLOC_BLOCK_SIZE (64 * 1024)
+#define ALLOC_LARGE_OBJECT_SIZE (ALLOC_BLOCK_SIZE / 4)
+#define ALLOC_ALIGNMENT 8
+#define ALLOC_ALIGN(x) (((x) + ALLOC_ALIGNMENT - 1) & ~(ALLOC_ALIGNMENT - 1))
+#define ALLOC_BLOCK_HEADER_SIZE ALLOC_ALIGN(2 * sizeof(void *))
+#define ALLOC_RECORD_HEADER_SIZE ALLOC_ALIGN(sizeof(juint) + sizeof(void *))
+
+/* Record (link word) accessors */
+#define RECORD_NEXT(rec) ((void *) (*((juint *) (rec)) & ~RECORD_FLAG_MASK))
+#define RECORD_SIZE(rec) (*(((juint *) (rec)) - 1))
+#define RECORD_LENGTH(rec) (RECORD_SIZE(rec) & RECORD_SIZE_MASK)
+#define RECORD_BASE(rec) (((jubyte *) (rec)) + sizeof(void *) - \
+                                              ALLOC_RECORD_HEADER_SIZE)
+#define BLOCK_NEXT(blk) (((void **) (blk))[0])
+#define BLOCK_PREV(blk) (((void **) (blk))[1])
+
+/*
+ * Heap records which are found to be unreachable are swept (lazily) onto
+ * per-environment free lists, indexed by the aligned record size, for reuse
+ * by subsequent allocations.  Reclaimed records are flagged, as they lie
+ * outside of the bump allocation region.
+ */
+#define ALLOC_FREE_LIST_COUNT (ALLOC_LARGE_OBJECT_SIZE / ALLOC_ALIGNMENT + 1)
+#define ALLOC_SWEEP_QUANTUM 512
+
+/* Collection threshold and marking worker/stack configuration */
+#define GC_INITIAL_THRESHOLD (16 * 1024 * 1024)
+#define GC_DEFAULT_WORKER_COUNT 4
+#define GC_MARK_STACK_SIZE 1024
+#define GC_STEAL_CHUNK 64
+#define GC_MIN_THRESHOLD(jvm) (((jvm)->gcMinThreshold != 0) ? \
+                                  (jvm)->gcMinThreshold : GC_INITIAL_THRESHOLD)
+
+/* Safepoint handshake polling interval and limit (in milliseconds) */
+#define GC_SAFEPOINT_WAIT 10
+#define GC_SAFEPOINT_TIMEOUT 2000
+
+/* Initial size of the (per-environment) pinned object table */
+#define PIN_INITIAL_CAPACITY 16
 
 /* Forward declarations to actual garbage allocators/collectors */
+static JEMCC_Object *JEM_AllocateObjectInstance(JNIEnv *env,
+                                                JEMCC_Class *classInst,
+                                                juint objDataSize);
 static JEMCC_Object *JEM_AllocateObjectRecord(JNIEnv *env, juint totalSize);
+static void JEM_SweepHeapRecords(JNIEnv *env, juint quantum);
 
 #ifndef TEST_INTERNAL
 /**
@@ -82,8 +147,9 @@ void *JEMCC_Malloc(JNIEnv *env, juint size) {
  * method as certain JEMCC implementations may use thread-local allocation
  * mechanisms outside of the standard malloc/free.
  *
- * Note: Object instances should never be passed through this method, let
- *       the garbage collector do its job!
+ * Note: Object instances (and array storage) are allocated from the
+ *       thread-local allocation blocks and should never be passed through
+ *       this method, let the garbage collector do its job!
  *
  * Parameters:
  *     block - the block of allocated memory to be freed
@@ -145,6 +211,24 @@ JEMCC_Object *JEMCC_AllocateObjectIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
  */
 JEMCC_Object *JEMCC_AllocateObject(JNIEnv *env, JEMCC_Class *classInst, 
                                    juint objDataSize) {
+    JEMCC_Object *retObj;
+    jboolean inSafeRegion;
+
+    /* Native method callouts return to the VM for the allocation */
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
+    retObj = JEM_AllocateObjectInstance(env, classInst, objDataSize);
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
+
+    return retObj;
+}
+
+/**
+ * Common method for the allocation of an Object instance above, made
+ * outside of any safe region.
+ */
+static JEMCC_Object *JEM_AllocateObjectInstance(JNIEnv *env,
+                                                JEMCC_Class *classInst,
+                                                juint objDataSize) {
     JEMCC_Object *retObj = NULL;
     unsigned int totalSize = sizeof(JEMCC_Object);
 
@@ -156,16 +240,28 @@ JEMCC_Object *JEMCC_AllocateObject(JNIEnv *env, JEMCC_Class *classInst,
         totalSize += classInst->classData->packedFieldSize;
     }
 
-    /* Create the memory space */
-    if ((retObj = JEM_AllocateObjectRecord(env, totalSize)) == NULL) {
+    /* Array storage is allocated contiguously with the object record */
+    if ((classInst != NULL) && (objDataSize > 0) &&
+        ((classInst->classData->accessFlags & ACC_ARRAY) != 0)) {
+        totalSize = ALLOC_ALIGN(totalSize);
+        retObj = JEM_AllocateObjectRecord(env, totalSize + objDataSize);
+        if (retObj == NULL) return NULL;
+        ((JEMCC_ArrayObject *) retObj)->arrayData = 
+                                          ((jubyte *) retObj) + totalSize;
+        objDataSize = 0;
+    } else if ((retObj = JEM_AllocateObjectRecord(env, totalSize)) == NULL) {
         return NULL;
     }
+
+    /* Other native object data is allocated separately */
     if (objDataSize > 0) {
         ((JEMCC_ObjectExt *) retObj)->objectData = JEMCC_Malloc(env, 
                                                                 objDataSize);
         if (((JEMCC_ObjectExt *) retObj)->objectData == NULL) {
             return NULL;
         }
+        RECORD_SIZE(((jubyte *) retObj) - sizeof(void *)) |=
+                                                      RECORD_NATIVE_BIT;
     }
 
     /* Initialize the main object structure elements */
@@ -204,52 +300,62 @@ JEMCC_Object *JEMCC_AllocateObject(JNIEnv *env, JEMCC_Class *classInst,
  */
 JEMCC_Object *JEMCC_CloneObject(JNIEnv *env, JEMCC_Object *obj) {
     JEMCC_Object *retObj = NULL;
-    unsigned int totalSize = sizeof(JEMCC_Object);
+    unsigned int totalSize = sizeof(JEMCC_Object), arraySize = 0;
     JEMCC_Class *classInst = obj->classReference;
+    jboolean inSafeRegion;
 
-    /* Determine object size and allocate appropriately */
+    /* Determine object size (including any array storage) */
     totalSize += classInst->classData->packedFieldSize;
-    if ((retObj = JEM_AllocateObjectRecord(env, totalSize)) == NULL) {
-        return NULL;
-    }
-
-    /* Perform the shallow clone */
-    (void) memcpy(retObj, obj, totalSize);
-
-    /* Handle array clone operation */
     if ((classInst->classData->accessFlags & ACC_ARRAY) != 0) {
         switch (((JEMCC_ArrayClass *) classInst)->typeDepthInfo) {
             case PRIMITIVE_BOOLEAN | 1:
             case PRIMITIVE_BYTE | 1:
-                totalSize = ((JEMCC_ArrayObject *) obj)->arrayLength;
+                arraySize = ((JEMCC_ArrayObject *) obj)->arrayLength;
                 break;
             case PRIMITIVE_CHAR | 1:
             case PRIMITIVE_SHORT | 1:
-                totalSize = 2 * ((JEMCC_ArrayObject *) obj)->arrayLength;
+                arraySize = 2 * ((JEMCC_ArrayObject *) obj)->arrayLength;
                 break;
             case PRIMITIVE_INT | 1:
-                totalSize = 4 * ((JEMCC_ArrayObject *) obj)->arrayLength;
+                arraySize = 4 * ((JEMCC_ArrayObject *) obj)->arrayLength;
                 break;
             case PRIMITIVE_LONG | 1:
             case PRIMITIVE_DOUBLE | 1:
-                totalSize = 8 * ((JEMCC_ArrayObject *) obj)->arrayLength;
+                arraySize = 8 * ((JEMCC_ArrayObject *) obj)->arrayLength;
                 break;
             default:
                 /* Everything else is objects or nested arrays */
-                totalSize = 4 * ((JEMCC_ArrayObject *) obj)->arrayLength;
+                arraySize = 4 * ((JEMCC_ArrayObject *) obj)->arrayLength;
                 break;
         }
-        ((JEMCC_ArrayObject *) retObj)->arrayData =
-                                          JEMCC_Malloc(env, totalSize);
-        if (((JEMCC_ArrayObject *) retObj)->arrayData == NULL) {
-            return NULL;
-        }
+    }
+
+    /* Allocate appropriately, array storage follows the object record */
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
+    if (arraySize > 0) {
+        retObj = JEM_AllocateObjectRecord(env, 
+                                          ALLOC_ALIGN(totalSize) + arraySize);
+    } else {
+        retObj = JEM_AllocateObjectRecord(env, totalSize);
+    }
+    if (retObj == NULL) {
+        if (inSafeRegion) JEM_GCEnterSafeRegion(env);
+        return NULL;
+    }
+
+    /* Perform the shallow clone */
+    (void) memcpy(retObj, obj, totalSize);
 
-        /* Again, shallow copy of array contents */
+    /* Handle array clone operation, again shallow copy of array contents */
+    if (arraySize > 0) {
+        ((JEMCC_ArrayObject *) retObj)->arrayData = 
+                               ((jubyte *) retObj) + ALLOC_ALIGN(totalSize);
         (void) memcpy(((JEMCC_ArrayObject *) retObj)->arrayData,
-                      ((JEMCC_ArrayObject *) obj)->arrayData, totalSize);
+                      ((JEMCC_ArrayObject *) obj)->arrayData, arraySize);
     }
 
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
+
     return retObj;
 }
 
@@ -264,9 +370,15 @@ JEMCC_Object *JEMCC_CloneObject(JNIEnv *env, JEMCC_Object *obj) {
  *     object - the object instance which is to be marked non-local
  */
 void JEMCC_MarkNonLocalObject(JNIEnv *env, JEMCC_Object *object) {
+    JEMCC_Class *objClass;
     juint linkPtr;
 
-    if (object != NULL) return;
+    if (object == NULL) return;
+
+    /* Class instances are not allocated as (collectible) object records */
+    objClass = object->classReference;
+    if ((objClass == NULL) ||
+        (objClass == VM_CLASS(JEMCC_Class_Class))) return;
     linkPtr = *((juint *) ((void *) object - sizeof(void *)));
 
     /**
@@ -318,18 +430,17 @@ JEMCC_Object *JEMCC_NewObjectInstance(JNIEnv *env, JEMCC_VMFrame *frame,
     JEM_ClassData *classData = classInst->classData;
     JEM_ClassMethodData *conMethod = NULL;
     JEMCC_Object *retObj;
+    char *nameSym, *descSym;
     int i;
     
     /* Ensure the class is initialized */
     if (JEMCC_InitializeClass(env, classInst) != JNI_OK) return NULL;
 
-    /* Locate the constructor method instance */
-    for (i = 0; i < classData->localMethodCount; i++) {
-        if ((strcmp(classData->localMethods[i].name, "<init>") == 0) &&
-            (strcmp(classData->localMethods[i].descriptorStr, desc) == 0)) {
-            conMethod = &(classData->localMethods[i]);
-            break;
-        }
+    /* Locate the constructor method instance (through the local index) */
+    nameSym = JEM_LookupSymbol(env, "<init>");
+    descSym = JEM_LookupSymbol(env, desc);
+    if ((nameSym != NULL) && (descSym != NULL)) {
+        conMethod = JEM_LocateLocalMethod(classData, nameSym, descSym);
     }
     if (conMethod == NULL) {
         JEMCC_ThrowStdThrowableIdxV(env, JEMCC_Class_NoSuchMethodException,
@@ -365,21 +476,170 @@ JEMCC_Object *JEMCC_NewObjectInstance(JNIEnv *env, JEMCC_VMFrame *frame,
     return retObj;
 }
 
+/**
+ * Unlink a dedicated large object block from the given (doubly-linked)
+ * block list.
+ */
+static void JEM_UnlinkLargeBlock(void **blockList, void *block) {
+    if (BLOCK_PREV(block) == NULL) {
+        *blockList = BLOCK_NEXT(block);
+    } else {
+        BLOCK_NEXT(BLOCK_PREV(block)) = BLOCK_NEXT(block);
+    }
+    if (BLOCK_NEXT(block) != NULL) {
+        BLOCK_PREV(BLOCK_NEXT(block)) = BLOCK_PREV(block);
+    }
+}
+
+/**
+ * Return an unused (small) object record to the free lists of the given
+ * environment for reuse, clearing the object storage.  The free lists are
+ * allocated on demand, if this fails the record is simply abandoned.
+ */
+static void JEM_ReclaimRecord(JNIEnv *env, void *record) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    juint recordSize = RECORD_LENGTH(record);
+    juint index = recordSize / ALLOC_ALIGNMENT;
+
+    if (jenv->allocFreeLists == NULL) {
+        jenv->allocFreeLists = (void **) JEMCC_Malloc(env, 
+                                       ALLOC_FREE_LIST_COUNT * sizeof(void *));
+        if (jenv->allocFreeLists == NULL) return;
+    }
+
+    (void) memset(((jubyte *) record) + sizeof(void *), 0,
+                  recordSize - ALLOC_RECORD_HEADER_SIZE);
+    RECORD_SIZE(record) = recordSize | RECORD_RECLAIMED_BIT;
+    *((juint *) record) = (juint) jenv->allocFreeLists[index];
+    jenv->allocFreeLists[index] = record;
+}
+
+/**
+ * Release the native data (ACC_NATIVE_DATA) attached to an object which is
+ * being discarded.  Classes with an object management method are asked to
+ * collect the data, otherwise only the data allocated along with the object
+ * (by JEMCC_AllocateObject) is released.  Array storage and attachments
+ * which refer to VM structures (e.g. the reflection objects) are untouched.
+ */
+static void JEM_ReleaseNativeData(JNIEnv *env, JEMCC_Object *obj,
+                                  void *record) {
+    JEMCC_ObjectExt *extObj = (JEMCC_ObjectExt *) obj;
+    JEM_ClassData *classData;
+
+    if (obj->classReference == NULL) return;
+    classData = obj->classReference->classData;
+    if (((classData->accessFlags & (ACC_NATIVE_DATA | ACC_ARRAY)) !=
+                  ACC_NATIVE_DATA) || (extObj->objectData == NULL)) return;
+
+    if ((classData->objMgmtFn == NULL) ||
+        ((*(classData->objMgmtFn))(env, JEMCC_OM_GC_COLLECT,
+                                   obj, NULL) == JNI_EINVAL)) {
+        if ((RECORD_SIZE(record) & RECORD_NATIVE_BIT) != 0) {
+            JEMCC_Free(extObj->objectData);
+        }
+    }
+    extObj->objectData = NULL;
+}
+
+/**
+ * Determine whether a (small) record of the frame being released lies below
+ * the reset point of the allocation region, in which case it is not
+ * recovered by the region reset.  Records in the blocks newer than the
+ * reset block are released with those blocks.
+ */
+static jboolean JEM_RecordBelowReset(JEM_JNIEnv *jenv, void *record,
+                                     void *block, jubyte *resetPtr) {
+    jubyte *base = RECORD_BASE(record);
+    void *regionBlock;
+
+    if (block == NULL) return JNI_FALSE;
+    if ((base > (jubyte *) block) &&
+        (base < ((jubyte *) block) + ALLOC_BLOCK_SIZE)) {
+        return (base < resetPtr) ? JNI_TRUE : JNI_FALSE;
+    }
+    regionBlock = jenv->allocBlockList;
+    while (regionBlock != block) {
+        if ((base > (jubyte *) regionBlock) &&
+            (base < ((jubyte *) regionBlock) + ALLOC_BLOCK_SIZE)) {
+            return JNI_FALSE;
+        }
+        regionBlock = BLOCK_NEXT(regionBlock);
+    }
+
+    return JNI_TRUE;
+}
+
 /**
  * Perform the allocation of a base object instance, adding it to the 
- * frame-specific garbage collection table.
+ * frame-specific garbage collection table.  Records which have been
+ * reclaimed from the global heap are reused first, otherwise the record is
+ * carved from the thread-local allocation block of the environment.  When
+ * the current block is exhausted, a portion of any pending heap sweep is
+ * performed before starting a new block (the unused tail is simply
+ * abandoned).  The free space of the allocation blocks is always zeroed
+ * (new blocks are allocated through JEMCC_Malloc and region resets clear
+ * the reclaimed space) as are reclaimed records, hence the record is zeroed.
  *
  * Note that, because this is environment specific, there are no
  * threading/concurrency issues in the record management.
  */
 static JEMCC_Object *JEM_AllocateObjectRecord(JNIEnv *env, juint totalSize) {
     JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
-    juint linkPtr;
-    void *retVal;
+    juint linkPtr, recordSize, recordFlags = 0, index;
+    void *retVal = NULL, *block;
+    jubyte *record;
 
-    /* Allocate the memory block (for now, standard malloc) */
-    retVal = JEMCC_Malloc(env, totalSize + sizeof(void *));
-    if (retVal == NULL) return NULL;
+    /* Carve the memory block from the thread-local allocation block */
+    recordSize = ALLOC_ALIGN(totalSize + ALLOC_RECORD_HEADER_SIZE);
+    if (recordSize > ALLOC_LARGE_OBJECT_SIZE) {
+        /* Large objects get a dedicated block */
+        if (jenv->parentVM->heapSweepRecords != NULL) {
+            JEM_SweepHeapRecords(env, ALLOC_SWEEP_QUANTUM);
+        }
+        block = JEMCC_Malloc(env, ALLOC_BLOCK_HEADER_SIZE + recordSize);
+        if (block == NULL) return NULL;
+        BLOCK_NEXT(block) = jenv->allocLargeList;
+        if (jenv->allocLargeList != NULL) {
+            BLOCK_PREV(jenv->allocLargeList) = block;
+        }
+        jenv->allocLargeList = block;
+        record = ((jubyte *) block) + ALLOC_BLOCK_HEADER_SIZE;
+        recordFlags = LARGE_RECORD_BIT;
+    } else {
+        index = recordSize / ALLOC_ALIGNMENT;
+        if (jenv->allocFreeLists != NULL) retVal = jenv->allocFreeLists[index];
+        if ((retVal == NULL) && ((jenv->allocBlockPtr == NULL) ||
+                 (jenv->allocBlockPtr + recordSize > jenv->allocBlockEnd))) {
+            if (jenv->parentVM->heapSweepRecords != NULL) {
+                JEM_SweepHeapRecords(env, ALLOC_SWEEP_QUANTUM);
+                if (jenv->allocFreeLists != NULL) {
+                    retVal = jenv->allocFreeLists[index];
+                }
+            }
+            if (retVal == NULL) {
+                block = JEMCC_Malloc(env, ALLOC_BLOCK_SIZE);
+                if (block == NULL) return NULL;
+                BLOCK_NEXT(block) = jenv->allocBlockList;
+                jenv->allocBlockList = block;
+                jenv->allocBlockPtr = ((jubyte *) block) + 
+                                                ALLOC_BLOCK_HEADER_SIZE;
+                jenv->allocBlockEnd = ((jubyte *) block) + ALLOC_BLOCK_SIZE;
+            }
+        }
+        if (retVal != NULL) {
+            /* Reclaimed records retain their (flagged) size */
+            jenv->allocFreeLists[index] = RECORD_NEXT(retVal);
+            record = NULL;
+        } else {
+            record = jenv->allocBlockPtr;
+            jenv->allocBlockPtr += recordSize;
+        }
+    }
+    if (record != NULL) {
+        retVal = record + ALLOC_RECORD_HEADER_SIZE - sizeof(void *);
+        RECORD_SIZE(retVal) = recordSize;
+    }
+    *((juint *) retVal) = recordFlags;
 
     /* Update the linked lists for allocation tracking (null flags) */
     if (jenv->firstAllocObjectRecord == NULL) {
@@ -388,7 +648,7 @@ static JEMCC_Object *JEM_AllocateObjectRecord(JNIEnv *env, juint totalSize) {
     } else {
         linkPtr = *((juint *) jenv->lastAllocObjectRecord);
         *((juint *) jenv->lastAllocObjectRecord) = 
-                                     ((juint) retVal) | (linkPtr & 0x03);
+                              ((juint) retVal) | (linkPtr & RECORD_FLAG_MASK);
         jenv->lastAllocObjectRecord = retVal;
         if (jenv->topFrame->firstAllocObjectRecord == NULL) 
                              jenv->topFrame->firstAllocObjectRecord = retVal;
@@ -399,63 +659,1497 @@ static JEMCC_Object *JEM_AllocateObjectRecord(JNIEnv *env, juint totalSize) {
 }
 
 /**
- * Perform a flush of all local object instances for the current frame
- * (which is exiting/popping from the stack).  If specified, do *not*
- * flush the given return value or exception being processed.
+ * Common method to process the objects allocated in the current frame
+ * (which is exiting/popping from the stack).  The records of the frame are
+ * those following the last record allocated prior to the frame.  Retained
+ * objects remain in the allocation list (now belonging to the calling frame),
+ * non-local objects are moved to the global heap list of the VM and the
+ * remaining local objects are released.  Local objects in the thread-local
+ * allocation blocks are released in bulk, by resetting the bump allocation
+ * region to the mark taken when the frame was created (but never below the
+ * end of the last surviving object of the frame).
+ *
+ * Once objects have been promoted out of the region, the reset point is
+ * also pushed into the calling frame, so that the promoted records are
+ * never reclaimed by the region resets of the outer frames.  Local records
+ * below such a pinned reset point are returned to the free lists instead,
+ * as are the records which were reused from the free lists (outside of the
+ * region).  When the reset point is only raised by retained objects, the
+ * (cleared) local records below it are handed to the calling frame, whose
+ * release recovers them.  The native data of the released objects is freed
+ * and promoted large object blocks are handed over to the heap.  A
+ * collection is started once the promotions take the heap past the
+ * collection threshold.
  */
-void JEM_FlushLocalFrameAllocations(JNIEnv *env, JEMCC_Object *retVal,
-                                    JEMCC_Object *pendingException) {
+static void JEM_ReleaseFrameRegion(JNIEnv *env, JEMCC_Object *retVal,
+                                   JEMCC_Object *pendingException,
+                                   jboolean promoteAll) {
     JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
-    JEMCC_ThrowableData *throwData;
+    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_VMFrameExt *frame = jenv->topFrame;
+    JEM_VMFrameExt *caller = frame->previousFrame;
+    JEMCC_ThrowableData *throwData = NULL;
     JEMCC_Object *currentObject;
-    void *currentRecord, *lastRecord, *nextRecord;
-    juint linkPtr;
+    juint i;
+    void *currentRecord, *nextRecord, *keepRecord, *pinRecord = NULL;
+    void *promoteFirst = NULL, *promoteLast = NULL, *block, *regionBlock;
+    void *largeFirst = NULL, *largeLast = NULL, *deadFirst = NULL;
+    jubyte *resetPtr, *clearEnd, *pinStart, *pinEnd;
+    juint linkPtr, promoteCount = 0, promoteBytes = 0;
+    jboolean pinned, retained, reclaimed, collect = JNI_FALSE;
 
-    /* Start from the current frame's initial allocation */
-    currentRecord = jenv->topFrame->firstAllocObjectRecord;
-    if (currentRecord == NULL) return;
+    /* Nothing to do if frame has no objects and has not been pinned */
+    pinned = ((frame->opFlags & FRAME_REGION_PINNED) != 0) ? 
+                                                        JNI_TRUE : JNI_FALSE;
+    if ((frame->firstAllocObjectRecord == NULL) && (pinned == JNI_FALSE)) {
+        return;
+    }
 
     /* Walk the linked list, moving into appropriate buckets */
     if (pendingException != NULL) throwData = (JEMCC_ThrowableData *)
-                            ((JEMCC_ObjectExt *) pendingException)->objectData;
-    lastRecord = NULL;
+                         &(((JEMCC_ObjectExt *) pendingException)->objectData);
+    keepRecord = frame->allocPrevRecord;
+    currentRecord = frame->firstAllocObjectRecord;
     while (currentRecord != NULL) {
         linkPtr = *((juint *) currentRecord);
+        nextRecord = RECORD_NEXT(currentRecord);
         currentObject = (JEMCC_Object *) (currentRecord + sizeof(void *));
-        if ((retVal != NULL) && (currentObject == retVal)) {
-fprintf(stderr, "Returning object\n", currentObject);
-            /* Move on to the next record */
-            lastRecord = currentRecord;
-            currentRecord = (void *) (linkPtr & 0xFFFFFFFC);
+        reclaimed = ((RECORD_SIZE(currentRecord) & 
+                         RECORD_RECLAIMED_BIT) != 0) ? JNI_TRUE : JNI_FALSE;
+
+        /* Objects still pinned by native code escape the frame */
+        if ((jenv->pinnedCount != 0) && ((linkPtr & NONLOCAL_BIT) == 0)) {
+            for (i = 0; i < jenv->pinnedCount; i++) {
+                if (jenv->pinnedObjects[i] == currentObject) {
+                    linkPtr |= NONLOCAL_BIT;
+                    break;
+                }
+            }
+        }
+
+        retained = JNI_FALSE;
+        if ((promoteAll == JNI_FALSE) && ((linkPtr & NONLOCAL_BIT) == 0)) {
+            if ((retVal != NULL) && (currentObject == retVal)) {
+                retained = JNI_TRUE;
+            } else if ((pendingException != NULL) &&
+                       ((currentObject == pendingException) ||
+                        (currentObject == throwData->message) ||
+                        (currentObject == throwData->causeThrowable))) {
+                retained = JNI_TRUE;
+            }
+        }
+
+        if (retained != JNI_FALSE) {
+            /* Retain in the allocation list for the calling frame */
+            if (keepRecord == NULL) {
+                jenv->firstAllocObjectRecord = currentRecord;
+            } else {
+                *((juint *) keepRecord) = ((juint) currentRecord) |
+                            (*((juint *) keepRecord) & RECORD_FLAG_MASK);
+            }
+            if (caller->firstAllocObjectRecord == NULL) {
+                caller->firstAllocObjectRecord = currentRecord;
+            }
+            keepRecord = currentRecord;
+            if (((linkPtr & LARGE_RECORD_BIT) == 0) &&
+                                           (reclaimed == JNI_FALSE)) {
+                pinRecord = currentRecord;
+            }
+        } else if ((promoteAll != JNI_FALSE) || 
+                               ((linkPtr & NONLOCAL_BIT) != 0)) {
+            /* Escaped object, collect for promotion to the heap list */
+            *((juint *) currentRecord) = 
+                               (linkPtr & RECORD_FLAG_MASK) | NONLOCAL_BIT;
+            if (promoteLast == NULL) {
+                promoteFirst = currentRecord;
+            } else {
+                *((juint *) promoteLast) |= (juint) currentRecord;
+            }
+            promoteLast = currentRecord;
+            promoteCount++;
+            promoteBytes += RECORD_LENGTH(currentRecord);
+            if ((linkPtr & LARGE_RECORD_BIT) != 0) {
+                /* The dedicated block now belongs to the heap */
+                block = RECORD_BASE(currentRecord) - ALLOC_BLOCK_HEADER_SIZE;
+                JEM_UnlinkLargeBlock(&(jenv->allocLargeList), block);
+                BLOCK_PREV(block) = NULL;
+                BLOCK_NEXT(block) = largeFirst;
+                if (largeFirst == NULL) {
+                    largeLast = block;
+                } else {
+                    BLOCK_PREV(largeFirst) = block;
+                }
+                largeFirst = block;
+            } else if (reclaimed == JNI_FALSE) {
+                pinRecord = currentRecord;
+                pinned = JNI_TRUE;
+            }
+        } else {
+            JEM_ReleaseNativeData(env, currentObject, currentRecord);
+            if ((linkPtr & LARGE_RECORD_BIT) != 0) {
+                /* Local large object, release the dedicated block */
+                block = RECORD_BASE(currentRecord) - ALLOC_BLOCK_HEADER_SIZE;
+                JEM_UnlinkLargeBlock(&(jenv->allocLargeList), block);
+                JEMCC_Free(block);
+            } else if (reclaimed != JNI_FALSE) {
+                /* Reused record is not part of the region, return it */
+                JEM_ReclaimRecord(env, currentRecord);
+            } else {
+                /* Region record, released against the reset point below */
+                *((juint *) currentRecord) = (juint) deadFirst;
+                deadFirst = currentRecord;
+            }
+        }
+
+        currentRecord = nextRecord;
+    }
+
+    /* Terminate the allocation list at the last retained record */
+    if (keepRecord == NULL) {
+        jenv->firstAllocObjectRecord = jenv->lastAllocObjectRecord = NULL;
+    } else {
+        *((juint *) keepRecord) &= RECORD_FLAG_MASK;
+        jenv->lastAllocObjectRecord = keepRecord;
+    }
+    frame->firstAllocObjectRecord = NULL;
+
+    /* Splice the escaped objects into the global heap list */
+    if (promoteFirst != NULL) {
+        JEMCC_EnterSysMonitor(jvm->monitor);
+        *((juint *) promoteLast) |= (juint) jvm->heapObjectRecords;
+        jvm->heapObjectRecords = promoteFirst;
+        jvm->heapObjectCount += promoteCount;
+        jvm->heapObjectBytes += promoteBytes;
+        if (largeFirst != NULL) {
+            BLOCK_NEXT(largeLast) = jvm->heapLargeList;
+            if (jvm->heapLargeList != NULL) {
+                BLOCK_PREV(jvm->heapLargeList) = largeLast;
+            }
+            jvm->heapLargeList = largeFirst;
+        }
+        if (jvm->gcThreshold == 0) jvm->gcThreshold = GC_MIN_THRESHOLD(jvm);
+        if (jvm->heapObjectBytes >= jvm->gcThreshold) collect = JNI_TRUE;
+        (void) JEMCC_ExitSysMonitor(jvm->monitor);
+    }
+
+    /* Determine the region reset point, above the last surviving object */
+    block = frame->allocRegionBlock;
+    resetPtr = frame->allocRegionPtr;
+    if (pinRecord != NULL) {
+        pinStart = RECORD_BASE(pinRecord);
+        pinEnd = pinStart + RECORD_LENGTH(pinRecord);
+        regionBlock = jenv->allocBlockList;
+        while (regionBlock != NULL) {
+            if ((pinStart > (jubyte *) regionBlock) &&
+                (pinStart < ((jubyte *) regionBlock) + ALLOC_BLOCK_SIZE)) {
+                if ((regionBlock != block) || (pinEnd > resetPtr)) {
+                    block = regionBlock;
+                    resetPtr = pinEnd;
+                }
+                break;
+            }
+            if (regionBlock == block) break;
+            regionBlock = BLOCK_NEXT(regionBlock);
+        }
+    }
+
+    /* Recover the local records which lie below the reset point */
+    if ((pinned == JNI_FALSE) && (pinRecord == NULL)) deadFirst = NULL;
+    while (deadFirst != NULL) {
+        currentRecord = deadFirst;
+        deadFirst = (void *) *((juint *) currentRecord);
+        if (JEM_RecordBelowReset(jenv, currentRecord,
+                                 block, resetPtr) == JNI_FALSE) continue;
+        if (pinned != JNI_FALSE) {
+            JEM_ReclaimRecord(env, currentRecord);
             continue;
         }
-        if (pendingException != NULL) {
-           if ((currentObject == pendingException) ||
-               (currentObject == throwData->message) ||
-               (currentObject == throwData->causeThrowable)) {
-fprintf(stderr, "Pending exception (contents) %p\n", currentObject);
-                /* Move on to the next record */
-                lastRecord = currentRecord;
-                currentRecord = (void *) (linkPtr & 0xFFFFFFFC);
-                continue;
-           }
-        }
-
-        /* Destroy local or move non-local records to GC list */
-        nextRecord = (void *) (linkPtr & 0xFFFFFFFC);
-        if ((linkPtr & NONLOCAL_BIT) != 0) {
-fprintf(stderr, "Non-local object %p\n", currentObject);
+
+        /* Region of the caller is not pinned, its reset will recover it */
+        (void) memset(((jubyte *) currentRecord) + sizeof(void *), 0,
+                      RECORD_LENGTH(currentRecord) - ALLOC_RECORD_HEADER_SIZE);
+        *((juint *) currentRecord) = 0;
+        if (jenv->lastAllocObjectRecord == NULL) {
+            jenv->firstAllocObjectRecord = currentRecord;
         } else {
-fprintf(stderr, "Local object %p\n", currentObject);
-            /* Perform destruct sequence, including known objects */
+            *((juint *) jenv->lastAllocObjectRecord) |=
+                                                 (juint) currentRecord;
+        }
+        jenv->lastAllocObjectRecord = currentRecord;
+        if (caller->firstAllocObjectRecord == NULL) {
+            caller->firstAllocObjectRecord = currentRecord;
+        }
+    }
+
+    /* Reset the region, releasing newer blocks and clearing reclaimed space */
+    if (block == NULL) {
+        clearEnd = NULL;
+    } else if (jenv->allocBlockList == block) {
+        clearEnd = jenv->allocBlockPtr;
+    } else {
+        clearEnd = ((jubyte *) block) + ALLOC_BLOCK_SIZE;
+    }
+    while (jenv->allocBlockList != block) {
+        regionBlock = jenv->allocBlockList;
+        jenv->allocBlockList = BLOCK_NEXT(regionBlock);
+        JEMCC_Free(regionBlock);
+    }
+    if (block == NULL) {
+        jenv->allocBlockPtr = jenv->allocBlockEnd = NULL;
+    } else {
+        if (clearEnd > resetPtr) {
+            (void) memset(resetPtr, 0, clearEnd - resetPtr);
+        }
+        jenv->allocBlockPtr = resetPtr;
+        jenv->allocBlockEnd = ((jubyte *) block) + ALLOC_BLOCK_SIZE;
+    }
+
+    /* Promoted objects pin the region of the calling frame */
+    if (pinned != JNI_FALSE) {
+        caller->allocRegionBlock = block;
+        caller->allocRegionPtr = resetPtr;
+        caller->opFlags |= FRAME_REGION_PINNED;
+    }
+
+    /* Once the region is consistent, collect the heap if required */
+    if (collect != JNI_FALSE) (void) JEM_CollectHeap(env);
+}
+
+/**
+ * Perform a flush of all local object instances for the current frame
+ * (which is exiting/popping from the stack).  If specified, do *not*
+ * flush the given return value or exception being processed, which are
+ * handed to the calling frame.  Objects which have been marked as non-local
+ * are promoted to the global heap list of the VM (where they are subject to
+ * full referential GC), all others are released with the frame region.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     retVal - the object being returned from the frame, if non-NULL
+ *     pendingException - the throwable being processed, if non-NULL
+ */
+void JEM_FlushLocalFrameAllocations(JNIEnv *env, JEMCC_Object *retVal,
+                                    JEMCC_Object *pendingException) {
+    JEM_ReleaseFrameRegion(env, retVal, pendingException, JNI_FALSE);
+}
+
+/**
+ * Promote all of the object instances allocated in the current frame
+ * (which is exiting/popping from the stack) to the global heap list of the
+ * VM.  Native and JEMCC methods may store object references in native data
+ * structures without marking them as non-local, so their objects are
+ * treated as escaped.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+void JEM_PromoteLocalFrameAllocations(JNIEnv *env) {
+    JEM_ReleaseFrameRegion(env, NULL, NULL, JNI_TRUE);
+}
+
+/**
+ * Pin an object instance for direct access to its storage by native code.
+ * Each pin is an entry in the pinned table of the environment, which is
+ * scanned for collection roots and consulted when frame regions are
+ * released (pinned local objects are promoted rather than released).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     obj - the object instance to be pinned
+ *
+ * Returns:
+ *     JNI_OK if the object was pinned, JNI_ENOMEM if the pin table of the
+ *     environment could not be expanded (an OutOfMemoryError will have been
+ *     thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_PinObject(JNIEnv *env, JEMCC_Object *obj) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEMCC_Object **pinned;
+    jboolean inSafeRegion;
+    juint capacity;
+
+    /* The pin table is a collection root, update it outside a safe region */
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
+    if (jenv->pinnedCount >= jenv->pinnedCapacity) {
+        capacity = (jenv->pinnedCapacity == 0) ? PIN_INITIAL_CAPACITY :
+                                                 2 * jenv->pinnedCapacity;
+        pinned = (JEMCC_Object **) JEMCC_Malloc(env, 
+                                         capacity * sizeof(JEMCC_Object *));
+        if (pinned == NULL) {
+            if (inSafeRegion) JEM_GCEnterSafeRegion(env);
+            return JNI_ENOMEM;
+        }
+        if (jenv->pinnedObjects != NULL) {
+            (void) memcpy(pinned, jenv->pinnedObjects,
+                          jenv->pinnedCount * sizeof(JEMCC_Object *));
+            JEMCC_Free(jenv->pinnedObjects);
+        }
+        jenv->pinnedObjects = pinned;
+        jenv->pinnedCapacity = capacity;
+    }
+    jenv->pinnedObjects[jenv->pinnedCount++] = obj;
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
+
+    return JNI_OK;
+}
+
+/**
+ * Release a single pin of an object instance.  Pins are normally released
+ * in the reverse order of their creation, so the table is searched from
+ * the most recent entry.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     obj - the object instance to be unpinned
+ */
+void JEM_UnpinObject(JNIEnv *env, JEMCC_Object *obj) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    juint i = jenv->pinnedCount;
+    jboolean inSafeRegion;
+
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
+    while (i > 0) {
+        if (jenv->pinnedObjects[--i] == obj) {
+            jenv->pinnedCount--;
+            (void) memmove(jenv->pinnedObjects + i,
+                           jenv->pinnedObjects + i + 1,
+                           (jenv->pinnedCount - i) * sizeof(JEMCC_Object *));
+            break;
+        }
+    }
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
+}
+
+/**
+ * Release all of the thread-local object allocation blocks associated with
+ * the given environment.  This invalidates every object instance allocated
+ * through the environment (including those which have been promoted to
+ * the global heap list) and is only to be used when the virtual machine is
+ * destroyed.
+ *
+ * Parameters:
+ *     env - the VM environment whose allocation blocks are to be released
+ */
+void JEM_ReleaseAllocationBlocks(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    void *block, *nextBlock;
+
+    block = jenv->allocBlockList;
+    while (block != NULL) {
+        nextBlock = BLOCK_NEXT(block);
+        JEMCC_Free(block);
+        block = nextBlock;
+    }
+    block = jenv->allocLargeList;
+    while (block != NULL) {
+        nextBlock = BLOCK_NEXT(block);
+        JEMCC_Free(block);
+        block = nextBlock;
+    }
+    jenv->allocBlockList = jenv->allocLargeList = NULL;
+    jenv->allocBlockPtr = jenv->allocBlockEnd = NULL;
+    jenv->firstAllocObjectRecord = jenv->lastAllocObjectRecord = NULL;
+
+    /* Reclaimed records were in the allocation blocks (of any environment) */
+    if (jenv->allocFreeLists != NULL) JEMCC_Free(jenv->allocFreeLists);
+    jenv->allocFreeLists = NULL;
+
+    /* Any remaining pins are released along with the blocks */
+    if (jenv->pinnedObjects != NULL) JEMCC_Free(jenv->pinnedObjects);
+    jenv->pinnedObjects = NULL;
+    jenv->pinnedCount = jenv->pinnedCapacity = 0;
+}
+
+/*
+ * The tracing collector for the global heap.  Marking is performed by the
+ * collecting thread and a pool of worker threads, each with a private mark
+ * stack.  Workers with a surplus of pending objects publish a chunk of them
+ * to a shared segment of their stack, from which idle workers steal.  Mark
+ * state is held in the record size word - concurrent marking of the same
+ * record is benign (both threads store the same value and the object is
+ * simply scanned twice).
+ */
+typedef struct JEM_GCMarkStack {
+    struct JEM_GCControl *control;
+    JEM_JNIEnv *workerEnv;
+
+    /* Private stack of marked objects pending scan (owner thread only) */
+    JEMCC_Object **entries;
+    juint count, capacity;
+
+    /* Segment available for stealing by idle workers (monitor guarded) */
+    JEMCC_SysMonitor *monitor;
+    JEMCC_Object *shared[GC_STEAL_CHUNK];
+    juint sharedCount;
+
+    /* Marking statistics and overflow indicator for the current collection */
+    juint markCount, markBytes;
+    jboolean overflow;
+
+    /* Single entry cache for the ClassLoader instance test */
+    JEMCC_Class *lastClass;
+    jboolean lastIsLoader;
+} JEM_GCMarkStack;
+
+/* Address range of an allocation block, for conservative root validation */
+typedef struct JEM_GCBlockRange {
+    jubyte *start, *end;
+    jboolean large;
+} JEM_GCBlockRange;
+
+typedef struct JEM_GCControl {
+    JEM_JavaVM *jvm;
+
+    /* Worker management (maxWorkers stacks, workerCount participating) */
+    JEMCC_SysMonitor *monitor;
+    JEM_GCMarkStack *stacks;
+    juint maxWorkers, workerCount, readyCount, exitCount;
+    juint cycle, finishedCount, idleCount;
+    jboolean markComplete, shutdown;
+
+    /* Classes requiring special treatment in the object scans */
+    JEMCC_Class *classClass, *loaderClass;
+
+    /* Sorted allocation block ranges for the current collection */
+    JEM_GCBlockRange *blocks;
+    juint blockCount, blockCapacity;
+} JEM_GCControl;
+
+/* Determine if the given class field holds an object reference */
+#define GC_REFERENCE_FIELD(fld) \
+    (((fld)->descriptorStr != NULL) && \
+     ((*((fld)->descriptorStr) == 'L') || (*((fld)->descriptorStr) == '[')))
+
+/**
+ * Double the capacity of the private mark stack.  Uses the standard
+ * allocator directly, as there is no exception context for the workers.
+ */
+static jint JEM_GCGrowStack(JEM_GCMarkStack *stack) {
+    JEMCC_Object **entries;
+
+    entries = (JEMCC_Object **) JEMCC_Malloc((JNIEnv *) stack->workerEnv,
+                           2 * stack->capacity * sizeof(JEMCC_Object *));
+    if (entries == NULL) return JNI_ENOMEM;
+    (void) memcpy(entries, stack->entries,
+                  stack->count * sizeof(JEMCC_Object *));
+    JEMCC_Free(stack->entries);
+    stack->entries = entries;
+    stack->capacity *= 2;
+
+    return JNI_OK;
+}
+
+/**
+ * Push a (newly marked) object onto the private mark stack, publishing
+ * the most recent entries for stealing once a surplus has accumulated and
+ * the shared segment has been drained.  If the stack cannot be expanded,
+ * the overflow is flagged and the object is picked up by a rescan of the
+ * marked records.
+ */
+static void JEM_GCPush(JEM_GCMarkStack *stack, JEMCC_Object *obj) {
+    if (stack->count >= stack->capacity) {
+        if (JEM_GCGrowStack(stack) != JNI_OK) {
+            stack->overflow = JNI_TRUE;
+            return;
+        }
+    }
+    stack->entries[stack->count++] = obj;
+
+    /* Only the owner fills the segment, so a stale count is harmless */
+    if ((stack->count >= 2 * GC_STEAL_CHUNK) && (stack->sharedCount == 0) &&
+        (stack->control->workerCount > 1)) {
+        JEMCC_EnterSysMonitor(stack->monitor);
+        if (stack->sharedCount == 0) {
+            stack->count -= GC_STEAL_CHUNK;
+            (void) memcpy(stack->shared, stack->entries + stack->count,
+                          GC_STEAL_CHUNK * sizeof(JEMCC_Object *));
+            stack->sharedCount = GC_STEAL_CHUNK;
+        }
+        (void) JEMCC_ExitSysMonitor(stack->monitor);
+    }
+}
+
+/**
+ * Pop the next object to be scanned from the private mark stack, taking
+ * back any unstolen entries from the shared segment once it is empty.
+ */
+static JEMCC_Object *JEM_GCPop(JEM_GCMarkStack *stack) {
+    if (stack->count == 0) {
+        if (stack->sharedCount == 0) return NULL;
+        JEMCC_EnterSysMonitor(stack->monitor);
+        (void) memcpy(stack->entries, stack->shared,
+                      stack->sharedCount * sizeof(JEMCC_Object *));
+        stack->count = stack->sharedCount;
+        stack->sharedCount = 0;
+        (void) JEMCC_ExitSysMonitor(stack->monitor);
+        if (stack->count == 0) return NULL;
+    }
+
+    return stack->entries[--(stack->count)];
+}
+
+/**
+ * Steal half of the shared segment of another worker into the (empty)
+ * private stack of the given worker.
+ */
+static jboolean JEM_GCSteal(JEM_GCControl *ctrl, JEM_GCMarkStack *stack) {
+    juint i, stealCount, index = stack - ctrl->stacks;
+    JEM_GCMarkStack *victim;
+
+    for (i = 1; i < ctrl->workerCount; i++) {
+        victim = &(ctrl->stacks[(index + i) % ctrl->workerCount]);
+        if (victim->sharedCount == 0) continue;
+
+        JEMCC_EnterSysMonitor(victim->monitor);
+        stealCount = (victim->sharedCount + 1) / 2;
+        victim->sharedCount -= stealCount;
+        (void) memcpy(stack->entries, victim->shared + victim->sharedCount,
+                      stealCount * sizeof(JEMCC_Object *));
+        (void) JEMCC_ExitSysMonitor(victim->monitor);
+
+        if (stealCount > 0) {
+            stack->count = stealCount;
+            return JNI_TRUE;
+        }
+    }
+
+    return JNI_FALSE;
+}
+
+/**
+ * Called when the worker has exhausted its own marking work.  Attempts to
+ * steal from the other workers, otherwise waits (idle) until more work is
+ * published or all of the workers are idle, which completes the marking.
+ * Note that an idle worker holds no work (it drains its shared segment
+ * before going idle) and is only counted as idle while it holds no work.
+ *
+ * Returns:
+ *     JNI_TRUE if work was obtained, JNI_FALSE if marking is complete.
+ */
+static jboolean JEM_GCAcquireWork(JEM_GCControl *ctrl, 
+                                  JEM_GCMarkStack *stack) {
+    jboolean available;
+    juint i;
+
+    if (JEM_GCSteal(ctrl, stack) != JNI_FALSE) return JNI_TRUE;
+
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    ctrl->idleCount++;
+    while (ctrl->markComplete == JNI_FALSE) {
+        if (ctrl->idleCount == ctrl->workerCount) {
+            ctrl->markComplete = JNI_TRUE;
+            (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+            break;
+        }
+
+        available = JNI_FALSE;
+        for (i = 0; i < ctrl->workerCount; i++) {
+            if (ctrl->stacks[i].sharedCount != 0) available = JNI_TRUE;
         }
+        if (available != JNI_FALSE) {
+            ctrl->idleCount--;
+            (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+            if (JEM_GCSteal(ctrl, stack) != JNI_FALSE) return JNI_TRUE;
+            JEMCC_EnterSysMonitor(ctrl->monitor);
+            ctrl->idleCount++;
+            continue;
+        }
+
+        (void) JEMCC_SysMonitorMilliWait(ctrl->monitor, 1);
+    }
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+    return JNI_FALSE;
+}
+
+/**
+ * Mark the given object reference, if it refers to an unmarked record of
+ * the global heap, and queue it for scanning.  Class instances are not
+ * object records, local (environment owned) records are scanned as roots.
+ * Local records which have been marked as non-local are marked as well,
+ * their marks are cleared once the collection completes.
+ */
+static void JEM_GCMarkObject(JEM_GCMarkStack *stack, JEMCC_Object *obj) {
+    JEMCC_Class *objClass;
+    jubyte *record;
+    juint size;
+
+    if (obj == NULL) return;
+    objClass = obj->classReference;
+    if ((objClass == NULL) || (objClass == stack->control->classClass)) return;
+
+    record = ((jubyte *) obj) - sizeof(void *);
+    if ((*((juint *) record) & NONLOCAL_BIT) == 0) return;
+    size = RECORD_SIZE(record);
+    if ((size & RECORD_MARK_BIT) != 0) return;
+    RECORD_SIZE(record) = size | RECORD_MARK_BIT;
+
+    stack->markCount++;
+    stack->markBytes += size & RECORD_SIZE_MASK;
+    JEM_GCPush(stack, obj);
+}
+
+/* Mark callback for the class scan hooks (see JEM_GCScanFn) */
+static void JEM_GCMarkReference(void *markData, JEMCC_Object *obj) {
+    JEM_GCMarkObject((JEM_GCMarkStack *) markData, obj);
+}
 
-        /* Unlink from current chain, move to next record */
-        if (lastRecord == NULL) {
+/**
+ * Mark a value which may or may not be an object reference (frame stack
+ * entries have no type information).  The value is only treated as an
+ * object if it is the start of an object record in one of the allocation
+ * blocks (which are always walkable, as unused space is zeroed).
+ */
+static void JEM_GCMarkConservative(JEM_GCMarkStack *stack, void *value) {
+    JEM_GCControl *ctrl = stack->control;
+    JEM_GCBlockRange *range = NULL;
+    jubyte *ptr = (jubyte *) value, *base, *record;
+    juint low = 0, high = ctrl->blockCount, mid, size;
+
+    /* Locate the allocation block containing the value */
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (ptr < ctrl->blocks[mid].start) {
+            high = mid;
+        } else if (ptr >= ctrl->blocks[mid].end) {
+            low = mid + 1;
         } else {
-        *((juint *) jenv->lastAllocObjectRecord) = 
-                                     ((juint) retVal) | (linkPtr & 0x03);
+            range = &(ctrl->blocks[mid]);
+            break;
         }
-        currentRecord = nextRecord;
     }
+    if (range == NULL) return;
+
+    /* Walk the block records, looking for an exact object match */
+    base = range->start + ALLOC_BLOCK_HEADER_SIZE;
+    while (base + ALLOC_RECORD_HEADER_SIZE < range->end) {
+        record = base + ALLOC_RECORD_HEADER_SIZE - sizeof(void *);
+        size = RECORD_LENGTH(record);
+        if (size == 0) break;
+        if (record + sizeof(void *) == ptr) {
+            JEM_GCMarkObject(stack, (JEMCC_Object *) ptr);
+            break;
+        }
+        if ((record + sizeof(void *) > ptr) || (range->large != JNI_FALSE)) {
+            break;
+        }
+        base += size;
+    }
+}
+
+/**
+ * Scan the values of the static reference fields of the given class.
+ */
+static void JEM_GCScanStatics(JEM_GCMarkStack *stack, JEMCC_Class *classInst) {
+    JEM_ClassData *classData = classInst->classData;
+    JEM_ClassFieldData *field;
+    jsize i;
+
+    if ((classData == NULL) || (classInst->staticData == NULL)) return;
+    for (i = 0; i < classData->localFieldCount; i++) {
+        field = &(classData->localFields[i]);
+        if (((field->accessFlags & ACC_STATIC) == 0) ||
+            (!GC_REFERENCE_FIELD(field))) continue;
+        JEM_GCMarkObject(stack, *((JEMCC_Object **) 
+                  (((jbyte *) classInst->staticData) + field->fieldOffset)));
+    }
+}
+
+/**
+ * Hashtable scanner for the class tables (bootstrap and ClassLoader
+ * namespaces), scanning the static fields of each class.  The package and
+ * pending class records of the bootstrap table (see package.c) are skipped.
+ */
+static jint JEM_GCClassScanner(JNIEnv *env, JEMCC_HashTable *table, 
+                               void *key, void *obj, void *userData) {
+    char *className = (char *) key;
+
+    if ((*className == '+') || (*className == '-') || (*className == '!') ||
+        (*className == '?') || (*className == '@')) return JNI_OK;
+    JEM_GCScanStatics((JEM_GCMarkStack *) userData, (JEMCC_Class *) obj);
+
+    return JNI_OK;
+}
+
+/**
+ * Scanner for the intern()'ed String table.
+ */
+static jint JEM_GCInternScanner(JNIEnv *env, JEMCC_Object *string,
+                                void *userData) {
+    JEM_GCMarkObject((JEM_GCMarkStack *) userData, string);
+
+    return JNI_OK;
+}
+
+/**
+ * Scan the references held by the given object.  Arrays of objects are
+ * scanned element by element, otherwise the reference fields are located
+ * from the packed field layout of the class and its superclasses.  The
+ * VM data of the Throwable classes and the native data of classes with a
+ * scan hook (StringBuffer) carry references as well, and ClassLoader
+ * instances hold the namespace of their classes.
+ */
+static void JEM_GCScanObject(JEM_GCMarkStack *stack, JEMCC_Object *obj) {
+    JEM_GCControl *ctrl = stack->control;
+    JEMCC_Class *objClass = obj->classReference, *classInst;
+    JEM_ClassData *classData;
+    JEM_ClassFieldData *field;
+    JEMCC_ThrowableData *throwData;
+    JEMCC_Object **elements;
+    jubyte *fieldBase;
+    juint typeDepth;
+    jint i;
+
+    if (objClass == NULL) return;
+    classData = objClass->classData;
+
+    /* Only object arrays (or nested arrays) contain references */
+    if ((classData->accessFlags & ACC_ARRAY) != 0) {
+        typeDepth = ((JEMCC_ArrayClass *) objClass)->typeDepthInfo;
+        if (((typeDepth & PRIMITIVE_TYPE_MASK) != 0) &&
+            ((typeDepth & ARRAY_DEPTH_MASK) == 1)) return;
+        elements = (JEMCC_Object **) ((JEMCC_ArrayObject *) obj)->arrayData;
+        for (i = 0; i < ((JEMCC_ArrayObject *) obj)->arrayLength; i++) {
+            JEM_GCMarkObject(stack, elements[i]);
+        }
+        return;
+    }
+
+    /* Instance reference fields of the full class hierarchy */
+    fieldBase = (jubyte *) &(((JEMCC_ObjectExt *) obj)->objectData);
+    classInst = objClass;
+    while (classInst != NULL) {
+        for (i = 0; i < classInst->classData->localFieldCount; i++) {
+            field = &(classInst->classData->localFields[i]);
+            if (((field->accessFlags & ACC_STATIC) != 0) ||
+                (!GC_REFERENCE_FIELD(field))) continue;
+            JEM_GCMarkObject(stack, 
+                    *((JEMCC_Object **) (fieldBase + field->fieldOffset)));
+        }
+        if (classInst->classData->assignList == NULL) break;
+        classInst = classInst->classData->assignList[0];
+    }
+
+    /* References held in the VM data of the core classes */
+    if ((classData->accessFlags & ACC_THROWABLE) != 0) {
+        throwData = (JEMCC_ThrowableData *) fieldBase;
+        JEM_GCMarkObject(stack, throwData->message);
+        JEM_GCMarkObject(stack, throwData->causeThrowable);
+    } else if (classData->gcScanFn != NULL) {
+        (*(classData->gcScanFn))(obj, JEM_GCMarkReference, stack);
+    }
+
+    /* Classes are reachable through their loader (and its namespace) */
+    JEM_GCMarkObject(stack, classData->classLoader);
+    if (objClass != stack->lastClass) {
+        stack->lastClass = objClass;
+        stack->lastIsLoader = JNI_FALSE;
+        classInst = objClass;
+        while (classInst != NULL) {
+            if (classInst == ctrl->loaderClass) {
+                stack->lastIsLoader = JNI_TRUE;
+                break;
+            }
+            if (classInst->classData->assignList == NULL) break;
+            classInst = classInst->classData->assignList[0];
+        }
+    }
+    if (stack->lastIsLoader != JNI_FALSE) {
+        JEMCC_HashScan(NULL, (JEMCC_HashTable *) fieldBase, 
+                       JEM_GCClassScanner, stack);
+    }
+}
+
+/**
+ * Scan the roots of the given environment.  The frame stack (the local
+ * variables and operand stacks of all frames) is scanned conservatively,
+ * the local object records of the environment are themselves roots and
+ * are scanned precisely, as are the objects pinned by native code.
+ */
+static void JEM_GCScanEnvironment(JEM_GCMarkStack *stack, JEM_JNIEnv *env) {
+    JEM_VMFrameExt *topFrame = env->topFrame;
+    jubyte *stackEnd;
+    void **entry, *record;
+    juint i;
+
+    JEM_GCMarkObject(stack, env->pendingException);
+    JEM_GCMarkConservative(stack, (void *) env->nativeReturnValue.objVal);
+    for (i = 0; i < env->pinnedCount; i++) {
+        JEM_GCMarkObject(stack, env->pinnedObjects[i]);
+    }
+
+    if ((topFrame != NULL) && (env->frameStackBlock != NULL)) {
+        stackEnd = ((jubyte *) topFrame) + sizeof(JEM_VMFrameExt);
+        if ((topFrame->frameVars.operandStackTop != NULL) &&
+            (((jubyte *) topFrame->frameVars.operandStackTop) > stackEnd)) {
+            stackEnd = (jubyte *) topFrame->frameVars.operandStackTop;
+        }
+        entry = (void **) env->frameStackBlock;
+        while ((jubyte *) (entry + 1) <= stackEnd) {
+            JEM_GCMarkConservative(stack, *(entry++));
+        }
+    }
+
+    record = env->firstAllocObjectRecord;
+    while (record != NULL) {
+        JEM_GCScanObject(stack, (JEMCC_Object *) (record + sizeof(void *)));
+        record = RECORD_NEXT(record);
+    }
+}
+
+/**
+ * Push all of the collection roots onto the given mark stack.
+ * Note: JNI global references are not yet implemented (NewGlobalRef).
+ */
+static void JEM_GCMarkRoots(JEM_JNIEnv *env, JEM_GCMarkStack *stack) {
+    JEM_JavaVM *jvm = env->parentVM;
+    JEM_JNIEnv *currentEnv;
+    int i;
+
+    /* The collecting environment may not be in the VM list (testing) */
+    JEM_GCScanEnvironment(stack, env);
+    currentEnv = jvm->envList;
+    while (currentEnv != NULL) {
+        if (currentEnv != env) JEM_GCScanEnvironment(stack, currentEnv);
+        currentEnv = currentEnv->nextEnv;
+    }
+
+    /* Static class data, interned strings and the system class loader */
+    JEMCC_HashScan(NULL, &(jvm->jemccClassPackageTable),
+                   JEM_GCClassScanner, stack);
+    for (i = 0; i < JEMCC_VM_CLASS_TBL_SIZE; i++) {
+        if (jvm->coreClassTbl[i] != NULL) {
+            JEM_GCScanStatics(stack, jvm->coreClassTbl[i]);
+        }
+    }
+    JEM_InternTableScan(NULL, &(jvm->internStringTable),
+                        JEM_GCInternScanner, stack);
+    JEM_GCMarkObject(stack, jvm->systemClassLoader);
+}
+
+/**
+ * Marking loop for a collector worker, scanning objects until marking is
+ * complete across all of the workers.
+ */
+static void JEM_GCMarkLoop(JEM_GCControl *ctrl, JEM_GCMarkStack *stack) {
+    JEMCC_Object *obj;
+
+    do {
+        while ((obj = JEM_GCPop(stack)) != NULL) {
+            JEM_GCScanObject(stack, obj);
+        }
+    } while (JEM_GCAcquireWork(ctrl, stack) != JNI_FALSE);
+}
+
+/**
+ * Thread start function for the collector worker threads.  Each worker
+ * claims a mark stack and then participates in the marking phase of each
+ * collection until the VM heap is released.
+ */
+static void *JEM_GCWorker(JNIEnv *env, void *userArg) {
+    JEM_GCControl *ctrl = (JEM_GCControl *) userArg;
+    JEM_GCMarkStack *stack;
+    juint cycle;
+
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    stack = &(ctrl->stacks[++(ctrl->readyCount)]);
+    stack->workerEnv = (JEM_JNIEnv *) env;
+    cycle = ctrl->cycle;
+    (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+
+    while (ctrl->shutdown == JNI_FALSE) {
+        if (ctrl->cycle == cycle) {
+            (void) JEMCC_SysMonitorWait(ctrl->monitor);
+            continue;
+        }
+        cycle = ctrl->cycle;
+
+        /* Workers arriving after the startup period do not participate */
+        if ((juint) (stack - ctrl->stacks) >= ctrl->workerCount) continue;
+
+        (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+        JEM_GCMarkLoop(ctrl, stack);
+        JEMCC_EnterSysMonitor(ctrl->monitor);
+        ctrl->finishedCount++;
+        (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+    }
+
+    ctrl->exitCount++;
+    (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+    return NULL;
+}
+
+/**
+ * Release the mark stacks and monitors of the collector control structure
+ * (the worker threads must have exited).
+ */
+static void JEM_GCDestroyControl(JEM_GCControl *ctrl) {
+    juint i;
+
+    for (i = 0; i < ctrl->maxWorkers; i++) {
+        if (ctrl->stacks[i].entries != NULL) {
+            JEMCC_Free(ctrl->stacks[i].entries);
+        }
+        if (ctrl->stacks[i].monitor != NULL) {
+            JEMCC_DestroySysMonitor(ctrl->stacks[i].monitor);
+        }
+    }
+    if (ctrl->blocks != NULL) JEMCC_Free(ctrl->blocks);
+    JEMCC_DestroySysMonitor(ctrl->monitor);
+    JEMCC_Free(ctrl->stacks);
+    JEMCC_Free(ctrl);
+}
+
+/**
+ * Construct the collector control structure and mark stacks for the VM
+ * and start the worker threads (the collecting thread is always worker
+ * zero).  If a thread cannot be started, the collector simply operates
+ * with fewer workers.
+ */
+static jint JEM_GCInitialize(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_GCControl *ctrl;
+    JEM_GCMarkStack *stack;
+    juint i, waitCount;
+
+    ctrl = (JEM_GCControl *) JEMCC_Malloc(env, sizeof(JEM_GCControl));
+    if (ctrl == NULL) return JNI_ENOMEM;
+    ctrl->jvm = jvm;
+    ctrl->maxWorkers = (jvm->gcWorkerCount > 0) ? jvm->gcWorkerCount :
+                                                  GC_DEFAULT_WORKER_COUNT;
+    ctrl->stacks = (JEM_GCMarkStack *) JEMCC_Malloc(env,
+                                 ctrl->maxWorkers * sizeof(JEM_GCMarkStack));
+    ctrl->monitor = JEMCC_CreateSysMonitor(env);
+    if ((ctrl->stacks == NULL) || (ctrl->monitor == NULL)) {
+        if (ctrl->monitor != NULL) JEMCC_DestroySysMonitor(ctrl->monitor);
+        JEMCC_Free(ctrl->stacks);
+        JEMCC_Free(ctrl);
+        return JNI_ENOMEM;
+    }
+    for (i = 0; i < ctrl->maxWorkers; i++) {
+        stack = &(ctrl->stacks[i]);
+        stack->control = ctrl;
+        stack->capacity = GC_MARK_STACK_SIZE;
+        stack->entries = (JEMCC_Object **) JEMCC_Malloc(env,
+                                 stack->capacity * sizeof(JEMCC_Object *));
+        stack->monitor = JEMCC_CreateSysMonitor(env);
+        if ((stack->entries == NULL) || (stack->monitor == NULL)) {
+            /* Tear down the partial worker set */
+            ctrl->maxWorkers = i + 1;
+            JEM_GCDestroyControl(ctrl);
+            return JNI_ENOMEM;
+        }
+    }
+    ctrl->stacks[0].workerEnv = jenv;
+    ctrl->workerCount = 1;
+    ctrl->classClass = VM_CLASS(JEMCC_Class_Class);
+    ctrl->loaderClass = VM_CLASS(JEMCC_Class_ClassLoader);
+
+    /* Start the additional marking threads and wait (briefly) for them */
+    for (i = 1; i < ctrl->maxWorkers; i++) {
+        if (JEMCC_CreateThread(env, JEM_GCWorker, ctrl, 5) == 0) {
+            jenv->pendingException = NULL;
+            break;
+        }
+    }
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    waitCount = 0;
+    while ((ctrl->readyCount < i - 1) && (waitCount++ < 100)) {
+        (void) JEMCC_SysMonitorMilliWait(ctrl->monitor, 10);
+    }
+    ctrl->workerCount = ctrl->readyCount + 1;
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+    jvm->gcControl = ctrl;
+
+    return JNI_OK;
+}
+
+/**
+ * Determine if the given environment belongs to one of the collector
+ * worker threads (which are never mutators).
+ */
+static jboolean JEM_GCIsWorkerEnv(JEM_GCControl *ctrl, JEM_JNIEnv *env) {
+    jboolean retVal = JNI_FALSE;
+    juint i;
+
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    for (i = 1; i <= ctrl->readyCount; i++) {
+        if (ctrl->stacks[i].workerEnv == env) retVal = JNI_TRUE;
+    }
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+    return retVal;
+}
+
+/**
+ * Append an allocation block range to the collection block table.
+ */
+static jint JEM_GCAddBlock(JEM_GCControl *ctrl, void *block, jubyte *end,
+                           jboolean large) {
+    JEM_GCBlockRange *blocks;
+
+    if (ctrl->blockCount >= ctrl->blockCapacity) {
+        blocks = (JEM_GCBlockRange *) JEMCC_Malloc(NULL,
+                    (2 * ctrl->blockCapacity + 64) * sizeof(JEM_GCBlockRange));
+        if (blocks == NULL) return JNI_ENOMEM;
+        if (ctrl->blocks != NULL) {
+            (void) memcpy(blocks, ctrl->blocks, 
+                          ctrl->blockCount * sizeof(JEM_GCBlockRange));
+            JEMCC_Free(ctrl->blocks);
+        }
+        ctrl->blocks = blocks;
+        ctrl->blockCapacity = 2 * ctrl->blockCapacity + 64;
+    }
+    ctrl->blocks[ctrl->blockCount].start = (jubyte *) block;
+    ctrl->blocks[ctrl->blockCount].end = end;
+    ctrl->blocks[ctrl->blockCount].large = large;
+    ctrl->blockCount++;
+
+    return JNI_OK;
+}
+
+/* Ordering function for the block table sort */
+static int JEM_GCBlockCompare(const void *a, const void *b) {
+    jubyte *startA = ((JEM_GCBlockRange *) a)->start;
+    jubyte *startB = ((JEM_GCBlockRange *) b)->start;
+
+    if (startA < startB) return -1;
+    return (startA > startB) ? 1 : 0;
+}
+
+/**
+ * Build the sorted table of the allocation blocks which may contain heap
+ * records, for the validation of conservative references.  Local large
+ * object blocks are excluded, as they only contain local records.
+ */
+static jint JEM_GCBuildBlockTable(JEM_GCControl *ctrl, JEM_JNIEnv *env) {
+    JEM_JavaVM *jvm = env->parentVM;
+    JEM_JNIEnv *currentEnv = env;
+    jubyte *record;
+    void *block;
+
+    ctrl->blockCount = 0;
+    while (currentEnv != NULL) {
+        block = currentEnv->allocBlockList;
+        while (block != NULL) {
+            if (JEM_GCAddBlock(ctrl, block, ((jubyte *) block) +
+                               ALLOC_BLOCK_SIZE, JNI_FALSE) != JNI_OK) {
+                return JNI_ENOMEM;
+            }
+            block = BLOCK_NEXT(block);
+        }
+        currentEnv = (currentEnv == env) ? jvm->envList : 
+                                           currentEnv->nextEnv;
+        if (currentEnv == env) currentEnv = currentEnv->nextEnv;
+    }
+    block = jvm->heapLargeList;
+    while (block != NULL) {
+        record = ((jubyte *) block) + ALLOC_BLOCK_HEADER_SIZE;
+        if (JEM_GCAddBlock(ctrl, block, record + RECORD_LENGTH(record +
+                                 ALLOC_RECORD_HEADER_SIZE - sizeof(void *)),
+                           JNI_TRUE) != JNI_OK) {
+            return JNI_ENOMEM;
+        }
+        block = BLOCK_NEXT(block);
+    }
+    qsort(ctrl->blocks, ctrl->blockCount, sizeof(JEM_GCBlockRange),
+          JEM_GCBlockCompare);
+
+    return JNI_OK;
+}
+
+/**
+ * Sweep records from the list of heap records pending the (lazy) sweep
+ * of the last collection.  Marked records are returned to the heap list,
+ * the native data of unmarked records is released, after which the small
+ * records are reclaimed to the free lists of the sweeping environment and
+ * dedicated large object blocks are released.
+ *
+ * Note: there is no finalization (the native data is released through the
+ *       object management method of the class, if defined).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     quantum - the maximum number of records to sweep (zero for all)
+ */
+static void JEM_SweepHeapRecords(JNIEnv *env, juint quantum) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    void *record, *block;
+    juint linkPtr, count = 0;
+
+    JEMCC_EnterSysMonitor(jvm->monitor);
+    while ((jvm->heapSweepRecords != NULL) &&
+           ((quantum == 0) || (count++ < quantum))) {
+        record = jvm->heapSweepRecords;
+        linkPtr = *((juint *) record);
+        jvm->heapSweepRecords = RECORD_NEXT(record);
+        jvm->heapSweepCount--;
+
+        if ((RECORD_SIZE(record) & RECORD_MARK_BIT) != 0) {
+            RECORD_SIZE(record) &= ~RECORD_MARK_BIT;
+            *((juint *) record) = (linkPtr & RECORD_FLAG_MASK) |
+                                         ((juint) jvm->heapObjectRecords);
+            jvm->heapObjectRecords = record;
+            jvm->heapObjectCount++;
+            continue;
+        }
+
+        JEM_ReleaseNativeData(env, (JEMCC_Object *) (record + sizeof(void *)),
+                              record);
+        if ((linkPtr & LARGE_RECORD_BIT) != 0) {
+            block = RECORD_BASE(record) - ALLOC_BLOCK_HEADER_SIZE;
+            JEM_UnlinkLargeBlock(&(jvm->heapLargeList), block);
+            JEMCC_Free(block);
+        } else {
+            JEM_ReclaimRecord(env, record);
+        }
+    }
+    (void) JEMCC_ExitSysMonitor(jvm->monitor);
+}
+
+/**
+ * Safepoint poll of the bytecode interpreter, stopping the current thread
+ * while a safepoint has been requested by a collection (see jvmenv.h).
+ */
+void JEM_GCSafepoint(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_JavaVM *jvm = jenv->parentVM;
+
+    JEMCC_EnterSysMonitor(jvm->safepointMonitor);
+    if (jvm->gcSafepoint != JEM_SAFEPOINT_NONE) {
+        jenv->gcState = JEM_ENV_STOPPED;
+        (void) JEMCC_SysMonitorNotifyAll(jvm->safepointMonitor);
+        while (jvm->gcSafepoint != JEM_SAFEPOINT_NONE) {
+            (void) JEMCC_SysMonitorWait(jvm->safepointMonitor);
+        }
+        jenv->gcState = JEM_ENV_RUNNING;
+    }
+    (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+}
+
+/**
+ * Mark the current thread as blocked outside of the interpreter, where it
+ * is safe for a collection (see jvmenv.h).
+ */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_JavaVM *jvm = jenv->parentVM;
+
+    JEMCC_EnterSysMonitor(jvm->safepointMonitor);
+    jenv->gcState = JEM_ENV_SAFE;
+    if (jvm->gcSafepoint == JEM_SAFEPOINT_REQUESTED) {
+        (void) JEMCC_SysMonitorNotifyAll(jvm->safepointMonitor);
+    }
+    (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+}
+
+/**
+ * Return the current thread from a safe region, waiting for the completion
+ * of any collection which has stopped the other threads.  A pending request
+ * does not block, the thread will stop at its next safepoint poll.
+ */
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_JavaVM *jvm = jenv->parentVM;
+
+    JEMCC_EnterSysMonitor(jvm->safepointMonitor);
+    while (jvm->gcSafepoint == JEM_SAFEPOINT_STOPPED) {
+        (void) JEMCC_SysMonitorWait(jvm->safepointMonitor);
+    }
+    jenv->gcState = JEM_ENV_RUNNING;
+    (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+}
+
+/**
+ * Return the current thread from the safe region of a native method callout
+ * for an operation on the heap, the collection roots or the frame stack
+ * (made through the JNI interfaces), waiting for the completion of any
+ * collection in progress.
+ *
+ * Returns:
+ *     JNI_TRUE if the thread was in a safe region, which must be re-entered
+ *     (JEM_GCEnterSafeRegion) once the operation is complete.
+ */
+jboolean JEM_GCResumeFromSafeRegion(JNIEnv *env) {
+    if (((JEM_JNIEnv *) env)->gcState != JEM_ENV_SAFE) return JNI_FALSE;
+    JEM_GCLeaveSafeRegion(env);
+
+    return JNI_TRUE;
+}
+
+/**
+ * Bring the other mutator environments to a safepoint for a collection.
+ * Running threads stop at their next safepoint poll, threads blocked in a
+ * safe region are left as they are (but cannot leave it).  Once all have
+ * stopped, this returns holding the VM monitor (which also blocks the
+ * attachment of new environments).  If a thread fails to reach a safepoint
+ * in time (e.g. a long running native method), the request is withdrawn.
+ *
+ * Returns:
+ *     JNI_TRUE if the other threads are stopped, JNI_FALSE if the
+ *     safepoint request timed out.
+ */
+static jboolean JEM_GCStopWorld(JEM_JNIEnv *jenv, JEM_GCControl *ctrl) {
+    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_JNIEnv *currentEnv;
+    juint waited = 0;
+
+    JEMCC_EnterSysMonitor(jvm->safepointMonitor);
+    jvm->gcSafepoint = JEM_SAFEPOINT_REQUESTED;
+    (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+
+    for (;;) {
+        JEMCC_EnterSysMonitor(jvm->monitor);
+        JEMCC_EnterSysMonitor(jvm->safepointMonitor);
+        currentEnv = jvm->envList;
+        while (currentEnv != NULL) {
+            if ((currentEnv != jenv) &&
+                (currentEnv->gcState == JEM_ENV_RUNNING) &&
+                (JEM_GCIsWorkerEnv(ctrl, currentEnv) == JNI_FALSE)) break;
+            currentEnv = currentEnv->nextEnv;
+        }
+        if (currentEnv == NULL) {
+            jvm->gcSafepoint = JEM_SAFEPOINT_STOPPED;
+            (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+            return JNI_TRUE;
+        }
+        (void) JEMCC_ExitSysMonitor(jvm->monitor);
+
+        if (waited >= GC_SAFEPOINT_TIMEOUT) {
+            jvm->gcSafepoint = JEM_SAFEPOINT_NONE;
+            (void) JEMCC_SysMonitorNotifyAll(jvm->safepointMonitor);
+            (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+            return JNI_FALSE;
+        }
+        (void) JEMCC_SysMonitorMilliWait(jvm->safepointMonitor,
+                                         GC_SAFEPOINT_WAIT);
+        (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+        waited += GC_SAFEPOINT_WAIT;
+    }
+}
+
+/**
+ * Release the threads stopped by JEM_GCStopWorld.
+ */
+static void JEM_GCStartWorld(JEM_JavaVM *jvm) {
+    JEMCC_EnterSysMonitor(jvm->safepointMonitor);
+    jvm->gcSafepoint = JEM_SAFEPOINT_NONE;
+    (void) JEMCC_SysMonitorNotifyAll(jvm->safepointMonitor);
+    (void) JEMCC_ExitSysMonitor(jvm->safepointMonitor);
+}
+
+/**
+ * Perform a full collection of the global object heap.  The other mutator
+ * threads are first brought to a safepoint (the collection is deferred if
+ * they fail to reach one).  The roots (the frame stacks and local objects
+ * of the environments, class static fields, interned strings and the system
+ * class loader) are then marked by the calling thread, after which the heap
+ * is traced by the calling thread and the collector worker threads in
+ * parallel.  The unmarked records are swept lazily, by subsequent
+ * allocations, once the mutator threads have been released.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *
+ * Returns:
+ *     JNI_OK if the collection was performed, JNI_ERR if it was deferred
+ *     (another collection is active or a thread did not reach a safepoint)
+ *     or JNI_ENOMEM if the collector resources could not be allocated.
+ */
+jint JEM_CollectHeap(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env, *currentEnv;
+    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_GCControl *ctrl;
+    JEM_GCMarkStack *stack;
+    void *record;
+    struct timeval start, end;
+    juint i, liveCount, liveBytes, totalCount, size, pauseMicros;
+    jboolean overflow, rescan = JNI_FALSE;
+
+    (void) gettimeofday(&start, NULL);
+
+    /* Only one collection at a time */
+    JEMCC_EnterSysMonitor(jvm->monitor);
+    if (jvm->gcActive != JNI_FALSE) {
+        (void) JEMCC_ExitSysMonitor(jvm->monitor);
+        return JNI_ERR;
+    }
+    jvm->gcActive = JNI_TRUE;
+    (void) JEMCC_ExitSysMonitor(jvm->monitor);
+
+    /* Worker threads attach to the VM, can't hold the VM monitor */
+    if ((jvm->gcControl == NULL) && (JEM_GCInitialize(env) != JNI_OK)) {
+        JEMCC_EnterSysMonitor(jvm->monitor);
+        jvm->gcActive = JNI_FALSE;
+        (void) JEMCC_ExitSysMonitor(jvm->monitor);
+        return JNI_ENOMEM;
+    }
+    ctrl = jvm->gcControl;
+
+    /* Stop the other mutator threads (defer if they cannot be stopped) */
+    if (JEM_GCStopWorld(jenv, ctrl) == JNI_FALSE) {
+        JEMCC_EnterSysMonitor(jvm->monitor);
+        jvm->gcThreshold += jvm->gcThreshold / 4;
+        jvm->gcActive = JNI_FALSE;
+        (void) JEMCC_ExitSysMonitor(jvm->monitor);
+        return JNI_ERR;
+    }
+
+    /* Complete any outstanding sweep, so that all marks are clear */
+    JEM_SweepHeapRecords(env, 0);
+    totalCount = jvm->heapObjectCount;
+    if (JEM_GCBuildBlockTable(ctrl, jenv) != JNI_OK) {
+        JEM_GCStartWorld(jvm);
+        jvm->gcActive = JNI_FALSE;
+        (void) JEMCC_ExitSysMonitor(jvm->monitor);
+        return JNI_ENOMEM;
+    }
+
+    for (i = 0; i < ctrl->workerCount; i++) {
+        ctrl->stacks[i].markCount = ctrl->stacks[i].markBytes = 0;
+    }
+    do {
+        /* Mark the roots (and on overflow, rescan the marked objects) */
+        for (i = 0; i < ctrl->workerCount; i++) {
+            stack = &(ctrl->stacks[i]);
+            stack->count = stack->sharedCount = 0;
+            stack->overflow = JNI_FALSE;
+            stack->lastClass = NULL;
+        }
+        stack = &(ctrl->stacks[0]);
+        JEM_GCMarkRoots(jenv, stack);
+        if (rescan != JNI_FALSE) {
+            record = jvm->heapObjectRecords;
+            while (record != NULL) {
+                if ((RECORD_SIZE(record) & RECORD_MARK_BIT) != 0) {
+                    JEM_GCScanObject(stack, (JEMCC_Object *) 
+                                             (record + sizeof(void *)));
+                }
+                record = RECORD_NEXT(record);
+            }
+        }
+
+        /* Release the workers and trace the heap until all are idle */
+        JEMCC_EnterSysMonitor(ctrl->monitor);
+        ctrl->idleCount = ctrl->finishedCount = 0;
+        ctrl->markComplete = JNI_FALSE;
+        ctrl->cycle++;
+        (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+        (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+        JEM_GCMarkLoop(ctrl, stack);
+
+        JEMCC_EnterSysMonitor(ctrl->monitor);
+        while (ctrl->finishedCount < ctrl->workerCount - 1) {
+            (void) JEMCC_SysMonitorWait(ctrl->monitor);
+        }
+        (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+        overflow = JNI_FALSE;
+        for (i = 0; i < ctrl->workerCount; i++) {
+            if (ctrl->stacks[i].overflow != JNI_FALSE) overflow = JNI_TRUE;
+        }
+        rescan = JNI_TRUE;
+    } while (overflow != JNI_FALSE);
+
+    liveCount = liveBytes = 0;
+    for (i = 0; i < ctrl->workerCount; i++) {
+        liveCount += ctrl->stacks[i].markCount;
+        liveBytes += ctrl->stacks[i].markBytes;
+    }
+
+    /* Non-local records not yet promoted are not part of the heap */
+    currentEnv = jenv;
+    while (currentEnv != NULL) {
+        record = currentEnv->firstAllocObjectRecord;
+        while (record != NULL) {
+            size = RECORD_SIZE(record);
+            if ((size & RECORD_MARK_BIT) != 0) {
+                RECORD_SIZE(record) = size & ~RECORD_MARK_BIT;
+                liveCount--;
+                liveBytes -= size & RECORD_SIZE_MASK;
+            }
+            record = RECORD_NEXT(record);
+        }
+        currentEnv = (currentEnv == jenv) ? jvm->envList : 
+                                            currentEnv->nextEnv;
+        if (currentEnv == jenv) currentEnv = currentEnv->nextEnv;
+    }
+
+    /* Hand the heap over to the lazy sweep, reset the threshold */
+    jvm->heapSweepRecords = jvm->heapObjectRecords;
+    jvm->heapSweepCount = jvm->heapObjectCount;
+    jvm->heapObjectRecords = NULL;
+    jvm->heapObjectCount = 0;
+    jvm->heapObjectBytes = liveBytes;
+    jvm->gcThreshold = GC_MIN_THRESHOLD(jvm);
+    if (jvm->gcThreshold < 2 * liveBytes) jvm->gcThreshold = 2 * liveBytes;
+
+    /* Record the pause statistics */
+    (void) gettimeofday(&end, NULL);
+    pauseMicros = (juint) ((end.tv_sec - start.tv_sec) * 1000000 +
+                                          (end.tv_usec - start.tv_usec));
+    jvm->gcCount++;
+    jvm->gcLastPauseMicros = pauseMicros;
+    if (pauseMicros > jvm->gcMaxPauseMicros) {
+        jvm->gcMaxPauseMicros = pauseMicros;
+    }
+    jvm->gcTotalPauseMicros += pauseMicros;
+    if (VERBOSE_GC(jvm)) {
+        (void) fprintf(stderr, 
+                "[GC #%u: %u of %u objects live, %u KB, %u workers, "
+                "%u.%03u ms pause]\n", jvm->gcCount, liveCount, totalCount,
+                liveBytes / 1024, ctrl->workerCount, pauseMicros / 1000,
+                pauseMicros % 1000);
+    }
+
+    JEM_GCStartWorld(jvm);
+    jvm->gcActive = JNI_FALSE;
+    (void) JEMCC_ExitSysMonitor(jvm->monitor);
+
+    return JNI_OK;
+}
+
+/**
+ * Release the garbage collector resources of the virtual machine, stopping
+ * the collector worker threads and releasing the dedicated large object
+ * blocks which were promoted to the heap.  Only to be used when the
+ * virtual machine is destroyed (all heap objects are invalidated).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+void JEM_ReleaseHeap(JNIEnv *env) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    JEM_GCControl *ctrl = jvm->gcControl;
+    void *block, *nextBlock;
+
+    if (ctrl != NULL) {
+        JEMCC_EnterSysMonitor(ctrl->monitor);
+        ctrl->shutdown = JNI_TRUE;
+        (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+        while (ctrl->exitCount < ctrl->readyCount) {
+            (void) JEMCC_SysMonitorWait(ctrl->monitor);
+        }
+        (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+        JEM_GCDestroyControl(ctrl);
+        jvm->gcControl = NULL;
+    }
+
+    block = jvm->heapLargeList;
+    while (block != NULL) {
+        nextBlock = BLOCK_NEXT(block);
+        JEMCC_Free(block);
+        block = nextBlock;
+    }
+    jvm->heapLargeList = NULL;
+    jvm->heapObjectRecords = jvm->heapSweepRecords = NULL;
+    jvm->heapObjectCount = jvm->heapSweepCount = jvm->heapObjectBytes = 0;
 }
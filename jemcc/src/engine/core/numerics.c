@@ -30,6 +30,71 @@ static char digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
                          'k', 'l', 'm' ,'n', 'o', 'p', 'q', 'r', 's', 't',
                          'u', 'v', 'w', 'x', 'y', 'z' };
 
+/* Decimal digit pairs, for radix 10 conversion two digits at a time */
+static char digitPairs[] = "00010203040506070809"
+                           "10111213141516171819"
+                           "20212223242526272829"
+                           "30313233343536373839"
+                           "40414243444546474849"
+                           "50515253545556575859"
+                           "60616263646566676869"
+                           "70717273747576777879"
+                           "80818283848586878889"
+                           "90919293949596979899";
+
+/* Determine the number of decimal digits needed for the unsigned value */
+static int decimalLength(juint val) {
+    if (val < 100000) {
+        if (val < 100) return (val < 10) ? 1 : 2;
+        if (val < 10000) return (val < 1000) ? 3 : 4;
+        return 5;
+    }
+    if (val < 10000000) return (val < 1000000) ? 6 : 7;
+    if (val < 1000000000) return (val < 100000000) ? 8 : 9;
+    return 10;
+}
+
+/**
+ * Write exactly len decimal digits of the value (zero filled on the left)
+ * backwards from the end of the digit area, two digits at a time.
+ */
+static void writeDecimal(juint val, char *end, int len) {
+    char *pair;
+
+    while (len >= 2) {
+        pair = digitPairs + (val % 100) * 2;
+        val = val / 100;
+        *(--end) = pair[1];
+        *(--end) = pair[0];
+        len -= 2;
+    }
+    if (len > 0) *(--end) = (char) ('0' + val);
+}
+
+/**
+ * Write the decimal digits of a non-negative long value, in blocks of nine
+ * digits to limit the number of (expensive) long divisions.  Returns the
+ * end of the written digits (not terminated).
+ */
+static char *writeLongDecimal(jlong val, char *buff) {
+    juint blocks[2];
+    int len, count = 0;
+
+    while (val >= 1000000000) {
+        blocks[count++] = (juint) (val % 1000000000);
+        val = val / 1000000000;
+    }
+    len = decimalLength((juint) val);
+    writeDecimal((juint) val, buff + len, len);
+    buff += len;
+    while (count > 0) {
+        writeDecimal(blocks[--count], buff + 9, 9);
+        buff += 9;
+    }
+
+    return buff;
+}
+
 /**
  * Convert an integer value into a character representation (for textual
  * output, for example). Essentially the Integer.toString(val, radix) method.
@@ -42,6 +107,22 @@ static char digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
  */
 void JEMCC_IntegerToText(jint val, jint radix, char *buff) {
     char wrkBuff[33], *ptr = wrkBuff;
+    juint uval;
+    int len;
+
+    /* Decimal is by far the most common, write directly by digit pairs */
+    if (radix == 10) {
+        if (val < 0) {
+            *(buff++) = '-';
+            uval = ((juint) 0) - ((juint) val);
+        } else {
+            uval = (juint) val;
+        }
+        len = decimalLength(uval);
+        writeDecimal(uval, buff + len, len);
+        buff[len] = '\0';
+        return;
+    }
 
     /* Handle negative, watch out for that really minimal value */
     if (val < 0) {
@@ -83,6 +164,29 @@ void JEMCC_IntegerToText(jint val, jint radix, char *buff) {
  */
 void JEMCC_LongToText(jlong val, jint radix, char *buff) {
     char wrkBuff[66], *ptr = wrkBuff;
+    jlong high;
+    juint low;
+
+    /* Decimal is by far the most common, write directly by digit pairs */
+    if (radix == 10) {
+        if (val < 0) {
+            /* Peel the low block while negative (minimal value again) */
+            *(buff++) = '-';
+            high = val / 1000000000;
+            low = (juint) (high * 1000000000 - val);
+            if (high == 0) {
+                buff = writeLongDecimal((jlong) low, buff);
+            } else {
+                buff = writeLongDecimal(-high, buff);
+                writeDecimal(low, buff + 9, 9);
+                buff += 9;
+            }
+        } else {
+            buff = writeLongDecimal(val, buff);
+        }
+        *buff = '\0';
+        return;
+    }
 
     /* Handle negative, watch out for that really minimal value */
     if (val < 0) {
@@ -112,6 +216,990 @@ void JEMCC_LongToText(jlong val, jint radix, char *buff) {
     *buff = '\0';
 }
 
+/*
+ * The floating point conversions below are exact (correctly rounded in
+ * both directions) and never involve the C library formatting/parsing,
+ * which is both slow and sensitive to the process locale.  Text output uses
+ * the Schubfach algorithm (R. Giulietti, "The Schubfach way to render
+ * doubles"), which is also the basis of the Double.toString() method of
+ * current Java platforms, to select the shortest decimal which uniquely
+ * identifies the binary value.  Text input uses the same table of decimal
+ * powers for a bounded approximation of the value, only falling back to
+ * exact (big number) comparisons when that approximation straddles a
+ * rounding boundary.
+ *
+ * The configured JNI types (jnitypes.h) only define the signed jlong, whose
+ * underlying compiler type varies by platform (__int64 for the Windows
+ * build).  Rather than assume a matching unsigned 64-bit type, the multiple
+ * precision arithmetic is performed in 28-bit limbs, whose products and
+ * sums comfortably fit in the signed long type.
+ */
+#define LIMB_BITS 28
+#define LIMB_MASK 0x0FFFFFFF
+
+/* Range of the decimal powers available in the approximation table */
+#define POW10_MIN_K -324
+#define POW10_MAX_K 341
+
+/*
+ * Table of the 126-bit approximations g(k) = floor(10^-k * 2^-r) + 1, where
+ * the binary scale r = floorLog2Pow10(-k) - 125 places g(k) in the range
+ * 2^125 < g(k) <= 2^126.  Stored as five 28-bit limbs, most significant
+ * first, generated by exact rational arithmetic.  The upper range beyond
+ * that of the formatting (k > 292) is used by the parsing of long decimal
+ * mantissas close to the subnormal limit.
+ */
+static juint pow10Table[POW10_MAX_K - POW10_MIN_K + 1][5] = {
+    { 0x0002786, 0x76e4ad3, 0x8c6ea5b, 0x01e8b09, 0xaa0d1b5 }, /* -324 */
+    { 0x0003f3d, 0x8b077b8, 0xe0b1091, 0x9ca780f, 0x767b5ee }, /* -323 */
+    { 0x0003297, 0xa26c62d, 0x808da0e, 0x16ec672, 0xc52f7f2 }, /* -322 */
+    { 0x0002879, 0x4ebd1be, 0x00714d8, 0x1256b8f, 0x0425ff5 }, /* -321 */
+    { 0x0002061, 0x0bca7cb, 0x338dd79, 0xa84560c, 0x0351991 }, /* -320 */
+    { 0x00033ce, 0x7943fab, 0x85afbf5, 0xda089ac, 0xd21c281 }, /* -319 */
+    { 0x0002971, 0xfa9cc89, 0x37bfcc4, 0xae6d48a, 0x41b0201 }, /* -318 */
+    { 0x0002127, 0xfbb0a07, 0x5fcca36, 0xf1f106e, 0x9af34cd }, /* -317 */
+    { 0x000350c, 0xc5e7672, 0x32e1057, 0xe981a4a, 0x918547b }, /* -316 */
+    { 0x0002a70, 0x9e52b8e, 0x8f1a6ac, 0xbace1d5, 0x41376c9 }, /* -315 */
+    { 0x00021f3, 0xb1dbc72, 0x0c15223, 0xc8a4e44, 0x342c56e }, /* -314 */
+    { 0x0003652, 0xb62c71c, 0xe021d06, 0x0dd4a06, 0xb9e08b0 }, /* -313 */
+    { 0x0002b75, 0x5e89f4a, 0x4ce7d9e, 0x7176e6b, 0xc7e6d59 }, /* -312 */
+    { 0x00022c4, 0x4ba1908, 0x3d8647e, 0xc12bebc, 0x9febde1 }, /* -311 */
+    { 0x00037a0, 0x790280d, 0x2f3d3fe, 0x01dfdfa, 0x9979635 }, /* -310 */
+    { 0x0002c80, 0x60cecd7, 0x58fdccb, 0x34b3195, 0x47944f7 }, /* -309 */
+    { 0x0002399, 0xe70bd79, 0x13fe3d5, 0xc3c27aa, 0x9fa9d93 }, /* -308 */
+    { 0x00038f6, 0x3e7958e, 0x8663956, 0x0603f77, 0x65dc8ea }, /* -307 */
+    { 0x0002d91, 0xcb94472, 0x051c778, 0x04cff92, 0xb7e3a55 }, /* -306 */
+    { 0x0002474, 0xa2dd05b, 0x3749f93, 0x370cc75, 0x5fe9511 }, /* -305 */
+    { 0x0003a54, 0x37c8091, 0xf20ff51, 0xf1ae0bb, 0xcca881b }, /* -304 */
+    { 0x0002ea9, 0xc639a0e, 0x5b3ff74, 0xc158096, 0x3d539af }, /* -303 */
+    { 0x0002554, 0x9e9480b, 0x7c332c3, 0xcde0078, 0x310faf3 }, /* -302 */
+    { 0x0003bba, 0x9754012, 0x6051e06, 0x16333f3, 0x81b2b1e }, /* -301 */
+    { 0x0002fc8, 0x791000e, 0xb374b38, 0x11c298f, 0x9af55b1 }, /* -300 */
+    { 0x0002639, 0xfa7333e, 0xf5f6f60, 0x0e35472, 0xe25de28 }, /* -299 */
+    { 0x0003d29, 0x90b8531, 0x898b233, 0x49eed84, 0x9d6303f }, /* -298 */
+    { 0x00030ee, 0x0d60427, 0xa13c1c2, 0xa18be03, 0xb11c033 }, /* -297 */
+    { 0x0002724, 0xd780352, 0xe76349b, 0xb46fe69, 0x5a7ccf5 }, /* -296 */
+    { 0x0003ea1, 0x58cd21e, 0x3f0542c, 0x53e63db, 0xc3fae55 }, /* -295 */
+    { 0x000321a, 0xad70e7e, 0x98d1023, 0x7651caf, 0xcffbeaa }, /* -294 */
+    { 0x0002815, 0x578d865, 0x470d9b5, 0xf8416f3, 0x0cc9888 }, /* -293 */
+    { 0x0002011, 0x12d79ea, 0x9f3e15e, 0x603458f, 0x3d6e06d }, /* -292 */
+    { 0x000334e, 0x848c310, 0xfec9bca, 0x3386f4b, 0x957cd7b }, /* -291 */
+    { 0x000290b, 0x9d3cf40, 0xcbd496e, 0x8f9f2a2, 0xddfd796 }, /* -290 */
+    { 0x00020d6, 0x1763f67, 0x0976df2, 0x0c7f54f, 0x17fdfab }, /* -289 */
+    { 0x0003489, 0xbf06571, 0xa8be31c, 0xe0cbbb1, 0xbffcc45 }, /* -288 */
+    { 0x0002a07, 0xcc05127, 0xba31c17, 0x1a3c95a, 0xfffd69e }, /* -287 */
+    { 0x000219f, 0xd66a752, 0xfb5b012, 0x7b63aaf, 0x3331218 }, /* -286 */
+    { 0x00035cc, 0x8a43eeb, 0x2bc4cea, 0x5f05de5, 0x1eb5026 }, /* -285 */
+    { 0x0002b0a, 0x0836588, 0xefd0a55, 0x18d17ea, 0x7ef7352 }, /* -284 */
+    { 0x000226e, 0x6cf846d, 0x8ca6eaa, 0x7a41321, 0xff2c2a8 }, /* -283 */
+    { 0x0003717, 0x14c0715, 0xadd7ddd, 0x9068503, 0x31e043f }, /* -282 */
+    { 0x0002c12, 0x77005aa, 0xf1797e4, 0x7386a68, 0xf4b3699 }, /* -281 */
+    { 0x0002341, 0xf8cd155, 0x8dfacb6, 0xc2d21ed, 0x908f87b }, /* -280 */
+    { 0x0003869, 0x8e14eef, 0x4991457, 0x9e1cfe2, 0x80e5a5d }, /* -279 */
+    { 0x0002d21, 0x3e77259, 0x07a76ac, 0x7e7d982, 0x00b7b7e }, /* -278 */
+    { 0x000241a, 0x985f514, 0x061f889, 0xfecae01, 0x9a2c932 }, /* -277 */
+    { 0x00039c4, 0x26fee86, 0x7032743, 0x314499c, 0x29e0eb6 }, /* -276 */
+    { 0x0002e36, 0x8598b9e, 0xc0285cf, 0x5a9d47c, 0xee4d891 }, /* -275 */
+    { 0x00024f8, 0x6ae094b, 0xcced172, 0xaee4397, 0x250ad41 }, /* -274 */
+    { 0x0003b27, 0x1167546, 0x14ae8b7, 0x7e39f58, 0x3b44868 }, /* -273 */
+    { 0x0002f52, 0x7452a9e, 0x76f2092, 0xcb61913, 0x629d387 }, /* -272 */
+    { 0x00025db, 0x9042218, 0x5f28075, 0x6f8140f, 0x8217605 }, /* -271 */
+    { 0x0003c92, 0x8069cf3, 0xcb733ef, 0x18cece5, 0x9cf233c }, /* -270 */
+    { 0x0003075, 0x3387d8f, 0xd5f5cbf, 0x470bd84, 0x7d8e8fd }, /* -269 */
+    { 0x00026c4, 0x29397a6, 0x44c4a32, 0x9f3cad0, 0x64720ca }, /* -268 */
+    { 0x0003e06, 0xa85bf70, 0x6e076b7, 0x652de1a, 0x3a50143 }, /* -267 */
+    { 0x000319e, 0xed165f3, 0x8b3922c, 0x50f1814, 0xfb73436 }, /* -266 */
+    { 0x00027b2, 0x574518f, 0xa2941bd, 0x0d8e010, 0xc92902b }, /* -265 */
+    { 0x0003f83, 0xbed4f4c, 0x37535fb, 0x48e334e, 0x0ea8045 }, /* -264 */
+    { 0x00032cf, 0xcbdd909, 0xc5dc4c9, 0x071c2a4, 0xd88669d }, /* -263 */
+    { 0x00028a6, 0x3cb1407, 0xd17d0a0, 0xd27ceea, 0x46d1ee4 }, /* -262 */
+    { 0x0002084, 0xfd5a99f, 0xdaca6e7, 0x0eca588, 0x38a7f1d }, /* -261 */
+    { 0x0003407, 0xfbc4299, 0x5e10b0b, 0x4add5a6, 0xc10cb62 }, /* -260 */
+    { 0x000299f, 0xfc9cee1, 0x180d5a2, 0xa24aaeb, 0xcda3c4e }, /* -259 */
+    { 0x000214c, 0xca1724d, 0xacd77b5, 0x4ea2256, 0x3e1c9d8 }, /* -258 */
+    { 0x0003547, 0xa9bea15, 0xe158c55, 0x4a9d089, 0xfcfa95a }, /* -257 */
+    { 0x0002a9f, 0xbafee77, 0xe77a377, 0x6ee406e, 0x63fbaae }, /* -256 */
+    { 0x0002219, 0x626585f, 0xec61c5f, 0x8be99f1, 0xe996225 }, /* -255 */
+    { 0x000368f, 0x03d5a33, 0x13cfa32, 0x7975cb6, 0x4289d08 }, /* -254 */
+    { 0x0002ba5, 0x9caae8f, 0x430c828, 0x612b091, 0xced4a6d }, /* -253 */
+    { 0x00022ea, 0xe3bbed9, 0x0270686, 0xb4226db, 0x0bdd524 }, /* -252 */
+    { 0x00037de, 0x392caf4, 0xd0b3da4, 0x536a491, 0xac95506 }, /* -251 */
+    { 0x0002cb1, 0xc756f2a, 0x408fe1d, 0x0f883a7, 0xbd44405 }, /* -250 */
+    { 0x00023c1, 0x6c458ee, 0x9a0cb4a, 0x72d361f, 0xca9d004 }, /* -249 */
+    { 0x0003935, 0x7a08e4a, 0x9014543, 0xeaebcff, 0xaa94cd3 }, /* -248 */
+    { 0x0002dc4, 0x61a0b6e, 0xd9a9dcf, 0xef230cc, 0x88770a9 }, /* -247 */
+    { 0x000249d, 0x1ae6f8b, 0xe154b0c, 0xbf4f3d6, 0xd3926ee }, /* -246 */
+    { 0x0003a94, 0xf7d7f46, 0x35544e1, 0x3218624, 0x85b717c }, /* -245 */
+    { 0x0002edd, 0x931329e, 0x91103e7, 0x5b46b50, 0x6af8dfd }, /* -244 */
+    { 0x000257e, 0x0f4287e, 0xda73652, 0xaf6bc40, 0x5593e64 }, /* -243 */
+    { 0x0003bfc, 0xe5373fe, 0x2a523b7, 0x7f12d33, 0xbc1fd6d }, /* -242 */
+    { 0x0002ffd, 0x842c331, 0xbb74fc5, 0xff42429, 0x634cabd }, /* -241 */
+    { 0x0002664, 0x69bcf5a, 0xfc5d96b, 0x329b687, 0x82a3bcb }, /* -240 */
+    { 0x0003d6d, 0x75fb22b, 0x2d628ab, 0x842bda5, 0x9dd2c77 }, /* -239 */
+    { 0x0003124, 0x5e62822, 0x8ab53bc, 0x69bcaea, 0xe4a89f9 }, /* -238 */
+    { 0x0002750, 0x4b8201b, 0xa22a963, 0x87ca255, 0x83ba194 }, /* -237 */
+    { 0x0003ee6, 0xdf36692, 0x9d10f05, 0xa6103bc, 0x05f68ed }, /* -236 */
+    { 0x0003252, 0x4c2b875, 0x4a73f37, 0xb80cfc9, 0x9e5ed8a }, /* -235 */
+    { 0x0002841, 0xd689391, 0x085cc2c, 0x933d96e, 0x184be08 }, /* -234 */
+    { 0x0002034, 0xaba0fa7, 0x39e3cf0, 0x75cadf1, 0xad09807 }, /* -233 */
+    { 0x0003387, 0x790190b, 0x8fd2e4d, 0x8944982, 0xae759a4 }, /* -232 */
+    { 0x0002939, 0x2d9ada2, 0xd97583e, 0x076a135, 0x585e150 }, /* -231 */
+    { 0x00020fa, 0x8ae2482, 0x4791364, 0xd2bb42a, 0xad1810d }, /* -230 */
+    { 0x00034c4, 0x116a0d0, 0x7281f07, 0xb792044, 0x4826815 }, /* -229 */
+    { 0x0002a36, 0x7454d73, 0x8ece59f, 0xc60e69d, 0x0685344 }, /* -228 */
+    { 0x00021c5, 0x29dd78f, 0xa571e19, 0x6b3ebb0, 0xd20429d }, /* -227 */
+    { 0x0003608, 0x42fbf4c, 0x3be968f, 0x11fdf81, 0x5006a94 }, /* -226 */
+    { 0x0002b39, 0xcf2ff70, 0x2feded8, 0xdb31934, 0x4005543 }, /* -225 */
+    { 0x0002294, 0xa5bff8c, 0xf324be0, 0xaf5adc3, 0x666aa9c }, /* -224 */
+    { 0x0003754, 0x3c665ae, 0x51d4634, 0x4bc4938, 0xa3dddc7 }, /* -223 */
+    { 0x0002c43, 0x6385158, 0x4176b5d, 0x096a0fa, 0x1cb17d2 }, /* -222 */
+    { 0x0002369, 0x1c6a779, 0xcdf8917, 0x3abb3fb, 0x4a27975 }, /* -221 */
+    { 0x00038a8, 0x2d7725c, 0x7cc0e8b, 0x912b992, 0x103f588 }, /* -220 */
+    { 0x0002d53, 0x5792849, 0xfd67209, 0x40efadb, 0x4032ad3 }, /* -219 */
+    { 0x0002442, 0xac7536e, 0x6452807, 0x6726249, 0x00288a9 }, /* -218 */
+    { 0x0003a04, 0x4721f17, 0x06ea672, 0x3ea36db, 0x337410e }, /* -217 */
+    { 0x0002e69, 0xd2818df, 0x38bb85b, 0x654f8af, 0x5c5cda5 }, /* -216 */
+    { 0x0002521, 0x7534718, 0xfa2f9e2, 0xb772d59, 0x16b0aeb }, /* -215 */
+    { 0x0003b68, 0xbb871c1, 0x904c304, 0x58b7bc1, 0xbde77dd }, /* -214 */
+    { 0x0002f86, 0xfc6c167, 0xa6a359d, 0x13c6301, 0x64b9318 }, /* -213 */
+    { 0x0002605, 0x96bcdec, 0x854f7b0, 0xdc9e8cd, 0xea2dc13 }, /* -212 */
+    { 0x0003cd5, 0xbdfafe0, 0xd54bf81, 0x60fdae3, 0x1049351 }, /* -211 */
+    { 0x00030aa, 0xfe6264d, 0x776ff9a, 0xb3fe24f, 0x403a90e }, /* -210 */
+    { 0x00026ef, 0x31e850a, 0xc5f32e2, 0x29981d9, 0x002eda5 }, /* -209 */
+    { 0x0003e4b, 0x830d4de, 0x0985169, 0xdc2695b, 0x337e2a1 }, /* -208 */
+    { 0x00031d6, 0x02710b1, 0xa137454, 0xb01ede2, 0x8f9821b }, /* -207 */
+    { 0x00027de, 0x685a6f4, 0x80f9043, 0xc018b1b, 0xa6134e2 }, /* -206 */
+    { 0x0003fca, 0x4090b20, 0xce5b39f, 0x99c11c5, 0xd68549d }, /* -205 */
+    { 0x0003308, 0x33a6f4d, 0x71e294c, 0x7b00e37, 0xded107e }, /* -204 */
+    { 0x00028d3, 0x5c8590a, 0xc182109, 0xfc00b5f, 0xe574065 }, /* -203 */
+    { 0x00020a9, 0x16d1408, 0x9ace73b, 0x3000919, 0x845cd1d }, /* -202 */
+    { 0x0003441, 0xbe1b9a7, 0x5e171f8, 0x4ccdb5c, 0x06fae95 }, /* -201 */
+    { 0x00029ce, 0x31afaec, 0x4b45b2d, 0x0a3e2b0, 0x0595877 }, /* -200 */
+    { 0x0002171, 0xc159589, 0xd5d15bd, 0xa1cb559, 0x9e11393 }, /* -199 */
+    { 0x0003582, 0xcef55a9, 0x561bc62, 0x9c7888f, 0x634ec1e }, /* -198 */
+    { 0x0002acf, 0x0bf77ba, 0xab496b5, 0x49fa072, 0xb5d89b1 }, /* -197 */
+    { 0x000223f, 0x3cc5fc8, 0x8907891, 0x07fb38e, 0xf7e07c1 }, /* -196 */
+    { 0x00036cb, 0x946ffa7, 0x41a5a81, 0xa65ec17, 0xf300c68 }, /* -195 */
+    { 0x0002bd6, 0x1059952, 0x9aeaece, 0x1eb2346, 0x5c009ed }, /* -194 */
+    { 0x0002311, 0xa6ae10e, 0xe2558a4, 0xe55b5d1, 0xe333b24 }, /* -193 */
+    { 0x000381c, 0x3de34e4, 0x9d55aa1, 0x6ef894f, 0xd1ec506 }, /* -192 */
+    { 0x0002ce3, 0x64b5d83, 0xb11154d, 0xf260773, 0x0e56a6c }, /* -191 */
+    { 0x00023e9, 0x1d5e469, 0x5a7443e, 0x5b805f5, 0xa5121f0 }, /* -190 */
+    { 0x0003974, 0xfbca0a8, 0x90ba063, 0xc59a322, 0xa1b697f }, /* -189 */
+    { 0x0002df7, 0x2fd4d53, 0xa6fb383, 0x047b5b5, 0x4e2bacc }, /* -188 */
+    { 0x00024c5, 0xbfdd776, 0x1f2f602, 0x69fc491, 0x0b5623d }, /* -187 */
+    { 0x0003ad5, 0xffc8bf0, 0x31e566a, 0x432d41b, 0x45569fb }, /* -186 */
+    { 0x0002f11, 0x996d659, 0xc184521, 0xcf5767c, 0x37787fc }, /* -185 */
+    { 0x00025a7, 0xadf11e1, 0x679d0e7, 0xd912b96, 0x92c6cca }, /* -184 */
+    { 0x0003c3f, 0x7cb4fcf, 0x0c2e7d9, 0x5b5128a, 0x8471476 }, /* -183 */
+    { 0x0003032, 0xca2a63f, 0x3cf1fe1, 0x15da86e, 0xd05a9f8 }, /* -182 */
+    { 0x000268f, 0x0821e98, 0xfd8e64d, 0xab1538b, 0xd9e2193 }, /* -181 */
+    { 0x0003db1, 0xa69ca8e, 0x627d6e2, 0xab55279, 0x5c9cf52 }, /* -180 */
+    { 0x000315a, 0xebb0871, 0xe864582, 0x22aa861, 0x16e3f75 }, /* -179 */
+    { 0x000277b, 0xefc06c1, 0x86b6ace, 0x822204d, 0xabe992a }, /* -178 */
+    { 0x0003f2c, 0xb2cd79c, 0x0abde17, 0x369cd49, 0x130f510 }, /* -177 */
+    { 0x000328a, 0x28a4616, 0x6efe4df, 0x5ee3dd4, 0x0f3f740 }, /* -176 */
+    { 0x000286e, 0x86e9e78, 0x58cb719, 0x18b64a9, 0xa5cc5cd }, /* -175 */
+    { 0x0002058, 0x6bee52d, 0x13d5f47, 0x46f83ba, 0xeb09e3e }, /* -174 */
+    { 0x00033c0, 0xacb0848, 0x1fbcba5, 0x3e59f91, 0x780fd2f }, /* -173 */
+    { 0x0002966, 0xf08d36c, 0xe630950, 0xfeae60d, 0xf9a6426 }, /* -172 */
+    { 0x000211f, 0x26d75f0, 0xb826dda, 0x65584d7, 0xfaeb685 }, /* -171 */
+    { 0x00034fe, 0xa48bcb4, 0x59d7c90, 0xa226e26, 0x5e4573b }, /* -170 */
+    { 0x0002a65, 0x506fd5d, 0x14aca0d, 0x4e8581e, 0xb1d1295 }, /* -169 */
+    { 0x00021ea, 0xa6bfde4, 0x108a1a4, 0x3ed134b, 0xc174211 }, /* -168 */
+    { 0x0003644, 0x3dffca0, 0x1a76906, 0xcae8546, 0x0253682 }, /* -167 */
+    { 0x0002b69, 0xcb33080, 0x152ba6b, 0xd586a9e, 0x6842b9b }, /* -166 */
+    { 0x00022bb, 0x08f5a00, 0x10efb89, 0x779eee5, 0x2035616 }, /* -165 */
+    { 0x0003791, 0xa7ef666, 0x817f8db, 0xf297e3b, 0x66bbcef }, /* -164 */
+    { 0x0002c74, 0x86591eb, 0x9acc716, 0x5bacb62, 0xb8963f3 }, /* -163 */
+    { 0x0002390, 0x6b7a7ef, 0xaf09f45, 0x1623c4e, 0xfa11cc2 }, /* -162 */
+    { 0x00038e7, 0x125d97f, 0x7e7653b, 0x569fa17, 0xf682e03 }, /* -161 */
+    { 0x0002d85, 0xa84adff, 0x985ea95, 0xdee61ac, 0xc535803 }, /* -160 */
+    { 0x000246a, 0xed08b32, 0xe04bbab, 0x18b8157, 0x042accf }, /* -159 */
+    { 0x0003a44, 0xae7451e, 0x33ac5de, 0x8df3558, 0x06aae18 }, /* -158 */
+    { 0x0002e9d, 0x585d0e4, 0xf6237e5, 0x3e5c446, 0x6bbbe7a }, /* -157 */
+    { 0x000254a, 0xad173ea, 0x5e82cb7, 0x65169d1, 0xefc9861 }, /* -156 */
+    { 0x0003baa, 0xae8b976, 0xfd9e125, 0x6e8a94f, 0xe60f3cf }, /* -155 */
+    { 0x0002fbb, 0xbed612b, 0xfe180ea, 0xbed543f, 0xeb3f63f }, /* -154 */
+    { 0x000262f, 0xcbde756, 0x64e00bb, 0xcbddcff, 0xef65e99 }, /* -153 */
+    { 0x0003d19, 0x4630bbd, 0x6e3345f, 0xac96199, 0x7f0975b }, /* -152 */
+    { 0x00030e1, 0x04f3c97, 0x8b5c37f, 0xbd44e14, 0x65a12af }, /* -151 */
+    { 0x000271a, 0x6a5ca12, 0xd5e35ff, 0xca9d810, 0x514dbbf }, /* -150 */
+    { 0x0003e90, 0xaa2dcea, 0xefd2332, 0xddc8ce6, 0xe87c5ff }, /* -149 */
+    { 0x000320d, 0x54f1722, 0x5974f5b, 0xe4a0a52, 0x5396b32 }, /* -148 */
+    { 0x000280a, 0xaa5ac1b, 0x7ac3f7c, 0xb6e6ea8, 0x42def5c }, /* -147 */
+    { 0x0002008, 0x88489af, 0x9569930, 0x9252553, 0x68b25e3 }, /* -146 */
+    { 0x0003340, 0xda0dc4c, 0x224284d, 0xb6ea21f, 0x0dea304 }, /* -145 */
+    { 0x0002900, 0xae716a3, 0x4e9b9d7, 0xc5881b2, 0x718826a }, /* -144 */
+    { 0x00020cd, 0x585abb5, 0xd87c7df, 0xd139af5, 0x27a01ef }, /* -143 */
+    { 0x000347b, 0xc0912bc, 0x8d93fcc, 0x81f5e55, 0x0c3364a }, /* -142 */
+    { 0x00029fc, 0x9a0dbca, 0x0adcca3, 0x9b2b1dd, 0xa35c508 }, /* -141 */
+    { 0x0002196, 0xe1a496e, 0x6f17082, 0xe288e4a, 0xe916a6d }, /* -140 */
+    { 0x00035be, 0x35d424a, 0x4b580d1, 0x6a74a11, 0x74f10ae }, /* -139 */
+    { 0x0002afe, 0x917683b, 0x6f79a41, 0x21f6e74, 0x5d8da25 }, /* -138 */
+    { 0x0002265, 0x412b9c9, 0x25fae9a, 0x8192529, 0xe4714eb }, /* -137 */
+    { 0x0003708, 0x6845c75, 0x099175d, 0x9c1d50f, 0xd3e87dd }, /* -136 */
+    { 0x0002c06, 0xb9d16c4, 0x07a7917, 0xb01773f, 0xdcb9fe4 }, /* -135 */
+    { 0x0002338, 0x94a789c, 0xd2ec746, 0x2679299, 0x7d61984 }, /* -134 */
+    { 0x000385a, 0x8772761, 0x517a53d, 0x0a5b75b, 0xfbcf59f }, /* -133 */
+    { 0x0002d15, 0x39285e7, 0x7461dca, 0x6eaf916, 0x630c47f }, /* -132 */
+    { 0x0002410, 0xfa86b1f, 0x904e4a1, 0xf2260de, 0xb5a36cc }, /* -131 */
+    { 0x00039b4, 0xc40ab65, 0xb3b0769, 0x8370164, 0x55d247a }, /* -130 */
+    { 0x0002e2a, 0x366ef84, 0x8fc05ee, 0x02c011d, 0x1175062 }, /* -129 */
+    { 0x00024ee, 0x91f2603, 0xa6337f1, 0x9bccdb0, 0xdac404e }, /* -128 */
+    { 0x0003b17, 0x4fea339, 0x09ebfe8, 0xf947c4e, 0x2ad33b0 }, /* -127 */
+    { 0x0002f45, 0xd988294, 0x07effed, 0x94396a4, 0xef0f627 }, /* -126 */
+    { 0x00025d1, 0x7ad3543, 0x398ccbe, 0x102deea, 0x58d91b9 }, /* -125 */
+    { 0x0003c82, 0x5e1eed1, 0xf5ae130, 0x19e3176, 0xf48e927 }, /* -124 */
+    { 0x0003068, 0x4b4bf0e, 0x5e24dc0, 0x14b5ac5, 0x90720ec }, /* -123 */
+    { 0x00026b9, 0xd5d65a5, 0x181d7cc, 0xdd5e237, 0xa6c1a57 }, /* -122 */
+    { 0x0003df6, 0x22f0908, 0x2695947, 0xc8969f2, 0xa46908a }, /* -121 */
+    { 0x0003191, 0xb58d406, 0x854476c, 0xa0787f5, 0x505406f }, /* -120 */
+    { 0x00027a7, 0xc471005, 0x3769f8a, 0x19f9ff7, 0x73766bf }, /* -119 */
+    { 0x0003f72, 0xd3e8008, 0x58a98dc, 0xf65ccbf, 0x1f23dfe }, /* -118 */
+    { 0x00032c2, 0x4320006, 0xad54717, 0x2b7d6ff, 0x4c1cb32 }, /* -117 */
+    { 0x000289b, 0x68e666b, 0xbddd278, 0xef978cc, 0x3ce3c28 }, /* -116 */
+    { 0x000207c, 0x53eb856, 0x317db93, 0xf2dfa3c, 0xfd83020 }, /* -115 */
+    { 0x00033fa, 0x1fdf3bd, 0x1bfc5b9, 0x8499061, 0x959e699 }, /* -114 */
+    { 0x0002994, 0xe64c2fd, 0xaffd161, 0x36e0d1a, 0xde18548 }, /* -113 */
+    { 0x0002143, 0xeb70264, 0x8cca780, 0xf8b3daf, 0x181376d }, /* -112 */
+    { 0x0003539, 0x78b3707, 0x47aa59b, 0x27862b1, 0xc01f247 }, /* -111 */
+    { 0x0002a94, 0x608f8d2, 0x9fbb7af, 0x52d1bc1, 0x667f506 }, /* -110 */
+    { 0x0002210, 0x4d3fa42, 0x1962c8c, 0x4241634, 0x51ff738 }, /* -109 */
+    { 0x0003680, 0x7b99069, 0xc237a7a, 0x039bd20, 0x8332526 }, /* -108 */
+    { 0x0002b99, 0xfc7a6bb, 0x01c61fb, 0x361641a, 0x028ea85 }, /* -107 */
+    { 0x00022e1, 0x96c8562, 0x67d1b2f, 0x5e78348, 0x020bb9e }, /* -106 */
+    { 0x00037cf, 0x57a6f03, 0xd94f84b, 0xca59ed9, 0x9cdf8fc }, /* -105 */
+    { 0x0002ca5, 0xdfb8c03, 0x143f9d6, 0x3b7b247, 0xb0b2d96 }, /* -104 */
+    { 0x00023b7, 0xe62d668, 0xdcffb11, 0xc92f506, 0x26f57ac }, /* -103 */
+    { 0x0003926, 0x3d1570e, 0x2e65e82, 0xdb7ee70, 0x3e55912 }, /* -102 */
+    { 0x0002db8, 0x30ddf3e, 0x8b84b9b, 0xe2cbec0, 0x31de0dc }, /* -101 */
+    { 0x0002493, 0x5a4b298, 0x6f9d616, 0x4f09899, 0xc17e716 }, /* -100 */
+    { 0x0003a85, 0x5d450f3, 0xe5c89bd, 0x4b4275c, 0x68ca4f0 }, /*  -99 */
+    { 0x0002ed1, 0x176a729, 0x84a07ca, 0xa29b916, 0xba3b726 }, /*  -98 */
+    { 0x0002574, 0x12bb8ee, 0x03b396e, 0xe87c745, 0x61c9285 }, /*  -97 */
+    { 0x0003bec, 0xeac5b16, 0x6c528b1, 0x73fa53b, 0xcfa8408 }, /*  -96 */
+    { 0x0002ff0, 0xbbd15ab, 0x89dba27, 0x8ffb763, 0x0c869a0 }, /*  -95 */
+    { 0x000265a, 0x2fdaaef, 0xa17c81f, 0xa662c4f, 0x3d387b3 }, /*  -94 */
+    { 0x0003d5d, 0x195de4c, 0x3594032, 0xa3d13b1, 0xfb8d91f }, /*  -93 */
+    { 0x0003117, 0x477e509, 0xc47668e, 0xe9742f4, 0xc93e0e6 }, /*  -92 */
+    { 0x0002745, 0xd2cb73b, 0x0391ed8, 0xbac3590, 0xa0fe71e }, /*  -91 */
+    { 0x0003ed6, 0x1e1252b, 0x38e97c1, 0x2ad2281, 0x01971c9 }, /*  -90 */
+    { 0x0003244, 0xe4db755, 0xc721300, 0xef0e867, 0x3478e3b }, /*  -89 */
+    { 0x0002837, 0x1d7c5de, 0x38e759a, 0x58d86b8, 0xf6c71c9 }, /*  -88 */
+    { 0x000202c, 0x1796b18, 0x2d85e15, 0x13e0560, 0xc56c16e }, /*  -87 */
+    { 0x0003379, 0xbf57826, 0xaf3c9bb, 0x530089a, 0xd579be2 }, /*  -86 */
+    { 0x000292e, 0x32ac685, 0x58fd495, 0xdc006e2, 0x446164f }, /*  -85 */
+    { 0x00020f1, 0xc22386a, 0xad976de, 0x4999f1b, 0x69e783f }, /*  -84 */
+    { 0x00034b6, 0x036c0aa, 0xaf58afd, 0x428fe92, 0x430c065 }, /*  -83 */
+    { 0x0002a2b, 0x35f0088, 0x8c46f31, 0x020cba8, 0x35a3384 }, /*  -82 */
+    { 0x00021bc, 0x2b266d3, 0xa36bf5a, 0x680a2ec, 0xf7b5c69 }, /*  -81 */
+    { 0x00035f9, 0xdea3e1f, 0x6bdfef7, 0x0cdd17b, 0x25efa42 }, /*  -80 */
+    { 0x0002b2e, 0x4bb64e5, 0xefe6592, 0x70b0dfc, 0x1e59502 }, /*  -79 */
+    { 0x000228b, 0x6fc50b7, 0xf31eadb, 0x8d5a4c9, 0xb1e10ce }, /*  -78 */
+    { 0x0003745, 0x7fa1abf, 0xeb64492, 0x7bc3adc, 0x4fce7b0 }, /*  -77 */
+    { 0x0002c37, 0x994e233, 0x22b6a0e, 0xc96957d, 0x0ca52f3 }, /*  -76 */
+    { 0x000235f, 0xadd81c2, 0x822bb3f, 0x0787797, 0x3d50f29 }, /*  -75 */
+    { 0x0003899, 0x1626937, 0x36ac531, 0xa5a58f1, 0xfbb4b75 }, /*  -74 */
+    { 0x0002d47, 0x44eba92, 0x922375a, 0xeaead8e, 0x62f6f91 }, /*  -73 */
+    { 0x0002439, 0x03efba8, 0x74e92af, 0x22557a5, 0x1bf8c74 }, /*  -72 */
+    { 0x00039f4, 0xd3192a7, 0x2175118, 0x36ef2a1, 0xc65ad86 }, /*  -71 */
+    { 0x0002e5d, 0x75adbb8, 0xe790dac, 0xf8bf54e, 0x3848ad2 }, /*  -70 */
+    { 0x0002517, 0x9157c93, 0xec73e23, 0xfa32aa4, 0xf9d3bdb }, /*  -69 */
+    { 0x0003b58, 0xe88c753, 0x13ec9d3, 0x29eaaa1, 0x8fb92f8 }, /*  -68 */
+    { 0x0002f7a, 0x53a390f, 0x4323b0f, 0x54bbbb4, 0x72fa8c6 }, /*  -67 */
+    { 0x00025fb, 0x761c73f, 0x68e95a5, 0xdd62fc3, 0x8f2ed6c }, /*  -66 */
+    { 0x0003cc5, 0x89c71ff, 0x0e422a2, 0xfbd1938, 0xe517bdf }, /*  -65 */
+    { 0x000309e, 0x07d27ff, 0x3e9b54f, 0x2fdadc7, 0x1dac97f }, /*  -64 */
+    { 0x00026e4, 0xd30eccc, 0x3215dd8, 0xf3157d2, 0x7e23acc }, /*  -63 */
+    { 0x0003e3a, 0xeb4ae13, 0x83562f4, 0xb82261d, 0x969f7ad }, /*  -62 */
+    { 0x00031c8, 0xbc3be76, 0x02ab590, 0x934eb4a, 0xdee5fbe }, /*  -61 */
+    { 0x00027d3, 0xc9c985e, 0x6889140, 0x75d8908, 0xb251965 }, /*  -60 */
+    { 0x0003fb9, 0x42dc097, 0x0da8200, 0xbc8db41, 0x1d4f56e }, /*  -59 */
+    { 0x00032fa, 0x9be33ac, 0x0aece66, 0xfd3e29a, 0x7dd9125 }, /*  -58 */
+    { 0x00028c8, 0x7cb5c89, 0xa2571eb, 0xfdcb548, 0x64ada84 }, /*  -57 */
+    { 0x00020a0, 0x63c4a07, 0xb5127ef, 0xfe3c439, 0xea2486a }, /*  -56 */
+    { 0x0003433, 0xd2d433f, 0x881d97f, 0xfd2d38f, 0xdd073dc }, /*  -55 */
+    { 0x00029c3, 0x0f10299, 0x39b1466, 0x64242d9, 0x7d9f64a }, /*  -54 */
+    { 0x0002168, 0xd8d9bad, 0xc7c1051, 0xe9b68ad, 0xfe191d5 }, /*  -53 */
+    { 0x0003574, 0x8e292af, 0xa601a1c, 0xa924116, 0x635b621 }, /*  -52 */
+    { 0x0002ac3, 0xa4edbbf, 0xb8014e3, 0xba83411, 0xe915e81 }, /*  -51 */
+    { 0x0002236, 0x1d8afcc, 0x93343e9, 0x62029a7, 0xedab201 }, /*  -50 */
+    { 0x00036bc, 0xfc11947, 0x51ed30f, 0x03375d9, 0x7c45001 }, /*  -49 */
+    { 0x0002bca, 0x6341439, 0x0e575a5, 0x9c2c4ad, 0xfd04001 }, /*  -48 */
+    { 0x0002308, 0x4f67694, 0x0b79151, 0x49bd08b, 0x30d0001 }, /*  -47 */
+    { 0x000380d, 0x4bd8a86, 0x78c1bb5, 0x42c80de, 0xb480001 }, /*  -46 */
+    { 0x0002cd7, 0x6fe086b, 0x93ce2f7, 0x68a00b2, 0x2a00001 }, /*  -45 */
+    { 0x00023df, 0x8cb39ef, 0xa971bf9, 0x208008e, 0x8800001 }, /*  -44 */
+    { 0x0003965, 0xadec319, 0x0f1c65b, 0x6733417, 0x4000001 }, /*  -43 */
+    { 0x0002dea, 0xf189c14, 0x0c16b7c, 0x528f679, 0x0000001 }, /*  -42 */
+    { 0x00024bb, 0xf46e343, 0x3cdef96, 0xa872b94, 0x0000001 }, /*  -41 */
+    { 0x0003ac6, 0x53e386b, 0x9497f57, 0x73eac20, 0x0000001 }, /*  -40 */
+    { 0x0002f05, 0x0fe9389, 0x43acc45, 0xf655680, 0x0000001 }, /*  -39 */
+    { 0x000259d, 0xa6542d4, 0x3623d04, 0xc511200, 0x0000001 }, /*  -38 */
+    { 0x0003c2f, 0x7086aed, 0x236c807, 0xa1b5000, 0x0000001 }, /*  -37 */
+    { 0x0003025, 0xf39ef24, 0x1c56cd2, 0xe7c4000, 0x0000001 }, /*  -36 */
+    { 0x0002684, 0xc2e58e9, 0xb04570f, 0x1fd0000, 0x0000001 }, /*  -35 */
+    { 0x0003da1, 0x37d5b0f, 0x806f1b1, 0xcc80000, 0x0000001 }, /*  -34 */
+    { 0x000314d, 0xc6448d9, 0x338c15b, 0x0a00000, 0x0000001 }, /*  -33 */
+    { 0x0002771, 0x6b6a0ad, 0xc2d677c, 0x0800000, 0x0000001 }, /*  -32 */
+    { 0x0003f1b, 0xdf10116, 0x048a593, 0x4000000, 0x0000001 }, /*  -31 */
+    { 0x000327c, 0xb273411, 0x9d3b7a9, 0x0000000, 0x0000001 }, /*  -30 */
+    { 0x0002863, 0xc1f5cda, 0xe42f954, 0x0000000, 0x0000001 }, /*  -29 */
+    { 0x000204f, 0xce5e3e2, 0x5026110, 0x0000000, 0x0000001 }, /*  -28 */
+    { 0x00033b2, 0xe3c9fd0, 0x803ce80, 0x0000000, 0x0000001 }, /*  -27 */
+    { 0x000295b, 0xe96e640, 0x6697200, 0x0000000, 0x0000001 }, /*  -26 */
+    { 0x0002116, 0x5458500, 0x5212800, 0x0000000, 0x0000001 }, /*  -25 */
+    { 0x00034f0, 0x86f3b33, 0xb684000, 0x0000000, 0x0000001 }, /*  -24 */
+    { 0x0002a5a, 0x058fc29, 0x5ed0000, 0x0000000, 0x0000001 }, /*  -23 */
+    { 0x00021e1, 0x9e0c9ba, 0xb240000, 0x0000000, 0x0000001 }, /*  -22 */
+    { 0x0003635, 0xc9adc5d, 0xea00000, 0x0000000, 0x0000001 }, /*  -21 */
+    { 0x0002b5e, 0x3af16b1, 0x8800000, 0x0000000, 0x0000001 }, /*  -20 */
+    { 0x00022b1, 0xc8c1227, 0xa000000, 0x0000000, 0x0000001 }, /*  -19 */
+    { 0x0003782, 0xdace9d9, 0x0000000, 0x0000000, 0x0000001 }, /*  -18 */
+    { 0x0002c68, 0xaf0bb14, 0x0000000, 0x0000000, 0x0000001 }, /*  -17 */
+    { 0x0002386, 0xf26fc10, 0x0000000, 0x0000000, 0x0000001 }, /*  -16 */
+    { 0x00038d7, 0xea4c680, 0x0000000, 0x0000000, 0x0000001 }, /*  -15 */
+    { 0x0002d79, 0x883d200, 0x0000000, 0x0000000, 0x0000001 }, /*  -14 */
+    { 0x0002461, 0x39ca800, 0x0000000, 0x0000000, 0x0000001 }, /*  -13 */
+    { 0x0003a35, 0x2944000, 0x0000000, 0x0000000, 0x0000001 }, /*  -12 */
+    { 0x0002e90, 0xedd0000, 0x0000000, 0x0000000, 0x0000001 }, /*  -11 */
+    { 0x0002540, 0xbe40000, 0x0000000, 0x0000000, 0x0000001 }, /*  -10 */
+    { 0x0003b9a, 0xca00000, 0x0000000, 0x0000000, 0x0000001 }, /*   -9 */
+    { 0x0002faf, 0x0800000, 0x0000000, 0x0000000, 0x0000001 }, /*   -8 */
+    { 0x0002625, 0xa000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -7 */
+    { 0x0003d09, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -6 */
+    { 0x00030d4, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -5 */
+    { 0x0002710, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -4 */
+    { 0x0003e80, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -3 */
+    { 0x0003200, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -2 */
+    { 0x0002800, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*   -1 */
+    { 0x0002000, 0x0000000, 0x0000000, 0x0000000, 0x0000001 }, /*    0 */
+    { 0x0003333, 0x3333333, 0x3333333, 0x3333333, 0x3333334 }, /*    1 */
+    { 0x00028f5, 0xc28f5c2, 0x8f5c28f, 0x5c28f5c, 0x28f5c29 }, /*    2 */
+    { 0x00020c4, 0x9ba5e35, 0x3f7ced9, 0x16872b0, 0x20c49bb }, /*    3 */
+    { 0x000346d, 0xc5d6388, 0x6594af4, 0xf0d844d, 0x013a92b }, /*    4 */
+    { 0x00029f1, 0x6b11c6d, 0x1e108c3, 0xf3e0370, 0xcdc8755 }, /*    5 */
+    { 0x000218d, 0xef416bd, 0xb1a6d69, 0x8fe6927, 0x0b06c44 }, /*    6 */
+    { 0x00035af, 0xe535795, 0xe90af0f, 0x4ca41d8, 0x11a46d4 }, /*    7 */
+    { 0x0002af3, 0x1dc4611, 0x873bf3f, 0x70834ac, 0xdae9f10 }, /*    8 */
+    { 0x000225c, 0x17d04da, 0xd2965cc, 0x5a02a23, 0xe254c0d }, /*    9 */
+    { 0x00036f9, 0xbfb3af7, 0xb756fad, 0x5cd1039, 0x6a21347 }, /*   10 */
+    { 0x0002bfa, 0xffc2f2c, 0x92abfbd, 0xe3da694, 0x54e75d3 }, /*   11 */
+    { 0x000232f, 0x33025bd, 0x42232fe, 0x4fe1edd, 0x10b9175 }, /*   12 */
+    { 0x000384b, 0x84d092e, 0xd0384ca, 0x19697c8, 0x1ac1bef }, /*   13 */
+    { 0x0002d09, 0x370d425, 0x73603d4, 0xe121306, 0x7bce326 }, /*   14 */
+    { 0x0002407, 0x5f3dcea, 0xc2b3643, 0xe74dc05, 0x2fd8285 }, /*   15 */
+    { 0x00039a5, 0x652fb11, 0x37856d3, 0x0baf9a1, 0xe626a6d }, /*   16 */
+    { 0x0002e1d, 0xea8c8da, 0x92d1242, 0x6fbfae7, 0xeb521f1 }, /*   17 */
+    { 0x00024e4, 0xbba3a48, 0x75741ce, 0xbfcc8b9, 0x890e7f4 }, /*   18 */
+    { 0x0003b07, 0x929f6da, 0x558694a, 0xcc7a78f, 0x41b0cba }, /*   19 */
+    { 0x0002f39, 0x4219248, 0x446baa2, 0x3d2ec72, 0x9af3d62 }, /*   20 */
+    { 0x00025c7, 0x68141d3, 0x69efbb4, 0xfdbf05b, 0xaf29781 }, /*   21 */
+    { 0x0003c72, 0x40202eb, 0xdcb2c54, 0xc931a2c, 0x4b758cf }, /*   22 */
+    { 0x000305b, 0x6680256, 0x4a289dd, 0x6dc14f0, 0x3c5e0a5 }, /*   23 */
+    { 0x00026af, 0x8533511, 0xd4ed4b1, 0x249aa59, 0xc9e4d51 }, /*   24 */
+    { 0x0003de5, 0xa1ebb4f, 0xbb1544e, 0xa0f76f6, 0x0fd4882 }, /*   25 */
+    { 0x0003184, 0x81895d9, 0x62776a5, 0x4d92bf8, 0x0caa068 }, /*   26 */
+    { 0x000279d, 0x346de47, 0x81f921d, 0xd7a8993, 0x3d54d20 }, /*   27 */
+    { 0x0003f61, 0xed7ca0c, 0x0328362, 0xf2a75b8, 0x6221500 }, /*   28 */
+    { 0x00032b4, 0xbdfd4d6, 0x68ecf82, 0x5bb9160, 0x4e810cd }, /*   29 */
+    { 0x0002890, 0x97fdd78, 0x53f0c68, 0x4960de6, 0xa5340a4 }, /*   30 */
+    { 0x0002073, 0xaccb12d, 0x0ff3d20, 0x3ab3e52, 0x1dc33b6 }, /*   31 */
+    { 0x00033ec, 0x47ab514, 0xe652e99, 0xf7863b6, 0x96052bd }, /*   32 */
+    { 0x0002989, 0xd2ef743, 0xeb7587b, 0x2c6b62b, 0xab37564 }, /*   33 */
+    { 0x000213b, 0x0f25f69, 0x892ad2f, 0x56bc4ef, 0xbc2c450 }, /*   34 */
+    { 0x000352b, 0x4b6ff0f, 0x41de1e5, 0x5793b19, 0x2d13a1a }, /*   35 */
+    { 0x0002a89, 0x09265a5, 0xce4b4b7, 0x7942f47, 0x5742e7b }, /*   36 */
+    { 0x0002207, 0x3a85151, 0x71d5d5f, 0x9435905, 0xdf68b96 }, /*   37 */
+    { 0x0003671, 0xf73b54f, 0x1c89565, 0xb9ef4d6, 0x3241289 }, /*   38 */
+    { 0x0002b8e, 0x5f62aa5, 0xb06ddea, 0xfb25d78, 0x2834207 }, /*   39 */
+    { 0x00022d8, 0x4c4eeea, 0xf38b188, 0xc8eb12c, 0xecf6806 }, /*   40 */
+    { 0x00037c0, 0x7a17e44, 0xb8de8da, 0xdb11b7b, 0x14bd9a3 }, /*   41 */
+    { 0x0002c99, 0xfb46503, 0xc718715, 0x7c0e2c8, 0xdd647b5 }, /*   42 */
+    { 0x00023ae, 0x629ea69, 0x6c138dd, 0xfcd823a, 0x4ab6c91 }, /*   43 */
+    { 0x0003917, 0x04310a8, 0xacec163, 0x2e269f6, 0xddf141b }, /*   44 */
+    { 0x0002dac, 0x035a6ed, 0x572344f, 0x581ee5f, 0x17f4349 }, /*   45 */
+    { 0x0002489, 0x9c4858a, 0xac1c372, 0xace584c, 0x1329c3b }, /*   46 */
+    { 0x0003a75, 0xc6da277, 0x79c6bea, 0xae3c079, 0xb842d2a }, /*   47 */
+    { 0x0002ec4, 0x9f14ec5, 0xfb05655, 0x5830061, 0x6035755 }, /*   48 */
+    { 0x000256a, 0x18dd89e, 0x626ab77, 0x79c004d, 0xe6912ab }, /*   49 */
+    { 0x0003bdc, 0xf495a97, 0x03ddf25, 0x8f99a16, 0x3db5111 }, /*   50 */
+    { 0x0002fe3, 0xf6de212, 0x697e5b7, 0xa614811, 0xcaf740d }, /*   51 */
+    { 0x000264f, 0xf8b1b41, 0xedfeaf9, 0x51aa00e, 0x3bf900b }, /*   52 */
+    { 0x0003d4c, 0xc11c536, 0x49977f5, 0x4f7667d, 0x2cc19ab }, /*   53 */
+    { 0x000310a, 0x3416a91, 0xd47932a, 0xa5f8530, 0xf09ae22 }, /*   54 */
+    { 0x000273b, 0x5cdeedb, 0x1060f55, 0x519375a, 0x5a1581b }, /*   55 */
+    { 0x0003ec5, 0x6164af8, 0x1a34bbb, 0xb5b8bc3, 0xc3559c5 }, /*   56 */
+    { 0x0003237, 0x811d593, 0x482a2fc, 0x9160969, 0x691149e }, /*   57 */
+    { 0x000282c, 0x674aadc, 0x39bb596, 0xdab3aba, 0xba743b2 }, /*   58 */
+    { 0x0002023, 0x85d557c, 0xfafc478, 0xaef622e, 0xfb902f5 }, /*   59 */
+    { 0x000336c, 0x0955594, 0xc4c6d8d, 0xe4bd04b, 0x2c19e54 }, /*   60 */
+    { 0x0002923, 0x3aaaadd, 0x6a38ad7, 0xea30d08, 0xf014b76 }, /*   61 */
+    { 0x00020e8, 0xfbbbbe4, 0x54fa246, 0x54f3da0, 0xc01092c }, /*   62 */
+    { 0x00034a7, 0xf92c63a, 0x21903a3, 0xbb1fc34, 0x6680eac }, /*   63 */
+    { 0x0002a1f, 0xfa89e94, 0xe7a694f, 0xc8e635d, 0x1ecd88a }, /*   64 */
+    { 0x00021b3, 0x2ed4baa, 0x52ebaa6, 0x3a51c4a, 0x7f0ad3b }, /*   65 */
+    { 0x00035eb, 0x7e212aa, 0x1e45dd6, 0xc3b6077, 0x31aaec4 }, /*   66 */
+    { 0x0002b22, 0xcb4dbbb, 0x4b6b178, 0x9c919f8, 0xf488bd0 }, /*   67 */
+    { 0x0002282, 0x3c3e2fc, 0x3c55ac6, 0xe3a7b2d, 0x906d640 }, /*   68 */
+    { 0x0003736, 0xc6c9e60, 0x608913e, 0x390c515, 0xb3e239a }, /*   69 */
+    { 0x0002c2b, 0xd23b1e6, 0xb3a0dcb, 0x60d6a77, 0xc31b615 }, /*   70 */
+    { 0x0002356, 0x41c8e52, 0x294d7d5, 0xe7121f9, 0x68e2b44 }, /*   71 */
+    { 0x000388a, 0x02db083, 0x7548c89, 0x71b698f, 0x0e3786d }, /*   72 */
+    { 0x0002d3b, 0x357c069, 0x2aa0a07, 0x8e2bad8, 0xd82c6bd }, /*   73 */
+    { 0x000242f, 0x5dfcd20, 0xeee6e6c, 0x71bc8ad, 0x79bd231 }, /*   74 */
+    { 0x00039e5, 0x632e1ce, 0x4b0b0ad, 0x82c7448, 0xc2c8382 }, /*   75 */
+    { 0x0002e51, 0x1c24e3e, 0xa26f3be, 0x023903a, 0x356cf9b }, /*   76 */
+    { 0x000250d, 0xb01d832, 0x1b8c2fe, 0x682d9c8, 0x2abd949 }, /*   77 */
+    { 0x0003b49, 0x19c8d1c, 0xf8e04ca, 0x4048fa6, 0xaac8edb }, /*   78 */
+    { 0x0002f6d, 0xae3a417, 0x2d803d5, 0x003a61e, 0xef07249 }, /*   79 */
+    { 0x00025f1, 0x582e9ac, 0x2466977, 0x3361e7f, 0x259f507 }, /*   80 */
+    { 0x0003cb5, 0x59e42ad, 0x070a8be, 0xb89ca65, 0x08fee71 }, /*   81 */
+    { 0x0003091, 0x14b688a, 0x6c086fe, 0xfa16eb7, 0x3a6585b }, /*   82 */
+    { 0x00026da, 0x76f86d5, 0x2339f32, 0x61abef8, 0xfb846af }, /*   83 */
+    { 0x0003e2a, 0x57f3e21, 0xd1f651d, 0x691318e, 0x5f3a44b }, /*   84 */
+    { 0x00031bb, 0x798fe81, 0x74c50e4, 0x540f471, 0xe5c836f }, /*   85 */
+    { 0x00027c9, 0x2e0cb9a, 0xc3d0d83, 0x76729f4, 0xb7d35f3 }, /*   86 */
+    { 0x0003fa8, 0x49adf5e, 0x061af38, 0xbd84321, 0x261efeb }, /*   87 */
+    { 0x00032ed, 0x07be5e4, 0xd1af293, 0xcad0280, 0xeb4bfef }, /*   88 */
+    { 0x00028bd, 0x9fcb7ea, 0x4158edc, 0xa240200, 0xbc3ccbf }, /*   89 */
+    { 0x0002097, 0xb309321, 0xcde0be3, 0xb50019a, 0x3030a33 }, /*   90 */
+    { 0x0003425, 0xeb41e9c, 0x7c9ac9f, 0x8800290, 0x4d1a9ea }, /*   91 */
+    { 0x00029b7, 0xef67ee3, 0x96e23b2, 0xd333540, 0x3daee55 }, /*   92 */
+    { 0x000215f, 0xf2b98b6, 0x124e95b, 0xdc29100, 0x3158b77 }, /*   93 */
+    { 0x0003566, 0x5128df0, 0x1d4a892, 0xf9db4cd, 0x1bc1258 }, /*   94 */
+    { 0x0002ab8, 0x40ed7f3, 0x4aa2075, 0x94af70a, 0x7c9a847 }, /*   95 */
+    { 0x000222d, 0x00bdff5, 0xd54e6c4, 0x76f2c08, 0x63aed06 }, /*   96 */
+    { 0x00036ae, 0x6796656, 0x221713a, 0x57eacda, 0x3917b3c }, /*   97 */
+    { 0x0002bbe, 0xb9451de, 0x81ac0fb, 0x7988a48, 0x2dac8fd }, /*   98 */
+    { 0x00022fe, 0xfa9db18, 0x67bcd95, 0xfad3b6c, 0xf156d97 }, /*   99 */
+    { 0x00037fe, 0x5dc91c0, 0xa5faf56, 0x5e1f8ae, 0x4ef15be }, /*  100 */
+    { 0x0002ccb, 0x7e3a7cd, 0x5195911, 0xe4e608b, 0x725aaff }, /*  101 */
+    { 0x00023d5, 0xfe9530a, 0xa7aada7, 0xea51a09, 0x28488cc }, /*  102 */
+    { 0x0003956, 0x6421e77, 0x72aaf73, 0x10829a8, 0x4074146 }, /*  103 */
+    { 0x0002dde, 0xb68185f, 0x8eef2c2, 0x739baed, 0x005cdd2 }, /*  104 */
+    { 0x00024b2, 0x2b9ad19, 0x3f25bce, 0xc2e2f24, 0x004a4a8 }, /*  105 */
+    { 0x0003ab6, 0xac2ae8e, 0xcb6f94a, 0xd16b1d3, 0x33aa10c }, /*  106 */
+    { 0x0002ef8, 0x89bbed8, 0xa2bfaa2, 0x41227dc, 0x2954da3 }, /*  107 */
+    { 0x0002593, 0xa163246, 0xe89954e, 0x9a81fe3, 0x5443e1c }, /*  108 */
+    { 0x0003c1f, 0x689ea0b, 0x0dc2217, 0x5d9cc9e, 0xed39694 }, /*  109 */
+    { 0x0003019, 0x207ee6f, 0x3e34e79, 0x17b0a18, 0xbdc7876 }, /*  110 */
+    { 0x000267a, 0x8065858, 0xfe90b94, 0x12f3b46, 0xfe39392 }, /*  111 */
+    { 0x0003d90, 0xcd6f3c1, 0x974df53, 0x5185ed7, 0xfd285b6 }, /*  112 */
+    { 0x0003140, 0xa458fce, 0x12a4c42, 0xa79e579, 0x97537c5 }, /*  113 */
+    { 0x0002766, 0xe9e0ca4, 0xdbb7035, 0x52e512e, 0x12a9304 }, /*  114 */
+    { 0x0003f0b, 0x0fce107, 0xc5f19ee, 0xeb081e3, 0x510eb39 }, /*  115 */
+    { 0x000326f, 0x3fd80d3, 0x04c14bf, 0x226ce4f, 0x740bc2e }, /*  116 */
+    { 0x0002858, 0xffe00a8, 0xd09aa32, 0x81f0b72, 0xc33c9be }, /*  117 */
+    { 0x0002047, 0x3319a20, 0xa6e21c2, 0x018d5f5, 0x68fd498 }, /*  118 */
+    { 0x00033a5, 0x1e8f69a, 0xa49cf9c, 0xcf48988, 0xa7fba8d }, /*  119 */
+    { 0x0002950, 0xe53f87b, 0xb6e3fb0, 0xa5d3ad3, 0xb99620b }, /*  120 */
+    { 0x000210d, 0x8432d2f, 0xc5832f3, 0xb7dc8a9, 0x6144e6f }, /*  121 */
+    { 0x00034e2, 0x6d1e1e6, 0x08d1e52, 0xbfc7442, 0x353b0b1 }, /*  122 */
+    { 0x0002a4e, 0xbdb1b1e, 0x6d74b75, 0x6639034, 0xf7626f4 }, /*  123 */
+    { 0x00021d8, 0x97c15b1, 0xf12a2c4, 0x51c735d, 0x92b525d }, /*  124 */
+    { 0x0003627, 0x59355e9, 0x81dd13a, 0x1c71efc, 0x1deea2e }, /*  125 */
+    { 0x0002b52, 0xadc44ba, 0xce4a761, 0xb05b263, 0x4b254f2 }, /*  126 */
+    { 0x00022a8, 0x8b036fb, 0xd83b91a, 0xf37c1e9, 0x08eaa5b }, /*  127 */
+    { 0x0003774, 0x119f192, 0xf39282b, 0x1f2cfdb, 0x41776f8 }, /*  128 */
+    { 0x0002c5c, 0xdae5adb, 0xf60ecef, 0x4c23fe2, 0x9ac5f2d }, /*  129 */
+    { 0x000237d, 0x7beaf16, 0x5e723f2, 0xa34ffe8, 0x7bd18f1 }, /*  130 */
+    { 0x00038c8, 0xc644b56, 0xfd83984, 0x387ffda, 0x5fb5b1b }, /*  131 */
+    { 0x0002d6d, 0x6b6a2ab, 0xfe02e03, 0x6066648, 0x4c915af }, /*  132 */
+    { 0x0002457, 0x8921bbc, 0xcb35802, 0xb3851d3, 0x707448c }, /*  133 */
+    { 0x0003a25, 0xa835f94, 0x785599d, 0xec082eb, 0xe720746 }, /*  134 */
+    { 0x0002e84, 0x8691943, 0x9377ae4, 0xbcd3589, 0x85b3905 }, /*  135 */
+    { 0x0002536, 0xd20e102, 0xdc5fbea, 0x30a913a, 0xd15c738 }, /*  136 */
+    { 0x0003b8a, 0xe9b019e, 0x2d65fdd, 0x1aa81f7, 0xb560b8c }, /*  137 */
+    { 0x0002fa2, 0x548ce18, 0x245197d, 0xaeece5f, 0xc44d609 }, /*  138 */
+    { 0x000261b, 0x76d71ac, 0xe9dadfe, 0x258a519, 0x69d7808 }, /*  139 */
+    { 0x0003cf8, 0xbe24f7b, 0x0fc4996, 0xa276e8f, 0x0fbf33f }, /*  140 */
+    { 0x00030c6, 0xfe83f95, 0xa636e12, 0x1b9253f, 0x3fcc299 }, /*  141 */
+    { 0x0002705, 0x9869944, 0x84f8b41, 0xafa8432, 0x9970214 }, /*  142 */
+    { 0x0003e6f, 0x5a4286d, 0xa18decf, 0x7f739ea, 0x8f19ced }, /*  143 */
+    { 0x00031f2, 0xae9b9f1, 0x4e0b23f, 0x99294bb, 0xa5ae3f1 }, /*  144 */
+    { 0x00027f5, 0x587c7f4, 0x3e6f4ff, 0xadbaa2f, 0xb7be98d }, /*  145 */
+    { 0x0003fee, 0xf3fa653, 0x97187ff, 0x7c5dd19, 0x25fdc15 }, /*  146 */
+    { 0x0003325, 0x8ffb842, 0xdf46ccc, 0x637e414, 0x1e649ab }, /*  147 */
+    { 0x00028ea, 0xd996035, 0x7f6bd70, 0x4f98343, 0x4b83aef }, /*  148 */
+    { 0x00020bb, 0xe144cf7, 0x9923126, 0xa6135cf, 0x6f9c8bf }, /*  149 */
+    { 0x000345f, 0xced47f2, 0x8e9e83d, 0xd685618, 0xb294132 }, /*  150 */
+    { 0x00029e6, 0x3f1065b, 0xa54b9cb, 0x12044e0, 0x8edcdc2 }, /*  151 */
+    { 0x0002184, 0xff40516, 0x1dd616f, 0x419d0b3, 0xa57d7ce }, /*  152 */
+    { 0x00035a1, 0x9866e89, 0xc9568b2, 0x0294dec, 0x3bfbfb0 }, /*  153 */
+    { 0x0002ae7, 0xad1f207, 0xd4453c1, 0x9baa4bc, 0xfcc995a }, /*  154 */
+    { 0x0002252, 0xf0e5b39, 0x769dc9a, 0xe2eea30, 0xca3ade1 }, /*  155 */
+    { 0x00036eb, 0x1b091f5, 0x8a960f7, 0xd17dd1a, 0xdd2afcf }, /*  156 */
+    { 0x0002bef, 0x48d4191, 0x3bab3f9, 0x7464a7b, 0xe42263f }, /*  157 */
+    { 0x0002325, 0xd3dce0d, 0xc955cc7, 0x9050863, 0x1ce84ff }, /*  158 */
+    { 0x000383c, 0x862e349, 0x4222e0c, 0x1a1a704, 0xfb0d4cc }, /*  159 */
+    { 0x0002cfd, 0x3824f6d, 0xce824d6, 0x7b4859d, 0x95a43d6 }, /*  160 */
+    { 0x00023fd, 0xc683f8b, 0x0b9b711, 0xfc39e17, 0xaae9cab }, /*  161 */
+    { 0x0003996, 0x0a6cc11, 0xac2be83, 0x2d2968c, 0x44a9445 }, /*  162 */
+    { 0x0002e11, 0xa1f09a7, 0xbcefecf, 0x575453d, 0x03ba9d1 }, /*  163 */
+    { 0x00024da, 0xe7f3aec, 0x9726572, 0xac43764, 0x02fbb0e }, /*  164 */
+    { 0x0003af7, 0xd985e47, 0x583d584, 0x46d256c, 0xd192b49 }, /*  165 */
+    { 0x0002f2c, 0xae04b6c, 0x469779d, 0x0575123, 0xdadbc3a }, /*  166 */
+    { 0x00025bd, 0x5803c56, 0x9edf94a, 0x6ac40e9, 0x7be302f }, /*  167 */
+    { 0x0003c62, 0x266c6f0, 0xfe32877, 0x1139b0f, 0x2c9e6b1 }, /*  168 */
+    { 0x000304e, 0x85238c0, 0xcb5b9f8, 0xda948d8, 0xf07ebc1 }, /*  169 */
+    { 0x00026a5, 0x374fa33, 0xd5e2e60, 0xaedd3e0, 0xc065634 }, /*  170 */
+    { 0x0003dd5, 0x254c386, 0x2304a34, 0x4afb967, 0x9a3bd20 }, /*  171 */
+    { 0x0003177, 0x5109c6b, 0x4f36e90, 0x3bfc786, 0x14fca80 }, /*  172 */
+    { 0x0002792, 0xa73b055, 0xd8f8ba6, 0x9663938, 0x10ca200 }, /*  173 */
+    { 0x0003f51, 0x0b91a22, 0xf4c12a4, 0x23d2859, 0xb476999 }, /*  174 */
+    { 0x00032a7, 0x3c7481b, 0xf700ee9, 0xb642047, 0xc392148 }, /*  175 */
+    { 0x0002885, 0xc9f6ce3, 0x2c00bee, 0x2b68039, 0x6941aa0 }, /*  176 */
+    { 0x000206b, 0x07f8a4f, 0x5666ff1, 0xbc53361, 0x210154d }, /*  177 */
+    { 0x00033de, 0x73276e5, 0x570b31c, 0x6085235, 0x019bbae }, /*  178 */
+    { 0x000297e, 0xc285f1d, 0xdf3c27d, 0x1a041c4, 0x0149625 }, /*  179 */
+    { 0x0002132, 0x3537f4b, 0x18fceca, 0x7b367d0, 0x010781d }, /*  180 */
+    { 0x000351d, 0x21f3211, 0xc194add, 0x91f0c80, 0x01a59c8 }, /*  181 */
+    { 0x0002a7d, 0xb4c280e, 0x3476f17, 0xa7f3d33, 0x34847d4 }, /*  182 */
+    { 0x00021fe, 0x2a3533e, 0x905f279, 0x532975c, 0x2a03976 }, /*  183 */
+    { 0x0003663, 0x76bb864, 0x1a31d8e, 0xeb75893, 0x766c256 }, /*  184 */
+    { 0x0002b82, 0xc562d1c, 0xe1c17a5, 0x892ad42, 0xc523512 }, /*  185 */
+    { 0x00022cf, 0x044f0e3, 0xe7cdfb7, 0xa0ef102, 0x374f742 }, /*  186 */
+    { 0x00037b1, 0xa07e7d3, 0x0c7cc59, 0x017e803, 0x8bb2536 }, /*  187 */
+    { 0x0002c8e, 0x19feca8, 0xd6ca37a, 0x6798669, 0x3c8ea91 }, /*  188 */
+    { 0x00023a4, 0xe198a20, 0xabd4f95, 0x1fad1ed, 0xca0bba8 }, /*  189 */
+    { 0x0003907, 0xcf5a9cd, 0xdfbb288, 0x32ae97c, 0x76792a5 }, /*  190 */
+    { 0x0002d9f, 0xd9154a4, 0xb2fc206, 0x8ef2130, 0x5ec7551 }, /*  191 */
+    { 0x000247f, 0xe0ddd50, 0x8f3019e, 0xd8c1a8d, 0x189f774 }, /*  192 */
+    { 0x0003a66, 0x349621a, 0x7eb35ca, 0xf4690e1, 0xc0ff253 }, /*  193 */
+    { 0x0002eb8, 0x2a11b48, 0x655c4a2, 0x5d20d81, 0x6732843 }, /*  194 */
+    { 0x0002560, 0x21a7c39, 0xeab03b5, 0x174d79a, 0xb8f5369 }, /*  195 */
+    { 0x0003bcd, 0x02a605c, 0xaab3921, 0xbee25c4, 0x5b21f0e }, /*  196 */
+    { 0x0002fd7, 0x35519e3, 0xbbc2db4, 0x98b5169, 0xe2818d8 }, /*  197 */
+    { 0x0002645, 0xc4414b6, 0x2fcf15d, 0x46f7454, 0xb534713 }, /*  198 */
+    { 0x0003d3c, 0x6d35456, 0xb2e4efb, 0xa4bed54, 0x5520b52 }, /*  199 */
+    { 0x00030fd, 0x242a9de, 0xf583f2f, 0xb6ff110, 0x441a2a8 }, /*  200 */
+    { 0x0002730, 0xe9bbb18, 0xc4698f2, 0xf8cc0d9, 0xd014eed }, /*  201 */
+    { 0x0003eb4, 0xa92c4f4, 0x6d75b1e, 0x5ae015c, 0x80217e1 }, /*  202 */
+    { 0x000322a, 0x20f03f6, 0xbdf7c18, 0x48b344a, 0x001acb4 }, /*  203 */
+    { 0x0002821, 0xb3f365e, 0xfe5fce0, 0x3a2903b, 0x3348a2a }, /*  204 */
+    { 0x000201a, 0xf65c518, 0xcb7fd80, 0x2e87362, 0x8f6d4ee }, /*  205 */
+    { 0x000335e, 0x56fa1c1, 0x4599599, 0xe40b89d, 0xb2487e3 }, /*  206 */
+    { 0x0002918, 0x4594e34, 0x37ade14, 0xb66fa17, 0xc1d3983 }, /*  207 */
+    { 0x00020e0, 0x37aa4f6, 0x92f1810, 0x91f2e79, 0x67dc79c }, /*  208 */
+    { 0x0003499, 0xf2aa18a, 0x84b59b4, 0x1cb7d8f, 0x0c93f5f }, /*  209 */
+    { 0x0002a14, 0xc221ad5, 0x36f7af6, 0x7d5fe0c, 0x0a0ff80 }, /*  210 */
+    { 0x00021aa, 0x34e7bdd, 0xc592f2b, 0x977fe70, 0x080cc66 }, /*  211 */
+    { 0x00035dd, 0x2172c96, 0x08eb1df, 0x58cca4c, 0xd9ae0a3 }, /*  212 */
+    { 0x0002b17, 0x4df56de, 0x6d88e4c, 0x470a1d7, 0x148b3b6 }, /*  213 */
+    { 0x0002279, 0x0b2abe5, 0x246d83d, 0x05a1b12, 0x76d5c92 }, /*  214 */
+    { 0x0003728, 0x11ddfd5, 0x07159fb, 0x3c35e83, 0xf1560e9 }, /*  215 */
+    { 0x0002c20, 0x0e4b310, 0xd277b2f, 0x635e536, 0x5aab3ed }, /*  216 */
+    { 0x000234c, 0xd83c273, 0xdb92f59, 0x1c4b75e, 0xaeef658 }, /*  217 */
+    { 0x000387a, 0xf39371f, 0xc5b7ef4, 0xfa12564, 0x4b18a26 }, /*  218 */
+    { 0x0002d2f, 0x2942c19, 0x6af98c3, 0xfb41de9, 0xd5ad4eb }, /*  219 */
+    { 0x0002425, 0xba9bce1, 0x22613cf, 0xfc34b21, 0x77bdd89 }, /*  220 */
+    { 0x00039d5, 0xf75fb01, 0xd09b94c, 0xc6bab68, 0xbf96274 }, /*  221 */
+    { 0x0002e44, 0xc5e6267, 0xda1610a, 0x38955ed, 0x6611b90 }, /*  222 */
+    { 0x0002503, 0xd184eb9, 0x7b44da1, 0xc6dde57, 0x84dafa7 }, /*  223 */
+    { 0x0003b39, 0x4f3b128, 0xc53af69, 0x3e2fd58, 0xd49190b }, /*  224 */
+    { 0x0002f61, 0x0c2f420, 0x9dc8c54, 0x31bfde0, 0xaa0e0d5 }, /*  225 */
+    { 0x00025e7, 0x3cf29b3, 0xb16d6a9, 0xc1664b3, 0xbb3e711 }, /*  226 */
+    { 0x0003ca5, 0x2e50f85, 0xe8af10f, 0x9bd6dec, 0x5eca4e8 }, /*  227 */
+    { 0x0003084, 0x250d937, 0xed58da6, 0x16457f0, 0x4bd50ba }, /*  228 */
+    { 0x00026d0, 0x1da475f, 0xf113e1e, 0x783798d, 0x09773c8 }, /*  229 */
+    { 0x0003e19, 0xc907233, 0x1b53030, 0xc058f48, 0x0f252d9 }, /*  230 */
+    { 0x00031ae, 0x3a6c1c2, 0x7c4268d, 0x66ad906, 0x7284247 }, /*  231 */
+    { 0x00027be, 0x952349b, 0x969b871, 0x1ef1405, 0x2869b6c }, /*  232 */
+    { 0x0003f97, 0x550542c, 0x242c0b4, 0xfe4ecd5, 0x0d75f14 }, /*  233 */
+    { 0x00032df, 0x7737689, 0xb689a2a, 0x650bd77, 0x3df7f43 }, /*  234 */
+    { 0x00028b2, 0xc5c5ed4, 0x9207b55, 0x1da312c, 0x319329c }, /*  235 */
+    { 0x000208f, 0x049e576, 0xdb395dd, 0xb14f423, 0x5adc217 }, /*  236 */
+    { 0x0003418, 0x0763bf1, 0x5ec22fc, 0x4ee536b, 0xc49368a }, /*  237 */
+    { 0x00029ac, 0xd2b6327, 0x7f01bfd, 0x0bea923, 0x03a9208 }, /*  238 */
+    { 0x0002157, 0x0ef8285, 0xff34997, 0x3cbba82, 0x69541a0 }, /*  239 */
+    { 0x0003558, 0x17f373c, 0xcb875be, 0xc792a6a, 0x422029a }, /*  240 */
+    { 0x0002aac, 0xdff5f63, 0xd605e32, 0x39421ee, 0x9b4cee1 }, /*  241 */
+    { 0x0002223, 0xe65e5e9, 0x7804b5b, 0x6101b25, 0x490a581 }, /*  242 */
+    { 0x000369f, 0xd6fd642, 0x59a122b, 0xce691d5, 0x41aa268 }, /*  243 */
+    { 0x0002bb3, 0x1264501, 0xe14db56, 0x3eba7dd, 0xce21b87 }, /*  244 */
+    { 0x00022f5, 0xa850401, 0x810af78, 0x322ecb1, 0x71b4939 }, /*  245 */
+    { 0x00037ef, 0x73b399c, 0x01ab259, 0xe9e4782, 0x4f87527 }, /*  246 */
+    { 0x0002cbf, 0x8fc2e16, 0x67bc1e1, 0x87e9f9b, 0x72d2a86 }, /*  247 */
+    { 0x00023cc, 0x73024de, 0xb9634b4, 0x6cbb2e2, 0xc242205 }, /*  248 */
+    { 0x0003947, 0x1e6a164, 0x5bd2120, 0xadf849e, 0x039d007 }, /*  249 */
+    { 0x0002dd2, 0x7ebb450, 0x4974db3, 0xbe603b1, 0x9c7d99f }, /*  250 */
+    { 0x00024a8, 0x65629d9, 0xd45d7c2, 0xfeb3627, 0xb0647b3 }, /*  251 */
+    { 0x0003aa7, 0x089dc8f, 0xba2f2d1, 0x97856a5, 0xe7072b8 }, /*  252 */
+    { 0x0002eec, 0x06e4a0c, 0x94f28a7, 0xac6abb7, 0xec05bc6 }, /*  253 */
+    { 0x0002589, 0x9f1d4d6, 0xdd8ed52, 0xf05562c, 0xbcd1638 }, /*  254 */
+    { 0x0003c0f, 0x64fbaf1, 0x627e21e, 0x4d556ad, 0xfae89f3 }, /*  255 */
+    { 0x000300c, 0x50c958d, 0xe864e7e, 0xa444557, 0xfbed4c3 }, /*  256 */
+    { 0x0002670, 0x40a113e, 0x5383ecb, 0xb69d113, 0x2ff109c }, /*  257 */
+    { 0x0003d80, 0x67681fd, 0x526cadf, 0x8a94e85, 0x1981a93 }, /*  258 */
+    { 0x0003133, 0x85ece64, 0x41f08b2, 0xd543ed0, 0xe134875 }, /*  259 */
+    { 0x000275c, 0x6b23eb6, 0x9b26d5b, 0xddcff0d, 0x80f6d2b }, /*  260 */
+    { 0x0003efa, 0x4506457, 0x5ea4892, 0xfc7fe7c, 0x018aeab }, /*  261 */
+    { 0x0003261, 0xd0d1d12, 0xb21d3a8, 0xc9ffec9, 0x9ad5889 }, /*  262 */
+    { 0x000284e, 0x40a7da8, 0x8e7dc87, 0x07fff07, 0xaf113a1 }, /*  263 */
+    { 0x000203e, 0x9a1fe20, 0x71fe39f, 0x39998d2, 0xf2742e7 }, /*  264 */
+    { 0x0003397, 0x5cffd00, 0xb6638fe, 0xc28f484, 0xb7204a4 }, /*  265 */
+    { 0x0002945, 0xe3ffd9a, 0x2b82d98, 0x9ba5d36, 0xf8e6a1d }, /*  266 */
+    { 0x0002104, 0xb66647b, 0x560247a, 0x161e42b, 0xfa521b1 }, /*  267 */
+    { 0x00034d4, 0x570a0c5, 0x566a0c3, 0x5696d13, 0x2a1cf81 }, /*  268 */
+    { 0x0002a43, 0x78d4d6a, 0xab8809c, 0x4545742, 0x88172ce }, /*  269 */
+    { 0x00021cf, 0x93dd788, 0x8939a16, 0x9dd129b, 0xa0128a5 }, /*  270 */
+    { 0x0003618, 0xec958da, 0x7529024, 0x2fb50f9, 0x001daa1 }, /*  271 */
+    { 0x0002b47, 0x23aad7b, 0x90ed9b6, 0x8c90d94, 0x0017bb4 }, /*  272 */
+    { 0x000229f, 0x4fbbdfc, 0x73f1492, 0x0a0d7a9, 0x99ac95d }, /*  273 */
+    { 0x0003765, 0x4c5fcc7, 0x1fe8750, 0x101590f, 0x5c47561 }, /*  274 */
+    { 0x0002c51, 0x09e63d2, 0x7fed2a6, 0x734473f, 0x7d05de8 }, /*  275 */
+    { 0x0002374, 0x07eb641, 0xfff0eeb, 0x8f69f65, 0xfd9e4b9 }, /*  276 */
+    { 0x00038b9, 0xa6456cf, 0xffe7e45, 0xb24323c, 0xc8fd45c }, /*  277 */
+    { 0x0002d61, 0x51d123f, 0xffecb6a, 0xf502830, 0xa0ca9e3 }, /*  278 */
+    { 0x000244d, 0xdb0db66, 0x6656f88, 0xc402026, 0xe7087e9 }, /*  279 */
+    { 0x0003a16, 0x2b4923d, 0x708b274, 0x6cd003e, 0x3e73fdb }, /*  280 */
+    { 0x0002e78, 0x22a0e97, 0x8d3c1f6, 0xbd73364, 0xfec3315 }, /*  281 */
+    { 0x000252c, 0xe880bac, 0x70fce5e, 0xfdf5c50, 0xcbcf5ab }, /*  282 */
+    { 0x0003b7b, 0x0d9ac47, 0x1b2e3cb, 0x2fefa1a, 0xdfb22ab }, /*  283 */
+    { 0x0002f95, 0xa47bd05, 0xaf58308, 0xf3261af, 0x195b555 }, /*  284 */
+    { 0x0002611, 0x50630d1, 0x59135a0, 0xc284e25, 0xade2aab }, /*  285 */
+    { 0x0003ce8, 0x809e7b5, 0x5b5229a, 0xd0d49d5, 0xe304444 }, /*  286 */
+    { 0x00030ba, 0x007ec91, 0x15db548, 0xa7107de, 0x4f369d0 }, /*  287 */
+    { 0x00026fb, 0x3398a0d, 0xab15dd3, 0xb8d9fe5, 0x0c2bb0d }, /*  288 */
+    { 0x0003e5e, 0xb8f4349, 0x11bc952, 0xc15cca1, 0xad12b48 }, /*  289 */
+    { 0x00031e5, 0x60c35d4, 0x0e30775, 0x677d6e7, 0xbda8906 }, /*  290 */
+    { 0x00027ea, 0xb3cf7dc, 0xd826c5d, 0xec64586, 0x3153a6c }, /*  291 */
+    { 0x0003fdd, 0xec7f2fa, 0xf3713c9, 0x7a3a270, 0x4eec3df }, /*  292 */
+    { 0x0003317, 0xf065bfb, 0xf5f4307, 0x94fb526, 0xa589cb3 }, /*  293 */
+    { 0x00028df, 0xf384996, 0x5e5cf39, 0x43fc41e, 0xead4a29 }, /*  294 */
+    { 0x00020b3, 0x2936e11, 0xe517294, 0x366367f, 0x2243b54 }, /*  295 */
+    { 0x0003451, 0xdb8b01c, 0xa1bea86, 0xbd6bd98, 0x36d2bb9 }, /*  296 */
+    { 0x00029db, 0x1608ce3, 0xb49886b, 0xcabcae0, 0x2bdbc94 }, /*  297 */
+    { 0x000217c, 0x11a0a4f, 0xc3ad389, 0x6efd580, 0x23163aa }, /*  298 */
+    { 0x0003593, 0x4f676e6, 0x05e1f42, 0x4b2ef33, 0x6b56c43 }, /*  299 */
+    { 0x0002adc, 0x3f85f1e, 0x6b1b29b, 0x6f58c29, 0x22abd02 }, /*  300 */
+    { 0x0002249, 0xcc6b27e, 0xbc15baf, 0x8c47020, 0xe889735 }, /*  301 */
+    { 0x00036dc, 0x7a450ca, 0xc6892b2, 0x7a0b367, 0xda75855 }, /*  302 */
+    { 0x0002be3, 0x95040a2, 0x386dbc1, 0xfb3c2b9, 0x7b91377 }, /*  303 */
+    { 0x000231c, 0x77366e8, 0x2d24967, 0xfc3022d, 0xfc742c6 }, /*  304 */
+    { 0x000382d, 0x8b8a4a6, 0xaea0f0c, 0xc6b36af, 0xfa537a2 }, /*  305 */
+    { 0x0002cf1, 0x3c6ea1e, 0xf21a5a3, 0xd229226, 0x61dc61c }, /*  306 */
+    { 0x00023f4, 0x3058818, 0xc1aeae9, 0x74edb51, 0xe7e3816 }, /*  307 */
+    { 0x0003986, 0xb3c0cf4, 0x69177db, 0xee4921c, 0xa638cf0 }, /*  308 */
+    { 0x0002e05, 0x5c9a3f6, 0xba79316, 0x583a816, 0xeb60a5a }, /*  309 */
+    { 0x00024d1, 0x16e1cc5, 0x61fa8de, 0xacfb9ab, 0xef80848 }, /*  310 */
+    { 0x0003ae8, 0x249c7a2, 0x365dafd, 0xe192913, 0x18cda0c }, /*  311 */
+    { 0x0002f20, 0x1d49fb4, 0xf84af31, 0x81420dc, 0x13d7b3d }, /*  312 */
+    { 0x00025b3, 0x4aa195d, 0x936f28e, 0x0101a49, 0xa9795cb }, /*  313 */
+    { 0x0003c52, 0x1102895, 0xb8b1db0, 0x019c3a9, 0x0f28944 }, /*  314 */
+    { 0x0003041, 0xa7353aa, 0xfa27e26, 0x67b02ed, 0xa5ba103 }, /*  315 */
+    { 0x000269a, 0xec2a955, 0x94ecb51, 0xec8cf24, 0x8494d9c }, /*  316 */
+    { 0x0003dc4, 0xad10eef, 0x54adee9, 0x7a7b1d4, 0x07548fa }, /*  317 */
+    { 0x000316a, 0x240d8bf, 0x76f18ba, 0xc8627dc, 0xd2aa0c8 }, /*  318 */
+    { 0x0002788, 0x1cd7a32, 0xc58e095, 0x6d1b97d, 0x7554d6d }, /*  319 */
+    { 0x0003f40, 0x2e25d1e, 0x08e3422, 0x482c262, 0x55548ae }, /*  320 */
+    { 0x0003299, 0xbe84a7e, 0x6d829b5, 0x0689b81, 0xdddd3be }, /*  321 */
+    { 0x000287a, 0xfed0865, 0x24687c4, 0x053af9b, 0x17e42ff }, /*  322 */
+    { 0x0002062, 0x65739ea, 0x8386c9c, 0xd0fbfaf, 0x4650265 }, /*  323 */
+    { 0x00033d0, 0xa252977, 0x38d7a94, 0x81932b2, 0x0a19d6f }, /*  324 */
+    { 0x0002973, 0xb50edf8, 0xfa46210, 0x67a8ef4, 0xd4e178c }, /*  325 */
+    { 0x0002129, 0x5da57fa, 0x61d1b40, 0x52ed8c3, 0xdd812d6 }, /*  326 */
+    { 0x000350e, 0xfc3bff7, 0x02e9200, 0x84af46c, 0x959b7bd }, /*  327 */
+    { 0x0002a72, 0x636332c, 0x025419a, 0x03bf6bd, 0x447c631 }, /*  328 */
+    { 0x00021f5, 0x1c4f5bc, 0xcea9ae1, 0x9c99231, 0x0396b5b }, /*  329 */
+    { 0x0003654, 0xfa1892e, 0x1775e35, 0xc75b6b4, 0xd28abc4 }, /*  330 */
+    { 0x0002b77, 0x2e7a0f1, 0xac5e4f7, 0xd2af890, 0xa86efd0 }, /*  331 */
+    { 0x00022c5, 0xbec80c1, 0x56b1d93, 0x0ef2d40, 0x86bf30d }, /*  332 */
+    { 0x00037a2, 0xcad9ace, 0xf11c8eb, 0x4b1e200, 0xd7984e1 }, /*  333 */
+    { 0x0002c82, 0x3be1572, 0x5a7d3ef, 0x6f4b4cd, 0x7946a4e }, /*  334 */
+    { 0x000239b, 0x631aac1, 0xe1fdcbf, 0x8c3c3d7, 0x943883e }, /*  335 */
+    { 0x00038f8, 0x9e91136, 0x3662dff, 0x46c6c8c, 0x205a6ca }, /*  336 */
+    { 0x0002d93, 0xb20da91, 0xc51be65, 0xd238a09, 0xb37b8a2 }, /*  337 */
+    { 0x0002476, 0x280aedb, 0x041651e, 0x41c6e6e, 0x292fa1b }, /*  338 */
+    { 0x0003a56, 0xa677e2b, 0x39bd4fd, 0x360b0b0, 0x41e5cf8 }, /*  339 */
+    { 0x0002eab, 0xb85fe88, 0xfafdd97, 0x5e6f3c0, 0x34b7d93 }, /*  340 */
+    { 0x0002556, 0x2d1986d, 0x9597e12, 0xb1f2966, 0x9093142 }  /*  341 */
+};
+
+/*
+ * Characteristics of the IEEE754 binary formats for the conversions (the
+ * decimal limits are the decimal exponents of values of the form 0.ddd at
+ * or beyond which the conversion result is always zero or infinity).
+ */
+typedef struct JEM_FloatFormat {
+    jint precision;
+    jint maxExponent;
+    jint tinyLimit;
+    jint minDecimal;
+    jint maxDecimal;
+} JEM_FloatFormat;
+
+static JEM_FloatFormat doubleFormat = { 53, 1023, 3, -324, 310 };
+static JEM_FloatFormat floatFormat = { 24, 127, 8, -46, 40 };
+
+/* Minimum (subnormal) binary exponent of the integral significand c*2^q */
+#define FORMAT_MIN_Q(fmt) (2 - (fmt)->maxExponent - (fmt)->precision)
+
+/* Raw bits for the positive infinity of the format */
+#define FORMAT_INFINITY(fmt) \
+    (((jlong) (2 * (fmt)->maxExponent + 1)) << ((fmt)->precision - 1))
+
+/* floor(q * log10(2)) */
+static jint floorLog10Pow2(jint q) {
+    return (jint) ((q * ((jlong) 661971961083)) >> 41);
+}
+
+/* floor(log10(3/4 * 2^q)) */
+static jint floorLog10ThreeQuartersPow2(jint q) {
+    return (jint) ((q * ((jlong) 661971961083) -
+                                   ((jlong) 274743187321)) >> 41);
+}
+
+/* floor(e * log2(10)) */
+static jint floorLog2Pow10(jint e) {
+    return (jint) ((e * ((jlong) 913124641741)) >> 38);
+}
+
+/**
+ * Multiply the 126-bit table power by the (at most 60-bit) value, producing
+ * the eight limb product (least significant limb first).
+ */
+static void multiplyPow10(juint *pow10, jlong val, juint *prod) {
+    jlong v0, v1, v2, acc;
+
+    v0 = val & LIMB_MASK;
+    v1 = (val >> LIMB_BITS) & LIMB_MASK;
+    v2 = val >> (2 * LIMB_BITS);
+    acc = v0 * pow10[4];
+    prod[0] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + v0 * pow10[3] + v1 * pow10[4];
+    prod[1] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + v0 * pow10[2] + v1 * pow10[3] + v2 * pow10[4];
+    prod[2] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + v0 * pow10[1] + v1 * pow10[2] + v2 * pow10[3];
+    prod[3] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + v0 * pow10[0] + v1 * pow10[1] + v2 * pow10[2];
+    prod[4] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + v1 * pow10[0] + v2 * pow10[1];
+    prod[5] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + v2 * pow10[0];
+    prod[6] = (juint) (acc & LIMB_MASK);
+    prod[7] = (juint) (acc >> LIMB_BITS);
+}
+
+/**
+ * Multiply the three limb value by the (at most 60-bit) operand, producing
+ * the six limb product (all least significant limb first).
+ */
+static void multiplyLimbs(juint *val, jlong op, juint *prod) {
+    jlong o0, o1, o2, acc;
+
+    o0 = op & LIMB_MASK;
+    o1 = (op >> LIMB_BITS) & LIMB_MASK;
+    o2 = op >> (2 * LIMB_BITS);
+    acc = o0 * val[0];
+    prod[0] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + o0 * val[1] + o1 * val[0];
+    prod[1] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + o0 * val[2] + o1 * val[1] + o2 * val[0];
+    prod[2] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + o1 * val[2] + o2 * val[1];
+    prod[3] = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + o2 * val[2];
+    prod[4] = (juint) (acc & LIMB_MASK);
+    prod[5] = (juint) (acc >> LIMB_BITS);
+}
+
+/**
+ * Compute the (scaled) value g * cp / 2^127, truncated with the lowest bit
+ * forced on when inexact (the round-to-odd 'rop' operation of Schubfach).
+ * Note that this must exactly follow the reference formulation, with g
+ * split into 63-bit halves (g1 * 2^63 + g0) and the low product of g0
+ * discarded, which is what yields exact results for the (overestimated)
+ * integral powers of ten.
+ */
+static jlong roundToOdd(juint *g0, juint *g1, jlong cp) {
+    juint p0[6], p1[6];
+    jlong acc, vb;
+    juint w;
+
+    multiplyLimbs(g0, cp, p0);
+    multiplyLimbs(g1, cp, p1);
+
+    /* Sum floor(g1 * cp / 2) + floor(g0 * cp / 2^64), 2^63 is the unit */
+    acc = (p1[0] >> 1) | ((p1[1] << 27) & LIMB_MASK);
+    acc += (p0[2] >> 8) | ((p0[3] << 20) & LIMB_MASK);
+    w = (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + ((p1[1] >> 1) | ((p1[2] << 27) & LIMB_MASK));
+    acc += (p0[3] >> 8) | ((p0[4] << 20) & LIMB_MASK);
+    w |= (juint) (acc & LIMB_MASK);
+    acc = (acc >> LIMB_BITS) + ((p1[2] >> 1) | ((p1[3] << 27) & LIMB_MASK));
+    acc += (p0[4] >> 8) | ((p0[5] << 20) & LIMB_MASK);
+    w |= (juint) (acc & 0x7F);
+    vb = (acc & LIMB_MASK) >> 7;
+    acc = (acc >> LIMB_BITS) + ((p1[3] >> 1) | ((p1[4] << 27) & LIMB_MASK));
+    acc += p0[5] >> 8;
+    vb += (acc & LIMB_MASK) << 21;
+    acc = (acc >> LIMB_BITS) + ((p1[4] >> 1) | ((p1[5] << 27) & LIMB_MASK));
+    vb += acc << 49;
+
+    return (w != 0) ? (vb | 1) : vb;
+}
+
+/**
+ * Determine the shortest decimal f * 10^e which rounds back to the binary
+ * value c * 2^q, choosing the closest such decimal (even on ties).  The dk
+ * adjustment accounts for the pre-scaling of the smallest subnormals.
+ */
+static void shortestDecimal(JEM_FloatFormat *fmt, jint q, jlong c, jint dk,
+                            jlong *fVal, jint *eVal) {
+    jlong cb, cbl, cbr, vb, vbl, vbr, s, t, sp10, tp10, cmp;
+    juint *pow10, g0[3], g1[3];
+    jboolean uin, win;
+    jint k, h;
+    int out;
+
+    /* Compute the scaled rounding interval boundaries */
+    out = (int) (c & 1);
+    cb = c << 2;
+    cbr = cb + 2;
+    if ((c != (((jlong) 1) << (fmt->precision - 1))) ||
+                                        (q == FORMAT_MIN_Q(fmt))) {
+        cbl = cb - 2;
+        k = floorLog10Pow2(q);
+    } else {
+        /* Closer lower neighbour at the power of two boundary */
+        cbl = cb - 1;
+        k = floorLog10ThreeQuartersPow2(q);
+    }
+    h = q + floorLog2Pow10(-k) + 2;
+
+    /* Split g (most significant limb first) into the 63-bit halves */
+    pow10 = pow10Table[k - POW10_MIN_K];
+    g0[0] = pow10[4];
+    g0[1] = pow10[3];
+    g0[2] = pow10[2] & 0x7F;
+    g1[0] = ((pow10[2] >> 7) | (pow10[1] << 21)) & LIMB_MASK;
+    g1[1] = ((pow10[1] >> 7) | (pow10[0] << 21)) & LIMB_MASK;
+    g1[2] = pow10[0] >> 7;
+    vb = roundToOdd(g0, g1, cb << h);
+    vbl = roundToOdd(g0, g1, cbl << h);
+    vbr = roundToOdd(g0, g1, cbr << h);
+
+    /* Try for one digit less than the scaled value first */
+    s = vb >> 2;
+    if (s >= 100) {
+        sp10 = (s / 10) * 10;
+        tp10 = sp10 + 10;
+        uin = (vbl + out <= (sp10 << 2)) ? JNI_TRUE : JNI_FALSE;
+        win = ((tp10 << 2) + out <= vbr) ? JNI_TRUE : JNI_FALSE;
+        if (uin != win) {
+            *fVal = (uin == JNI_TRUE) ? sp10 : tp10;
+            *eVal = k;
+            return;
+        }
+    }
+
+    /* Otherwise, one of the neighbours (closest) of the scaled value */
+    t = s + 1;
+    uin = (vbl + out <= (s << 2)) ? JNI_TRUE : JNI_FALSE;
+    win = ((t << 2) + out <= vbr) ? JNI_TRUE : JNI_FALSE;
+    *eVal = k + dk;
+    if (uin != win) {
+        *fVal = (uin == JNI_TRUE) ? s : t;
+        return;
+    }
+    cmp = vb - ((s + t) << 1);
+    *fVal = ((cmp < 0) || ((cmp == 0) && ((s & 1) == 0))) ? s : t;
+}
+
+/**
+ * Write the decimal f * 10^e in the Double/Float.toString() layout (plain
+ * notation for magnitudes from 10^-3 up to 10^7, computerized scientific
+ * notation otherwise).
+ */
+static void writeJavaDecimal(jlong f, jint e, char *buff) {
+    char digitBuff[20];
+    int len, exp, i;
+
+    /* Obtain the digits, now representing 0.ddd * 10^exp */
+    len = writeLongDecimal(f, digitBuff) - digitBuff;
+    exp = e + len;
+    while ((len > 1) && (digitBuff[len - 1] == '0')) len--;
+
+    if ((exp > 0) && (exp <= 7)) {
+        if (len <= exp) {
+            (void) memcpy(buff, digitBuff, len);
+            buff += len;
+            for (i = len; i < exp; i++) *(buff++) = '0';
+            *(buff++) = '.';
+            *(buff++) = '0';
+        } else {
+            (void) memcpy(buff, digitBuff, exp);
+            buff += exp;
+            *(buff++) = '.';
+            (void) memcpy(buff, digitBuff + exp, len - exp);
+            buff += len - exp;
+        }
+    } else if ((exp > -3) && (exp <= 0)) {
+        *(buff++) = '0';
+        *(buff++) = '.';
+        for (i = exp; i < 0; i++) *(buff++) = '0';
+        (void) memcpy(buff, digitBuff, len);
+        buff += len;
+    } else {
+        *(buff++) = digitBuff[0];
+        *(buff++) = '.';
+        if (len > 1) {
+            (void) memcpy(buff, digitBuff + 1, len - 1);
+            buff += len - 1;
+        } else {
+            *(buff++) = '0';
+        }
+        *(buff++) = 'E';
+        if (--exp < 0) {
+            *(buff++) = '-';
+            exp = -exp;
+        }
+        len = decimalLength((juint) exp);
+        writeDecimal((juint) exp, buff + len, len);
+        buff += len;
+    }
+    *buff = '\0';
+}
+
+/**
+ * Common formatting of finite, non-negative binary values, from the biased
+ * exponent and the fraction bits of the format.
+ */
+static void writeBinaryValue(JEM_FloatFormat *fmt, jint bq, jlong t,
+                             char *buff) {
+    jint mq, e;
+    jlong c, f;
+
+    if (bq != 0) {
+        /* Normal value, small integers are directly represented */
+        mq = 1 - FORMAT_MIN_Q(fmt) - bq;
+        c = (((jlong) 1) << (fmt->precision - 1)) | t;
+        if ((mq > 0) && (mq < fmt->precision)) {
+            f = c >> mq;
+            if ((f << mq) == c) {
+                writeJavaDecimal(f, 0, buff);
+                return;
+            }
+        }
+        shortestDecimal(fmt, -mq, c, 0, &f, &e);
+    } else if (t != 0) {
+        /* Subnormal, the very smallest require an additional digit */
+        if (t < fmt->tinyLimit) {
+            shortestDecimal(fmt, FORMAT_MIN_Q(fmt), 10 * t, -1, &f, &e);
+        } else {
+            shortestDecimal(fmt, FORMAT_MIN_Q(fmt), t, 0, &f, &e);
+        }
+    } else {
+        (void) strcpy(buff, "0.0");
+        return;
+    }
+    writeJavaDecimal(f, e, buff);
+}
+
 /**
  * Convert a float value into a character representation (for textual
  * output, for example).  Follows the ruleset and is essentially the same
@@ -119,25 +1207,26 @@ void JEMCC_LongToText(jlong val, jint radix, char *buff) {
  *
  * Parameters:
  *    val - the value to be converted to text
- *    buff - the character buffer to write into
+ *    buff - the character buffer to write into (at most 16 characters are
+ *           written, including the terminator)
  */
 void JEMCC_FloatToText(jfloat val, char *buff) {
-    char *ptr;
-    int foundDec;
-
-    /* TODO - follow the JLS for representation modes */
-    (void) sprintf(buff, "%f", val);
+    union {
+        jfloat fval;
+        jint bits;
+    } conv;
+    jint bq, t;
 
-    /* Trim trailing precision zeros (rough approximation) */
-    ptr = buff;
-    foundDec = 0;
-    while (*ptr != '\0') {
-        if (*(ptr++) == '.') foundDec = 1;
-    }
-    if (foundDec != 0) {
-        ptr--;
-        while ((*ptr == '0') && (*(ptr - 1) != '.')) *(ptr--) = '\0';
+    conv.fval = val;
+    bq = (conv.bits >> 23) & 0xFF;
+    t = conv.bits & 0x7FFFFF;
+    if (bq == 0xFF) {
+        if (t != 0) (void) strcpy(buff, "NaN");
+        else (void) strcpy(buff, (conv.bits < 0) ? "-Infinity" : "Infinity");
+        return;
     }
+    if (conv.bits < 0) *(buff++) = '-';
+    writeBinaryValue(&floatFormat, bq, t, buff);
 }
 
 /**
@@ -147,23 +1236,503 @@ void JEMCC_FloatToText(jfloat val, char *buff) {
  *
  * Parameters:
  *    val - the value to be converted to text
- *    buff - the character buffer to write into
+ *    buff - the character buffer to write into (at most 25 characters are
+ *           written, including the terminator)
  */
 void JEMCC_DoubleToText(jdouble val, char *buff) {
-    char *ptr;
-    int foundDec;
+    union {
+        jdouble dval;
+        jlong bits;
+    } conv;
+    jlong t;
+    jint bq;
+
+    conv.dval = val;
+    bq = (jint) ((conv.bits >> 52) & 0x7FF);
+    t = conv.bits & ((((jlong) 1) << 52) - 1);
+    if (bq == 0x7FF) {
+        if (t != 0) (void) strcpy(buff, "NaN");
+        else (void) strcpy(buff, (conv.bits < 0) ? "-Infinity" : "Infinity");
+        return;
+    }
+    if (conv.bits < 0) *(buff++) = '-';
+    writeBinaryValue(&doubleFormat, bq, t, buff);
+}
+
+/* Significant decimal digits directly collected for the parse mantissa */
+#define MANTISSA_DIGITS 18
+
+/*
+ * Significant digits retained for exact (big number) resolution, beyond
+ * which only the presence of non-zero digits can affect the rounding.
+ */
+#define EXACT_DIGITS 768
 
-    /* TODO - follow the JLS for representation modes */
-    (void) sprintf(buff, "%f", val);
+/* Limb capacity for the exact comparisons (over 10^1100 * 2^54) */
+#define BIGNUM_LIMBS 140
 
-    /* Trim trailing precision zeros (rough approximation) */
-    ptr = buff;
-    foundDec = 0;
-    while (*ptr != '\0') {
-        if (*(ptr++) == '.') foundDec = 1;
+typedef struct JEM_BigNum {
+    jint length;
+    juint limbs[BIGNUM_LIMBS];
+} JEM_BigNum;
+
+/* Details of the decimal text, for the slow path of the conversion */
+typedef struct JEM_DecimalText {
+    const char *digits;
+    jint digitCount;
+    jint exponent;
+} JEM_DecimalText;
+
+/* Multiply the big number by the (28-bit) value and add the (28-bit) sum */
+static void bigMulAdd(JEM_BigNum *num, juint mul, juint add) {
+    jlong acc = add;
+    jint i;
+
+    for (i = 0; i < num->length; i++) {
+        acc += ((jlong) num->limbs[i]) * mul;
+        num->limbs[i] = (juint) (acc & LIMB_MASK);
+        acc = acc >> LIMB_BITS;
+    }
+    if (acc != 0) num->limbs[num->length++] = (juint) acc;
+}
+
+/* Multiply the big number by the given power of ten */
+static void bigMulPow10(JEM_BigNum *num, jint exp) {
+    juint mul = 1;
+
+    while (exp >= 8) {
+        bigMulAdd(num, 100000000, 0);
+        exp -= 8;
+    }
+    while (exp-- > 0) mul *= 10;
+    if (mul != 1) bigMulAdd(num, mul, 0);
+}
+
+/* Multiply the big number by the given power of two */
+static void bigShiftLeft(JEM_BigNum *num, jint bits) {
+    jint limbShift = bits / LIMB_BITS, bitShift = bits % LIMB_BITS, i;
+
+    if (num->length == 0) return;
+    num->limbs[num->length] = 0;
+    for (i = num->length; i >= 0; i--) {
+        num->limbs[i + limbShift] = (num->limbs[i] << bitShift) & LIMB_MASK;
+        if (i > 0) {
+            num->limbs[i + limbShift] |=
+                         num->limbs[i - 1] >> (LIMB_BITS - bitShift);
+        }
+    }
+    for (i = 0; i < limbShift; i++) num->limbs[i] = 0;
+    num->length += limbShift + 1;
+    if (num->limbs[num->length - 1] == 0) num->length--;
+}
+
+/* Compare two (normalized) big numbers, returning <0, 0 or >0 as usual */
+static int bigCompare(JEM_BigNum *a, JEM_BigNum *b) {
+    jint i;
+
+    if (a->length != b->length) return (a->length < b->length) ? -1 : 1;
+    for (i = a->length - 1; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i]) {
+            return (a->limbs[i] < b->limbs[i]) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Round the binary value x * 2^r (x being an unsigned number of the given
+ * number of 28-bit limbs, least significant first) to the nearest value
+ * (ties to even) in the floating point format, returning the raw bits.
+ */
+static jlong roundBinary(JEM_FloatFormat *fmt, juint *x, jint limbCount,
+                         jint r) {
+    jint i, nb, e, prec, bits, take, minExp = 1 - fmt->maxExponent;
+    juint top, sticky = 0;
+    jlong q;
+
+    /* Locate the leading bit, to determine the available precision */
+    for (i = limbCount - 1; (i >= 0) && (x[i] == 0); i--);
+    if (i < 0) return 0;
+    top = x[i];
+    bits = 1;
+    if (top >= 0x4000) {
+        bits += 14;
+        top >>= 14;
+    }
+    if (top >= 0x80) {
+        bits += 7;
+        top >>= 7;
     }
-    if (foundDec != 0) {
-        ptr--;
-        while ((*ptr == '0') && (*(ptr - 1) != '.')) *(ptr--) = '\0';
+    while (top > 1) {
+        bits++;
+        top >>= 1;
+    }
+    nb = i * LIMB_BITS + bits;
+    e = nb - 1 + r;
+    prec = fmt->precision;
+    if (e < minExp) {
+        prec -= minExp - e;
+        if (prec < 0) return 0;
+    }
+
+    /* Gather the significand and round bit, the remainder being sticky */
+    q = x[i];
+    while ((bits <= prec) && (--i >= 0)) {
+        take = prec + 1 - bits;
+        if (take > LIMB_BITS) take = LIMB_BITS;
+        q = (q << take) | (x[i] >> (LIMB_BITS - take));
+        sticky |= x[i] & ((((juint) 1) << (LIMB_BITS - take)) - 1);
+        bits += take;
     }
+    if (bits <= prec) {
+        q = q << (prec + 1 - bits);
+    } else if (bits > prec + 1) {
+        if ((q & ((((jlong) 1) << (bits - prec - 1)) - 1)) != 0) sticky = 1;
+        q = q >> (bits - prec - 1);
+    }
+    while ((sticky == 0) && (--i >= 0)) sticky = x[i];
+    if (((q & 1) != 0) && ((sticky != 0) || ((q & 2) != 0))) q += 2;
+    q = q >> 1;
+
+    /* Subnormal results carry naturally into the minimum normal value */
+    if (e < minExp) return q;
+    if (q == (((jlong) 1) << prec)) {
+        q = q >> 1;
+        e++;
+    }
+    if (e > fmt->maxExponent) return FORMAT_INFINITY(fmt);
+
+    return (((jlong) (e + fmt->maxExponent)) << (prec - 1)) |
+                             (q & ((((jlong) 1) << (prec - 1)) - 1));
+}
+
+/**
+ * Determine the correct rounding of the decimal text by exact comparison
+ * with the midpoints of the candidate values, from the lower bound up to
+ * (at most) the upper bound.
+ */
+static jlong resolveDecimal(JEM_FloatFormat *fmt, JEM_DecimalText *dec,
+                            jlong lower, jlong upper) {
+    jint count, chunkCount, exp, bexp, mantBits = fmt->precision - 1;
+    JEM_BigNum num, a, b;
+    juint chunk, chunkMul;
+    const char *ptr;
+    jlong mid;
+
+    /* Build the (abbreviated) digits as a big number */
+    num.length = 0;
+    exp = dec->exponent;
+    chunk = 0;
+    chunkCount = 0;
+    chunkMul = 1;
+    for (ptr = dec->digits, count = 0; count < dec->digitCount; ptr++) {
+        if (*ptr == '.') continue;
+        if (count == EXACT_DIGITS) {
+            /* Any trailing non-zero digit simply lands beyond a midpoint */
+            exp += dec->digitCount - count;
+            for (; count < dec->digitCount; ptr++) {
+                if (*ptr == '.') continue;
+                if (*ptr != '0') {
+                    chunk = chunk * 10 + 1;
+                    chunkMul *= 10;
+                    exp--;
+                    break;
+                }
+                count++;
+            }
+            break;
+        }
+        chunk = chunk * 10 + (*ptr - '0');
+        chunkMul *= 10;
+        count++;
+        if (++chunkCount == 8) {
+            bigMulAdd(&num, chunkMul, chunk);
+            chunk = 0;
+            chunkCount = 0;
+            chunkMul = 1;
+        }
+    }
+    if (chunkMul != 1) bigMulAdd(&num, chunkMul, chunk);
+
+    while (lower < upper) {
+        /* Midpoint to the next value is (2m + 1) * 2^(bexp - 1) */
+        mid = lower & ((((jlong) 1) << mantBits) - 1);
+        bexp = (jint) (lower >> mantBits);
+        if (bexp != 0) {
+            mid |= ((jlong) 1) << mantBits;
+            bexp -= fmt->maxExponent + mantBits;
+        } else {
+            bexp = FORMAT_MIN_Q(fmt);
+        }
+        mid = 2 * mid + 1;
+        b.length = 0;
+        while (mid != 0) {
+            b.limbs[b.length++] = (juint) (mid & LIMB_MASK);
+            mid = mid >> LIMB_BITS;
+        }
+        a = num;
+        if (exp >= 0) bigMulPow10(&a, exp);
+        else bigMulPow10(&b, -exp);
+        if (bexp - 1 >= 0) bigShiftLeft(&b, bexp - 1);
+        else bigShiftLeft(&a, 1 - bexp);
+
+        count = bigCompare(&a, &b);
+        if ((count < 0) || ((count == 0) && ((lower & 1) == 0))) break;
+        lower++;
+    }
+
+    return lower;
+}
+
+/**
+ * Parse the hexadecimal (0x) floating point form, where the text pointer is
+ * just after the leading prefix.
+ */
+static jint parseHexText(JEM_FloatFormat *fmt, const char *ptr,
+                         const char *end, jlong *bits) {
+    jboolean seenDigit = JNI_FALSE, seenDot = JNI_FALSE, expNeg = JNI_FALSE;
+    jint binExp = 0, expVal = 0, digit;
+    juint sticky = 0, x[3];
+    jlong mant = 0;
+
+    for (; ptr < end; ptr++) {
+        if (*ptr == '.') {
+            if (seenDot == JNI_TRUE) return JNI_ERR;
+            seenDot = JNI_TRUE;
+            continue;
+        }
+        if ((*ptr >= '0') && (*ptr <= '9')) digit = *ptr - '0';
+        else if ((*ptr >= 'a') && (*ptr <= 'f')) digit = *ptr - 'a' + 10;
+        else if ((*ptr >= 'A') && (*ptr <= 'F')) digit = *ptr - 'A' + 10;
+        else break;
+        seenDigit = JNI_TRUE;
+        if (mant < (((jlong) 1) << 56)) {
+            mant = (mant << 4) | digit;
+            if (seenDot == JNI_TRUE) binExp -= 4;
+        } else {
+            if (digit != 0) sticky = 1;
+            if (seenDot == JNI_FALSE) binExp += 4;
+        }
+    }
+
+    /* Binary exponent is mandatory for the hexadecimal form */
+    if ((seenDigit == JNI_FALSE) || (ptr == end) ||
+                             ((*ptr != 'p') && (*ptr != 'P'))) return JNI_ERR;
+    if ((++ptr < end) && ((*ptr == '+') || (*ptr == '-'))) {
+        expNeg = (*(ptr++) == '-') ? JNI_TRUE : JNI_FALSE;
+    }
+    if (ptr == end) return JNI_ERR;
+    for (; ptr < end; ptr++) {
+        if ((*ptr < '0') || (*ptr > '9')) return JNI_ERR;
+        if (expVal < 100000) expVal = expVal * 10 + (*ptr - '0');
+    }
+    binExp += (expNeg == JNI_TRUE) ? -expVal : expVal;
+
+    /* Round with the sticky bit just below the retained digits */
+    mant = (mant << 1) | sticky;
+    x[0] = (juint) (mant & LIMB_MASK);
+    x[1] = (juint) ((mant >> LIMB_BITS) & LIMB_MASK);
+    x[2] = (juint) (mant >> (2 * LIMB_BITS));
+    *bits = roundBinary(fmt, x, 3, binExp - 1);
+
+    return JNI_OK;
+}
+
+/**
+ * Common parsing of the floating point text for the given format, following
+ * the grammar of the Double.valueOf(String) method.  Returns the raw bits of
+ * the magnitude, the sign being applied by the caller.
+ */
+static jint parseFloatText(JEM_FloatFormat *fmt, const char *text,
+                           jlong *bits, jboolean *negative) {
+    jboolean seenDigit = JNI_FALSE, seenDot = JNI_FALSE, expNeg = JNI_FALSE;
+    jboolean truncated = JNI_FALSE;
+    jint mantDigits = 0, exp10 = 0, expVal = 0, sciExp, r, i;
+    juint prod[8], upper[8], *pow10;
+    jlong mant = 0, borrow, lowBits, highBits;
+    const char *ptr = text, *end;
+    JEM_DecimalText dec;
+
+    /* Trim as for String.trim() and handle the special values */
+    while ((*ptr != '\0') && (*((jubyte *) ptr) <= ' ')) ptr++;
+    end = ptr + strlen(ptr);
+    while ((end > ptr) && (*((jubyte *) (end - 1)) <= ' ')) end--;
+    *negative = JNI_FALSE;
+    if ((ptr < end) && ((*ptr == '+') || (*ptr == '-'))) {
+        if (*(ptr++) == '-') *negative = JNI_TRUE;
+    }
+    if ((end - ptr == 3) && (strncmp(ptr, "NaN", 3) == 0)) {
+        *bits = FORMAT_INFINITY(fmt) |
+                          (((jlong) 1) << (fmt->precision - 2));
+        return JNI_OK;
+    }
+    if ((end - ptr == 8) && (strncmp(ptr, "Infinity", 8) == 0)) {
+        *bits = FORMAT_INFINITY(fmt);
+        return JNI_OK;
+    }
+    if ((end > ptr) && ((*(end - 1) == 'f') || (*(end - 1) == 'F') ||
+                        (*(end - 1) == 'd') || (*(end - 1) == 'D'))) end--;
+    if ((end - ptr > 2) && (*ptr == '0') &&
+                               ((*(ptr + 1) == 'x') || (*(ptr + 1) == 'X'))) {
+        return parseHexText(fmt, ptr + 2, end, bits);
+    }
+
+    /* Collect the leading significant digits, tracking the decimal point */
+    dec.digits = NULL;
+    dec.digitCount = 0;
+    for (; ptr < end; ptr++) {
+        if (*ptr == '.') {
+            if (seenDot == JNI_TRUE) return JNI_ERR;
+            seenDot = JNI_TRUE;
+            continue;
+        }
+        if ((*ptr < '0') || (*ptr > '9')) break;
+        seenDigit = JNI_TRUE;
+        if (dec.digits == NULL) {
+            if (*ptr == '0') {
+                if (seenDot == JNI_TRUE) exp10--;
+                continue;
+            }
+            dec.digits = ptr;
+        }
+        dec.digitCount++;
+        if (mantDigits < MANTISSA_DIGITS) {
+            mant = mant * 10 + (*ptr - '0');
+            mantDigits++;
+            if (seenDot == JNI_TRUE) exp10--;
+        } else {
+            if (seenDot == JNI_FALSE) exp10++;
+            if (*ptr != '0') truncated = JNI_TRUE;
+        }
+    }
+    if (seenDigit == JNI_FALSE) return JNI_ERR;
+    if (ptr < end) {
+        if ((*ptr != 'e') && (*ptr != 'E')) return JNI_ERR;
+        if ((++ptr < end) && ((*ptr == '+') || (*ptr == '-'))) {
+            expNeg = (*(ptr++) == '-') ? JNI_TRUE : JNI_FALSE;
+        }
+        if (ptr == end) return JNI_ERR;
+        for (; ptr < end; ptr++) {
+            if ((*ptr < '0') || (*ptr > '9')) return JNI_ERR;
+            if (expVal < 100000) expVal = expVal * 10 + (*ptr - '0');
+        }
+        exp10 += (expNeg == JNI_TRUE) ? -expVal : expVal;
+    }
+
+    /* Quick outs for the values that are certainly zero or infinite */
+    sciExp = exp10 + mantDigits;
+    if ((mant == 0) || (sciExp <= fmt->minDecimal)) {
+        *bits = 0;
+        return JNI_OK;
+    }
+    if (sciExp >= fmt->maxDecimal) {
+        *bits = FORMAT_INFINITY(fmt);
+        return JNI_OK;
+    }
+
+    /*
+     * The table power g * 2^r approximates 10^exp10 from above by less
+     * than 2^r, so the value lies in [m(g - 1), (m + 1)g) * 2^r (or just
+     * below mg * 2^r for exact mantissas).  Only resolve exactly where the
+     * rounding of those bounds differ.  Note that the lower bound is exact
+     * for the small positive powers (where 10^exp10 * 2^-r is integral).
+     */
+    pow10 = pow10Table[-exp10 - POW10_MIN_K];
+    r = floorLog2Pow10(exp10) - 125;
+    multiplyPow10(pow10, mant, prod);
+    (void) memcpy(upper, prod, sizeof(prod));
+    borrow = 0;
+    for (i = 0; i < 8; i++) {
+        if (i < 3) borrow -= (mant >> (i * LIMB_BITS)) & LIMB_MASK;
+        else if (borrow == 0) break;
+        borrow += prod[i];
+        prod[i] = (juint) (borrow & LIMB_MASK);
+        borrow = borrow >> LIMB_BITS;
+    }
+    lowBits = roundBinary(fmt, prod, 8, r);
+    if ((truncated == JNI_FALSE) && (exp10 >= 0) && (r <= exp10)) {
+        *bits = lowBits;
+        return JNI_OK;
+    }
+    if (truncated == JNI_TRUE) {
+        borrow = 0;
+        for (i = 0; i < 8; i++) {
+            if (i < 5) borrow += pow10[4 - i];
+            borrow += upper[i];
+            upper[i] = (juint) (borrow & LIMB_MASK);
+            borrow = borrow >> LIMB_BITS;
+        }
+    }
+    highBits = roundBinary(fmt, upper, 8, r);
+    if (lowBits != highBits) {
+        dec.exponent = exp10 - (dec.digitCount - mantDigits);
+        lowBits = resolveDecimal(fmt, &dec, lowBits, highBits);
+    }
+    *bits = lowBits;
+
+    return JNI_OK;
+}
+
+/**
+ * Convert the text representation of a floating point number into a float
+ * value.  Accepts the same textual forms as the Float.valueOf(String)
+ * method (including the hexadecimal form) and produces the same correctly
+ * rounded result, independent of the C library and process locale.
+ *
+ * Parameters:
+ *    text - the (NUL terminated) text to be converted
+ *    val - pointer through which the converted value is returned
+ *
+ * Returns:
+ *    JNI_OK - the text was successfully converted
+ *    JNI_ERR - the text is not a valid floating point number (a
+ *              NumberFormatException condition)
+ */
+jint JEMCC_TextToFloat(const char *text, jfloat *val) {
+    union {
+        jfloat fval;
+        jint bits;
+    } conv;
+    jboolean negative;
+    jlong bits;
+
+    if (parseFloatText(&floatFormat, text, &bits, &negative) != JNI_OK) {
+        return JNI_ERR;
+    }
+    conv.bits = (jint) bits;
+    *val = (negative == JNI_TRUE) ? -conv.fval : conv.fval;
+
+    return JNI_OK;
+}
+
+/**
+ * Convert the text representation of a floating point number into a double
+ * value.  Accepts the same textual forms as the Double.valueOf(String)
+ * method (including the hexadecimal form) and produces the same correctly
+ * rounded result, independent of the C library and process locale.
+ *
+ * Parameters:
+ *    text - the (NUL terminated) text to be converted
+ *    val - pointer through which the converted value is returned
+ *
+ * Returns:
+ *    JNI_OK - the text was successfully converted
+ *    JNI_ERR - the text is not a valid floating point number (a
+ *              NumberFormatException condition)
+ */
+jint JEMCC_TextToDouble(const char *text, jdouble *val) {
+    union {
+        jdouble dval;
+        jlong bits;
+    } conv;
+    jboolean negative;
+
+    if (parseFloatText(&doubleFormat, text, &conv.bits,
+                       &negative) != JNI_OK) {
+        return JNI_ERR;
+    }
+    *val = (negative == JNI_TRUE) ? -conv.dval : conv.dval;
+
+    return JNI_OK;
 }
@@ -23,6 +23,7 @@
  */
 
 /* This file is not compiled separately, read into cpu.c as switch contents */
+/* (or as the labelled opcode blocks for the threaded interpreter variant)  */
 
 /* See the cpu.c file for the location of this definition */
 #ifdef DEBUG_CPU_INTERNALS
@@ -50,13 +51,12 @@
     fprintf(stderr, "Stack long val %f\n", \
                     (((JEM_DblFrameEntry *) (frame->operandStackTop)) - 1)->d);
 
-/* Wrapper macro to make contents more readable */
-#define OPCODE(opname, opcode) \
-       (void) fprintf(stderr, "Completing opcode\n"); \
-    break; \
-    case opcode: \
+/* Opcode tracing wrappers for the OPCODE macros below */
+#define OPCODE_START(opname) \
        (void) fprintf(stderr, "[%i] Starting opcode %s\n", \
-                              currentFrameExt->pc - 1, opname);
+                              JEM_PC - 1, opname);
+#define OPCODE_END() \
+       (void) fprintf(stderr, "Completing opcode\n");
 
 #else
 
@@ -65,25 +65,69 @@
 #define JEMCC_DEBUG_STACK_OBJECT(frame)
 #define JEMCC_DEBUG_STACK_LONG(frame)
 #define JEMCC_DEBUG_STACK_DOUBLE(frame)
+#define OPCODE_START(opname)
+#define OPCODE_END()
+
+#endif
+
+/*
+ * Wrapper macros to make contents more readable.  For the standard switch
+ * based interpreter, each opcode is simply a case in the switch.  For the
+ * threaded interpreter (see ENABLE_THREADED_DISPATCH in cpu.c), each opcode
+ * is a label referenced from the dispatch table and each opcode body ends
+ * with its own copy of the dispatch jump.  The opcodes embedded in the
+ * "wide" instruction are always cases of the local wide switch.
+ *
+ * Note that opcode bodies must use the JEM_PC/READ_OP*() macros to access
+ * the program counter and any code which calls out of the interpreter (may
+ * throw an exception, alter the frame stack or trigger GC) must be wrapped
+ * in a JEM_BEGIN_CALLOUT/JEM_END_CALLOUT block, which must be the last
+ * statement executed by the opcode.
+ */
+#ifdef ENABLE_THREADED_DISPATCH
+#define OPCODE(opname, opcode) \
+    OPCODE_END() \
+    JEM_DISPATCH_NEXT(); \
+    JEM_OP_##opcode: \
+    OPCODE_START(opname)
+#else
 #define OPCODE(opname, opcode) \
+    OPCODE_END() \
     break; \
-    case opcode:
-
+    case opcode: \
+    OPCODE_START(opname)
 #endif
 
+#define WIDE_OPCODE(opname, opcode) \
+    OPCODE_END() \
+    break; \
+    case opcode: \
+    OPCODE_START(opname)
+
+/* Branch to a relative target, backward branches poll for a safepoint */
+#define JEM_BRANCH(offset) \
+    do { \
+        JEM_PC += (offset); \
+        if ((offset) < 0) { JEM_SAFEPOINT_POLL(); } \
+    } while (0)
+
 OPCODE("aaload", 0x32)
 {
     jint index = JEMCC_POP_STACK_INT(currentFrame);
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_OBJECT(currentFrame, 
+                      *(((JEMCC_Object **) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_OBJECT(currentFrame, 
-                          *(((JEMCC_Object **) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -94,14 +138,29 @@ OPCODE("aastore", 0x53)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
-    } else {
-fprintf(stderr, "Storing %p in %p at %i\n", val, array, index);
-        /* TODO - check component type information (assignments) */
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        /* Stored value must be assignable to the array component type */
+        if ((val != NULL) &&
+            (JEM_IsAssignableArrayElement(val->classReference,
+                                 (JEMCC_ArrayClass *) array->classReference)
+                                                           == JNI_FALSE)) {
+            JEM_BEGIN_CALLOUT
+            JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ArrayStoreException,
+                                 NULL,
+                                 val->classReference->classData->className);
+            JEM_END_CALLOUT
+        } else {
             *(((JEMCC_Object **) array->arrayData) + index) = val;
+            JEMCC_MarkNonLocalObject(env, val);
         }
+    } else {
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -112,7 +171,7 @@ OPCODE("aconst_null", 0x01)
 
 OPCODE("aload", 0x19)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_PUSH_STACK_OBJECT(currentFrame, 
                             JEMCC_LOAD_OBJECT(currentFrame, index));
 }
@@ -138,8 +197,9 @@ OPCODE("aload_3", 0x2d)
 }
 
 OPCODE("anewarray", 0xbd)
+JEM_BEGIN_CALLOUT
 {
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     jint length = JEMCC_POP_STACK_INT(currentFrame);
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
@@ -161,12 +221,17 @@ abort();
         if (objArray != NULL) JEMCC_PUSH_STACK_OBJECT(currentFrame, objArray);
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("areturn", 0xb0)
+JEM_BEGIN_CALLOUT
 {
     /* Grab the value from the working stack */
     JEMCC_Object *retVal = JEMCC_POP_STACK_OBJECT(currentFrame);
 
+    /* Release the frame objects, handing the return value to the caller */
+    JEM_FlushLocalFrameAllocations(env, retVal, NULL);
+
     /* Pop the frame instance, absorbing method arguments */
     JEM_PopFrame(env);
 
@@ -184,14 +249,17 @@ OPCODE("areturn", 0xb0)
             break;
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("arraylength", 0xbe)
 {
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
     } else {
         JEMCC_PUSH_STACK_INT(currentFrame, array->arrayLength);
     }
@@ -199,7 +267,7 @@ OPCODE("arraylength", 0xbe)
 
 OPCODE("astore", 0x3a)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_STORE_OBJECT(currentFrame, index, 
                        JEMCC_POP_STACK_OBJECT(currentFrame));
 }
@@ -225,6 +293,7 @@ OPCODE("astore_3", 0x4e)
 }
 
 OPCODE("athrow", 0xbf)
+JEM_BEGIN_CALLOUT
 {
     jobject ex = JEMCC_POP_STACK_OBJECT(currentFrame);
     if (ex == NULL) {
@@ -234,6 +303,7 @@ OPCODE("athrow", 0xbf)
         JEMCC_ProcessThrowable(env, (JEMCC_Object *) ex);
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("baload", 0x33)
 {
@@ -241,13 +311,17 @@ OPCODE("baload", 0x33)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_INT(currentFrame, 
+                      (int) *(((jbyte *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_INT(currentFrame, 
-                          (int) *(((jbyte *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -258,18 +332,22 @@ OPCODE("bastore", 0x54)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jbyte *) array->arrayData) + index) = (jbyte) (val & 0xFF);
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jbyte *) array->arrayData) + index) = (jbyte) (val & 0xFF);
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
 OPCODE("bipush", 0x10)
 {
-    jbyte res = (jbyte) read_op1(currentFrameExt);
+    jbyte res = (jbyte) READ_OP1();
     JEMCC_PUSH_STACK_INT(currentFrame, (jint) res);
 }
 
@@ -283,13 +361,17 @@ OPCODE("caload", 0x34)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_INT(currentFrame, 
+                      (int) *(((jchar *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_INT(currentFrame, 
-                          (int) *(((jchar *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -300,49 +382,46 @@ OPCODE("castore", 0x55)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jchar *) array->arrayData) + index) = 
+                                                (jchar) (val & 0xFFFF);
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jchar *) array->arrayData) + index) = 
-                                                    (jchar) (val & 0xFFFF);
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
 OPCODE("checkcast", 0xc0)
 {
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
     JEMCC_Class *checkClass = classData->classRefs[index];
-    JEMCC_Class *objClass, **compClassPtr;
-    JEMCC_Object *obj;
-
-    /* Handle unknown class cast */
-    if (checkClass == NULL) {
-        /* TODO - really do missing class check */
-    } else {     
-        obj = (currentFrame->operandStackTop - 1)->obj;
-        /* Note that 'null' object can always be cast */
-        if (obj != NULL) {
-            objClass = (JEMCC_Class *) obj->classReference;
-            if (objClass != checkClass) {
-                compClassPtr = objClass->classData->assignList;
-                while (*compClassPtr != NULL) {
-                    if (*compClassPtr == checkClass) break;
-                    compClassPtr++;
-                }
+    JEMCC_Object *obj = (currentFrame->operandStackTop - 1)->obj;
 
-                /* No match was found in assignment list - cast is invalid */
-                if (*compClassPtr == NULL) {
-                    JEMCC_ThrowStdThrowableIdxV(env, 
-                                          JEMCC_Class_ClassCastException, NULL,
-                                          "Class is not instance of ",
-                                          checkClass->classData->className,
-                                          NULL);
-                }
-            }
+    /* Note that 'null' object can always be cast */
+    if (obj == NULL) {
+        /* Nothing to do */
+    } else if (!JEM_CLASS_REF_RESOLVED(checkClass)) {
+        /* Unknown class, rethrow the resolution error */
+        JEM_BEGIN_CALLOUT
+        JEM_ThrowSkeletonThrowable(env, (JEMCC_Object *) checkClass);
+        JEM_END_CALLOUT
+    } else if (obj->classReference != checkClass) {
+        /* Not a subtype (display/interface check) - invalid cast */
+        if (JEM_IsAssignableClass(obj->classReference,
+                                  checkClass) == JNI_FALSE) {
+            JEM_BEGIN_CALLOUT
+            JEMCC_ThrowStdThrowableIdxV(env, JEMCC_Class_ClassCastException,
+                                        NULL, "Class is not instance of ",
+                                        checkClass->classData->className,
+                                        NULL);
+            JEM_END_CALLOUT
         }
     }
 }
@@ -381,13 +460,17 @@ OPCODE("daload", 0x31)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_DOUBLE(currentFrame, 
+                      *(((jdouble *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_DOUBLE(currentFrame, 
-                          *(((jdouble *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -398,12 +481,16 @@ OPCODE("dastore", 0x52)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jdouble *) array->arrayData) + index) = val;
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jdouble *) array->arrayData) + index) = val;
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -456,7 +543,7 @@ OPCODE("ddiv", 0x6f)
 
 OPCODE("dload", 0x18)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_PUSH_STACK_DOUBLE(currentFrame, 
                             JEMCC_LOAD_DOUBLE(currentFrame, index));
 }
@@ -502,10 +589,14 @@ OPCODE("drem", 0x73)
 }
 
 OPCODE("dreturn", 0xaf)
+JEM_BEGIN_CALLOUT
 {
     /* Grab the value from the working stack */
     jdouble retVal = JEMCC_POP_STACK_DOUBLE(currentFrame);
 
+    /* Release the frame objects */
+    JEM_FlushLocalFrameAllocations(env, NULL, NULL);
+
     /* Pop the frame instance, absorbing method arguments */
     JEM_PopFrame(env);
 
@@ -523,10 +614,11 @@ OPCODE("dreturn", 0xaf)
             break;
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("dstore", 0x39)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_STORE_DOUBLE(currentFrame, index, 
                        JEMCC_POP_STACK_DOUBLE(currentFrame));
 }
@@ -643,13 +735,17 @@ OPCODE("faload", 0x30)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_FLOAT(currentFrame, 
+                          *(((jfloat *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_FLOAT(currentFrame, 
-                              *(((jfloat *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -660,12 +756,16 @@ OPCODE("fastore", 0x51)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jfloat *) array->arrayData) + index) = val;
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jfloat *) array->arrayData) + index) = val;
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -723,7 +823,7 @@ OPCODE("fdiv", 0x6e)
 
 OPCODE("fload", 0x17)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_PUSH_STACK_FLOAT(currentFrame, 
                            JEMCC_LOAD_FLOAT(currentFrame, index));
 }
@@ -772,10 +872,14 @@ OPCODE("frem", 0x72)
 }
 
 OPCODE("freturn", 0xae)
+JEM_BEGIN_CALLOUT
 {
     /* Grab the value from the working stack */
     jfloat retVal = JEMCC_POP_STACK_FLOAT(currentFrame);
 
+    /* Release the frame objects */
+    JEM_FlushLocalFrameAllocations(env, NULL, NULL);
+
     /* Pop the frame instance, absorbing method arguments */
     JEM_PopFrame(env);
 
@@ -793,10 +897,11 @@ OPCODE("freturn", 0xae)
             break;
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("fstore", 0x38)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_STORE_FLOAT(currentFrame, index, 
                       JEMCC_POP_STACK_FLOAT(currentFrame));
 }
@@ -832,7 +937,7 @@ OPCODE("getfield", 0xb4)
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassFieldData *fieldRef = classData->classFieldRefs[index];
     JEMCC_Object *targObj;
     jbyte *basePtr;
@@ -844,8 +949,10 @@ OPCODE("getfield", 0xb4)
         /* Obtain the source object for the field */
         targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
         if (targObj == NULL) {
+            JEM_BEGIN_CALLOUT
             JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                        NULL, NULL);
+            JEM_END_CALLOUT
         } else {
 #ifdef DEBUG_CPU_INTERNALS
 (void) fprintf(stderr, "Retrieving field from object %s\n",
@@ -903,17 +1010,141 @@ OPCODE("getfield", 0xb4)
                     JEMCC_DEBUG_STACK_OBJECT(currentFrame);
                     break;
                 default:
+                    JEM_BEGIN_CALLOUT
                     JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError, 
                                            NULL, "Unknown getfield data type");
+                    JEM_END_CALLOUT
                     break;
             }
         }
     }
 }
 
+/*
+ * Quick variants of getfield, rewritten by JEM_QuickenClassByteCode once the
+ * field reference is resolved.  The operand is the field offset into the
+ * object data and the opcode selects the storage type (int also handles
+ * float fields, long also handles double fields).
+ */
+OPCODE("getfield_quick_byte", 0xcb)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        JEMCC_PUSH_STACK_INT(currentFrame, (jint) *((jbyte *) basePtr));
+        JEMCC_DEBUG_STACK_INT(currentFrame);
+    }
+}
+
+OPCODE("getfield_quick_char", 0xcc)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        JEMCC_PUSH_STACK_INT(currentFrame, (jint) *((jchar *) basePtr));
+        JEMCC_DEBUG_STACK_INT(currentFrame);
+    }
+}
+
+OPCODE("getfield_quick_short", 0xcd)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        JEMCC_PUSH_STACK_INT(currentFrame, (jint) *((jshort *) basePtr));
+        JEMCC_DEBUG_STACK_INT(currentFrame);
+    }
+}
+
+OPCODE("getfield_quick_int", 0xce)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        JEMCC_PUSH_STACK_INT(currentFrame, *((jint *) basePtr));
+        JEMCC_DEBUG_STACK_INT(currentFrame);
+    }
+}
+
+OPCODE("getfield_quick_long", 0xcf)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        JEMCC_PUSH_STACK_LONG(currentFrame, *((jlong *) basePtr));
+        JEMCC_DEBUG_STACK_LONG(currentFrame);
+    }
+}
+
+OPCODE("getfield_quick_object", 0xd0)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        JEMCC_PUSH_STACK_OBJECT(currentFrame,
+                                *((JEMCC_Object **) basePtr));
+        JEMCC_DEBUG_STACK_OBJECT(currentFrame);
+    }
+}
+
 OPCODE("getstatic", 0xb2)
+JEM_BEGIN_CALLOUT
 {
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
     JEM_ClassFieldData *fieldRef = classData->classFieldRefs[index];
@@ -978,17 +1209,18 @@ OPCODE("getstatic", 0xb2)
         }
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("goto", 0xa7)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt);
-    currentFrameExt->pc += offset - 3;
+    jshort offset = (jshort) READ_OP2();
+    JEM_BRANCH(offset - 3);
 }
 
 OPCODE("goto_w", 0xc8)
 {
-    jint offset = (jint) read_op4(currentFrameExt);
-    currentFrameExt->pc += offset - 3;
+    jint offset = (jint) READ_OP4();
+    JEM_BRANCH(offset - 3);
 }
 
 OPCODE("i2b", 0x91)
@@ -1044,13 +1276,17 @@ OPCODE("iaload", 0x2e)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_INT(currentFrame, 
+                      *(((jint *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_INT(currentFrame, 
-                          *(((jint *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -1068,12 +1304,16 @@ OPCODE("iastore", 0x4f)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jint *) array->arrayData) + index) = val;
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jint *) array->arrayData) + index) = val;
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -1118,8 +1358,10 @@ OPCODE("idiv", 0x6c)
     jint numerand = JEMCC_POP_STACK_INT(currentFrame);
 
     if (divisor == 0) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ArithmeticException, 
                                    NULL, "Integer divide by zero");
+        JEM_END_CALLOUT
     } else {
         JEMCC_PUSH_STACK_INT(currentFrame, numerand / divisor);
     }
@@ -1127,130 +1369,130 @@ OPCODE("idiv", 0x6c)
 
 OPCODE("ifeq", 0x99)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
-    if (JEMCC_POP_STACK_INT(currentFrame) == 0) currentFrameExt->pc += offset;
+    jshort offset = (jshort) READ_OP2() - 3;
+    if (JEMCC_POP_STACK_INT(currentFrame) == 0) JEM_BRANCH(offset);
 }
 
 OPCODE("ifge", 0x9c)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
-    if (JEMCC_POP_STACK_INT(currentFrame) >= 0) currentFrameExt->pc += offset;
+    jshort offset = (jshort) READ_OP2() - 3;
+    if (JEMCC_POP_STACK_INT(currentFrame) >= 0) JEM_BRANCH(offset);
 }
 
 OPCODE("ifgt", 0x9d)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
-    if (JEMCC_POP_STACK_INT(currentFrame) > 0) currentFrameExt->pc += offset;
+    jshort offset = (jshort) READ_OP2() - 3;
+    if (JEMCC_POP_STACK_INT(currentFrame) > 0) JEM_BRANCH(offset);
 }
 
 OPCODE("ifle", 0x9e)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
-    if (JEMCC_POP_STACK_INT(currentFrame) <= 0) currentFrameExt->pc += offset;
+    jshort offset = (jshort) READ_OP2() - 3;
+    if (JEMCC_POP_STACK_INT(currentFrame) <= 0) JEM_BRANCH(offset);
 }
 
 OPCODE("iflt", 0x9b)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
-    if (JEMCC_POP_STACK_INT(currentFrame) < 0) currentFrameExt->pc += offset;
+    jshort offset = (jshort) READ_OP2() - 3;
+    if (JEMCC_POP_STACK_INT(currentFrame) < 0) JEM_BRANCH(offset);
 }
 
 OPCODE("ifne", 0x9a)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
-    if (JEMCC_POP_STACK_INT(currentFrame) != 0) currentFrameExt->pc += offset;
+    jshort offset = (jshort) READ_OP2() - 3;
+    if (JEMCC_POP_STACK_INT(currentFrame) != 0) JEM_BRANCH(offset);
 }
 
 OPCODE("ifnonnull", 0xc7)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     if (JEMCC_POP_STACK_OBJECT(currentFrame) != NULL) {
-        currentFrameExt->pc += offset;
+        JEM_BRANCH(offset);
     }
 }
 
 OPCODE("ifnull", 0xc6)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     if (JEMCC_POP_STACK_OBJECT(currentFrame) == NULL) {
-        currentFrameExt->pc += offset;
+        JEM_BRANCH(offset);
     }
 }
 
 OPCODE("if_acmpeq", 0xa5)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     JEMCC_Object *objb = JEMCC_POP_STACK_OBJECT(currentFrame);
     JEMCC_Object *obja = JEMCC_POP_STACK_OBJECT(currentFrame);
-    if (obja == objb) currentFrameExt->pc += offset;
+    if (obja == objb) JEM_BRANCH(offset);
 }
 
 OPCODE("if_acmpne", 0xa6)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     JEMCC_Object *objb = JEMCC_POP_STACK_OBJECT(currentFrame);
     JEMCC_Object *obja = JEMCC_POP_STACK_OBJECT(currentFrame);
-    if (obja != objb) currentFrameExt->pc += offset;
+    if (obja != objb) JEM_BRANCH(offset);
 }
 
 OPCODE("if_icmpeq", 0x9f)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     jint ib = JEMCC_POP_STACK_INT(currentFrame);
     jint ia = JEMCC_POP_STACK_INT(currentFrame);
-    if (ia == ib) currentFrameExt->pc += offset;
+    if (ia == ib) JEM_BRANCH(offset);
 }
 
 OPCODE("if_icmpge", 0xa2)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     jint ib = JEMCC_POP_STACK_INT(currentFrame);
     jint ia = JEMCC_POP_STACK_INT(currentFrame);
-    if (ia >= ib) currentFrameExt->pc += offset;
+    if (ia >= ib) JEM_BRANCH(offset);
 }
 
 OPCODE("if_icmpgt", 0xa3)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     jint ib = JEMCC_POP_STACK_INT(currentFrame);
     jint ia = JEMCC_POP_STACK_INT(currentFrame);
-    if (ia > ib) currentFrameExt->pc += offset;
+    if (ia > ib) JEM_BRANCH(offset);
 }
 
 OPCODE("if_icmple", 0xa4)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     jint ib = JEMCC_POP_STACK_INT(currentFrame);
     jint ia = JEMCC_POP_STACK_INT(currentFrame);
-    if (ia <= ib) currentFrameExt->pc += offset;
+    if (ia <= ib) JEM_BRANCH(offset);
 }
 
 OPCODE("if_icmplt", 0xa1)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     jint ib = JEMCC_POP_STACK_INT(currentFrame);
     jint ia = JEMCC_POP_STACK_INT(currentFrame);
-    if (ia < ib) currentFrameExt->pc += offset;
+    if (ia < ib) JEM_BRANCH(offset);
 }
 
 OPCODE("if_icmpne", 0xa0)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt) - 3;
+    jshort offset = (jshort) READ_OP2() - 3;
     jint ib = JEMCC_POP_STACK_INT(currentFrame);
     jint ia = JEMCC_POP_STACK_INT(currentFrame);
-    if (ia != ib) currentFrameExt->pc += offset;
+    if (ia != ib) JEM_BRANCH(offset);
 }
 
 OPCODE("iinc", 0x84)
 {
-    juint index = (juint) read_op1(currentFrameExt);
-    jbyte adj = read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
+    jbyte adj = READ_OP1();
     currentFrame->localVars[index].i += adj;
 }
 
 OPCODE("iload", 0x15)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_PUSH_STACK_INT(currentFrame, 
                          JEMCC_LOAD_INT(currentFrame, index));
 }
@@ -1290,17 +1532,33 @@ OPCODE("ineg", 0x74)
 
 OPCODE("instanceof", 0xc1)
 {
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
+    JEM_ClassData *classData = 
+                      currentFrameExt->currentMethod->parentClass->classData;
+    JEMCC_Class *checkClass = classData->classRefs[index];
     JEMCC_Object *obj = JEMCC_POP_STACK_OBJECT(currentFrame);
-    /* TODO - lots of complex rules appear here */
-    (void) fprintf(stderr, "instanceof %p %i\n", obj, index);
+
+    /* Note that 'null' is never an instance of anything */
+    if (obj == NULL) {
+        JEMCC_PUSH_STACK_INT(currentFrame, 0);
+    } else if (!JEM_CLASS_REF_RESOLVED(checkClass)) {
+        /* Unknown class, rethrow the resolution error */
+        JEM_BEGIN_CALLOUT
+        JEM_ThrowSkeletonThrowable(env, (JEMCC_Object *) checkClass);
+        JEM_END_CALLOUT
+    } else {
+        JEMCC_PUSH_STACK_INT(currentFrame, 
+                  (JEM_IsAssignableClass(obj->classReference,
+                                         checkClass) == JNI_TRUE) ? 1 : 0);
+    }
 }
 
 OPCODE("invokeinterface", 0xb9)
+JEM_BEGIN_CALLOUT
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassMethodData *ifMethodData, *targetMethodData;
     JEMCC_Object *targetObj;
     JEMCC_Class **assignClassPtr;
@@ -1309,8 +1567,8 @@ OPCODE("invokeinterface", 0xb9)
 fprintf(stderr, "INVOKE INTERFACE INDEX %i\n", index);
 
     /* Discard the proprietary Java encoding areas */
-    (void) read_op1(currentFrameExt); /* numArgs */
-    (void) read_op1(currentFrameExt); /* reserved */
+    (void) READ_OP1(); /* numArgs */
+    (void) READ_OP1(); /* reserved */
 
     ifMethodData = classData->classMethodRefs[index];
     if (ifMethodData == NULL) {
@@ -1360,12 +1618,43 @@ JEM_DumpDebugClass(env, targetObj->classReference);
         }
     }
 }
+JEM_END_CALLOUT
+
+/*
+ * Quick variants of invokeinterface/invokevirtual, rewritten by
+ * JEM_QuickenClassByteCode for resolved method references.  The operand is
+ * the index of the inline cache for the call site in the current method.
+ */
+OPCODE("invokeinterface_quick", 0xd8)
+JEM_BEGIN_CALLOUT
+{
+    JEM_BCMethod *bcMethod = currentFrameExt->currentMethod->method.bcMethod;
+    JEM_CallSiteCache *cache = bcMethod->callSiteCaches + READ_OP2();
+    JEM_ClassMethodData *targetMethodData;
+
+    /* Discard the proprietary Java encoding areas */
+    (void) READ_OP1(); /* numArgs */
+    (void) READ_OP1(); /* reserved */
+
+    targetMethodData = JEM_CallSiteTarget(env, bcMethod, cache,
+                            (currentFrame->operandStackTop - 
+                                  cache->methodRef->stackConsumeCount)->obj,
+                            JNI_TRUE);
+
+    /* Push and execute the target method instance */
+    if ((targetMethodData != NULL) &&
+        (JEM_PushFrame(env, (jmethodID) targetMethodData, NULL) == JNI_OK)) {
+        JEM_ExecuteCurrentFrame(env, JNI_TRUE);
+    }
+}
+JEM_END_CALLOUT
 
 OPCODE("invokespecial", 0xb7)
+JEM_BEGIN_CALLOUT
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassMethodData *methodData;
     JEMCC_Object *targetObj;
 
@@ -1392,12 +1681,14 @@ fprintf(stderr, "ERROR SPECIAL METHOD DATA\n");
         }
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("invokestatic", 0xb8)
+JEM_BEGIN_CALLOUT
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassMethodData *methodData;
 
     (void) fprintf(stderr, "STATIC CALL %i\n", index);
@@ -1417,12 +1708,14 @@ fprintf(stderr, "ERROR STATIC METHOD DATA\n");
         }
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("invokevirtual", 0xb6)
+JEM_BEGIN_CALLOUT
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassMethodData *methodData, *targetMethodData;
     JEM_ClassData *targetClassData;
     JEMCC_Object *targetObj;
@@ -1457,6 +1750,27 @@ fprintf(stderr, "TARGET METHOD %s\n", targetMethodData->name);
         }
     }
 }
+JEM_END_CALLOUT
+
+OPCODE("invokevirtual_quick", 0xd7)
+JEM_BEGIN_CALLOUT
+{
+    JEM_BCMethod *bcMethod = currentFrameExt->currentMethod->method.bcMethod;
+    JEM_CallSiteCache *cache = bcMethod->callSiteCaches + READ_OP2();
+    JEM_ClassMethodData *targetMethodData;
+
+    targetMethodData = JEM_CallSiteTarget(env, bcMethod, cache,
+                            (currentFrame->operandStackTop - 
+                                  cache->methodRef->stackConsumeCount)->obj,
+                            JNI_FALSE);
+
+    /* Push and execute the target method instance */
+    if ((targetMethodData != NULL) &&
+        (JEM_PushFrame(env, (jmethodID) targetMethodData, NULL) == JNI_OK)) {
+        JEM_ExecuteCurrentFrame(env, JNI_TRUE);
+    }
+}
+JEM_END_CALLOUT
 
 OPCODE("ior", 0x80)
 {
@@ -1471,18 +1785,24 @@ OPCODE("irem", 0x70)
     jint numerand = JEMCC_POP_STACK_INT(currentFrame);
 
     if (divisor == 0) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ArithmeticException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
     } else {
         JEMCC_PUSH_STACK_INT(currentFrame, numerand % divisor);
     }
 }
 
 OPCODE("ireturn", 0xac)
+JEM_BEGIN_CALLOUT
 {
     /* Grab the value from the working stack */
     jint retVal = JEMCC_POP_STACK_INT(currentFrame);
 
+    /* Release the frame objects */
+    JEM_FlushLocalFrameAllocations(env, NULL, NULL);
+
     /* Pop the frame instance, absorbing method arguments */
     JEM_PopFrame(env);
 
@@ -1500,6 +1820,7 @@ OPCODE("ireturn", 0xac)
             break;
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("ishl", 0x78)
 {
@@ -1518,7 +1839,7 @@ OPCODE("ishr", 0x7a)
 
 OPCODE("istore", 0x36)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_STORE_INT(currentFrame, index, 
                     JEMCC_POP_STACK_INT(currentFrame));
 }
@@ -1567,16 +1888,16 @@ OPCODE("ixor", 0x82)
 
 OPCODE("jsr", 0xa8)
 {
-    jshort offset = (jshort) read_op2(currentFrameExt);
-    JEMCC_PUSH_STACK_INT(currentFrame, currentFrameExt->pc);
-    currentFrameExt->pc += offset - 1;
+    jshort offset = (jshort) READ_OP2();
+    JEMCC_PUSH_STACK_INT(currentFrame, JEM_PC);
+    JEM_PC += offset - 1;
 }
 
 OPCODE("jsr_w", 0xc9)
 {
-    jint offset = (jint) read_op4(currentFrameExt);
-    JEMCC_PUSH_STACK_INT(currentFrame, currentFrameExt->pc);
-    currentFrameExt->pc += offset - 1;
+    jint offset = (jint) READ_OP4();
+    JEMCC_PUSH_STACK_INT(currentFrame, JEM_PC);
+    JEM_PC += offset - 1;
 }
 
 OPCODE("l2d", 0x8a)
@@ -1618,13 +1939,17 @@ OPCODE("laload", 0x2f)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_LONG(currentFrame, 
+                      *(((jlong *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_LONG(currentFrame, 
-                          *(((jlong *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -1635,12 +1960,16 @@ OPCODE("lastore", 0x50)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jlong *) array->arrayData) + index) = val;
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jlong *) array->arrayData) + index) = val;
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -1671,7 +2000,7 @@ OPCODE("ldc", 0x12)
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
 
     switch (classData->localConstants[index].generic.tag) {
         case CONSTANT_Integer:
@@ -1696,7 +2025,7 @@ OPCODE("ldc_w", 0x13)
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
 
     switch (classData->localConstants[index].generic.tag) {
         case CONSTANT_Integer:
@@ -1721,7 +2050,7 @@ OPCODE("ldc2_w", 0x14)
 {
     JEM_ClassData *classData = 
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
 
     switch (classData->localConstants[index].generic.tag) {
         case CONSTANT_Long:
@@ -1745,8 +2074,10 @@ OPCODE("ldiv", 0x6d)
     jlong numerand = JEMCC_POP_STACK_LONG(currentFrame);
 
     if (divisor == 0) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ArithmeticException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
     } else {
         JEMCC_PUSH_STACK_LONG(currentFrame, numerand / divisor);
     }
@@ -1754,7 +2085,7 @@ OPCODE("ldiv", 0x6d)
 
 OPCODE("lload", 0x16)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_PUSH_STACK_LONG(currentFrame, 
                           JEMCC_LOAD_LONG(currentFrame, index));
 }
@@ -1795,28 +2126,61 @@ OPCODE("lneg", 0x75)
 OPCODE("lookupswitch", 0xab)
 {
     jint switchValue = JEMCC_POP_STACK_INT(currentFrame);
-    jint basePC = currentFrameExt->pc - 1;
+    jint basePC = JEM_PC - 1;
     jint i, switchOffset, caseCount, caseValue, caseOffset;
 
     /* Adjust pad to arrive at four byte offset */
-    currentFrameExt->pc = ((currentFrameExt->pc + 3) >> 2) << 2;
+    JEM_PC = ((JEM_PC + 3) >> 2) << 2;
 
     /* Read the default lookup offset */
-    switchOffset = (jint) read_op4(currentFrameExt);
+    switchOffset = (jint) READ_OP4();
 
     /* Scan through the match table looking for our case value */
-    caseCount = (jint) read_op4(currentFrameExt);
+    caseCount = (jint) READ_OP4();
     for (i = 0; i < caseCount; i++) {
-        caseValue = (jint) read_op4(currentFrameExt);
-        caseOffset = (jint) read_op4(currentFrameExt);
+        caseValue = (jint) READ_OP4();
+        caseOffset = (jint) READ_OP4();
         if (switchValue == caseValue) {
             switchOffset = caseOffset;
             break;
         }
     }
 
-    /* Jump to the final target address */
-    currentFrameExt->pc = basePC + switchOffset;
+    /* Jump to the final target address, polling if a backward branch */
+    JEM_PC = basePC + switchOffset;
+    if (switchOffset <= 0) { JEM_SAFEPOINT_POLL(); }
+}
+
+/*
+ * Quick variant of lookupswitch, rewritten by JEM_QuickenClassByteCode.  The
+ * operand is the index of the decoded switch table for the current method,
+ * whose keys are sorted for a binary search.
+ */
+OPCODE("lookupswitch_quick", 0xda)
+{
+    JEM_SwitchTable *table =
+            currentFrameExt->currentMethod->method.bcMethod->switchTables +
+                                                                READ_OP2();
+    jint switchValue = JEMCC_POP_STACK_INT(currentFrame);
+    jint low = 0, high = table->count - 1, mid, key;
+    jint basePC = JEM_PC - 3;
+
+    JEM_PC = table->defaultPC;
+    while (low <= high) {
+        mid = (low + high) >> 1;
+        key = table->keys[mid];
+        if (switchValue < key) {
+            high = mid - 1;
+        } else if (switchValue > key) {
+            low = mid + 1;
+        } else {
+            JEM_PC = table->targetPCs[mid];
+            break;
+        }
+    }
+
+    /* Poll for a safepoint if a backward branch */
+    if (JEM_PC <= basePC) { JEM_SAFEPOINT_POLL(); }
 }
 
 OPCODE("lor", 0x81)
@@ -1832,18 +2196,24 @@ OPCODE("lrem", 0x71)
     jlong numerand = JEMCC_POP_STACK_LONG(currentFrame);
 
     if (divisor == 0) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ArithmeticException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
     } else {
         JEMCC_PUSH_STACK_LONG(currentFrame, numerand % divisor);
     }
 }
 
 OPCODE("lreturn", 0xad)
+JEM_BEGIN_CALLOUT
 {
     /* Grab the value from the working stack */
     jlong retVal = JEMCC_POP_STACK_LONG(currentFrame);
 
+    /* Release the frame objects */
+    JEM_FlushLocalFrameAllocations(env, NULL, NULL);
+
     /* Pop the frame instance, absorbing method arguments */
     JEM_PopFrame(env);
 
@@ -1861,6 +2231,7 @@ OPCODE("lreturn", 0xad)
             break;
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("lshl", 0x79)
 {
@@ -1879,7 +2250,7 @@ OPCODE("lshr", 0x7b)
 
 OPCODE("lstore", 0x37)
 {
-    juint index = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP1();
     JEMCC_STORE_LONG(currentFrame, index, 
                      JEMCC_POP_STACK_LONG(currentFrame));
 }
@@ -1927,6 +2298,7 @@ OPCODE("lxor", 0x83)
 }
 
 OPCODE("monitorenter", 0xc2)
+JEM_BEGIN_CALLOUT
 {
     JEMCC_Object *obj = JEMCC_POP_STACK_OBJECT(currentFrame);
     if (obj == NULL) {
@@ -1936,8 +2308,10 @@ OPCODE("monitorenter", 0xc2)
         JEMCC_EnterObjMonitor(env, (jobject) obj);
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("monitorexit", 0xc3)
+JEM_BEGIN_CALLOUT
 {
     JEMCC_Object *obj = JEMCC_POP_STACK_OBJECT(currentFrame);
     if (obj == NULL) {
@@ -1947,11 +2321,12 @@ OPCODE("monitorexit", 0xc3)
         JEMCC_ExitObjMonitor(env, (jobject) obj);
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("multinewarray", 0xc5)
 {
-    juint index = (juint) read_op2(currentFrameExt);
-    juint dimensionCount = (juint) read_op1(currentFrameExt);
+    juint index = (juint) READ_OP2();
+    juint dimensionCount = (juint) READ_OP1();
     jint i, dimension;
 
     /* Get and resolve class definition of array to create */
@@ -1965,10 +2340,11 @@ OPCODE("multinewarray", 0xc5)
 }
 
 OPCODE("new", 0xbb)
+JEM_BEGIN_CALLOUT
 {
     JEM_ClassData *classData =
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEMCC_Object *newObject;
     JEMCC_Class *newClass;
 
@@ -1983,10 +2359,12 @@ fprintf(stderr, "OBJECT CREATED %p\n", newObject);
         }
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("newarray", 0xbc)
+JEM_BEGIN_CALLOUT
 {
-    jint type = read_op1(currentFrameExt);
+    jint type = READ_OP1();
     jsize size = (jsize) JEMCC_POP_STACK_INT(currentFrame);
     JEMCC_Object *array = NULL;
 
@@ -2019,6 +2397,7 @@ OPCODE("newarray", 0xbc)
     }
     if (array != NULL) JEMCC_PUSH_STACK_OBJECT(currentFrame, array);
 }
+JEM_END_CALLOUT
 
 OPCODE("nop", 0x0)
 {
@@ -2039,7 +2418,7 @@ OPCODE("putfield", 0xb5)
 {
     JEM_ClassData *classData =
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassFieldData *fieldRef = classData->classFieldRefs[index];
     JEMCC_Object *targObj;
     jbyte *basePtr;
@@ -2084,8 +2463,10 @@ OPCODE("putfield", 0xb5)
         /* Snare the object into which the value is stored */
         targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
         if (targObj == NULL) {
+            JEM_BEGIN_CALLOUT
             JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                        NULL, NULL);
+            JEM_END_CALLOUT
         } else {
 #ifdef DEBUG_CPU_INTERNALS
 (void) fprintf(stderr, "Storing field to object %s\n",
@@ -2126,21 +2507,143 @@ fprintf(stderr, "TARGET %p offset %i\n", targObj, fieldRef->fieldOffset);
                 case DESCRIPTOR_ObjectType:
                 case DESCRIPTOR_ArrayType:
                     *((JEMCC_Object **) basePtr) = val.objVal;
+                    JEMCC_MarkNonLocalObject(env, val.objVal);
                     break;
                 default:
+                    JEM_BEGIN_CALLOUT
                     JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError, 
                                            NULL, "Unknown putfield data type");
+                    JEM_END_CALLOUT
                     break;
             }
         }
     }
 }
 
+/*
+ * Quick variants of putfield, see the getfield_quick opcodes above.
+ */
+OPCODE("putfield_quick_byte", 0xd1)
+{
+    juint offset = (juint) READ_OP2();
+    jint val = JEMCC_POP_STACK_INT(currentFrame);
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        *((jbyte *) basePtr) = (jbyte) (val & 0xFF);
+    }
+}
+
+OPCODE("putfield_quick_char", 0xd2)
+{
+    juint offset = (juint) READ_OP2();
+    jint val = JEMCC_POP_STACK_INT(currentFrame);
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        *((jchar *) basePtr) = (jchar) (val & 0xFFFF);
+    }
+}
+
+OPCODE("putfield_quick_short", 0xd3)
+{
+    juint offset = (juint) READ_OP2();
+    jint val = JEMCC_POP_STACK_INT(currentFrame);
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        *((jshort *) basePtr) = (jshort) (val & 0xFFFF);
+    }
+}
+
+OPCODE("putfield_quick_int", 0xd4)
+{
+    juint offset = (juint) READ_OP2();
+    jint val = JEMCC_POP_STACK_INT(currentFrame);
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        *((jint *) basePtr) = val;
+    }
+}
+
+OPCODE("putfield_quick_long", 0xd5)
+{
+    juint offset = (juint) READ_OP2();
+    jlong val = JEMCC_POP_STACK_LONG(currentFrame);
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        *((jlong *) basePtr) = val;
+    }
+}
+
+OPCODE("putfield_quick_object", 0xd6)
+{
+    juint offset = (juint) READ_OP2();
+    JEMCC_Object *val = JEMCC_POP_STACK_OBJECT(currentFrame);
+    JEMCC_Object *targObj = JEMCC_POP_STACK_OBJECT(currentFrame);
+    jubyte *basePtr;
+
+    if (targObj == NULL) {
+        JEM_BEGIN_CALLOUT
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
+                                   NULL, NULL);
+        JEM_END_CALLOUT
+    } else {
+        basePtr = ((jubyte *) &(((JEMCC_ObjectExt *) targObj)->objectData)) +
+                                                                       offset;
+        *((JEMCC_Object **) basePtr) = val;
+        JEMCC_MarkNonLocalObject(env, val);
+    }
+}
+
 OPCODE("putstatic", 0xb3)
+JEM_BEGIN_CALLOUT
 {
     JEM_ClassData *classData =
                       currentFrameExt->currentMethod->parentClass->classData;
-    juint index = (juint) read_op2(currentFrameExt);
+    juint index = (juint) READ_OP2();
     JEM_ClassFieldData *fieldRef = classData->classFieldRefs[index];
     jbyte *staticData;
 
@@ -2195,6 +2698,8 @@ OPCODE("putstatic", 0xb3)
                 JEMCC_DEBUG_STACK_OBJECT(currentFrame);
                 *((JEMCC_Object **) staticData) =
                         JEMCC_POP_STACK_OBJECT(currentFrame);
+                JEMCC_MarkNonLocalObject(env, 
+                                      *((JEMCC_Object **) staticData));
                 break;
             default:
                 JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError, 
@@ -2203,20 +2708,24 @@ OPCODE("putstatic", 0xb3)
         }
     }
 }
+JEM_END_CALLOUT
 
 OPCODE("ret", 0xa9)
 {
-    juint index = (juint) read_op1(currentFrameExt);
-    currentFrameExt->pc = JEMCC_LOAD_INT(currentFrame, index);
+    juint index = (juint) READ_OP1();
+    JEM_PC = JEMCC_LOAD_INT(currentFrame, index);
 }
 
 OPCODE("return", 0xb1)
+JEM_BEGIN_CALLOUT
 {
     /* delete the current frame (and contained words) */
     /* if synchronized, release monitor */
     /* make invoker frame current and continue execution */
+    JEM_FlushLocalFrameAllocations(env, NULL, NULL);
     JEM_PopFrame(env);
 }
+JEM_END_CALLOUT
 
 OPCODE("saload", 0x35)
 {
@@ -2224,13 +2733,17 @@ OPCODE("saload", 0x35)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        JEMCC_PUSH_STACK_INT(currentFrame, 
+                      (int) *(((jshort *) array->arrayData) + index));
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            JEMCC_PUSH_STACK_INT(currentFrame, 
-                          (int) *(((jshort *) array->arrayData) + index));
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
@@ -2241,19 +2754,23 @@ OPCODE("sastore", 0x56)
     JEMCC_ArrayObject *array = 
                (JEMCC_ArrayObject *) JEMCC_POP_STACK_OBJECT(currentFrame);
     if (array == NULL) {
+        JEM_BEGIN_CALLOUT
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NullPointerException, 
                                    NULL, NULL);
+        JEM_END_CALLOUT
+    } else if (JEM_ARRAY_INDEX_VALID(array, index)) {
+        *(((jshort *) array->arrayData) + index) = 
+                                                 (jshort) (val & 0xFFFF);
     } else {
-        if (JEMCC_CheckArrayLimits(env, array, index, -1) == JNI_OK) {
-            *(((jshort *) array->arrayData) + index) = 
-                                                     (jshort) (val & 0xFFFF);
-        }
+        JEM_BEGIN_CALLOUT
+        (void) JEMCC_CheckArrayLimits(env, array, index, -1);
+        JEM_END_CALLOUT
     }
 }
 
 OPCODE("sipush", 0x11)
 {
-    jshort res = (jshort) read_op2(currentFrameExt);
+    jshort res = (jshort) READ_OP2();
     JEMCC_PUSH_STACK_INT(currentFrame, (jint) res);
 }
 
@@ -2269,98 +2786,125 @@ OPCODE("swap", 0x5f)
 OPCODE("tableswitch", 0xaa)
 {
     jint switchIndex = JEMCC_POP_STACK_INT(currentFrame);
-    jint basePC = currentFrameExt->pc - 1;
+    jint basePC = JEM_PC - 1;
     jint offset, lowIndex, highIndex;
 
     /* Adjust pad to arrive at four byte offset */
-    currentFrameExt->pc = ((currentFrameExt->pc + 3) >> 2) << 2;
+    JEM_PC = ((JEM_PC + 3) >> 2) << 2;
 
     /* Read the default offset and low/high index marks */
-    offset = (jint) read_op4(currentFrameExt);
-    lowIndex = (jint) read_op4(currentFrameExt);
-    highIndex = (jint) read_op4(currentFrameExt);
+    offset = (jint) READ_OP4();
+    lowIndex = (jint) READ_OP4();
+    highIndex = (jint) READ_OP4();
 
     /* Go to default offset if index out of range, read table otherwise */
     if ((switchIndex < lowIndex) || (switchIndex > highIndex)) {
-        currentFrameExt->pc = basePC + offset;
+        JEM_PC = basePC + offset;
     } else {
-        currentFrameExt->pc = currentFrameExt->pc + 
+        JEM_PC = JEM_PC + 
                                           4 * (switchIndex - lowIndex);
-        offset = (jint) read_op4(currentFrameExt);
-        currentFrameExt->pc = basePC + offset;
+        offset = (jint) READ_OP4();
+        JEM_PC = basePC + offset;
+    }
+
+    /* Poll for a safepoint if a backward branch */
+    if (offset <= 0) { JEM_SAFEPOINT_POLL(); }
+}
+
+/*
+ * Quick variant of tableswitch, rewritten by JEM_QuickenClassByteCode.  The
+ * operand is the index of the decoded switch table for the current method,
+ * the unsigned difference from the low index covers both range tests.
+ */
+OPCODE("tableswitch_quick", 0xd9)
+{
+    JEM_SwitchTable *table =
+            currentFrameExt->currentMethod->method.bcMethod->switchTables +
+                                                                READ_OP2();
+    juint index = (juint) JEMCC_POP_STACK_INT(currentFrame) -
+                                                   (juint) table->lowIndex;
+    jint basePC = JEM_PC - 3;
+
+    if (index < (juint) table->count) {
+        JEM_PC = table->targetPCs[index];
+    } else {
+        JEM_PC = table->defaultPC;
     }
+
+    /* Poll for a safepoint if a backward branch */
+    if (JEM_PC <= basePC) { JEM_SAFEPOINT_POLL(); }
 }
 
 OPCODE("wide", 0xc4)
 {
     /* Grab the contained opcode and the expanded local variable index */
-    jubyte wideOpCode = read_op1(currentFrameExt);
-    juint index = (juint) read_op2(currentFrameExt);
+    jubyte wideOpCode = READ_OP1();
+    juint index = (juint) READ_OP2();
 
     /* Perform the opcode based handling of the wide index */
     switch (wideOpCode) {
         default:
             /* TODO - Ack Barf! */
-        OPCODE("aload", 0x19)
+        WIDE_OPCODE("aload", 0x19)
             {
                 JEMCC_PUSH_STACK_OBJECT(currentFrame, 
                                         JEMCC_LOAD_OBJECT(currentFrame, index));
             }
-        OPCODE("astore", 0x3a)
+        WIDE_OPCODE("astore", 0x3a)
             {
                 JEMCC_STORE_OBJECT(currentFrame, index, 
                                    JEMCC_POP_STACK_OBJECT(currentFrame));
             }
-        OPCODE("dload", 0x18)
+        WIDE_OPCODE("dload", 0x18)
             {
                 JEMCC_PUSH_STACK_DOUBLE(currentFrame, 
                                         JEMCC_LOAD_DOUBLE(currentFrame, index));
             }
-        OPCODE("dstore", 0x39)
+        WIDE_OPCODE("dstore", 0x39)
             {
                 JEMCC_STORE_DOUBLE(currentFrame, index, 
                                    JEMCC_POP_STACK_DOUBLE(currentFrame));
             }
-        OPCODE("fload", 0x17)
+        WIDE_OPCODE("fload", 0x17)
             {
                 JEMCC_PUSH_STACK_FLOAT(currentFrame, 
                                        JEMCC_LOAD_FLOAT(currentFrame, index));
             }
-        OPCODE("fstore", 0x38)
+        WIDE_OPCODE("fstore", 0x38)
             {
                 JEMCC_STORE_FLOAT(currentFrame, index, 
                                   JEMCC_POP_STACK_FLOAT(currentFrame));
             }
-        OPCODE("iinc", 0x84)
+        WIDE_OPCODE("iinc", 0x84)
             {
-                jshort adj = (jshort) read_op2(currentFrameExt);
+                jshort adj = (jshort) READ_OP2();
                 currentFrame->localVars[index].i += adj;
             }
-        OPCODE("iload", 0x15)
+        WIDE_OPCODE("iload", 0x15)
             {
                 JEMCC_PUSH_STACK_INT(currentFrame, 
                                      JEMCC_LOAD_INT(currentFrame, index));
             }
-        OPCODE("istore", 0x36)
+        WIDE_OPCODE("istore", 0x36)
             {
                 JEMCC_STORE_INT(currentFrame, index, 
                                 JEMCC_POP_STACK_INT(currentFrame));
             }
-        OPCODE("lload", 0x16)
+        WIDE_OPCODE("lload", 0x16)
             {
                 JEMCC_PUSH_STACK_LONG(currentFrame, 
                                       JEMCC_LOAD_LONG(currentFrame, index));
             }
-        OPCODE("lstore", 0x37)
+        WIDE_OPCODE("lstore", 0x37)
             {
                 JEMCC_STORE_LONG(currentFrame, index, 
                                  JEMCC_POP_STACK_LONG(currentFrame));
             }
-        OPCODE("ret", 0xa9)
+        WIDE_OPCODE("ret", 0xa9)
             {
-                currentFrameExt->pc = JEMCC_LOAD_INT(currentFrame, index);
+                JEM_PC = JEMCC_LOAD_INT(currentFrame, index);
             }
-       OPCODE("dummy", 0xff) 
+       WIDE_OPCODE("dummy", 0xff) 
             {
                /* This will never be called, just here for debugging */
             }
@@ -143,7 +143,8 @@ void JEM_DestroyPathList(JNIEnv *env, JEM_PathEntryList *list) {
     if (list->entries != NULL) {
         /* Need to flush all open zipfile instances */
         for (i = 0; i < list->entryCount; i++) {
-            if (list->entries[i].type == JEM_PATH_JARZIP) {
+            if ((list->entries[i].type == JEM_PATH_JARZIP) ||
+                    (list->entries[i].type == JEM_PATH_BADZIP)) {
                 JEMCC_CloseZipFile(env, list->entries[i].zipFile);
             }
         }
@@ -154,6 +155,99 @@ void JEM_DestroyPathList(JNIEnv *env, JEM_PathEntryList *list) {
     }
 }
 
+/**
+ * Common search/read method for the path file methods below.  If isMapped
+ * is NULL, the file contents are returned in an allocated buffer, otherwise
+ * they are mapped or read into the environment scratch buffer.
+ */
+static jint readPathFile(JNIEnv *env, JEM_PathEntryList *pathList,
+                         const char *fileName, jbyte **rawFileData,
+                         jsize *rawFileSize, jboolean *isMapped) {
+    JEMCC_ZipFileEntry zfentry;
+    int i, rc, offset;
+    char *targName;
+    jsize len;
+    FILE *fp;
+
+    /* Search the path list for the file, depending on entry type */
+    for (i = 0; i < pathList->entryCount; i++) {
+        switch (pathList->entries[i].type) {
+            case JEM_PATH_DIR:
+                /* Determine the proper filename and verify its existence */
+                if (JEMCC_EnvStrBufferInit(env, 100) == NULL) return JNI_ENOMEM;
+                targName = JEMCC_EnvStrBufferAppendSet(env,
+                                              pathList->entries[i].path,
+                                              JEMCC_FileSeparatorStr, fileName,
+                                              (char *) NULL);
+                if (targName == NULL) return JNI_ENOMEM;
+                if ((len = JEMCC_GetFileSize(targName)) <= 0) break;
+
+                /* Read the contents of the file into memory */
+                if (isMapped != NULL) {
+                    *isMapped = JNI_FALSE;
+                    *rawFileData = JEM_EnvScratchBuffer(env, len + 4);
+                } else {
+                    *rawFileData = (jbyte *) JEMCC_Malloc(env, len + 4);
+                }
+                if (*rawFileData == NULL) return JNI_ENOMEM;
+                fp = fopen(targName, "rb");
+                if (ERROR_SWEEP(ES_DATA, fp == NULL)) {
+                    if (isMapped == NULL) JEMCC_Free(*rawFileData);
+                    JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException,
+                                               NULL, "Path file open failed");
+                    return JNI_ERR;
+                }
+                offset = 0;
+                while ((rc = fread(*rawFileData + offset, 1,
+                                   len - offset + 1, fp)) != 0) offset += rc;
+                if (ERROR_SWEEP(ES_DATA, (feof(fp) == 0) || (offset != len))) {
+                    /* Read error or file size has changed */
+                    (void) fclose(fp);
+                    if (isMapped == NULL) JEMCC_Free(*rawFileData);
+                    JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException,
+                                               NULL, "Path file read failed");
+                    return JNI_ERR;
+                }
+                (void) fclose(fp);
+                *rawFileSize = len;
+                return JNI_OK;
+            case JEM_PATH_JARZIP:
+                rc = JEMCC_FindZipFileEntry(env, pathList->entries[i].zipFile,
+                                            fileName, &zfentry, JNI_TRUE);
+                if (rc == JNI_ENOMEM) return rc;
+                if (ERROR_SWEEP(ES_DATA, rc == JNI_ERR)) {
+                    /* Zip file is corrupt, stop using it (but mapped */
+                    /* data may still be referenced, so close later)  */
+                    pathList->entries[i].type = JEM_PATH_BADZIP;
+                    break;
+                }
+                if (rc == JNI_OK) {
+                    len = zfentry.uncompressedSize;
+                    if (isMapped != NULL) {
+                        *rawFileData = JEM_MapZipFileEntry(env,
+                                                   pathList->entries[i].zipFile,
+                                                   &zfentry, isMapped);
+                    } else {
+                        *rawFileData = JEMCC_ReadZipFileEntry(env,
+                                                   pathList->entries[i].zipFile,
+                                                   &zfentry);
+                    }
+                    JEMCC_ReleaseZipFileEntry(env, pathList->entries[i].zipFile,
+                                              &zfentry);
+                    if (*rawFileData == NULL) return JNI_ERR;
+                    *rawFileSize = len;
+                    return JNI_OK;
+                }
+                break;
+            default:
+                /* Do nothing here, just ignore the entry */
+                break;
+        }
+    }
+
+    return JNI_EINVAL;
+}
+
 /**
  * Read the contents of a file located in the specified path list.
  * Scans each path location in order until it finds the requested file,
@@ -189,69 +283,112 @@ void JEM_DestroyPathList(JNIEnv *env, JEM_PathEntryList *list) {
 jint JEM_ReadPathFileContents(JNIEnv *env, JEM_PathEntryList *pathList,
                               const char *fileName, jbyte **rawFileData,
                               jsize *rawFileSize) {
+    return readPathFile(env, pathList, fileName, rawFileData,
+                        rawFileSize, NULL);
+}
+
+/**
+ * Obtain the contents of a file located in the specified path list, without
+ * an allocated copy.  Identical to the ReadPathFileContents method above,
+ * except that stored entries of (mapped) Zip files are returned directly
+ * from the mapped region and all other files are inflated/read into the
+ * environment scratch buffer.  Primarily for class loading, where the
+ * parser copies (or references, if mapped) the required information.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     pathList - the path entry set on which the file is located
+ *     fileName - the name of the file to be read
+ *     rawFileData - the contents of the file, either in the mapped region
+ *                   (valid while the path list is open) or the environment
+ *                   scratch buffer (valid until its next use).  Must not be
+ *                   freed or modified by the caller.
+ *     rawFileSize - the size of the file (and hence the buffer contents)
+ *     isMapped - a reference through which JNI_TRUE is returned if the
+ *                file contents are in a persistent mapped region
+ *
+ * Returns:
+ *     JNI_OK - the file was found and the read completed successfully
+ *     JNI_EINVAL - the specified file was not found on the path
+ *     JNI_ERR - the file was found and a read error occurred or a memory
+ *               failure occurred while *reading* the file (an exception    
+ *               will be thrown in the current environment)
+ *     JNI_ENOMEM - a memory failure occurred while *searching* for the
+ *                  file (an exception will be thrown in the current 
+ *                  environment)
+ *
+ * Exceptions:
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     InternalError - an unexpected zlib library error occurred
+ *     OutOfMemoryError - a memory allocation failed (search or read)
+ */
+jint JEM_MapPathFileContents(JNIEnv *env, JEM_PathEntryList *pathList,
+                             const char *fileName, jbyte **rawFileData,
+                             jsize *rawFileSize, jboolean *isMapped) {
+    return readPathFile(env, pathList, fileName, rawFileData,
+                        rawFileSize, isMapped);
+}
+
+/**
+ * Locate the first entry of the path list which provides the given file,
+ * without reading the file contents (the search order and the handling
+ * of corrupt Zip files matches the read methods above).  Used to validate
+ * previously recorded information about the file.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     pathList - the path entry set on which the file is located
+ *     fileName - the name of the file to be located
+ *     entryIndex - the index of the path entry containing the file
+ *     fileSize - the size of the file (uncompressed, for Zip/Jar entries)
+ *     crc32 - the checksum of the file from the Zip/Jar directory (zero for
+ *             directory path entries)
+ *
+ * Returns:
+ *     JNI_OK - the file was found and the details have been returned
+ *     JNI_EINVAL - the specified file was not found on the path
+ *     JNI_ENOMEM - a memory failure occurred while searching for the file
+ *                  (an exception will be thrown in the current environment)
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_LocatePathFile(JNIEnv *env, JEM_PathEntryList *pathList,
+                        const char *fileName, jint *entryIndex,
+                        jsize *fileSize, juint *crc32) {
     JEMCC_ZipFileEntry zfentry;
-    int i, rc, offset;
     char *targName;
-    jsize len;
-    FILE *fp;
+    int i, rc;
 
-    /* Search the path list for the file, depending on entry type */
     for (i = 0; i < pathList->entryCount; i++) {
         switch (pathList->entries[i].type) {
             case JEM_PATH_DIR:
-                /* Determine the proper filename and verify its existence */
                 if (JEMCC_EnvStrBufferInit(env, 100) == NULL) return JNI_ENOMEM;
                 targName = JEMCC_EnvStrBufferAppendSet(env,
                                               pathList->entries[i].path,
                                               JEMCC_FileSeparatorStr, fileName,
                                               (char *) NULL);
                 if (targName == NULL) return JNI_ENOMEM;
-                if ((len = JEMCC_GetFileSize(targName)) <= 0) break;
-
-                /* Read the contents of the file into memory */
-                *rawFileData = (jbyte *) JEMCC_Malloc(env, len + 4);
-                if (*rawFileData == NULL) return JNI_ENOMEM;
-                fp = fopen(targName, "rb");
-                if (ERROR_SWEEP(ES_DATA, fp == NULL)) {
-                    JEMCC_Free(*rawFileData);
-                    JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException,
-                                               NULL, "Path file open failed");
-                    return JNI_ERR;
-                }
-                offset = 0;
-                while ((rc = fread(*rawFileData + offset, 1,
-                                   len - offset + 1, fp)) != 0) offset += rc;
-                if (ERROR_SWEEP(ES_DATA, (feof(fp) == 0) || (offset != len))) {
-                    /* Read error or file size has changed */
-                    (void) fclose(fp);
-                    JEMCC_Free(*rawFileData);
-                    JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException,
-                                               NULL, "Path file read failed");
-                    return JNI_ERR;
-                }
-                (void) fclose(fp);
-                *rawFileSize = len;
+                if ((*fileSize = JEMCC_GetFileSize(targName)) <= 0) break;
+                *entryIndex = i;
+                *crc32 = 0;
                 return JNI_OK;
             case JEM_PATH_JARZIP:
                 rc = JEMCC_FindZipFileEntry(env, pathList->entries[i].zipFile,
                                             fileName, &zfentry, JNI_TRUE);
                 if (rc == JNI_ENOMEM) return rc;
                 if (ERROR_SWEEP(ES_DATA, rc == JNI_ERR)) {
-                    /* Zip file is corrupt, stop using it */
-                    pathList->entries[i].type = JEM_PATH_INV;
-                    /* But make sure to clean up the references */
-                    JEMCC_CloseZipFile(env, pathList->entries[i].zipFile);
+                    pathList->entries[i].type = JEM_PATH_BADZIP;
                     break;
                 }
                 if (rc == JNI_OK) {
-                    len = zfentry.uncompressedSize;
-                    *rawFileData = JEMCC_ReadZipFileEntry(env,
-                                                   pathList->entries[i].zipFile,
-                                                   &zfentry);
+                    *entryIndex = i;
+                    *fileSize = zfentry.uncompressedSize;
+                    *crc32 = zfentry.crc32;
                     JEMCC_ReleaseZipFileEntry(env, pathList->entries[i].zipFile,
                                               &zfentry);
-                    if (rawFileData == NULL) return JNI_ERR;
-                    *rawFileSize = len;
                     return JNI_OK;
                 }
                 break;
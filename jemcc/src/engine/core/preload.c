@@ -0,0 +1,478 @@
+/**
+ * Parallel preloading of the system (classpath) class set.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU Lesser General Public
+ * License, as well as further clarification on your rights to use this
+ * software.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+#include "jeminc.h"
+
+/* Read the VM structure/method definitions */
+#include "jem.h"
+
+/* Number of parsing threads, where not specified by the VM properties */
+#define PRELOAD_DEFAULT_WORKER_COUNT 4
+
+/* Processing states of the preload entries */
+#define PRELOAD_PENDING 0
+#define PRELOAD_PARSING 1
+#define PRELOAD_PARSED 2
+#define PRELOAD_DONE 3
+
+/* Growable set of (dotted) class names to be preloaded */
+typedef struct JEM_PreloadNameList {
+    char **names;
+    juint count, capacity;
+    jboolean memFailure;
+} JEM_PreloadNameList;
+
+/* Preload record of a class, parsed by a worker and claimed by the loader */
+typedef struct JEM_PreloadEntry {
+    char *className;
+    JEM_ParsedClassData *pData;
+    jint state;
+} JEM_PreloadEntry;
+
+typedef struct JEM_PreloadControl {
+    JEM_JavaVM *jvm;
+
+    /* Worker management (monitor also controls the entry states) */
+    JEMCC_SysMonitor *monitor;
+    juint workerCount, exitCount;
+    jboolean shutdown;
+
+    /* Class entries, in load order, and the class name lookup table */
+    JEM_PreloadEntry *entries;
+    juint entryCount, nextEntry;
+    JEMCC_HashTable entryTable;
+} JEM_PreloadControl;
+
+/**
+ * Append a class name (of the given length, in either dotted or directory
+ * format) to the preload name list.  Returns JNI_OK if successful or
+ * JNI_ENOMEM if a memory allocation failed.
+ */
+static jint JEM_PreloadAddName(JNIEnv *env, JEM_PreloadNameList *list,
+                               const char *name, juint length) {
+    char **names, *ptr;
+
+    if (list->count >= list->capacity) {
+        names = (char **) JEMCC_Malloc(env,
+                               (2 * list->capacity + 64) * sizeof(char *));
+        if (names == NULL) return JNI_ENOMEM;
+        if (list->names != NULL) {
+            (void) memcpy(names, list->names, list->count * sizeof(char *));
+            JEMCC_Free(list->names);
+        }
+        list->names = names;
+        list->capacity = 2 * list->capacity + 64;
+    }
+
+    ptr = (char *) JEMCC_Malloc(env, length + 1);
+    if (ptr == NULL) return JNI_ENOMEM;
+    (void) memcpy(ptr, name, length);
+    ptr[length] = '\0';
+    JEM_SlashToDot(ptr);
+    list->names[list->count++] = ptr;
+
+    return JNI_OK;
+}
+
+/**
+ * Release the (unclaimed) names and storage of the preload name list.
+ */
+static void JEM_PreloadFreeNames(JEM_PreloadNameList *list) {
+    juint i;
+
+    for (i = 0; i < list->count; i++) {
+        if (list->names[i] != NULL) JEMCC_Free(list->names[i]);
+    }
+    if (list->names != NULL) JEMCC_Free(list->names);
+}
+
+/**
+ * Read the list of classes to be preloaded from the given file.  Each line
+ * contains a single class name (dotted or directory format, with or without
+ * a trailing .class) and '#' introduces a comment.  Returns JNI_OK if the
+ * file was read, JNI_ERR if it could not be opened (an IOException is
+ * thrown) or JNI_ENOMEM if a memory allocation failed.
+ */
+static jint JEM_PreloadReadClassList(JNIEnv *env, const char *fileName,
+                                     JEM_PreloadNameList *list) {
+    char line[1024], *ptr, *end;
+    FILE *fp;
+
+    fp = fopen(fileName, "r");
+    if (fp == NULL) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, NULL,
+                                   "Unable to open preload class list");
+        return JNI_ERR;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        ptr = line;
+        while ((*ptr == ' ') || (*ptr == '\t')) ptr++;
+        end = ptr;
+        while ((*end != '\0') && (*end != '#') && (*end != ' ') &&
+               (*end != '\t') && (*end != '\r') && (*end != '\n')) end++;
+        if ((end - ptr > 6) && (strncmp(end - 6, ".class", 6) == 0)) end -= 6;
+        if (end == ptr) continue;
+
+        if (JEM_PreloadAddName(env, list, ptr, end - ptr) != JNI_OK) {
+            (void) fclose(fp);
+            return JNI_ENOMEM;
+        }
+    }
+    (void) fclose(fp);
+
+    return JNI_OK;
+}
+
+/**
+ * Archive scanning callback to collect the class entries of a classpath
+ * Zip/Jar file.
+ */
+static jint JEM_PreloadEntryCB(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                               JEMCC_ZipFileEntry *zipEntry, void *userData) {
+    JEM_PreloadNameList *list = (JEM_PreloadNameList *) userData;
+    juint len = zipEntry->fileNameLength;
+
+    if ((len <= 6) ||
+        (memcmp(zipEntry->fileName + len - 6, ".class", 6) != 0)) {
+        return JNI_OK;
+    }
+    if (JEM_PreloadAddName(env, list, (char *) zipEntry->fileName,
+                           len - 6) != JNI_OK) {
+        list->memFailure = JNI_TRUE;
+        return JNI_ERR;
+    }
+
+    return JNI_OK;
+}
+
+/**
+ * Allocate the preload control structure for the given name list, taking
+ * ownership of the names.  Duplicate names (the first instance determines
+ * the load order) are discarded.  Returns NULL if a memory allocation
+ * failed (an OutOfMemoryError will have been thrown).
+ */
+static JEM_PreloadControl *JEM_PreloadCreateControl(JNIEnv *env,
+                                               JEM_PreloadNameList *list) {
+    JEM_PreloadControl *ctrl;
+    JEM_PreloadEntry *entry;
+    juint i;
+    jint rc;
+
+    ctrl = (JEM_PreloadControl *) JEMCC_Malloc(env,
+                                               sizeof(JEM_PreloadControl));
+    if (ctrl == NULL) return NULL;
+    ctrl->jvm = ((JEM_JNIEnv *) env)->parentVM;
+    ctrl->entries = (JEM_PreloadEntry *) JEMCC_Malloc(env,
+                               (list->count + 1) * sizeof(JEM_PreloadEntry));
+    ctrl->monitor = JEMCC_CreateSysMonitor(env);
+    if ((ctrl->entries == NULL) || (ctrl->monitor == NULL) ||
+        (JEMCC_HashInitTable(env, &(ctrl->entryTable),
+                             list->count) != JNI_OK)) {
+        if (ctrl->monitor != NULL) JEMCC_DestroySysMonitor(ctrl->monitor);
+        if (ctrl->entries != NULL) JEMCC_Free(ctrl->entries);
+        JEMCC_Free(ctrl);
+        return NULL;
+    }
+
+    for (i = 0; i < list->count; i++) {
+        entry = &(ctrl->entries[ctrl->entryCount]);
+        rc = JEMCC_HashInsertEntry(env, &(ctrl->entryTable), list->names[i],
+                                   entry, NULL, NULL,
+                                   JEMCC_StrHashFn, JEMCC_StrEqualsFn);
+        if (rc == JNI_ENOMEM) {
+            /* Hand the stored names back to the list for release */
+            JEMCC_HashDestroyTable(&(ctrl->entryTable));
+            for (i = 0; i < ctrl->entryCount; i++) {
+                list->names[i] = ctrl->entries[i].className;
+            }
+            JEMCC_DestroySysMonitor(ctrl->monitor);
+            JEMCC_Free(ctrl->entries);
+            JEMCC_Free(ctrl);
+            return NULL;
+        }
+        if (rc == JNI_OK) {
+            entry->className = list->names[i];
+            entry->state = PRELOAD_PENDING;
+            ctrl->entryCount++;
+        } else {
+            JEMCC_Free(list->names[i]);
+        }
+        list->names[i] = NULL;
+    }
+
+    return ctrl;
+}
+
+/**
+ * Release the preload control structure, along with any class data which
+ * was parsed but never claimed by the loader (the workers must have exited).
+ */
+static void JEM_PreloadDestroyControl(JEM_PreloadControl *ctrl) {
+    juint i;
+
+    for (i = 0; i < ctrl->entryCount; i++) {
+        if (ctrl->entries[i].pData != NULL) {
+            JEM_DestroyParsedClassData(ctrl->entries[i].pData);
+        }
+        JEMCC_Free(ctrl->entries[i].className);
+    }
+    JEMCC_HashDestroyTable(&(ctrl->entryTable));
+    JEMCC_DestroySysMonitor(ctrl->monitor);
+    JEMCC_Free(ctrl->entries);
+    JEMCC_Free(ctrl);
+}
+
+/**
+ * Locate and parse the class data for the given class name from the VM
+ * classpath (mirrors the lookup of JEM_GetSystemClass).  Returns NULL if
+ * the class was not found or could not be parsed - the worker exception is
+ * discarded, as the loader will repeat the load and report the failure.
+ */
+static JEM_ParsedClassData *JEM_PreloadParseClass(JNIEnv *env,
+                                                  const char *className) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    JEM_ParsedClassData *pData = NULL;
+    jbyte *rawClassData;
+    jsize rawClassLen;
+    jboolean isMapped;
+    char *ptr, *fileName;
+    int rc;
+
+    if ((JEMCC_EnvStrBufferInit(env, 100) == NULL) ||
+        (JEMCC_EnvStrBufferAppendSet(env, (char *) className, ".class",
+                                     (char *) NULL) == NULL) ||
+        ((fileName = JEMCC_EnvStrBufferDup(env)) == NULL)) {
+        ((JEM_JNIEnv *) env)->pendingException = NULL;
+        return NULL;
+    }
+    ptr = fileName + strlen(fileName) - 7;
+    while (ptr >= fileName) {
+        if (*ptr == '.') *ptr = JEMCC_FileSeparator;
+        ptr--;
+    }
+
+    rc = JEM_MapPathFileContents(env, &(jvm->classPath), fileName,
+                                 &rawClassData, &rawClassLen, &isMapped);
+    JEMCC_Free(fileName);
+    if ((rc == JNI_OK) && (rawClassLen >= 0)) {
+        pData = JEM_ParseClassData(env, rawClassData, rawClassLen, isMapped);
+    }
+    ((JEM_JNIEnv *) env)->pendingException = NULL;
+
+    return pData;
+}
+
+/**
+ * Thread start function for the preload workers.  Each worker claims the
+ * next pending entry (in load order) and parses the class data, until all
+ * of the entries are claimed or the preload is complete.  The parsing does
+ * not involve the object heap (other than the discarded exceptions, whose
+ * allocation temporarily leaves the region) so the workers run entirely
+ * in a collection safe region.
+ */
+static void *JEM_PreloadWorker(JNIEnv *env, void *userArg) {
+    JEM_PreloadControl *ctrl = (JEM_PreloadControl *) userArg;
+    JEM_ParsedClassData *pData;
+    JEM_PreloadEntry *entry;
+
+    JEM_GCEnterSafeRegion(env);
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    while ((ctrl->shutdown == JNI_FALSE) &&
+           (ctrl->nextEntry < ctrl->entryCount)) {
+        entry = &(ctrl->entries[ctrl->nextEntry++]);
+        if (entry->state != PRELOAD_PENDING) continue;
+        entry->state = PRELOAD_PARSING;
+        (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+        pData = JEM_PreloadParseClass(env, entry->className);
+
+        JEMCC_EnterSysMonitor(ctrl->monitor);
+        entry->pData = pData;
+        entry->state = (pData != NULL) ? PRELOAD_PARSED : PRELOAD_DONE;
+        (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+    }
+
+    ctrl->exitCount++;
+    (void) JEMCC_SysMonitorNotifyAll(ctrl->monitor);
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+    JEM_GCLeaveSafeRegion(env);
+
+    return NULL;
+}
+
+/**
+ * Obtain the preparsed class data for the given class, if a preload is
+ * underway and the class is part of the preload set.  Waits if the class
+ * is currently being parsed by a preload worker.  Each entry can only be
+ * claimed once - if the class has not yet been parsed, it is removed from
+ * the worker queue (the caller loads the class directly).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     className - the fully qualified (dotted) name of the class to claim
+ *     pData - the parsed class data reference through which the preparsed
+ *             class information is returned (if available).  The caller
+ *             takes ownership of the parsed data
+ *
+ * Returns:
+ *     JNI_OK - the class has been preparsed and the data has been returned
+ *              through the pData reference
+ *     JNI_EINVAL - no preparsed data is available for the class (no
+ *                  exception is thrown)
+ */
+jint JEM_ClaimPreloadedClass(JNIEnv *env, const char *className,
+                             JEM_ParsedClassData **pData) {
+    JEM_PreloadControl *ctrl = ((JEM_JNIEnv *) env)->parentVM->preloadControl;
+    JEM_PreloadEntry *entry;
+
+    if (ctrl == NULL) return JNI_EINVAL;
+    entry = (JEM_PreloadEntry *) JEMCC_HashGetEntry(env, &(ctrl->entryTable),
+                                                    (void *) className,
+                                                    JEMCC_StrHashFn,
+                                                    JEMCC_StrEqualsFn);
+    if (entry == NULL) return JNI_EINVAL;
+
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    if (entry->state == PRELOAD_PARSING) {
+        JEM_GCEnterSafeRegion(env);
+        while (entry->state == PRELOAD_PARSING) {
+            (void) JEMCC_SysMonitorWait(ctrl->monitor);
+        }
+        JEM_GCLeaveSafeRegion(env);
+    }
+    *pData = entry->pData;
+    entry->pData = NULL;
+    entry->state = PRELOAD_DONE;
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+
+    return (*pData != NULL) ? JNI_OK : JNI_EINVAL;
+}
+
+/**
+ * Preload a set of classes through the system classloader, parsing the
+ * class data in parallel.  A pool of worker threads parses the classes
+ * in list order, while the calling (loader) thread defines and links
+ * each class in turn.  As the linking of a class resolves the superclass
+ * and interfaces first, the loader claims the parsed data in dependency
+ * order through JEM_GetSystemClass, waiting only for classes which are
+ * still being parsed.  Classes which fail to load are skipped (the failure
+ * will be reported again by a subsequent load request).  NOTE: this method
+ * is only intended to be used during VM initialization.
+ *
+ * As the Zip/Jar file access is only thread-safe for memory mapped
+ * archives, the workers are only used where mmap() is available,
+ * otherwise all classes are parsed by the loader thread.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     classListFile - the name of a file containing the list of classes to
+ *                     be preloaded (one per line).  If NULL, all of the
+ *                     classes contained in the Zip/Jar files of the VM
+ *                     classpath are preloaded
+ *     workerCount - the number of parsing threads to start (if <= 0, a
+ *                   default number of threads is used)
+ *
+ * Returns:
+ *     JNI_OK - the preload was completed
+ *     JNI_ERR - the class list file could not be read (an exception has been
+ *               thrown in the current environment)
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ *     IOException - the class list file could not be opened
+ */
+jint JEM_PreloadSystemClasses(JNIEnv *env, const char *classListFile,
+                              jint workerCount) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_PathEntryList *classPath = &(jvm->classPath);
+    JEM_PreloadNameList list;
+    JEM_PreloadControl *ctrl;
+    JEMCC_Class *classInst;
+    jint i, rc = JNI_OK;
+
+    /* Collect the set of classes to be preloaded */
+    list.names = NULL;
+    list.count = list.capacity = 0;
+    list.memFailure = JNI_FALSE;
+    if (classListFile != NULL) {
+        rc = JEM_PreloadReadClassList(env, classListFile, &list);
+    } else {
+        for (i = 0; i < classPath->entryCount; i++) {
+            if (classPath->entries[i].type != JEM_PATH_JARZIP) continue;
+            rc = JEMCC_ScanZipFileEntries(env, classPath->entries[i].zipFile,
+                                          JEM_PreloadEntryCB, &list, JNI_TRUE);
+            if (list.memFailure != JNI_FALSE) rc = JNI_ENOMEM;
+            if (rc == JNI_ENOMEM) break;
+
+            /* Unreadable archives are quietly ignored by the loader too */
+            rc = JNI_OK;
+        }
+    }
+    if ((rc != JNI_OK) ||
+            ((ctrl = JEM_PreloadCreateControl(env, &list)) == NULL)) {
+        JEM_PreloadFreeNames(&list);
+        return (rc != JNI_OK) ? rc : JNI_ENOMEM;
+    }
+    JEM_PreloadFreeNames(&list);
+
+    /* Start the parsing threads (fewer is acceptable) */
+#ifdef HAVE_MMAP
+    if (workerCount <= 0) workerCount = PRELOAD_DEFAULT_WORKER_COUNT;
+    for (i = 0; i < workerCount; i++) {
+        if (JEMCC_CreateThread(env, JEM_PreloadWorker, ctrl, 5) == 0) {
+            jenv->pendingException = NULL;
+            break;
+        }
+    }
+    ctrl->workerCount = i;
+#endif
+    jvm->preloadControl = ctrl;
+
+    /* Define/link the classes in order, consuming the parsed data */
+    for (i = 0; i < (jint) ctrl->entryCount; i++) {
+        rc = JEMCC_LocateClass(env, jvm->systemClassLoader,
+                               ctrl->entries[i].className, JNI_FALSE,
+                               &classInst);
+        if (rc == JNI_ENOMEM) break;
+        jenv->pendingException = NULL;
+        rc = JNI_OK;
+    }
+    jvm->preloadControl = NULL;
+
+    /* Stop any remaining workers and discard the unclaimed class data */
+    JEMCC_EnterSysMonitor(ctrl->monitor);
+    ctrl->shutdown = JNI_TRUE;
+    JEM_GCEnterSafeRegion(env);
+    while (ctrl->exitCount < ctrl->workerCount) {
+        (void) JEMCC_SysMonitorWait(ctrl->monitor);
+    }
+    JEM_GCLeaveSafeRegion(env);
+    (void) JEMCC_ExitSysMonitor(ctrl->monitor);
+    JEM_PreloadDestroyControl(ctrl);
+
+    return rc;
+}
@@ -26,6 +26,315 @@
 /* Read the VM structure/method definitions */
 #include "jem.h"
 
+/*
+ * Character kernels use the SSE2 compare/pack operations, where configure
+ * found the compiler able to build them (ENABLE_SSE2_KERNELS).  The block
+ * loops are compiled for SSE2 individually and only called if the processor
+ * reports SSE2 support, so the remainder of the library is unaffected.
+ */
+#ifdef ENABLE_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+/*
+ * Number of characters handled per block by the SSE2 kernels (one 128-bit
+ * register of 16-bit characters, or two for the 8-bit kernels).  Any
+ * partial block or a block with a match is completed with the scalar scan.
+ */
+#define KERNEL_BLOCK 8
+
+/* Use the SSE2 block loops for texts of at least the given block size */
+#ifdef ENABLE_SSE2_KERNELS
+#define USE_SSE2_BLOCKS(len, blk) (((len) >= (blk)) && JEM_CPU_HAS_SSE2())
+#endif
+
+#ifdef ENABLE_SSE2_KERNELS
+/*
+ * SSE2 block loops for the kernels below.  Each returns the index at which
+ * the scalar scan is to continue (the first partial or matching block).
+ */
+static JEM_SSE2_KERNEL jsize findWideCharBlocks(const jchar *str,
+                                                jsize len) {
+    __m128i zero = _mm_setzero_si128(), blk, narrow;
+    jsize idx = 0;
+
+    while (idx + KERNEL_BLOCK <= len) {
+        blk = _mm_loadu_si128((__m128i *) (str + idx));
+        narrow = _mm_andnot_si128(_mm_cmpeq_epi16(blk, zero),
+                         _mm_cmpeq_epi16(_mm_srli_epi16(blk, 8), zero));
+        if (_mm_movemask_epi8(narrow) != 0xFFFF) break;
+        idx += KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize scanCharBlocks(const jchar *str, jsize len,
+                                            jchar ch) {
+    __m128i match = _mm_set1_epi16((short) ch), blk;
+    jsize idx = 0;
+
+    while (idx + KERNEL_BLOCK <= len) {
+        blk = _mm_loadu_si128((__m128i *) (str + idx));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(blk, match)) != 0) break;
+        idx += KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize mismatchCharBlocks(const jchar *stra,
+                                                const jchar *strb,
+                                                jsize len) {
+    __m128i blka, blkb;
+    jsize idx = 0;
+
+    while (idx + KERNEL_BLOCK <= len) {
+        blka = _mm_loadu_si128((__m128i *) (stra + idx));
+        blkb = _mm_loadu_si128((__m128i *) (strb + idx));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(blka, blkb)) != 0xFFFF) break;
+        idx += KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize mismatchByteBlocks(const jubyte *stra,
+                                                const jubyte *strb,
+                                                jsize len) {
+    __m128i blka, blkb;
+    jsize idx = 0;
+
+    while (idx + 2 * KERNEL_BLOCK <= len) {
+        blka = _mm_loadu_si128((__m128i *) (stra + idx));
+        blkb = _mm_loadu_si128((__m128i *) (strb + idx));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(blka, blkb)) != 0xFFFF) break;
+        idx += 2 * KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize widenBlocks(jchar *dst, const jubyte *src,
+                                         jsize len) {
+    __m128i zero = _mm_setzero_si128(), blk;
+    jsize idx = 0;
+
+    while (idx + 2 * KERNEL_BLOCK <= len) {
+        blk = _mm_loadu_si128((__m128i *) (src + idx));
+        _mm_storeu_si128((__m128i *) (dst + idx),
+                         _mm_unpacklo_epi8(blk, zero));
+        _mm_storeu_si128((__m128i *) (dst + idx + KERNEL_BLOCK),
+                         _mm_unpackhi_epi8(blk, zero));
+        idx += 2 * KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize narrowBlocks(jubyte *dst, const jchar *src,
+                                          jsize len) {
+    __m128i blkl, blkh;
+    jsize idx = 0;
+
+    while (idx + 2 * KERNEL_BLOCK <= len) {
+        blkl = _mm_loadu_si128((__m128i *) (src + idx));
+        blkh = _mm_loadu_si128((__m128i *) (src + idx + KERNEL_BLOCK));
+        _mm_storeu_si128((__m128i *) (dst + idx),
+                         _mm_packus_epi16(blkl, blkh));
+        idx += 2 * KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize asciiRunBlocks(const jubyte *utf, jsize len) {
+    __m128i zero = _mm_setzero_si128(), blk;
+    jsize idx = 0;
+
+    while (idx + 2 * KERNEL_BLOCK <= len) {
+        /* Signed compare, excludes both '\0' and the high bit bytes */
+        blk = _mm_loadu_si128((__m128i *) (utf + idx));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(blk, zero)) != 0xFFFF) break;
+        idx += 2 * KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+
+static JEM_SSE2_KERNEL jsize asciiRunCharBlocks(const jchar *str,
+                                                jsize len) {
+    __m128i zero = _mm_setzero_si128(), limit = _mm_set1_epi16(0x80), blk;
+    jsize idx = 0;
+
+    while (idx + KERNEL_BLOCK <= len) {
+        /* Characters above 0x7FFF are negative and fail the first test */
+        blk = _mm_loadu_si128((__m128i *) (str + idx));
+        if (_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi16(blk, zero),
+                                  _mm_cmplt_epi16(blk, limit))) != 0xFFFF) {
+            break;
+        }
+        idx += KERNEL_BLOCK;
+    }
+
+    return idx;
+}
+#endif
+
+/**
+ * Locate the first character in the Unicode text which cannot be stored in
+ * the 8-bit String format (either '\0' or greater than 255).
+ *
+ * Parameters:
+ *     str - the Unicode text to scan
+ *     len - the number of Unicode characters in the text
+ *
+ * Returns:
+ *     The index of the first non 8-bit character, or len if all of the
+ *     characters are 8-bit.
+ */
+jsize JEM_StrFindWideChar(const jchar *str, jsize len) {
+    jsize idx = 0;
+    jchar jch;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, KERNEL_BLOCK)) {
+        idx = findWideCharBlocks(str, len);
+    }
+#endif
+    while (idx < len) {
+        jch = str[idx];
+        if ((jch == 0) || (jch > 255)) break;
+        idx++;
+    }
+
+    return idx;
+}
+
+/**
+ * Locate the first occurrence of the given character in the Unicode text
+ * (the 16-bit equivalent of memchr()).
+ *
+ * Parameters:
+ *     str - the Unicode text to scan
+ *     len - the number of Unicode characters in the text
+ *     ch - the character to search for
+ *
+ * Returns:
+ *     The index of the first matching character, or -1 if not found.
+ */
+jsize JEM_StrScanChar(const jchar *str, jsize len, jchar ch) {
+    jsize idx = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, KERNEL_BLOCK)) {
+        idx = scanCharBlocks(str, len, ch);
+    }
+#endif
+    while (idx < len) {
+        if (str[idx] == ch) return idx;
+        idx++;
+    }
+
+    return -1;
+}
+
+/**
+ * Determine the index of the first differing character between two Unicode
+ * texts of equal length.
+ *
+ * Parameters:
+ *     stra, strb - the Unicode texts to compare
+ *     len - the number of Unicode characters to compare
+ *
+ * Returns:
+ *     The index of the first mismatched character, or len if the texts are
+ *     identical.
+ */
+jsize JEM_StrMismatchChars(const jchar *stra, const jchar *strb, jsize len) {
+    jsize idx = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, KERNEL_BLOCK)) {
+        idx = mismatchCharBlocks(stra, strb, len);
+    }
+#endif
+    while ((idx < len) && (stra[idx] == strb[idx])) idx++;
+
+    return idx;
+}
+
+/**
+ * Determine the index of the first differing character between two 8-bit
+ * texts of equal length.
+ *
+ * Parameters:
+ *     stra, strb - the 8-bit texts to compare
+ *     len - the number of characters to compare
+ *
+ * Returns:
+ *     The index of the first mismatched character, or len if the texts are
+ *     identical.
+ */
+jsize JEM_StrMismatchBytes(const jubyte *stra, const jubyte *strb, jsize len) {
+    jsize idx = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, 2 * KERNEL_BLOCK)) {
+        idx = mismatchByteBlocks(stra, strb, len);
+    }
+#endif
+    while ((idx < len) && (stra[idx] == strb[idx])) idx++;
+
+    return idx;
+}
+
+/**
+ * Expand 8-bit String characters into the Unicode (16-bit) equivalent.
+ *
+ * Parameters:
+ *     dst - the Unicode buffer to write the expanded characters into
+ *     src - the 8-bit characters to be expanded
+ *     len - the number of characters to expand
+ */
+void JEM_StrWiden(jchar *dst, const jubyte *src, jsize len) {
+    jsize idx = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, 2 * KERNEL_BLOCK)) {
+        idx = widenBlocks(dst, src, len);
+    }
+#endif
+    while (idx < len) {
+        dst[idx] = (jchar) src[idx];
+        idx++;
+    }
+}
+
+/**
+ * Reduce Unicode characters into the 8-bit String format.  The caller must
+ * ensure that all of the characters fit (see JEM_StrFindWideChar).  The
+ * reduction may be performed in place (dst the same memory as src).
+ *
+ * Parameters:
+ *     dst - the buffer to write the 8-bit characters into
+ *     src - the Unicode characters to be reduced
+ *     len - the number of characters to reduce
+ */
+void JEM_StrNarrow(jubyte *dst, const jchar *src, jsize len) {
+    jsize idx = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, 2 * KERNEL_BLOCK)) {
+        idx = narrowBlocks(dst, src, len);
+    }
+#endif
+    while (idx < len) {
+        dst[idx] = (jubyte) src[idx];
+        idx++;
+    }
+}
+
 /**
  * Scans the provided UTF-8 string information to determine if the contents
  * are ASCII (7-bit characters).
@@ -39,10 +348,9 @@
  *     characters only.
  */
 jboolean JEMCC_UTFStrIsAscii(const char *utfStrData) {
-    while (*utfStrData != '\0') {
-        if ((*utfStrData & 0x80) != 0) return JNI_FALSE;
-        utfStrData++;
-    }
+    jsize len = strlen(utfStrData);
+
+    if (JEM_UTFAsciiRun((jubyte *) utfStrData, len) != len) return JNI_FALSE;
     return JNI_TRUE;
 }
 
@@ -59,81 +367,367 @@ jboolean JEMCC_UTFStrIsAscii(const char *utfStrData) {
  *     characters only.
  */
 jboolean JEMCC_UnicodeStrIsAscii(const jchar *uniStrData, jsize len) {
-    jchar jch;
+    if (JEM_StrFindWideChar(uniStrData, len) != len) return JNI_FALSE;
+    return JNI_TRUE;
+}
+
+/**
+ * Determine the length of the run of plain ASCII characters (1-127, which
+ * are encoded as single bytes in modified UTF-8) at the start of the given
+ * byte sequence.
+ *
+ * Parameters:
+ *     utf - the modified UTF-8 (or 8-bit String) data to scan
+ *     len - the number of bytes to scan
+ *
+ * Returns:
+ *     The number of leading single byte characters, len if all are ASCII.
+ */
+jsize JEM_UTFAsciiRun(const jubyte *utf, jsize len) {
+    jsize idx = 0;
 
-    while (len > 0) {
-        jch = *(uniStrData++);
-        if ((jch == 0) || (jch > 255)) return JNI_FALSE;
-        len--;
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, 2 * KERNEL_BLOCK)) {
+        idx = asciiRunBlocks(utf, len);
     }
-    return JNI_TRUE ;
+#endif
+    while ((idx < len) && (utf[idx] != 0) && (utf[idx] < 0x80)) idx++;
+
+    return idx;
 }
 
 /**
- * Local methods to process UTF8 encoded character sequences, determining
- * length and expanding to 16-bit Unicode sequences.
+ * Determine the length of the run of plain ASCII characters (1-127) at the
+ * start of the given Unicode text.
+ *
+ * Parameters:
+ *     str - the Unicode text to scan
+ *     len - the number of Unicode characters to scan
+ *
+ * Returns:
+ *     The number of leading ASCII characters, len if all are ASCII.
  */
-static jint JEM_GetUTFLength(const char *utfStrData) {
-    jint len = 0;
-    char ch;
+jsize JEM_UTFAsciiRunChars(const jchar *str, jsize len) {
+    jsize idx = 0;
+
+#ifdef ENABLE_SSE2_KERNELS
+    if (USE_SSE2_BLOCKS(len, KERNEL_BLOCK)) {
+        idx = asciiRunCharBlocks(str, len);
+    }
+#endif
+    while ((idx < len) && (str[idx] != 0) && (str[idx] < 0x80)) idx++;
+
+    return idx;
+}
 
-    while ((ch = *utfStrData) != '\0') {
-        if ((ch & 0x80) == 0) {
-            utfStrData++;
+/**
+ * Scan (validate) a modified UTF-8 encoded byte sequence, determining the
+ * number of characters it contains and whether they can all be stored in
+ * the compact 8-bit String format.  Scanning stops at the first malformed
+ * sequence (including '\0' bytes and the four byte forms, which do not
+ * appear in modified UTF-8).  Runs of ASCII are skipped a block at a time.
+ *
+ * Parameters:
+ *     utf - the modified UTF-8 data to scan
+ *     byteLen - the number of bytes in the data
+ *     validLen - if non-NULL, returns the number of bytes in the valid
+ *                prefix of the data (byteLen if the data is well formed)
+ *     isCompact - if non-NULL, returns JNI_TRUE if all of the characters in
+ *                 the valid prefix are 8-bit (neither '\0' nor above 255)
+ *
+ * Returns:
+ *     The number of characters in the valid prefix of the data.
+ */
+jint JEM_UTFScan(const jubyte *utf, jsize byteLen, jsize *validLen,
+                 jboolean *isCompact) {
+    jboolean compact = JNI_TRUE;
+    jsize run, idx = 0;
+    jint len = 0;
+    juint ch, uch;
+
+    while (idx < byteLen) {
+        run = JEM_UTFAsciiRun(utf + idx, byteLen - idx);
+        idx += run;
+        len += run;
+        if (idx >= byteLen) break;
+
+        ch = utf[idx];
+        if (((ch & 0xE0) == 0xC0) && (idx + 1 < byteLen) &&
+                ((utf[idx + 1] & 0xC0) == 0x80)) {
+            uch = ((ch & 0x1F) << 6) | (utf[idx + 1] & 0x3F);
+            idx += 2;
+        } else if (((ch & 0xF0) == 0xE0) && (idx + 2 < byteLen) &&
+                       ((utf[idx + 1] & 0xC0) == 0x80) &&
+                       ((utf[idx + 2] & 0xC0) == 0x80)) {
+            uch = ((ch & 0x0F) << 12) | ((utf[idx + 1] & 0x3F) << 6) |
+                                                      (utf[idx + 2] & 0x3F);
+            idx += 3;
         } else {
-            if ((ch & 0x20) == 0) {
-                if ((*(++utfStrData) & 0xC0) == 0x80) utfStrData++;
-                else break;
-            } else {
-                if ((*(++utfStrData) & 0xC0) == 0x80) utfStrData++;
-                else break;
-                if ((*utfStrData & 0xC0) == 0x80) utfStrData++;
-                else break;
-            }
+            /* Malformed sequence */
+            break;
         }
+        if ((uch == 0) || (uch > 255)) compact = JNI_FALSE;
         len++;
     }
 
+    if (validLen != NULL) *validLen = idx;
+    if (isCompact != NULL) *isCompact = compact;
     return len;
 }
 
-/* The following returns length, positive for unicode, negative for ASCII */
-static jint JEM_UTFDecode(const unsigned char *utfStrData, jchar *buffer) {
-    jint ch, asciiInd = -1, len = 0;
-    jchar uch;
+/**
+ * Decode a well-formed modified UTF-8 byte sequence (as determined by
+ * JEM_UTFScan) into either the compact 8-bit or the Unicode String format.
+ * ASCII runs are copied or widened a block at a time.
+ *
+ * Parameters:
+ *     utf - the modified UTF-8 data to decode
+ *     byteLen - the number of bytes to decode (the valid length from the
+ *               scan)
+ *     buffer - the String data buffer to decode into (jubyte or jchar
+ *              elements according to the compact flag), which must have
+ *              space for the scanned number of characters
+ *     compact - if JNI_TRUE, decode into 8-bit characters (the scan must
+ *               have indicated that the characters are compact), otherwise
+ *               into Unicode characters
+ *
+ * Returns:
+ *     The number of characters decoded.
+ */
+jint JEM_UTFDecode(const jubyte *utf, jsize byteLen, void *buffer,
+                   jboolean compact) {
+    jubyte *ptr = (jubyte *) buffer;
+    jchar *jptr = (jchar *) buffer;
+    jsize run, idx = 0;
+    jint len = 0;
+    juint ch, uch;
 
-    while ((ch = *utfStrData) != '\0') {
-        if ((ch & 0x80) == 0) {
-            uch = (jchar) ch;
-            utfStrData++;
-        } else {
-            if ((ch & 0x20) == 0) {
-                uch = (ch & 0x1f) << 6;
-                if (((ch = *(++utfStrData)) & 0xC0) == 0x80) {
-                    uch = uch | (ch & 0x3F);
-                } else break;
+    while (idx < byteLen) {
+        run = JEM_UTFAsciiRun(utf + idx, byteLen - idx);
+        if (run > 0) {
+            if (compact == JNI_TRUE) {
+                (void) memcpy(ptr + len, utf + idx, run);
             } else {
-                uch = (ch & 0x0f) << 12;
-                if (((ch = *(++utfStrData)) & 0xC0) == 0x80) {
-                    uch = uch | (ch & 0x3F) << 6;
-                } else break;
-                if (((ch = *(++utfStrData)) & 0xC0) == 0x80) {
-                    uch = uch | (ch & 0x3F);
-                } else break;
+                JEM_StrWiden(jptr + len, utf + idx, run);
             }
-            if ((uch == 0) || ((uch & 0xFF80) != 0)) asciiInd = 1;
-            utfStrData++;
+            idx += run;
+            len += run;
+            if (idx >= byteLen) break;
+        }
+
+        ch = utf[idx];
+        if ((ch & 0xE0) == 0xC0) {
+            uch = ((ch & 0x1F) << 6) | (utf[idx + 1] & 0x3F);
+            idx += 2;
+        } else {
+            uch = ((ch & 0x0F) << 12) | ((utf[idx + 1] & 0x3F) << 6) |
+                                                      (utf[idx + 2] & 0x3F);
+            idx += 3;
+        }
+        if (compact == JNI_TRUE) {
+            ptr[len++] = (jubyte) uch;
+        } else {
+            jptr[len++] = (jchar) uch;
         }
-        *(buffer++) = uch;
-        len++;
     }
 
-    return (asciiInd * len);
+    return len;
+}
+
+/**
+ * Determine the number of bytes required to encode the contents of a
+ * java.lang.String in modified UTF-8 (excluding the '\0' terminator).
+ *
+ * Parameters:
+ *     strData - the JEMCC_StringData structure containing the String data
+ *
+ * Returns:
+ *     The number of bytes in the modified UTF-8 encoding.
+ */
+jsize JEM_UTFEncodedLength(JEMCC_StringData *strData) {
+    jubyte *ptr = (jubyte *) &(strData->data);
+    jchar ch, *jptr = (jchar *) ptr;
+    jsize run, idx = 0, len = abs(strData->length), utfLen = 0;
+
+    while (idx < len) {
+        if (strData->length < 0) {
+            run = JEM_UTFAsciiRun(ptr + idx, len - idx);
+        } else {
+            run = JEM_UTFAsciiRunChars(jptr + idx, len - idx);
+        }
+        idx += run;
+        utfLen += run;
+        if (idx >= len) break;
+
+        /* Note that '\0' has the two byte encoding in modified UTF-8 */
+        ch = (strData->length < 0) ? (jchar) ptr[idx] : jptr[idx];
+        utfLen += (ch < 0x800) ? 2 : 3;
+        idx++;
+    }
+
+    return utfLen;
+}
+
+/**
+ * Encode the contents of a java.lang.String in modified UTF-8.  Runs of
+ * ASCII characters are copied (or narrowed) a block at a time.
+ *
+ * Parameters:
+ *     strData - the JEMCC_StringData structure containing the String data
+ *     buffer - the buffer to write the encoded data into, which must have
+ *              space for the encoded length (see JEM_UTFEncodedLength)
+ *              plus the '\0' terminator
+ */
+void JEM_UTFEncode(JEMCC_StringData *strData, char *buffer) {
+    jubyte *ptr = (jubyte *) &(strData->data), *out = (jubyte *) buffer;
+    jchar ch, *jptr = (jchar *) ptr;
+    jsize run, idx = 0, len = abs(strData->length);
+
+    while (idx < len) {
+        if (strData->length < 0) {
+            run = JEM_UTFAsciiRun(ptr + idx, len - idx);
+            (void) memcpy(out, ptr + idx, run);
+        } else {
+            run = JEM_UTFAsciiRunChars(jptr + idx, len - idx);
+            JEM_StrNarrow(out, jptr + idx, run);
+        }
+        idx += run;
+        out += run;
+        if (idx >= len) break;
+
+        ch = (strData->length < 0) ? (jchar) ptr[idx] : jptr[idx];
+        if (ch < 0x800) {
+            *(out++) = (jubyte) (0xC0 | (ch >> 6));
+            *(out++) = (jubyte) (0x80 | (ch & 0x3F));
+        } else {
+            *(out++) = (jubyte) (0xE0 | (ch >> 12));
+            *(out++) = (jubyte) (0x80 | ((ch >> 6) & 0x3F));
+            *(out++) = (jubyte) (0x80 | (ch & 0x3F));
+        }
+        idx++;
+    }
+    *out = '\0';
+}
+
+/*
+ * Common method to allocate and populate the String data for the given
+ * modified UTF-8 text, decoding directly into the compact 8-bit format where
+ * all of the characters allow.  Any malformed trailing data is discarded.
+ */
+static JEMCC_StringData *JEM_UTFCreateStringData(JNIEnv *env,
+                                                 const char *utfStrData) {
+    JEMCC_StringData *strData;
+    jboolean isCompact;
+    jsize validLen;
+    jint len;
+
+    len = JEM_UTFScan((jubyte *) utfStrData, strlen(utfStrData),
+                      &validLen, &isCompact);
+    if (isCompact == JNI_TRUE) {
+        /* Includes the '\0' terminator through the structure padding */
+        strData = (JEMCC_StringData *) JEMCC_Malloc(env,
+                                           sizeof(JEMCC_StringData) + len);
+        if (strData == NULL) return NULL;
+        strData->length = -len;
+    } else {
+        strData = (JEMCC_StringData *) JEMCC_Malloc(env,
+                               sizeof(JEMCC_StringData) + len * sizeof(jchar));
+        if (strData == NULL) return NULL;
+        strData->length = len;
+    }
+    (void) JEM_UTFDecode((jubyte *) utfStrData, validLen, &(strData->data),
+                         isCompact);
+
+    return strData;
+}
+
+/* Initial bucket count for the intern() table (at least one per stripe) */
+#define INTERN_INITIAL_BUCKETS 256
+
+/**
+ * Initialize the intern()'ed String table of a VM.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be initialized
+ *
+ * Returns:
+ *     JNI_OK if the table was initialized, JNI_ENOMEM if a memory
+ *     allocation failed (an OutOfMemoryError will have been thrown in
+ *     the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_InternTableInit(JNIEnv *env, JEM_InternTable *table) {
+    return JEM_StripedTableInit(env, table, INTERN_INITIAL_BUCKETS);
+}
+
+/* Caller scan information, for adapting the striped table scan callback */
+typedef struct JEM_InternScanData {
+    JEM_InternScanCB scanCB;
+    void *userData;
+} JEM_InternScanData;
+
+static jint JEM_InternEntryScanner(JNIEnv *env, JEM_StripedEntry *entry,
+                                   void *userData) {
+    JEM_InternScanData *scanData = (JEM_InternScanData *) userData;
+
+    return (*(scanData->scanCB))(env, ((JEM_InternEntry *) entry)->string,
+                                 scanData->userData);
+}
+
+/**
+ * Scan the Strings of the intern()'ed String table.  Only to be used when
+ * there are no concurrent inserts (VM shutdown or collection).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be scanned
+ *     scanCB - the method to call for each interned String
+ *     userData - caller provided information passed to the callback
+ */
+void JEM_InternTableScan(JNIEnv *env, JEM_InternTable *table,
+                         JEM_InternScanCB scanCB, void *userData) {
+    JEM_InternScanData scanData;
+
+    scanData.scanCB = scanCB;
+    scanData.userData = userData;
+    JEM_StripedTableScan(env, table, JEM_InternEntryScanner, &scanData);
+}
+
+static jint JEM_InternEntryReleaser(JNIEnv *env, JEM_StripedEntry *entry,
+                                    void *userData) {
+    JEMCC_Free(entry);
+    return JNI_OK;
+}
+
+/**
+ * Release the internals of the intern()'ed String table.  Does not release
+ * the String instances or their character data.
+ *
+ * Parameters:
+ *     table - the table to be destroyed
+ */
+void JEM_InternTableDestroy(JEM_InternTable *table) {
+    JEM_StripedTableScan(NULL, table, JEM_InternEntryReleaser, NULL);
+    JEM_StripedTableDestroy(table);
+}
+
+/**
+ * Key match test for the intern() table, comparing the character data.
+ */
+static jboolean JEM_InternEqualsFn(JNIEnv *env, JEM_StripedEntry *entry,
+                                   const void *key) {
+    return JEMCC_StringEqualsFn(env, ((JEM_InternEntry *) entry)->strData,
+                                (void *) key);
 }
 
 /**
  * Common method to retrieve/insert a String instance into the intern()'ed
  * hashtable within the VM.  Used by all three of the following methods.
+ * Lookups of existing Strings (the common case) do not lock, inserts
+ * are serialized per stripe of the table.
  *
  * Parameters:
  *     env - the VM environment which is currently in context
@@ -155,58 +749,45 @@ static jint JEM_UTFDecode(const unsigned char *utfStrData, jchar *buffer) {
  */
 static JEMCC_Object *JEM_InternString(JNIEnv *env, JEMCC_StringData *strData,
                                       JEMCC_Object *string) {
-    JEMCC_Class *stringClass = VM_CLASS(JEMCC_Class_String);
     JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
-    JEM_JavaVM *jvm = jenv->parentVM;
+    JEM_InternTable *table = &(jenv->parentVM->internStringTable);
+    juint hashCode = JEMCC_StringHashFn(env, strData);
+    JEM_InternEntry *entry;
     JEMCC_Object *retStr;
-    jint rc;
 
-    /* Watch for concurrent access */
-    if (JEMCC_EnterObjMonitor(env, stringClass) != JNI_OK) {
+    entry = (JEM_InternEntry *) JEM_StripedTableLookup(env, table, strData,
+                                                       hashCode,
+                                                       JEM_InternEqualsFn,
+                                                       JNI_TRUE);
+    if (entry != NULL) {
         if (string == NULL) JEMCC_Free(strData);
-        return NULL;
+        return entry->string;
     }
 
-    /* Easy return when already existing in table */
-    retStr = (JEMCC_Object *) JEMCC_HashGetEntry(env, &(jvm->internStringTable),
-                                                 strData, JEMCC_StringHashFn,
-                                                 JEMCC_StringEqualsFn);
-    if (retStr != NULL) {
+    /* Either insert the given String instance or create a new one */
+    entry = (JEM_InternEntry *) JEMCC_Malloc(env, sizeof(JEM_InternEntry));
+    if (entry == NULL) {
+        JEM_StripedTableUnlock(table, hashCode);
         if (string == NULL) JEMCC_Free(strData);
-        if (JEMCC_ExitObjMonitor(env, stringClass) != JNI_OK) abort();
-        return retStr;
+        return NULL;
     }
-
-    /* If indicated, just insert the string instance into the intern() table */
     if (string != NULL) {
-        rc = JEMCC_HashInsertEntry(env, &(jvm->internStringTable),
-                                   strData, string, NULL, NULL,
-                                   JEMCC_StringHashFn, JEMCC_StringEqualsFn);
-        if (JEMCC_ExitObjMonitor(env, stringClass) != JNI_OK) abort();
-        if (rc == JNI_ENOMEM) return NULL;
-        if (rc != JNI_OK) abort();
-        return string;
-    }
-
-    /* Otherwise, create a new instance, using the provided string data */
-    retStr = JEMCC_AllocateObject(env, stringClass, 0);
-    if (retStr == NULL) {
-        JEMCC_Free(strData);
-        if (JEMCC_ExitObjMonitor(env, stringClass) != JNI_OK) abort();
-        return NULL;
+        retStr = string;
+    } else {
+        retStr = JEMCC_AllocateObject(env, VM_CLASS(JEMCC_Class_String), 0);
+        if (retStr == NULL) {
+            JEM_StripedTableUnlock(table, hashCode);
+            JEMCC_Free(entry);
+            JEMCC_Free(strData);
+            return NULL;
+        }
+        ((JEMCC_ObjectExt *) retStr)->objectData = strData;
     }
-    ((JEMCC_ObjectExt *) retStr)->objectData = strData;
+    JEMCC_MarkNonLocalObject(env, retStr);
 
-    /* And insert it into the table */
-    rc = JEMCC_HashInsertEntry(env, &(jvm->internStringTable),
-                               strData, retStr, NULL, NULL,
-                               JEMCC_StringHashFn, JEMCC_StringEqualsFn);
-    if (JEMCC_ExitObjMonitor(env, stringClass) != JNI_OK) abort();
-    if (rc == JNI_ENOMEM) {
-        JEMCC_Free(strData);
-        return NULL;
-    }
-    if (rc != JNI_OK) abort();
+    entry->strData = strData;
+    entry->string = retStr;
+    JEM_StripedTableInsert(env, table, &(entry->link), hashCode);
 
     return retStr;
 }
@@ -234,36 +815,10 @@ static JEMCC_Object *JEM_InternString(JNIEnv *env, JEMCC_StringData *strData,
 JEMCC_Object *JEMCC_GetInternStringUTF(JNIEnv *env, 
                                        const char *utfStrData) {
     JEMCC_StringData *strData;
-    jchar *jptr;
-    char *ptr;
-    jint len;
 
     /* Prepare the string data lookup/create structure */
-    if (JEMCC_UTFStrIsAscii((char *) utfStrData) == JNI_TRUE) {
-        len = strlen(utfStrData);
-        strData = (JEMCC_StringData *) JEMCC_Malloc(env,
-                                               sizeof(JEMCC_StringData) + len);
-        if (strData == NULL) return NULL;
-        strData->length = -len;
-        (void) strcpy(&(strData->data), utfStrData);
-    } else {
-        len = JEM_GetUTFLength(utfStrData);
-        strData = (JEMCC_StringData *) JEMCC_Malloc(env,
-                               sizeof(JEMCC_StringData) + len * sizeof(jchar));
-        if (strData == NULL) return NULL;
-
-        strData->length = len;
-        if (JEM_UTFDecode(utfStrData, (jchar *) &(strData->data)) < 0) {
-            /* Embedded ASCII, compact and flip result */
-            strData->length = -len;
-            jptr = (jchar *) ptr = &(strData->data);
-            while (len > 0) {
-                *(ptr++) = *(jptr++) & 0xFF;
-                len--;
-            }
-            *ptr = '\0';
-        }
-    }
+    strData = JEM_UTFCreateStringData(env, utfStrData);
+    if (strData == NULL) return NULL;
 
     /* And locate/create the intern() String instance */
     return JEM_InternString(env, strData, NULL);
@@ -366,22 +921,46 @@ JEMCC_Object *JEMCC_FindInternString(JNIEnv *env, JEMCC_Object *string) {
  */
 juint JEMCC_StringHashFn(JNIEnv *env, void *key) {
     JEMCC_StringData *strData = (JEMCC_StringData *) key;
-    unsigned long hashCode = 0;
-    char *ptr = &(strData->data);
+    jubyte *ptr = (jubyte *) &(strData->data);
+    jchar *uniPtr = (jchar *) ptr;
     jint len = strData->length;
+    juint hashCode = 0;
 
     if (len < 0) {
-        /* ASCII */
-        while (*ptr != '\0') {
-            hashCode += *(ptr++);
+        /* ASCII, four characters per block (length is known) */
+        len = -len;
+        while (len >= 4) {
+            JEMCC_HASH_BLOCK(hashCode, ((juint) ptr[0]) | 
+                                       (((juint) ptr[1]) << 8) |
+                                       (((juint) ptr[2]) << 16) |
+                                       (((juint) ptr[3]) << 24));
+            ptr += 4;
+            len -= 4;
         }
+        if (len == 3) {
+            JEMCC_HASH_BLOCK(hashCode, ((juint) ptr[0]) | 
+                                       (((juint) ptr[1]) << 8) |
+                                       (((juint) ptr[2]) << 16));
+        } else if (len == 2) {
+            JEMCC_HASH_BLOCK(hashCode, ((juint) ptr[0]) | 
+                                       (((juint) ptr[1]) << 8));
+        } else if (len == 1) {
+            JEMCC_HASH_BLOCK(hashCode, (juint) ptr[0]);
+        }
+        len = -strData->length;
     } else {
-        /* Unicode */
-        while (len > 0) {
-            hashCode += *(((jchar *) ptr)++);
-            len--;
+        /* Unicode, two characters per block */
+        while (len >= 2) {
+            JEMCC_HASH_BLOCK(hashCode, ((juint) uniPtr[0]) | 
+                                       (((juint) uniPtr[1]) << 16));
+            uniPtr += 2;
+            len -= 2;
         }
+        if (len == 1) JEMCC_HASH_BLOCK(hashCode, (juint) uniPtr[0]);
+        len = strData->length;
     }
+    JEMCC_HASH_FINAL(hashCode, len);
+
     return hashCode;
 }
 
@@ -407,18 +986,60 @@ jboolean JEMCC_StringEqualsFn(JNIEnv *env, void *keya, void *keyb) {
     if (len != strDataB->length) return JNI_FALSE;
     if (len < 0) {
         /* ASCII */
-        return (strcmp(ptrA, ptrB) == 0) ? JNI_TRUE : JNI_FALSE;
+        len = -len;
+        if (JEM_StrMismatchBytes((jubyte *) ptrA, (jubyte *) ptrB,
+                                 len) != len) return JNI_FALSE;
     } else {
         /* Unicode */
-        while (len > 0) {
-            if (*(((jchar *) ptrA)++) != *(((jchar *) ptrB)++)) {
-                return JNI_FALSE;
+        if (JEM_StrMismatchChars((jchar *) ptrA, (jchar *) ptrB,
+                                 len) != len) return JNI_FALSE;
+    }
+
+    return JNI_TRUE;
+}
+
+/**
+ * Lexicographically compare the contents of two java.lang.String instances
+ * (via the attachment data structures), as defined for String.compareTo().
+ *
+ * Parameters:
+ *     strDataA, strDataB - the JEMCC_StringData structures to be compared
+ *
+ * Returns:
+ *     The difference between the first mismatched characters or, if one
+ *     string is a prefix of the other, the difference in lengths (zero if
+ *     the strings are equal).
+ */
+jint JEM_StringCompare(JEMCC_StringData *strDataA,
+                       JEMCC_StringData *strDataB) {
+    jint idx, len, lenA = abs(strDataA->length), lenB = abs(strDataB->length);
+    jubyte *ptrA = (jubyte *) &(strDataA->data);
+    jubyte *ptrB = (jubyte *) &(strDataB->data);
+    jchar *jptrA = (jchar *) ptrA, *jptrB = (jchar *) ptrB;
+
+    len = (lenA < lenB) ? lenA : lenB;
+    if ((strDataA->length < 0) && (strDataB->length < 0)) {
+        idx = JEM_StrMismatchBytes(ptrA, ptrB, len);
+        if (idx < len) return ((jint) ptrA[idx]) - ((jint) ptrB[idx]);
+    } else if ((strDataA->length >= 0) && (strDataB->length >= 0)) {
+        idx = JEM_StrMismatchChars(jptrA, jptrB, len);
+        if (idx < len) return ((jint) jptrA[idx]) - ((jint) jptrB[idx]);
+    } else {
+        /* Mixed storage, compare the expanded characters */
+        for (idx = 0; idx < len; idx++) {
+            if (strDataA->length < 0) {
+                if (ptrA[idx] != jptrB[idx]) {
+                    return ((jint) ptrA[idx]) - ((jint) jptrB[idx]);
+                }
+            } else {
+                if (jptrA[idx] != ptrB[idx]) {
+                    return ((jint) jptrA[idx]) - ((jint) ptrB[idx]);
+                }
             }
-            len--;
         }
     }
 
-    return JNI_TRUE;
+    return lenA - lenB;
 }
 
 /**
@@ -442,33 +1063,27 @@ jboolean JEMCC_StringEqualsFn(JNIEnv *env, void *keya, void *keyb) {
 JEMCC_Object *JEMCC_StringCatUTF(JNIEnv *env, ...) {
     JEMCC_StringData *strData;
     JEMCC_Object *retStr;
+    jboolean isCompact = JNI_TRUE, segCompact;
+    jsize validLen;
+    jint len;
     char *ptr, *str;
-    jchar *jptr;
     va_list ap;
-    jint isAscii = JNI_TRUE, l, len;
 
-    /* Determine the full length, compensating for UTF/Unicode conversion */
+    /* Determine the full length and whether the result can be compact */
     len = 0;
     va_start(ap, env);
     ptr = va_arg(ap, char *);
     while (ptr != NULL) {
-        if (len > 0) {
-            len += JEM_GetUTFLength(ptr);
-        } else {
-            if (JEMCC_UTFStrIsAscii(ptr) == JNI_TRUE) {
-                len -= strlen(ptr);
-            } else {
-                len = -len + JEM_GetUTFLength(ptr);
-            }
-        }
+        len += JEM_UTFScan((jubyte *) ptr, strlen(ptr), NULL, &segCompact);
+        if (segCompact == JNI_FALSE) isCompact = JNI_FALSE;
         ptr = va_arg(ap, char *);
     }
     va_end(ap);
 
     /* Allocate the return string */
-    if (len < 0) {
+    if (isCompact == JNI_TRUE) {
         retStr = JEMCC_AllocateObjectIdx(env, JEMCC_Class_String,
-                                         sizeof(JEMCC_StringData) - len);
+                                         sizeof(JEMCC_StringData) + len);
     } else {
         retStr = JEMCC_AllocateObjectIdx(env, JEMCC_Class_String,
                                sizeof(JEMCC_StringData) + len * sizeof(jchar));
@@ -476,43 +1091,20 @@ JEMCC_Object *JEMCC_StringCatUTF(JNIEnv *env, ...) {
     if (retStr == NULL) return NULL;
 
     strData = (JEMCC_StringData *) ((JEMCC_ObjectExt *) retStr)->objectData;
-    strData->length = len;
+    strData->length = (isCompact == JNI_TRUE) ? -len : len;
     str = &(strData->data);
 
-    /* Assemble the String result */
+    /* Assemble the String result, directly in the storage format */
     va_start(ap, env);
     ptr = va_arg(ap, char *);
     while (ptr != NULL) {
-        if (len < 0) {
-            while (*ptr != '\0') {
-                *(str++) = *(ptr++);
-            }
-        } else {
-            l = JEM_UTFDecode(ptr, (jchar *) str);
-            if (l > 0) {
-                isAscii = JNI_FALSE;
-                str = str + l * sizeof(jchar);
-            } else {
-                str = str - l * sizeof(jchar);
-            }
-        }
+        (void) JEM_UTFScan((jubyte *) ptr, strlen(ptr), &validLen, NULL);
+        len = JEM_UTFDecode((jubyte *) ptr, validLen, str, isCompact);
+        str += (isCompact == JNI_TRUE) ? len : len * sizeof(jchar);
         ptr = va_arg(ap, char *);
     }
     va_end(ap);
-
-    if (isAscii == JNI_TRUE) {
-        /* Check for complex ASCII UTF encoding */
-        if (len > 0) {
-            strData->length = -len;
-            jptr = (jchar *) str = &(strData->data);
-            while (len > 0) {
-                *(str++) = *(jptr++) & 0xFF;
-                len--;
-            }
-        }
-
-        *str = '\0';
-    }
+    if (isCompact == JNI_TRUE) *str = '\0';
 
     return retStr;
 }
@@ -540,36 +1132,10 @@ JEMCC_Object *JEMCC_StringCatUTF(JNIEnv *env, ...) {
 jstring JEMCC_NewStringUTF(JNIEnv *env, const char *utf) {
     JEMCC_StringData *strData;
     JEMCC_Object *retStr;
-    jchar *jptr;
-    char *ptr;
-    jint len;
 
-    /* Prepare the string data lookup/create structure */
-    if (JEMCC_UTFStrIsAscii(utf) == JNI_TRUE) {
-        len = strlen(utf);
-        strData = (JEMCC_StringData *) JEMCC_Malloc(env,
-                                               sizeof(JEMCC_StringData) + len);
-        if (strData == NULL) return NULL;
-        strData->length = -len;
-        (void) strcpy(&(strData->data), utf);
-    } else {
-        len = JEM_GetUTFLength(utf);
-        strData = (JEMCC_StringData *) JEMCC_Malloc(env,
-                                sizeof(JEMCC_StringData) + len * sizeof(jchar));
-        if (strData == NULL) return NULL;
-
-        strData->length = len;
-        if (JEM_UTFDecode(utf, (jchar *) &(strData->data)) < 0) {
-            /* Embedded ASCII, compact and flip result */
-            strData->length = -len;
-            jptr = (jchar *) ptr = &(strData->data);
-            while (len > 0) {
-                *(ptr++) = *(jptr++) & 0xFF;
-                len--;
-            }
-            *ptr = '\0';
-        }
-    }
+    /* Prepare the string data structure */
+    strData = JEM_UTFCreateStringData(env, utf);
+    if (strData == NULL) return NULL;
 
     /* Create and return the String instance */
     retStr = JEMCC_AllocateObjectIdx(env, JEMCC_Class_String, 0);
@@ -789,26 +1355,15 @@ jint JEMCC_CheckStringSegment(JNIEnv *env, JEMCC_StringData *strData,
  */
 void JEMCC_StringGetChars(JNIEnv *env, JEMCC_StringData *strData,
                           jint begin, jint end, jchar *buff) {
-    jchar *jstr = NULL;
-    char *str = NULL;
     jint len = end - begin;
 
-    /* Setup and make the copy */
-    if (strData->length < 0) {
-        str = &(strData->data) + begin;
-    } else {
-        jstr = ((jchar *) &(strData->data)) + begin;
-    }
+    /* Make the copy, expanding ASCII data */
+    if (len <= 0) return;
     if (strData->length < 0) {
-        while (len > 0) {
-            *(buff++) = (jchar) *(str++);
-            len--;
-        }
+        JEM_StrWiden(buff, ((jubyte *) &(strData->data)) + begin, len);
     } else {
-        while (len > 0) {
-            *(buff++) = *(jstr++);
-            len--;
-        }
+        (void) memcpy(buff, ((jchar *) &(strData->data)) + begin,
+                      len * sizeof(jchar));
     }
 }
 
@@ -837,21 +1392,13 @@ JEMCC_Object *JEMCC_StringSubstring(JNIEnv *env, JEMCC_StringData *strData,
     unsigned int charLen = 1;
     JEMCC_StringData *newStrData;
     JEMCC_ObjectExt *retStr;
-    jchar uch, *jptr, *jstr;
-    char *ptr, *str;
+    jchar *jstr;
+    char *ptr;
 
     /* Determine if substring fragment is Unicode */
     if (strData->length > 0) {
-        jptr = ((jchar *) &(strData->data)) + begin;
-        while (strlen > 0) {
-            uch = *(jptr++);
-            if ((uch == 0) || (uch > 255)) {
-                charLen = 2;
-                break;
-            }
-            strlen--;
-        }
-        strlen = end - begin;
+        jstr = ((jchar *) &(strData->data)) + begin;
+        if (JEM_StrFindWideChar(jstr, strlen) != strlen) charLen = 2;
     }
 
     /* Allocate the storage first */
@@ -863,36 +1410,24 @@ JEMCC_Object *JEMCC_StringSubstring(JNIEnv *env, JEMCC_StringData *strData,
     /* Make the copy, with all the conversion cases */
     newStrData = (JEMCC_StringData *) retStr->objectData;
     if (strData->length > 0) {
+        jstr = ((jchar *) &(strData->data)) + begin;
         if (charLen == 2) {
             /* Unicode to Unicode */
             newStrData->length = strlen;
-            jptr = (jchar *) &(newStrData->data);
-            jstr = ((jchar *) &(strData->data)) + begin;
-            while (strlen > 0) {
-                *(jptr++) = *(jstr++);
-                strlen--;
-            }
+            (void) memcpy(&(newStrData->data), jstr, strlen * sizeof(jchar));
         } else {
             /* Unicode to ASCII */
             newStrData->length = -strlen;
             ptr = (char *) &(newStrData->data);
-            jstr = ((jchar *) &(strData->data)) + begin;
-            while (strlen > 0) {
-                *(ptr++) = (char) *(jstr++);
-                strlen--;
-            }
-            *ptr = '\0';
+            JEM_StrNarrow((jubyte *) ptr, jstr, strlen);
+            ptr[strlen] = '\0';
         }
     } else {
         /* ASCII to ASCII */
         newStrData->length = -strlen;
         ptr = (char *) &(newStrData->data);
-        str = ((char *) &(strData->data)) + begin;
-        while (strlen > 0) {
-            *(ptr++) = *(str++);
-            strlen--;
-        }
-        *ptr = '\0';
+        (void) memcpy(ptr, ((char *) &(strData->data)) + begin, strlen);
+        ptr[strlen] = '\0';
     }
 
     return (JEMCC_Object *) retStr;
@@ -915,82 +1450,65 @@ JEMCC_Object *JEMCC_StringSubstring(JNIEnv *env, JEMCC_StringData *strData,
  */
 jint JEMCC_StringString(JNIEnv *env, JEMCC_StringData *haystack,
                         JEMCC_StringData *needle, jint fromIdx) {
-    jint scanLen, l, hLen = abs(haystack->length), nLen = abs(needle->length);
-    jchar jch, *jptr, *jmptr, *jstr;
-    char ch, *ptr, *mptr, *str;
+    jint l, scanLen, hLen = abs(haystack->length), nLen = abs(needle->length);
+    jchar jch, *jptr, *jstr;
+    jubyte *ptr, *mptr, *str;
 
     if (fromIdx < 0) fromIdx = 0;
     if ((nLen > hLen) || (fromIdx > hLen)) return -1;
     if (nLen == 0) return fromIdx;
-    scanLen = hLen - nLen - fromIdx;
+
+    /* Number of candidate start positions for the first character */
+    scanLen = hLen - nLen - fromIdx + 1;
+    if (scanLen <= 0) return -1;
 
     if (haystack->length < 0) {
         /* ASCII haystack, only ASCII needles will match */
         if (needle->length > 0) return -1;
 
-        /* Scan for a match on the first character, then the rest */
-        ch = needle->data;
-        ptr = &(haystack->data) + fromIdx;
-        while (scanLen >= 0) {
-            if (*(ptr++) != ch) {
-                scanLen--;
-                fromIdx++;
-                continue;
-            }
-            l = nLen - 1;
-            mptr = ptr;
-            str = &(needle->data) + 1;
-            while (l > 0) {
-                if (*(mptr++) != *(str++)) break;
-                l--;
-            }
-            if (l == 0) return fromIdx;
-            scanLen--;
-            fromIdx++;
+        /* Scan (memchr) for a match on the first character, then the rest */
+        str = (jubyte *) &(needle->data);
+        ptr = ((jubyte *) &(haystack->data)) + fromIdx;
+        while (scanLen > 0) {
+            mptr = (jubyte *) memchr(ptr, *str, scanLen);
+            if (mptr == NULL) break;
+            l = JEM_StrMismatchBytes(mptr + 1, str + 1, nLen - 1);
+            if (l == nLen - 1) return fromIdx + (jint) (mptr - ptr);
+            scanLen -= (jint) (mptr - ptr) + 1;
+            fromIdx += (jint) (mptr - ptr) + 1;
+            ptr = mptr + 1;
         }
     } else {
+        jptr = ((jchar *) &(haystack->data)) + fromIdx;
         if (needle->length > 0) {
             /* Looking for Unicode in Unicode */
-            jch = *((jchar *) &(needle->data));
-            jptr = ((jchar *) &(haystack->data)) + fromIdx;
-            while (scanLen >= 0) {
-                if (*(jptr++) != jch) {
-                    scanLen--;
-                    fromIdx++;
-                    continue;
-                }
-                l = nLen - 1;
-                jmptr = jptr;
-                jstr = ((jchar *) &(needle->data)) + 1;
-                while (l > 0) {
-                    if (*(jmptr++) != *(jstr++)) break;
-                    l--;
-                }
-                if (l == 0) return fromIdx;
-                scanLen--;
-                fromIdx++;
-            }
+            jstr = (jchar *) &(needle->data);
+            jch = *jstr;
         } else {
             /* Looking for Ascii in Unicode */
-            jch = (jchar) needle->data;
-            jptr = ((jchar *) &(haystack->data)) + fromIdx;
-            while (scanLen >= 0) {
-                if (*(jptr++) != jch) {
-                    scanLen--;
-                    fromIdx++;
-                    continue;
+            str = (jubyte *) &(needle->data);
+            jch = (jchar) *str;
+        }
+        while (scanLen > 0) {
+            l = JEM_StrScanChar(jptr, scanLen, jch);
+            if (l < 0) break;
+            jptr += l;
+            fromIdx += l;
+            scanLen -= l;
+            if (needle->length > 0) {
+                if (JEM_StrMismatchChars(jptr + 1, jstr + 1,
+                                         nLen - 1) == nLen - 1) {
+                    return fromIdx;
                 }
-                l = nLen - 1;
-                jmptr = jptr;
-                str = &(needle->data) + 1;
-                while (l > 0) {
-                    if (*(jmptr++) != (jchar) *(str++)) break;
-                    l--;
+            } else {
+                for (l = 1; l < nLen; l++) {
+                    if (jptr[l] != (jchar) str[l]) break;
                 }
-                if (l == 0) return fromIdx;
-                scanLen--;
-                fromIdx++;
+                if (l == nLen) return fromIdx;
             }
+            jptr++;
+            fromIdx++;
+            scanLen--;
         }
     }
 
@@ -1106,24 +1624,21 @@ jint JEMCC_LastStringString(JNIEnv *env, JEMCC_StringData *haystack,
 jint JEMCC_StringChar(JNIEnv *env, JEMCC_StringData *haystack,
                       jchar needle, jint fromIdx) {
     jint hLen = abs(haystack->length);
-    jchar *jptr;
-    char *ptr;
+    jubyte *ptr, *mptr;
 
     if (fromIdx < 0) fromIdx = 0;
     if (fromIdx >= hLen) return -1;
 
     if (haystack->length < 0) {
-        ptr = &(haystack->data) + fromIdx;
-        while (fromIdx < hLen) {
-            if (((jchar) *(ptr++)) == needle) return fromIdx;
-            fromIdx++;
-        }
+        /* ASCII storage cannot contain '\0' or Unicode characters */
+        if ((needle == 0) || (needle > 255)) return -1;
+        ptr = ((jubyte *) &(haystack->data)) + fromIdx;
+        mptr = (jubyte *) memchr(ptr, (int) needle, hLen - fromIdx);
+        if (mptr != NULL) return fromIdx + (jint) (mptr - ptr);
     } else {
-        jptr = ((jchar *) &(haystack->data)) + fromIdx;
-        while (fromIdx < hLen) {
-            if (*(jptr++) == needle) return fromIdx;
-            fromIdx++;
-        }
+        hLen = JEM_StrScanChar(((jchar *) &(haystack->data)) + fromIdx,
+                               hLen - fromIdx, needle);
+        if (hLen >= 0) return fromIdx + hLen;
     }
 
     return -1;
@@ -293,6 +293,44 @@ char *JEMCC_EnvStrBufferDup(JNIEnv *env) {
     return retVal;
 }
 
+/**
+ * Obtain the scratch buffer associated with the environment, which is
+ * separate from the string buffer above and is used for bulk transient
+ * data (such as inflated archive entries).  The contents are only valid
+ * until the next call to this method in the same environment.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     length - the total number of bytes which the buffer must allocate to
+ *              be available for subsequent use
+ *
+ * Returns:
+ *     Either a pointer to the beginning of the scratch buffer or NULL if
+ *     the allocation of the requested memory has failed (an OutOfMemoryError
+ *     will have been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - the memory allocation for the buffer failed
+ */
+jbyte *JEM_EnvScratchBuffer(JNIEnv *env, jsize length) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+    jsize newLength = jenv->scratchBufferLength;
+    jbyte *newBuffer;
+
+    /* Contents are not retained, so no need to copy on expansion */
+    if (newLength >= length) return jenv->scratchBuffer;
+    if (newLength == 0) newLength = 4096;
+    while (newLength < length) newLength *= 2;
+
+    newBuffer = (jbyte *) JEMCC_Malloc(env, newLength);
+    if (newBuffer == NULL) return NULL;
+    if (jenv->scratchBuffer != NULL) JEMCC_Free(jenv->scratchBuffer);
+    jenv->scratchBuffer = newBuffer;
+    jenv->scratchBufferLength = newLength;
+
+    return newBuffer;
+}
+
 /******************** Str (char *) Functions ****************************/
 
 /**
@@ -347,3 +385,97 @@ char *JEMCC_StrCatFn(JNIEnv *env, ...) {
 
     return retVal;
 }
+
+/*********************** Allocation Arenas ******************************/
+
+/* Arena blocks double in size from the minimum to the maximum */
+#define ARENA_MIN_BLOCK 1024
+#define ARENA_MAX_BLOCK 65536
+
+/* All arena allocations are aligned for the largest primitive types */
+#define ARENA_ALIGN(x) (((x) + 7) & ~7)
+#define ARENA_HEADER_SIZE ARENA_ALIGN(sizeof(JEM_ArenaBlock))
+
+typedef struct JEM_ArenaBlock {
+    struct JEM_ArenaBlock *next;
+    juint used, size;
+} JEM_ArenaBlock;
+
+/**
+ * Allocate a block of memory from the given arena.  Allocations are carved
+ * sequentially from the current arena block and are never individually
+ * released, the entire arena is released in one operation (see
+ * JEM_ArenaRelease).  Not multi-thread safe, the caller must control
+ * concurrent access to the arena.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     arena - the arena to allocate from (initially zeroed)
+ *     size - the number of bytes to allocate
+ *
+ * Returns:
+ *     NULL if memory allocation failed, otherwise the allocated storage block.
+ *     The allocated block of memory will be initialized to zero.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+void *JEM_ArenaAlloc(JNIEnv *env, JEM_Arena *arena, juint size) {
+    JEM_ArenaBlock *block = arena->blocks;
+    juint blockSize;
+    jbyte *retVal;
+
+    size = ARENA_ALIGN((size == 0) ? 1 : size);
+    if ((block != NULL) && (block->used + size <= block->size)) {
+        retVal = ((jbyte *) block) + ARENA_HEADER_SIZE + block->used;
+        block->used += size;
+        return retVal;
+    }
+
+    /* Large requests have a dedicated block, behind the active block */
+    blockSize = (arena->nextBlockSize == 0) ? ARENA_MIN_BLOCK :
+                                              arena->nextBlockSize;
+    if (size > blockSize / 2) {
+        block = (JEM_ArenaBlock *) JEMCC_Malloc(env, ARENA_HEADER_SIZE + size);
+        if (block == NULL) return NULL;
+        block->used = block->size = size;
+        if (arena->blocks != NULL) {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        } else {
+            arena->blocks = block;
+        }
+        return ((jbyte *) block) + ARENA_HEADER_SIZE;
+    }
+
+    block = (JEM_ArenaBlock *) JEMCC_Malloc(env,
+                                            ARENA_HEADER_SIZE + blockSize);
+    if (block == NULL) return NULL;
+    block->size = blockSize;
+    block->used = size;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    if (blockSize < ARENA_MAX_BLOCK) arena->nextBlockSize = 2 * blockSize;
+    else arena->nextBlockSize = blockSize;
+
+    return ((jbyte *) block) + ARENA_HEADER_SIZE;
+}
+
+/**
+ * Release all of the memory allocated from the given arena.  The arena is
+ * reset to the initial (empty) state and may be reused.
+ *
+ * Parameters:
+ *     arena - the arena to be released
+ */
+void JEM_ArenaRelease(JEM_Arena *arena) {
+    JEM_ArenaBlock *block = arena->blocks, *next;
+
+    while (block != NULL) {
+        next = block->next;
+        JEMCC_Free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->nextBlockSize = 0;
+}
@@ -0,0 +1,476 @@
+/**
+ * Interned symbol (class member name/descriptor) table and the striped
+ * chained hashtable which it shares with the intern()'ed String table.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU Lesser General Public
+ * License, as well as further clarification on your rights to use this
+ * software.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+#include "jeminc.h"
+
+/* Read the VM structure/method definitions */
+#include "jem.h"
+
+/* Allocation size of a bucket array for the given bucket mask */
+#define STRIPED_BUCKETS_SIZE(mask) (sizeof(JEM_StripedBuckets) + \
+                                         (mask) * sizeof(JEM_StripedEntry *))
+
+/* Initial bucket count for the symbol table (at least one per stripe) */
+#define SYMBOL_INITIAL_BUCKETS 1024
+
+/* Recover the symbol table entry from the (interned) symbol text */
+#define SYMBOL_ENTRY(symbol) ((JEM_SymbolEntry *) \
+            (((char *) (symbol)) - \
+                 (size_t) &(((JEM_SymbolEntry *) 0)->text)))
+
+/**
+ * Initialize a striped (lock-free read) chained hashtable.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be initialized
+ *     bucketCount - the initial number of buckets (a power of two, at
+ *                   least one per stripe)
+ *
+ * Returns:
+ *     JNI_OK if the table was initialized, JNI_ENOMEM if a memory
+ *     allocation failed (an OutOfMemoryError will have been thrown in
+ *     the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_StripedTableInit(JNIEnv *env, JEM_StripedTable *table,
+                          juint bucketCount) {
+    int i;
+
+    (void) memset(table, 0, sizeof(JEM_StripedTable));
+    table->buckets = (JEM_StripedBuckets *) JEMCC_Malloc(env,
+                                     STRIPED_BUCKETS_SIZE(bucketCount - 1));
+    if (table->buckets == NULL) return JNI_ENOMEM;
+    table->buckets->bucketMask = bucketCount - 1;
+    for (i = 0; i < JEM_TABLE_STRIPES; i++) {
+        table->stripeMonitors[i] = JEMCC_CreateSysMonitor(env);
+        if (table->stripeMonitors[i] == NULL) {
+            JEM_StripedTableDestroy(table);
+            return JNI_ENOMEM;
+        }
+    }
+
+    return JNI_OK;
+}
+
+/**
+ * Scan the entries of a striped table.  Only to be used when there are no
+ * concurrent inserts.  The scan callback may release the entry.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context (may be NULL)
+ *     table - the table to be scanned
+ *     scanCB - the method to call for each entry
+ *     userData - caller provided information passed to the callback
+ */
+void JEM_StripedTableScan(JNIEnv *env, JEM_StripedTable *table,
+                          JEM_StripedScanCB scanCB, void *userData) {
+    JEM_StripedBuckets *buckets = table->buckets;
+    JEM_StripedEntry *entry, *next;
+    juint i;
+
+    /* Entries are only linked from the current bucket array */
+    if (buckets == NULL) return;
+    for (i = 0; i <= buckets->bucketMask; i++) {
+        for (entry = buckets->heads[i]; entry != NULL; entry = next) {
+            next = entry->next;
+            if ((*scanCB)(env, entry, userData) != JNI_OK) return;
+        }
+    }
+}
+
+/**
+ * Release the bucket arrays and monitors of a striped table (the entries
+ * must be released by the caller, e.g. through a prior scan).
+ *
+ * Parameters:
+ *     table - the table to be destroyed
+ */
+void JEM_StripedTableDestroy(JEM_StripedTable *table) {
+    JEM_StripedBuckets *buckets = table->buckets, *retired;
+    juint i;
+
+    while (buckets != NULL) {
+        retired = buckets->retired;
+        JEMCC_Free(buckets);
+        buckets = retired;
+    }
+    for (i = 0; i < JEM_TABLE_STRIPES; i++) {
+        if (table->stripeMonitors[i] != NULL) {
+            JEMCC_DestroySysMonitor(table->stripeMonitors[i]);
+        }
+    }
+    (void) memset(table, 0, sizeof(JEM_StripedTable));
+}
+
+/**
+ * Locate the entry for the given key in a bucket array of a striped table.
+ * As this is called without locking, a concurrent resize may cause a miss
+ * for an existing entry (but never a false match), so a miss must be
+ * confirmed under the stripe monitor.
+ */
+static JEM_StripedEntry *JEM_StripedBucketLookup(JNIEnv *env,
+                                        JEM_StripedBuckets *buckets,
+                                        const void *key, juint hashCode,
+                                        JEM_StripedKeyEqualsFn keyEqualsFn) {
+    JEM_StripedEntry *entry = buckets->heads[hashCode & buckets->bucketMask];
+
+    while (entry != NULL) {
+        if ((entry->hashCode == hashCode) &&
+            ((*keyEqualsFn)(env, entry, key) == JNI_TRUE)) return entry;
+        entry = entry->next;
+    }
+    return NULL;
+}
+
+/**
+ * Double the bucket count of a striped table, if the bucket array has not
+ * already been replaced.  All of the stripe monitors are held, so that
+ * there are no concurrent inserts.  The entries are relinked into the new
+ * array, readers of the original array may miss an entry but will always
+ * reach the end of a chain.  Failure to allocate the new array is ignored
+ * (the chains are just longer).
+ */
+static void JEM_StripedTableExpand(JNIEnv *env, JEM_StripedTable *table,
+                                   JEM_StripedBuckets *origBuckets) {
+    JEM_StripedBuckets *newBuckets;
+    JEM_StripedEntry *entry, *next;
+    juint i, index, newMask;
+
+    for (i = 0; i < JEM_TABLE_STRIPES; i++) {
+        JEMCC_EnterSysMonitor(table->stripeMonitors[i]);
+    }
+    if (table->buckets == origBuckets) {
+        newMask = (origBuckets->bucketMask << 1) | 1;
+        newBuckets = (JEM_StripedBuckets *) JEMCC_Malloc(env,
+                                               STRIPED_BUCKETS_SIZE(newMask));
+        if (newBuckets != NULL) {
+            newBuckets->bucketMask = newMask;
+            newBuckets->retired = origBuckets;
+            for (i = 0; i <= origBuckets->bucketMask; i++) {
+                entry = origBuckets->heads[i];
+                while (entry != NULL) {
+                    next = entry->next;
+                    index = entry->hashCode & newMask;
+                    entry->next = newBuckets->heads[index];
+                    newBuckets->heads[index] = entry;
+                    entry = next;
+                }
+            }
+            (void) JEM_AtomicSwapPointer((void **) &(table->buckets),
+                                         newBuckets);
+        }
+    }
+    for (i = JEM_TABLE_STRIPES; i > 0; i--) {
+        (void) JEMCC_ExitSysMonitor(table->stripeMonitors[i - 1]);
+    }
+}
+
+/**
+ * Locate the entry for the given key in a striped table.  The lookup does
+ * not lock, a miss is confirmed against the current bucket array under the
+ * monitor of the stripe.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to search
+ *     key - the key to be located, passed to the key match test
+ *     hashCode - the hashcode of the key
+ *     keyEqualsFn - the key match test for the table entries
+ *     insertLock - if JNI_TRUE and the key is not found, the stripe monitor
+ *                  is retained for an insert (the caller must then call
+ *                  JEM_StripedTableInsert or JEM_StripedTableUnlock)
+ *
+ * Returns:
+ *     The matching table entry or NULL if the key is not in the table.
+ */
+JEM_StripedEntry *JEM_StripedTableLookup(JNIEnv *env, JEM_StripedTable *table,
+                                         const void *key, juint hashCode,
+                                         JEM_StripedKeyEqualsFn keyEqualsFn,
+                                         jboolean insertLock) {
+    JEMCC_SysMonitor *monitor;
+    JEM_StripedEntry *entry;
+
+    /* Easy (unlocked) return when already existing in table */
+    entry = JEM_StripedBucketLookup(env, table->buckets, key, hashCode,
+                                    keyEqualsFn);
+    if (entry != NULL) return entry;
+
+    /* Confirm the miss against the current buckets, with inserts blocked */
+    monitor = table->stripeMonitors[JEM_TABLE_STRIPE(hashCode)];
+    JEMCC_EnterSysMonitor(monitor);
+    entry = JEM_StripedBucketLookup(env, table->buckets, key, hashCode,
+                                    keyEqualsFn);
+    if ((entry != NULL) || (insertLock == JNI_FALSE)) {
+        (void) JEMCC_ExitSysMonitor(monitor);
+    }
+
+    return entry;
+}
+
+/**
+ * Publish a new entry into a striped table, releasing the stripe monitor
+ * retained by the JEM_StripedTableLookup call which confirmed the miss.
+ * The bucket array is expanded when the stripe averages more than two
+ * entries per bucket (a failure to expand is ignored).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to insert into
+ *     entry - the complete new entry (the link record is initialized here)
+ *     hashCode - the hashcode of the entry key
+ */
+void JEM_StripedTableInsert(JNIEnv *env, JEM_StripedTable *table,
+                            JEM_StripedEntry *entry, juint hashCode) {
+    JEM_StripedBuckets *buckets = table->buckets;
+    juint stripe = JEM_TABLE_STRIPE(hashCode);
+    jboolean expand;
+
+    /* Entry must be complete before it is published to the readers */
+    entry->hashCode = hashCode;
+    entry->next = buckets->heads[hashCode & buckets->bucketMask];
+    (void) JEM_AtomicSwapPointer(
+               (void **) &(buckets->heads[hashCode & buckets->bucketMask]),
+               entry);
+
+    /* Expand when the stripe averages more than two entries per bucket */
+    table->stripeCounts[stripe]++;
+    expand = (table->stripeCounts[stripe] >
+                 2 * ((buckets->bucketMask + 1) / JEM_TABLE_STRIPES)) ?
+                                                         JNI_TRUE : JNI_FALSE;
+    (void) JEMCC_ExitSysMonitor(table->stripeMonitors[stripe]);
+    if (expand == JNI_TRUE) JEM_StripedTableExpand(env, table, buckets);
+}
+
+/**
+ * Release the stripe monitor retained by JEM_StripedTableLookup, where the
+ * insert of the new entry is abandoned.
+ *
+ * Parameters:
+ *     table - the table being inserted into
+ *     hashCode - the hashcode of the entry key
+ */
+void JEM_StripedTableUnlock(JEM_StripedTable *table, juint hashCode) {
+    (void) JEMCC_ExitSysMonitor(
+                        table->stripeMonitors[JEM_TABLE_STRIPE(hashCode)]);
+}
+
+/**
+ * Initialize the symbol table of a VM.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be initialized
+ *
+ * Returns:
+ *     JNI_OK if the table was initialized, JNI_ENOMEM if a memory
+ *     allocation failed (an OutOfMemoryError will have been thrown in
+ *     the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+jint JEM_SymbolTableInit(JNIEnv *env, JEM_SymbolTable *table) {
+    (void) memset(table, 0, sizeof(JEM_SymbolTable));
+    return JEM_StripedTableInit(env, &(table->symbols),
+                                SYMBOL_INITIAL_BUCKETS);
+}
+
+/**
+ * Scan callback to release the shared parsed descriptor of a symbol (the
+ * entries themselves are released with the stripe arenas).
+ */
+static jint JEM_SymbolReleaseScanner(JNIEnv *env, JEM_StripedEntry *entry,
+                                     void *userData) {
+    JEM_SymbolEntry *symEntry = (JEM_SymbolEntry *) entry;
+
+    if (symEntry->descriptor != NULL) {
+        JEM_DestroyDescriptor(symEntry->descriptor, JNI_TRUE);
+    }
+    return JNI_OK;
+}
+
+/**
+ * Release the symbol table and all of the interned symbols and descriptors.
+ * Only to be used when the virtual machine is destroyed (once all class
+ * definitions have been released).
+ *
+ * Parameters:
+ *     table - the table to be destroyed
+ */
+void JEM_SymbolTableDestroy(JEM_SymbolTable *table) {
+    int i;
+
+    JEM_StripedTableScan(NULL, &(table->symbols),
+                         JEM_SymbolReleaseScanner, NULL);
+    JEM_StripedTableDestroy(&(table->symbols));
+    for (i = 0; i < JEM_TABLE_STRIPES; i++) {
+        JEM_ArenaRelease(&(table->stripeArenas[i]));
+    }
+}
+
+/**
+ * Key match test for the symbol table, comparing the symbol text.
+ */
+static jboolean JEM_SymbolEqualsFn(JNIEnv *env, JEM_StripedEntry *entry,
+                                   const void *key) {
+    return (strcmp(((JEM_SymbolEntry *) entry)->text,
+                   (const char *) key) == 0) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Obtain the interned (VM-wide unique) instance of the given symbol text
+ * (class member name, descriptor, etc.), creating it if required.  Two
+ * interned symbols are equal if and only if their pointers are equal.
+ * Interned symbols are permanent (for the lifetime of the VM) and must
+ * never be modified or released.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     symbol - the (modified UTF-8) symbol text to intern
+ *
+ * Returns:
+ *     The interned symbol or NULL if the creation of the symbol failed (an
+ *     OutOfMemoryError has been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+char *JEM_InternSymbol(JNIEnv *env, const char *symbol) {
+    JEM_SymbolTable *table = &(((JEM_JNIEnv *) env)->parentVM->symbolTable);
+    juint hashCode = JEMCC_StrHashFn(env, (void *) symbol);
+    JEM_SymbolEntry *entry;
+
+    entry = (JEM_SymbolEntry *) JEM_StripedTableLookup(env, &(table->symbols),
+                                                       symbol, hashCode,
+                                                       JEM_SymbolEqualsFn,
+                                                       JNI_TRUE);
+    if (entry != NULL) return entry->text;
+
+    /* Entry and text are a single allocation from the stripe arena */
+    entry = (JEM_SymbolEntry *) JEM_ArenaAlloc(env,
+                      &(table->stripeArenas[JEM_TABLE_STRIPE(hashCode)]),
+                      sizeof(JEM_SymbolEntry) + strlen(symbol));
+    if (entry == NULL) {
+        JEM_StripedTableUnlock(&(table->symbols), hashCode);
+        return NULL;
+    }
+    (void) strcpy(entry->text, symbol);
+    JEM_StripedTableInsert(env, &(table->symbols), &(entry->link), hashCode);
+
+    return entry->text;
+}
+
+/**
+ * Obtain the interned instance of the given symbol text, if one exists.
+ * Used to convert external names and descriptors for the (pointer)
+ * comparisons against interned symbols - if the symbol has never been
+ * interned, it cannot match any class member.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     symbol - the (modified UTF-8) symbol text to locate
+ *
+ * Returns:
+ *     The interned symbol or NULL if no such symbol has been interned (no
+ *     exception is thrown).
+ */
+char *JEM_LookupSymbol(JNIEnv *env, const char *symbol) {
+    JEM_SymbolTable *table = &(((JEM_JNIEnv *) env)->parentVM->symbolTable);
+    juint hashCode = JEMCC_StrHashFn(env, (void *) symbol);
+    JEM_SymbolEntry *entry;
+
+    entry = (JEM_SymbolEntry *) JEM_StripedTableLookup(env, &(table->symbols),
+                                                       symbol, hashCode,
+                                                       JEM_SymbolEqualsFn,
+                                                       JNI_FALSE);
+
+    return (entry == NULL) ? NULL : entry->text;
+}
+
+/**
+ * Obtain the shared parsed descriptor for the given interned descriptor
+ * symbol, parsing it on first use.  The parsed descriptor is shared by all
+ * class members with the same descriptor and must never be destroyed by
+ * the caller.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     symbol - the interned descriptor symbol (from JEM_InternSymbol)
+ *     isStatic - for method descriptors, if JNI_FALSE this is an instance
+ *                method and can only have 254 arguments (otherwise 255)
+ *
+ * Returns:
+ *     NULL if a parsing error occurred (an exception will have been thrown
+ *     in the current environment), otherwise the shared descriptor instance.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ *     ClassFormatError - the descriptor information is invalid
+ */
+JEM_DescriptorData *JEM_InternDescriptor(JNIEnv *env, const char *symbol,
+                                         jboolean isStatic) {
+    JEM_SymbolTable *table = &(((JEM_JNIEnv *) env)->parentVM->symbolTable);
+    JEM_SymbolEntry *entry = SYMBOL_ENTRY(symbol);
+    JEM_DescriptorData *desc, *param;
+    JEMCC_SysMonitor *monitor;
+    int count;
+
+    /* Parse on first use, with the most permissive (static) checks */
+    desc = entry->descriptor;
+    if (desc == NULL) {
+        desc = JEM_ParseDescriptor(env, symbol, NULL, NULL, JNI_TRUE);
+        if (desc == NULL) return NULL;
+
+        /* Lost the race, another thread has already published it */
+        monitor = table->symbols.stripeMonitors[
+                                      JEM_TABLE_STRIPE(entry->link.hashCode)];
+        JEMCC_EnterSysMonitor(monitor);
+        if (entry->descriptor != NULL) {
+            JEM_DestroyDescriptor(desc, JNI_TRUE);
+            desc = entry->descriptor;
+        } else {
+            (void) JEM_AtomicSwapPointer((void **) &(entry->descriptor), desc);
+        }
+        (void) JEMCC_ExitSysMonitor(monitor);
+    }
+
+    /* Instance methods have the implicit 'this' argument */
+    if ((isStatic == JNI_FALSE) &&
+        (desc->generic.tag == DESCRIPTOR_MethodType)) {
+        param = desc->method_info.paramDescriptor;
+        for (count = 0; param->generic.tag != DESCRIPTOR_EndOfList; count++) {
+            param++;
+        }
+        if (count > 254) {
+            JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_ClassFormatError, NULL,
+                                  "Too many parameters for method descriptor");
+            return NULL;
+        }
+    }
+
+    return desc;
+}
@@ -320,8 +320,10 @@ jint JEM_GetSystemClass(JNIEnv *env, const char *className,
     JEM_JavaVM *jvm = (JEM_JavaVM *) ((JEM_JNIEnv *) env)->parentVM;
     JEM_ParsedClassData *pData;
     jbyte *rawClassData;
-    int rc, rawClassLen;
+    jsize rawClassLen;
+    jboolean isMapped;
     char *ptr, *fileName;
+    int rc;
 
     /* Build the 'directory' classname for loading */
     if (JEMCC_EnvStrBufferInit(env, 100) == NULL) return JNI_ENOMEM;
@@ -334,22 +336,42 @@ jint JEM_GetSystemClass(JNIEnv *env, const char *className,
         ptr--;
     }
 
-    /* Locate the class instance using the VM classpath information */
-    rc = JEM_ReadPathFileContents(env, &(jvm->classPath), fileName,
-                                  &rawClassData, &rawClassLen);
-    JEMCC_Free(fileName);
-    if ((rc == JNI_OK) && (rawClassLen >= 0)) {
-        /* Parse and link it */
-        pData = JEM_ParseClassData(env, rawClassData, rawClassLen);
-        JEMCC_Free(rawClassData);
-        if (pData == NULL) return JNI_ENOMEM;
-        *classInst = JEM_DefineAndResolveClass(env, jvm->systemClassLoader, 
-                                               pData);
-        return ((*classInst == NULL) ? JNI_ERR : JNI_OK);
+    /* Consume the class data if already parsed by the preload workers */
+    rc = JEM_ClaimPreloadedClass(env, className, &pData);
+    if (rc != JNI_OK) {
+        /* Or if available from the class data archive */
+        rc = JEM_GetArchivedClassData(env, className, fileName, &pData);
+        if (rc == JNI_ENOMEM) {
+            JEMCC_Free(fileName);
+            return rc;
+        }
     }
+    if (rc != JNI_OK) {
+        /* Locate the class instance using the VM classpath information */
+        rc = JEM_MapPathFileContents(env, &(jvm->classPath), fileName,
+                                     &rawClassData, &rawClassLen, &isMapped);
+        if ((rc != JNI_OK) || (rawClassLen < 0)) {
+            JEMCC_Free(fileName);
+
+            /* No matching class information found, return in silence */
+            return JNI_EINVAL;
+        }
 
-    // No matching class information found, return in silence */
-    return JNI_EINVAL;
+        /* Parse (referencing mapped data, scratch data is copied) */
+        pData = JEM_ParseClassData(env, rawClassData, rawClassLen, isMapped);
+        if (pData == NULL) {
+            JEMCC_Free(fileName);
+            return JNI_ENOMEM;
+        }
+    }
+
+    /* Capture for the class data archive (before linking) and link */
+    if (jvm->classArchiveWriter != NULL) {
+        JEM_RecordArchivedClassData(env, className, fileName, pData);
+    }
+    JEMCC_Free(fileName);
+    *classInst = JEM_DefineAndResolveClass(env, jvm->systemClassLoader, pData);
+    return ((*classInst == NULL) ? JNI_ERR : JNI_OK);
 }
 
 /* External method from classloader.c (loadClass implementation) */
@@ -596,6 +618,13 @@ jint JEMCC_InitializeClass(JNIEnv *env, JEMCC_Class *classInst) {
                         break;
                     }
 
+                    /* Rewrite the verified bytecode into quick forms */
+                    if (JEM_QuickenClassByteCode(env, classData) != JNI_OK) {
+                        classData->resolveInitState = JEM_CLASS_INIT_FAILED;
+                        initComplete = JNI_TRUE;
+                        break;
+                    }
+
                     /* All done linkages, set the parse data free */
                     JEM_DestroyParsedClassData(classData->parseData);
                     classData->parseData = NULL;
@@ -70,6 +70,7 @@
 #define PRIMITIVE_VOID     0x0900
 
 #define PRIMITIVE_TYPE_MASK 0x0F00
+#define ARRAY_DEPTH_MASK    0x00FF
 
 /**
  * Convenience method to obtain the "internal" name of the class.  This
@@ -219,6 +220,45 @@ typedef struct {
     struct ATTRIBUTE_info *attributes;
 } JEM_ParsedMethodData;
 
+/*
+ * Bump allocation arena, for metadata which is released as a single unit
+ * (see JEM_ArenaAlloc).  Zeroed to initialize an (empty) arena.
+ */
+typedef struct JEM_Arena {
+    struct JEM_ArenaBlock *blocks;
+    juint nextBlockSize;
+} JEM_Arena;
+
+/**
+ * Allocate a block of memory from the given arena.  Allocations are never
+ * individually released, the entire arena is released in one operation
+ * (see JEM_ArenaRelease).  Not multi-thread safe, the caller must control
+ * concurrent access to the arena.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     arena - the arena to allocate from
+ *     size - the number of bytes to allocate
+ *
+ * Returns:
+ *     NULL if memory allocation failed, otherwise the allocated storage block.
+ *     The allocated block of memory will be initialized to zero.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT void *JNICALL JEM_ArenaAlloc(JNIEnv *env, JEM_Arena *arena,
+                                       juint size);
+
+/**
+ * Release all of the memory allocated from the given arena.  The arena is
+ * reset to the initial (empty) state and may be reused.
+ *
+ * Parameters:
+ *     arena - the arena to be released
+ */
+JNIEXPORT void JNICALL JEM_ArenaRelease(JEM_Arena *arena);
+
 /* Storage structure for fully parsed binary class data */
 typedef struct JEM_ParsedClassData {
     jint classAccessFlags;
@@ -239,6 +279,15 @@ typedef struct JEM_ParsedClassData {
 
     jsize attributesCount;
     struct ATTRIBUTE_info *attributes;
+
+    /* If true, attribute information references the (persistent) source */
+    jboolean isMapped;
+
+    /* If true, constructed from a class data archive (see classarchive.c) */
+    jboolean isArchived;
+
+    /* Storage for all of the parsed elements, released as a unit */
+    JEM_Arena arena;
 } JEM_ParsedClassData;
 
 /**
@@ -252,6 +301,10 @@ typedef struct JEM_ParsedClassData {
  *     env - the VM environment which is currently in context
  *     buff - the binary data associated with the class to be parsed
  *     buffLen - the number of bytes in the provided binary data buffer
+ *     isMapped - if JNI_TRUE, the binary data will remain valid and
+ *                unmodified for the lifetime of the parsed class data
+ *                (e.g. mapped archive contents) and the attribute
+ *                information references it directly instead of copying
  *
  * Returns:
  *     NULL if a parsing error occurred, otherwise the structure instance
@@ -266,7 +319,8 @@ typedef struct JEM_ParsedClassData {
  */
 JNIEXPORT JEM_ParsedClassData *JNICALL JEM_ParseClassData(JNIEnv *env,
                                                           const jbyte *buff,
-                                                          jsize buffLen);
+                                                          jsize buffLen,
+                                                          jboolean isMapped);
 
 /**
  * Destroy the parsed class information, as returned from the ParseClassData
@@ -433,6 +487,64 @@ JNIEXPORT jint JNICALL JEM_ValidateDescriptor(JNIEnv *env,
                                               const char *descriptor,
                                               jboolean isMethod);
 
+/**
+ * Obtain the interned (VM-wide unique) instance of the given symbol text
+ * (class member name, descriptor, etc.), creating it if required.  Two
+ * interned symbols are equal if and only if their pointers are equal.
+ * Interned symbols are permanent (for the lifetime of the VM) and must
+ * never be modified or released.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     symbol - the (modified UTF-8) symbol text to intern
+ *
+ * Returns:
+ *     The interned symbol or NULL if the creation of the symbol failed (an
+ *     OutOfMemoryError has been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT char *JNICALL JEM_InternSymbol(JNIEnv *env, const char *symbol);
+
+/**
+ * Obtain the interned instance of the given symbol text, if one exists.
+ * If the symbol has never been interned, it cannot match any class member.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     symbol - the (modified UTF-8) symbol text to locate
+ *
+ * Returns:
+ *     The interned symbol or NULL if no such symbol has been interned (no
+ *     exception is thrown).
+ */
+JNIEXPORT char *JNICALL JEM_LookupSymbol(JNIEnv *env, const char *symbol);
+
+/**
+ * Obtain the shared parsed descriptor for the given interned descriptor
+ * symbol, parsing it on first use.  The parsed descriptor is shared by all
+ * class members with the same descriptor and must never be destroyed by
+ * the caller.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     symbol - the interned descriptor symbol (from JEM_InternSymbol)
+ *     isStatic - for method descriptors, if JNI_FALSE this is an instance
+ *                method and can only have 254 arguments (otherwise 255)
+ *
+ * Returns:
+ *     NULL if a parsing error occurred (an exception will have been thrown
+ *     in the current environment), otherwise the shared descriptor instance.
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ *     ClassFormatError - the descriptor information is invalid
+ */
+JNIEXPORT JEM_DescriptorData *JNICALL JEM_InternDescriptor(JNIEnv *env,
+                                                        const char *symbol,
+                                                        jboolean isStatic);
+
 /**
  * "Unparse" a descriptor, converting the parsed descriptor structure
  * back into the internal Java string representation of the descriptor.
@@ -493,8 +605,22 @@ typedef struct JEM_MethodExceptionBlock {
         jint index;
         JEMCC_Class *instance;
     } exceptionClass;
+
 } JEM_MethodExceptionBlock;
 
+/*
+ * Sorted index of the exception table, one record per distinct range of
+ * PC values which is covered by at least one handler.  The handlers array
+ * lists the exception table indices active across the range, in table
+ * (precedence) order.  Ranges do not overlap, allowing a binary search.
+ */
+typedef struct JEM_HandlerRange {
+    jint startPC;
+    jint endPC;
+    jsize handlerCount;
+    jint *handlers;
+} JEM_HandlerRange;
+
 #ifndef NO_JVM_DEBUG
 typedef struct JEM_LineNumberEntry {
     jint startPC;
@@ -510,6 +636,42 @@ typedef struct JEM_LocalVariableEntry {
 } JEM_LocalVariableEntry;
 #endif
 
+/*
+ * Inline cache for a virtual/interface method call site, keyed on the class
+ * of the target object.  Entries are filled in order (under the global
+ * monitor) and never replaced, so a site which sees more receiver classes
+ * than there are entries (megamorphic) falls back to the full lookup.  The
+ * receiver class is published (JEM_AtomicSwapPointer) after the method, as
+ * the cache is read without locking.
+ */
+#define JEM_CALLSITE_CACHE_SIZE 4
+
+typedef struct JEM_CallSiteCacheEntry {
+    JEMCC_Class *volatile receiverClass;
+    struct JEM_ClassMethodData *volatile targetMethod;
+} JEM_CallSiteCacheEntry;
+
+typedef struct JEM_CallSiteCache {
+    struct JEM_ClassMethodData *methodRef;
+    JEM_CallSiteCacheEntry entries[JEM_CALLSITE_CACHE_SIZE];
+} JEM_CallSiteCache;
+
+/**
+ * Pre-decoded tableswitch/lookupswitch instruction (see
+ * JEM_QuickenClassByteCode), with the jump targets converted to absolute
+ * program counter locations.  For tableswitch, the targets are indexed
+ * directly by the switch value less the low index.  For lookupswitch, the
+ * keys are in ascending order (as required by the specification) with the
+ * matching target at the same index.
+ */
+typedef struct JEM_SwitchTable {
+    jint defaultPC;
+    jint lowIndex;
+    jsize count;
+    jint *keys;
+    jint *targetPCs;
+} JEM_SwitchTable;
+
 typedef struct JEM_BCMethod {
     jsize maxStack;
     jsize maxLocals;
@@ -517,6 +679,21 @@ typedef struct JEM_BCMethod {
     jubyte *code;
     jsize exceptionTableLength;
     JEM_MethodExceptionBlock *exceptionTable;
+    jsize handlerRangeCount;
+    JEM_HandlerRange *handlerRanges;
+
+    /* Call site caches (see JEM_QuickenClassByteCode) */
+    jsize callSiteCount;
+    JEM_CallSiteCache *callSiteCaches;
+#ifdef ENABLE_CALLSITE_STATS
+    /* Unsynchronized (approximate) counts, --enable-callsite-stats only */
+    juint callSiteHits;
+    juint callSiteMisses;
+#endif
+
+    /* Decoded switch tables (see JEM_QuickenClassByteCode) */
+    jsize switchTableCount;
+    JEM_SwitchTable *switchTables;
 
 #ifndef NO_JVM_DEBUG
     jsize lineNumberTableLength;
@@ -561,6 +738,7 @@ JNIEXPORT JEM_BCMethod *JNICALL JEM_ParseMethodCode(JNIEnv *env,
  */
 JNIEXPORT void JNICALL JEM_DestroyMethodCode(JEM_BCMethod *method);
 
+/* Note: member names, descriptors and parsed descriptors are interned */
 typedef struct JEM_ClassMethodData {
     juint accessFlags;
     char *name;
@@ -599,6 +777,22 @@ typedef struct JEM_ClassFieldRefError {
     JEM_DescriptorData *descriptor;
 } JEM_ClassFieldRefError;
 
+/*
+ * Open-addressed hash index of class members, keyed on the (interned)
+ * name and descriptor pair.  Built once the member tables of the class are
+ * complete and never modified thereafter (read without locking).
+ */
+typedef struct JEM_MemberIndexEntry {
+    char *name;
+    char *descriptor;
+    void *member;
+} JEM_MemberIndexEntry;
+
+typedef struct JEM_MemberIndex {
+    juint mask;
+    JEM_MemberIndexEntry entries[1];
+} JEM_MemberIndex;
+
 typedef union JEM_ClassConstant {
     struct {
         jint tag;
@@ -640,6 +834,16 @@ typedef union JEM_ClassConstant {
 #define JEM_CLASS_INIT_COMPLETE       6
 #define JEM_CLASS_ABSTRACT_ERROR      7
 
+/**
+ * Scan hook for the object references held in the native data element of
+ * a JEMCC class instance, which the collector cannot locate from the field
+ * layout.  Called from the collector workers (there is no environment),
+ * each reference is passed to the provided mark callback.
+ */
+typedef void (*JEM_GCMarkFn)(void *markData, JEMCC_Object *obj);
+typedef void (*JEM_GCScanFn)(JEMCC_Object *obj, JEM_GCMarkFn markFn,
+                             void *markData);
+
 typedef struct JEM_ClassData {
     /* Class flag information (see ACC_ defines) */
     juint accessFlags;
@@ -659,6 +863,13 @@ typedef struct JEM_ClassData {
     JEMCC_Class **assignList;
     jsize interfaceCount, assignmentCount;
 
+    /* Supertype display (superclass chain from Object, indexed by depth), */
+    /* all superinterfaces (NULL terminated) and the last interface matched */
+    JEMCC_Class **superDisplay;
+    jsize superDepth;
+    JEMCC_Class **superInterfaces;
+    JEMCC_Class *volatile interfaceCache;
+
     /* Reference tables for class/interface method vtables */
     JEM_ClassMethodData ***methodLinkTables;
     jsize classMethodCount, syntheticMethodCount;
@@ -669,6 +880,9 @@ typedef struct JEM_ClassData {
     JEM_ClassFieldData *localFields;
     jsize localFieldCount;
 
+    /* Hashed lookups over the method table, local methods and all fields */
+    JEM_MemberIndex *methodIndex, *localMethodIndex, *fieldIndex;
+
     /* Field packing information */
     juint packedFieldSize;
 
@@ -680,6 +894,12 @@ typedef struct JEM_ClassData {
     JEM_ClassMethodData **classMethodRefs;
     JEM_ClassFieldData **classFieldRefs;
 
+    /* Object management method of JEMCC classes (NULL for the defaults) */
+    JEMCC_ObjMgmtFn objMgmtFn;
+
+    /* Collector scan of native data references (NULL if none held) */
+    JEM_GCScanFn gcScanFn;
+
     /* Miscellaneous bits and pieces */
     char *sourceFile;
 } JEM_ClassData;
@@ -831,17 +1051,50 @@ JNIEXPORT jint JNICALL JEM_ClassNameSpaceStore(JNIEnv *env,
 JNIEXPORT void JNICALL JEM_ClassNameSpaceRemove(JNIEnv *env,
                                                 JEMCC_Class *classInst);
 
+/**
+ * Determine if instances of the source class may be assigned to references
+ * of the target class (the instanceof/checkcast relationship, including
+ * the array covariance rules).  Superclass targets are resolved in constant
+ * time through the supertype display, interface targets through a scan of
+ * the superinterface list (with a single entry cache of the last match).
+ *
+ * Parameters:
+ *     source - the class of the instance being assigned
+ *     target - the class of the reference being assigned to
+ *
+ * Returns:
+ *     JNI_TRUE if the assignment is valid, JNI_FALSE otherwise.
+ */
+JNIEXPORT jboolean JNICALL JEM_IsAssignableClass(JEMCC_Class *source,
+                                                 JEMCC_Class *target);
+
+/**
+ * Determine if instances of the source class may be stored as elements of
+ * an array of the given (object or nested array) class, as required for
+ * the aastore operation.
+ *
+ * Parameters:
+ *     source - the class of the instance being stored
+ *     arrayClass - the class of the array receiving the instance
+ *
+ * Returns:
+ *     JNI_TRUE if the element store is valid, JNI_FALSE otherwise.
+ */
+JNIEXPORT jboolean JNICALL JEM_IsAssignableArrayElement(JEMCC_Class *source,
+                                                JEMCC_ArrayClass *arrayClass);
+
 /**
  * Locate a method instance in the given class definition, using the
  * name and descriptor of the method in question.  Only scans the primary
  * linked method table (inheritance and interfaces accounted for), not
  * the local method table (i.e. this method will not locate the <init> or
- * <clinit> methods).
+ * <clinit> methods).  The name and descriptor must be the interned
+ * symbols (see JEM_LookupSymbol), as they are compared by reference.
  *
  * Parameters:
  *     classData - the class definition to search for the method
- *     name - the name of the method to find
- *     descriptor - the descriptor of the method to find
+ *     name - the (interned) name of the method to find
+ *     descriptor - the (interned) descriptor of the method to find
  *
  * Returns:
  *     The method definition reference if the method was found, NULL otherwise.
@@ -851,16 +1104,36 @@ JNIEXPORT JEM_ClassMethodData *JNICALL
                                             const char *name,
                                             const char *descriptor);
 
+/**
+ * Locate a method instance in the local method table of the given class
+ * definition (the methods declared by the class itself, including the
+ * <init> and <clinit> methods).  As above, the name and descriptor must be
+ * the interned symbols.
+ *
+ * Parameters:
+ *     classData - the class definition to search for the method
+ *     name - the (interned) name of the method to find
+ *     descriptor - the (interned) descriptor of the method to find
+ *
+ * Returns:
+ *     The method definition reference if the method was found, NULL otherwise.
+ */
+JNIEXPORT JEM_ClassMethodData *JNICALL
+                      JEM_LocateLocalMethod(JEM_ClassData *classData,
+                                            const char *name,
+                                            const char *descriptor);
+
 /**
  * Locate a field instance in the given class definition, using the
  * name and descriptor of the field in question.  Will scan local field
  * definitions, then recurse over superinterfaces and superclasses
- * according to the sequence defined in the Java VM specification.
+ * according to the sequence defined in the Java VM specification.  As
+ * with methods, the name and descriptor must be the interned symbols.
  *
  * Parameters:
  *     classData - the class definition to search for the field
- *     name - the name of the field to find
- *     descriptor - the descriptor of the field to find
+ *     name - the (interned) name of the field to find
+ *     descriptor - the (interned) descriptor of the field to find
  *
  * Returns:
  *     The method definition reference if the method was found, NULL otherwise.
@@ -960,6 +1233,31 @@ JNIEXPORT jint JNICALL JEM_LinkClassReferences(JNIEnv *env,
 JNIEXPORT jint JNICALL JEM_VerifyClassByteCode(JNIEnv *env,
                                                JEM_ClassData *classData);
 
+/**
+ * Rewrite ("quicken") the verified method bytecode of the given class for
+ * faster interpretation.  Instance field operations whose references have
+ * been successfully resolved are replaced with internal quick opcodes, where
+ * the operand is the object data offset of the field and the opcode itself
+ * encodes the storage type.  Resolved invokevirtual/invokeinterface calls
+ * are replaced with quick variants which reference a per-method inline
+ * cache for the call site.  Must be called after JEM_VerifyClassByteCode.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     classData - the linked and verified class instance information
+ *
+ * Returns:
+ *     JNI_OK - the class bytecode was quickened
+ *     JNI_ENOMEM - a memory allocation failed for the call site caches and
+ *                  an OutOfMemory error has been thrown in the current
+ *                  environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_QuickenClassByteCode(JNIEnv *env,
+                                                JEM_ClassData *classData);
+
 /**
  * Internal method to construct array class instances on demand.  This method
  * manually constructs the JEMCC_ArrayClass instance (which overlays the
@@ -1040,6 +1338,168 @@ JNIEXPORT jint JNICALL JEM_BuildArrayClass(JNIEnv *env, JEMCC_Object *loader,
 JNIEXPORT jint JNICALL JEM_ParseLibPackageInfo(JNIEnv *env, char *pkgFileData, 
                                                int pkgFileLen);
 
+/**
+ * Preload a set of classes through the system classloader, parsing the
+ * class data in parallel.  A pool of worker threads parses the classes
+ * in list order, while the calling (loader) thread defines and links
+ * each class in turn, claiming the parsed data in dependency order (see
+ * JEM_ClaimPreloadedClass).  Classes which fail to load are skipped.
+ * NOTE: this method is only intended to be used during VM initialization.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     classListFile - the name of a file containing the list of classes to
+ *                     be preloaded (one per line).  If NULL, all of the
+ *                     classes contained in the Zip/Jar files of the VM
+ *                     classpath are preloaded
+ *     workerCount - the number of parsing threads to start (if <= 0, a
+ *                   default number of threads is used)
+ *
+ * Returns:
+ *     JNI_OK - the preload was completed
+ *     JNI_ERR - the class list file could not be read (an exception has been
+ *               thrown in the current environment)
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ *     IOException - the class list file could not be opened
+ */
+JNIEXPORT jint JNICALL JEM_PreloadSystemClasses(JNIEnv *env,
+                                                const char *classListFile,
+                                                jint workerCount);
+
+/**
+ * Obtain the preparsed class data for the given class, if a preload is
+ * underway and the class is part of the preload set.  Waits if the class
+ * is currently being parsed by a preload worker.  Each entry can only be
+ * claimed once.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     className - the fully qualified (dotted) name of the class to claim
+ *     pData - the parsed class data reference through which the preparsed
+ *             class information is returned (if available).  The caller
+ *             takes ownership of the parsed data
+ *
+ * Returns:
+ *     JNI_OK - the class has been preparsed and the data has been returned
+ *              through the pData reference
+ *     JNI_EINVAL - no preparsed data is available for the class (no
+ *                  exception is thrown)
+ */
+JNIEXPORT jint JNICALL JEM_ClaimPreloadedClass(JNIEnv *env,
+                                               const char *className,
+                                               JEM_ParsedClassData **pData);
+
+/**
+ * Open a class data archive for use by the system classloader.  The archive
+ * is validated against the current VM layout and classpath, classes whose
+ * source Zip/Jar file has changed are ignored.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     fileName - the name of the archive file to open
+ *
+ * Returns:
+ *     JNI_OK - the archive was opened and validated
+ *     JNI_EINVAL - the archive is missing or is not valid for this VM (no
+ *                  exception is thrown)
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_OpenClassArchive(JNIEnv *env, const char *fileName);
+
+/**
+ * Release the class archive of the virtual machine (if opened).  Only to be
+ * used when the virtual machine is destroyed.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+JNIEXPORT void JNICALL JEM_CloseClassArchive(JNIEnv *env);
+
+/**
+ * Obtain the parsed class data for a system class from the class archive,
+ * if the archived class is still valid (same classpath source, size and
+ * CRC).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     className - the fully qualified (dotted) name of the class
+ *     fileName - the classpath file name of the class
+ *     pData - the parsed class data reference through which the archived
+ *             class information is returned (if available).  The caller
+ *             takes ownership of the parsed data
+ *
+ * Returns:
+ *     JNI_OK - the class data was available and has been returned through
+ *              the pData reference
+ *     JNI_EINVAL - the class is not available from the archive (no
+ *                  exception is thrown)
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_GetArchivedClassData(JNIEnv *env,
+                                                const char *className,
+                                                const char *fileName,
+                                                JEM_ParsedClassData **pData);
+
+/**
+ * Begin the recording of a class data archive, which is written when the
+ * virtual machine is destroyed (see JEM_WriteClassArchive).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     fileName - the name of the archive file to be written
+ *
+ * Returns:
+ *     JNI_OK - the archive recording has been started
+ *     JNI_ENOMEM - a memory allocation error has occurred and an OutOfMemory
+ *                  error has been thrown in the current environment
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_CreateClassArchive(JNIEnv *env,
+                                              const char *fileName);
+
+/**
+ * Record the parsed data of a system class in the class archive being
+ * created.  Must be called before the class is linked.  Only classes
+ * provided by classpath Zip/Jar files are recorded.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     className - the fully qualified (dotted) name of the class
+ *     fileName - the classpath file name of the class
+ *     pData - the parsed class data to be recorded (unmodified)
+ */
+JNIEXPORT void JNICALL JEM_RecordArchivedClassData(JNIEnv *env,
+                                                   const char *className,
+                                                   const char *fileName,
+                                                   JEM_ParsedClassData *pData);
+
+/**
+ * Write the class archive recorded during the lifetime of the virtual
+ * machine (if any) and release the recording information.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *
+ * Returns:
+ *     JNI_OK - the archive was written (or none was being recorded)
+ *     JNI_ERR - the archive file could not be written
+ */
+JNIEXPORT jint JNICALL JEM_WriteClassArchive(JNIEnv *env);
+
 /**
  * Collection method used to destroy class instances and attachments.  Used
  * for cleanup operations following errors during class creation and for
@@ -139,6 +139,8 @@ typedef union JEM_DblFrameEntry {
 #define FRAME_TYPE_MASK 0x03
 
 #define FRAME_THROWABLE_CAPTURE 0x08
+#define FRAME_REGION_PINNED 0x10
+#define FRAME_SAFE_REGION 0x20
 
 /* This is the actual frame structure used within the VM */
 typedef struct JEM_VMFrameExt {
@@ -160,6 +162,10 @@ typedef struct JEM_VMFrameExt {
 
     /* Pointer to the first object allocated in this frame */
     void *firstAllocObjectRecord;
+
+    /* Last record allocated prior to this frame and allocation region mark */
+    void *allocPrevRecord, *allocRegionBlock;
+    jubyte *allocRegionPtr;
 } JEM_VMFrameExt;
 
 /* <jemcc_start> */
@@ -222,6 +228,28 @@ JNIEXPORT JEMCC_Class *JNICALL JEMCC_GetCallingClassInstance(JNIEnv *env);
 
 /* <jemcc_end> */
 
+/**
+ * Allocate the frame stack for a new environment and initialize the root
+ * frame.  Called before the environment is otherwise usable, so no
+ * exception is thrown on failure.
+ *
+ * Parameters:
+ *     env - the VM environment to allocate the frame stack for
+ *
+ * Returns:
+ *     JNI_OK - the frame stack was allocated and initialized
+ *     JNI_ENOMEM - the frame stack memory could not be allocated
+ */
+JNIEXPORT jint JNICALL JEM_CreateFrameStack(JNIEnv *env);
+
+/**
+ * Release the frame stack of an environment.
+ *
+ * Parameters:
+ *     env - the VM environment to release the frame stack for
+ */
+JNIEXPORT void JNICALL JEM_DestroyFrameStack(JNIEnv *env);
+
 /**
  * Generate a new frame instance on the provided environment stack.
  * Externally exposed for test purposes only - the PushFrame method
@@ -239,11 +267,10 @@ JNIEXPORT JEMCC_Class *JNICALL JEMCC_GetCallingClassInstance(JNIEnv *env);
  *                       for method use
  *
  * Returns:
- *     The new execution frame instance or NULL if a memory allocation
- *     failed (an exception will be thrown in the current environment).
+ *     The new execution frame instance or NULL if the frame could not be
+ *     allocated (an exception will be thrown in the current environment).
  *
  *  Exceptions:
- *     OutOfMemoryError - a memory allocation failed in creating the frame
  *     StackOverflowError - the new frame has exceeded the recursion limit
  *                          for the application
  */
@@ -52,6 +52,20 @@ JNIEXPORT int JNICALL JEM_CheckErrorSweep(int sweepType);
 
 #endif
 
+/**
+ * Macros for the SSE2 vector kernels (string and hashtable scans).  Where
+ * configure determined that the compiler can build them, the kernels are
+ * compiled for SSE2 individually (through the GCC target attribute) and
+ * are only called if the processor reports SSE2 support through CPUID.
+ * Other processors (and other hosts) use the scalar equivalents.
+ */
+#ifdef ENABLE_SSE2_KERNELS
+
+#define JEM_SSE2_KERNEL __attribute__((target("sse2")))
+#define JEM_CPU_HAS_SSE2() (__builtin_cpu_supports("sse2"))
+
+#endif
+
 /********************* Memory/Object Management ************************/
 
 /**
@@ -725,11 +739,14 @@ JNIEXPORT jint JNICALL JEMCC_LastStringChar(JNIEnv *env,
  * Hashtable data management.  Generic hashing structure and methods for
  * maintaining keyed data records.  Note that this is used internally by
  * the engine routines and is also used by the Hashtable implementation.
+ * The control array holds the per-entry probe markers (it shares the
+ * allocation of the entries and is unused by the legacy implementation).
  */
 typedef struct JEMCC_HashTable {
     juint entryCount, occupied;
     juint tableMask;
     struct JEM_HashEntry *entries;
+    jubyte *control;
 } JEMCC_HashTable;
 
 /**
@@ -1068,6 +1085,26 @@ JNIEXPORT void JNICALL JEMCC_HashDestroyTable(JEMCC_HashTable *table);
 
 /* * * * * * * * * * * Convenience Hash Methods * * * * * * * * * * */
 
+/*
+ * Block mixing and finalization steps shared by the key hash functions
+ * (after the 32-bit MurmurHash3).  Keys are consumed four bytes (or two
+ * jchars) per block, the finalization avalanches the result so that the
+ * low order bits used by the hashtable index masks are well distributed.
+ */
+#define JEMCC_HASH_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define JEMCC_HASH_BLOCK(hash, block) { \
+            juint _blk = (juint) (block) * 0xcc9e2d51U; \
+            _blk = JEMCC_HASH_ROTL(_blk, 15) * 0x1b873593U; \
+            (hash) ^= _blk; \
+            (hash) = JEMCC_HASH_ROTL((hash), 13) * 5 + 0xe6546b64U; \
+        }
+#define JEMCC_HASH_FINAL(hash, length) { \
+            (hash) ^= (juint) (length); \
+            (hash) ^= (hash) >> 16; (hash) *= 0x85ebca6bU; \
+            (hash) ^= (hash) >> 13; (hash) *= 0xc2b2ae35U; \
+            (hash) ^= (hash) >> 16; \
+        }
+
 /**
  * Generate the hashcode value for a char sequence of characters (may
  * be ASCII or UTF-8 encoded Unicode) given in the key.
@@ -1157,6 +1194,7 @@ JNIEXPORT jboolean JNICALL JEMCC_ClassNameEqualsFn(JNIEnv *env,
 #define JEM_PATH_DIR 1
 #define JEM_PATH_JARZIP 2
 #define JEM_PATH_INV 3
+#define JEM_PATH_BADZIP 4
 
 struct JEMCC_ZipFile;
 typedef struct JEM_PathEntryList {
@@ -1242,6 +1280,79 @@ JNIEXPORT jint JNICALL JEM_ReadPathFileContents(JNIEnv *env,
                                                 jbyte **rawFileData,
                                                 jsize *rawFileSize);
 
+/**
+ * Obtain the contents of a file located in the specified path list, without
+ * an allocated copy.  Identical to the ReadPathFileContents method above,
+ * except that stored entries of (mapped) Zip files are returned directly
+ * from the mapped region and all other files are inflated/read into the
+ * environment scratch buffer.  Primarily for class loading, where the
+ * parser copies (or references, if mapped) the required information.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     pathList - the path entry set on which the file is located
+ *     fileName - the name of the file to be read
+ *     rawFileData - the contents of the file, either in the mapped region
+ *                   (valid while the path list is open) or the environment
+ *                   scratch buffer (valid until its next use).  Must not be
+ *                   freed or modified by the caller.
+ *     rawFileSize - the size of the file (and hence the buffer contents)
+ *     isMapped - a reference through which JNI_TRUE is returned if the
+ *                file contents are in a persistent mapped region
+ *
+ * Returns:
+ *     JNI_OK - the file was found and the read completed successfully
+ *     JNI_EINVAL - the specified file was not found on the path
+ *     JNI_ERR - the file was found and a read error occurred or a memory
+ *               failure occurred while *reading* the file (an exception
+ *               will be thrown in the current environment)
+ *     JNI_ENOMEM - a memory failure occurred while *searching* for the
+ *                  file (an exception will be thrown in the current
+ *                  environment)
+ *
+ * Exceptions:
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     InternalError - an unexpected zlib library error occurred
+ *     OutOfMemoryError - a memory allocation failed (search or read)
+ */
+JNIEXPORT jint JNICALL JEM_MapPathFileContents(JNIEnv *env,
+                                               JEM_PathEntryList *pathList,
+                                               const char *fileName,
+                                               jbyte **rawFileData,
+                                               jsize *rawFileSize,
+                                               jboolean *isMapped);
+
+/**
+ * Locate the first entry of the path list which provides the given file,
+ * without reading the file contents.  Used to validate previously recorded
+ * information about the file.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     pathList - the path entry set on which the file is located
+ *     fileName - the name of the file to be located
+ *     entryIndex - the index of the path entry containing the file
+ *     fileSize - the size of the file (uncompressed, for Zip/Jar entries)
+ *     crc32 - the checksum of the file from the Zip/Jar directory (zero for
+ *             directory path entries)
+ *
+ * Returns:
+ *     JNI_OK - the file was found and the details have been returned
+ *     JNI_EINVAL - the specified file was not found on the path
+ *     JNI_ENOMEM - a memory failure occurred while searching for the file
+ *                  (an exception will be thrown in the current environment)
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_LocatePathFile(JNIEnv *env,
+                                          JEM_PathEntryList *pathList,
+                                          const char *fileName,
+                                          jint *entryIndex, jsize *fileSize,
+                                          juint *crc32);
+
 /**
  * Load a dynamic library through a specified source path (similar to
  * LD_LIBRARY_PATH).  Searches each directory entry in the path for the
@@ -1474,7 +1585,8 @@ JNIEXPORT JEMCC_Object *JNICALL JEMCC_CatchThrowable(JNIEnv *env,
  * Methods to manage the extraction and rethrow of throwables. TBD.
  */
 JNIEXPORT JEMCC_Object *JNICALL JEM_ExtractSkeletonThrowable(JNIEnv *env);
-JNIEXPORT void JNICALL JEM_ThrowSkeletonThrowable(JEMCC_Object *skeleton);
+JNIEXPORT void JNICALL JEM_ThrowSkeletonThrowable(JNIEnv *env,
+                                                  JEMCC_Object *skeleton);
 
 /*
  * Make this file the "one-stop" source for all of the VM definitions.
@@ -627,6 +627,20 @@ JNIEXPORT void JNICALL JEMCC_SetDoubleArrayRegion(JNIEnv *env,
                                                   jsize start, jsize len,
                                                   jdouble *buff);
 
+/* Equivalents of the JNI 1.2 critical access methods (not in the table) */
+JNIEXPORT void *JNICALL JEMCC_GetPrimitiveArrayCritical(JNIEnv *env,
+                                                        jarray array,
+                                                        jboolean *isCopy);
+JNIEXPORT void JNICALL JEMCC_ReleasePrimitiveArrayCritical(JNIEnv *env,
+                                                           jarray array,
+                                                           void *carray,
+                                                           jint mode);
+JNIEXPORT const jchar *JNICALL JEMCC_GetStringCritical(JNIEnv *env,
+                                                       jstring str,
+                                                       jboolean *isCopy);
+JNIEXPORT void JNICALL JEMCC_ReleaseStringCritical(JNIEnv *env, jstring str,
+                                                   const jchar *carray);
+
 JNIEXPORT jint JNICALL JEMCC_RegisterNatives(JNIEnv *env, jclass clazz,
                                              const JNINativeMethod *methods,
                                              jint nMethods);
@@ -27,6 +27,68 @@
 
 /* NOTE: this is auto-read by jem.h, so it shouldn't be directly read */
 
+/*
+ * Chained hashtable which is read without locking, shared by the intern()'ed
+ * String table and the symbol table of the VM (see core/symbol.c).  Entries
+ * are never removed or relocated, new entries are published at the head of
+ * the bucket chains and the bucket array is only ever replaced (previous
+ * arrays are retained until the table is destroyed).  Inserts are
+ * serialized by the monitor of the stripe selected by the hashcode.  Each
+ * entry structure begins with the chain link record.
+ */
+#define JEM_TABLE_STRIPES 16
+
+/* Stripe of a striped table which controls inserts for the hashcode */
+#define JEM_TABLE_STRIPE(hashCode) ((hashCode) & (JEM_TABLE_STRIPES - 1))
+
+typedef struct JEM_StripedEntry {
+    juint hashCode;
+    struct JEM_StripedEntry *next;
+} JEM_StripedEntry;
+
+typedef struct JEM_StripedBuckets {
+    juint bucketMask;
+    struct JEM_StripedBuckets *retired;
+    JEM_StripedEntry *heads[1];
+} JEM_StripedBuckets;
+
+typedef struct JEM_StripedTable {
+    JEM_StripedBuckets *buckets;
+    JEMCC_SysMonitor *stripeMonitors[JEM_TABLE_STRIPES];
+    juint stripeCounts[JEM_TABLE_STRIPES];
+} JEM_StripedTable;
+
+/* Key match test of a striped table lookup (entry has the key hashcode) */
+typedef jboolean (*JEM_StripedKeyEqualsFn)(JNIEnv *env,
+                                           JEM_StripedEntry *entry,
+                                           const void *key);
+
+/* The intern()'ed String table of the VM */
+typedef struct JEM_InternEntry {
+    JEM_StripedEntry link;
+    JEMCC_StringData *strData;
+    JEMCC_Object *string;
+} JEM_InternEntry;
+
+typedef JEM_StripedTable JEM_InternTable;
+
+/*
+ * The symbol table of the VM interns the names and descriptors of the class
+ * members (and the shared parsed descriptors).  Entries and their text are
+ * allocated from the arena of the stripe and are never released until the
+ * VM is destroyed.
+ */
+typedef struct JEM_SymbolEntry {
+    JEM_StripedEntry link;
+    JEM_DescriptorData *descriptor;
+    char text[1];
+} JEM_SymbolEntry;
+
+typedef struct JEM_SymbolTable {
+    JEM_StripedTable symbols;
+    JEM_Arena stripeArenas[JEM_TABLE_STRIPES];
+} JEM_SymbolTable;
+
 /* Definition of the private virtual machine structure */
 typedef struct JEM_JavaVM {
     /* Base of the structure must be the standard VM pointer */
@@ -55,8 +117,35 @@ typedef struct JEM_JavaVM {
     /* Dynamic loader used for JEMCC and JNI dynamic loading */
     JEM_DynaLibLoader libLoader;
 
-    /* VM-local hashtable for intern()'ed java.lang.String data */
-    JEMCC_HashTable internStringTable;
+    /* VM-local table for intern()'ed java.lang.String data */
+    JEM_InternTable internStringTable;
+
+    /* VM-wide table of interned member names and descriptors */
+    JEM_SymbolTable symbolTable;
+
+    /* Global heap list of object records promoted from frame regions */
+    void *heapObjectRecords;
+    juint heapObjectCount, heapObjectBytes;
+
+    /* Promoted large object blocks and records pending the (lazy) sweep */
+    void *heapLargeList, *heapSweepRecords;
+    juint heapSweepCount;
+
+    /* Garbage collector control, collection threshold and pause statistics */
+    struct JEM_GCControl *gcControl;
+    jboolean gcActive;
+    volatile jint gcSafepoint;
+    JEMCC_SysMonitor *safepointMonitor;
+    juint gcThreshold, gcMinThreshold, gcWorkerCount, gcCount;
+    juint gcLastPauseMicros, gcMaxPauseMicros;
+    jlong gcTotalPauseMicros;
+
+    /* Parallel class preload control (only during the VM initialization) */
+    struct JEM_PreloadControl *preloadControl;
+
+    /* Class data archive in use and/or being recorded (if enabled) */
+    struct JEM_ClassArchive *classArchive;
+    struct JEM_ClassArchiveWriter *classArchiveWriter;
 
     /* VM-global runtime options (as passed via invocation arguments) */
     jint verboseDebugFlags;
@@ -71,6 +160,19 @@ typedef struct JEM_JavaVM {
 #define VERBOSE_JNI(vm) (((JEM_JavaVM *) vm)->verboseDebugFlags != 0) && \
                          ((((JEM_JavaVM *) vm)->verboseDebugFlags & 4) != 0)
 
+/* Collector safepoint states of the VM (gcSafepoint) and environments */
+#define JEM_SAFEPOINT_NONE 0
+#define JEM_SAFEPOINT_REQUESTED 1
+#define JEM_SAFEPOINT_STOPPED 2
+
+#define JEM_ENV_RUNNING 0
+#define JEM_ENV_STOPPED 1
+#define JEM_ENV_SAFE 2
+
+/* Inline test for a pending safepoint, ahead of the JEM_GCSafepoint call */
+#define JEM_SAFEPOINT_PENDING(env) \
+    (((JEM_JNIEnv *) (env))->parentVM->gcSafepoint != JEM_SAFEPOINT_NONE)
+
 /* Forward declaration of the object locking queue structure */
 typedef struct JEM_ObjLockQueueEntry JEM_ObjLockQueueEntry;
 
@@ -94,6 +196,7 @@ typedef struct JEM_JNIEnv {
     juint stateTxfrMode, stateTxfrSet;
     JEMCC_SysMonitor *objStateTxfrMonitor, *objLockMonitor;
     JEM_ObjLockQueueEntry *freeObjLockQueue;
+    juint thinLockId;
 
     /* The last exception thrown by the processing by this environment */
     JEMCC_Object *pendingException;
@@ -102,9 +205,13 @@ typedef struct JEM_JNIEnv {
     jbyte *envBuffer, *envEndPtr;
     jint envBufferLength, envBufferStringLength;
 
+    /* Reusable scratch area for transient data (e.g. inflated class data) */
+    jbyte *scratchBuffer;
+    jsize scratchBufferLength;
+
     /* CPU based information - frame stack data block and top frame instance*/
     void *frameStackBlock;
-    jsize frameStackBlockSize;
+    jsize frameStackBlockSize, frameStackLimit;
     struct JEM_VMFrameExt *topFrame;
 
     /* Return structure for non-bytecode operations (no return stack) */
@@ -112,6 +219,23 @@ typedef struct JEM_JNIEnv {
 
     /* Allocation tracking for first and last object records in this env */
     void *firstAllocObjectRecord, *lastAllocObjectRecord;
+
+    /* Thread-local allocation blocks, objects are carved by bump pointer */
+    void *allocBlockList;
+    jubyte *allocBlockPtr, *allocBlockEnd;
+
+    /* Dedicated (doubly-linked) blocks for large object records */
+    void *allocLargeList;
+
+    /* Swept heap records available for reuse, indexed by aligned size */
+    void **allocFreeLists;
+
+    /* Objects pinned for direct native access (one entry for each pin) */
+    JEMCC_Object **pinnedObjects;
+    juint pinnedCount, pinnedCapacity;
+
+    /* Collector safepoint state of this environment (see JEM_ENV_*) */
+    volatile jint gcState;
 } JEM_JNIEnv;
 
 /* The object locking structure (defined here to allow cleanup) */
@@ -337,4 +461,566 @@ JNIEXPORT JEMCC_Object *JNICALL JEMCC_EnvStringBufferToString(JNIEnv *env);
 
 /* <jemcc_end> */
 
+/**
+ * Obtain the scratch buffer associated with the environment, which is
+ * separate from the string buffer above and is used for bulk transient
+ * data (such as inflated archive entries).  The contents are only valid
+ * until the next call to this method in the same environment, so the
+ * caller must copy anything which needs to be retained.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     length - the total number of bytes which the buffer must allocate to
+ *              be available for subsequent use
+ *
+ * Returns:
+ *     Either a pointer to the beginning of the scratch buffer or NULL if
+ *     the allocation of the requested memory has failed (an OutOfMemoryError
+ *     will have been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - the memory allocation for the buffer failed
+ */
+JNIEXPORT jbyte *JNICALL JEM_EnvScratchBuffer(JNIEnv *env, jsize length);
+
+/**
+ * Release all of the thread-local object allocation blocks associated with
+ * the given environment.  This invalidates every object instance allocated
+ * through the environment (including those which have been promoted to
+ * non-local) and is only to be used when the virtual machine is destroyed.
+ *
+ * Parameters:
+ *     env - the VM environment whose allocation blocks are to be released
+ */
+JNIEXPORT void JNICALL JEM_ReleaseAllocationBlocks(JNIEnv *env);
+
+/**
+ * Perform a flush of all local object instances for the current frame
+ * (which is exiting/popping from the stack), resetting the allocation
+ * region of the frame.  Non-local (escaped) objects are promoted to the
+ * global heap list of the VM, the given return value and exception being
+ * processed (with its message and cause) are handed to the calling frame.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     retVal - the object being returned from the frame, if non-NULL
+ *     pendingException - the throwable being processed, if non-NULL
+ */
+JNIEXPORT void JNICALL JEM_FlushLocalFrameAllocations(JNIEnv *env,
+                                           JEMCC_Object *retVal,
+                                           JEMCC_Object *pendingException);
+
+/**
+ * Promote all of the object instances allocated in the current frame
+ * (which is exiting/popping from the stack) to the global heap list of the
+ * VM.  Used for native and JEMCC frames, which may retain references to
+ * their objects without marking them as non-local.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+JNIEXPORT void JNICALL JEM_PromoteLocalFrameAllocations(JNIEnv *env);
+
+/**
+ * Pin an object instance for direct access to its storage by native code
+ * (the JNI array element and critical access methods).  Pins are counted,
+ * a pinned object is a root for the garbage collector and is never released
+ * with a frame region, until every pin has been released.  Objects are
+ * never moved, so the storage address remains valid throughout.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     obj - the object instance to be pinned
+ *
+ * Returns:
+ *     JNI_OK if the object was pinned, JNI_ENOMEM if the pin table of the
+ *     environment could not be expanded (an OutOfMemoryError will have been
+ *     thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_PinObject(JNIEnv *env, JEMCC_Object *obj);
+
+/**
+ * Release a single pin of an object instance obtained through the
+ * JEM_PinObject method of the same environment.  Unmatched releases are
+ * ignored.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     obj - the object instance to be unpinned
+ */
+JNIEXPORT void JNICALL JEM_UnpinObject(JNIEnv *env, JEMCC_Object *obj);
+
+/**
+ * Perform a full (stop-the-world) garbage collection of the global heap
+ * list of the VM.  Roots are the frame stacks, local objects and pending
+ * exceptions of all environments, the static fields of the loaded classes
+ * and the intern()'ed String table.  The other (mutator) environments are
+ * first brought to a safepoint, marking is then performed in parallel by
+ * the collector worker threads and the unreachable records are reclaimed
+ * lazily by subsequent allocations.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *
+ * Returns:
+ *     JNI_OK if the collection was performed, JNI_ERR if it was deferred
+ *     (another collection is active or a thread did not reach a safepoint)
+ *     or JNI_ENOMEM if the collector could not be initialized.
+ */
+JNIEXPORT jint JNICALL JEM_CollectHeap(JNIEnv *env);
+
+/**
+ * Safepoint poll of the bytecode interpreter (made on backward branches
+ * and after callouts, when JEM_SAFEPOINT_PENDING is true).  If a collection
+ * has requested a safepoint, the current thread is stopped until the
+ * collection has completed.  The frame state of the environment must be
+ * consistent (saved) when this is called.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+JNIEXPORT void JNICALL JEM_GCSafepoint(JNIEnv *env);
+
+/**
+ * Mark the current thread as safe for a collection while it is blocked
+ * (e.g. waiting on an object monitor or for I/O) or executing a native
+ * method, where it cannot reach a safepoint poll.  No objects may be
+ * modified until the matching JEM_GCLeaveSafeRegion call, which waits for
+ * any collection in progress to complete.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+JNIEXPORT void JNICALL JEM_GCEnterSafeRegion(JNIEnv *env);
+
+/**
+ * Leave the safe region entered through JEM_GCEnterSafeRegion, blocking
+ * while a collection is in progress.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+JNIEXPORT void JNICALL JEM_GCLeaveSafeRegion(JNIEnv *env);
+
+/**
+ * Temporarily leave the safe region of a native method callout, for an
+ * operation on the object heap, collection roots or frame stack made
+ * through the JNI interfaces (e.g. an object allocation or a method call).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *
+ * Returns:
+ *     JNI_TRUE if the thread was in a safe region, in which case the caller
+ *     must re-enter it through JEM_GCEnterSafeRegion once the operation
+ *     is complete.
+ */
+JNIEXPORT jboolean JNICALL JEM_GCResumeFromSafeRegion(JNIEnv *env);
+
+/**
+ * Stop the collector worker threads and release the large object blocks
+ * which have been promoted to the global heap of the VM.  Like the release
+ * of the allocation blocks, this is only to be used when the virtual
+ * machine is destroyed.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ */
+JNIEXPORT void JNICALL JEM_ReleaseHeap(JNIEnv *env);
+
+/**
+ * Callback method to enumerate (or release) the entries of a striped table.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context (may be NULL)
+ *     entry - the table entry
+ *     userData - the caller provided information attached to the scan
+ *
+ * Returns:
+ *     JNI_OK to continue the scan, JNI_ERR to terminate it.
+ */
+typedef jint (*JEM_StripedScanCB)(JNIEnv *env, JEM_StripedEntry *entry,
+                                  void *userData);
+
+/**
+ * Initialize a striped (lock-free read) chained hashtable.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be initialized
+ *     bucketCount - the initial number of buckets (a power of two, at
+ *                   least one per stripe)
+ *
+ * Returns:
+ *     JNI_OK if the table was initialized, JNI_ENOMEM if a memory
+ *     allocation failed (an OutOfMemoryError will have been thrown in
+ *     the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_StripedTableInit(JNIEnv *env,
+                                            JEM_StripedTable *table,
+                                            juint bucketCount);
+
+/**
+ * Scan the entries of a striped table.  Only to be used when there are no
+ * concurrent inserts.  The scan callback may release the entry.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context (may be NULL)
+ *     table - the table to be scanned
+ *     scanCB - the method to call for each entry
+ *     userData - caller provided information passed to the callback
+ */
+JNIEXPORT void JNICALL JEM_StripedTableScan(JNIEnv *env,
+                                            JEM_StripedTable *table,
+                                            JEM_StripedScanCB scanCB,
+                                            void *userData);
+
+/**
+ * Release the bucket arrays and monitors of a striped table (the entries
+ * must be released by the caller, e.g. through a prior scan).
+ *
+ * Parameters:
+ *     table - the table to be destroyed
+ */
+JNIEXPORT void JNICALL JEM_StripedTableDestroy(JEM_StripedTable *table);
+
+/**
+ * Locate the entry for the given key in a striped table.  The lookup does
+ * not lock, a miss is confirmed against the current bucket array under the
+ * monitor of the stripe.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to search
+ *     key - the key to be located, passed to the key match test
+ *     hashCode - the hashcode of the key
+ *     keyEqualsFn - the key match test for the table entries
+ *     insertLock - if JNI_TRUE and the key is not found, the stripe monitor
+ *                  is retained for an insert (the caller must then call
+ *                  JEM_StripedTableInsert or JEM_StripedTableUnlock)
+ *
+ * Returns:
+ *     The matching table entry or NULL if the key is not in the table.
+ */
+JNIEXPORT JEM_StripedEntry *JNICALL JEM_StripedTableLookup(JNIEnv *env,
+                                        JEM_StripedTable *table,
+                                        const void *key, juint hashCode,
+                                        JEM_StripedKeyEqualsFn keyEqualsFn,
+                                        jboolean insertLock);
+
+/**
+ * Publish a new entry into a striped table, releasing the stripe monitor
+ * retained by the JEM_StripedTableLookup call which confirmed the miss.
+ * The bucket array is expanded when the stripe averages more than two
+ * entries per bucket (a failure to expand is ignored).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to insert into
+ *     entry - the complete new entry (the link record is initialized here)
+ *     hashCode - the hashcode of the entry key
+ */
+JNIEXPORT void JNICALL JEM_StripedTableInsert(JNIEnv *env,
+                                              JEM_StripedTable *table,
+                                              JEM_StripedEntry *entry,
+                                              juint hashCode);
+
+/**
+ * Release the stripe monitor retained by JEM_StripedTableLookup, where the
+ * insert of the new entry is abandoned.
+ *
+ * Parameters:
+ *     table - the table being inserted into
+ *     hashCode - the hashcode of the entry key
+ */
+JNIEXPORT void JNICALL JEM_StripedTableUnlock(JEM_StripedTable *table,
+                                              juint hashCode);
+
+/**
+ * Callback method to enumerate the Strings within the intern()'ed String
+ * table of the VM.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     string - the interned String instance
+ *     userData - the caller provided information attached to the scan
+ *
+ * Returns:
+ *     JNI_OK to continue the scan, JNI_ERR to terminate it.
+ */
+typedef jint (*JEM_InternScanCB)(JNIEnv *env, JEMCC_Object *string,
+                                 void *userData);
+
+/**
+ * Initialize the intern()'ed String table of a VM.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be initialized
+ *
+ * Returns:
+ *     JNI_OK if the table was initialized, JNI_ENOMEM if a memory
+ *     allocation failed (an OutOfMemoryError will have been thrown in
+ *     the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_InternTableInit(JNIEnv *env, 
+                                           JEM_InternTable *table);
+
+/**
+ * Scan the Strings of the intern()'ed String table.  Only to be used when
+ * there are no concurrent inserts (VM shutdown or collection).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be scanned
+ *     scanCB - the method to call for each interned String
+ *     userData - caller provided information passed to the callback
+ */
+JNIEXPORT void JNICALL JEM_InternTableScan(JNIEnv *env, JEM_InternTable *table,
+                                           JEM_InternScanCB scanCB,
+                                           void *userData);
+
+/**
+ * Release the internals of the intern()'ed String table.  Does not release
+ * the String instances or their character data.
+ *
+ * Parameters:
+ *     table - the table to be destroyed
+ */
+JNIEXPORT void JNICALL JEM_InternTableDestroy(JEM_InternTable *table);
+
+/**
+ * Initialize the symbol table of a VM.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     table - the table to be initialized
+ *
+ * Returns:
+ *     JNI_OK if the table was initialized, JNI_ENOMEM if a memory
+ *     allocation failed (an OutOfMemoryError will have been thrown in
+ *     the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+JNIEXPORT jint JNICALL JEM_SymbolTableInit(JNIEnv *env,
+                                           JEM_SymbolTable *table);
+
+/**
+ * Release the symbol table and all of the interned symbols and descriptors.
+ * Only to be used when the virtual machine is destroyed (once all class
+ * definitions have been released).
+ *
+ * Parameters:
+ *     table - the table to be destroyed
+ */
+JNIEXPORT void JNICALL JEM_SymbolTableDestroy(JEM_SymbolTable *table);
+
+/**
+ * Lexicographically compare the contents of two java.lang.String instances
+ * (via the attachment data structures), as defined for String.compareTo().
+ *
+ * Parameters:
+ *     strDataA, strDataB - the JEMCC_StringData structures to be compared
+ *
+ * Returns:
+ *     The difference between the first mismatched characters or, if one
+ *     string is a prefix of the other, the difference in lengths (zero if
+ *     the strings are equal).
+ */
+JNIEXPORT jint JNICALL JEM_StringCompare(JEMCC_StringData *strDataA,
+                                         JEMCC_StringData *strDataB);
+
+/*
+ * String character kernels (see core/string.c), using SSE2 operations where
+ * the processor supports them.  The 8-bit forms operate on the negative length (ASCII/Latin-1)
+ * String storage and the 16-bit forms on the Unicode storage.
+ */
+
+/**
+ * Locate the first character in the Unicode text which cannot be stored in
+ * the 8-bit String format (either '\0' or greater than 255).
+ *
+ * Parameters:
+ *     str - the Unicode text to scan
+ *     len - the number of Unicode characters in the text
+ *
+ * Returns:
+ *     The index of the first non 8-bit character, or len if all of the
+ *     characters are 8-bit.
+ */
+JNIEXPORT jsize JNICALL JEM_StrFindWideChar(const jchar *str, jsize len);
+
+/**
+ * Locate the first occurrence of the given character in the Unicode text
+ * (the 16-bit equivalent of memchr()).
+ *
+ * Parameters:
+ *     str - the Unicode text to scan
+ *     len - the number of Unicode characters in the text
+ *     ch - the character to search for
+ *
+ * Returns:
+ *     The index of the first matching character, or -1 if not found.
+ */
+JNIEXPORT jsize JNICALL JEM_StrScanChar(const jchar *str, jsize len,
+                                        jchar ch);
+
+/**
+ * Determine the index of the first differing character between two Unicode
+ * texts of equal length.
+ *
+ * Parameters:
+ *     stra, strb - the Unicode texts to compare
+ *     len - the number of Unicode characters to compare
+ *
+ * Returns:
+ *     The index of the first mismatched character, or len if the texts are
+ *     identical.
+ */
+JNIEXPORT jsize JNICALL JEM_StrMismatchChars(const jchar *stra,
+                                             const jchar *strb, jsize len);
+
+/**
+ * Determine the index of the first differing character between two 8-bit
+ * texts of equal length.
+ *
+ * Parameters:
+ *     stra, strb - the 8-bit texts to compare
+ *     len - the number of characters to compare
+ *
+ * Returns:
+ *     The index of the first mismatched character, or len if the texts are
+ *     identical.
+ */
+JNIEXPORT jsize JNICALL JEM_StrMismatchBytes(const jubyte *stra,
+                                             const jubyte *strb, jsize len);
+
+/**
+ * Expand 8-bit String characters into the Unicode (16-bit) equivalent.
+ *
+ * Parameters:
+ *     dst - the Unicode buffer to write the expanded characters into
+ *     src - the 8-bit characters to be expanded
+ *     len - the number of characters to expand
+ */
+JNIEXPORT void JNICALL JEM_StrWiden(jchar *dst, const jubyte *src, jsize len);
+
+/**
+ * Reduce Unicode characters into the 8-bit String format.  The caller must
+ * ensure that all of the characters fit (see JEM_StrFindWideChar).  The
+ * reduction may be performed in place (dst the same memory as src).
+ *
+ * Parameters:
+ *     dst - the buffer to write the 8-bit characters into
+ *     src - the Unicode characters to be reduced
+ *     len - the number of characters to reduce
+ */
+JNIEXPORT void JNICALL JEM_StrNarrow(jubyte *dst, const jchar *src, jsize len);
+
+/**
+ * Determine the length of the run of plain ASCII characters (1-127, which
+ * are encoded as single bytes in modified UTF-8) at the start of the given
+ * byte sequence.
+ *
+ * Parameters:
+ *     utf - the modified UTF-8 (or 8-bit String) data to scan
+ *     len - the number of bytes to scan
+ *
+ * Returns:
+ *     The number of leading single byte characters, len if all are ASCII.
+ */
+JNIEXPORT jsize JNICALL JEM_UTFAsciiRun(const jubyte *utf, jsize len);
+
+/**
+ * Determine the length of the run of plain ASCII characters (1-127) at the
+ * start of the given Unicode text.
+ *
+ * Parameters:
+ *     str - the Unicode text to scan
+ *     len - the number of Unicode characters to scan
+ *
+ * Returns:
+ *     The number of leading ASCII characters, len if all are ASCII.
+ */
+JNIEXPORT jsize JNICALL JEM_UTFAsciiRunChars(const jchar *str, jsize len);
+
+/**
+ * Scan (validate) a modified UTF-8 encoded byte sequence, determining the
+ * number of characters it contains and whether they can all be stored in
+ * the compact 8-bit String format.  Scanning stops at the first malformed
+ * sequence (including '\0' bytes and the four byte forms, which do not
+ * appear in modified UTF-8).  Runs of ASCII are skipped a block at a time.
+ *
+ * Parameters:
+ *     utf - the modified UTF-8 data to scan
+ *     byteLen - the number of bytes in the data
+ *     validLen - if non-NULL, returns the number of bytes in the valid
+ *                prefix of the data (byteLen if the data is well formed)
+ *     isCompact - if non-NULL, returns JNI_TRUE if all of the characters in
+ *                 the valid prefix are 8-bit (neither '\0' nor above 255)
+ *
+ * Returns:
+ *     The number of characters in the valid prefix of the data.
+ */
+JNIEXPORT jint JNICALL JEM_UTFScan(const jubyte *utf, jsize byteLen,
+                                   jsize *validLen, jboolean *isCompact);
+
+/**
+ * Decode a well-formed modified UTF-8 byte sequence (as determined by
+ * JEM_UTFScan) into either the compact 8-bit or the Unicode String format.
+ * ASCII runs are copied or widened a block at a time.
+ *
+ * Parameters:
+ *     utf - the modified UTF-8 data to decode
+ *     byteLen - the number of bytes to decode (the valid length from the
+ *               scan)
+ *     buffer - the String data buffer to decode into (jubyte or jchar
+ *              elements according to the compact flag), which must have
+ *              space for the scanned number of characters
+ *     compact - if JNI_TRUE, decode into 8-bit characters (the scan must
+ *               have indicated that the characters are compact), otherwise
+ *               into Unicode characters
+ *
+ * Returns:
+ *     The number of characters decoded.
+ */
+JNIEXPORT jint JNICALL JEM_UTFDecode(const jubyte *utf, jsize byteLen,
+                                     void *buffer, jboolean compact);
+
+/**
+ * Determine the number of bytes required to encode the contents of a
+ * java.lang.String in modified UTF-8 (excluding the '\0' terminator).
+ *
+ * Parameters:
+ *     strData - the JEMCC_StringData structure containing the String data
+ *
+ * Returns:
+ *     The number of bytes in the modified UTF-8 encoding.
+ */
+JNIEXPORT jsize JNICALL JEM_UTFEncodedLength(JEMCC_StringData *strData);
+
+/**
+ * Encode the contents of a java.lang.String in modified UTF-8.  Runs of
+ * ASCII characters are copied (or narrowed) a block at a time.
+ *
+ * Parameters:
+ *     strData - the JEMCC_StringData structure containing the String data
+ *     buffer - the buffer to write the encoded data into, which must have
+ *              space for the encoded length (see JEM_UTFEncodedLength)
+ *              plus the '\0' terminator
+ */
+JNIEXPORT void JNICALL JEM_UTFEncode(JEMCC_StringData *strData,
+                                     char *buffer);
+
 #endif
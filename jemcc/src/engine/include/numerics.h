@@ -58,7 +58,8 @@ JNIEXPORT void JNICALL JEMCC_LongToText(jlong val, jint radix, char *buff);
  *
  * Parameters:
  *    val - the value to be converted to text
- *    buff - the character buffer to write into
+ *    buff - the character buffer to write into (at most 16 characters are
+ *           written, including the terminator)
  */
 JNIEXPORT void JNICALL JEMCC_FloatToText(jfloat val, char *buff);
 
@@ -69,10 +70,45 @@ JNIEXPORT void JNICALL JEMCC_FloatToText(jfloat val, char *buff);
  *
  * Parameters:
  *    val - the value to be converted to text
- *    buff - the character buffer to write into
+ *    buff - the character buffer to write into (at most 25 characters are
+ *           written, including the terminator)
  */
 JNIEXPORT void JNICALL JEMCC_DoubleToText(jdouble val, char *buff);
 
+/**
+ * Convert the text representation of a floating point number into a float
+ * value.  Accepts the same textual forms as the Float.valueOf(String)
+ * method (including the hexadecimal form) and produces the same correctly
+ * rounded result, independent of the C library and process locale.
+ *
+ * Parameters:
+ *    text - the (NUL terminated) text to be converted
+ *    val - pointer through which the converted value is returned
+ *
+ * Returns:
+ *    JNI_OK - the text was successfully converted
+ *    JNI_ERR - the text is not a valid floating point number (a
+ *              NumberFormatException condition)
+ */
+JNIEXPORT jint JNICALL JEMCC_TextToFloat(const char *text, jfloat *val);
+
+/**
+ * Convert the text representation of a floating point number into a double
+ * value.  Accepts the same textual forms as the Double.valueOf(String)
+ * method (including the hexadecimal form) and produces the same correctly
+ * rounded result, independent of the C library and process locale.
+ *
+ * Parameters:
+ *    text - the (NUL terminated) text to be converted
+ *    val - pointer through which the converted value is returned
+ *
+ * Returns:
+ *    JNI_OK - the text was successfully converted
+ *    JNI_ERR - the text is not a valid floating point number (a
+ *              NumberFormatException condition)
+ */
+JNIEXPORT jint JNICALL JEMCC_TextToDouble(const char *text, jdouble *val);
+
 /* <jemcc_end> */
 
 #endif
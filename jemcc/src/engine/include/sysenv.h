@@ -354,6 +354,101 @@ JNIEXPORT void JNICALL JEMCC_ReleaseZipFileEntry(JNIEnv *env,
                                                  JEMCC_ZipFile *zipFile,
                                                  JEMCC_ZipFileEntry *zipEntry);
 
+/**
+ * Callback method to enumerate the entries of a directory within a Zip
+ * file.  The provided entry is released when the callback returns (the
+ * entry contents may be read or streamed during the callback).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance which is being scanned
+ *     zipEntry - the currently scanned entry of the directory
+ *     userData - the caller provided information attached to the scan
+ *                request
+ *
+ * Returns:
+ *     JNI_OK - continue with scanning of the directory
+ *     JNI_ERR - terminate scanning of the directory
+ */
+typedef jint (*JEMCC_ZipEntryScanCB)(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                                     JEMCC_ZipFileEntry *zipEntry,
+                                     void *userData);
+
+/**
+ * Scan the entries which are contained within a specific directory of an
+ * open Zip/Jar file (not including the entries of subdirectories).  Uses
+ * a directory index, so the cost is proportional to the number of entries
+ * in the directory and not the size of the archive (supports resource
+ * and package enumeration).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance to be scanned
+ *     dirName - the name of the directory to scan, including the trailing
+ *               separator (e.g. "java/lang/"), or "" for the root directory
+ *     entryCB - a function reference which is called for each entry in the
+ *               directory
+ *     userData - a caller provided data set which is included in the
+ *                scan arguments
+ *     quietMode - if JNI_TRUE, no exceptions other than OutOfMemory will
+ *                 be thrown (used for classloaders, etc.)
+ *
+ * Returns:
+ *     JNI_OK - the directory was found and the entries were scanned
+ *     JNI_ERR - an error occurred reading/parsing the Zip file directory
+ *               (an exception will have been thrown in the current
+ *               environment if quietMode is false)
+ *     JNI_ENOMEM - an memory allocation failed and an OutOfMemoryError has
+ *                  been thrown in the current environment
+ *     JNI_EINVAL - no entries exist in the requested directory
+ *
+ * Exceptions
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     OutOfMemoryError - a memory allocation for the file structures failed
+ */
+JNIEXPORT jint JNICALL JEMCC_ScanZipFileDirectory(JNIEnv *env,
+                                                  JEMCC_ZipFile *zipFile,
+                                                  const char *dirName,
+                                                  JEMCC_ZipEntryScanCB entryCB,
+                                                  void *userData,
+                                                  jboolean quietMode);
+
+/**
+ * Scan all of the entries of an open Zip/Jar file, in archive order
+ * (including directory entries, if present in the archive).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance to be scanned
+ *     entryCB - a function reference which is called for each entry in the
+ *               archive
+ *     userData - a caller provided data set which is included in the
+ *                scan arguments
+ *     quietMode - if JNI_TRUE, no exceptions other than OutOfMemory will
+ *                 be thrown (used for classloaders, etc.)
+ *
+ * Returns:
+ *     JNI_OK - the entries were scanned (or the callback terminated the scan)
+ *     JNI_ERR - an error occurred reading/parsing the Zip file directory
+ *               (an exception will have been thrown in the current
+ *               environment if quietMode is false)
+ *     JNI_ENOMEM - an memory allocation failed and an OutOfMemoryError has
+ *                  been thrown in the current environment
+ *
+ * Exceptions
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     OutOfMemoryError - a memory allocation for the file structures failed
+ */
+JNIEXPORT jint JNICALL JEMCC_ScanZipFileEntries(JNIEnv *env,
+                                                JEMCC_ZipFile *zipFile,
+                                                JEMCC_ZipEntryScanCB entryCB,
+                                                void *userData,
+                                                jboolean quietMode);
+
 /**
  * Load the contents of a Zip file entry (fully inflated if required).
  * NOTE: this method does not allow for exception suppression - if a Zip
@@ -556,6 +651,17 @@ JNIEXPORT void JNICALL JEMCC_YieldCurrentThread();
  */
 JNIEXPORT void JNICALL JEMCC_YieldCurrentThreadAndSleep(jlong nano);
 
+/**
+ * Sleep the current thread for a given period (e.g. for the Thread.sleep()
+ * implementation).  Unlike the yield method above, the VM environment of
+ * the thread is marked as safe for garbage collection while it sleeps.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     nano - the number of nanoseconds to sleep for
+ */
+JNIEXPORT void JNICALL JEMCC_SleepCurrentThread(JNIEnv *env, jlong nano);
+
 /**
  * Yield control of the current thread based on activity on the given
  * file descriptor index, allowing other threads waiting on the processor
@@ -571,6 +677,39 @@ JNIEXPORT void JNICALL JEMCC_YieldCurrentThreadAgainstFd(int fd);
 
 /* <jemcc_end> */
 
+/**
+ * Obtain the contents of a Zip file entry without allocating a copy for
+ * the caller.  Stored (uncompressed) entries of a mapped Zip file are
+ * returned directly from the mapped region, and remain valid until the
+ * Zip file is closed.  All other entries are inflated/read into the
+ * scratch buffer of the environment, which is only valid until the next
+ * use of that buffer (the caller must copy anything to be retained).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance from which the entry originated
+ *     zipEntry - the Zip/Jar file entry to read the contents of
+ *     isMapped - a reference through which JNI_TRUE is returned if the
+ *                contents are in the persistent mapped region, JNI_FALSE
+ *                if in the environment scratch buffer
+ *
+ * Returns:
+ *     The data contents of the requested entry (not to be freed or
+ *     modified by the caller) or NULL if a typing/inflation error
+ *     occurred (an exception will be thrown in the current environment).
+ *
+ * Exceptions:
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     InternalError - an unexpected zlib library error occurred
+ *     OutOfMemoryError - a memory allocation for the scratch buffer failed
+ */
+JNIEXPORT jbyte *JNICALL JEM_MapZipFileEntry(JNIEnv *env,
+                                             JEMCC_ZipFile *zipFile,
+                                             JEMCC_ZipFileEntry *zipEntry,
+                                             jboolean *isMapped);
+
 /**
  * Associate the given data object with the current thread in context.
  * This is typically used to attach the JNIEnv instance to the thread
@@ -1007,6 +1146,33 @@ JNIEXPORT jint JNICALL JEMCC_ObjMonitorNotifyAll(JNIEnv *env, jobject obj);
 
 /* <jemcc_end> */
 
+/**
+ * Atomically exchange the pointer value stored at the given address.  The
+ * exchange is a full memory barrier, so that all stores made by the calling
+ * thread prior to the exchange are visible to any thread which reads the
+ * new value.  Used to publish structures which are read without locking
+ * (such as the intern()'ed String table).
+ *
+ * Parameters:
+ *     targAddr - the address of the pointer value to be replaced
+ *     newVal - the pointer value to store
+ *
+ * Returns:
+ *     The pointer value which was stored at the address prior to the
+ *     exchange.
+ */
+JNIEXPORT void *JNICALL JEM_AtomicSwapPointer(void **targAddr, void *newVal);
+
+/**
+ * Release the thin object lock id assigned to an environment (on its first
+ * object monitor entry), allowing the id to be reused.  Called when the
+ * environment is destroyed, it must not hold any object monitors.
+ *
+ * Parameters:
+ *     env - the VM environment which is being destroyed
+ */
+JNIEXPORT void JNICALL JEM_ReleaseThinLockId(JNIEnv *env);
+
 /******************* Dynamic Library Management **********************/
 
 /*
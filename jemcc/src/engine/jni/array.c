@@ -205,10 +205,16 @@ jobject JEMCC_GetObjectArrayElement(JNIEnv *env, jobjectArray array,
 void JEMCC_SetObjectArrayElement(JNIEnv *env, jobjectArray array, jsize index, 
                                  jobject val) {
     JEMCC_ArrayObject *arrayObj = (JEMCC_ArrayObject *) array;
+    jboolean inSafeRegion;
 
     if (JEMCC_CheckArrayLimits(env, arrayObj, index, -1) != JNI_OK) return;
     /* TODO - validate proper assignment details */
+
+    /* Reference stores are not made during a collection (mark tracing) */
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
+    JEMCC_MarkNonLocalObject(env, (JEMCC_Object *) val);
     *(((JEMCC_Object **) arrayObj->arrayData) + index) = (JEMCC_Object *) val;
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
 }
 
 jbooleanArray JEMCC_NewBooleanArray(JNIEnv *env, jsize len) {
@@ -307,162 +313,269 @@ jdoubleArray JEMCC_NewDoubleArray(JNIEnv *env, jsize len) {
     return (jdoubleArray) retArray;
 }
 
+/**
+ * Common method to obtain direct access to the elements of a primitive
+ * array.  Array storage is never moved by the collector, so the elements
+ * are returned in place (never a copy) and the array is pinned until the
+ * matching release.
+ */
+static void *JEM_PinArrayElements(JNIEnv *env, jarray array,
+                                  jboolean *isCopy) {
+    JEMCC_ArrayObject *arrayObj = (JEMCC_ArrayObject *) array;
+
+    if (JEM_PinObject(env, (JEMCC_Object *) arrayObj) != JNI_OK) return NULL;
+    if (isCopy != NULL) *isCopy = JNI_FALSE;
+
+    /* Empty arrays have no storage, but NULL would indicate failure */
+    if (arrayObj->arrayData == NULL) return (void *) (arrayObj + 1);
+    return arrayObj->arrayData;
+}
+
+/**
+ * Common method to release the elements obtained through the method above.
+ * The elements are the array storage itself, so there is nothing to copy
+ * back (or discard for JNI_ABORT).  JNI_COMMIT retains the pin, as the
+ * elements remain in use.
+ */
+static void JEM_UnpinArrayElements(JNIEnv *env, jarray array, jint mode) {
+    if (mode == JNI_COMMIT) return;
+    JEM_UnpinObject(env, (JEMCC_Object *) array);
+}
+
+/**
+ * Common method to copy a region of a primitive array to or from a native
+ * buffer, throwing an ArrayIndexOutOfBoundsException (and copying nothing)
+ * if the region is not within the array.
+ */
+static void JEM_CopyArrayRegion(JNIEnv *env, jarray array, jsize start,
+                                jsize len, void *buff, juint elementSize,
+                                jboolean store) {
+    JEMCC_ArrayObject *arrayObj = (JEMCC_ArrayObject *) array;
+    jbyte *elements;
+
+    if (JEMCC_CheckArrayRegion(env, arrayObj, start, len, -1) != JNI_OK) {
+        return;
+    }
+    if (len == 0) return;
+
+    elements = ((jbyte *) arrayObj->arrayData) + start * elementSize;
+    if (store != JNI_FALSE) {
+        (void) memcpy(elements, buff, len * elementSize);
+    } else {
+        (void) memcpy(buff, elements, len * elementSize);
+    }
+}
+
 jboolean *JEMCC_GetBooleanArrayElements(JNIEnv *env, jbooleanArray array,
                                         jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jboolean *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
-jbyte *JEMCC_GetByteArrayElements(JNIEnv *env, jbyteArray array, 
+jbyte *JEMCC_GetByteArrayElements(JNIEnv *env, jbyteArray array,
                                   jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jbyte *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
-jchar *JEMCC_GetCharArrayElements(JNIEnv *env, jcharArray array, 
+jchar *JEMCC_GetCharArrayElements(JNIEnv *env, jcharArray array,
                                   jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jchar *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
-jshort *JEMCC_GetShortArrayElements(JNIEnv *env, jshortArray array, 
+jshort *JEMCC_GetShortArrayElements(JNIEnv *env, jshortArray array,
                                     jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jshort *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
-jint *JEMCC_GetIntArrayElements(JNIEnv *env, jintArray array, 
+jint *JEMCC_GetIntArrayElements(JNIEnv *env, jintArray array,
                                 jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jint *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
-jlong *JEMCC_GetLongArrayElements(JNIEnv *env, jlongArray array, 
+jlong *JEMCC_GetLongArrayElements(JNIEnv *env, jlongArray array,
                                   jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jlong *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
 jfloat *JEMCC_GetFloatArrayElements(JNIEnv *env, jfloatArray array,
                                     jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jfloat *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
 jdouble *JEMCC_GetDoubleArrayElements(JNIEnv *env, jdoubleArray array,
                                       jboolean *isCopy) {
-    return NULL; /* TODO */
+    return (jdouble *) JEM_PinArrayElements(env, (jarray) array, isCopy);
 }
 
 void JEMCC_ReleaseBooleanArrayElements(JNIEnv *env, jbooleanArray array,
                                        jboolean *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseByteArrayElements(JNIEnv *env, jbyteArray array,
                                     jbyte *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseCharArrayElements(JNIEnv *env, jcharArray array,
                                     jchar *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseShortArrayElements(JNIEnv *env, jshortArray array,
                                      jshort *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseIntArrayElements(JNIEnv *env, jintArray array,
                                    jint *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseLongArrayElements(JNIEnv *env, jlongArray array,
                                     jlong *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseFloatArrayElements(JNIEnv *env, jfloatArray array,
                                      jfloat *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_ReleaseDoubleArrayElements(JNIEnv *env, jdoubleArray array,
                                       jdouble *elems, jint mode) {
-    /* TODO */
+    JEM_UnpinArrayElements(env, (jarray) array, mode);
 }
 
 void JEMCC_GetBooleanArrayRegion(JNIEnv *env, jbooleanArray array,
                                  jsize start, jsize len, jboolean *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jboolean), JNI_FALSE);
 }
 
 void JEMCC_GetByteArrayRegion(JNIEnv *env, jbyteArray array,
                               jsize start, jsize len, jbyte *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jbyte), JNI_FALSE);
 }
 
 void JEMCC_GetCharArrayRegion(JNIEnv *env, jcharArray array,
                               jsize start, jsize len, jchar *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jchar), JNI_FALSE);
 }
 
 void JEMCC_GetShortArrayRegion(JNIEnv *env, jshortArray array,
                                jsize start, jsize len, jshort *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jshort), JNI_FALSE);
 }
 
 void JEMCC_GetIntArrayRegion(JNIEnv *env, jintArray array,
                              jsize start, jsize len, jint *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jint), JNI_FALSE);
 }
 
 void JEMCC_GetLongArrayRegion(JNIEnv *env, jlongArray array,
                               jsize start, jsize len, jlong *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jlong), JNI_FALSE);
 }
 
 void JEMCC_GetFloatArrayRegion(JNIEnv *env, jfloatArray array,
                                jsize start, jsize len, jfloat *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jfloat), JNI_FALSE);
 }
 
 void JEMCC_GetDoubleArrayRegion(JNIEnv *env, jdoubleArray array,
                                 jsize start, jsize len, jdouble *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jdouble), JNI_FALSE);
 }
 
 void JEMCC_SetBooleanArrayRegion(JNIEnv *env, jbooleanArray array,
                                  jsize start, jsize len, jboolean *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jboolean), JNI_TRUE);
 }
 
 void JEMCC_SetByteArrayRegion(JNIEnv *env, jbyteArray array,
                               jsize start, jsize len, jbyte *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jbyte), JNI_TRUE);
 }
 
 void JEMCC_SetCharArrayRegion(JNIEnv *env, jcharArray array,
                               jsize start, jsize len, jchar *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jchar), JNI_TRUE);
 }
 
 void JEMCC_SetShortArrayRegion(JNIEnv *env, jshortArray array,
                                jsize start, jsize len, jshort *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jshort), JNI_TRUE);
 }
 
 void JEMCC_SetIntArrayRegion(JNIEnv *env, jintArray array,
                              jsize start, jsize len, jint *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jint), JNI_TRUE);
 }
 
 void JEMCC_SetLongArrayRegion(JNIEnv *env, jlongArray array,
                               jsize start, jsize len, jlong *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jlong), JNI_TRUE);
 }
 
 void JEMCC_SetFloatArrayRegion(JNIEnv *env, jfloatArray array,
                                jsize start, jsize len, jfloat *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jfloat), JNI_TRUE);
 }
 
 void JEMCC_SetDoubleArrayRegion(JNIEnv *env, jdoubleArray array,
                                 jsize start, jsize len, jdouble *buff) {
-    /* TODO */
+    JEM_CopyArrayRegion(env, (jarray) array, start, len, buff,
+                        sizeof(jdouble), JNI_TRUE);
+}
+
+/**
+ * Obtain direct access to the elements of a primitive array, for a short
+ * (non-blocking) native operation.  This is the equivalent of the JNI 1.2
+ * GetPrimitiveArrayCritical method, which is not part of the JNI 1.1
+ * function table.  As for the Get<Type>ArrayElements methods, the array
+ * storage is returned in place and pinned until released.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     array - the primitive array instance to access
+ *     isCopy - if non-NULL, set to JNI_FALSE (the elements are never copied)
+ *
+ * Returns:
+ *     The array storage, or NULL if the array could not be pinned (an
+ *     OutOfMemoryError will have been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+void *JEMCC_GetPrimitiveArrayCritical(JNIEnv *env, jarray array,
+                                      jboolean *isCopy) {
+    return JEM_PinArrayElements(env, array, isCopy);
+}
+
+/**
+ * Release the array storage obtained through GetPrimitiveArrayCritical.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     array - the primitive array instance being accessed
+ *     carray - the array storage returned by GetPrimitiveArrayCritical
+ *     mode - the JNI release mode (0, JNI_COMMIT or JNI_ABORT)
+ */
+void JEMCC_ReleasePrimitiveArrayCritical(JNIEnv *env, jarray array,
+                                         void *carray, jint mode) {
+    JEM_UnpinArrayElements(env, array, mode);
 }
@@ -32,7 +32,7 @@ jclass JEMCC_DefineClass(JNIEnv *env, jobject loader, const jbyte *buff,
     JEM_ParsedClassData *classData;
     JEMCC_Class *classInstance;
 
-    classData = JEM_ParseClassData(env, buff, buffLen);
+    classData = JEM_ParseClassData(env, buff, buffLen, JNI_FALSE);
     if (classData == NULL) return NULL;
     classInstance = JEM_DefineAndResolveClass(env, loader, classData);
     return (jclass) classInstance;
@@ -64,21 +64,7 @@ jclass JEMCC_GetSuperclass(JNIEnv *env, jclass clazz) {
 }
 
 jboolean JEMCC_IsAssignableFrom(JNIEnv *env, jclass clazza, jclass clazzb) {
-    JEM_ClassData *classData = ((JEMCC_Class *) clazza)->classData;
-    JEMCC_Class **compClassPtr;
-
-    /* TODO Catch the array comparison case! */
-
-    /* Are they the same class, i.e. same pointer in this context */
-    if (clazza == clazzb) return JNI_TRUE;
-
-    /* Is clazzb a superclass or interface of clazza */
-    compClassPtr = classData->assignList;
-    while (*compClassPtr != NULL) {
-        if (*compClassPtr == (JEMCC_Class *) clazzb) return JNI_TRUE;
-        compClassPtr++;
-    }
-
-    /* All tests have failed */
-    return JNI_FALSE;
+    /* Is clazzb the same class, a supertype or a covariant array type */
+    return JEM_IsAssignableClass((JEMCC_Class *) clazza,
+                                 (JEMCC_Class *) clazzb);
 }
@@ -27,9 +27,52 @@
 #include "jem.h"
 #include "jnifunc.h"
 
+/**
+ * Common method to locate a field for the Get[Static]FieldID methods,
+ * throwing NoSuchFieldError if the field is undefined or the static
+ * nature of the field does not match the request.
+ */
+static JEM_ClassFieldData *JEM_LocateJNIField(JNIEnv *env, jclass clazz,
+                                              const char *name,
+                                              const char *sig,
+                                              jboolean isStatic) {
+    JEM_ClassData *classData = ((JEMCC_Class *) clazz)->classData;
+    JEM_ClassFieldData *fieldData = NULL;
+    char *nameSym, *sigSym;
+
+    /* Initialize the class first (JNI spec), aborting on init failure */
+    if (JEMCC_InitializeClass(env, (JEMCC_Class *) clazz) != JNI_OK) {
+        return NULL;
+    }
+
+    /* Retrieve the class field by interned symbols */
+    nameSym = JEM_LookupSymbol(env, name);
+    sigSym = JEM_LookupSymbol(env, sig);
+    if ((nameSym != NULL) && (sigSym != NULL)) {
+        fieldData = JEM_LocateClassField(classData, nameSym, sigSym);
+    }
+    if (fieldData == NULL) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NoSuchFieldError, 
+                                   NULL, name);
+        return NULL;
+    }
+
+    /* Confirm the static nature of the field */
+    if (((fieldData->accessFlags & ACC_STATIC) != 0) != (isStatic != 0)) {
+        JEMCC_ThrowStdThrowableIdxV(env, JEMCC_Class_NoSuchFieldError, NULL,
+                                    ((isStatic != 0) ?
+                                        "JNI: Requested field is not static" :
+                                        "JNI: Requested field is static"),
+                                    name, NULL);
+        return NULL;
+    }
+
+    return fieldData;
+}
+
 jfieldID JEMCC_GetFieldID(JNIEnv *env, jclass clazz, const char *name, 
                           const char *sig) {
-    return NULL; /* TODO */
+    return (jfieldID) JEM_LocateJNIField(env, clazz, name, sig, JNI_FALSE);
 }
 
 jobject JEMCC_GetObjectField(JNIEnv *env, jobject obj, jfieldID fieldID) {
@@ -109,9 +152,13 @@ void JEMCC_SetObjectField(JNIEnv *env, jobject obj, jfieldID fieldID,
     JEM_ClassFieldData *fieldRef = (JEM_ClassFieldData *) fieldID;
     jbyte *basePtr = ((jbyte *) &(((JEMCC_ObjectExt *) obj)->objectData)) +
                                                          fieldRef->fieldOffset;
+    jboolean inSafeRegion;
 
+    /* Reference stores are not made during a collection (mark tracing) */
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
     JEMCC_MarkNonLocalObject(env, (JEMCC_Object *) val);
     *((JEMCC_Object **) basePtr) = (JEMCC_Object *) val;
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
 }
 
 void JEMCC_SetBooleanField(JNIEnv *env, jobject obj, jfieldID fieldID, 
@@ -188,7 +235,7 @@ void JEMCC_SetDoubleField(JNIEnv *env, jobject obj, jfieldID fieldID,
 
 jfieldID JEMCC_GetStaticFieldID(JNIEnv *env, jclass clazz, const char *name, 
                                 const char *sig) {
-    return NULL; /* TODO */
+    return (jfieldID) JEM_LocateJNIField(env, clazz, name, sig, JNI_TRUE);
 }
 
 jobject JEMCC_GetStaticObjectField(JNIEnv *env, jclass clazz, 
@@ -270,10 +317,15 @@ void JEMCC_SetStaticObjectField(JNIEnv *env, jclass clazz, jfieldID fieldID,
                                 jobject val) {
     JEM_ClassFieldData *fieldRef = (JEM_ClassFieldData *) fieldID;
     jbyte *staticData = (jbyte *) ((JEMCC_Class *) clazz)->staticData;
+    jboolean inSafeRegion;
 
+    /* Reference stores are not made during a collection (mark tracing) */
+    inSafeRegion = JEM_GCResumeFromSafeRegion(env);
     (void) JEMCC_InitializeClass(env, (JEMCC_Class *) clazz);
+    JEMCC_MarkNonLocalObject(env, (JEMCC_Object *) val);
     *((JEMCC_Object **) (staticData + fieldRef->fieldOffset)) =
                                                      (JEMCC_Object *) val;
+    if (inSafeRegion) JEM_GCEnterSafeRegion(env);
 }
 
 void JEMCC_SetStaticBooleanField(JNIEnv *env, jclass clazz, jfieldID fieldID, 
@@ -58,13 +58,31 @@ static jint JEM_DestroyJavaVM(JavaVM *vm) {
     /* All finished the linkage destruction, release the monitor */
     JEMCC_ExitGlobalMonitor();
 
-    /* Destroy any environments assigned to the VM */
+    /* Write the recorded class data archive (if enabled) */
+    if (jvm->envList != NULL) {
+        (void) JEM_WriteClassArchive((JNIEnv *) jvm->envList);
+    }
+
+    /* Stop the collector and release the heap (before the environments) */
+    if (jvm->envList != NULL) {
+        JEM_ReleaseHeap((JNIEnv *) jvm->envList);
+
+        /* Class data referencing the archive is gone, release it as well */
+        JEM_CloseClassArchive((JNIEnv *) jvm->envList);
+    }
+
+    /* Destroy any environments assigned to the VM (and their objects) */
     while (jvm->envList != NULL) {
+        JEM_ReleaseAllocationBlocks((JNIEnv *) jvm->envList);
         JEM_DestroyJNIEnv(jvm->envList);
     }
 
-    /* No longer need the virtual machine environment monitor */
+    /* Classes are all released, the member symbols can now be discarded */
+    JEM_SymbolTableDestroy(&(jvm->symbolTable));
+
+    /* No longer need the virtual machine environment/safepoint monitors */
     JEMCC_DestroySysMonitor(jvm->monitor);
+    JEMCC_DestroySysMonitor(jvm->safepointMonitor);
 
     /* Free the associated memory */
     /* TODO - lots of other stuff too! */
@@ -241,7 +259,7 @@ jint JNI_GetDefaultJavaVMInitArgs(void *args) {
             args11->checkSource = 0; /* Ignored */
             args11->nativeStackSize = 0; /* Ignored */
             args11->javaStackSize = 0; /* Ignored */
-            args11->minHeapSize = 0; /* Ignored */
+            args11->minHeapSize = 0; /* Default collection threshold */
             args11->maxHeapSize = 0; /* Ignored */
             args11->verifyMode = 0; /* Ignored */
             args11->classpath = "."; 
@@ -260,11 +278,29 @@ jint JNI_GetDefaultJavaVMInitArgs(void *args) {
     return JNI_OK;
 }
 
+/*
+ * Locate the value of a VM property (in name=value form) in the
+ * initialization property set, returning NULL if the property is not given.
+ */
+static char *JEM_GetInitProperty(char **properties, const char *name) {
+    int len = strlen(name);
+
+    if (properties == NULL) return NULL;
+    while (*properties != NULL) {
+        if ((strncmp(*properties, name, len) == 0) &&
+                ((*properties)[len] == '=')) return *properties + len + 1;
+        properties++;
+    }
+
+    return NULL;
+}
+
 /* Create a new instance of a Java virtual machine */
 jint JNI_CreateJavaVM(JavaVM **pVm, JNIEnv **pEnv, void *args) {
     JEM_JavaVM *jvm;
     JEM_JNIEnv *jenv;
     JDK1_1InitArgs *jvmArgs11 = (JDK1_1InitArgs *) args;
+    char *preloadList, *preloadWorkers, *archiveFile;
     jbyte *pkgFileData;
     jsize pkgFileLen;
     jint rc;
@@ -288,6 +324,14 @@ jint JNI_CreateJavaVM(JavaVM **pVm, JNIEnv **pEnv, void *args) {
         return JNI_ENOMEM;
     }
 
+    /* And the monitor for the collection safepoint handshake */
+    jvm->safepointMonitor = JEMCC_CreateSysMonitor(NULL);
+    if (jvm->safepointMonitor == NULL) {
+        JEMCC_DestroySysMonitor(jvm->monitor);
+        JEMCC_Free(jvm);
+        return JNI_ENOMEM;
+    }
+
     /* Create the basic VM environment record */
     jenv = JEM_CreateJNIEnv(jvm);
     if (jenv == NULL) {
@@ -305,8 +349,16 @@ jint JNI_CreateJavaVM(JavaVM **pVm, JNIEnv **pEnv, void *args) {
     }
 
     /* Initialize the internal string table */
-    if (JEMCC_HashInitTable((JNIEnv *) jenv, 
-                            &(jvm->internStringTable), 32) != JNI_OK) {
+    if (JEM_InternTableInit((JNIEnv *) jenv,
+                            &(jvm->internStringTable)) != JNI_OK) {
+        /* TODO - destroy monitor, environment */
+        JEMCC_Free(jvm);
+        return JNI_ENOMEM;
+    }
+
+    /* Initialize the member name/descriptor symbol table */
+    if (JEM_SymbolTableInit((JNIEnv *) jenv,
+                            &(jvm->symbolTable)) != JNI_OK) {
         /* TODO - destroy monitor, environment */
         JEMCC_Free(jvm);
         return JNI_ENOMEM;
@@ -330,6 +382,19 @@ jint JNI_CreateJavaVM(JavaVM **pVm, JNIEnv **pEnv, void *args) {
                            jvmArgs11->libpath, JNI_FALSE);
     if (rc != JNI_OK) return rc;
 
+    /* Use and/or record the class data archive (invalid archives unused) */
+    archiveFile = JEM_GetInitProperty(jvmArgs11->properties, "jemcc.archive");
+    if (archiveFile != NULL) {
+        rc = JEM_OpenClassArchive((JNIEnv *) jenv, archiveFile);
+        if (rc == JNI_ENOMEM) return rc;
+    }
+    archiveFile = JEM_GetInitProperty(jvmArgs11->properties,
+                                      "jemcc.archive.dump");
+    if (archiveFile != NULL) {
+        rc = JEM_CreateClassArchive((JNIEnv *) jenv, archiveFile);
+        if (rc != JNI_OK) return rc;
+    }
+
     /* Initialize the package definition information as well */
     rc = JEM_ReadPathFileContents((JNIEnv *) jenv, &(jvm->libPath),
                                   "jemcclib.txt", &pkgFileData, &pkgFileLen);
@@ -352,12 +417,31 @@ jint JNI_CreateJavaVM(JavaVM **pVm, JNIEnv **pEnv, void *args) {
     jvm->verboseDebugFlags = 1 | 2; /* TODO */
     if (jvmArgs11->enableVerboseGC != 0) jvm->verboseDebugFlags |= 2;
 
+    /* The minimum heap size is the floor of the collection threshold */
+    jvm->gcMinThreshold = (juint) jvmArgs11->minHeapSize;
+
     /* Complete the initialization of the environment (needed Thread) */
     if ((rc = JEM_InitializeJNIEnv(jenv)) != JNI_OK) {
         /* TODO CLEAN UP */
         return rc;
     }
 
+    /* Preload the listed (or all archived, for '*') classpath classes */
+    preloadList = JEM_GetInitProperty(jvmArgs11->properties, "jemcc.preload");
+    if (preloadList != NULL) {
+        preloadWorkers = JEM_GetInitProperty(jvmArgs11->properties,
+                                             "jemcc.preload.workers");
+        rc = JEM_PreloadSystemClasses((JNIEnv *) jenv,
+                             (strcmp(preloadList, "*") == 0) ? NULL :
+                                                               preloadList,
+                             (preloadWorkers == NULL) ? 0 :
+                                                       atoi(preloadWorkers));
+        if (rc != JNI_OK) {
+            /* TODO CLEAN UP */
+            return rc;
+        }
+    }
+
     /* Control multi-thread access to the VM link table */
     JEMCC_EnterGlobalMonitor();
 
@@ -437,25 +521,20 @@ static JEM_JNIEnv *JEM_CreateJNIEnv(JEM_JavaVM *vm) {
     /* Buffer is always NULL'd at first */
     jenv->envBuffer = jenv->envEndPtr = NULL;
     jenv->envBufferLength = 0;
+    jenv->scratchBuffer = NULL;
+    jenv->scratchBufferLength = 0;
 
     /* Initialize the memory allocation components */
     jenv->firstAllocObjectRecord = jenv->lastAllocObjectRecord = NULL;
+    jenv->allocBlockList = NULL;
+    jenv->allocBlockPtr = jenv->allocBlockEnd = NULL;
+    jenv->allocLargeList = NULL;
 
     /* Construct the frame buffer and push the root native frame */
-    jenv->frameStackBlockSize = 1024;
-    jenv->frameStackBlock = calloc((unsigned int) jenv->frameStackBlockSize, 1);
-    if (jenv->frameStackBlock == NULL) {
-        /* TODO - handle calloc failure */
+    if (JEM_CreateFrameStack((JNIEnv *) jenv) != JNI_OK) {
+        /* TODO - handle allocation failure */
         return NULL;
     }
-    jenv->topFrame = (JEM_VMFrameExt *) jenv->frameStackBlock;
-    ((JEMCC_VMFrame *) jenv->topFrame)->operandStackTop = NULL;
-    ((JEMCC_VMFrame *) jenv->topFrame)->localVars = NULL;
-    jenv->topFrame->opFlags = FRAME_ROOT;
-    jenv->topFrame->previousFrame = NULL;
-    jenv->topFrame->frameDepth = 1;
-    jenv->topFrame->currentMethod = NULL;
-    jenv->topFrame->firstAllocObjectRecord = NULL;
 
     return jenv;
 }
@@ -503,8 +582,11 @@ static void JEM_DestroyJNIEnv(JEM_JNIEnv *env) {
     env->parentVM = NULL;
     JEMCC_ExitSysMonitor(jvm->monitor);
 
-    /* Destroy the buffer if present */
+    /* Destroy the buffer and frame stack if present */
+    JEM_ReleaseThinLockId((JNIEnv *) env);
     if (env->envBuffer != NULL) JEMCC_Free(env->envBuffer);
+    if (env->scratchBuffer != NULL) JEMCC_Free(env->scratchBuffer);
+    JEM_DestroyFrameStack((JNIEnv *) env);
 
     /* TODO - Nuke the threading info */
 
@@ -155,7 +155,41 @@ static JEMCC_VMFrame *pushRunMethodFrameA(JNIEnv *env, jclass clazz,
 
 jmethodID JEMCC_GetMethodID(JNIEnv *env, jclass clazz, const char *name, 
                             const char *sig) {
-    return NULL; /* TODO */
+    JEM_ClassData *classData = ((JEMCC_Class *) clazz)->classData;
+    JEM_ClassMethodData *methodData = NULL;
+    char *nameSym, *sigSym;
+
+    /* Initialize the class first (JNI spec), aborting on init failure */
+    if (JEMCC_InitializeClass(env, (JEMCC_Class *) clazz) != JNI_OK) {
+        return NULL;
+    }
+
+    /* Retrieve the class method by interned symbols (constructors local) */
+    nameSym = JEM_LookupSymbol(env, name);
+    sigSym = JEM_LookupSymbol(env, sig);
+    if ((nameSym != NULL) && (sigSym != NULL)) {
+        if (*nameSym == '<') {
+            methodData = JEM_LocateLocalMethod(classData, nameSym, sigSym);
+        } else {
+            methodData = JEM_LocateClassMethod(classData, nameSym, sigSym);
+        }
+    }
+    if (methodData == NULL) {
+        /* TODO - check the descriptor and give a nice method description */
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NoSuchMethodError, 
+                                   NULL, name);
+        return NULL;
+    }
+
+    /* Confirm returned method is in fact an instance method */
+    if ((methodData->accessFlags & ACC_STATIC) != 0) {
+        JEMCC_ThrowStdThrowableIdxV(env, JEMCC_Class_NoSuchMethodError, NULL, 
+                                    "JNI: Requested method is static",
+                                    name, NULL);
+        return NULL;
+    } 
+
+    return (jmethodID) methodData;
 }
 
 jobject JEMCC_CallObjectMethodV(JNIEnv *env, jobject obj,
@@ -381,13 +415,20 @@ void JEMCC_CallNonvirtualVoidMethodA(JNIEnv *env, jobject obj,
 jmethodID JEMCC_GetStaticMethodID(JNIEnv *env, jclass clazz, const char *name, 
                                   const char *sig) {
     JEM_ClassData *classData = ((JEMCC_Class *) clazz)->classData;
-    JEM_ClassMethodData *methodData;
+    JEM_ClassMethodData *methodData = NULL;
+    char *nameSym, *sigSym;
 
-    /* Initialize the class first */
-    /* TODO DO IT - WATCH FOR INIT ERROR */
+    /* Initialize the class first (JNI spec), aborting on init failure */
+    if (JEMCC_InitializeClass(env, (JEMCC_Class *) clazz) != JNI_OK) {
+        return NULL;
+    }
 
-    /* Retrieve the class method by hash key */
-    methodData = JEM_LocateClassMethod(classData, name, sig);
+    /* Retrieve the class method by interned symbols */
+    nameSym = JEM_LookupSymbol(env, name);
+    sigSym = JEM_LookupSymbol(env, sig);
+    if ((nameSym != NULL) && (sigSym != NULL)) {
+        methodData = JEM_LocateClassMethod(classData, nameSym, sigSym);
+    }
     if (methodData == NULL) {
         /* TODO - check the descriptor and give a nice method description */
         JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_NoSuchMethodError, 
@@ -36,23 +36,116 @@ jsize JEMCC_GetStringLength(JNIEnv *env, jstring str) {
     return len;
 }
 
+/**
+ * Common method to obtain the Unicode characters of a String.  Unicode
+ * String data is returned in place (the String is pinned until released),
+ * 8-bit String data must be expanded into an allocated copy.
+ */
+static const jchar *JEM_GetStringElements(JNIEnv *env, jstring str,
+                                          jboolean *isCopy) {
+    JEMCC_StringData *strData = (JEMCC_StringData *) 
+                                         ((JEMCC_ObjectExt *) str)->objectData;
+    jchar *chars;
+    jsize len;
+
+    if (strData->length >= 0) {
+        if (JEM_PinObject(env, (JEMCC_Object *) str) != JNI_OK) return NULL;
+        if (isCopy != NULL) *isCopy = JNI_FALSE;
+        return (jchar *) &(strData->data);
+    }
+
+    /* Always allocate an element, a zero size allocation may be NULL */
+    len = -strData->length;
+    chars = (jchar *) JEMCC_Malloc(env, (len + 1) * sizeof(jchar));
+    if (chars == NULL) return NULL;
+    JEM_StrWiden(chars, (jubyte *) &(strData->data), len);
+    if (isCopy != NULL) *isCopy = JNI_TRUE;
+
+    return chars;
+}
+
+/**
+ * Common method to release the characters obtained through the method
+ * above, unpinning the String or releasing the expanded copy.
+ */
+static void JEM_ReleaseStringElements(JNIEnv *env, jstring str,
+                                      const jchar *chars) {
+    JEMCC_StringData *strData = (JEMCC_StringData *) 
+                                         ((JEMCC_ObjectExt *) str)->objectData;
+
+    if (chars == (jchar *) &(strData->data)) {
+        JEM_UnpinObject(env, (JEMCC_Object *) str);
+    } else {
+        JEMCC_Free((void *) chars);
+    }
+}
+
 const jchar *JEMCC_GetStringChars(JNIEnv *env, jstring str, jboolean *isCopy) {
-    return NULL; /* TODO */
+    return JEM_GetStringElements(env, str, isCopy);
 }
 
 void JEMCC_ReleaseStringChars(JNIEnv *env, jstring str, const jchar *chars) {
-    /* TODO */
+    JEM_ReleaseStringElements(env, str, chars);
+}
+
+/**
+ * Obtain the Unicode characters of a String, for a short (non-blocking)
+ * native operation.  This is the equivalent of the JNI 1.2
+ * GetStringCritical method, which is not part of the JNI 1.1 function
+ * table.  Unicode String data is returned in place, but Strings with 8-bit
+ * data can only be returned as an (expanded) copy.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     str - the String instance to access
+ *     isCopy - if non-NULL, set to JNI_TRUE if the characters are a copy
+ *
+ * Returns:
+ *     The Unicode characters of the String, or NULL if a memory allocation
+ *     failed (an OutOfMemoryError will have been thrown in the current
+ *     environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+const jchar *JEMCC_GetStringCritical(JNIEnv *env, jstring str,
+                                     jboolean *isCopy) {
+    return JEM_GetStringElements(env, str, isCopy);
+}
+
+/**
+ * Release the characters obtained through GetStringCritical.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     str - the String instance being accessed
+ *     carray - the characters returned by GetStringCritical
+ */
+void JEMCC_ReleaseStringCritical(JNIEnv *env, jstring str,
+                                 const jchar *carray) {
+    JEM_ReleaseStringElements(env, str, carray);
 }
 
 jsize JEMCC_GetStringUTFLength(JNIEnv *env, jstring str) {
-    return 0; /* TODO */
+    return JEM_UTFEncodedLength((JEMCC_StringData *)
+                                        ((JEMCC_ObjectExt *) str)->objectData);
 }
 
 const char *JEMCC_GetStringUTFChars(JNIEnv *env, jstring str,
                                     jboolean *isCopy) {
-    return NULL; /* TODO */
+    JEMCC_StringData *strData = (JEMCC_StringData *) 
+                                         ((JEMCC_ObjectExt *) str)->objectData;
+    char *utf;
+
+    /* Always a copy, the String storage is not UTF-8 encoded */
+    utf = (char *) JEMCC_Malloc(env, JEM_UTFEncodedLength(strData) + 1);
+    if (utf == NULL) return NULL;
+    JEM_UTFEncode(strData, utf);
+    if (isCopy != NULL) *isCopy = JNI_TRUE;
+
+    return utf;
 }
 
 void JEMCC_ReleaseStringUTFChars(JNIEnv *env, jstring str, const char *chars) {
-    /* TODO */
+    JEMCC_Free((void *) chars);
 }
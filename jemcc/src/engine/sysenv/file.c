@@ -148,6 +148,9 @@ jint JEMCC_ReadFromFileDesc(JNIEnv *env, jint fd, void *buff, jint len,
     jint l = 0, errnum;
     char *msg;
 
+    /* The read may block indefinitely, collections may proceed meanwhile */
+    JEM_GCEnterSafeRegion(env);
+
     /* Repeat until some read or error occurs */
     while (len > 0) {
         l = read(fd, buff, len);
@@ -164,6 +167,7 @@ jint JEMCC_ReadFromFileDesc(JNIEnv *env, jint fd, void *buff, jint len,
                 msg = NULL;
             }
 
+            JEM_GCLeaveSafeRegion(env);
             JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, 
                                        NULL, msg);
             return JNI_ERR;
@@ -171,6 +175,7 @@ jint JEMCC_ReadFromFileDesc(JNIEnv *env, jint fd, void *buff, jint len,
             break;
         }
     }
+    JEM_GCLeaveSafeRegion(env);
 
     *readLen = l;
     return JNI_OK;
@@ -199,6 +204,9 @@ jint JEMCC_WriteToFileDesc(JNIEnv *env, jint fd, void *buff, jint len) {
     jint l, errnum;
     char *msg;
 
+    /* The write may block indefinitely, collections may proceed meanwhile */
+    JEM_GCEnterSafeRegion(env);
+
     /* Repeat until written or error occurs */
     while (len > 0) {
         l = write(fd, buff, len);
@@ -214,6 +222,7 @@ jint JEMCC_WriteToFileDesc(JNIEnv *env, jint fd, void *buff, jint len) {
                 msg = NULL;
             }
 
+            JEM_GCLeaveSafeRegion(env);
             JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, 
                                        NULL, msg);
             return JNI_ERR;
@@ -222,6 +231,7 @@ jint JEMCC_WriteToFileDesc(JNIEnv *env, jint fd, void *buff, jint len) {
         buff += l;
         len -= l;
     }
+    JEM_GCLeaveSafeRegion(env);
 
     return JNI_OK;
 }
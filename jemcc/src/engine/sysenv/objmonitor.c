@@ -38,6 +38,31 @@
 
 #define LOCK_STATE_MASK   0x3
 
+/*
+ * Thin lock state.  An object with no other state information is locked
+ * by a single compare-and-swap of a thin lock word, containing the thin
+ * lock id of the owning environment and an inline recursion count.  Lock
+ * queue records and environments are (at least) 8-byte aligned, so the
+ * LOCK_THIN bit never appears in the queue record states above.  The thin
+ * lock is inflated into the queue record form on contention, recursion
+ * count overflow or wait(), and reverts to the original state on exit.
+ */
+#define LOCK_THIN         0x4
+#define LOCK_THIN_MASK    0x7
+
+#define THIN_COUNT_SHIFT  3
+#define THIN_COUNT_MAX    0xFF
+#define THIN_ID_SHIFT     11
+#define THIN_ID_MAX       0x1FFFFF
+#define THIN_ID_NONE      0xFFFFFFFF
+
+#define IS_THIN_LOCK(state) \
+    (((state) & LOCK_THIN_MASK) == (LOCK_THIN | LOCK_ACTIVE))
+#define IS_QUEUE_ACTIVE(state) \
+    (((state) & LOCK_THIN_MASK) == LOCK_ACTIVE)
+#define THIN_LOCK_ID(state) ((state) >> THIN_ID_SHIFT)
+#define THIN_LOCK_COUNT(state) (((state) >> THIN_COUNT_SHIFT) & THIN_COUNT_MAX)
+
 /* State definitions for the object queue locking transfers */
 #define STATETXFR_IDLE 0
 #define STATETXFR_SEND_WAIT 1
@@ -249,6 +274,170 @@ static void JEM_UnlockObjectQueue(JEM_JNIEnv *jenv, juint *stateFieldAddr,
 
 #endif
 
+/*
+ * Registry of the environments which have been assigned thin lock ids,
+ * indexed by id (zero is never assigned).  Only accessed under the global
+ * monitor, by id assignment/release and by contending threads inflating
+ * the thin lock of another environment.
+ */
+static JEM_JNIEnv **thinLockOwners = NULL;
+static juint thinLockOwnerCapacity = 0;
+
+/**
+ * Assign a thin lock id to the given environment, on the first object
+ * monitor entry of the environment.  If an id cannot be assigned, the
+ * environment is marked to always use the lock queue records.
+ *
+ * Parameters:
+ *     jenv - the VM environment which is currently in context
+ *
+ * Returns:
+ *     The assigned thin lock id or THIN_ID_NONE if no id is available.
+ */
+static juint JEM_AssignThinLockId(JEM_JNIEnv *jenv) {
+    JEM_JNIEnv **owners;
+    juint id, capacity;
+
+    jenv->thinLockId = THIN_ID_NONE;
+    if (JEMCC_EnterGlobalMonitor() != JNI_OK) return THIN_ID_NONE;
+    for (id = 1; id < thinLockOwnerCapacity; id++) {
+        if (thinLockOwners[id] == NULL) break;
+    }
+    if (id >= thinLockOwnerCapacity) {
+        /* Grow the registry (not an error if this fails, just no id) */
+        capacity = (thinLockOwnerCapacity == 0) ? 64 :
+                                                  2 * thinLockOwnerCapacity;
+        if (capacity > THIN_ID_MAX + 1) capacity = THIN_ID_MAX + 1;
+        owners = (id >= capacity) ? NULL : (JEM_JNIEnv **)
+                   JEMCC_Malloc(NULL, capacity * sizeof(JEM_JNIEnv *));
+        if (owners == NULL) {
+            JEMCC_ExitGlobalMonitor();
+            return THIN_ID_NONE;
+        }
+        if (thinLockOwners != NULL) {
+            (void) memcpy(owners, thinLockOwners,
+                          thinLockOwnerCapacity * sizeof(JEM_JNIEnv *));
+            JEMCC_Free(thinLockOwners);
+        }
+        thinLockOwners = owners;
+        thinLockOwnerCapacity = capacity;
+    }
+    thinLockOwners[id] = jenv;
+    jenv->thinLockId = id;
+    JEMCC_ExitGlobalMonitor();
+
+    return id;
+}
+
+/**
+ * Release the thin lock id of an environment which is being destroyed,
+ * allowing the id to be reused.  The environment must not hold any object
+ * monitors.
+ *
+ * Parameters:
+ *     env - the VM environment which is being destroyed
+ */
+void JEM_ReleaseThinLockId(JNIEnv *env) {
+    JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
+
+    if ((jenv->thinLockId == 0) || (jenv->thinLockId == THIN_ID_NONE)) return;
+    if (JEMCC_EnterGlobalMonitor() != JNI_OK) return;
+    thinLockOwners[jenv->thinLockId] = NULL;
+    JEMCC_ExitGlobalMonitor();
+    jenv->thinLockId = 0;
+}
+
+/**
+ * Pull a lock queue record from the free list of the environment,
+ * allocating more records if required.  Records migrate between the free
+ * lists of different environments (through inflation), so the record
+ * is reinitialized here.
+ *
+ * Parameters:
+ *     jenv - the VM environment which is currently in context
+ *
+ * Returns:
+ *     The lock queue record or NULL if a memory allocation failed (an
+ *     OutOfMemoryError will have been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+static JEM_ObjLockQueueEntry *JEM_AllocLockQueueEntry(JEM_JNIEnv *jenv) {
+    JEM_ObjLockQueueEntry *lockEntry;
+    int i;
+
+    if (jenv->freeObjLockQueue == NULL) {
+        for (i = 0; i < 4; i++) {
+            lockEntry = (JEM_ObjLockQueueEntry *) JEMCC_Malloc((JNIEnv *) jenv,
+                                        (juint) sizeof(JEM_ObjLockQueueEntry));
+            if (lockEntry == NULL) {
+                if (jenv->freeObjLockQueue != NULL) break;
+                return NULL;
+            }
+            lockEntry->nextEntry = jenv->freeObjLockQueue;
+            jenv->freeObjLockQueue = lockEntry;
+        }
+    }
+    lockEntry = jenv->freeObjLockQueue;
+    jenv->freeObjLockQueue = lockEntry->nextEntry;
+    lockEntry->parentEnv = jenv;
+    lockEntry->entryCount = 1;
+    lockEntry->nextEntry = NULL;
+
+    return lockEntry;
+}
+
+/**
+ * Inflate a thin lock into the lock queue record form, on behalf of the
+ * owning environment (which may be the current one).  The object queue
+ * lock must be held, which prevents the owner from altering the thin lock.
+ *
+ * Parameters:
+ *     jenv - the VM environment which is currently in context
+ *     thinState - the thin lock state, as returned from the queue lock
+ *
+ * Returns:
+ *     The active lock state for the queue record of the owner, to replace
+ *     the thin lock state, or zero if a memory allocation failed (an
+ *     OutOfMemoryError will have been thrown in the current environment).
+ *
+ * Exceptions:
+ *     OutOfMemoryError - a memory allocation failed
+ */
+static juint JEM_InflateThinLock(JEM_JNIEnv *jenv, juint thinState) {
+    JEM_ObjLockQueueEntry *ownerEntry;
+    JEM_JNIEnv *ownerEnv = jenv;
+
+    if (THIN_LOCK_ID(thinState) != jenv->thinLockId) {
+        if (JEMCC_EnterGlobalMonitor() != JNI_OK) {
+            abort(); /* purecov: deadcode */
+        }
+        ownerEnv = thinLockOwners[THIN_LOCK_ID(thinState)];
+        JEMCC_ExitGlobalMonitor();
+        if (ownerEnv == NULL) {
+            abort(); /* purecov: deadcode */
+        }
+    }
+
+    ownerEntry = JEM_AllocLockQueueEntry(jenv);
+    if (ownerEntry == NULL) return 0;
+    ownerEntry->parentEnv = ownerEnv;
+    ownerEntry->entryCount = THIN_LOCK_COUNT(thinState) + 1;
+    ownerEntry->objStateSet = LOCK_AVAILABLE;
+
+    return ((juint) ownerEntry) | LOCK_ACTIVE;
+}
+
+/**
+ * Determine the state to restore when the thin lock owner exits the
+ * monitor, either a decremented count or the (empty) unlocked state.
+ */
+static juint JEM_ThinLockExitState(juint thinState) {
+    if (THIN_LOCK_COUNT(thinState) == 0) return LOCK_AVAILABLE;
+    return thinState - (1 << THIN_COUNT_SHIFT);
+}
+
 /**
  * Local method used by the enter and wait methods where several 
  * threads are actively attempting to obtain the active lock for a specific
@@ -295,6 +484,7 @@ static void JEM_WaitForActiveObjectLock(JEM_JNIEnv *jenv, juint *stateFieldAddr,
                 JEMCC_EnterSysMonitor(jenv->objLockMonitor);
                 JEM_UnlockObjectQueue(jenv, stateFieldAddr,
                                       currentQueueLockState);
+                JEM_GCEnterSafeRegion((JNIEnv *) jenv);
                 if (JEMCC_SysMonitorWait(jenv->objLockMonitor) != 
                                                       JEMCC_MONITOR_OK) {
                     abort(); /* purecov: deadcode */
@@ -303,6 +493,7 @@ static void JEM_WaitForActiveObjectLock(JEM_JNIEnv *jenv, juint *stateFieldAddr,
                                                       JEMCC_MONITOR_OK) {
                     abort(); /* purecov: deadcode */
                 }
+                JEM_GCLeaveSafeRegion((JNIEnv *) jenv);
 
                 /* Quick check for direct handoff */
                 currentQueueLockState = *stateFieldAddr;
@@ -436,14 +627,35 @@ jint JEMCC_EnterObjMonitor(JNIEnv *env, jobject obj) {
     juint *stateFieldAddr = &(((JEMCC_Object *) obj)->objStateSet);
     JEM_ObjLockQueueEntry *queueEntry, *lockEntry;
     juint compState, lockState;
-    int i;
 #ifdef HAS_COMPARE_AND_SWAP
     register char casResult;
+    juint thinId;
 #endif
 
-    /* Handle the relock case first (very simple data manipulation) */
     compState = *stateFieldAddr;
-    if ((compState & LOCK_STATE_MASK) == LOCK_ACTIVE) {
+#ifdef HAS_COMPARE_AND_SWAP
+    /* Thin lock entry/reentry for the uncontested case (single CAS) */
+    thinId = jenv->thinLockId;
+    if (thinId == 0) thinId = JEM_AssignThinLockId(jenv);
+    if (thinId != THIN_ID_NONE) {
+        if (compState == LOCK_AVAILABLE) {
+            lockState = (thinId << THIN_ID_SHIFT) | LOCK_THIN | LOCK_ACTIVE;
+            COMPARE_AND_SWAP(compState, lockState, stateFieldAddr, casResult);
+            if (casResult != 0) return JNI_OK;
+            compState = *stateFieldAddr;
+        } else if ((IS_THIN_LOCK(compState)) &&
+                   (THIN_LOCK_ID(compState) == thinId) &&
+                   (THIN_LOCK_COUNT(compState) < THIN_COUNT_MAX)) {
+            lockState = compState + (1 << THIN_COUNT_SHIFT);
+            COMPARE_AND_SWAP(compState, lockState, stateFieldAddr, casResult);
+            if (casResult != 0) return JNI_OK;
+            compState = *stateFieldAddr;
+        }
+    }
+#endif
+
+    /* Handle the relock case first (very simple data manipulation) */
+    if (IS_QUEUE_ACTIVE(compState)) {
         lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (compState & (~((juint) LOCK_STATE_MASK)));
         if (lockEntry->parentEnv == jenv) {
@@ -453,20 +665,8 @@ jint JEMCC_EnterObjMonitor(JNIEnv *env, jobject obj) {
     }
 
     /* Ensure adequate lock queue records (and pull one from the free list) */
-    if (jenv->freeObjLockQueue == NULL) {
-        for (i = 0; i < 4; i++) {
-            lockEntry = (JEM_ObjLockQueueEntry *) JEMCC_Malloc(env,
-                                        (juint) sizeof(JEM_ObjLockQueueEntry));
-            if (lockEntry == NULL) return JNI_ENOMEM;
-            lockEntry->parentEnv = jenv;
-            lockEntry->entryCount = 1;
-            lockEntry->nextEntry = jenv->freeObjLockQueue;
-            jenv->freeObjLockQueue = lockEntry;
-        }
-    }
-    lockEntry = jenv->freeObjLockQueue;
-    jenv->freeObjLockQueue = lockEntry->nextEntry;
-    lockEntry->nextEntry = NULL;
+    lockEntry = JEM_AllocLockQueueEntry(jenv);
+    if (lockEntry == NULL) return JNI_ENOMEM;
 
     /* Rapid lock sequence for uncontested lock states */
 #ifdef HAS_COMPARE_AND_SWAP
@@ -480,6 +680,17 @@ jint JEMCC_EnterObjMonitor(JNIEnv *env, jobject obj) {
 
     /* Lock the object queue and get the current lock state */
     lockState = JEM_LockObjectQueue(jenv, stateFieldAddr);
+    if (IS_THIN_LOCK(lockState)) {
+        /* Contention or count overflow, convert to the queue record form */
+        compState = JEM_InflateThinLock(jenv, lockState);
+        if (compState == 0) {
+            JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
+            lockEntry->nextEntry = jenv->freeObjLockQueue;
+            jenv->freeObjLockQueue = lockEntry;
+            return JNI_ENOMEM;
+        }
+        lockState = compState;
+    }
     switch (lockState & LOCK_STATE_MASK) {
         case LOCK_AVAILABLE:
             /* Simply store the new lock record into the state set */
@@ -560,7 +771,16 @@ jint JEMCC_ExitObjMonitor(JNIEnv *env, jobject obj) {
 
     /* Handle quick uncontested lock conditions (no queue lock) */
     compState = *stateFieldAddr;
-    if ((compState & LOCK_STATE_MASK) == LOCK_ACTIVE) {
+#ifdef HAS_COMPARE_AND_SWAP
+    if ((IS_THIN_LOCK(compState)) &&
+                   (THIN_LOCK_ID(compState) == jenv->thinLockId)) {
+        COMPARE_AND_SWAP(compState, JEM_ThinLockExitState(compState),
+                         stateFieldAddr, casResult);
+        if (casResult != 0) return JNI_OK;
+        compState = *stateFieldAddr;
+    }
+#endif
+    if (IS_QUEUE_ACTIVE(compState)) {
         lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (compState & (~((juint) LOCK_STATE_MASK)));
         if (lockEntry->parentEnv == jenv) {
@@ -587,10 +807,16 @@ jint JEMCC_ExitObjMonitor(JNIEnv *env, jobject obj) {
 
     /* Grab control of the queue and validate lock condition */
     lockState = JEM_LockObjectQueue(jenv, stateFieldAddr);
+    if ((IS_THIN_LOCK(lockState)) &&
+                   (THIN_LOCK_ID(lockState) == jenv->thinLockId)) {
+        /* Owned thin lock (collided with transient queue lock) */
+        JEM_UnlockObjectQueue(jenv, stateFieldAddr,
+                              JEM_ThinLockExitState(lockState));
+        return JNI_OK;
+    }
     lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (lockState & (~((juint) LOCK_STATE_MASK)));
-    if (((lockState & LOCK_STATE_MASK) != LOCK_ACTIVE) ||
-                                          (lockEntry->parentEnv != jenv)) {
+    if ((!IS_QUEUE_ACTIVE(lockState)) || (lockEntry->parentEnv != jenv)) {
         JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
         JEMCC_ThrowStdThrowableIdx(env, 
                                    JEMCC_Class_IllegalMonitorStateException,
@@ -719,7 +945,7 @@ jint JEMCC_ObjMonitorNanoWait(JNIEnv *env, jobject obj,
     JEM_JNIEnv *jenv = (JEM_JNIEnv *) env;
     juint *stateFieldAddr = &(((JEMCC_Object *) obj)->objStateSet);
     JEM_ObjLockQueueEntry *lockEntry;
-    juint lockState;
+    juint lockState, inflState;
     jint rc;
 
     /* Quick check of input parameters */
@@ -738,10 +964,19 @@ jint JEMCC_ObjMonitorNanoWait(JNIEnv *env, jobject obj,
 
     /* Grab control of the queue and validate lock condition */
     lockState = JEM_LockObjectQueue(jenv, stateFieldAddr);
+    if ((IS_THIN_LOCK(lockState)) &&
+                   (THIN_LOCK_ID(lockState) == jenv->thinLockId)) {
+        /* Waiting requires the queue record form of the lock */
+        inflState = JEM_InflateThinLock(jenv, lockState);
+        if (inflState == 0) {
+            JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
+            return JNI_ERR;
+        }
+        lockState = inflState;
+    }
     lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (lockState & (~((juint) LOCK_STATE_MASK)));
-    if (((lockState & LOCK_STATE_MASK) != LOCK_ACTIVE) ||
-                                          (lockEntry->parentEnv != jenv)) {
+    if ((!IS_QUEUE_ACTIVE(lockState)) || (lockEntry->parentEnv != jenv)) {
         JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
         JEMCC_ThrowStdThrowableIdx(env, 
                                    JEMCC_Class_IllegalMonitorStateException,
@@ -761,7 +996,8 @@ jint JEMCC_ObjMonitorNanoWait(JNIEnv *env, jobject obj,
         JEM_TxfrActiveObjectLock(jenv, stateFieldAddr, lockEntry);
     }
 
-    /* Perform the wait/exit of the local environment monitor */
+    /* Perform the wait/exit of the local environment monitor (GC safe) */
+    JEM_GCEnterSafeRegion((JNIEnv *) jenv);
     if ((milli == 0) && (nano == 0)) {
         /* See java.lang.Object documentation for notation on this behaviour */
         if (JEMCC_SysMonitorWait(jenv->objLockMonitor) != JEMCC_MONITOR_OK) {
@@ -779,10 +1015,11 @@ jint JEMCC_ObjMonitorNanoWait(JNIEnv *env, jobject obj,
     if (JEMCC_ExitSysMonitor(jenv->objLockMonitor) != JEMCC_MONITOR_OK) {
         abort(); /* purecov: deadcode */
     }
+    JEM_GCLeaveSafeRegion((JNIEnv *) jenv);
 
     /* Check for direct unlock/transfer */
     lockState = *stateFieldAddr;
-    if ((lockState & LOCK_STATE_MASK) == LOCK_ACTIVE) {
+    if (IS_QUEUE_ACTIVE(lockState)) {
         lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (lockState & (~((juint) LOCK_STATE_MASK)));
         if (lockEntry->parentEnv == jenv) return JNI_OK;
@@ -826,10 +1063,15 @@ jint JEMCC_ObjMonitorNotify(JNIEnv *env, jobject obj) {
 
     /* Grab control of the queue and validate lock condition */
     lockState = JEM_LockObjectQueue(jenv, stateFieldAddr);
+    if ((IS_THIN_LOCK(lockState)) &&
+                   (THIN_LOCK_ID(lockState) == jenv->thinLockId)) {
+        /* Thin lock has never been waited on, nothing to notify */
+        JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
+        return JNI_OK;
+    }
     lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (lockState & (~((juint) LOCK_STATE_MASK)));
-    if (((lockState & LOCK_STATE_MASK) != LOCK_ACTIVE) ||
-                                          (lockEntry->parentEnv != jenv)) {
+    if ((!IS_QUEUE_ACTIVE(lockState)) || (lockEntry->parentEnv != jenv)) {
         JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
         JEMCC_ThrowStdThrowableIdx(env, 
                                    JEMCC_Class_IllegalMonitorStateException,
@@ -882,10 +1124,15 @@ jint JEMCC_ObjMonitorNotifyAll(JNIEnv *env, jobject obj) {
 
     /* Grab control of the queue and validate lock condition */
     lockState = JEM_LockObjectQueue(jenv, stateFieldAddr);
+    if ((IS_THIN_LOCK(lockState)) &&
+                   (THIN_LOCK_ID(lockState) == jenv->thinLockId)) {
+        /* Thin lock has never been waited on, nothing to notify */
+        JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
+        return JNI_OK;
+    }
     lockEntry = (JEM_ObjLockQueueEntry*) 
                                 (lockState & (~((juint) LOCK_STATE_MASK)));
-    if (((lockState & LOCK_STATE_MASK) != LOCK_ACTIVE) ||
-                                          (lockEntry->parentEnv != jenv)) {
+    if ((!IS_QUEUE_ACTIVE(lockState)) || (lockEntry->parentEnv != jenv)) {
         JEM_UnlockObjectQueue(jenv, stateFieldAddr, lockState);
         JEMCC_ThrowStdThrowableIdx(env, 
                                    JEMCC_Class_IllegalMonitorStateException,
@@ -905,3 +1152,32 @@ jint JEMCC_ObjMonitorNotifyAll(JNIEnv *env, jobject obj) {
 
     return JNI_OK;
 }
+
+/**
+ * Atomically exchange the pointer value stored at the given address, as
+ * a full memory barrier.  Uses the cpu exchange primitive if available,
+ * otherwise the global monitor provides the ordering.
+ *
+ * Parameters:
+ *     targAddr - the address of the pointer value to be replaced
+ *     newVal - the pointer value to store
+ *
+ * Returns:
+ *     The pointer value which was stored at the address prior to the
+ *     exchange.
+ */
+void *JEM_AtomicSwapPointer(void **targAddr, void *newVal) {
+#ifdef HAS_FETCH_AND_STORE
+    FETCH_AND_STORE(newVal, targAddr);
+#else
+    void *origVal;
+
+    if (JEMCC_EnterGlobalMonitor() != JNI_OK) abort();
+    origVal = *targAddr;
+    *targAddr = newVal;
+    JEMCC_ExitGlobalMonitor();
+    newVal = origVal;
+#endif
+
+    return newVal;
+}
@@ -243,6 +243,21 @@ void JEMCC_YieldCurrentThreadAndSleep(jlong nano) {
 #endif
 }
 
+/**
+ * Sleep the current thread for a given period (e.g. for the Thread.sleep()
+ * implementation).  Unlike the yield method above, the VM environment of
+ * the thread is marked as safe for garbage collection while it sleeps.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     nano - the number of nanoseconds to sleep for
+ */
+void JEMCC_SleepCurrentThread(JNIEnv *env, jlong nano) {
+    JEM_GCEnterSafeRegion(env);
+    JEMCC_YieldCurrentThreadAndSleep(nano);
+    JEM_GCLeaveSafeRegion(env);
+}
+
 /**
  * Yield control of the current thread based on activity on the given
  * file descriptor index, allowing other threads waiting on the processor
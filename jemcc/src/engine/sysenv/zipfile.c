@@ -42,6 +42,24 @@
 
 struct ZipFileStreamData;
 
+/* Hashed index record for an entry in the central directory */
+typedef struct ZipIndexEntry {
+    juint nameHash;
+    jint dirOffset;
+
+    /* Chains (entry indices) for the name hash and containing directory */
+    jint nameNext, dirNext;
+} ZipIndexEntry;
+
+/* Index record for a directory (package) prefix of the entry names */
+typedef struct ZipDirectory {
+    juint nameHash, nameLength;
+    char *name;
+
+    /* Head of the entry chain and next directory in the hash bucket */
+    jint firstEntry, next;
+} ZipDirectory;
+
 /* Definition of the internal ZipFile management structure */
 typedef struct ZipFileData {
     /* Match the external definition */
@@ -50,6 +68,13 @@ typedef struct ZipFileData {
     /* Pre-scan data */
     JEMCC_ZipFileEntry *entries;
 
+    /* Name/directory hash index (at open if prescanned, else on demand) */
+    ZipIndexEntry *index;
+    jint *nameBuckets, *dirBuckets;
+    juint bucketMask;
+    ZipDirectory *dirs;
+    jint dirCount, dirCapacity;
+
     /* File descriptor/size and map access information */
     int fd;
     jint fileSize, dirStartOffset;
@@ -183,6 +208,192 @@ static jint readZipFileEntry(JNIEnv *env, ZipFileData *zipFile,
            entry->fileCommentLength + 46;
 }
 
+/**
+ * Hash function for the entry and directory names of the index (FNV-1a).
+ * Note that this is local, as the zipfile methods are linked standalone.
+ */
+static juint hashZipName(const jbyte *name, juint length) {
+    juint hashCode = 2166136261U;
+
+    while (length > 0) {
+        hashCode ^= (jubyte) *(name++);
+        hashCode *= 16777619;
+        length--;
+    }
+
+    return hashCode;
+}
+
+/**
+ * Determine the length of the directory prefix of an entry name, including
+ * the trailing separator (zero for entries in the root).  Entries which are
+ * themselves directories belong to their parent directory.
+ */
+static juint zipDirLength(const jbyte *name, juint length) {
+    if ((length > 0) && (name[length - 1] == '/')) length--;
+    while ((length > 0) && (name[length - 1] != '/')) length--;
+
+    return length;
+}
+
+/**
+ * Release the name/directory index of a Zip file, if it exists.
+ */
+static void freeZipIndex(ZipFileData *zFile) {
+    jint i;
+
+    if (zFile->dirs != NULL) {
+        for (i = 0; i < zFile->dirCount; i++) JEMCC_Free(zFile->dirs[i].name);
+        JEMCC_Free(zFile->dirs);
+    }
+    if (zFile->nameBuckets != NULL) JEMCC_Free(zFile->nameBuckets);
+    if (zFile->index != NULL) JEMCC_Free(zFile->index);
+
+    zFile->index = NULL;
+    zFile->nameBuckets = zFile->dirBuckets = NULL;
+    zFile->dirs = NULL;
+    zFile->dirCount = zFile->dirCapacity = 0;
+}
+
+/**
+ * Attach the indicated entry to the record for its containing directory,
+ * creating the directory record if this is the first entry in it.  Returns
+ * JNI_OK or JNI_ENOMEM if a memory allocation failed.
+ */
+static jint addZipDirEntry(JNIEnv *env, ZipFileData *zFile,
+                           JEMCC_ZipFileEntry *entry, jint entryIdx) {
+    juint dirLength = zipDirLength(entry->fileName, entry->fileNameLength);
+    juint dirHash = hashZipName(entry->fileName, dirLength);
+    ZipDirectory *dir, *newDirs;
+    jint d, newCapacity;
+
+    for (d = zFile->dirBuckets[dirHash & zFile->bucketMask]; d >= 0;
+                                                     d = dir->next) {
+        dir = &(zFile->dirs[d]);
+        if ((dir->nameHash == dirHash) && (dir->nameLength == dirLength) &&
+            (memcmp(dir->name, entry->fileName, dirLength) == 0)) break;
+    }
+
+    if (d < 0) {
+        if (zFile->dirCount == zFile->dirCapacity) {
+            newCapacity = (zFile->dirCapacity == 0) ? 16 :
+                                                  2 * zFile->dirCapacity;
+            newDirs = (ZipDirectory *) JEMCC_Malloc(env, newCapacity *
+                                                    sizeof(ZipDirectory));
+            if (newDirs == NULL) return JNI_ENOMEM;
+            if (zFile->dirs != NULL) {
+                (void) memcpy(newDirs, zFile->dirs,
+                              zFile->dirCount * sizeof(ZipDirectory));
+                JEMCC_Free(zFile->dirs);
+            }
+            zFile->dirs = newDirs;
+            zFile->dirCapacity = newCapacity;
+        }
+
+        dir = &(zFile->dirs[zFile->dirCount]);
+        dir->name = (char *) JEMCC_Malloc(env, dirLength + 1);
+        if (dir->name == NULL) return JNI_ENOMEM;
+        (void) memcpy(dir->name, entry->fileName, dirLength);
+        dir->nameHash = dirHash;
+        dir->nameLength = dirLength;
+        dir->firstEntry = -1;
+        dir->next = zFile->dirBuckets[dirHash & zFile->bucketMask];
+        zFile->dirBuckets[dirHash & zFile->bucketMask] = zFile->dirCount++;
+    }
+
+    zFile->index[entryIdx].dirNext = dir->firstEntry;
+    dir->firstEntry = entryIdx;
+
+    return JNI_OK;
+}
+
+/**
+ * Build the hashed name and directory indices for the entries of the central
+ * directory.  Uses the prescanned entries if available, otherwise reads
+ * each directory entry once (only the index is retained).  Chains are
+ * reordered once complete, so that lookups return the first of duplicated
+ * names (as the original linear scan did) and directory scans are in
+ * archive order.  Returns JNI_OK if successful, JNI_ERR if a directory
+ * entry could not be read/parsed (exception will be thrown if not in quiet
+ * mode) or JNI_ENOMEM if a memory allocation failed.
+ */
+static jint buildZipIndex(JNIEnv *env, ZipFileData *zFile,
+                          jboolean quietMode) {
+    jint i, rc, entryLen, offset, prev, next, count = zFile->ezf.entryCount;
+    JEMCC_ZipFileEntry scanEntry, *entry;
+    juint bucketCount, b;
+    ZipIndexEntry *idx;
+
+    /* Allocate the index records and name/directory bucket sets */
+    bucketCount = 16;
+    while (bucketCount < (juint) count) bucketCount <<= 1;
+    zFile->index = (ZipIndexEntry *) JEMCC_Malloc(env,
+                                  (count + 1) * sizeof(ZipIndexEntry));
+    if (zFile->index == NULL) return JNI_ENOMEM;
+    zFile->nameBuckets = (jint *) JEMCC_Malloc(env,
+                                  2 * bucketCount * sizeof(jint));
+    if (zFile->nameBuckets == NULL) {
+        freeZipIndex(zFile);
+        return JNI_ENOMEM;
+    }
+    zFile->dirBuckets = zFile->nameBuckets + bucketCount;
+    zFile->bucketMask = bucketCount - 1;
+    for (b = 0; b < 2 * bucketCount; b++) zFile->nameBuckets[b] = -1;
+
+    offset = zFile->dirStartOffset;
+    for (i = 0; i < count; i++) {
+        if (zFile->entries != NULL) {
+            entry = &(zFile->entries[i]);
+            entryLen = entry->fileNameLength + entry->extraFieldLength +
+                       entry->fileCommentLength + 46;
+        } else {
+            entry = &scanEntry;
+            entryLen = readZipFileEntry(env, zFile, offset, entry, quietMode);
+            if (entryLen < 0) {
+                freeZipIndex(zFile);
+                return entryLen;
+            }
+        }
+
+        idx = &(zFile->index[i]);
+        idx->dirOffset = offset;
+        idx->nameHash = hashZipName(entry->fileName, entry->fileNameLength);
+        idx->nameNext = zFile->nameBuckets[idx->nameHash & zFile->bucketMask];
+        zFile->nameBuckets[idx->nameHash & zFile->bucketMask] = i;
+        rc = addZipDirEntry(env, zFile, entry, i);
+#ifndef HAVE_MMAP
+        if (zFile->entries == NULL) JEMCC_Free(entry->fileName);
+#endif
+        if (rc != JNI_OK) {
+            freeZipIndex(zFile);
+            return rc;
+        }
+        offset += entryLen;
+    }
+
+    /* Chains were built in reverse, restore the archive ordering */
+    for (b = 0; b < bucketCount; b++) {
+        prev = -1;
+        for (i = zFile->nameBuckets[b]; i >= 0; i = next) {
+            next = zFile->index[i].nameNext;
+            zFile->index[i].nameNext = prev;
+            prev = i;
+        }
+        zFile->nameBuckets[b] = prev;
+    }
+    for (b = 0; b < (juint) zFile->dirCount; b++) {
+        prev = -1;
+        for (i = zFile->dirs[b].firstEntry; i >= 0; i = next) {
+            next = zFile->index[i].dirNext;
+            zFile->index[i].dirNext = prev;
+            prev = i;
+        }
+        zFile->dirs[b].firstEntry = prev;
+    }
+
+    return JNI_OK;
+}
+
 /**
  * Open a Zip/Jar file instance for reading.  Can prescan the file instance
  * and determine the internal file entries, providing efficient lookups at the
@@ -382,6 +593,13 @@ jint JEMCC_OpenZipFile(JNIEnv *env, const char *fileName,
             }
             offset += entryLen;
         }
+
+        /* Entries are verified, index them for the lookups */
+        entryLen = buildZipIndex(env, retFile, quietMode);
+        if (entryLen != JNI_OK) {
+            JEMCC_CloseZipFile(env, (JEMCC_ZipFile *) retFile);
+            return entryLen;
+        }
     }
 
     *zipFile = (JEMCC_ZipFile *) retFile;
@@ -410,7 +628,8 @@ void JEMCC_CloseZipFile(JNIEnv *env, JEMCC_ZipFile *zipFile) {
         return;
     }
 
-    /* Clean up the prescanned entry information */
+    /* Clean up the index and prescanned entry information */
+    freeZipIndex(zFile);
     if (zFile->entries != NULL) {
 #ifndef HAVE_MMAP
         for (i = 0; i < zFile->ezf.entryCount; i++) {
@@ -463,25 +682,35 @@ jint JEMCC_FindZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
                             const char *fileName, JEMCC_ZipFileEntry *zipEntry,
                             jboolean quietMode) {
     ZipFileData *zFile = (ZipFileData *) zipFile;
-    jint i, entryLen, offset, fileNameLength = strlen(fileName);
+    jint i, rc, fileNameLength = strlen(fileName);
     JEMCC_ZipFileEntry *ePtr;
+    ZipIndexEntry *idx;
+    juint hashCode;
 
-    /* Scan the entries list if we have one */
-    if (zFile->entries != NULL) {
-        ePtr = zFile->entries;
-        for (i = 0; i < zFile->ezf.entryCount; i++, ePtr++) {
+    /* Without prescan, the index is built on the first lookup */
+    if (zFile->index == NULL) {
+        rc = buildZipIndex(env, zFile, quietMode);
+        if (rc != JNI_OK) return rc;
+    }
+
+    /* Walk the hash chain for the name, matching the entry names */
+    hashCode = hashZipName((jbyte *) fileName, fileNameLength);
+    for (i = zFile->nameBuckets[hashCode & zFile->bucketMask]; i >= 0;
+                                                      i = idx->nameNext) {
+        idx = &(zFile->index[i]);
+        if (idx->nameHash != hashCode) continue;
+
+        if (zFile->entries != NULL) {
+            ePtr = &(zFile->entries[i]);
             if ((ePtr->fileNameLength == fileNameLength) &&
                 (memcmp(ePtr->fileName, fileName, fileNameLength) == 0)) {
                 *zipEntry = *ePtr;
                 return JNI_OK;
             }
-        }
-    } else {
-        offset = zFile->dirStartOffset;
-        for (i = 0; i < zFile->ezf.entryCount; i++) {
-            entryLen = readZipFileEntry(env, zFile, offset,
-                                        zipEntry, quietMode);
-            if (entryLen < 0) return entryLen;
+        } else {
+            rc = readZipFileEntry(env, zFile, idx->dirOffset,
+                                  zipEntry, quietMode);
+            if (rc < 0) return rc;
             if ((zipEntry->fileNameLength == fileNameLength) &&
                 (memcmp(zipEntry->fileName, fileName, fileNameLength) == 0)) {
                 return JNI_OK;
@@ -489,7 +718,6 @@ jint JEMCC_FindZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
 #ifndef HAVE_MMAP
             JEMCC_Free(zipEntry->fileName);
 #endif
-            offset += entryLen;
         }
     }
 
@@ -518,6 +746,134 @@ void JEMCC_ReleaseZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
 #endif
 }
 
+/**
+ * Scan the entries which are contained within a specific directory of an
+ * open Zip/Jar file (not including the entries of subdirectories, but
+ * including the subdirectory entries themselves, if present in the archive).
+ * Uses the directory index, so the cost is proportional to the number of
+ * entries in the directory, not the archive.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance to be scanned
+ *     dirName - the name of the directory to scan, including the trailing
+ *               separator (e.g. "java/lang/"), or "" for the root directory
+ *     entryCB - a function reference which is called for each entry in the
+ *               directory
+ *     userData - a caller provided data set which is included in the
+ *                scan arguments
+ *     quietMode - if JNI_TRUE, no exceptions other than OutOfMemory will
+ *                 be thrown (used for classloaders, etc.)
+ *
+ * Returns:
+ *     JNI_OK - the directory was found and the entries were scanned
+ *     JNI_ERR - an error occurred reading/parsing the Zip file directory
+ *               (an exception will have been thrown in the current
+ *               environment if quietMode is false)
+ *     JNI_ENOMEM - an memory allocation failed and an OutOfMemoryError has
+ *                  been thrown in the current environment
+ *     JNI_EINVAL - no entries exist in the requested directory
+ *
+ * Exceptions
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     OutOfMemoryError - a memory allocation for the file structures failed
+ */
+jint JEMCC_ScanZipFileDirectory(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                                const char *dirName,
+                                JEMCC_ZipEntryScanCB entryCB,
+                                void *userData, jboolean quietMode) {
+    ZipFileData *zFile = (ZipFileData *) zipFile;
+    juint hashCode, dirLength = strlen(dirName);
+    JEMCC_ZipFileEntry entry;
+    ZipDirectory *dir;
+    jint d, i, rc;
+
+    if (zFile->index == NULL) {
+        rc = buildZipIndex(env, zFile, quietMode);
+        if (rc != JNI_OK) return rc;
+    }
+
+    /* Locate the directory record */
+    hashCode = hashZipName((jbyte *) dirName, dirLength);
+    for (d = zFile->dirBuckets[hashCode & zFile->bucketMask]; d >= 0;
+                                                          d = dir->next) {
+        dir = &(zFile->dirs[d]);
+        if ((dir->nameHash == hashCode) && (dir->nameLength == dirLength) &&
+            (memcmp(dir->name, dirName, dirLength) == 0)) break;
+    }
+    if (d < 0) return JNI_EINVAL;
+
+    /* And walk the associated entries (released after each callback) */
+    for (i = dir->firstEntry; i >= 0; i = zFile->index[i].dirNext) {
+        if (zFile->entries != NULL) {
+            entry = zFile->entries[i];
+        } else {
+            rc = readZipFileEntry(env, zFile, zFile->index[i].dirOffset,
+                                  &entry, quietMode);
+            if (rc < 0) return rc;
+        }
+        rc = (*entryCB)(env, zipFile, &entry, userData);
+        JEMCC_ReleaseZipFileEntry(env, zipFile, &entry);
+        if (rc != JNI_OK) break;
+    }
+
+    return JNI_OK;
+}
+
+/**
+ * Scan all of the entries of an open Zip/Jar file, in archive order
+ * (including directory entries, if present in the archive).  Unlike the
+ * directory scan above, this does not require (or build) the name index.
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance to be scanned
+ *     entryCB - a function reference which is called for each entry in the
+ *               archive
+ *     userData - a caller provided data set which is included in the
+ *                scan arguments
+ *     quietMode - if JNI_TRUE, no exceptions other than OutOfMemory will
+ *                 be thrown (used for classloaders, etc.)
+ *
+ * Returns:
+ *     JNI_OK - the entries were scanned (or the callback terminated the scan)
+ *     JNI_ERR - an error occurred reading/parsing the Zip file directory
+ *               (an exception will have been thrown in the current
+ *               environment if quietMode is false)
+ *     JNI_ENOMEM - an memory allocation failed and an OutOfMemoryError has
+ *                  been thrown in the current environment
+ *
+ * Exceptions
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     OutOfMemoryError - a memory allocation for the file structures failed
+ */
+jint JEMCC_ScanZipFileEntries(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                              JEMCC_ZipEntryScanCB entryCB,
+                              void *userData, jboolean quietMode) {
+    ZipFileData *zFile = (ZipFileData *) zipFile;
+    jint i, rc, entryLen, offset = zFile->dirStartOffset;
+    JEMCC_ZipFileEntry entry;
+
+    for (i = 0; i < zFile->ezf.entryCount; i++) {
+        if (zFile->entries != NULL) {
+            entry = zFile->entries[i];
+        } else {
+            entryLen = readZipFileEntry(env, zFile, offset, &entry, quietMode);
+            if (entryLen < 0) return entryLen;
+            offset += entryLen;
+        }
+        rc = (*entryCB)(env, zipFile, &entry, userData);
+        JEMCC_ReleaseZipFileEntry(env, zipFile, &entry);
+        if (rc != JNI_OK) break;
+    }
+
+    return JNI_OK;
+}
+
 /**
  * Validate a zip file entry.  Cross checks the size, crc and other
  * information and updates the local extra field data information.
@@ -536,6 +892,142 @@ static char *JEM_CheckZipFileEntry(JEMCC_ZipFileEntry *zipEntry,
     return NULL;
 }
 
+/**
+ * Locate the raw (possibly compressed) data of a Zip file entry, validating
+ * the local header information.  For mapped files, this returns a pointer
+ * to the data within the mapped region.  Otherwise, the data (and one
+ * trailing byte for zlib) is read into the provided buffer, which must be
+ * at least compressedSize + 1 bytes long.  Returns NULL if the header was
+ * invalid or the read failed (an exception will be thrown in the current
+ * environment).
+ */
+static jbyte *locateZipEntryData(JNIEnv *env, ZipFileData *zFile,
+                                 JEMCC_ZipFileEntry *zipEntry,
+                                 jbyte *readBuff) {
+    jbyte *inBuff;
+    char *errMsg;
+#ifndef HAVE_MMAP
+    jint offset = (jint) zipEntry->entryData;
+    jbyte checkBuff[30];
+#endif
+
+#ifdef HAVE_MMAP
+    inBuff = zipEntry->entryData;
+    errMsg = JEM_CheckZipFileEntry(zipEntry, inBuff);
+    if (ERROR_SWEEP(ES_DATA, errMsg != NULL)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL, "java.util.zip.ZipException",
+                                      NULL, errMsg);
+        return NULL;
+    }
+    inBuff += 30 + zipEntry->fileNameLength + zipEntry->extraFieldLength;
+#else
+    if (ERROR_SWEEP(ES_DATA, lseek(zFile->fd, offset, SEEK_SET) < 0)) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, NULL,
+                                   "Zip file seek failed");
+        return NULL; 
+    }
+    if (readFromFile(env, zFile->fd, checkBuff, 30, JNI_FALSE) != JNI_OK) {
+        return NULL;
+    }
+    errMsg = JEM_CheckZipFileEntry(zipEntry, checkBuff);
+    if (ERROR_SWEEP(ES_DATA, errMsg != NULL)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL, "java.util.zip.ZipException",
+                                      NULL, errMsg);
+        return NULL;
+    }
+
+    offset += 30 + zipEntry->fileNameLength + zipEntry->extraFieldLength;
+    if (ERROR_SWEEP(ES_DATA, lseek(zFile->fd, offset, SEEK_SET) < 0)) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, NULL,
+                                   "Zip file seek failed");
+        return NULL; 
+    }
+    inBuff = readBuff;
+    if (readFromFile(env, zFile->fd, inBuff, zipEntry->compressedSize + 1, 
+                     JNI_FALSE) != JNI_OK) {
+        return NULL;
+    }
+#endif
+
+    return inBuff;
+}
+
+/**
+ * Inflate the raw data of a deflated Zip file entry into the provided
+ * buffer (sized for the uncompressed contents) and verify the checksum.
+ * Note that the input must have one readable byte beyond the compressed
+ * data.  Returns JNI_OK if the entry was inflated successfully, JNI_ERR
+ * otherwise (an exception will be thrown in the current environment).
+ */
+static jint inflateZipEntry(JNIEnv *env, JEMCC_ZipFileEntry *zipEntry,
+                            jbyte *inBuff, jbyte *outBuff) {
+    z_stream inflateStream;
+    juint checksum;
+    jint rc;
+
+    inflateStream.zalloc = NULL;
+    inflateStream.zfree = NULL;
+    inflateStream.opaque = NULL;
+    rc = inflateInit2(&inflateStream, -MAX_WBITS);
+    if (ERROR_SWEEP(ES_MEM, rc == Z_MEM_ERROR)) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_OutOfMemoryError,
+                                   NULL, NULL);
+        (void) inflateEnd(&inflateStream);
+        return JNI_ERR;
+    }
+    if (ERROR_SWEEP(ES_DATA, rc != Z_OK)) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError, NULL,
+                                   (inflateStream.msg != NULL) ?
+                                       inflateStream.msg :
+                                       "Zlib inflate init failed");
+        (void) inflateEnd(&inflateStream);
+        return JNI_ERR;
+    }
+
+    /* Strange glitch, zlib needs one extra input byte for Z_FINISH */
+    inflateStream.next_in = inBuff;
+    inflateStream.avail_in = zipEntry->compressedSize + 1;
+    inflateStream.next_out = outBuff;
+    inflateStream.avail_out = zipEntry->uncompressedSize;
+    rc = inflate(&inflateStream, Z_FINISH);
+    if (ERROR_SWEEP(ES_MEM, rc == Z_MEM_ERROR)) {
+        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_OutOfMemoryError,
+                                   NULL, NULL);
+        (void) inflateEnd(&inflateStream);
+        return JNI_ERR;
+    }
+    if (ERROR_SWEEP(ES_DATA, rc != Z_STREAM_END)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL,
+                                      "java.util.zip.ZipException",
+                                      NULL, "Invalid data to inflate");
+        (void) inflateEnd(&inflateStream);
+        return JNI_ERR;
+    }
+    checksum = (juint) crc32((uLong) 0, NULL, 0);
+    checksum = (juint) crc32((uLong) checksum, outBuff, 
+                             zipEntry->uncompressedSize);
+    if (ERROR_SWEEP(ES_DATA, checksum != zipEntry->crc32)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL,
+                                      "java.util.zip.ZipException",
+                                      NULL, "Corrupt Zip entry data");
+        (void) inflateEnd(&inflateStream);
+        return JNI_ERR;
+    }
+
+    rc = inflateEnd(&inflateStream);
+    if (ERROR_SWEEP(ES_DATA, rc != Z_OK)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL,
+                                      "java.util.zip.ZipException",
+                                      NULL,
+                                      (inflateStream.msg != NULL) ?
+                                         inflateStream.msg :
+                                         "Zlib close failed (corrupt)");
+        return JNI_ERR;
+    }
+
+    return JNI_OK;
+}
+
 /**
  * Load the contents of a Zip file entry (fully inflated if required).
  * NOTE: this method does not allow for exception suppression - if a Zip
@@ -561,15 +1053,10 @@ static char *JEM_CheckZipFileEntry(JEMCC_ZipFileEntry *zipEntry,
  */
 jbyte *JEMCC_ReadZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
                               JEMCC_ZipFileEntry *zipEntry) {
+    ZipFileData *zFile = (ZipFileData *) zipFile;
     jbyte *inBuff, *outBuff;
-    z_stream inflateStream;
-    char *errMsg;
-    juint checksum;
-    jint rc;
 #ifndef HAVE_MMAP
-    ZipFileData *zFile = (ZipFileData *) zipFile;
-    jint offset = (jint) zipEntry->entryData;
-    jbyte checkBuff[30];
+    jbyte *readBuff;
 #endif
 
     /* Watch for zero length entries */
@@ -585,41 +1072,14 @@ jbyte *JEMCC_ReadZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
 
     /* Move to or read the entry contents */
 #ifdef HAVE_MMAP
-    inBuff = zipEntry->entryData;
-    errMsg = JEM_CheckZipFileEntry(zipEntry, inBuff);
-    if (ERROR_SWEEP(ES_DATA, errMsg != NULL)) {
-        JEMCC_ThrowStdThrowableByName(env, NULL, "java.util.zip.ZipException",
-                                      NULL, errMsg);
-        return NULL;
-    }
-    inBuff += 30 + zipEntry->fileNameLength + zipEntry->extraFieldLength;
-#else
-    if (ERROR_SWEEP(ES_DATA, lseek(zFile->fd, offset, SEEK_SET) < 0)) {
-        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, NULL,
-                                   "Zip file seek failed");
-        return NULL; 
-    }
-    if (readFromFile(env, zFile->fd, checkBuff, 30, JNI_FALSE) != JNI_OK) {
-        return NULL;
-    }
-    errMsg = JEM_CheckZipFileEntry(zipEntry, checkBuff);
-    if (ERROR_SWEEP(ES_DATA, errMsg != NULL)) {
-        JEMCC_ThrowStdThrowableByName(env, NULL, "java.util.zip.ZipException",
-                                      NULL, errMsg);
-        return NULL;
-    }
-
-    offset += 30 + zipEntry->fileNameLength + zipEntry->extraFieldLength;
-    if (ERROR_SWEEP(ES_DATA, lseek(zFile->fd, offset, SEEK_SET) < 0)) {
-        JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_IOException, NULL,
-                                   "Zip file seek failed");
-        return NULL; 
-    }
-    inBuff = (jbyte *) JEMCC_Malloc(env, zipEntry->compressedSize + 1);
+    inBuff = locateZipEntryData(env, zFile, zipEntry, NULL);
     if (inBuff == NULL) return NULL;
-    if (readFromFile(env, zFile->fd, inBuff, zipEntry->compressedSize + 1, 
-                     JNI_FALSE) != JNI_OK) {
-        JEMCC_Free(inBuff);
+#else
+    readBuff = (jbyte *) JEMCC_Malloc(env, zipEntry->compressedSize + 1);
+    if (readBuff == NULL) return NULL;
+    inBuff = locateZipEntryData(env, zFile, zipEntry, readBuff);
+    if (inBuff == NULL) {
+        JEMCC_Free(readBuff);
         return NULL;
     }
 #endif
@@ -637,87 +1097,16 @@ jbyte *JEMCC_ReadZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
             return inBuff;
 #endif
         case Z_DEFLATED:
-            inflateStream.zalloc = NULL;
-            inflateStream.zfree = NULL;
-            inflateStream.opaque = NULL;
-            rc = inflateInit2(&inflateStream, -MAX_WBITS);
-            if (ERROR_SWEEP(ES_MEM, rc == Z_MEM_ERROR)) {
-                JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_OutOfMemoryError,
-                                           NULL, NULL);
-#ifndef HAVE_MMAP
-                JEMCC_Free(inBuff);
-#endif
-                (void) inflateEnd(&inflateStream);
-                return NULL;
-            }
-            if (ERROR_SWEEP(ES_DATA, rc != Z_OK)) {
-                JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_InternalError, NULL,
-                                           (inflateStream.msg != NULL) ?
-                                               inflateStream.msg :
-                                               "Zlib inflate init failed");
-#ifndef HAVE_MMAP
-                JEMCC_Free(inBuff);
-#endif
-                (void) inflateEnd(&inflateStream);
-                return NULL;
-            }
             outBuff = (jbyte *) JEMCC_Malloc(env, zipEntry->uncompressedSize);
-            if (outBuff == NULL) {
-#ifndef HAVE_MMAP
-                JEMCC_Free(inBuff);
-#endif
-                (void) inflateEnd(&inflateStream);
-                return NULL;
+            if ((outBuff != NULL) &&
+                    (inflateZipEntry(env, zipEntry, 
+                                     inBuff, outBuff) != JNI_OK)) {
+                JEMCC_Free(outBuff);
+                outBuff = NULL;
             }
-
-            /* Strange glitch, zlib needs one extra input byte for Z_FINISH */
-            inflateStream.next_in = inBuff;
-            inflateStream.avail_in = zipEntry->compressedSize + 1;
-            inflateStream.next_out = outBuff;
-            inflateStream.avail_out = zipEntry->uncompressedSize;
-            rc = inflate(&inflateStream, Z_FINISH);
 #ifndef HAVE_MMAP
             JEMCC_Free(inBuff);
 #endif
-            if (ERROR_SWEEP(ES_MEM, rc == Z_MEM_ERROR)) {
-                JEMCC_ThrowStdThrowableIdx(env, JEMCC_Class_OutOfMemoryError,
-                                           NULL, NULL);
-                (void) inflateEnd(&inflateStream);
-                JEMCC_Free(outBuff);
-                return NULL;
-            }
-            if (ERROR_SWEEP(ES_DATA, rc != Z_STREAM_END)) {
-                JEMCC_ThrowStdThrowableByName(env, NULL,
-                                              "java.util.zip.ZipException",
-                                              NULL, "Invalid data to inflate");
-                (void) inflateEnd(&inflateStream);
-                JEMCC_Free(outBuff);
-                return NULL;
-            }
-            checksum = (juint) crc32((uLong) 0, NULL, 0);
-            checksum = (juint) crc32((uLong) checksum, outBuff, 
-                                     zipEntry->uncompressedSize);
-            if (ERROR_SWEEP(ES_DATA, checksum != zipEntry->crc32)) {
-                JEMCC_ThrowStdThrowableByName(env, NULL,
-                                              "java.util.zip.ZipException",
-                                              NULL, "Corrupt Zip entry data");
-                (void) inflateEnd(&inflateStream);
-                JEMCC_Free(outBuff);
-                return NULL;
-            }
-
-            rc = inflateEnd(&inflateStream);
-            if (ERROR_SWEEP(ES_DATA, rc != Z_OK)) {
-                JEMCC_ThrowStdThrowableByName(env, NULL,
-                                              "java.util.zip.ZipException",
-                                              NULL,
-                                              (inflateStream.msg != NULL) ?
-                                                 inflateStream.msg :
-                                                 "Zlib close failed (corrupt)");
-                JEMCC_Free(outBuff);
-                return NULL;
-            }
-
             return outBuff;
     }
 
@@ -730,6 +1119,94 @@ jbyte *JEMCC_ReadZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
     return NULL;
 }
 
+/**
+ * Obtain the contents of a Zip file entry without allocating a copy for
+ * the caller.  Stored (uncompressed) entries of a mapped Zip file are
+ * returned directly from the mapped region, and remain valid until the
+ * Zip file is closed.  All other entries are inflated/read into the
+ * scratch buffer of the environment, which is only valid until the next
+ * use of that buffer (the caller must copy anything to be retained).
+ *
+ * Parameters:
+ *     env - the VM environment which is currently in context
+ *     zipFile - the Zip/Jar file instance from which the entry originated
+ *     zipEntry - the Zip/Jar file entry to read the contents of
+ *     isMapped - a reference through which JNI_TRUE is returned if the
+ *                contents are in the persistent mapped region, JNI_FALSE
+ *                if in the environment scratch buffer
+ *
+ * Returns:
+ *     The data contents of the requested entry (not to be freed or
+ *     modified by the caller) or NULL if a typing/inflation error
+ *     occurred (an exception will be thrown in the current environment).
+ *
+ * Exceptions:
+ *     ZipException - a Zipfile specific error occurred (invalid signature,
+ *                    record information, etc.)
+ *     IOException - a general file access exception occurred
+ *     InternalError - an unexpected zlib library error occurred
+ *     OutOfMemoryError - a memory allocation for the scratch buffer failed
+ */
+jbyte *JEM_MapZipFileEntry(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                           JEMCC_ZipFileEntry *zipEntry, jboolean *isMapped) {
+    ZipFileData *zFile = (ZipFileData *) zipFile;
+    jbyte *inBuff, *outBuff;
+
+    *isMapped = JNI_FALSE;
+
+    /* Watch for zero length entries and unknown formats */
+    if (zipEntry->compressedSize == 0) {
+        if (zipEntry->uncompressedSize == 0) {
+            return JEM_EnvScratchBuffer(env, 1);
+        }
+        JEMCC_ThrowStdThrowableByName(env, NULL,
+                                      "java.util.zip.ZipException", NULL,
+                                      "Invalid Zip entry length");
+        return NULL;
+    }
+    if ((zipEntry->compressionMethod != 0) &&
+            (zipEntry->compressionMethod != Z_DEFLATED)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL, "java.util.zip.ZipException",
+                                      NULL, "Unsupported Zip entry format");
+        return NULL;
+    }
+    if ((zipEntry->compressionMethod == 0) &&
+            (zipEntry->compressedSize != zipEntry->uncompressedSize)) {
+        JEMCC_ThrowStdThrowableByName(env, NULL,
+                                      "java.util.zip.ZipException", NULL,
+                                      "Invalid Zip entry length");
+        return NULL;
+    }
+
+#ifdef HAVE_MMAP
+    /* Stored entries are used directly from the mapped region */
+    inBuff = locateZipEntryData(env, zFile, zipEntry, NULL);
+    if (inBuff == NULL) return NULL;
+    if (zipEntry->compressionMethod == 0) {
+        *isMapped = JNI_TRUE;
+        return inBuff;
+    }
+    outBuff = JEM_EnvScratchBuffer(env, zipEntry->uncompressedSize);
+    if (outBuff == NULL) return NULL;
+#else
+    /* Scratch holds the inflated contents, followed by the raw data */
+    if (zipEntry->compressionMethod == 0) {
+        outBuff = JEM_EnvScratchBuffer(env, zipEntry->compressedSize + 1);
+        if (outBuff == NULL) return NULL;
+        return locateZipEntryData(env, zFile, zipEntry, outBuff);
+    }
+    outBuff = JEM_EnvScratchBuffer(env, zipEntry->uncompressedSize +
+                                             zipEntry->compressedSize + 1);
+    if (outBuff == NULL) return NULL;
+    inBuff = locateZipEntryData(env, zFile, zipEntry, 
+                                outBuff + zipEntry->uncompressedSize);
+    if (inBuff == NULL) return NULL;
+#endif
+
+    if (inflateZipEntry(env, zipEntry, inBuff, outBuff) != JNI_OK) return NULL;
+    return outBuff;
+}
+
 /* Definition of the internal stream information */
 #define STRM_RD_SZ 8
 typedef struct ZipFileStreamData {
@@ -0,0 +1,271 @@
+/**
+ * JEMCC stress/benchmark program for the frame-local object allocation.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+#include "jnifunc.h"
+
+/* External elements from uvminit.c */
+extern JNIEnv *createTestEnv();
+extern void destroyTestEnv(JNIEnv *env);
+
+/* External elements from benchutil.c */
+extern long elapsedMillis(struct timeval *start);
+extern long peakRSS();
+
+/*
+ * Each method call allocates a sequence of small int arrays.  In the local
+ * case, the arrays are temporaries which are released with the frame
+ * region, in the escape case each array is stored into an object array
+ * held by the root frame and is promoted to the heap list.  The mixed case
+ * allocates temporaries but stores the last array of each call, which pins
+ * the region below it.
+ */
+
+/* Local variables: 0 - alloc count, 1 - holder array, 2 - index, 3 - temp */
+static jubyte localCode[] = {
+    0x03,             /*  0: iconst_0 */
+    0x3d,             /*  1: istore_2 */
+    0x1c,             /*  2: iload_2 */
+    0x1a,             /*  3: iload_0 */
+    0xa2, 0x00, 0x12, /*  4: if_icmpge 22 */
+    0x10, 0x10,       /*  7: bipush 16 */
+    0xbc, 0x0a,       /*  9: newarray int */
+    0x4e,             /* 11: astore_3 */
+    0x2d,             /* 12: aload_3 */
+    0x03,             /* 13: iconst_0 */
+    0x1c,             /* 14: iload_2 */
+    0x4f,             /* 15: iastore */
+    0x84, 0x02, 0x01, /* 16: iinc 2, 1 */
+    0xa7, 0xff, 0xef, /* 19: goto 2 */
+    0x1c,             /* 22: iload_2 */
+    0xac              /* 23: ireturn */
+};
+
+static jubyte escapeCode[] = {
+    0x03,             /*  0: iconst_0 */
+    0x3d,             /*  1: istore_2 */
+    0x1c,             /*  2: iload_2 */
+    0x1a,             /*  3: iload_0 */
+    0xa2, 0x00, 0x16, /*  4: if_icmpge 26 */
+    0x10, 0x10,       /*  7: bipush 16 */
+    0xbc, 0x0a,       /*  9: newarray int */
+    0x4e,             /* 11: astore_3 */
+    0x2b,             /* 12: aload_1 */
+    0x1c,             /* 13: iload_2 */
+    0x2d,             /* 14: aload_3 */
+    0x53,             /* 15: aastore */
+    0x2d,             /* 16: aload_3 */
+    0x03,             /* 17: iconst_0 */
+    0x1c,             /* 18: iload_2 */
+    0x4f,             /* 19: iastore */
+    0x84, 0x02, 0x01, /* 20: iinc 2, 1 */
+    0xa7, 0xff, 0xeb, /* 23: goto 2 */
+    0x1c,             /* 26: iload_2 */
+    0xac              /* 27: ireturn */
+};
+
+static jubyte mixedCode[] = {
+    0x03,             /*  0: iconst_0 */
+    0x3d,             /*  1: istore_2 */
+    0x1c,             /*  2: iload_2 */
+    0x1a,             /*  3: iload_0 */
+    0xa2, 0x00, 0x12, /*  4: if_icmpge 22 */
+    0x10, 0x10,       /*  7: bipush 16 */
+    0xbc, 0x0a,       /*  9: newarray int */
+    0x4e,             /* 11: astore_3 */
+    0x2d,             /* 12: aload_3 */
+    0x03,             /* 13: iconst_0 */
+    0x1c,             /* 14: iload_2 */
+    0x4f,             /* 15: iastore */
+    0x84, 0x02, 0x01, /* 16: iinc 2, 1 */
+    0xa7, 0xff, 0xef, /* 19: goto 2 */
+    0x2b,             /* 22: aload_1 */
+    0x03,             /* 23: iconst_0 */
+    0x2d,             /* 24: aload_3 */
+    0x53,             /* 25: aastore */
+    0x1c,             /* 26: iload_2 */
+    0xac              /* 27: ireturn */
+};
+
+/* Run the given bytecode block through the interpreter, with arguments */
+static jint runCode(JEM_JNIEnv *env, JEM_ClassMethodData *method,
+                    jint count, JEMCC_Object *array) {
+    JEM_BCMethod *bcMethod = method->method.bcMethod;
+    JEMCC_VMFrame *frame;
+
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 0,
+                            bcMethod->maxLocals, bcMethod->maxStack);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Error: unable to create benchmark frame\n");
+        exit(1);
+    }
+    ((JEM_VMFrameExt *) frame)->currentMethod = method;
+    JEMCC_STORE_INT(frame, 0, count);
+    JEMCC_STORE_OBJECT(frame, 1, array);
+
+    JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+    if (env->pendingException != NULL) {
+        (void) fprintf(stderr, "Error: unexpected benchmark exception\n");
+        exit(1);
+    }
+
+    return env->nativeReturnValue.intVal;
+}
+
+/* Time a sequence of method calls, reporting throughput and peak memory */
+static void runPhase(JEM_JNIEnv *env, const char *name,
+                     JEM_ClassMethodData *method, jint callCount,
+                     jint allocCount, JEMCC_Object *holder) {
+    struct timeval start;
+    long elapsed;
+    jint i;
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < callCount; i++) {
+        if (runCode(env, method, allocCount, holder) != allocCount) {
+            (void) fprintf(stderr, "Error: %s method returned bad count\n",
+                                   name);
+            exit(1);
+        }
+    }
+    elapsed = elapsedMillis(&start);
+    if (elapsed <= 0) elapsed = 1;
+
+    (void) fprintf(stderr, "%s allocation (%i x %i arrays): %li ms, "
+                           "%li allocs/ms, peak RSS %li KB\n",
+                           name, callCount, allocCount, elapsed,
+                           ((long) callCount * allocCount) / elapsed,
+                           peakRSS());
+}
+
+/* Main program will time the various allocation sequences */
+int main(int argc, char *argv[]) {
+    JEM_ClassMethodData localMethod, escapeMethod, mixedMethod;
+    JEM_BCMethod localBCMethod, escapeBCMethod, mixedBCMethod;
+    jint callCount = 100000, allocCount = 100;
+    JEMCC_Object *holder;
+    JEM_JNIEnv *env;
+    long baseRSS;
+
+    /* Allow for alternate call counts for quick runs */
+    if (argc > 1) callCount = atoi(argv[1]);
+    if (callCount <= 0) callCount = 1;
+
+    /* Initialize operating machines */
+    if ((env = (JEM_JNIEnv *) createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Fatal test initialization error\n");
+        exit(1);
+    }
+    if (JEM_InitializeVMClasses((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Fatal core initialization error\n");
+        exit(1);
+    }
+
+    /* Build the bytecode methods for the benchmark sequences */
+    (void) memset(&localBCMethod, 0, sizeof(JEM_BCMethod));
+    localBCMethod.maxStack = 4;
+    localBCMethod.maxLocals = 4;
+    localBCMethod.codeLength = sizeof(localCode);
+    localBCMethod.code = localCode;
+    (void) memset(&localMethod, 0, sizeof(JEM_ClassMethodData));
+    localMethod.method.bcMethod = &localBCMethod;
+    localMethod.name = "localBench";
+    localMethod.descriptorStr = "(I[Ljava/lang/Object;)I";
+
+    (void) memset(&escapeBCMethod, 0, sizeof(JEM_BCMethod));
+    escapeBCMethod.maxStack = 4;
+    escapeBCMethod.maxLocals = 4;
+    escapeBCMethod.codeLength = sizeof(escapeCode);
+    escapeBCMethod.code = escapeCode;
+    (void) memset(&escapeMethod, 0, sizeof(JEM_ClassMethodData));
+    escapeMethod.method.bcMethod = &escapeBCMethod;
+    escapeMethod.name = "escapeBench";
+    escapeMethod.descriptorStr = "(I[Ljava/lang/Object;)I";
+
+    (void) memset(&mixedBCMethod, 0, sizeof(JEM_BCMethod));
+    mixedBCMethod.maxStack = 4;
+    mixedBCMethod.maxLocals = 4;
+    mixedBCMethod.codeLength = sizeof(mixedCode);
+    mixedBCMethod.code = mixedCode;
+    (void) memset(&mixedMethod, 0, sizeof(JEM_ClassMethodData));
+    mixedMethod.method.bcMethod = &mixedBCMethod;
+    mixedMethod.name = "mixedBench";
+    mixedMethod.descriptorStr = "(I[Ljava/lang/Object;)I";
+
+    holder = (JEMCC_Object *) JEMCC_NewObjectArray((JNIEnv *) env, allocCount,
+                                     (jclass) VM_CLASS(JEMCC_Class_Object),
+                                     NULL);
+    if (holder == NULL) {
+        (void) fprintf(stderr, "Could not create benchmark holder array\n");
+        exit(1);
+    }
+    baseRSS = peakRSS();
+    (void) fprintf(stderr, "Initial peak RSS %li KB\n", baseRSS);
+
+    /*
+     * Local temporaries are reclaimed with each frame, so the peak RSS
+     * must remain bounded by a single region regardless of the call count.
+     */
+    runPhase(env, "Local", &localMethod, callCount, allocCount, NULL);
+    if (peakRSS() - baseRSS > 4096) {
+        (void) fprintf(stderr, "Error: local allocations were not reclaimed\n");
+        exit(1);
+    }
+
+    /*
+     * The temporaries below each escaping array are recovered through the
+     * free lists, so only the escaped arrays (collected once they pass the
+     * collection threshold) may add to the peak RSS.
+     */
+    baseRSS = peakRSS();
+    runPhase(env, "Mixed", &mixedMethod, callCount, allocCount, holder);
+    if (peakRSS() - baseRSS > 20480) {
+        (void) fprintf(stderr, "Error: pinned temporaries were not "
+                               "reclaimed\n");
+        exit(1);
+    }
+
+    /* Escaped objects are promoted and retained (a tenth of the calls) */
+    runPhase(env, "Escaping", &escapeMethod, callCount / 10, allocCount,
+             holder);
+
+    /* Clean up the test environment (objects are in the allocation blocks) */
+    destroyTestEnv((JNIEnv *) env);
+
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+jint JEM_CallForeignFunction(JNIEnv *env, JEMCC_Object *thisObj, void *fnRef,
+                             union JEM_DescriptorInfo *fnDesc,
+                             JEMCC_ReturnValue *argList,
+                             JEMCC_ReturnValue *retVal) {
+    return JNI_OK;
+}
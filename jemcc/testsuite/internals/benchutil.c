@@ -0,0 +1,61 @@
+/**
+ * Common timing/resource support methods for the JEMCC benchmark programs.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+
+/* The benchmarks always run as normal (no error sweeps) */
+#ifdef ENABLE_ERRORSWEEP
+int JEM_CheckErrorSweep(int sweepType) {
+    return JNI_FALSE;
+}
+#endif
+
+/* Return the elapsed milliseconds since the given time marker */
+long elapsedMillis(struct timeval *start) {
+    struct timeval now;
+
+    (void) gettimeofday(&now, NULL);
+    return (now.tv_sec - start->tv_sec) * 1000 +
+                  (now.tv_usec - start->tv_usec) / 1000;
+}
+
+/* Return the elapsed microseconds since the given time marker */
+long elapsedMicros(struct timeval *start) {
+    struct timeval now;
+
+    (void) gettimeofday(&now, NULL);
+    return (now.tv_sec - start->tv_sec) * 1000000 +
+                  (now.tv_usec - start->tv_usec);
+}
+
+/* Return the peak resident set size of the process (in kilobytes) */
+long peakRSS() {
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,405 @@
+/**
+ * JEMCC test program to test the persistent class data archive.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/stat.h>
+#include <utime.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+
+/* External elements from uvminit.c */
+extern JNIEnv *createTestEnv();
+extern void destroyTestEnv(JNIEnv *env);
+
+/* Test flags/data values for condition setups and tests */
+#ifdef ENABLE_ERRORSWEEP
+int JEM_CheckErrorSweep(int sweepType) {
+    /* No error sweeps here, corruption is tested directly */
+    return JNI_FALSE;
+}
+#endif
+
+/*
+ * The test Jar (zipdata/archive.zip) contains the single class
+ * test/race/B.class (stored).  The archivemod.zip variant is identical in
+ * size, but the class differs in one byte (different CRC).  The tests run
+ * against a working copy of the Jar, as the file stamp is modified.
+ */
+#define TEST_JAR "archtest.zip"
+#define TEST_ARCHIVE "archtest.jsa"
+#define TEST_CORRUPT "archbad.jsa"
+#define TEST_CLASS "test.race.B"
+#define TEST_CLASS_FILE "test/race/B.class"
+
+/*
+ * Header fields (juint words following the 8 byte magic) of the archive,
+ * see JEM_ArchiveHeader in classarchive.c.
+ */
+#define HDR_IMAGE_LENGTH 5
+#define HDR_SOURCE_COUNT 6
+#define HDR_CLASS_COUNT 8
+#define HDR_CLASS_OFFSET 9
+#define HDR_BLOB_OFFSET 10
+#define HDR_BLOB_LENGTH 11
+
+/* Class directory fields (juint words), see JEM_ArchiveClass */
+#define CLS_NAME_OFFSET 0
+#define CLS_SOURCE_INDEX 1
+#define CLS_DATA_OFFSET 3
+
+/* Class data fields (jint words), see JEM_ArchiveClassData */
+#define DATA_POOL_COUNT 3
+#define DATA_POOL_OFFSET 9
+#define DATA_MEMBERS_OFFSET 11
+
+static void fail(const char *msg) {
+    (void) fprintf(stderr, "Error: %s\n", msg);
+    exit(1);
+}
+
+/* Read an entire file, returning the allocated contents */
+static jbyte *readFile(const char *fileName, jint *length) {
+    jbyte *buff;
+    FILE *fp;
+
+    *length = JEMCC_GetFileSize(fileName);
+    if ((*length <= 0) ||
+        ((buff = (jbyte *) calloc(1, *length)) == NULL)) {
+        fail("unable to size/allocate test file");
+    }
+    if (((fp = fopen(fileName, "rb")) == NULL) ||
+        (fread(buff, 1, *length, fp) != (size_t) *length)) {
+        fail("unable to read test file");
+    }
+    (void) fclose(fp);
+
+    return buff;
+}
+
+/* Write the given (possibly partial) contents to a file */
+static void writeFile(const char *fileName, jbyte *buff, jint length) {
+    FILE *fp;
+
+    if (((fp = fopen(fileName, "wb")) == NULL) ||
+        (fwrite(buff, 1, length, fp) != (size_t) length) ||
+        (fclose(fp) != 0)) {
+        fail("unable to write test file");
+    }
+}
+
+/* Install a Jar as the working copy and (re)build the classpath */
+static void installJar(JNIEnv *env, const char *srcName, time_t modTime) {
+    JEM_JavaVM *jvm = ((JEM_JNIEnv *) env)->parentVM;
+    struct utimbuf times;
+    jbyte *buff;
+    jint length;
+
+    buff = readFile(srcName, &length);
+    writeFile(TEST_JAR, buff, length);
+    free(buff);
+    if (modTime != 0) {
+        times.actime = times.modtime = modTime;
+        if (utime(TEST_JAR, &times) != 0) fail("unable to set Jar time");
+    }
+
+    JEM_DestroyPathList(env, &(jvm->classPath));
+    if (JEM_ParsePathList(env, &(jvm->classPath), TEST_JAR,
+                          JNI_TRUE) != JNI_OK) {
+        fail("unable to parse test classpath");
+    }
+}
+
+/* Verify that the archived class data is identical to the parsed data */
+static void compareAttributes(struct ATTRIBUTE_info *a,
+                              struct ATTRIBUTE_info *b, jsize count) {
+    jint i;
+
+    for (i = 0; i < count; i++) {
+        if ((a[i].attributeNameIndex != b[i].attributeNameIndex) ||
+            (a[i].attributeLength != b[i].attributeLength) ||
+            (memcmp(a[i].info, b[i].info, a[i].attributeLength) != 0)) {
+            fail("archived attribute mismatch");
+        }
+    }
+}
+
+static void compareClassData(JEM_ParsedClassData *pData,
+                             JEM_ParsedClassData *aData) {
+    JEM_ConstantPoolData *pEntry, *aEntry;
+    JEM_ParsedFieldData *pMember, *aMember;
+    jint i;
+
+    if ((aData->isArchived != JNI_TRUE) ||
+        (aData->classAccessFlags != pData->classAccessFlags) ||
+        (aData->classIndex != pData->classIndex) ||
+        (aData->superClassIndex != pData->superClassIndex) ||
+        (aData->constantPoolCount != pData->constantPoolCount) ||
+        (aData->interfacesCount != pData->interfacesCount) ||
+        (aData->fieldsCount != pData->fieldsCount) ||
+        (aData->methodsCount != pData->methodsCount) ||
+        (aData->attributesCount != pData->attributesCount)) {
+        fail("archived class header mismatch");
+    }
+    for (i = 0; i < pData->constantPoolCount - 1; i++) {
+        pEntry = &(pData->constantPool[i]);
+        aEntry = &(aData->constantPool[i]);
+        if (pEntry->generic.tag != aEntry->generic.tag) {
+            fail("archived constant pool tag mismatch");
+        }
+        if (pEntry->generic.tag == CONSTANT_Utf8) {
+            if (strcmp((char *) pEntry->utf8_info.bytes,
+                       (char *) aEntry->utf8_info.bytes) != 0) {
+                fail("archived utf8 constant mismatch");
+            }
+        } else if (memcmp(pEntry, aEntry,
+                          sizeof(JEM_ConstantPoolData)) != 0) {
+            fail("archived constant pool entry mismatch");
+        }
+    }
+    if ((pData->interfacesCount != 0) &&
+        (memcmp(pData->interfaces, aData->interfaces,
+                pData->interfacesCount * sizeof(jint)) != 0)) {
+        fail("archived interfaces mismatch");
+    }
+    for (i = 0; i < pData->fieldsCount + pData->methodsCount; i++) {
+        pMember = (i < pData->fieldsCount) ? &(pData->fields[i]) :
+                  (JEM_ParsedFieldData *)
+                          &(pData->methods[i - pData->fieldsCount]);
+        aMember = (i < aData->fieldsCount) ? &(aData->fields[i]) :
+                  (JEM_ParsedFieldData *)
+                          &(aData->methods[i - aData->fieldsCount]);
+        if ((pMember->accessFlags != aMember->accessFlags) ||
+            (pMember->nameIndex != aMember->nameIndex) ||
+            (pMember->descIndex != aMember->descIndex) ||
+            (pMember->attributesCount != aMember->attributesCount)) {
+            fail("archived member mismatch");
+        }
+        compareAttributes(pMember->attributes, aMember->attributes,
+                          pMember->attributesCount);
+    }
+    compareAttributes(pData->attributes, aData->attributes,
+                      pData->attributesCount);
+}
+
+/* Open the archive and attempt to obtain the test class */
+static jint openAndLoad(JNIEnv *env, const char *archiveName,
+                        JEM_ParsedClassData **aData) {
+    jint rc;
+
+    *aData = NULL;
+    rc = JEM_OpenClassArchive(env, archiveName);
+    if (rc != JNI_OK) return rc;
+    rc = JEM_GetArchivedClassData(env, TEST_CLASS, TEST_CLASS_FILE, aData);
+    if ((rc != JNI_OK) && (*aData != NULL)) fail("data returned on error");
+    return rc;
+}
+
+/* Write a corrupted copy of the archive (one juint word replaced) */
+static void corruptArchive(jbyte *image, jint length, juint wordOffset,
+                           juint value) {
+    jbyte *copy = (jbyte *) calloc(1, length);
+
+    if (copy == NULL) fail("unable to allocate corrupt archive");
+    (void) memcpy(copy, image, length);
+    *((juint *) (copy + wordOffset)) = value;
+    writeFile(TEST_CORRUPT, copy, length);
+    free(copy);
+}
+
+int main(int argc, char *argv[]) {
+    JNIEnv *env;
+    JEM_JavaVM *jvm;
+    JEM_ParsedClassData *pData, *aData;
+    jbyte *classData, *image;
+    juint *hdr, classOffset, blobOffset, dataOffset, dataBase;
+    jint classLength, length;
+    struct stat stBuff;
+    time_t jarTime;
+
+    /* Initialize operating machines */
+    if ((env = createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Fatal test env initialization error\n");
+        exit(1);
+    }
+    jvm = ((JEM_JNIEnv *) env)->parentVM;
+
+    /* Normal parse of the class from the (working copy of the) Jar */
+    installJar(env, "zipdata/archive.zip", 0);
+    if (stat(TEST_JAR, &stBuff) != 0) fail("unable to stat test Jar");
+    jarTime = stBuff.st_mtime;
+    if (JEM_ReadPathFileContents(env, &(jvm->classPath), TEST_CLASS_FILE,
+                                 &classData, &classLength) != JNI_OK) {
+        fail("unable to read test class from Jar");
+    }
+    pData = JEM_ParseClassData(env, classData, classLength, JNI_FALSE);
+    if (pData == NULL) fail("unable to parse test class");
+
+    /* Dump the archive (duplicate records are discarded on writing) */
+    (void) remove(TEST_ARCHIVE);
+    if (JEM_CreateClassArchive(env, TEST_ARCHIVE) != JNI_OK) {
+        fail("unable to create class archive");
+    }
+    JEM_RecordArchivedClassData(env, TEST_CLASS, TEST_CLASS_FILE, pData);
+    JEM_RecordArchivedClassData(env, TEST_CLASS, TEST_CLASS_FILE, pData);
+    JEM_RecordArchivedClassData(env, "no.such.Class", "no/such/Class.class",
+                                pData);
+    if (JEM_WriteClassArchive(env) != JNI_OK) {
+        fail("unable to write class archive");
+    }
+    image = readFile(TEST_ARCHIVE, &length);
+    hdr = (juint *) (image + 8);
+    if ((hdr[HDR_CLASS_COUNT] != 1) || (hdr[HDR_SOURCE_COUNT] != 1)) {
+        fail("unexpected archive directory counts");
+    }
+
+    /* Map the archive and compare against the normal parse */
+    if (openAndLoad(env, TEST_ARCHIVE, &aData) != JNI_OK) {
+        fail("unable to load class from archive");
+    }
+    compareClassData(pData, aData);
+    JEM_DestroyParsedClassData(aData);
+    if (JEM_GetArchivedClassData(env, "test.race.A", "test/race/A.class",
+                                 &aData) != JNI_EINVAL) {
+        fail("unexpected archive data for missing class");
+    }
+    JEM_CloseClassArchive(env);
+
+    /* Same Jar size and time, but the class CRC has changed */
+    installJar(env, "zipdata/archivemod.zip", jarTime);
+    if (openAndLoad(env, TEST_ARCHIVE, &aData) != JNI_EINVAL) {
+        fail("stale class (changed CRC) loaded from archive");
+    }
+    JEM_CloseClassArchive(env);
+
+    /* Original Jar contents, but modified (stale source) */
+    installJar(env, "zipdata/archive.zip", jarTime + 10);
+    if (openAndLoad(env, TEST_ARCHIVE, &aData) != JNI_EINVAL) {
+        fail("stale source Jar loaded from archive");
+    }
+    JEM_CloseClassArchive(env);
+
+    /* Restore the original and confirm that the archive is usable again */
+    installJar(env, "zipdata/archive.zip", jarTime);
+    if (openAndLoad(env, TEST_ARCHIVE, &aData) != JNI_OK) {
+        fail("unable to reload class from archive");
+    }
+    JEM_DestroyParsedClassData(aData);
+    JEM_CloseClassArchive(env);
+
+    /* Truncated archives are rejected */
+    writeFile(TEST_CORRUPT, image, length - 1);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("truncated archive was opened");
+    }
+    writeFile(TEST_CORRUPT, image, 20);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("truncated archive header was opened");
+    }
+
+    /* Table sizes which overflow the header offset checks */
+    classOffset = hdr[HDR_CLASS_OFFSET];
+    blobOffset = hdr[HDR_BLOB_OFFSET];
+    corruptArchive(image, length, 8 + HDR_CLASS_COUNT * sizeof(juint),
+                   0xFFFFFFFF / sizeof(juint));
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("overflowing class count was accepted");
+    }
+    corruptArchive(image, length, 8 + HDR_BLOB_LENGTH * sizeof(juint),
+                   0xFFFFFFFF - blobOffset + 1);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("overflowing blob length was accepted");
+    }
+    corruptArchive(image, length, 8 + HDR_IMAGE_LENGTH * sizeof(juint),
+                   length + 8);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("mismatched image length was accepted");
+    }
+
+    /* Class directory references outside of the blob/source table */
+    corruptArchive(image, length,
+                   classOffset + CLS_NAME_OFFSET * sizeof(juint),
+                   hdr[HDR_BLOB_LENGTH]);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("invalid class name offset was accepted");
+    }
+    corruptArchive(image, length,
+                   classOffset + CLS_SOURCE_INDEX * sizeof(juint), 1);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("invalid class source index was accepted");
+    }
+    corruptArchive(image, length,
+                   classOffset + CLS_DATA_OFFSET * sizeof(juint),
+                   hdr[HDR_BLOB_LENGTH] - 8);
+    if (JEM_OpenClassArchive(env, TEST_CORRUPT) != JNI_EINVAL) {
+        fail("invalid class data offset was accepted");
+    }
+
+    /* Class data references outside of the blob (rejected on loading) */
+    dataOffset = *((juint *) (image + classOffset +
+                              CLS_DATA_OFFSET * sizeof(juint)));
+    dataBase = blobOffset + dataOffset;
+    corruptArchive(image, length,
+                   dataBase + DATA_POOL_COUNT * sizeof(jint), 0);
+    if (openAndLoad(env, TEST_CORRUPT, &aData) != JNI_EINVAL) {
+        fail("empty constant pool count was accepted");
+    }
+    JEM_CloseClassArchive(env);
+    corruptArchive(image, length,
+                   dataBase + DATA_POOL_OFFSET * sizeof(jint),
+                   hdr[HDR_BLOB_LENGTH] - 8);
+    if (openAndLoad(env, TEST_CORRUPT, &aData) != JNI_EINVAL) {
+        fail("invalid constant pool offset was accepted");
+    }
+    JEM_CloseClassArchive(env);
+    corruptArchive(image, length,
+                   dataBase + DATA_MEMBERS_OFFSET * sizeof(jint),
+                   0xFFFFFFF8);
+    if (openAndLoad(env, TEST_CORRUPT, &aData) != JNI_EINVAL) {
+        fail("invalid member offset was accepted");
+    }
+    JEM_CloseClassArchive(env);
+
+    /* Clean up the mess */
+    free(image);
+    JEMCC_Free(classData);
+    JEM_DestroyParsedClassData(pData);
+    (void) remove(TEST_ARCHIVE);
+    (void) remove(TEST_CORRUPT);
+    (void) remove(TEST_JAR);
+    destroyTestEnv(env);
+
+    (void) fprintf(stderr, "All tests passed successfully\n");
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+jint JEM_CallForeignFunction(JNIEnv *env, JEMCC_Object *thisObj, void *fnRef,
+                             union JEM_DescriptorInfo *fnDesc,
+                             JEMCC_ReturnValue *argList,
+                             JEMCC_ReturnValue *retVal) {
+    return JNI_OK;
+}
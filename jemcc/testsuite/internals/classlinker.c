@@ -3554,7 +3554,8 @@ int main(int argc, char *argv[]) {
     for (i = 0; i < nErrTests; i++) {
         *exClassName = *exMsg = '\0';
         classData = JEM_ParseClassData(env, errClassTests[i].testData, 
-                                            errClassTests[i].testLength);
+                                            errClassTests[i].testLength,
+                                            JNI_FALSE);
         if (classData == NULL) {
             (void) fprintf(stderr, "Test %i: Fatal class parsing error:\n", i);
             (void) fprintf(stderr, "%s\n", exMsg);
@@ -3644,7 +3645,8 @@ void doValidScan() {
     /* Parse the ok dictionary set */
     for (i = 0; i < nOkTests; i++) {
         classData = JEM_ParseClassData(env, okClassTests[i].testData, 
-                                            okClassTests[i].testLength);
+                                            okClassTests[i].testLength,
+                                            JNI_FALSE);
         if (classData == NULL) {
             destroyTestEnv(env);
             return;
@@ -3676,6 +3678,13 @@ void JEMCC_Free(void *block) {
     free(block);
 }
 
+/* Collection safe regions are not tracked without the collector */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+}
+
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+}
+
 void JEMCC_ThrowStdThrowableIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
                                 JEMCC_Object *causeThrowable, const char *msg) {
     char *className = "unknown";
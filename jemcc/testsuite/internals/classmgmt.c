@@ -21,9 +21,11 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #include "jeminc.h"
+#include <sys/stat.h>
 
 /* Read the JNI/JEMCC internal details */
 #include "jem.h"
+#include "jnifunc.h"
 
 /* External elements from uvminit.c */
 extern JNIEnv *createTestEnv();
@@ -53,11 +55,11 @@ void destroyException(JNIEnv *env, JEMCC_Object *exception) {
     JEMCC_ThrowableData *exData = (JEMCC_ThrowableData *)
                              &(((JEMCC_ObjectExt *) exception)->objectData);
 
+    /* Object records are in the allocation blocks, only release data */
     if (exData->message != NULL) {
          JEMCC_Free(((JEMCC_ObjectExt *) (exData->message))->objectData);
-         JEMCC_Free(exData->message);
+         ((JEMCC_ObjectExt *) (exData->message))->objectData = NULL;
     }
-    JEMCC_Free(exception);
 }
 
 void checkException(JNIEnv *env, const char *checkClassName, 
@@ -175,7 +177,7 @@ void *classLoadRaceFn(JNIEnv *env, void *userArg) {
 
     if (userArg == (void *) 0) {
         /* Parse B, which delays on A resolution */
-        pData = JEM_ParseClassData(env, raceClassB, 181);
+        pData = JEM_ParseClassData(env, raceClassB, 181, JNI_FALSE);
         if (pData != NULL) {
             tstClass = JEM_DefineAndResolveClass(env,
                          ((JEM_JNIEnv *) env)->parentVM->systemClassLoader,
@@ -183,7 +185,7 @@ void *classLoadRaceFn(JNIEnv *env, void *userArg) {
         }
     } else {
         /* Parse C, which will wait on B resolution */
-        pData = JEM_ParseClassData(env, raceClassC, 181);
+        pData = JEM_ParseClassData(env, raceClassC, 181, JNI_FALSE);
         if (pData != NULL) {
             tstClass = JEM_DefineAndResolveClass(env,
                          ((JEM_JNIEnv *) env)->parentVM->systemClassLoader,
@@ -217,6 +219,404 @@ jint racePkgClassLoader(JNIEnv *env, JEMCC_Object *loader,
     return JNI_EINVAL;
 }
 
+/*
+ * Member resolution hierarchy: Derived extends Base and implements IfaceA
+ * and IfaceB (in that order).  Derived shadows the Base instance field,
+ * both interfaces define the CONST constant and Base defines a static CONST
+ * as well, the JVM sequence resolves Derived.CONST to IfaceA.
+ */
+static jint memberTestMethod(JNIEnv *env, JEMCC_VMFrame *frame,
+                             JEMCC_ReturnValue *retVal) {
+    return JEMCC_RET_VOID;
+}
+
+static JEMCC_FieldData ifaceAFields[] = {
+    { ACC_PUBLIC | ACC_STATIC | ACC_FINAL, "CONST", "I", -1 }
+};
+static JEMCC_FieldData ifaceBFields[] = {
+    { ACC_PUBLIC | ACC_STATIC | ACC_FINAL, "CONST", "I", -1 },
+    { ACC_PUBLIC | ACC_STATIC | ACC_FINAL, "ONLYB", "I", -1 }
+};
+static JEMCC_MethodData baseMethods[] = {
+    { ACC_PUBLIC, "baseMethod", "()V", memberTestMethod },
+    { ACC_PUBLIC, "overMethod", "()V", memberTestMethod },
+    { ACC_PUBLIC | ACC_STATIC, "statMethod", "()V", memberTestMethod }
+};
+static JEMCC_FieldData baseFields[] = {
+    { ACC_PUBLIC, "shadow", "I", -1 },
+    { ACC_PUBLIC, "baseOnly", "J", -1 },
+    { ACC_PUBLIC | ACC_STATIC, "CONST", "I", -1 }
+};
+static JEMCC_MethodData derivedMethods[] = {
+    { ACC_PUBLIC, "overMethod", "()V", memberTestMethod }
+};
+static JEMCC_FieldData derivedFields[] = {
+    { ACC_PUBLIC, "shadow", "I", -1 }
+};
+
+/* Confirm the owner of a member resolved through the JNI lookups */
+static void checkMember(JNIEnv *env, JEMCC_Class *owner,
+                        JEMCC_Class *expected, const char *tstName) {
+    if (((JEM_JNIEnv *) env)->pendingException != NULL) {
+        (void) fprintf(stderr, "Unexpected exception for %s\n", tstName);
+        exit(1);
+    }
+    if (owner != expected) {
+        (void) fprintf(stderr, "Incorrect member resolved for %s\n",
+                               tstName);
+        exit(1);
+    }
+}
+
+static void doMemberLookup(JNIEnv *env) {
+    JEMCC_Class *objClass, *ifaceA, *ifaceB, *base, *derived, *ifaces[2];
+    JEM_ClassMethodData *method;
+    JEM_ClassFieldData *field;
+
+    if (JEMCC_LocateClass(env, NULL, "java.lang.Object",
+                          JNI_FALSE, &objClass) != JNI_OK) {
+        (void) fprintf(stderr, "Unable to locate Object class\n");
+        exit(1);
+    }
+    if ((JEMCC_CreateStdClass(env, NULL, ACC_PUBLIC | ACC_INTERFACE,
+                              "jemcc.member.IfaceA", objClass, NULL, 0,
+                              NULL, 0, NULL, ifaceAFields, 1,
+                              NULL, 0, NULL, &ifaceA) != JNI_OK) ||
+        (JEMCC_CreateStdClass(env, NULL, ACC_PUBLIC | ACC_INTERFACE,
+                              "jemcc.member.IfaceB", objClass, NULL, 0,
+                              NULL, 0, NULL, ifaceBFields, 2,
+                              NULL, 0, NULL, &ifaceB) != JNI_OK) ||
+        (JEMCC_CreateStdClass(env, NULL, ACC_PUBLIC,
+                              "jemcc.member.Base", objClass, NULL, 0,
+                              baseMethods, 3, NULL, baseFields, 3,
+                              NULL, 0, NULL, &base) != JNI_OK)) {
+        (void) fprintf(stderr, "Unable to create member base classes\n");
+        exit(1);
+    }
+    ifaces[0] = ifaceA;
+    ifaces[1] = ifaceB;
+    if (JEMCC_CreateStdClass(env, NULL, ACC_PUBLIC,
+                             "jemcc.member.Derived", base, ifaces, 2,
+                             derivedMethods, 1, NULL, derivedFields, 1,
+                             NULL, 0, NULL, &derived) != JNI_OK) {
+        (void) fprintf(stderr, "Unable to create member derived class\n");
+        exit(1);
+    }
+
+    /* Shadowed and inherited instance fields */
+    field = (JEM_ClassFieldData *)
+                 JEMCC_GetFieldID(env, (jclass) derived, "shadow", "I");
+    checkMember(env, (field == NULL) ? NULL : field->parentClass, derived,
+                "shadowed field");
+    field = (JEM_ClassFieldData *)
+                 JEMCC_GetFieldID(env, (jclass) base, "shadow", "I");
+    checkMember(env, (field == NULL) ? NULL : field->parentClass, base,
+                "base shadow field");
+    field = (JEM_ClassFieldData *)
+                 JEMCC_GetFieldID(env, (jclass) derived, "baseOnly", "J");
+    checkMember(env, (field == NULL) ? NULL : field->parentClass, base,
+                "inherited field");
+
+    /* Interface constants, in declaration order before the superclass */
+    field = (JEM_ClassFieldData *)
+                 JEMCC_GetStaticFieldID(env, (jclass) derived, "CONST", "I");
+    checkMember(env, (field == NULL) ? NULL : field->parentClass, ifaceA,
+                "interface constant order");
+    field = (JEM_ClassFieldData *)
+                 JEMCC_GetStaticFieldID(env, (jclass) derived, "ONLYB", "I");
+    checkMember(env, (field == NULL) ? NULL : field->parentClass, ifaceB,
+                "second interface constant");
+    field = (JEM_ClassFieldData *)
+                 JEMCC_GetStaticFieldID(env, (jclass) base, "CONST", "I");
+    checkMember(env, (field == NULL) ? NULL : field->parentClass, base,
+                "superclass static field");
+
+    /* Static mismatches and missing fields */
+    if (JEMCC_GetFieldID(env, (jclass) derived, "CONST", "I") != NULL) {
+        (void) fprintf(stderr, "Static field returned as instance field\n");
+        exit(1);
+    }
+    checkException(env, "NoSuchFieldError", "is static", "static field");
+    if (JEMCC_GetFieldID(env, (jclass) derived, "shadow", "J") != NULL) {
+        (void) fprintf(stderr, "Field with wrong descriptor returned\n");
+        exit(1);
+    }
+    checkException(env, "NoSuchFieldError", "shadow", "field descriptor");
+
+    /* Inherited, overridden and static methods */
+    method = (JEM_ClassMethodData *)
+                 JEMCC_GetMethodID(env, (jclass) derived, "baseMethod", "()V");
+    checkMember(env, (method == NULL) ? NULL : method->parentClass, base,
+                "inherited method");
+    method = (JEM_ClassMethodData *)
+                 JEMCC_GetMethodID(env, (jclass) derived, "overMethod", "()V");
+    checkMember(env, (method == NULL) ? NULL : method->parentClass, derived,
+                "overridden method");
+    method = (JEM_ClassMethodData *)
+                 JEMCC_GetMethodID(env, (jclass) base, "overMethod", "()V");
+    checkMember(env, (method == NULL) ? NULL : method->parentClass, base,
+                "base overridden method");
+    method = (JEM_ClassMethodData *)
+                 JEMCC_GetStaticMethodID(env, (jclass) derived,
+                                         "statMethod", "()V");
+    checkMember(env, (method == NULL) ? NULL : method->parentClass, base,
+                "inherited static method");
+    if (JEMCC_GetMethodID(env, (jclass) derived,
+                          "statMethod", "()V") != NULL) {
+        (void) fprintf(stderr, "Static method returned as instance method\n");
+        exit(1);
+    }
+    checkException(env, "NoSuchMethodError", "is static", "static method");
+    if (JEMCC_GetMethodID(env, (jclass) derived, "noMethod", "()V") != NULL) {
+        (void) fprintf(stderr, "Undefined method returned\n");
+        exit(1);
+    }
+    checkException(env, "NoSuchMethodError", "noMethod", "undefined method");
+
+    /* The lookups initialize the class */
+    if (derived->classData->resolveInitState != JEM_CLASS_INIT_COMPLETE) {
+        (void) fprintf(stderr, "Member lookup did not initialize class\n");
+        exit(1);
+    }
+}
+
+/*
+ * Parallel preload test classes, built from the race class B template by
+ * renaming the class and superclass.  Classes C0-C11 extend B, which
+ * extends A (not in the preload list, loaded directly while linking B).
+ * D extends A and is not in the list either.  The list also contains a
+ * duplicate name (in directory format) and a class which is not present
+ * on the classpath.
+ */
+#define PRELOAD_DIR "prldtest"
+#define PRELOAD_CLASS_DIR "prldtest/test/prld"
+#define PRELOAD_LIST "prldtest/classes.lst"
+#define PRELOAD_EMPTY_LIST "prldtest/empty.lst"
+#define PRELOAD_CHILD_COUNT 12
+
+/* Rebuild the template class with the given (slash format) names */
+static jint buildPreloadClass(jbyte *buff, const char *className,
+                              const char *superName) {
+    static const char *tmplNames[2] = { "test/race/B", "test/race/A" };
+    const char *names[2];
+    jint i = 0, j, len = 0, nameLen;
+
+    names[0] = className;
+    names[1] = superName;
+    while (i < (jint) sizeof(raceClassB)) {
+        for (j = 0; j < 2; j++) {
+            if ((i + 14 <= (jint) sizeof(raceClassB)) &&
+                (raceClassB[i] == 0x01) && (raceClassB[i + 1] == 0x00) &&
+                (raceClassB[i + 2] == 0x0b) &&
+                (memcmp(raceClassB + i + 3, tmplNames[j], 11) == 0)) break;
+        }
+        if (j < 2) {
+            /* Replace the UTF-8 constant with the new name */
+            nameLen = strlen(names[j]);
+            buff[len++] = 0x01;
+            buff[len++] = (jbyte) ((nameLen >> 8) & 0xFF);
+            buff[len++] = (jbyte) (nameLen & 0xFF);
+            (void) memcpy(buff + len, names[j], nameLen);
+            len += nameLen;
+            i += 14;
+        } else {
+            buff[len++] = raceClassB[i++];
+        }
+    }
+
+    return len;
+}
+
+/* Write the preload class file for the given (simple) class name */
+static void writePreloadClass(const char *name, const char *superName) {
+    char className[64], fileName[128];
+    jbyte buff[256];
+    jint len;
+    FILE *fp;
+
+    (void) sprintf(className, "test/prld/%s", name);
+    (void) sprintf(fileName, "%s/%s.class", PRELOAD_CLASS_DIR, name);
+    len = buildPreloadClass(buff, className, superName);
+    if (((fp = fopen(fileName, "wb")) == NULL) ||
+        (fwrite(buff, 1, len, fp) != (size_t) len) ||
+        (fclose(fp) != 0)) {
+        (void) fprintf(stderr, "Unable to write preload class %s\n", name);
+        exit(1);
+    }
+}
+
+/* Build the classpath directory and the class list files */
+static void buildPreloadFiles() {
+    char name[16];
+    FILE *fp;
+    int i;
+
+    (void) mkdir(PRELOAD_DIR, 0755);
+    (void) mkdir(PRELOAD_DIR "/test", 0755);
+    (void) mkdir(PRELOAD_CLASS_DIR, 0755);
+    writePreloadClass("A", "java/lang/Object");
+    writePreloadClass("B", "test/prld/A");
+    writePreloadClass("D", "test/prld/A");
+    for (i = 0; i < PRELOAD_CHILD_COUNT; i++) {
+        (void) sprintf(name, "C%i", i);
+        writePreloadClass(name, "test/prld/B");
+    }
+
+    if ((fp = fopen(PRELOAD_LIST, "w")) == NULL) {
+        (void) fprintf(stderr, "Unable to write preload class list\n");
+        exit(1);
+    }
+    (void) fprintf(fp, "# Children first, so that B is claimed early\n");
+    for (i = 0; i < PRELOAD_CHILD_COUNT; i++) {
+        (void) fprintf(fp, "test.prld.C%i\n", i);
+    }
+    (void) fprintf(fp, "\ttest/prld/B.class\n");
+    (void) fprintf(fp, "test.prld.C0\n");
+    (void) fprintf(fp, "test.prld.Missing  # not on the classpath\n");
+    (void) fclose(fp);
+
+    if ((fp = fopen(PRELOAD_EMPTY_LIST, "w")) == NULL) {
+        (void) fprintf(stderr, "Unable to write empty preload list\n");
+        exit(1);
+    }
+    (void) fprintf(fp, "# Nothing to preload\n\n");
+    (void) fclose(fp);
+}
+
+/* Remove the preload test files */
+static void removePreloadFiles() {
+    char fileName[128];
+    int i;
+
+    for (i = 0; i < PRELOAD_CHILD_COUNT; i++) {
+        (void) sprintf(fileName, "%s/C%i.class", PRELOAD_CLASS_DIR, i);
+        (void) remove(fileName);
+    }
+    (void) remove(PRELOAD_CLASS_DIR "/A.class");
+    (void) remove(PRELOAD_CLASS_DIR "/B.class");
+    (void) remove(PRELOAD_CLASS_DIR "/D.class");
+    (void) remove(PRELOAD_LIST);
+    (void) remove(PRELOAD_EMPTY_LIST);
+    (void) rmdir(PRELOAD_CLASS_DIR);
+    (void) rmdir(PRELOAD_DIR "/test");
+    (void) rmdir(PRELOAD_DIR);
+}
+
+/* Confirm that the preload defined the class, with the given superclass */
+static JEMCC_Class *checkPreloaded(JNIEnv *env, const char *className,
+                                   JEMCC_Class *superClass) {
+    JEMCC_Object *loader = ((JEM_JNIEnv *) env)->parentVM->systemClassLoader;
+    JEMCC_Class *tstClass;
+
+    if (JEM_RetrieveClass(env, loader, className, &tstClass) != JNI_OK) {
+        (void) fprintf(stderr, "Class %s was not preloaded\n", className);
+        exit(1);
+    }
+    if ((superClass != NULL) &&
+        (tstClass->classData->assignList[0] != superClass)) {
+        (void) fprintf(stderr, "Class %s has incorrect superclass\n",
+                               className);
+        exit(1);
+    }
+
+    return tstClass;
+}
+
+/* Preload the class set with the given number of parsing threads */
+static void doPreload(jint workerCount) {
+    JEMCC_Class *aClass, *bClass, *tstClass;
+    JEM_JavaVM *jvm;
+    char name[32];
+    JNIEnv *env;
+    int i;
+
+    if (((env = createTestEnv()) == NULL) ||
+        (JEM_InitializeVMClasses(env) != JNI_OK)) {
+        (void) fprintf(stderr, "Fatal preload test env init error\n");
+        exit(1);
+    }
+    jvm = ((JEM_JNIEnv *) env)->parentVM;
+    if (JEM_ParsePathList(env, &(jvm->classPath), PRELOAD_DIR,
+                          JNI_TRUE) != JNI_OK) {
+        (void) fprintf(stderr, "Unable to parse preload classpath\n");
+        exit(1);
+    }
+
+    /* Missing list file, no classes are loaded */
+    if (JEM_PreloadSystemClasses(env, PRELOAD_DIR "/none.lst",
+                                 workerCount) != JNI_ERR) {
+        (void) fprintf(stderr, "Unexpected return from missing list\n");
+        exit(1);
+    }
+    checkException(env, "IOException", "preload class list",
+                   "missing preload list");
+
+    /* Empty list, workers must shut down without any entries */
+    if ((JEM_PreloadSystemClasses(env, PRELOAD_EMPTY_LIST,
+                                  workerCount) != JNI_OK) ||
+        (((JEM_JNIEnv *) env)->pendingException != NULL) ||
+        (jvm->preloadControl != NULL)) {
+        (void) fprintf(stderr, "Empty preload list failed\n");
+        exit(1);
+    }
+
+    /* Full list, claims overlap the workers parsing the children/B */
+    if ((JEM_PreloadSystemClasses(env, PRELOAD_LIST,
+                                  workerCount) != JNI_OK) ||
+        (((JEM_JNIEnv *) env)->pendingException != NULL)) {
+        (void) fprintf(stderr, "Preload of class list failed\n");
+        exit(1);
+    }
+    if (jvm->preloadControl != NULL) {
+        (void) fprintf(stderr, "Preload control not released\n");
+        exit(1);
+    }
+    aClass = checkPreloaded(env, "test.prld.A",
+                            JEMCC_GetCoreVMClass(env, JEMCC_Class_Object));
+    bClass = checkPreloaded(env, "test.prld.B", aClass);
+    for (i = 0; i < PRELOAD_CHILD_COUNT; i++) {
+        (void) sprintf(name, "test.prld.C%i", i);
+        (void) checkPreloaded(env, name, bClass);
+    }
+
+    /* Unlisted class is not loaded, but still available afterwards */
+    if (JEM_RetrieveClass(env, jvm->systemClassLoader, "test.prld.D",
+                          &tstClass) != JNI_EINVAL) {
+        (void) fprintf(stderr, "Unlisted class was preloaded\n");
+        exit(1);
+    }
+    if (JEMCC_LocateClass(env, jvm->systemClassLoader, "test.prld.D",
+                          JNI_FALSE, &tstClass) != JNI_OK) {
+        (void) fprintf(stderr, "Unable to load unlisted class\n");
+        exit(1);
+    }
+    (void) checkPreloaded(env, "test.prld.D", aClass);
+
+    /* Listed class which could not be found is reported on request */
+    if (JEMCC_LocateClass(env, jvm->systemClassLoader, "test.prld.Missing",
+                          JNI_FALSE, &tstClass) != JNI_EINVAL) {
+        (void) fprintf(stderr, "Unexpected return for missing class\n");
+        exit(1);
+    }
+    checkException(env, "ClassNotFoundException", "test.prld.Missing",
+                   "missing preload class");
+
+    destroyTestEnv(env);
+}
+
+static void doPreloadTests() {
+    static jint workerCounts[] = { 0, 1, 2, 4, 16 };
+    int i, j;
+
+    buildPreloadFiles();
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < (int) (sizeof(workerCounts) / sizeof(jint)); i++) {
+            doPreload(workerCounts[i]);
+        }
+    }
+    removePreloadFiles();
+}
+
 /* Forward declarations */
 void doValidScan(jboolean fullsweep);
 
@@ -296,9 +696,15 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
+    /* Member (field/method) resolution through the hierarchy */
+    doMemberLookup(env);
+
     /* All done, clean up the mess */
     destroyTestEnv(env);
 
+    /* Parallel preload of the system classes (separate environments) */
+    doPreloadTests();
+
     /* Memory failure scanning */
 #ifdef ENABLE_ERRORSWEEP
     testFailureCurrentCount = 0;
@@ -2456,9 +2456,34 @@ static struct method_test_data {
 void doValidScan();
 void parseClasspathEntry(char *entry);
 
+/* Verify the handler range index of the real method above */
+static void checkHandlerIndex(JEM_BCMethod *bcMeth) {
+    static jint expected[][4] = { { 2, 6, 0, 1 }, { 6, 9, 1, -1 },
+                                  { 12, 18, 2, -1 }, { 21, 25, 3, -1 } };
+    JEM_HandlerRange *range = bcMeth->handlerRanges;
+    int i;
+
+    if (bcMeth->handlerRangeCount != 4) {
+        (void) fprintf(stderr, "Error: expected 4 handler ranges, got %i\n",
+                               bcMeth->handlerRangeCount);
+        exit(1);
+    }
+    for (i = 0; i < 4; i++, range++) {
+        if ((range->startPC != expected[i][0]) ||
+            (range->endPC != expected[i][1]) ||
+            (range->handlerCount != ((expected[i][3] < 0) ? 1 : 2)) ||
+            (range->handlers[0] != expected[i][2]) ||
+            ((expected[i][3] >= 0) &&
+                 (range->handlers[1] != expected[i][3]))) {
+            (void) fprintf(stderr, "Error: invalid handler range %i\n", i);
+            exit(1);
+        }
+    }
+}
+
 /* Main program will send the class parser through its paces */
 int main(int argc, char *argv[]) {
-    int i, nCTests = sizeof(classTests)/sizeof(struct class_test_data);
+    int i, j, nCTests = sizeof(classTests)/sizeof(struct class_test_data);
     int nMTests = sizeof(methodTests)/sizeof(struct method_test_data);
     int targTest = 0;
     char *str, *ptr, *exceptionMessage, *cpath = getenv("CLASSPATH");
@@ -2481,7 +2506,7 @@ int main(int argc, char *argv[]) {
         if ((targTest > 0) && (i != (targTest - 1))) continue;
         *exClassName = *exMsg = '\0';
         pData = JEM_ParseClassData(NULL, classTests[i].testData, 
-                                         classTests[i].testLength);
+                                         classTests[i].testLength, JNI_FALSE);
         exceptionMessage = exMsg;
         if (strlen(exceptionMessage) == 0) exceptionMessage = NULL;
         if (classTests[i].msgFragment != NULL) {
@@ -2511,12 +2536,21 @@ int main(int argc, char *argv[]) {
         if (pData != NULL) JEM_DestroyParsedClassData(pData);
     }
 
-    /* Then the bytecode method test array */
-    pData = JEM_ParseClassData(NULL, objData, 589);
+    /* Then the bytecode method test array (mapped, attributes reference) */
+    pData = JEM_ParseClassData(NULL, objData, 589, JNI_TRUE);
     if (pData == NULL) {
         (void) fprintf(stderr, "Error: parse failure of base object\n");
         exit(1);
     }
+    for (i = 0; i < pData->methodsCount; i++) {
+        for (j = 0; j < pData->methods[i].attributesCount; j++) {
+            if ((pData->methods[i].attributes[j].info < objData) ||
+                (pData->methods[i].attributes[j].info >= objData + 589)) {
+                (void) fprintf(stderr, "Error: mapped attribute was copied\n");
+                exit(1);
+            }
+        }
+    }
     for (i = 0; i < nMTests; i++) {
         if ((targTest < 0) && (i != (1 - targTest))) continue;
         *exClassName = *exMsg = '\0';
@@ -2548,6 +2582,9 @@ int main(int argc, char *argv[]) {
                 exit(1);
             }
         }
+        if ((bcMeth != NULL) && (methodTests[i].msgFragment == NULL)) {
+            checkHandlerIndex(bcMeth);
+        }
         if (bcMeth != NULL) JEM_DestroyMethodCode(bcMeth);
     }
     JEM_DestroyParsedClassData(pData);
@@ -2599,16 +2636,19 @@ void doValidScan() {
     JEM_BCMethod *bcMeth;
 
     pData = JEM_ParseClassData(NULL, classTests[nCTests - 3].testData, 
-                                     classTests[nCTests - 3].testLength);
+                                     classTests[nCTests - 3].testLength,
+                                     JNI_FALSE);
     JEM_DestroyParsedClassData(pData);
     pData = JEM_ParseClassData(NULL, classTests[nCTests - 2].testData, 
-                                     classTests[nCTests - 2].testLength);
+                                     classTests[nCTests - 2].testLength,
+                                     JNI_FALSE);
     JEM_DestroyParsedClassData(pData);
     pData = JEM_ParseClassData(NULL, classTests[nCTests - 1].testData, 
-                                     classTests[nCTests - 1].testLength);
+                                     classTests[nCTests - 1].testLength,
+                                     JNI_FALSE);
     JEM_DestroyParsedClassData(pData);
 
-    pData = JEM_ParseClassData(NULL, objData, 589);
+    pData = JEM_ParseClassData(NULL, objData, 589, JNI_FALSE);
     if (pData == NULL) return;
     bcMeth = JEM_ParseMethodCode(NULL, methodTests[nMTests - 1].testData,
                                  methodTests[nMTests - 1].testLength, pData);
@@ -2654,7 +2694,7 @@ void parseClasspathEntry(char *entry) {
             (void) fclose(fp);
 
             /* Try to parse it */
-            if ((classData = JEM_ParseClassData(NULL, dBuff, n)) == NULL) {
+            if ((classData = JEM_ParseClassData(NULL, dBuff, n, JNI_FALSE)) == NULL) {
                 (void) fprintf(stderr, "Scanner: got unexpected error '%s'\n",
                                exMsg);
                 JEMCC_Free(dBuff);
@@ -2712,3 +2752,16 @@ void *JEMCC_StrDupFn(JNIEnv *env, void *key) {
     (void) strcpy(newKey, (char *) key);
     return (void *) newKey;
 }
+
+/* No symbol table here, the constant pool outlives the parsed method code */
+char *JEM_InternSymbol(JNIEnv *env, const char *symbol) {
+    return (char *) symbol;
+}
+
+/* No UTF-8 validation here either, the test class data is well formed */
+jint JEM_UTFScan(const jubyte *utf, jsize byteLen, jsize *validLen,
+                 jboolean *isCompact) {
+    if (validLen != NULL) *validLen = byteLen;
+    if (isCompact != NULL) *isCompact = JNI_FALSE;
+    return byteLen;
+}
@@ -56,11 +56,11 @@ void destroyException(JNIEnv *env, JEMCC_Object *exception) {
     JEMCC_ThrowableData *exData = (JEMCC_ThrowableData *)
                              &(((JEMCC_ObjectExt *) exception)->objectData);
 
+    /* Object records are in the allocation blocks, only release data */
     if (exData->message != NULL) {
          JEMCC_Free(((JEMCC_ObjectExt *) (exData->message))->objectData);
-         JEMCC_Free(exData->message);
+         ((JEMCC_ObjectExt *) (exData->message))->objectData = NULL;
     }
-    JEMCC_Free(exception);
 }
 
 void checkException(JNIEnv *env, const char *checkClassName, 
@@ -313,9 +313,868 @@ static struct code_test_data {
             special numerical representations */
 };
 
+/* Instances and class references for the subtype check tests */
+#define SUB_STRING 0
+#define SUB_STRING_ARRAY 1
+#define SUB_OBJECT_ARRAY 2
+#define SUB_INT_ARRAY 3
+#define SUB_OBJECT 4
+#define SUB_NULL 5
+#define SUB_COUNT 6
+
+#define REF_OBJECT 0
+#define REF_OBJECT_ARRAY 1
+#define REF_STRING_ARRAY 2
+#define REF_INT_ARRAY 3
+#define REF_LONG_ARRAY 4
+#define REF_SERIALIZABLE 5
+#define REF_CLONEABLE 6
+#define REF_STRING 7
+#define REF_UNRESOLVED 8
+#define REF_FAILED 9
+#define REF_COUNT 10
+
+/*
+ * For instanceof/checkcast, the target is a class reference index and the
+ * result the expected instanceof value (checkcast returns the instance).
+ * For aastore, the target is the array instance and the result is 1.
+ */
+static struct subtype_test_data {
+    int opcode;
+    int objIdx;
+    int targetIdx;
+    int result;
+    char *exceptionClass;
+    char *exceptionMsg;
+} subtypeTests[] = {
+    /* instanceof (array covariance, primitive arrays, interfaces) */
+    { 0xc1, SUB_STRING_ARRAY, REF_OBJECT_ARRAY, 1, NULL, NULL },
+    { 0xc1, SUB_OBJECT_ARRAY, REF_STRING_ARRAY, 0, NULL, NULL },
+    { 0xc1, SUB_STRING_ARRAY, REF_OBJECT, 1, NULL, NULL },
+    { 0xc1, SUB_STRING_ARRAY, REF_CLONEABLE, 1, NULL, NULL },
+    { 0xc1, SUB_STRING_ARRAY, REF_SERIALIZABLE, 1, NULL, NULL },
+    { 0xc1, SUB_INT_ARRAY, REF_OBJECT, 1, NULL, NULL },
+    { 0xc1, SUB_INT_ARRAY, REF_CLONEABLE, 1, NULL, NULL },
+    { 0xc1, SUB_INT_ARRAY, REF_OBJECT_ARRAY, 0, NULL, NULL },
+    { 0xc1, SUB_INT_ARRAY, REF_LONG_ARRAY, 0, NULL, NULL },
+    { 0xc1, SUB_INT_ARRAY, REF_INT_ARRAY, 1, NULL, NULL },
+    { 0xc1, SUB_STRING, REF_SERIALIZABLE, 1, NULL, NULL },
+    { 0xc1, SUB_STRING, REF_CLONEABLE, 0, NULL, NULL },
+    { 0xc1, SUB_OBJECT, REF_STRING, 0, NULL, NULL },
+    { 0xc1, SUB_OBJECT, REF_SERIALIZABLE, 0, NULL, NULL },
+    { 0xc1, SUB_NULL, REF_UNRESOLVED, 0, NULL, NULL },
+    { 0xc1, SUB_STRING, REF_UNRESOLVED, 0,
+      "NoClassDefFoundError", "unresolved class reference" },
+
+    /* checkcast */
+    { 0xc0, SUB_STRING_ARRAY, REF_OBJECT_ARRAY, 1, NULL, NULL },
+    { 0xc0, SUB_INT_ARRAY, REF_OBJECT_ARRAY, 0, "ClassCastException", NULL },
+    { 0xc0, SUB_STRING, REF_SERIALIZABLE, 1, NULL, NULL },
+    { 0xc0, SUB_OBJECT, REF_STRING, 0, "ClassCastException", NULL },
+    { 0xc0, SUB_NULL, REF_UNRESOLVED, 1, NULL, NULL },
+    { 0xc0, SUB_OBJECT, REF_FAILED, 0,
+      "NoClassDefFoundError", "test.Missing" },
+
+    /* aastore */
+    { 0x53, SUB_STRING, SUB_OBJECT_ARRAY, 1, NULL, NULL },
+    { 0x53, SUB_INT_ARRAY, SUB_OBJECT_ARRAY, 1, NULL, NULL },
+    { 0x53, SUB_OBJECT, SUB_STRING_ARRAY, 0, "ArrayStoreException", NULL },
+    { 0x53, SUB_INT_ARRAY, SUB_STRING_ARRAY, 0, "ArrayStoreException", NULL },
+    { 0x53, SUB_NULL, SUB_STRING_ARRAY, 1, NULL, NULL }
+};
+
+/* Locate a core class for the subtype tests */
+static JEMCC_Class *findTestClass(JNIEnv *env, const char *className) {
+    JEMCC_Class *tstClass;
+
+    if (JEMCC_LocateClass(env, NULL, className, JNI_FALSE,
+                          &tstClass) != JNI_OK) {
+        (void) fprintf(stderr, "Could not find class %s\n", className);
+        exit(1);
+    }
+    return tstClass;
+}
+
+/* Run the type check opcodes against the instance/class combinations */
+static void runSubtypeTests(JEM_JNIEnv *env, JEM_ClassMethodData *method) {
+    int i, nTests = sizeof(subtypeTests) / sizeof(struct subtype_test_data);
+    struct subtype_test_data *tst;
+    JEMCC_Object *objs[SUB_COUNT], *obj;
+    JEMCC_Class *refs[REF_COUNT];
+    JEM_ClassData parentData;
+    JEMCC_Class parentClass;
+    JEMCC_VMFrame *frame;
+    jubyte code[8];
+
+    /* Build the test instances */
+    refs[REF_OBJECT] = findTestClass((JNIEnv *) env, "java.lang.Object");
+    refs[REF_STRING] = findTestClass((JNIEnv *) env, "java.lang.String");
+    refs[REF_SERIALIZABLE] = findTestClass((JNIEnv *) env,
+                                           "java.io.Serializable");
+    refs[REF_CLONEABLE] = findTestClass((JNIEnv *) env, "java.lang.Cloneable");
+    objs[SUB_STRING] = (JEMCC_Object *) JEMCC_NewStringUTF((JNIEnv *) env,
+                                                           "subtype");
+    objs[SUB_STRING_ARRAY] = (JEMCC_Object *)
+                 JEMCC_NewObjectArray((JNIEnv *) env, 1,
+                                      (jclass) refs[REF_STRING], NULL);
+    objs[SUB_OBJECT_ARRAY] = (JEMCC_Object *)
+                 JEMCC_NewObjectArray((JNIEnv *) env, 1,
+                                      (jclass) refs[REF_OBJECT], NULL);
+    objs[SUB_INT_ARRAY] = (JEMCC_Object *) JEMCC_NewIntArray((JNIEnv *) env,
+                                                             1);
+    objs[SUB_OBJECT] = JEMCC_AllocateObject((JNIEnv *) env,
+                                            refs[REF_OBJECT], 0);
+    objs[SUB_NULL] = NULL;
+    for (i = 0; i < SUB_NULL; i++) {
+        if (objs[i] == NULL) {
+            (void) fprintf(stderr, "Could not create subtype instance\n");
+            exit(1);
+        }
+    }
+    obj = (JEMCC_Object *) JEMCC_NewLongArray((JNIEnv *) env, 1);
+    if (obj == NULL) {
+        (void) fprintf(stderr, "Could not create subtype instance\n");
+        exit(1);
+    }
+    refs[REF_OBJECT_ARRAY] = objs[SUB_OBJECT_ARRAY]->classReference;
+    refs[REF_STRING_ARRAY] = objs[SUB_STRING_ARRAY]->classReference;
+    refs[REF_INT_ARRAY] = objs[SUB_INT_ARRAY]->classReference;
+    refs[REF_LONG_ARRAY] = obj->classReference;
+
+    /* Failed resolutions, with and without a captured throwable */
+    refs[REF_UNRESOLVED] = NULL;
+    JEMCC_ThrowStdThrowableIdx((JNIEnv *) env,
+                               JEMCC_Class_NoClassDefFoundError, NULL,
+                               "test.Missing");
+    refs[REF_FAILED] = (JEMCC_Class *)
+                             JEM_ExtractSkeletonThrowable((JNIEnv *) env);
+    if (refs[REF_FAILED] == NULL) {
+        (void) fprintf(stderr, "Could not capture skeleton throwable\n");
+        exit(1);
+    }
+
+    /* Dummy parent class holding the class reference table */
+    (void) memset(&parentData, 0, sizeof(parentData));
+    (void) memset(&parentClass, 0, sizeof(parentClass));
+    parentData.classRefs = refs;
+    parentClass.classData = &parentData;
+    method->parentClass = &parentClass;
+    method->method.bcMethod->code = code;
+
+    for (i = 0; i < nTests; i++) {
+        tst = &(subtypeTests[i]);
+        if (tst->opcode == 0x53) {
+            /* aload_1, iconst_0, aload_0, aastore, iconst_1, ireturn */
+            code[0] = 0x2b; code[1] = 0x03; code[2] = 0x2a;
+            code[3] = 0x53; code[4] = 0x04; code[5] = 0xac;
+        } else {
+            /* aload_0, checkcast/instanceof #target, areturn/ireturn */
+            code[0] = 0x2a; code[1] = tst->opcode;
+            code[2] = 0x00; code[3] = tst->targetIdx;
+            code[4] = (tst->opcode == 0xc0) ? 0xb0 : 0xac;
+        }
+
+        frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 
+                                method->method.bcMethod->maxStack,
+                                method->method.bcMethod->maxStack,
+                                method->method.bcMethod->maxLocals);
+        ((JEM_VMFrameExt *) frame)->currentMethod = method;
+        ((JEM_VMFrameExt *) frame)->lastPC = 0;
+        JEMCC_STORE_OBJECT(frame, 0, objs[tst->objIdx]);
+        if (tst->opcode == 0x53) {
+            JEMCC_STORE_OBJECT(frame, 1, objs[tst->targetIdx]);
+        }
+
+        JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+
+        if (tst->exceptionClass != NULL) {
+            checkException((JNIEnv *) env, tst->exceptionClass,
+                           tst->exceptionMsg, "subtype check");
+            continue;
+        }
+        if (env->pendingException != NULL) {
+            (void) fprintf(stderr, "Error: subtype test %i threw exception\n",
+                                   i + 1);
+            exit(1);
+        }
+        if (tst->opcode == 0xc0) {
+            if (env->nativeReturnValue.objVal != objs[tst->objIdx]) {
+                (void) fprintf(stderr, "Error: subtype test %i bad cast\n",
+                                       i + 1);
+                exit(1);
+            }
+        } else if (env->nativeReturnValue.intVal != tst->result) {
+            (void) fprintf(stderr, "Error: subtype test %i returned %i\n",
+                                   i + 1, env->nativeReturnValue.intVal);
+            exit(1);
+        }
+    }
+    method->parentClass = NULL;
+}
+
+/*
+ * Inline call site cache test structures.  Each receiver class has a single
+ * method (linked at index 0 for the virtual and interface tables) which
+ * returns 10 plus the receiver number.  The last receiver does not
+ * implement the call site interface.
+ */
+#define RECV_COUNT 6
+
+static JEMCC_Class recvClasses[RECV_COUNT], siteIface, otherIface;
+static JEM_ClassData recvClassData[RECV_COUNT];
+static JEMCC_Class *recvAssignLists[RECV_COUNT][2];
+static JEM_ClassMethodData *recvMethodTables[RECV_COUNT][1];
+static JEM_ClassMethodData **recvLinkTables[RECV_COUNT][2];
+static JEM_ClassMethodData recvMethods[RECV_COUNT], siteMethodRef;
+static JEM_BCMethod recvBCMethods[RECV_COUNT];
+static jubyte recvCode[RECV_COUNT][3];
+static JEMCC_Object recvObjs[RECV_COUNT];
+
+static void buildCallSiteReceivers() {
+    int i;
+
+    for (i = 0; i < RECV_COUNT; i++) {
+        /* bipush 10 + i, ireturn */
+        recvCode[i][0] = 0x10;
+        recvCode[i][1] = 10 + i;
+        recvCode[i][2] = 0xac;
+        recvBCMethods[i].maxStack = 2;
+        recvBCMethods[i].maxLocals = 1;
+        recvBCMethods[i].codeLength = 3;
+        recvBCMethods[i].code = recvCode[i];
+
+        recvMethods[i].name = "value";
+        recvMethods[i].descriptorStr = "()I";
+        recvMethods[i].methodIndex = 0;
+        recvMethods[i].stackConsumeCount = 1;
+        recvMethods[i].method.bcMethod = &(recvBCMethods[i]);
+        recvMethods[i].parentClass = &(recvClasses[i]);
+
+        recvMethodTables[i][0] = &(recvMethods[i]);
+        recvLinkTables[i][0] = recvMethodTables[i];
+        recvLinkTables[i][1] = recvMethodTables[i];
+        recvAssignLists[i][0] = NULL;
+        recvAssignLists[i][1] = (i == RECV_COUNT - 1) ? &otherIface :
+                                                        &siteIface;
+        recvClassData[i].className = "callsite.Receiver";
+        recvClassData[i].methodLinkTables = recvLinkTables[i];
+        recvClassData[i].assignList = recvAssignLists[i];
+        recvClassData[i].interfaceCount = 1;
+        recvClassData[i].assignmentCount = 1;
+        recvClasses[i].classData = &(recvClassData[i]);
+        recvObjs[i].classReference = &(recvClasses[i]);
+    }
+
+    siteMethodRef.name = "value";
+    siteMethodRef.descriptorStr = "()I";
+    siteMethodRef.methodIndex = 0;
+    siteMethodRef.stackConsumeCount = 1;
+}
+
+/* Run the quick invoke against a receiver through the test call site */
+static void runCallSite(JEM_JNIEnv *env, JEM_ClassMethodData *method,
+                        JEMCC_Object *receiver, jboolean isInterface,
+                        char *exceptionClass, int result) {
+    /* aload_0, invoke[virtual|interface]_quick #0 [1, 0], ireturn */
+    static jubyte virtualCode[] = { 0x2a, 0xd7, 0x00, 0x00, 0xac };
+    static jubyte interfaceCode[] = { 0x2a, 0xd8, 0x00, 0x00,
+                                      0x01, 0x00, 0xac };
+    JEMCC_VMFrame *frame;
+
+    siteMethodRef.parentClass = (isInterface == JNI_TRUE) ? &siteIface :
+                                                       &(recvClasses[0]);
+    method->method.bcMethod->code = (isInterface == JNI_TRUE) ?
+                                              interfaceCode : virtualCode;
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 
+                            method->method.bcMethod->maxStack,
+                            method->method.bcMethod->maxStack,
+                            method->method.bcMethod->maxLocals);
+    ((JEM_VMFrameExt *) frame)->currentMethod = method;
+    ((JEM_VMFrameExt *) frame)->lastPC = 0;
+    JEMCC_STORE_OBJECT(frame, 0, receiver);
+
+    JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+
+    if (exceptionClass != NULL) {
+        checkException((JNIEnv *) env, exceptionClass, NULL, "call site");
+        return;
+    }
+    if (env->pendingException != NULL) {
+        (void) fprintf(stderr, "Error: unexpected call site exception\n");
+        exit(1);
+    }
+    if (env->nativeReturnValue.intVal != result) {
+        (void) fprintf(stderr, "Error: call site returned %i, not %i\n",
+                               env->nativeReturnValue.intVal, result);
+        exit(1);
+    }
+}
+
+/* Verify the receiver classes recorded in the call site cache */
+static void checkCallSiteCache(JEM_CallSiteCache *cache, int *expected,
+                               const char *tstName) {
+    JEMCC_Class *recvClass;
+    int i;
+
+    for (i = 0; i < JEM_CALLSITE_CACHE_SIZE; i++) {
+        recvClass = (expected[i] < 0) ? NULL : &(recvClasses[expected[i]]);
+        if (cache->entries[i].receiverClass != recvClass) {
+            (void) fprintf(stderr, "Error: %s cache entry %i mismatch\n",
+                                   tstName, i);
+            exit(1);
+        }
+        if ((recvClass != NULL) && (cache->entries[i].targetMethod !=
+                                          &(recvMethods[expected[i]]))) {
+            (void) fprintf(stderr, "Error: %s cache target %i mismatch\n",
+                                   tstName, i);
+            exit(1);
+        }
+    }
+}
+
+/* Monomorphic, polymorphic and megamorphic call site sequences */
+static void runCallSiteTests(JEM_JNIEnv *env, JEM_ClassMethodData *method) {
+    static int monoEntries[] = { 0, -1, -1, -1 };
+    static int polyEntries[] = { 0, 1, 2, -1 };
+    static int clearedEntries[] = { -1, 1, 2, -1 };
+    static int megaEntries[] = { 0, 1, 2, 3 };
+    static int ifaceEntries[] = { 2, -1, -1, -1 };
+    JEM_BCMethod *bcMethod = method->method.bcMethod;
+    JEM_CallSiteCache cache;
+    int i;
+
+    buildCallSiteReceivers();
+    (void) memset(&cache, 0, sizeof(cache));
+    cache.methodRef = &siteMethodRef;
+    bcMethod->callSiteCaches = &cache;
+    bcMethod->callSiteCount = 1;
+
+    /* Monomorphic, first call fills the cache and the rest hit it */
+    for (i = 0; i < 3; i++) {
+        runCallSite(env, method, &(recvObjs[0]), JNI_FALSE, NULL, 10);
+    }
+    checkCallSiteCache(&cache, monoEntries, "monomorphic");
+
+    /* Polymorphic, receivers fill successive entries */
+    runCallSite(env, method, &(recvObjs[1]), JNI_FALSE, NULL, 11);
+    runCallSite(env, method, &(recvObjs[2]), JNI_FALSE, NULL, 12);
+    runCallSite(env, method, &(recvObjs[0]), JNI_FALSE, NULL, 10);
+    runCallSite(env, method, &(recvObjs[1]), JNI_FALSE, NULL, 11);
+    checkCallSiteCache(&cache, polyEntries, "polymorphic");
+
+    /* Empty (NULL) slots are skipped by the probe and refilled on a miss */
+    cache.entries[0].receiverClass = NULL;
+    cache.entries[0].targetMethod = NULL;
+    runCallSite(env, method, &(recvObjs[2]), JNI_FALSE, NULL, 12);
+    checkCallSiteCache(&cache, clearedEntries, "cleared slot");
+    runCallSite(env, method, &(recvObjs[0]), JNI_FALSE, NULL, 10);
+    checkCallSiteCache(&cache, polyEntries, "refilled slot");
+
+    /* Megamorphic, overflow receivers always take the full lookup */
+    for (i = 0; i < 2; i++) {
+        runCallSite(env, method, &(recvObjs[3]), JNI_FALSE, NULL, 13);
+        runCallSite(env, method, &(recvObjs[4]), JNI_FALSE, NULL, 14);
+        runCallSite(env, method, &(recvObjs[5]), JNI_FALSE, NULL, 15);
+        runCallSite(env, method, &(recvObjs[1]), JNI_FALSE, NULL, 11);
+    }
+    checkCallSiteCache(&cache, megaEntries, "megamorphic");
+    runCallSite(env, method, NULL, JNI_FALSE, "NullPointerException", 0);
+
+    /* Interface call sites map through the interface link table */
+    (void) memset(&cache, 0, sizeof(cache));
+    cache.methodRef = &siteMethodRef;
+    runCallSite(env, method, &(recvObjs[2]), JNI_TRUE, NULL, 12);
+    runCallSite(env, method, &(recvObjs[2]), JNI_TRUE, NULL, 12);
+    runCallSite(env, method, &(recvObjs[RECV_COUNT - 1]), JNI_TRUE,
+                "IncompatibleClassChangeError", 0);
+    checkCallSiteCache(&cache, ifaceEntries, "interface");
+
+    bcMethod->callSiteCaches = NULL;
+    bcMethod->callSiteCount = 0;
+}
+
+/*
+ * Quickened field access test structures.  Each program stores a value into
+ * a field of the holder instance (local 0, with an integer argument in local
+ * 1) and reads it back.  The programs are run with the standard opcodes,
+ * rewritten through JEM_QuickenClassByteCode and then run again (twice) with
+ * the quick opcodes.  The quick table lists the rewritten instruction
+ * locations and their expected opcodes, static field instructions and the
+ * failed reference (following the int return) must be left untouched.
+ */
+#define QF_BYTE 0
+#define QF_CHAR 1
+#define QF_SHORT 2
+#define QF_INT 3
+#define QF_LONG 4
+#define QF_DOUBLE 5
+#define QF_FLOAT 6
+#define QF_OBJECT 7
+#define QF_STATIC 8
+#define QF_FAILED 9
+#define QF_COUNT 10
+
+static JEMCC_FieldData quickHolderFields[] = {
+    { ACC_PUBLIC, "byteVal", "B", -1 },
+    { ACC_PUBLIC, "charVal", "C", -1 },
+    { ACC_PUBLIC, "shortVal", "S", -1 },
+    { ACC_PUBLIC, "intVal", "I", -1 },
+    { ACC_PUBLIC, "longVal", "J", -1 },
+    { ACC_PUBLIC, "dblVal", "D", -1 },
+    { ACC_PUBLIC, "fltVal", "F", -1 },
+    { ACC_PUBLIC, "objVal", "Ljava/lang/Object;", -1 },
+    { ACC_PUBLIC | ACC_STATIC, "statVal", "I", -1 }
+};
+
+static struct quick_test_data {
+    jubyte code[16];
+    int codeLength;
+    jint intArg;
+    int fieldIdx;
+    int quick[5];
+    char returnType;
+    jlong intResult;
+    jdouble dblResult;
+} quickTests[] = {
+    /* aload_0, bipush -5, putfield, aload_0, getfield, ireturn */
+    { { 0x2a, 0x10, 0xfb, 0xb5, 0x00, QF_BYTE,
+        0x2a, 0xb4, 0x00, QF_BYTE, 0xac }, 11, 0, QF_BYTE,
+      { 3, 0xd1, 7, 0xcb, -1 }, 'I', -5, 0.0 },
+    /* aload_0, sipush 0xffff, putfield, aload_0, getfield, ireturn */
+    { { 0x2a, 0x11, 0xff, 0xff, 0xb5, 0x00, QF_CHAR,
+        0x2a, 0xb4, 0x00, QF_CHAR, 0xac }, 12, 0, QF_CHAR,
+      { 4, 0xd2, 8, 0xcc, -1 }, 'I', 65535, 0.0 },
+    /* aload_0, sipush -1234, putfield, aload_0, getfield, ireturn */
+    { { 0x2a, 0x11, 0xfb, 0x2e, 0xb5, 0x00, QF_SHORT,
+        0x2a, 0xb4, 0x00, QF_SHORT, 0xac }, 12, 0, QF_SHORT,
+      { 4, 0xd3, 8, 0xcd, -1 }, 'I', -1234, 0.0 },
+    /* aload_0, iload_1, putfield, aload_0, getfield, ireturn, (unreached) */
+    /* aload_0, getfield failed, ireturn */
+    { { 0x2a, 0x1b, 0xb5, 0x00, QF_INT, 0x2a, 0xb4, 0x00, QF_INT, 0xac,
+        0x2a, 0xb4, 0x00, QF_FAILED, 0xac }, 15, 1234, QF_INT,
+      { 2, 0xd4, 6, 0xce, -1 }, 'I', 1234, 0.0 },
+    /* aload_0, lconst_1, bipush 40, lshl, putfield, aload_0, getfield, */
+    /* lreturn */
+    { { 0x2a, 0x0a, 0x10, 0x28, 0x79, 0xb5, 0x00, QF_LONG,
+        0x2a, 0xb4, 0x00, QF_LONG, 0xad }, 13, 0, QF_LONG,
+      { 5, 0xd5, 9, 0xcf, -1 }, 'J', ((jlong) 1) << 40, 0.0 },
+    /* aload_0, iload_1, i2d, putfield, aload_0, getfield, dreturn */
+    { { 0x2a, 0x1b, 0x87, 0xb5, 0x00, QF_DOUBLE,
+        0x2a, 0xb4, 0x00, QF_DOUBLE, 0xaf }, 11, -3, QF_DOUBLE,
+      { 3, 0xd5, 7, 0xcf, -1 }, 'D', 0, -3.0 },
+    /* aload_0, fconst_2, putfield, aload_0, getfield, freturn */
+    { { 0x2a, 0x0d, 0xb5, 0x00, QF_FLOAT,
+        0x2a, 0xb4, 0x00, QF_FLOAT, 0xae }, 10, 0, QF_FLOAT,
+      { 2, 0xd4, 6, 0xce, -1 }, 'F', 0, 2.0 },
+    /* aload_0, aload_0, putfield, aload_0, getfield, areturn */
+    { { 0x2a, 0x2a, 0xb5, 0x00, QF_OBJECT,
+        0x2a, 0xb4, 0x00, QF_OBJECT, 0xb0 }, 10, 0, QF_OBJECT,
+      { 2, 0xd6, 6, 0xd0, -1 }, 'L', 0, 0.0 },
+    /* iload_1, putstatic, getstatic, ireturn */
+    { { 0x1b, 0xb3, 0x00, QF_STATIC, 0xb2, 0x00, QF_STATIC, 0xac },
+      8, 77, QF_STATIC, { 1, 0xb3, 4, 0xb2, -1 }, 'I', 77, 0.0 }
+};
+
+#define QUICK_TEST_COUNT \
+              (sizeof(quickTests) / sizeof(struct quick_test_data))
+
+static JEMCC_Class quickParent;
+static JEM_ClassData quickParentData;
+static JEM_ClassMethodData quickMethods[QUICK_TEST_COUNT];
+static JEM_BCMethod quickBCMethods[QUICK_TEST_COUNT];
+static JEM_ClassFieldData *quickFieldRefs[QF_COUNT], failedFieldRef;
+
+/* Run a field access program and verify the stored/retrieved value */
+static void runQuickTest(JEM_JNIEnv *env, int idx, JEMCC_Object *holder,
+                         const char *tstName) {
+    struct quick_test_data *tst = &(quickTests[idx]);
+    JEMCC_ReturnValue *retVal = &(env->nativeReturnValue);
+    JEM_ClassFieldData *statField = quickFieldRefs[QF_STATIC];
+    JEMCC_VMFrame *frame;
+    int valid;
+
+    /* Clear the previous storage so that the store must take effect */
+    (void) memset(&(((JEMCC_ObjectExt *) holder)->objectData), 0,
+                  holder->classReference->classData->packedFieldSize);
+    *((jint *) (((jbyte *) statField->parentClass->staticData) +
+                                               statField->fieldOffset)) = 0;
+
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE,
+                            quickBCMethods[idx].maxStack,
+                            quickBCMethods[idx].maxStack,
+                            quickBCMethods[idx].maxLocals);
+    ((JEM_VMFrameExt *) frame)->currentMethod = &(quickMethods[idx]);
+    ((JEM_VMFrameExt *) frame)->lastPC = 0;
+    JEMCC_STORE_OBJECT(frame, 0, holder);
+    JEMCC_STORE_INT(frame, 1, tst->intArg);
+
+    JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+
+    if (env->pendingException != NULL) {
+        (void) fprintf(stderr, "Error: %s field test %i threw exception\n",
+                               tstName, idx + 1);
+        exit(1);
+    }
+    switch (tst->returnType) {
+        case 'I':
+            valid = (retVal->intVal == (jint) tst->intResult);
+            break;
+        case 'J':
+            valid = (retVal->longVal == tst->intResult);
+            break;
+        case 'D':
+            valid = (retVal->dblVal == tst->dblResult);
+            break;
+        case 'F':
+            valid = (retVal->fltVal == (jfloat) tst->dblResult);
+            break;
+        default:
+            valid = (retVal->objVal == holder);
+            break;
+    }
+    if (!valid) {
+        (void) fprintf(stderr, "Error: %s field test %i bad result\n",
+                               tstName, idx + 1);
+        exit(1);
+    }
+}
+
+/* Field access before and after quickening (and repeated execution) */
+static void runQuickFieldTests(JEM_JNIEnv *env) {
+    JEMCC_Class *objClass, *holderClass;
+    struct quick_test_data *tst;
+    JEMCC_Object *holder;
+    jubyte *opPtr;
+    int i, j;
+
+    if (JEMCC_LocateClass((JNIEnv *) env, NULL, "java.lang.Object",
+                          JNI_FALSE, &objClass) != JNI_OK) {
+        (void) fprintf(stderr, "Unable to locate Object class\n");
+        exit(1);
+    }
+    if (JEMCC_CreateStdClass((JNIEnv *) env, NULL, ACC_PUBLIC,
+                             "jemcc.quick.Holder", objClass, NULL, 0,
+                             NULL, 0, NULL, quickHolderFields, QF_STATIC + 1,
+                             NULL, 0, NULL, &holderClass) != JNI_OK) {
+        (void) fprintf(stderr, "Unable to create field holder class\n");
+        exit(1);
+    }
+    for (i = 0; i < QF_STATIC; i++) {
+        quickFieldRefs[i] = (JEM_ClassFieldData *)
+                 JEMCC_GetFieldID((JNIEnv *) env, (jclass) holderClass,
+                                  quickHolderFields[i].name,
+                                  quickHolderFields[i].descriptor);
+    }
+    quickFieldRefs[QF_STATIC] = (JEM_ClassFieldData *)
+             JEMCC_GetStaticFieldID((JNIEnv *) env, (jclass) holderClass,
+                                    quickHolderFields[QF_STATIC].name,
+                                    quickHolderFields[QF_STATIC].descriptor);
+    for (i = 0; i < QF_FAILED; i++) {
+        if (quickFieldRefs[i] == NULL) {
+            (void) fprintf(stderr, "Unable to locate holder field %i\n", i);
+            exit(1);
+        }
+    }
+    failedFieldRef = *(quickFieldRefs[QF_INT]);
+    failedFieldRef.accessFlags |= ACC_RESOLVE_ERROR;
+    quickFieldRefs[QF_FAILED] = &failedFieldRef;
+
+    holder = JEMCC_AllocateObject((JNIEnv *) env, holderClass, 0);
+    if (holder == NULL) {
+        (void) fprintf(stderr, "Unable to allocate field holder\n");
+        exit(1);
+    }
+
+    /* Dummy parent class with a method for each of the test programs */
+    quickParentData.className = "jemcc.quick.Accessor";
+    quickParentData.classFieldRefs = quickFieldRefs;
+    quickParentData.localMethods = quickMethods;
+    quickParentData.localMethodCount = QUICK_TEST_COUNT;
+    quickParent.classData = &quickParentData;
+    for (i = 0; i < QUICK_TEST_COUNT; i++) {
+        quickBCMethods[i].maxStack = 4;
+        quickBCMethods[i].maxLocals = 2;
+        quickBCMethods[i].codeLength = quickTests[i].codeLength;
+        quickBCMethods[i].code = quickTests[i].code;
+        quickMethods[i].name = "access";
+        quickMethods[i].descriptorStr = "()V";
+        quickMethods[i].method.bcMethod = &(quickBCMethods[i]);
+        quickMethods[i].parentClass = &quickParent;
+    }
+
+    /* Standard opcodes, resolved through the field reference table */
+    for (i = 0; i < QUICK_TEST_COUNT; i++) {
+        runQuickTest(env, i, holder, "standard");
+    }
+
+    if (JEM_QuickenClassByteCode((JNIEnv *) env,
+                                 &quickParentData) != JNI_OK) {
+        (void) fprintf(stderr, "Error: field quickening failed\n");
+        exit(1);
+    }
+    for (i = 0; i < QUICK_TEST_COUNT; i++) {
+        tst = &(quickTests[i]);
+        for (j = 0; tst->quick[j] >= 0; j += 2) {
+            opPtr = tst->code + tst->quick[j];
+            if (*opPtr != tst->quick[j + 1]) {
+                (void) fprintf(stderr, "Error: field test %i opcode %i "
+                                       "not quickened\n", i + 1, j / 2);
+                exit(1);
+            }
+            if ((*opPtr >= 0xcb) && (*opPtr <= 0xd6) &&
+                (((opPtr[1] << 8) | opPtr[2]) !=
+                         quickFieldRefs[tst->fieldIdx]->fieldOffset)) {
+                (void) fprintf(stderr, "Error: field test %i opcode %i "
+                                       "bad offset\n", i + 1, j / 2);
+                exit(1);
+            }
+        }
+    }
+    if ((quickTests[QF_INT].code[11] != 0xb4) ||
+        (quickTests[QF_INT].code[13] != QF_FAILED)) {
+        (void) fprintf(stderr, "Error: failed field reference quickened\n");
+        exit(1);
+    }
+
+    /* Quick opcodes, with the rewritten code executed repeatedly */
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < QUICK_TEST_COUNT; i++) {
+            runQuickTest(env, i, holder, "quick");
+        }
+    }
+}
+
+/*
+ * Quickened switch test structures.  Each program loads the integer argument
+ * (local 1) after the given number of nop pads, so that the switch operands
+ * need from zero to three bytes of alignment.  The case targets return ten
+ * plus the case number, the default target returns -1.  For tableswitch the
+ * keys are the consecutive values from the low index.  The final program has
+ * unordered keys, which cannot be searched and must remain unquickened.
+ */
+#define SWITCH_KEY_MAX 5
+#define SWITCH_CODE_MAX 96
+
+static struct switch_test_data {
+    int opcode;
+    int pad;
+    jint lowIndex;
+    int count;
+    jint keys[SWITCH_KEY_MAX];
+    int quickOpCode;
+} switchTests[] = {
+    { 0xaa, 0, -2, 5, { 0 }, 0xd9 },
+    { 0xaa, 1, -2, 5, { 0 }, 0xd9 },
+    { 0xaa, 2, -2, 5, { 0 }, 0xd9 },
+    { 0xaa, 3, -2, 5, { 0 }, 0xd9 },
+    { 0xaa, 1, 100, 1, { 0 }, 0xd9 },
+    { 0xab, 0, 0, 5, { -100000, -5, 0, 7, 65536 }, 0xda },
+    { 0xab, 1, 0, 5, { -100000, -5, 0, 7, 65536 }, 0xda },
+    { 0xab, 2, 0, 5, { -100000, -5, 0, 7, 65536 }, 0xda },
+    { 0xab, 3, 0, 5, { -100000, -5, 0, 7, 65536 }, 0xda },
+    { 0xab, 1, 0, 1, { -7 }, 0xda },
+    { 0xab, 2, 0, 0, { 0 }, 0xda },
+    { 0xab, 0, 0, 2, { 5, 3 }, 0xab }
+};
+
+#define SWITCH_TEST_COUNT \
+              (sizeof(switchTests) / sizeof(struct switch_test_data))
+
+static JEMCC_Class switchParent;
+static JEM_ClassData switchParentData;
+static JEM_ClassMethodData switchMethods[SWITCH_TEST_COUNT];
+static JEM_BCMethod switchBCMethods[SWITCH_TEST_COUNT];
+static jubyte switchCode[SWITCH_TEST_COUNT][SWITCH_CODE_MAX];
+static int switchPCs[SWITCH_TEST_COUNT], switchDefaultPCs[SWITCH_TEST_COUNT];
+
+/* Store a big-endian switch operand */
+static void putSwitchOperand(jubyte *code, int pos, jint val) {
+    code[pos] = (jubyte) ((val >> 24) & 0xFF);
+    code[pos + 1] = (jubyte) ((val >> 16) & 0xFF);
+    code[pos + 2] = (jubyte) ((val >> 8) & 0xFF);
+    code[pos + 3] = (jubyte) (val & 0xFF);
+}
+
+/* Assemble the switch program, returning the code length */
+static int buildSwitchTest(int idx) {
+    struct switch_test_data *tst = &(switchTests[idx]);
+    jubyte *code = switchCode[idx];
+    int i, pc, pos, blockPC;
+
+    for (pos = 0; pos < tst->pad; pos++) code[pos] = 0x00;
+    code[pos++] = 0x1b;
+    pc = switchPCs[idx] = pos;
+    code[pos++] = tst->opcode;
+    while ((pos & 3) != 0) code[pos++] = 0x00;
+
+    /* Target blocks (bipush, ireturn) follow the operands, default first */
+    blockPC = pos + ((tst->opcode == 0xaa) ? 12 + 4 * tst->count :
+                                             8 + 8 * tst->count);
+    switchDefaultPCs[idx] = blockPC;
+    putSwitchOperand(code, pos, blockPC - pc);
+    pos += 4;
+    if (tst->opcode == 0xaa) {
+        putSwitchOperand(code, pos, tst->lowIndex);
+        putSwitchOperand(code, pos + 4, tst->lowIndex + tst->count - 1);
+        pos += 8;
+    } else {
+        putSwitchOperand(code, pos, tst->count);
+        pos += 4;
+    }
+    for (i = 0; i < tst->count; i++) {
+        if (tst->opcode == 0xaa) {
+            tst->keys[i] = tst->lowIndex + i;
+        } else {
+            putSwitchOperand(code, pos, tst->keys[i]);
+            pos += 4;
+        }
+        putSwitchOperand(code, pos, blockPC + 3 * (i + 1) - pc);
+        pos += 4;
+    }
+
+    code[pos++] = 0x10;
+    code[pos++] = 0xff;
+    code[pos++] = 0xac;
+    for (i = 0; i < tst->count; i++) {
+        code[pos++] = 0x10;
+        code[pos++] = (jubyte) (10 + i);
+        code[pos++] = 0xac;
+    }
+
+    return pos;
+}
+
+/* Run the switch program for a value, expecting the first matching case */
+static void runSwitchTest(JEM_JNIEnv *env, int idx, jint value,
+                          const char *tstName) {
+    struct switch_test_data *tst = &(switchTests[idx]);
+    JEMCC_VMFrame *frame;
+    jint i, result = -1;
+
+    for (i = 0; i < tst->count; i++) {
+        if (tst->keys[i] == value) {
+            result = 10 + i;
+            break;
+        }
+    }
+
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE,
+                            switchBCMethods[idx].maxStack,
+                            switchBCMethods[idx].maxStack,
+                            switchBCMethods[idx].maxLocals);
+    ((JEM_VMFrameExt *) frame)->currentMethod = &(switchMethods[idx]);
+    ((JEM_VMFrameExt *) frame)->lastPC = 0;
+    JEMCC_STORE_INT(frame, 1, value);
+
+    JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+
+    if (env->pendingException != NULL) {
+        (void) fprintf(stderr, "Error: %s switch test %i threw exception\n",
+                               tstName, idx + 1);
+        exit(1);
+    }
+    if (env->nativeReturnValue.intVal != result) {
+        (void) fprintf(stderr, "Error: %s switch test %i value %i gave %i\n",
+                               tstName, idx + 1, value,
+                               env->nativeReturnValue.intVal);
+        exit(1);
+    }
+}
+
+/* Probe each key, its neighbours and the integer extremes */
+static void runSwitchProbes(JEM_JNIEnv *env, int idx, const char *tstName) {
+    struct switch_test_data *tst = &(switchTests[idx]);
+    int i;
+
+    runSwitchTest(env, idx, 0, tstName);
+    runSwitchTest(env, idx, (jint) 0x7FFFFFFF, tstName);
+    runSwitchTest(env, idx, -((jint) 0x7FFFFFFF) - 1, tstName);
+    for (i = 0; i < tst->count; i++) {
+        runSwitchTest(env, idx, tst->keys[i] - 1, tstName);
+        runSwitchTest(env, idx, tst->keys[i], tstName);
+        runSwitchTest(env, idx, tst->keys[i] + 1, tstName);
+    }
+}
+
+/* Switch decoding, rewriting and execution before and after quickening */
+static void runQuickSwitchTests(JEM_JNIEnv *env) {
+    struct switch_test_data *tst;
+    JEM_SwitchTable *table;
+    jubyte *opPtr;
+    int i, j;
+
+    switchParentData.className = "jemcc.quick.Switcher";
+    switchParentData.localMethods = switchMethods;
+    switchParentData.localMethodCount = SWITCH_TEST_COUNT;
+    switchParent.classData = &switchParentData;
+    for (i = 0; i < SWITCH_TEST_COUNT; i++) {
+        switchBCMethods[i].maxStack = 2;
+        switchBCMethods[i].maxLocals = 2;
+        switchBCMethods[i].codeLength = buildSwitchTest(i);
+        switchBCMethods[i].code = switchCode[i];
+        switchMethods[i].name = "select";
+        switchMethods[i].descriptorStr = "(I)I";
+        switchMethods[i].method.bcMethod = &(switchBCMethods[i]);
+        switchMethods[i].parentClass = &switchParent;
+    }
+
+    /* Standard opcodes, decoding the aligned operands inline */
+    for (i = 0; i < SWITCH_TEST_COUNT; i++) {
+        runSwitchProbes(env, i, "standard");
+    }
+
+    if (JEM_QuickenClassByteCode((JNIEnv *) env,
+                                 &switchParentData) != JNI_OK) {
+        (void) fprintf(stderr, "Error: switch quickening failed\n");
+        exit(1);
+    }
+    for (i = 0; i < SWITCH_TEST_COUNT; i++) {
+        tst = &(switchTests[i]);
+        opPtr = switchCode[i] + switchPCs[i];
+        if (*opPtr != tst->quickOpCode) {
+            (void) fprintf(stderr, "Error: switch test %i bad opcode %i\n",
+                                   i + 1, *opPtr);
+            exit(1);
+        }
+        if (*opPtr == tst->opcode) continue;
+
+        /* Single switch per method, operand is the first table index */
+        table = switchBCMethods[i].switchTables;
+        if ((switchBCMethods[i].switchTableCount != 1) ||
+            (opPtr[1] != 0) || (opPtr[2] != 0)) {
+            (void) fprintf(stderr, "Error: switch test %i bad table ref\n",
+                                   i + 1);
+            exit(1);
+        }
+        if ((table->defaultPC != switchDefaultPCs[i]) ||
+            (table->count != tst->count) ||
+            ((tst->opcode == 0xaa) && (table->lowIndex != tst->lowIndex))) {
+            (void) fprintf(stderr, "Error: switch test %i bad table\n",
+                                   i + 1);
+            exit(1);
+        }
+        for (j = 0; j < tst->count; j++) {
+            if ((table->targetPCs[j] != switchDefaultPCs[i] + 3 * (j + 1)) ||
+                ((tst->opcode == 0xab) && (table->keys[j] != tst->keys[j]))) {
+                (void) fprintf(stderr, "Error: switch test %i bad entry %i\n",
+                                       i + 1, j);
+                exit(1);
+            }
+        }
+    }
+
+    /* Quick opcodes (and the unordered lookupswitch left as standard) */
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < SWITCH_TEST_COUNT; i++) {
+            runSwitchProbes(env, i, "quick");
+        }
+    }
+}
+
 /* Main program will send the CPU opcodes through their paces */
 int main(int argc, char *argv[]) {
     JEMCC_VMFrame *currentFrame;
+    JEM_VMFrameExt *baseFrame;
     int i, nTestBlocks = sizeof(codeSlices) / sizeof(struct code_test_data);
     JEM_ClassMethodData method;
     JEM_BCMethod bcMethod;
@@ -847,6 +1706,8 @@ int main(int argc, char *argv[]) {
     bcMethod.codeLength = 1000;
     bcMethod.exceptionTable = NULL;
     bcMethod.exceptionTableLength = 0;
+    bcMethod.handlerRangeCount = 0;
+    bcMethod.handlerRanges = NULL;
     method.method.bcMethod = &bcMethod;
     method.name = "testMethod";
     method.descriptorStr = "()V";
@@ -997,12 +1858,52 @@ int main(int argc, char *argv[]) {
                 break;
         }
 
-        /* Clean up locally allocated objects */
-        if (tstArray != NULL) {
-            JEMCC_Free(((JEMCC_ObjectExt *) tstArray)->objectData);
-            JEMCC_Free(tstArray);
+        /* Note: test arrays are released with the allocation blocks */
+    }
+
+    /* Type checks (instanceof, checkcast, aastore) */
+    runSubtypeTests(env, &method);
+    (void) fprintf(stderr, "Subtype tests complete\n");
+
+    /* Inline caches of the quick invoke opcodes */
+    runCallSiteTests(env, &method);
+    (void) fprintf(stderr, "Call site tests complete\n");
+
+    /* Field access through the standard and quickened opcodes */
+    runQuickFieldTests(env);
+    (void) fprintf(stderr, "Quick field tests complete\n");
+
+    /* Decoded switch tables through the standard and quickened opcodes */
+    runQuickSwitchTests(env);
+    (void) fprintf(stderr, "Quick switch tests complete\n");
+
+    /* Deep frame chains (arguments overlap), overflow is an exception */
+    baseFrame = (JEM_VMFrameExt *) env->topFrame;
+    currentFrame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 0, 4, 8);
+    for (i = 0; i < 100000; i++) {
+        JEMCC_PUSH_STACK_INT(currentFrame, i);
+        JEMCC_PUSH_STACK_INT(currentFrame, -i);
+        currentFrame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE,
+                                       2, 4, 8);
+        if (currentFrame == NULL) break;
+        if ((JEMCC_LOAD_INT(currentFrame, 0) != i) ||
+            (JEMCC_LOAD_INT(currentFrame, 1) != -i)) {
+            (void) fprintf(stderr, "Error: invalid frame argument overlap\n");
+            exit(1);
         }
     }
+    if (i < 500) {
+        (void) fprintf(stderr, "Error: frame stack exhausted at %i\n", i);
+        exit(1);
+    }
+    if (i == 100000) {
+        (void) fprintf(stderr, "Error: frame stack did not overflow\n");
+        exit(1);
+    }
+    checkException((JNIEnv *) env, "StackOverflowError", NULL,
+                   "frame overflow");
+    env->topFrame = baseFrame;
+    (void) fprintf(stderr, "Frame overflow at depth %i\n", i);
 
     /* Clean up the test environment */
     destroyTestEnv((JNIEnv *) env);
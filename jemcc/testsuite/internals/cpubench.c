@@ -0,0 +1,219 @@
+/**
+ * JEMCC benchmark program to time the bytecode interpreter dispatch.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+#include "jnifunc.h"
+
+/* External elements from uvminit.c */
+extern JNIEnv *createTestEnv();
+extern void destroyTestEnv(JNIEnv *env);
+
+/* External elements from benchutil.c */
+extern long elapsedMillis(struct timeval *start);
+
+/*
+ * Note: this program is linked twice, against the standard switch based
+ * interpreter (cpubench) and the threaded interpreter (cpubenchthr), so
+ * that the two dispatch modes can be compared (see 'make benchmark').
+ */
+
+/* Local variables: 0 - loop count, 1 - accumulator, 2 - index */
+static jubyte arithCode[] = {
+    0x03,             /*  0: iconst_0 */
+    0x3c,             /*  1: istore_1 */
+    0x03,             /*  2: iconst_0 */
+    0x3d,             /*  3: istore_2 */
+    0x1c,             /*  4: iload_2 */
+    0x1a,             /*  5: iload_0 */
+    0xa2, 0x00, 0x11, /*  6: if_icmpge 23 */
+    0x1b,             /*  9: iload_1 */
+    0x1c,             /* 10: iload_2 */
+    0x60,             /* 11: iadd */
+    0x1c,             /* 12: iload_2 */
+    0x06,             /* 13: iconst_3 */
+    0x68,             /* 14: imul */
+    0x82,             /* 15: ixor */
+    0x3c,             /* 16: istore_1 */
+    0x84, 0x02, 0x01, /* 17: iinc 2, 1 */
+    0xa7, 0xff, 0xf0, /* 20: goto 4 */
+    0x1b,             /* 23: iload_1 */
+    0xac              /* 24: ireturn */
+};
+
+/* Local variables: 0 - array length, 1 - int array, 2 - index, 3 - sum */
+static jubyte arrayCode[] = {
+    0x03,             /*  0: iconst_0 */
+    0x3d,             /*  1: istore_2 */
+    0x1c,             /*  2: iload_2 */
+    0x1a,             /*  3: iload_0 */
+    0xa2, 0x00, 0x0d, /*  4: if_icmpge 17 */
+    0x2b,             /*  7: aload_1 */
+    0x1c,             /*  8: iload_2 */
+    0x1c,             /*  9: iload_2 */
+    0x4f,             /* 10: iastore */
+    0x84, 0x02, 0x01, /* 11: iinc 2, 1 */
+    0xa7, 0xff, 0xf4, /* 14: goto 2 */
+    0x03,             /* 17: iconst_0 */
+    0x3e,             /* 18: istore_3 */
+    0x03,             /* 19: iconst_0 */
+    0x3d,             /* 20: istore_2 */
+    0x1c,             /* 21: iload_2 */
+    0x1a,             /* 22: iload_0 */
+    0xa2, 0x00, 0x0f, /* 23: if_icmpge 38 */
+    0x1d,             /* 26: iload_3 */
+    0x2b,             /* 27: aload_1 */
+    0x1c,             /* 28: iload_2 */
+    0x2e,             /* 29: iaload */
+    0x60,             /* 30: iadd */
+    0x3e,             /* 31: istore_3 */
+    0x84, 0x02, 0x01, /* 32: iinc 2, 1 */
+    0xa7, 0xff, 0xf2, /* 35: goto 21 */
+    0x1d,             /* 38: iload_3 */
+    0xac              /* 39: ireturn */
+};
+
+/* Run the given bytecode block through the interpreter, with arguments */
+static jint runCode(JEM_JNIEnv *env, JEM_ClassMethodData *method,
+                    jint count, JEMCC_Object *array) {
+    JEM_BCMethod *bcMethod = method->method.bcMethod;
+    JEMCC_VMFrame *frame;
+
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 0,
+                            bcMethod->maxLocals, bcMethod->maxStack);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Error: unable to create benchmark frame\n");
+        exit(1);
+    }
+    ((JEM_VMFrameExt *) frame)->currentMethod = method;
+    JEMCC_STORE_INT(frame, 0, count);
+    JEMCC_STORE_OBJECT(frame, 1, array);
+
+    JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+    if (env->pendingException != NULL) {
+        (void) fprintf(stderr, "Error: unexpected benchmark exception\n");
+        exit(1);
+    }
+
+    return env->nativeReturnValue.intVal;
+}
+
+/* Main program will time the various bytecode sequences */
+int main(int argc, char *argv[]) {
+    JEM_ClassMethodData arithMethod, arrayMethod;
+    JEM_BCMethod arithBCMethod, arrayBCMethod;
+    jint i, result, expected, loopCount = 10000000, arrayLength = 10000;
+    JEMCC_Object *intArray;
+    struct timeval start;
+    JEM_JNIEnv *env;
+
+    /* Allow for alternate loop counts for quick runs */
+    if (argc > 1) loopCount = atoi(argv[1]);
+    if (loopCount <= 0) loopCount = 1;
+
+    /* Initialize operating machines */
+    if ((env = (JEM_JNIEnv *) createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Fatal test initialization error\n");
+        exit(1);
+    }
+    if (JEM_InitializeVMClasses((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Fatal core initialization error\n");
+        exit(1);
+    }
+
+    /* Build the bytecode methods for the benchmark sequences */
+    (void) memset(&arithBCMethod, 0, sizeof(JEM_BCMethod));
+    arithBCMethod.maxStack = 4;
+    arithBCMethod.maxLocals = 3;
+    arithBCMethod.codeLength = sizeof(arithCode);
+    arithBCMethod.code = arithCode;
+    (void) memset(&arithMethod, 0, sizeof(JEM_ClassMethodData));
+    arithMethod.method.bcMethod = &arithBCMethod;
+    arithMethod.name = "arithBench";
+    arithMethod.descriptorStr = "(I)I";
+
+    (void) memset(&arrayBCMethod, 0, sizeof(JEM_BCMethod));
+    arrayBCMethod.maxStack = 4;
+    arrayBCMethod.maxLocals = 4;
+    arrayBCMethod.codeLength = sizeof(arrayCode);
+    arrayBCMethod.code = arrayCode;
+    (void) memset(&arrayMethod, 0, sizeof(JEM_ClassMethodData));
+    arrayMethod.method.bcMethod = &arrayBCMethod;
+    arrayMethod.name = "arrayBench";
+    arrayMethod.descriptorStr = "(I[I)I";
+
+    intArray = (JEMCC_Object *) JEMCC_NewIntArray((JNIEnv *) env, arrayLength);
+    if (intArray == NULL) {
+        (void) fprintf(stderr, "Could not create benchmark array\n");
+        exit(1);
+    }
+
+    /* Pure arithmetic/local variable/branch sequence */
+    expected = 0;
+    for (i = 0; i < loopCount; i++) {
+        expected = (jint) (((juint) expected + (juint) i) ^ ((juint) i * 3));
+    }
+    (void) gettimeofday(&start, NULL);
+    result = runCode(env, &arithMethod, loopCount, NULL);
+    (void) fprintf(stderr, "Arithmetic loop (%i iterations): %li ms\n",
+                           loopCount, elapsedMillis(&start));
+    if (result != expected) {
+        (void) fprintf(stderr, "Error: arithmetic loop returned %i not %i\n",
+                               result, expected);
+        exit(1);
+    }
+
+    /* Array store/load sequence */
+    expected = (arrayLength * (arrayLength - 1)) / 2;
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < loopCount / arrayLength; i++) {
+        result = runCode(env, &arrayMethod, arrayLength, intArray);
+        if (result != expected) {
+            (void) fprintf(stderr, "Error: array loop returned %i not %i\n",
+                                   result, expected);
+            exit(1);
+        }
+    }
+    (void) fprintf(stderr, "Array loop (%i x %i elements): %li ms\n",
+                           loopCount / arrayLength, arrayLength,
+                           elapsedMillis(&start));
+
+    /* Clean up the test environment (array is in the allocation blocks) */
+    destroyTestEnv((JNIEnv *) env);
+
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+jint JEM_CallForeignFunction(JNIEnv *env, JEMCC_Object *thisObj, void *fnRef,
+                             union JEM_DescriptorInfo *fnDesc,
+                             JEMCC_ReturnValue *argList,
+                             JEMCC_ReturnValue *retVal) {
+    return JNI_OK;
+}
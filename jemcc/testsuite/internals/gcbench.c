@@ -0,0 +1,352 @@
+/**
+ * JEMCC benchmark program for the parallel mark-sweep heap collector.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+#include "jnifunc.h"
+
+/* External elements from uvminit.c */
+extern JNIEnv *createTestEnv();
+extern void destroyTestEnv(JNIEnv *env);
+
+/* External elements from benchutil.c */
+extern long elapsedMillis(struct timeval *start);
+extern long peakRSS();
+
+/* Frame ejection method from the interpreter (cpu.c) */
+extern void JEM_PopFrame(JNIEnv *env);
+
+/*
+ * The churn phase repeatedly replaces the contents of a holder array with
+ * newly allocated (escaping) int arrays, so that all but the most recent
+ * set are garbage and the heap is bounded only if the collector reclaims
+ * them.  The trace phase builds a large live tree of object arrays and
+ * times explicit collections over it.  A final check verifies that an
+ * array pinned through the JNI element methods survives collection until
+ * released.  Run with different worker counts to compare the parallel
+ * marking (see 'make benchmark').
+ */
+
+/* Local variables: 0 - alloc count, 1 - holder array, 2 - index, 3 - temp */
+static jubyte churnCode[] = {
+    0x03,             /*  0: iconst_0 */
+    0x3d,             /*  1: istore_2 */
+    0x1c,             /*  2: iload_2 */
+    0x1a,             /*  3: iload_0 */
+    0xa2, 0x00, 0x16, /*  4: if_icmpge 26 */
+    0x10, 0x10,       /*  7: bipush 16 */
+    0xbc, 0x0a,       /*  9: newarray int */
+    0x4e,             /* 11: astore_3 */
+    0x2b,             /* 12: aload_1 */
+    0x1c,             /* 13: iload_2 */
+    0x2d,             /* 14: aload_3 */
+    0x53,             /* 15: aastore */
+    0x2d,             /* 16: aload_3 */
+    0x03,             /* 17: iconst_0 */
+    0x1c,             /* 18: iload_2 */
+    0x4f,             /* 19: iastore */
+    0x84, 0x02, 0x01, /* 20: iinc 2, 1 */
+    0xa7, 0xff, 0xeb, /* 23: goto 2 */
+    0x1c,             /* 26: iload_2 */
+    0xac              /* 27: ireturn */
+};
+
+/* Length of the int array used to verify the pinning of array elements */
+#define PIN_LENGTH (64 * 1024)
+
+/* Report the collection count and pause statistics of the VM */
+static void reportPauses(JEM_JavaVM *jvm, const char *name) {
+    (void) fprintf(stderr, "%s: %u collections, last pause %u us, "
+                           "max pause %u us, average pause %li us\n",
+                           name, jvm->gcCount, jvm->gcLastPauseMicros,
+                           jvm->gcMaxPauseMicros, (jvm->gcCount == 0) ? 0 :
+                           (long) (jvm->gcTotalPauseMicros / jvm->gcCount));
+}
+
+/* Run the churn method through the interpreter, with arguments */
+static jint runCode(JEM_JNIEnv *env, JEM_ClassMethodData *method,
+                    jint count, JEMCC_Object *array) {
+    JEM_BCMethod *bcMethod = method->method.bcMethod;
+    JEMCC_VMFrame *frame;
+
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 0,
+                            bcMethod->maxLocals, bcMethod->maxStack);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Error: unable to create benchmark frame\n");
+        exit(1);
+    }
+    ((JEM_VMFrameExt *) frame)->currentMethod = method;
+    JEMCC_STORE_INT(frame, 0, count);
+    JEMCC_STORE_OBJECT(frame, 1, array);
+
+    JEM_ExecuteCurrentFrame((JNIEnv *) env, 0);
+    if (env->pendingException != NULL) {
+        (void) fprintf(stderr, "Error: unexpected benchmark exception\n");
+        exit(1);
+    }
+
+    return env->nativeReturnValue.intVal;
+}
+
+/* Recursively construct a tree of object arrays with int array leaves */
+static JEMCC_Object *buildTree(JEM_JNIEnv *env, jint width, jint depth,
+                               jint *leafIndex) {
+    JEMCC_ArrayObject *node;
+    jint i;
+
+    if (depth == 0) {
+        node = (JEMCC_ArrayObject *) JEMCC_NewIntArray((JNIEnv *) env, 4);
+        if (node == NULL) return NULL;
+        ((jint *) node->arrayData)[0] = (*leafIndex)++;
+        return (JEMCC_Object *) node;
+    }
+
+    node = (JEMCC_ArrayObject *) JEMCC_NewObjectArray((JNIEnv *) env, width,
+                                       (jclass) VM_CLASS(JEMCC_Class_Object),
+                                       NULL);
+    if (node == NULL) return NULL;
+    for (i = 0; i < width; i++) {
+        ((JEMCC_Object **) node->arrayData)[i] = 
+                                  buildTree(env, width, depth - 1, leafIndex);
+        if (((JEMCC_Object **) node->arrayData)[i] == NULL) return NULL;
+    }
+
+    return (JEMCC_Object *) node;
+}
+
+/* Verify the leaves of the tree, returning the number of leaves found */
+static jint verifyTree(JEMCC_Object *obj, jint width, jint depth,
+                       jint *leafIndex) {
+    JEMCC_ArrayObject *node = (JEMCC_ArrayObject *) obj;
+    jint i, count = 0;
+
+    if (depth == 0) {
+        if (((jint *) node->arrayData)[0] != (*leafIndex)++) return -1;
+        return 1;
+    }
+    for (i = 0; i < width; i++) {
+        count += verifyTree(((JEMCC_Object **) node->arrayData)[i], width,
+                            depth - 1, leafIndex);
+    }
+
+    return count;
+}
+
+/* Main program will time the churn and trace collection sequences */
+int main(int argc, char *argv[]) {
+    JEM_ClassMethodData churnMethod, treeMethod;
+    JEM_BCMethod churnBCMethod;
+    jint i, callCount = 100000, allocCount = 100, workerCount = 4;
+    jint width = 16, depth = 4, leafIndex, leafCount, collectCount = 10;
+    JEMCC_Object *holder, **holderData;
+    jintArray pinArray;
+    jint *pinData;
+    jboolean isCopy;
+    JEMCC_VMFrame *frame;
+    struct timeval start;
+    JEM_JavaVM *jvm;
+    JEM_JNIEnv *env;
+    long baseRSS, elapsed;
+
+    /* Allow for alternate call and marking worker counts */
+    if (argc > 1) callCount = atoi(argv[1]);
+    if (callCount <= 0) callCount = 1;
+    if (argc > 2) workerCount = atoi(argv[2]);
+    if (workerCount <= 0) workerCount = 1;
+
+    /* Initialize operating machines */
+    if ((env = (JEM_JNIEnv *) createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Fatal test initialization error\n");
+        exit(1);
+    }
+    if (JEM_InitializeVMClasses((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Fatal core initialization error\n");
+        exit(1);
+    }
+    jvm = env->parentVM;
+    jvm->gcWorkerCount = workerCount;
+
+    /* Build the bytecode method for the churn sequence */
+    (void) memset(&churnBCMethod, 0, sizeof(JEM_BCMethod));
+    churnBCMethod.maxStack = 4;
+    churnBCMethod.maxLocals = 4;
+    churnBCMethod.codeLength = sizeof(churnCode);
+    churnBCMethod.code = churnCode;
+    (void) memset(&churnMethod, 0, sizeof(JEM_ClassMethodData));
+    churnMethod.method.bcMethod = &churnBCMethod;
+    churnMethod.name = "churnBench";
+    churnMethod.descriptorStr = "(I[Ljava/lang/Object;)I";
+
+    holder = (JEMCC_Object *) JEMCC_NewObjectArray((JNIEnv *) env, allocCount,
+                                     (jclass) VM_CLASS(JEMCC_Class_Object),
+                                     NULL);
+    if (holder == NULL) {
+        (void) fprintf(stderr, "Could not create benchmark holder array\n");
+        exit(1);
+    }
+    holderData = (JEMCC_Object **) ((JEMCC_ArrayObject *) holder)->arrayData;
+    baseRSS = peakRSS();
+    (void) fprintf(stderr, "Initial peak RSS %li KB, %i marking workers\n",
+                           baseRSS, workerCount);
+
+    /*
+     * Churn - only the last set of arrays is reachable, so the collections
+     * triggered by the promotions must keep the heap (and RSS) bounded.
+     */
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < callCount; i++) {
+        if (runCode(env, &churnMethod, allocCount, holder) != allocCount) {
+            (void) fprintf(stderr, "Error: churn method returned bad count\n");
+            exit(1);
+        }
+    }
+    elapsed = elapsedMillis(&start);
+    (void) fprintf(stderr, "Churn allocation (%i x %i arrays): %li ms, "
+                           "peak RSS %li KB\n", callCount, allocCount,
+                           elapsed, peakRSS());
+    reportPauses(jvm, "Churn");
+    if ((callCount >= 10000) && (jvm->gcCount == 0)) {
+        (void) fprintf(stderr, "Error: churn did not trigger a collection\n");
+        exit(1);
+    }
+    for (i = 0; i < allocCount; i++) {
+        if ((holderData[i] == NULL) || (((jint *) ((JEMCC_ArrayObject *)
+                                  holderData[i])->arrayData)[0] != i)) {
+            (void) fprintf(stderr, "Error: churn array %i corrupted\n", i);
+            exit(1);
+        }
+    }
+
+    /* Trace - build the tree in a native frame, promoted when popped */
+    (void) memset(&treeMethod, 0, sizeof(JEM_ClassMethodData));
+    treeMethod.name = "treeBench";
+    treeMethod.descriptorStr = "()V";
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_JEMCC, 0, 0, 0);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Error: unable to create tree frame\n");
+        exit(1);
+    }
+    ((JEM_VMFrameExt *) frame)->currentMethod = &treeMethod;
+    leafIndex = 0;
+    holderData[0] = buildTree(env, width, depth, &leafIndex);
+    if (holderData[0] == NULL) {
+        (void) fprintf(stderr, "Could not create benchmark tree\n");
+        exit(1);
+    }
+    JEM_PopFrame((JNIEnv *) env);
+    leafCount = leafIndex;
+
+    jvm->gcMaxPauseMicros = 0;
+    jvm->gcTotalPauseMicros = 0;
+    jvm->gcCount = 0;
+    for (i = 0; i < collectCount; i++) {
+        if (JEM_CollectHeap((JNIEnv *) env) != JNI_OK) {
+            (void) fprintf(stderr, "Error: heap collection failed\n");
+            exit(1);
+        }
+    }
+    (void) fprintf(stderr, "Trace (%i leaves, %u KB live)\n", 
+                           leafCount, jvm->heapObjectBytes / 1024);
+    reportPauses(jvm, "Trace");
+
+    leafIndex = 0;
+    if (verifyTree(holderData[0], width, depth, &leafIndex) != leafCount) {
+        (void) fprintf(stderr, "Error: live tree corrupted by collection\n");
+        exit(1);
+    }
+
+    /* Drop the tree, the next collection must reclaim it */
+    holderData[0] = NULL;
+    if (JEM_CollectHeap((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Error: heap collection failed\n");
+        exit(1);
+    }
+    if (jvm->heapObjectBytes > 64 * 1024) {
+        (void) fprintf(stderr, "Error: %u bytes retained after tree drop\n",
+                               jvm->heapObjectBytes);
+        exit(1);
+    }
+
+    /* A pinned array must survive collection (locals here are not roots) */
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_JEMCC, 0, 0, 0);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Error: unable to create pin frame\n");
+        exit(1);
+    }
+    ((JEM_VMFrameExt *) frame)->currentMethod = &treeMethod;
+    pinArray = (jintArray) JEMCC_NewIntArray((JNIEnv *) env, PIN_LENGTH);
+    if (pinArray == NULL) {
+        (void) fprintf(stderr, "Could not create pinned array\n");
+        exit(1);
+    }
+    JEM_PopFrame((JNIEnv *) env);
+    pinData = JEMCC_GetIntArrayElements((JNIEnv *) env, pinArray, &isCopy);
+    if ((pinData == NULL) || (isCopy != JNI_FALSE) ||
+        (pinData != ((JEMCC_ArrayObject *) pinArray)->arrayData)) {
+        (void) fprintf(stderr, "Error: array elements were not pinned\n");
+        exit(1);
+    }
+    for (i = 0; i < PIN_LENGTH; i++) pinData[i] = i;
+    if (JEM_CollectHeap((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Error: heap collection failed\n");
+        exit(1);
+    }
+    if (jvm->heapObjectBytes < PIN_LENGTH * sizeof(jint)) {
+        (void) fprintf(stderr, "Error: pinned array was collected\n");
+        exit(1);
+    }
+    for (i = 0; i < PIN_LENGTH; i++) {
+        if (pinData[i] != i) {
+            (void) fprintf(stderr, "Error: pinned array corrupted\n");
+            exit(1);
+        }
+    }
+    JEMCC_ReleaseIntArrayElements((JNIEnv *) env, pinArray, pinData, 0);
+    if (JEM_CollectHeap((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Error: heap collection failed\n");
+        exit(1);
+    }
+    if (jvm->heapObjectBytes > 64 * 1024) {
+        (void) fprintf(stderr, "Error: released pinned array retained\n");
+        exit(1);
+    }
+
+    /* Clean up the test environment (objects are in the allocation blocks) */
+    destroyTestEnv((JNIEnv *) env);
+
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+jint JEM_CallForeignFunction(JNIEnv *env, JEMCC_Object *thisObj, void *fnRef,
+                             union JEM_DescriptorInfo *fnDesc,
+                             JEMCC_ReturnValue *argList,
+                             JEMCC_ReturnValue *retVal) {
+    return JNI_OK;
+}
@@ -0,0 +1,375 @@
+/**
+ * JEMCC benchmark program for the hash function quality and throughput.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+
+/* External elements from benchutil.c */
+extern long elapsedMicros(struct timeval *start);
+
+/*
+ * Note: this program is linked twice, against the default group probed
+ * hashtable (hashbench) and the legacy double-hashing table
+ * (hashbenchlegacy), so that the two can be compared (see 'make benchmark').
+ */
+
+/*
+ * The key set models the class names of a large deployment.  The class
+ * names are permutations of common name tokens across packages whose names
+ * are themselves anagrams (svc01/svc10 etc.), the worst case for the
+ * original additive hash.
+ */
+static char *packages[] = {
+    "com/acme/svc01", "com/acme/svc10", "com/acme/svc02", "com/acme/svc20",
+    "com/acme/svc12", "com/acme/svc21", "com/acme/svc03", "com/acme/svc30",
+    "org/acme/svc01", "org/acme/svc10", "org/acme/svc02", "org/acme/svc20",
+    "net/acme/svc13", "net/acme/svc31", "net/acme/svc23", "net/acme/svc32"
+};
+static char *tokens[] = {
+    "Abstract", "Default", "Remote", "Local",
+    "Service", "Factory", "Impl", "Bean"
+};
+#define PACKAGE_COUNT (sizeof(packages) / sizeof(char *))
+#define TOKEN_COUNT (sizeof(tokens) / sizeof(char *))
+
+/* The original additive class name hash, for comparison */
+static juint additiveHashFn(JNIEnv *env, void *key) {
+    char *ptr = (char *) key;
+    juint hashCode = 0;
+
+    while (*ptr != '\0') {
+        hashCode += (*ptr == '/') ? '.' : *ptr;
+        ptr++;
+    }
+    return hashCode;
+}
+
+/* Ordering function for the hashcode sort */
+static int compareHash(const void *a, const void *b) {
+    juint hashA = *((juint *) a), hashB = *((juint *) b);
+
+    if (hashA < hashB) return -1;
+    return (hashA > hashB) ? 1 : 0;
+}
+
+/*
+ * Report the quality of the hash function over the key set, as the number
+ * of distinct hash values, the maximum bucket load and the average number
+ * of key comparisons per (successful) lookup in a chained table masked to
+ * at least twice the key count.  Returns the average comparison count.
+ */
+static double reportQuality(const char *name, JEMCC_KeyHashFn hashFn,
+                            void **keys, int keyCount) {
+    juint *hashes, *loads, mask = 1, maxLoad = 0;
+    int i, distinct = 0;
+    double probes = 0.0;
+
+    while (mask < 2 * (juint) keyCount) mask <<= 1;
+    hashes = (juint *) calloc(keyCount, sizeof(juint));
+    loads = (juint *) calloc(mask, sizeof(juint));
+    if ((hashes == NULL) || (loads == NULL)) {
+        (void) fprintf(stderr, "Error: unable to allocate hash tables\n");
+        exit(1);
+    }
+    mask--;
+
+    for (i = 0; i < keyCount; i++) {
+        hashes[i] = (*hashFn)(NULL, keys[i]);
+        loads[hashes[i] & mask]++;
+        probes += loads[hashes[i] & mask];
+        if (loads[hashes[i] & mask] > maxLoad) {
+            maxLoad = loads[hashes[i] & mask];
+        }
+    }
+    qsort(hashes, keyCount, sizeof(juint), compareHash);
+    for (i = 0; i < keyCount; i++) {
+        if ((i == 0) || (hashes[i] != hashes[i - 1])) distinct++;
+    }
+    probes /= keyCount;
+
+    (void) fprintf(stderr, "%s: %i of %i distinct, max bucket %u, "
+                           "%.2f compares/lookup\n",
+                           name, distinct, keyCount, maxLoad, probes);
+    free(hashes);
+    free(loads);
+
+    return probes;
+}
+
+/* Time the hashing of the key set, reporting the time per key */
+static void reportThroughput(const char *name, JEMCC_KeyHashFn hashFn,
+                             void **keys, int keyCount, int rounds) {
+    struct timeval start;
+    juint total = 0;
+    long elapsed;
+    int i, j;
+
+    (void) gettimeofday(&start, NULL);
+    for (j = 0; j < rounds; j++) {
+        for (i = 0; i < keyCount; i++) total += (*hashFn)(NULL, keys[i]);
+    }
+    elapsed = elapsedMicros(&start);
+
+    (void) fprintf(stderr, "%s: %li us for %i x %i keys, %.1f ns/key "
+                           "(check %u)\n", name, elapsed, rounds, keyCount,
+                           (elapsed * 1000.0) / ((double) rounds * keyCount),
+                           total);
+}
+
+/* Time the lookup of every class name in a populated class table */
+static void reportLookup(const char *name, JEMCC_KeyHashFn hashFn,
+                         char **names, int nameCount, int rounds) {
+    JEMCC_HashTable table;
+    struct timeval start;
+    long elapsed;
+    int i, j;
+
+    if (JEMCC_HashInitTable(NULL, &table, -1) != JNI_OK) {
+        (void) fprintf(stderr, "Error: unable to initialize hashtable\n");
+        exit(1);
+    }
+    for (i = 0; i < nameCount; i++) {
+        if (JEMCC_HashPutEntry(NULL, &table, names[i], names[i], NULL, NULL,
+                               hashFn, JEMCC_ClassNameEqualsFn) != JNI_OK) {
+            (void) fprintf(stderr, "Error: unable to populate hashtable\n");
+            exit(1);
+        }
+    }
+
+    (void) gettimeofday(&start, NULL);
+    for (j = 0; j < rounds; j++) {
+        for (i = 0; i < nameCount; i++) {
+            if (JEMCC_HashGetEntry(NULL, &table, names[i], hashFn,
+                                   JEMCC_ClassNameEqualsFn) != names[i]) {
+                (void) fprintf(stderr, "Error: class name lookup failed\n");
+                exit(1);
+            }
+        }
+    }
+    elapsed = elapsedMicros(&start);
+
+    (void) fprintf(stderr, "%s: %li us for %i x %i lookups, %.1f ns/lookup\n",
+                           name, elapsed, rounds, nameCount,
+                           (elapsed * 1000.0) / ((double) rounds * nameCount));
+    JEMCC_HashDestroyTable(&table);
+}
+
+/*
+ * Time a mixed workload against a class table holding half of the names,
+ * where each step looks up a name (half of which miss) and then replaces
+ * a present entry with an absent one, so that removal markers accumulate.
+ */
+static void reportChurn(const char *name, JEMCC_KeyHashFn hashFn,
+                        char **names, int nameCount, int rounds) {
+    JEMCC_HashTable table;
+    struct timeval start;
+    int i, j, half = nameCount / 2, found = 0;
+    long elapsed;
+
+    if (JEMCC_HashInitTable(NULL, &table, -1) != JNI_OK) {
+        (void) fprintf(stderr, "Error: unable to initialize hashtable\n");
+        exit(1);
+    }
+    for (i = 0; i < half; i++) {
+        if (JEMCC_HashPutEntry(NULL, &table, names[i], names[i], NULL, NULL,
+                               hashFn, JEMCC_ClassNameEqualsFn) != JNI_OK) {
+            (void) fprintf(stderr, "Error: unable to populate hashtable\n");
+            exit(1);
+        }
+    }
+
+    /* Entry (i) is swapped for entry (i + half), alternately each round */
+    (void) gettimeofday(&start, NULL);
+    for (j = 0; j < rounds; j++) {
+        for (i = 0; i < half; i++) {
+            if (JEMCC_HashGetEntry(NULL, &table, names[2 * i + (j & 1)], 
+                                   hashFn, JEMCC_ClassNameEqualsFn) != NULL) {
+                found++;
+            }
+            if (JEMCC_HashRemoveEntry(NULL, &table,
+                                      names[((j & 1) == 0) ? i : i + half],
+                                      NULL, NULL, hashFn,
+                                      JEMCC_ClassNameEqualsFn) != JNI_OK) {
+                (void) fprintf(stderr, "Error: class name removal failed\n");
+                exit(1);
+            }
+            if (JEMCC_HashInsertEntry(NULL, &table,
+                                      names[((j & 1) == 0) ? i + half : i],
+                                      names[i], NULL, NULL, hashFn,
+                                      JEMCC_ClassNameEqualsFn) != JNI_OK) {
+                (void) fprintf(stderr, "Error: class name insert failed\n");
+                exit(1);
+            }
+        }
+    }
+    elapsed = elapsedMicros(&start);
+
+    (void) fprintf(stderr, "%s: %li us for %i x %i lookup/replace, "
+                           "%.1f ns/step (%i found)\n",
+                           name, elapsed, rounds, half,
+                           (elapsed * 1000.0) / ((double) rounds * half),
+                           found);
+    JEMCC_HashDestroyTable(&table);
+}
+
+/* Main program will measure the hash functions over the class name set */
+int main(int argc, char *argv[]) {
+    int i, j, a, b, c, d, len, nameCount = 0, rounds = 20, lookupRounds = 2;
+    void **asciiStrings, **uniStrings;
+    JEMCC_StringData *strData;
+    char **names, buff[256];
+    jchar *uniPtr;
+
+    /* Allow for alternate round counts for quick runs */
+    if (argc > 1) rounds = atoi(argv[1]);
+    if (rounds <= 0) rounds = 1;
+
+    /* Build the class name set (four distinct tokens per name) */
+    names = (char **) calloc(PACKAGE_COUNT * TOKEN_COUNT * TOKEN_COUNT *
+                             TOKEN_COUNT * TOKEN_COUNT, sizeof(char *));
+    if (names == NULL) {
+        (void) fprintf(stderr, "Error: unable to allocate name set\n");
+        exit(1);
+    }
+    for (i = 0; i < PACKAGE_COUNT; i++) {
+        for (a = 0; a < TOKEN_COUNT; a++) {
+            for (b = 0; b < TOKEN_COUNT; b++) {
+                for (c = 0; c < TOKEN_COUNT; c++) {
+                    for (d = 0; d < TOKEN_COUNT; d++) {
+                        if ((a == b) || (a == c) || (a == d) || (b == c) ||
+                            (b == d) || (c == d)) continue;
+                        (void) sprintf(buff, "%s/%s%s%s%s", packages[i],
+                                       tokens[a], tokens[b], tokens[c],
+                                       tokens[d]);
+                        names[nameCount] = strdup(buff);
+                        if (names[nameCount++] == NULL) {
+                            (void) fprintf(stderr, "Error: name dup\n");
+                            exit(1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Build the equivalent String data records, in both forms */
+    asciiStrings = (void **) calloc(nameCount, sizeof(void *));
+    uniStrings = (void **) calloc(nameCount, sizeof(void *));
+    if ((asciiStrings == NULL) || (uniStrings == NULL)) {
+        (void) fprintf(stderr, "Error: unable to allocate string set\n");
+        exit(1);
+    }
+    for (i = 0; i < nameCount; i++) {
+        len = strlen(names[i]);
+        strData = (JEMCC_StringData *) calloc(1, sizeof(JEMCC_StringData) +
+                                                 2 * len + 2);
+        if (strData == NULL) {
+            (void) fprintf(stderr, "Error: unable to allocate string\n");
+            exit(1);
+        }
+        strData->length = -len;
+        (void) strcpy(&(strData->data), names[i]);
+        asciiStrings[i] = strData;
+
+        strData = (JEMCC_StringData *) calloc(1, sizeof(JEMCC_StringData) +
+                                                 2 * len + 2);
+        if (strData == NULL) {
+            (void) fprintf(stderr, "Error: unable to allocate string\n");
+            exit(1);
+        }
+        strData->length = len;
+        uniPtr = (jchar *) &(strData->data);
+        for (j = 0; j < len; j++) uniPtr[j] = (jchar) names[i][j];
+        uniStrings[i] = strData;
+    }
+    (void) fprintf(stderr, "Generated %i class names\n", nameCount);
+
+    /* Distribution of the hash functions over the key set */
+    (void) reportQuality("Additive class name", additiveHashFn,
+                         (void **) names, nameCount);
+    if (reportQuality("Class name", JEMCC_ClassNameHashFn,
+                      (void **) names, nameCount) > 2.0) {
+        (void) fprintf(stderr, "Error: poor class name distribution\n");
+        exit(1);
+    }
+    if (reportQuality("Char sequence", JEMCC_StrHashFn,
+                      (void **) names, nameCount) > 2.0) {
+        (void) fprintf(stderr, "Error: poor char sequence distribution\n");
+        exit(1);
+    }
+    if (reportQuality("ASCII String", JEMCC_StringHashFn,
+                      asciiStrings, nameCount) > 2.0) {
+        (void) fprintf(stderr, "Error: poor ASCII String distribution\n");
+        exit(1);
+    }
+    if (reportQuality("Unicode String", JEMCC_StringHashFn,
+                      uniStrings, nameCount) > 2.0) {
+        (void) fprintf(stderr, "Error: poor Unicode String distribution\n");
+        exit(1);
+    }
+
+    /* Raw hashing throughput */
+    reportThroughput("Additive class name", additiveHashFn,
+                     (void **) names, nameCount, rounds);
+    reportThroughput("Class name", JEMCC_ClassNameHashFn,
+                     (void **) names, nameCount, rounds);
+    reportThroughput("Char sequence", JEMCC_StrHashFn,
+                     (void **) names, nameCount, rounds);
+    reportThroughput("ASCII String", JEMCC_StringHashFn,
+                     asciiStrings, nameCount, rounds);
+    reportThroughput("Unicode String", JEMCC_StringHashFn,
+                     uniStrings, nameCount, rounds);
+
+    /* Class table lookups (the additive case is very slow, fewer rounds) */
+    reportLookup("Additive class table", additiveHashFn, names, nameCount,
+                 lookupRounds);
+    reportLookup("Class table", JEMCC_ClassNameHashFn, names, nameCount,
+                 lookupRounds * rounds);
+    reportChurn("Class table churn", JEMCC_ClassNameHashFn, names, nameCount,
+                lookupRounds * rounds);
+
+    for (i = 0; i < nameCount; i++) {
+        free(names[i]);
+        free(asciiStrings[i]);
+        free(uniStrings[i]);
+    }
+    free(names);
+    free(asciiStrings);
+    free(uniStrings);
+
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+jint JEM_CallForeignFunction(JNIEnv *env, JEMCC_Object *thisObj, void *fnRef,
+                             union JEM_DescriptorInfo *fnDesc,
+                             JEMCC_ReturnValue *argList,
+                             JEMCC_ReturnValue *retVal) {
+    return JNI_OK;
+}
@@ -309,6 +309,13 @@ void JEMCC_Free(void *block) {
     free(block);
 }
 
+/* Collection safe regions are not tracked without the collector */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+}
+
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+}
+
 void JEMCC_ThrowStdThrowableIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
                                 JEMCC_Object *causeThrowable, const char *msg) {
     char *className = "unknown";
@@ -0,0 +1,238 @@
+/**
+ * JEMCC benchmark program for the construction of very large StringBuffers.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+#include "jnifunc.h"
+
+/* External elements from uvminit.c */
+extern JNIEnv *createTestEnv();
+extern void destroyTestEnv(JNIEnv *env);
+
+/* External elements from benchutil.c */
+extern long elapsedMillis(struct timeval *start);
+extern long peakRSS();
+
+/* Frame ejection method from the interpreter (cpu.c) */
+extern void JEM_PopFrame(JNIEnv *env);
+
+/*
+ * Each phase builds a single StringBuffer of the requested size from a
+ * sequence of small appends (in the manner of report generation) and then
+ * converts it to a String.  The mixed phases introduce Unicode (non 8-bit)
+ * text, either regularly or only once the buffer is already large, which
+ * are the cases where the entire buffer would otherwise be widened.
+ */
+#define PHASE_ASCII 0
+#define PHASE_MIXED 1
+#define PHASE_LATE_UNICODE 2
+#define PHASE_NUMERIC 3
+
+/* The StringBuffer methods exercised by the benchmark */
+static JEM_ClassMethodData *initMethod, *appendStrMethod, *appendIntMethod;
+static JEM_ClassMethodData *appendLongMethod, *appendDblMethod;
+static JEM_ClassMethodData *lengthMethod, *toStringMethod;
+
+/* Locate the indicated method in the StringBuffer class */
+static JEM_ClassMethodData *findMethod(JEMCC_Class *bufferClass,
+                                       const char *name, const char *desc) {
+    JEM_ClassData *classData = bufferClass->classData;
+    jint i;
+
+    for (i = 0; i < classData->localMethodCount; i++) {
+        if ((strcmp(classData->localMethods[i].name, name) == 0) &&
+            (strcmp(classData->localMethods[i].descriptorStr, desc) == 0)) {
+            return &(classData->localMethods[i]);
+        }
+    }
+
+    (void) fprintf(stderr, "Error: missing StringBuffer method %s%s\n",
+                           name, desc);
+    exit(1);
+    return NULL;
+}
+
+/* Call the JEMCC method directly, arguments are in the frame locals */
+static JEMCC_ReturnValue callMethod(JEM_JNIEnv *env, JEMCC_VMFrame *frame,
+                                    JEM_ClassMethodData *method) {
+    JEMCC_ReturnValue retVal;
+
+    if ((*(method->method.ccMethod))((JNIEnv *) env, frame,
+                                     &retVal) == JEMCC_ERR) {
+        (void) fprintf(stderr, "Error: unexpected %s failure\n",
+                               method->name);
+        exit(1);
+    }
+
+    return retVal;
+}
+
+/* Build a String of the given size using the appends for the phase */
+static void runPhase(JEM_JNIEnv *env, JEMCC_Class *bufferClass,
+                     const char *name, int phase, jint totalSize) {
+    JEMCC_Object *asciiStr, *uniStr, *buffer;
+    JEMCC_StringData *strData;
+    JEMCC_ReturnValue retVal;
+    JEMCC_VMFrame *frame;
+    struct timeval start;
+    jint length, count;
+    long elapsed;
+
+    asciiStr = JEMCC_GetInternStringUTF((JNIEnv *) env,
+                             "Report line item text, with some detail: ");
+    uniStr = JEMCC_GetInternStringUTF((JNIEnv *) env,
+                             "\xe6\x8a\xa5\xe5\x91\x8a \xce\xb1\xce\xb2 ");
+    buffer = JEMCC_AllocateObject((JNIEnv *) env, bufferClass, 0);
+    if ((asciiStr == NULL) || (uniStr == NULL) || (buffer == NULL)) {
+        (void) fprintf(stderr, "Error: unable to allocate phase objects\n");
+        exit(1);
+    }
+    frame = JEM_CreateFrame((JNIEnv *) env, FRAME_BYTECODE, 0, 4, 4);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Error: unable to create benchmark frame\n");
+        exit(1);
+    }
+    JEMCC_STORE_OBJECT(frame, 0, buffer);
+    (void) callMethod(env, frame, initMethod);
+
+    (void) gettimeofday(&start, NULL);
+    length = 0;
+    count = 0;
+    while (length < totalSize) {
+        if (phase == PHASE_NUMERIC) {
+            JEMCC_STORE_INT(frame, 1, count * 7919);
+            (void) callMethod(env, frame, appendIntMethod);
+            JEMCC_STORE_LONG(frame, 1, ((jlong) count) * 1000000007);
+            (void) callMethod(env, frame, appendLongMethod);
+            JEMCC_STORE_DOUBLE(frame, 1, count / 8.0);
+            (void) callMethod(env, frame, appendDblMethod);
+        } else if (((phase == PHASE_MIXED) && ((count % 16) == 15)) ||
+                   ((phase == PHASE_LATE_UNICODE) &&
+                                     (length > totalSize / 2) &&
+                                     ((count % 1024) == 0))) {
+            JEMCC_STORE_OBJECT(frame, 1, uniStr);
+            (void) callMethod(env, frame, appendStrMethod);
+        } else {
+            JEMCC_STORE_OBJECT(frame, 1, asciiStr);
+            (void) callMethod(env, frame, appendStrMethod);
+            JEMCC_STORE_INT(frame, 1, count);
+            (void) callMethod(env, frame, appendIntMethod);
+        }
+        retVal = callMethod(env, frame, lengthMethod);
+        length = retVal.intVal;
+        count++;
+    }
+    retVal = callMethod(env, frame, toStringMethod);
+    elapsed = elapsedMillis(&start);
+    if (elapsed <= 0) elapsed = 1;
+
+    /* Verify the String result against the buffer */
+    strData = (JEMCC_StringData *)
+                     ((JEMCC_ObjectExt *) retVal.objVal)->objectData;
+    if ((strData->length != length) && (strData->length != -length)) {
+        (void) fprintf(stderr, "Error: %s String length mismatch\n", name);
+        exit(1);
+    }
+    if ((phase == PHASE_ASCII) || (phase == PHASE_NUMERIC)) {
+        if (strData->length >= 0) {
+            (void) fprintf(stderr, "Error: %s String is not ASCII\n", name);
+            exit(1);
+        }
+    } else if (strData->length <= 0) {
+        (void) fprintf(stderr, "Error: %s String is not Unicode\n", name);
+        exit(1);
+    }
+
+    (void) fprintf(stderr, "%s (%i chars, %i appends): %li ms, "
+                           "%li KB/s, peak RSS %li KB\n",
+                           name, length, count, elapsed,
+                           ((long) length / elapsed) * 1000 / 1024,
+                           peakRSS());
+    JEM_PopFrame((JNIEnv *) env);
+}
+
+/* Main program will time the various StringBuffer constructions */
+int main(int argc, char *argv[]) {
+    JEMCC_Class *bufferClass;
+    jint totalSize = 8 * 1024 * 1024;
+    JEM_JNIEnv *env;
+
+    /* Allow for alternate buffer sizes for quick runs */
+    if (argc > 1) totalSize = atoi(argv[1]);
+    if (totalSize <= 0) totalSize = 1;
+
+    /* Initialize operating machines */
+    if ((env = (JEM_JNIEnv *) createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Fatal test initialization error\n");
+        exit(1);
+    }
+    if (JEM_InitializeVMClasses((JNIEnv *) env) != JNI_OK) {
+        (void) fprintf(stderr, "Fatal core initialization error\n");
+        exit(1);
+    }
+
+    /* Find the StringBuffer methods to be timed */
+    if (JEMCC_LocateClass((JNIEnv *) env, NULL, "java.lang.StringBuffer",
+                          JNI_FALSE, &bufferClass) != JNI_OK) {
+        (void) fprintf(stderr, "Error: unable to locate StringBuffer\n");
+        exit(1);
+    }
+    initMethod = findMethod(bufferClass, "<init>", "()V");
+    appendStrMethod = findMethod(bufferClass, "append",
+                            "(Ljava/lang/String;)Ljava/lang/StringBuffer;");
+    appendIntMethod = findMethod(bufferClass, "append",
+                                 "(I)Ljava/lang/StringBuffer;");
+    appendLongMethod = findMethod(bufferClass, "append",
+                                  "(J)Ljava/lang/StringBuffer;");
+    appendDblMethod = findMethod(bufferClass, "append",
+                                 "(D)Ljava/lang/StringBuffer;");
+    lengthMethod = findMethod(bufferClass, "length", "()I");
+    toStringMethod = findMethod(bufferClass, "toString",
+                                "()Ljava/lang/String;");
+    (void) fprintf(stderr, "Initial peak RSS %li KB\n", peakRSS());
+
+    runPhase(env, bufferClass, "ASCII appends", PHASE_ASCII, totalSize);
+    runPhase(env, bufferClass, "Mixed appends", PHASE_MIXED, totalSize);
+    runPhase(env, bufferClass, "Late Unicode appends", PHASE_LATE_UNICODE,
+             totalSize);
+    runPhase(env, bufferClass, "Numeric appends", PHASE_NUMERIC, totalSize);
+
+    /* Clean up the test environment */
+    destroyTestEnv((JNIEnv *) env);
+
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+jint JEM_CallForeignFunction(JNIEnv *env, JEMCC_Object *thisObj, void *fnRef,
+                             union JEM_DescriptorInfo *fnDesc,
+                             JEMCC_ReturnValue *argList,
+                             JEMCC_ReturnValue *retVal) {
+    return JNI_OK;
+}
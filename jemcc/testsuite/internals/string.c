@@ -21,9 +21,11 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #include "jeminc.h"
+#include <sys/time.h>
 
 /* Read the JNI/JEMCC internal details */
 #include "jem.h"
+#include "numerics.h"
 
 /* External elements from uvminit.c */
 extern JNIEnv *createTestEnv();
@@ -33,6 +35,10 @@ extern void destroyTestEnv(JNIEnv *env);
 /* From jnifunc.h */
 extern jstring JEMCC_NewStringUTF(JNIEnv *env, const char *utf);
 extern jstring JEMCC_NewString(JNIEnv *env, const jchar *unicode, jsize len);
+extern jcharArray JEMCC_NewCharArray(JNIEnv *env, jsize len);
+
+/* Frame ejection method from the interpreter (cpu.c) */
+extern void JEM_PopFrame(JNIEnv *env);
 
 /* Test flags/data values for condition setups and tests */
 int failureTotal;
@@ -71,8 +77,10 @@ void checkException(const char *checkClassName, const char *checkMsg,
     }
 }
 
-/* Forward declaration */
+/* Forward declarations */
 void doValidScan();
+void doStringBufferTests();
+void doInternBenchmark(int threadCount);
 
 struct tstStringData {
     int length;
@@ -83,11 +91,15 @@ static struct tstStringData tstStringDataA, tstStringDataB;
 
 /* Send the JEMCC class definition methods through their paces */
 int main(int argc, char *argv[]) {
+    int threadCount = 4;
     char mixedAscii[] = { 0x41, 0x73, 0x63, 0x69, 0x69, 0xBE, 0xA2, 0x0 };
+    char latinUtf[] = { 0x41, 0x73, 0x63, 0xC2, 0xA2, 0xC3, 0xA9, 0x0 };
     jchar uniAscii[] = { 0x41, 0x73, 0x63, 0x69, 0x69 };
     jchar unicode[] = { 0x55, 0x6E, 0x69, 0xA6F2 };
     JEMCC_StringData *tstStringA = (JEMCC_StringData *) &tstStringDataA, 
                      *tstStringB = (JEMCC_StringData *) &tstStringDataB;
+    jboolean isCompact;
+    jsize validLen;
 
     /* No memory test just yet */
 #ifdef ENABLE_ERRORSWEEP
@@ -95,6 +107,9 @@ int main(int argc, char *argv[]) {
 #endif
     quietMode = JNI_TRUE;
 
+    /* Allow for alternate thread counts for the intern() benchmark */
+    if (argc > 1) threadCount = atoi(argv[1]);
+
     /* Basic test cases */
     if (JEMCC_UTFStrIsAscii("This is a plain ASCII string!!") != JNI_TRUE) {
         (void) fprintf(stderr, "Invalid return for ASCII UTF string\n");
@@ -155,6 +170,76 @@ int main(int argc, char *argv[]) {
         (void) fprintf(stderr, "Invalid return for uni string != compare\n");
         exit(1);
     }
+    if (JEM_StringCompare(tstStringA, tstStringB) != 0xA6F2 - 'x') {
+        (void) fprintf(stderr, "Invalid return for uni string ordering\n");
+        exit(1);
+    }
+
+    /* Character kernels, with lengths spanning several blocks */
+    tstStringDataA.length = -40;
+    (void) strcpy(tstStringDataA.data,
+                  "abcdefghijabcdefghijabcdefghijabcdefgXij");
+    tstStringDataB.length = -3;
+    (void) strcpy(tstStringDataB.data, "gXi");
+    if (JEMCC_StringString(NULL, tstStringA, tstStringB, 0) != 36) {
+        (void) fprintf(stderr, "Invalid return for ASCII string search\n");
+        exit(1);
+    }
+    if (JEMCC_StringChar(NULL, tstStringA, 'X', 3) != 37) {
+        (void) fprintf(stderr, "Invalid return for ASCII char search\n");
+        exit(1);
+    }
+    if (JEM_StringCompare(tstStringA, tstStringB) != 'a' - 'g') {
+        (void) fprintf(stderr, "Invalid return for ASCII string ordering\n");
+        exit(1);
+    }
+    JEM_StrWiden((jchar *) tstStringDataB.data,
+                 (jubyte *) tstStringDataA.data, 40);
+    tstStringDataB.length = 40;
+    if ((JEMCC_StringString(NULL, tstStringB, tstStringA, 0) != 0) ||
+            (JEM_StringCompare(tstStringA, tstStringB) != 0)) {
+        (void) fprintf(stderr, "Invalid return for widened string\n");
+        exit(1);
+    }
+    *(((jchar *) tstStringDataB.data) + 5) = 0x100;
+    if ((JEM_StrScanChar((jchar *) tstStringDataB.data, 40, 0x100) != 5) ||
+            (JEMCC_UnicodeStrIsAscii((jchar *) tstStringDataB.data,
+                                     40) != JNI_FALSE)) {
+        (void) fprintf(stderr, "Invalid return for Unicode char scan\n");
+        exit(1);
+    }
+    tstStringDataA.length = -4;
+    (void) strcpy(tstStringDataA.data, "gXij");
+    if (JEMCC_StringString(NULL, tstStringB, tstStringA, 0) != 36) {
+        (void) fprintf(stderr, "Invalid return for mixed string search\n");
+        exit(1);
+    }
+
+    /* Modified UTF-8 scan, compact decode and encode round trip */
+    if ((JEM_UTFScan((jubyte *) latinUtf, 7, &validLen,
+                     &isCompact) != 5) || (validLen != 7) ||
+            (isCompact != JNI_TRUE)) {
+        (void) fprintf(stderr, "Invalid return for UTF-8 scan\n");
+        exit(1);
+    }
+    tstStringDataA.length = -JEM_UTFDecode((jubyte *) latinUtf, 7,
+                                           tstStringDataA.data, JNI_TRUE);
+    tstStringDataA.data[5] = '\0';
+    if ((tstStringDataA.length != -5) ||
+            (((jubyte *) tstStringDataA.data)[4] != 0xE9) ||
+            (JEM_UTFEncodedLength(tstStringA) != 7)) {
+        (void) fprintf(stderr, "Invalid return for UTF-8 decode\n");
+        exit(1);
+    }
+    JEM_UTFEncode(tstStringA, tstStringDataB.data);
+    if (strcmp(tstStringDataB.data, latinUtf) != 0) {
+        (void) fprintf(stderr, "Invalid return for UTF-8 encode\n");
+        exit(1);
+    }
+    if (JEM_UTFScan((jubyte *) "ab\xF0\x9F", 4, &validLen, NULL) != 2) {
+        (void) fprintf(stderr, "Invalid return for malformed UTF-8\n");
+        exit(1);
+    }
 
     /* Memory failure scanning */
 #ifdef ENABLE_ERRORSWEEP
@@ -172,6 +257,8 @@ int main(int argc, char *argv[]) {
 #else
     failureTotal = 0;
     doValidScan();
+    doStringBufferTests();
+    doInternBenchmark(threadCount);
 #endif
 
     (void) fprintf(stderr, "All tests passed successfully (%i forced)\n",
@@ -909,6 +996,457 @@ void doValidScan() {
     destroyTestEnv(env);
 }
 
+/*
+ * Content tests for the chunked StringBuffer.  The buffers are built well
+ * beyond the chunk size (64K characters) from small appends, alongside an
+ * expected copy of the text, and are verified character by character
+ * through charAt() (against the chunks) and toString() (flattened), as well
+ * as after each of the operations which flatten the chunks.
+ */
+#define SB_CHUNK_SIZE 65536
+#define SB_BUILD_SIZE (3 * SB_CHUNK_SIZE + 1000)
+#define SB_EXPECT_SIZE (SB_BUILD_SIZE + 1024)
+
+#define SB_ASCII 0
+#define SB_MIXED 1
+#define SB_LATE_UNICODE 2
+
+static JEMCC_Class *sbClass;
+static JEMCC_Object *sbAsciiStr, *sbUniStr;
+static jchar sbExpected[SB_EXPECT_SIZE];
+static jint sbExpectedLen;
+
+/* Call the named StringBuffer method directly (arguments in the locals) */
+static JEMCC_ReturnValue sbCall(JNIEnv *env, JEMCC_VMFrame *frame,
+                                const char *name, const char *desc) {
+    JEM_ClassData *classData = sbClass->classData;
+    JEM_ClassMethodData *method = NULL;
+    JEMCC_ReturnValue retVal;
+    jint i;
+
+    for (i = 0; i < classData->localMethodCount; i++) {
+        if ((strcmp(classData->localMethods[i].name, name) == 0) &&
+            (strcmp(classData->localMethods[i].descriptorStr, desc) == 0)) {
+            method = &(classData->localMethods[i]);
+            break;
+        }
+    }
+    if (method == NULL) {
+        (void) fprintf(stderr, "Error: missing StringBuffer method %s%s\n",
+                               name, desc);
+        exit(1);
+    }
+    if ((*(method->method.ccMethod))(env, frame, &retVal) == JEMCC_ERR) {
+        (void) fprintf(stderr, "Error: unexpected StringBuffer %s failure\n",
+                               name);
+        exit(1);
+    }
+
+    return retVal;
+}
+
+/* Append the ASCII text to the expected text */
+static void sbExpectText(const char *text) {
+    while (*text != '\0') sbExpected[sbExpectedLen++] = (jubyte) *(text++);
+}
+
+/* Insert the String characters into the expected text at the index */
+static void sbExpectString(JEMCC_Object *str, jint index) {
+    JEMCC_StringData *strData = (JEMCC_StringData *)
+                                      ((JEMCC_ObjectExt *) str)->objectData;
+    jint i, len = abs(strData->length);
+
+    (void) memmove(sbExpected + index + len, sbExpected + index,
+                   (sbExpectedLen - index) * sizeof(jchar));
+    for (i = 0; i < len; i++) {
+        if (strData->length < 0) {
+            sbExpected[index + i] = ((jubyte *) &(strData->data))[i];
+        } else {
+            sbExpected[index + i] = ((jchar *) &(strData->data))[i];
+        }
+    }
+    sbExpectedLen += len;
+}
+
+/*
+ * Build a new StringBuffer (in local zero of the frame) from String,
+ * character and numeric appends, with Unicode text appearing according to
+ * the mode (regularly, only once two chunks are full or never).
+ */
+static void sbBuild(JNIEnv *env, JEMCC_VMFrame *frame, int mode) {
+    JEMCC_Object *buffer;
+    char buff[64];
+    jint count = 0;
+
+    buffer = JEMCC_AllocateObject(env, sbClass, 0);
+    if (buffer == NULL) {
+        (void) fprintf(stderr, "Error: unable to allocate StringBuffer\n");
+        exit(1);
+    }
+    JEMCC_STORE_OBJECT(frame, 0, buffer);
+    (void) sbCall(env, frame, "<init>", "()V");
+    sbExpectedLen = 0;
+
+    while (sbExpectedLen < SB_BUILD_SIZE) {
+        JEMCC_STORE_OBJECT(frame, 1, sbAsciiStr);
+        (void) sbCall(env, frame, "append",
+                      "(Ljava/lang/String;)Ljava/lang/StringBuffer;");
+        sbExpectString(sbAsciiStr, sbExpectedLen);
+
+        JEMCC_STORE_INT(frame, 1, count * 7919 - 100000);
+        (void) sbCall(env, frame, "append", "(I)Ljava/lang/StringBuffer;");
+        JEMCC_IntegerToText(count * 7919 - 100000, 10, buff);
+        sbExpectText(buff);
+
+        if ((count % 5) == 0) {
+            JEMCC_STORE_LONG(frame, 1, ((jlong) count) * -1000000007);
+            (void) sbCall(env, frame, "append",
+                          "(J)Ljava/lang/StringBuffer;");
+            JEMCC_LongToText(((jlong) count) * -1000000007, 10, buff);
+            sbExpectText(buff);
+
+            JEMCC_STORE_FLOAT(frame, 1, count / 4.0f);
+            (void) sbCall(env, frame, "append",
+                          "(F)Ljava/lang/StringBuffer;");
+            JEMCC_FloatToText(count / 4.0f, buff);
+            sbExpectText(buff);
+
+            JEMCC_STORE_DOUBLE(frame, 1, count / 8.0 - 3.0);
+            (void) sbCall(env, frame, "append",
+                          "(D)Ljava/lang/StringBuffer;");
+            JEMCC_DoubleToText(count / 8.0 - 3.0, buff);
+            sbExpectText(buff);
+        }
+
+        if (((mode == SB_MIXED) && ((count % 50) == 49)) ||
+                ((mode == SB_LATE_UNICODE) &&
+                        (sbExpectedLen > 2 * SB_CHUNK_SIZE) &&
+                        ((count % 500) == 0))) {
+            JEMCC_STORE_OBJECT(frame, 1, sbUniStr);
+            (void) sbCall(env, frame, "append",
+                          "(Ljava/lang/String;)Ljava/lang/StringBuffer;");
+            sbExpectString(sbUniStr, sbExpectedLen);
+            JEMCC_STORE_INT(frame, 1, 0x3B1);
+            (void) sbCall(env, frame, "append",
+                          "(C)Ljava/lang/StringBuffer;");
+            sbExpected[sbExpectedLen++] = 0x3B1;
+        }
+        count++;
+    }
+}
+
+/* Verify the length and each character of the buffer through charAt() */
+static void sbCheckChars(JNIEnv *env, JEMCC_VMFrame *frame,
+                         const char *tstName) {
+    JEMCC_ReturnValue retVal;
+    jint i;
+
+    retVal = sbCall(env, frame, "length", "()I");
+    if (retVal.intVal != sbExpectedLen) {
+        (void) fprintf(stderr, "Error: %s length %i, expected %i\n",
+                               tstName, retVal.intVal, sbExpectedLen);
+        exit(1);
+    }
+    for (i = 0; i < sbExpectedLen; i++) {
+        JEMCC_STORE_INT(frame, 1, i);
+        retVal = sbCall(env, frame, "charAt", "(I)C");
+        if (retVal.intVal != sbExpected[i]) {
+            (void) fprintf(stderr, "Error: %s charAt(%i) mismatch\n",
+                                   tstName, i);
+            exit(1);
+        }
+    }
+}
+
+/* Verify the buffer contents through toString() (and charAt() after) */
+static void sbCheckString(JNIEnv *env, JEMCC_VMFrame *frame,
+                          const char *tstName, jboolean isAscii) {
+    JEMCC_StringData *strData;
+    JEMCC_ReturnValue retVal;
+    jint i, len;
+
+    retVal = sbCall(env, frame, "toString", "()Ljava/lang/String;");
+    strData = (JEMCC_StringData *)
+                     ((JEMCC_ObjectExt *) retVal.objVal)->objectData;
+    len = strData->length;
+    if (((isAscii == JNI_TRUE) && (len > 0)) ||
+            ((isAscii == JNI_FALSE) && (len < 0))) {
+        (void) fprintf(stderr, "Error: %s String has the wrong form\n",
+                               tstName);
+        exit(1);
+    }
+    if (abs(len) != sbExpectedLen) {
+        (void) fprintf(stderr, "Error: %s String length %i, expected %i\n",
+                               tstName, abs(len), sbExpectedLen);
+        exit(1);
+    }
+    for (i = 0; i < sbExpectedLen; i++) {
+        if (((len < 0) ? ((jubyte *) &(strData->data))[i] :
+                         ((jchar *) &(strData->data))[i]) != sbExpected[i]) {
+            (void) fprintf(stderr, "Error: %s String mismatch at %i\n",
+                                   tstName, i);
+            exit(1);
+        }
+    }
+    sbCheckChars(env, frame, tstName);
+}
+
+void doStringBufferTests() {
+    JEMCC_ArrayObject *arr;
+    JEMCC_VMFrame *frame;
+    jint i, start, end;
+    jchar jch;
+    JNIEnv *env;
+
+    if ((env = createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Unexpected fatal error during env setup\n");
+        exit(1);
+    }
+    if (JEM_InitializeVMClasses(env) != JNI_OK) {
+        (void) fprintf(stderr, "Unexpected fatal error during class init\n");
+        exit(1);
+    }
+    if (JEMCC_LocateClass(env, NULL, "java.lang.StringBuffer",
+                          JNI_FALSE, &sbClass) != JNI_OK) {
+        (void) fprintf(stderr, "Error: unable to locate StringBuffer\n");
+        exit(1);
+    }
+    frame = JEM_CreateFrame(env, FRAME_BYTECODE, 0, 6, 4);
+    if (frame == NULL) {
+        (void) fprintf(stderr, "Unexpected fatal error during frame init\n");
+        exit(1);
+    }
+    sbAsciiStr = JEMCC_GetInternStringUTF(env, "Report line item text: ");
+    sbUniStr = JEMCC_GetInternStringUTF(env, "\xe6\x8a\xa5\xe5\x91\x8a "
+                                             "\xce\xb1\xce\xb2 ");
+    if ((sbAsciiStr == NULL) || (sbUniStr == NULL)) {
+        (void) fprintf(stderr, "Error: unable to allocate test Strings\n");
+        exit(1);
+    }
+
+    /* ASCII chunks, before and after sharing the result with a String */
+    sbBuild(env, frame, SB_ASCII);
+    sbCheckChars(env, frame, "ASCII chunks");
+    sbCheckString(env, frame, "ASCII chunks", JNI_TRUE);
+    JEMCC_STORE_INT(frame, 1, -12345);
+    (void) sbCall(env, frame, "append", "(I)Ljava/lang/StringBuffer;");
+    sbExpectText("-12345");
+    sbCheckString(env, frame, "ASCII shared append", JNI_TRUE);
+
+    /* Mixed ASCII and Unicode chunks */
+    sbBuild(env, frame, SB_MIXED);
+    sbCheckChars(env, frame, "Mixed chunks");
+    sbCheckString(env, frame, "Mixed chunks", JNI_FALSE);
+
+    /* Insert into the ASCII chunks (Unicode working buffer) */
+    sbBuild(env, frame, SB_LATE_UNICODE);
+    sbCheckChars(env, frame, "Late Unicode chunks");
+    JEMCC_STORE_INT(frame, 1, SB_CHUNK_SIZE - 3);
+    JEMCC_STORE_OBJECT(frame, 2, sbUniStr);
+    (void) sbCall(env, frame, "insert",
+                  "(ILjava/lang/String;)Ljava/lang/StringBuffer;");
+    sbExpectString(sbUniStr, SB_CHUNK_SIZE - 3);
+    sbCheckString(env, frame, "Chunked insert", JNI_FALSE);
+
+    /* Reverse of the mixed chunks */
+    sbBuild(env, frame, SB_MIXED);
+    (void) sbCall(env, frame, "reverse", "()Ljava/lang/StringBuffer;");
+    for (i = 0; i < sbExpectedLen / 2; i++) {
+        jch = sbExpected[i];
+        sbExpected[i] = sbExpected[sbExpectedLen - i - 1];
+        sbExpected[sbExpectedLen - i - 1] = jch;
+    }
+    sbCheckString(env, frame, "Chunked reverse", JNI_FALSE);
+
+    /* Character replacement in the ASCII chunks (widens the result) */
+    sbBuild(env, frame, SB_ASCII);
+    JEMCC_STORE_INT(frame, 1, SB_CHUNK_SIZE + 5);
+    JEMCC_STORE_INT(frame, 2, 0x3B1);
+    (void) sbCall(env, frame, "setCharAt", "(IC)V");
+    sbExpected[SB_CHUNK_SIZE + 5] = 0x3B1;
+    sbCheckString(env, frame, "Chunked setCharAt", JNI_FALSE);
+
+    /* Truncate into the sealed chunks (dropping the Unicode), then extend */
+    sbBuild(env, frame, SB_LATE_UNICODE);
+    JEMCC_STORE_INT(frame, 1, SB_CHUNK_SIZE + 10);
+    (void) sbCall(env, frame, "setLength", "(I)V");
+    sbExpectedLen = SB_CHUNK_SIZE + 10;
+    sbCheckString(env, frame, "Chunked truncate", JNI_TRUE);
+    sbBuild(env, frame, SB_MIXED);
+    JEMCC_STORE_INT(frame, 1, sbExpectedLen + 20);
+    (void) sbCall(env, frame, "setLength", "(I)V");
+    for (i = 0; i < 20; i++) sbExpected[sbExpectedLen++] = 0;
+    sbCheckString(env, frame, "Chunked extend", JNI_FALSE);
+
+    /* Extract a region spanning all of the chunk boundaries */
+    sbBuild(env, frame, SB_MIXED);
+    start = 100;
+    end = sbExpectedLen - 100;
+    arr = (JEMCC_ArrayObject *) JEMCC_NewCharArray(env, end - start + 2);
+    if (arr == NULL) {
+        (void) fprintf(stderr, "Error: unable to allocate char array\n");
+        exit(1);
+    }
+    JEMCC_STORE_INT(frame, 1, start);
+    JEMCC_STORE_INT(frame, 2, end);
+    JEMCC_STORE_OBJECT(frame, 3, (JEMCC_Object *) arr);
+    JEMCC_STORE_INT(frame, 4, 2);
+    (void) sbCall(env, frame, "getChars", "(II[CI)V");
+    if (memcmp(((jchar *) arr->arrayData) + 2, sbExpected + start,
+               (end - start) * sizeof(jchar)) != 0) {
+        (void) fprintf(stderr, "Error: chunked getChars mismatch\n");
+        exit(1);
+    }
+    sbCheckString(env, frame, "Chunked getChars", JNI_FALSE);
+
+    JEM_PopFrame(env);
+    destroyTestEnv(env);
+}
+
+/* Shared data for the multi-threaded intern() benchmark */
+#define INTERN_KEY_COUNT 4096
+#define INTERN_ROUNDS 50
+#define INTERN_MAX_THREADS 16
+static char internKeys[INTERN_KEY_COUNT][32];
+static JEMCC_Object *internResults[INTERN_MAX_THREADS][INTERN_KEY_COUNT];
+static int internIndices[INTERN_MAX_THREADS];
+static JEMCC_SysMonitor *internMonitor;
+static int internStarted, internActive;
+
+/* Thread method for the intern() benchmark, interns the key set repeatedly */
+void *internBenchFn(JNIEnv *env, void *userArg) {
+    int i, j, k, idx = *((int *) userArg);
+    JEMCC_Object *str;
+
+    if (JEM_CreateFrame(env, FRAME_JEMCC, 0, -1, 16) == NULL) {
+        (void) fprintf(stderr, "Error: unable to create intern frame\n");
+        exit(1);
+    }
+
+    /* Wait for all of the threads to be ready */
+    JEMCC_EnterSysMonitor(internMonitor);
+    while (internStarted == 0) (void) JEMCC_SysMonitorWait(internMonitor);
+    (void) JEMCC_ExitSysMonitor(internMonitor);
+
+    /* Each thread starts at a different point in the key set */
+    for (j = 0; j < INTERN_ROUNDS; j++) {
+        for (i = 0; i < INTERN_KEY_COUNT; i++) {
+            k = (i + idx * (INTERN_KEY_COUNT / INTERN_MAX_THREADS)) %
+                                                        INTERN_KEY_COUNT;
+            str = JEMCC_GetInternStringUTF(env, internKeys[k]);
+            if (str == NULL) {
+                (void) fprintf(stderr, "Error: intern failure in thread\n");
+                exit(1);
+            }
+            if (j == 0) {
+                internResults[idx][k] = str;
+            } else if (internResults[idx][k] != str) {
+                (void) fprintf(stderr, "Error: unstable intern instance\n");
+                exit(1);
+            }
+        }
+    }
+
+    JEMCC_EnterSysMonitor(internMonitor);
+    internActive--;
+    (void) JEMCC_SysMonitorNotifyAll(internMonitor);
+    (void) JEMCC_ExitSysMonitor(internMonitor);
+
+    return NULL;
+}
+
+/*
+ * Time the concurrent intern() of a key set, half of which is already
+ * present in the table (lookups) and half of which is inserted by the
+ * racing threads.  All threads must obtain the same String instances.
+ */
+void doInternBenchmark(int threadCount) {
+    JEMCC_Object *preStrs[INTERN_KEY_COUNT / 2];
+    struct timeval start, end;
+    JNIEnv *env;
+    long elapsed;
+    int i, j;
+
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > INTERN_MAX_THREADS) threadCount = INTERN_MAX_THREADS;
+
+    if ((env = createTestEnv()) == NULL) {
+        (void) fprintf(stderr, "Unexpected fatal error during env setup\n");
+        exit(1);
+    }
+    if (JEM_InitializeVMClasses(env) != JNI_OK) {
+        (void) fprintf(stderr, "Unexpected fatal error during class init\n");
+        exit(1);
+    }
+    if (JEM_CreateFrame(env, FRAME_JEMCC, 0, -1, 16) == NULL) {
+        (void) fprintf(stderr, "Unexpected fatal error during frame init\n");
+        exit(1);
+    }
+    if ((internMonitor = JEMCC_CreateSysMonitor(env)) == NULL) {
+        (void) fprintf(stderr, "Unexpected fatal error on monitor init\n");
+        exit(1);
+    }
+
+    for (i = 0; i < INTERN_KEY_COUNT; i++) {
+        (void) sprintf(internKeys[i], "intern.bench.Key%i", i);
+        if (i < INTERN_KEY_COUNT / 2) {
+            preStrs[i] = JEMCC_GetInternStringUTF(env, internKeys[i]);
+            if (preStrs[i] == NULL) {
+                (void) fprintf(stderr, "Error: intern key setup failed\n");
+                exit(1);
+            }
+        }
+    }
+
+    /* Start the threads, then release them together */
+    internStarted = 0;
+    internActive = threadCount;
+    for (i = 0; i < threadCount; i++) {
+        internIndices[i] = i;
+        if (JEMCC_CreateThread(env, internBenchFn, 
+                               &(internIndices[i]), 1) == 0) {
+            (void) fprintf(stderr, "Error: intern thread create failure\n");
+            exit(1);
+        }
+    }
+    JEMCC_EnterSysMonitor(internMonitor);
+    (void) gettimeofday(&start, NULL);
+    internStarted = 1;
+    (void) JEMCC_SysMonitorNotifyAll(internMonitor);
+    while (internActive > 0) (void) JEMCC_SysMonitorWait(internMonitor);
+    (void) gettimeofday(&end, NULL);
+    (void) JEMCC_ExitSysMonitor(internMonitor);
+    elapsed = (end.tv_sec - start.tv_sec) * 1000000 +
+                                   (end.tv_usec - start.tv_usec);
+
+    /* Every thread must have seen the same instance for each key */
+    for (i = 0; i < INTERN_KEY_COUNT; i++) {
+        for (j = 0; j < threadCount; j++) {
+            if ((internResults[j][i] != internResults[0][i]) ||
+                ((i < INTERN_KEY_COUNT / 2) &&
+                                 (internResults[j][i] != preStrs[i]))) {
+                (void) fprintf(stderr, "Error: intern instance mismatch\n");
+                exit(1);
+            }
+        }
+        if (JEMCC_GetInternStringUTF(env, internKeys[i]) != 
+                                               internResults[0][i]) {
+            (void) fprintf(stderr, "Error: intern table lost an instance\n");
+            exit(1);
+        }
+    }
+
+    (void) fprintf(stderr, "Intern benchmark (%i threads, %i x %i keys): "
+                           "%li us, %.1f ns/intern\n",
+                           threadCount, INTERN_ROUNDS, INTERN_KEY_COUNT,
+                           elapsed, (elapsed * 1000.0) / 
+                           ((double) threadCount * INTERN_ROUNDS *
+                                                   INTERN_KEY_COUNT));
+
+    JEMCC_DestroySysMonitor(internMonitor);
+    destroyTestEnv(env);
+}
+
 /* Local methods to avoid full library inclusion */
 void *JEMCC_Malloc(JNIEnv *env, juint size) {
 #ifdef ENABLE_ERRORSWEEP
@@ -22,6 +22,7 @@
  */
 #include "jeminc.h"
 #include <time.h>
+#include <sys/time.h>
 
 /* Read the jni/jem internal details */
 #include "jem.h"
@@ -164,6 +165,7 @@ void destroyTempEnv(JEM_JNIEnv *jenv) {
         JEMCC_Free(lockEntry);
         lockEntry = nextEntry;
     }
+    JEM_ReleaseThinLockId((JNIEnv *) jenv);
     JEMCC_Free(jenv);
 }
 
@@ -367,9 +369,127 @@ void *objNotifyWaitTestFn(JNIEnv *env, void *userArg) {
     return (void *) 0;
 }
 
+/* Shared data for the object monitor enter/exit benchmark */
+#define LOCK_BENCH_ITERATIONS 200000
+static JEMCC_SysMonitor *lockBenchMonitor;
+static JEMCC_Object *lockBenchObject;
+static int lockBenchStarted, lockBenchActive;
+static jlong lockBenchCount;
+
+/* Thread method for the lock benchmark, repeatedly locks the shared object */
+void *lockBenchFn(JNIEnv *env, void *userArg) {
+    int i;
+
+    env = (JNIEnv *) createTempEnv();
+
+    /* Wait for all of the threads to be ready */
+    JEMCC_EnterSysMonitor(lockBenchMonitor);
+    while (lockBenchStarted == 0) {
+        (void) JEMCC_SysMonitorWait(lockBenchMonitor);
+    }
+    (void) JEMCC_ExitSysMonitor(lockBenchMonitor);
+
+    /* Short critical section, with an occasional reentry */
+    for (i = 0; i < LOCK_BENCH_ITERATIONS; i++) {
+        if (JEMCC_EnterObjMonitor(env, lockBenchObject) != JNI_OK) {
+            (void) fprintf(stderr, "Error: benchmark monitor lock failed.\n");
+            exit(1);
+        }
+        if ((i & 0xF) == 0) {
+            if (JEMCC_EnterObjMonitor(env, lockBenchObject) != JNI_OK) {
+                (void) fprintf(stderr, "Error: benchmark relock failed.\n");
+                exit(1);
+            }
+            lockBenchCount++;
+            if (JEMCC_ExitObjMonitor(env, lockBenchObject) != JNI_OK) {
+                (void) fprintf(stderr, "Error: benchmark unlock failed.\n");
+                exit(1);
+            }
+        } else {
+            lockBenchCount++;
+        }
+        if (JEMCC_ExitObjMonitor(env, lockBenchObject) != JNI_OK) {
+            (void) fprintf(stderr, "Error: benchmark unlock failed.\n");
+            exit(1);
+        }
+    }
+
+    destroyTempEnv((JEM_JNIEnv *) env);
+
+    JEMCC_EnterSysMonitor(lockBenchMonitor);
+    lockBenchActive--;
+    (void) JEMCC_SysMonitorNotifyAll(lockBenchMonitor);
+    (void) JEMCC_ExitSysMonitor(lockBenchMonitor);
+
+    return (void *) 0;
+}
+
+/*
+ * Time the enter/exit of a single object monitor by the given number of
+ * contending threads.  The single thread case measures the uncontested
+ * (thin lock) path, the remainder the contended/inflated path.
+ */
+void doLockBenchmark(int threadCount) {
+    struct timeval start, end;
+    long elapsed;
+    int i;
+
+    lockBenchMonitor = JEMCC_CreateSysMonitor(NULL);
+    lockBenchObject = (JEMCC_Object *) JEMCC_Malloc(NULL,
+                                                    sizeof(JEMCC_Object));
+    if ((lockBenchMonitor == NULL) || (lockBenchObject == NULL)) {
+        (void) fprintf(stderr, "Error: benchmark setup failed.\n");
+        exit(1);
+    }
+    lockBenchObject->objStateSet = 0;
+    lockBenchCount = 0;
+
+    /* Start the threads, then release them together */
+    lockBenchStarted = 0;
+    lockBenchActive = threadCount;
+    for (i = 0; i < threadCount; i++) {
+        if (JEMCC_CreateThread(NULL, lockBenchFn, NULL, 1) == 0) {
+            (void) fprintf(stderr, "Error: benchmark thread create failed.\n");
+            exit(1);
+        }
+    }
+    JEMCC_EnterSysMonitor(lockBenchMonitor);
+    (void) gettimeofday(&start, NULL);
+    lockBenchStarted = 1;
+    (void) JEMCC_SysMonitorNotifyAll(lockBenchMonitor);
+    while (lockBenchActive > 0) {
+        (void) JEMCC_SysMonitorWait(lockBenchMonitor);
+    }
+    (void) gettimeofday(&end, NULL);
+    (void) JEMCC_ExitSysMonitor(lockBenchMonitor);
+    elapsed = (end.tv_sec - start.tv_sec) * 1000000 +
+                                   (end.tv_usec - start.tv_usec);
+
+    /* Lock must be exclusive and the object state restored */
+    if (lockBenchCount != ((jlong) threadCount) * LOCK_BENCH_ITERATIONS) {
+        (void) fprintf(stderr, "Error: benchmark lost updates (%lli).\n",
+                               lockBenchCount);
+        exit(1);
+    }
+    if (lockBenchObject->objStateSet != 0) {
+        (void) fprintf(stderr, "Error: benchmark monitor state not reset.\n");
+        exit(1);
+    }
+
+    (void) fprintf(stderr, "Lock benchmark (%i threads, %i x %i locks): "
+                           "%li us, %.1f ns/lock\n",
+                           threadCount, threadCount, LOCK_BENCH_ITERATIONS,
+                           elapsed, (elapsed * 1000.0) /
+                           ((double) threadCount * LOCK_BENCH_ITERATIONS));
+
+    JEMCC_Free(lockBenchObject);
+    JEMCC_DestroySysMonitor(lockBenchMonitor);
+}
+
 #define TEST_THREAD 1
 #define TEST_SYSTEM 2
 #define TEST_OBJECT 4
+#define TEST_BENCH 8
 
 /* Main program will send the threading/monitor routines through their paces */
 int main(int argc, char *argv[]) {
@@ -382,7 +502,9 @@ int main(int argc, char *argv[]) {
     /* Collect options */
     for (i = 0; i < argc; i++) {
         if (strcmp(argv[i], "-all") == 0) {
-            testFlags = 0xFF;
+            testFlags |= TEST_THREAD | TEST_SYSTEM | TEST_OBJECT;
+        } else if (strcmp(argv[i], "-bench") == 0) {
+            testFlags |= TEST_BENCH;
         } else if (strcmp(argv[i], "-checkmulti") == 0) {
             multiCheck = 1;
         } else if ((strcmp(argv[i], "-h") == 0) ||
@@ -390,6 +512,7 @@ int main(int argc, char *argv[]) {
             (void) fprintf(stderr, "Usage: %s [options]\n", argv[0]);
             (void) fprintf(stderr, "\nOptions:\n");
             (void) fprintf(stderr, "    -all          all tests [default]\n");
+            (void) fprintf(stderr, "    -bench        lock benchmark\n");
             (void) fprintf(stderr, "    -checkmulti   run multi-CPU test\n");
             (void) fprintf(stderr, "    -object       test object monitors\n");
             (void) fprintf(stderr, "    -system       test system monitors\n");
@@ -404,7 +527,7 @@ int main(int argc, char *argv[]) {
             testFlags |= TEST_THREAD;
         }
     }
-    if (testFlags == 0) testFlags = 0xFF;
+    if (testFlags == 0) testFlags = TEST_THREAD | TEST_SYSTEM | TEST_OBJECT;
 
     /* Do these tests first to avoid MT global monitor error */
     mallocFailFlag = 1;
@@ -969,6 +1092,100 @@ int main(int argc, char *argv[]) {
 
         sleep(5);
 
+        /* Objects without other state use the thin lock, repeat the above */
+        (void) fprintf(stdout, "Performing thin object monitor tests\n");
+        topObjMonitor->objStateSet = 0;
+        if ((JEMCC_EnterObjMonitor((JNIEnv *) jenv, 
+                                   topObjMonitor) != JNI_OK) ||
+            (JEMCC_EnterObjMonitor((JNIEnv *) jenv, 
+                                   topObjMonitor) != JNI_OK)) {
+            (void) fprintf(stderr, "Error: thin object monitor lock failed.\n");
+            exit(1);
+        }
+        if (topObjMonitor->objStateSet == 0) {
+            (void) fprintf(stderr, "Error: thin lock state not recorded\n");
+            exit(1);
+        }
+        if (JEMCC_ObjMonitorNotifyAll((JNIEnv *) jenv, 
+                                      topObjMonitor) != JNI_OK) {
+            (void) fprintf(stderr, "Error: thin obj notifyAll failed.\n");
+            exit(1);
+        }
+        if ((JEMCC_ExitObjMonitor((JNIEnv *) jenv, topObjMonitor) != JNI_OK) ||
+            (JEMCC_ExitObjMonitor((JNIEnv *) jenv, topObjMonitor) != JNI_OK)) {
+            (void) fprintf(stderr, "Error: thin obj monitor unlock failed.\n");
+            exit(1);
+        }
+        if (topObjMonitor->objStateSet != 0) {
+            (void) fprintf(stderr, "Thin monitor state did not reset\n");
+            exit(1);
+        }
+        if (JEMCC_ExitObjMonitor((JNIEnv *) jenv, topObjMonitor) != JNI_ERR) {
+            (void) fprintf(stderr, 
+                           "Error: exit thin test allowed non-owner.\n");
+            exit(1);
+        }
+        checkException("IllegalMonitorState", "not entered for exit",
+                       "exit thin without enter");
+
+        /* Recursion count overflow and wait both inflate the thin lock */
+        for (i = 0; i < 300; i++) {
+            if (JEMCC_EnterObjMonitor((JNIEnv *) jenv, 
+                                      topObjMonitor) != JNI_OK) {
+                (void) fprintf(stderr, "Error: thin deep lock failed.\n");
+                exit(1);
+            }
+        }
+        if (JEMCC_ObjMonitorMilliWait((JNIEnv *) jenv, 
+                                      topObjMonitor, 100) != JNI_OK) {
+            (void) fprintf(stderr, "Error: thin obj timed wait failed.\n");
+            exit(1);
+        }
+        for (i = 0; i < 300; i++) {
+            if (JEMCC_ExitObjMonitor((JNIEnv *) jenv, 
+                                     topObjMonitor) != JNI_OK) {
+                (void) fprintf(stderr, "Error: thin deep unlock failed.\n");
+                exit(1);
+            }
+        }
+        if (topObjMonitor->objStateSet != 0) {
+            (void) fprintf(stderr, "Inflated monitor state did not reset\n");
+            exit(1);
+        }
+
+        /* And the racing threads, which inflate on each collision */
+        objExitCount = 0;
+        for (i = 0; i < 4; i++) {
+            threadId = JEMCC_CreateThread(NULL, objMonitorTestFn, 
+                                          (void *) i, 1);
+            if (threadId == 0) {
+                (void) fprintf(stderr, 
+                               "Error: thin conflict thread %i failed.\n", i);
+                exit(1);
+            }
+        }
+        if (JEMCC_EnterObjMonitor((JNIEnv *) jenv, topObjMonitor) != JNI_OK) {
+            (void) fprintf(stderr, "Error: object monitor lock failed.\n");
+            exit(1);
+        }
+        while (objExitCount < i) {
+            if (JEMCC_ObjMonitorWait((JNIEnv *) jenv, 
+                                     topObjMonitor) != JNI_OK) {
+                (void) fprintf(stderr, "Error: object monitor wait failed.\n");
+                exit(1);
+            }
+        }
+        if (JEMCC_ExitObjMonitor((JNIEnv *) jenv, topObjMonitor) != JNI_OK) {
+            (void) fprintf(stderr, "Error: object monitor release failed.\n");
+            exit(1);
+        }
+        if (topObjMonitor->objStateSet != 0) {
+            (void) fprintf(stderr, "Thin monitor state did not reset\n");
+            exit(1);
+        }
+
+        sleep(5);
+
         /* Clean up to ensure truly complete memcheck */
         JEMCC_Free(topObjMonitor);
         lockEntry = jenv->freeObjLockQueue;
@@ -979,9 +1196,17 @@ int main(int argc, char *argv[]) {
         }
         JEMCC_DestroySysMonitor(jenv->objLockMonitor);
         JEMCC_DestroySysMonitor(jenv->objStateTxfrMonitor);
+        JEM_ReleaseThinLockId((JNIEnv *) jenv);
         JEMCC_Free(jenv);
     }
 
+    if ((testFlags & TEST_BENCH) != 0) {
+        doLockBenchmark(1);
+        doLockBenchmark(2);
+        doLockBenchmark(8);
+        doLockBenchmark(32);
+    }
+
     exit(0);
 }
 
@@ -998,6 +1223,13 @@ void JEMCC_Free(void *block) {
     free(block);
 }
 
+/* Collection safe regions are not tracked without the collector */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+}
+
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+}
+
 void JEMCC_ThrowStdThrowableIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
                                 JEMCC_Object *causeThrowable, const char *msg) {
     char *className = "unknown";
@@ -21,9 +21,11 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #include "jeminc.h"
+#include <sys/time.h>
 
 /* Read the jni/jem internal details */
 #include "jem.h"
+#include "numerics.h"
 
 int failureTotal;
 #ifdef ENABLE_ERRORSWEEP
@@ -43,6 +45,8 @@ int JEM_CheckErrorSweep(int sweepType) {
 /* Forward declarations, see below */
 void doValidEnvStrScan(jboolean fullsweep);
 void doValidHashScan(jboolean fullsweep);
+void doNumericTests();
+void doNumericBenchmark();
 
 /* Main program will send the class linker through its paces */
 int main(int argc, char *argv[]) {
@@ -50,6 +54,12 @@ int main(int argc, char *argv[]) {
     JEMCC_HashTable hashTable, dupHashTable;
     int i, j;
 
+    /* Only time the numeric conversions when benchmarking */
+    if ((argc > 1) && (strcmp(argv[1], "-bench") == 0)) {
+        doNumericBenchmark();
+        exit(0);
+    }
+
     /* 'Conventional' tests first, do not force internal errors */
 #ifdef ENABLE_ERRORSWEEP
     testFailureCount = -1;
@@ -135,6 +145,9 @@ int main(int argc, char *argv[]) {
     JEMCC_HashDestroyTable(&hashTable);
     JEMCC_HashDestroyTable(&dupHashTable);
 
+    fprintf(stderr, "Beginning numeric conversion tests\n");
+    doNumericTests();
+
     /* Memory failure scanning */
 #ifdef ENABLE_ERRORSWEEP
     testFailureCurrentCount = 0;
@@ -534,6 +547,283 @@ void doValidHashScan(jboolean fullsweep) {
     }
 }
 
+/* Expected Double/Float.toString() results (from a reference platform) */
+static struct {
+    jdouble val;
+    char *text;
+} doubleTexts[] = {
+    { 0.0, "0.0" }, { 1.0, "1.0" }, { -1.0, "-1.0" }, { 0.1, "0.1" },
+    { 100.0, "100.0" }, { 9999999.0, "9999999.0" }, { 1.0e7, "1.0E7" },
+    { 0.001, "0.001" }, { 1.0e-4, "1.0E-4" }, { -3.0e-5, "-3.0E-5" },
+    { 123456.789, "123456.789" }, { 1.0e23, "1.0E23" },
+    { 9223372036854775808.0, "9.223372036854776E18" },
+    { 4.9e-324, "4.9E-324" }, { 2.2250738585072014e-308,
+                                "2.2250738585072014E-308" },
+    { 1.7976931348623157e308, "1.7976931348623157E308" },
+    { 0.30000000000000004, "0.30000000000000004" },
+    { 0.0, NULL }
+};
+static struct {
+    jfloat val;
+    char *text;
+} floatTexts[] = {
+    { 0.1f, "0.1" }, { 1.0f, "1.0" }, { -0.3f, "-0.3" },
+    { 1.4e-45f, "1.4E-45" }, { 3.4028235e38f, "3.4028235E38" },
+    { 1.17549435e-38f, "1.1754944E-38" }, { 16777216.0f, "1.6777216E7" },
+    { 371756.625f, "371756.62" }, { 0.0f, NULL }
+};
+
+/* Parse cases, including the rounding boundaries and special forms */
+static struct {
+    char *text;
+    jdouble val;
+} parseTexts[] = {
+    { "1", 1.0 }, { " -2.5E-3d ", -2.5e-3 }, { "+.5", 0.5 },
+    { "1.", 1.0 }, { "1e23", 1.0e23 }, { "0x1.8p1", 3.0 },
+    { "-0X.8P-1f", -0.25 }, { "4.9E-324", 4.9e-324 },
+    { "2.4703282292062328E-324", 4.9e-324 },
+    { "2.4703282292062327E-324", 0.0 },
+    { "9007199254740993", 9007199254740992.0 },
+    { "9007199254740993.000000000000000000000000000001",
+      9007199254740994.0 },
+    { "1.7976931348623158e308", 1.7976931348623157e308 },
+    { "0.000000000000000000000000000000000000000000000000000000000000001e63",
+      1.0 },
+    { "1e-99999999999", 0.0 }, { NULL, 0.0 }
+};
+static char *invalidTexts[] = {
+    "", " ", "-", ".", "e5", "1e", "1e+", "1.0.0", "0x1", "0x1.8", "abc",
+    "1 2", "--1", "NaNd", "1.0ff", NULL
+};
+
+/* Verify the bitwise equivalence of the double value */
+static void checkDouble(jdouble val, jdouble expected, char *text) {
+    if (memcmp(&val, &expected, sizeof(jdouble)) != 0) {
+        (void) fprintf(stderr, "Invalid double conversion of '%s'\n", text);
+        exit(1);
+    }
+}
+
+/* Verify the integral and floating point conversions (text and back) */
+void doNumericTests() {
+    volatile jdouble zero = 0.0;
+    union {
+        jdouble dval;
+        jlong bits;
+    } dconv;
+    union {
+        jfloat fval;
+        jint bits;
+    } fconv;
+    jdouble dval;
+    jfloat fval;
+    char buff[80];
+    int i;
+
+    JEMCC_IntegerToText(0x80000000, 10, buff);
+    if (strcmp(buff, "-2147483648") != 0) {
+        (void) fprintf(stderr, "Invalid minimum integer text %s\n", buff);
+        exit(1);
+    }
+    JEMCC_IntegerToText(1000000000, 10, buff);
+    if (strcmp(buff, "1000000000") != 0) {
+        (void) fprintf(stderr, "Invalid integer text %s\n", buff);
+        exit(1);
+    }
+    JEMCC_IntegerToText(-255, 16, buff);
+    if (strcmp(buff, "-ff") != 0) {
+        (void) fprintf(stderr, "Invalid hexadecimal integer text %s\n", buff);
+        exit(1);
+    }
+    JEMCC_LongToText(-((jlong) 9223372036854775807) - 1, 10, buff);
+    if (strcmp(buff, "-9223372036854775808") != 0) {
+        (void) fprintf(stderr, "Invalid minimum long text %s\n", buff);
+        exit(1);
+    }
+    JEMCC_LongToText(-((jlong) 1000000007), 10, buff);
+    if (strcmp(buff, "-1000000007") != 0) {
+        (void) fprintf(stderr, "Invalid long text %s\n", buff);
+        exit(1);
+    }
+    for (i = 0; i < 100000; i++) {
+        JEMCC_IntegerToText(rand() - RAND_MAX / 2, 10, buff);
+        if (strtol(buff, NULL, 10) != atoi(buff)) {
+            (void) fprintf(stderr, "Inconsistent integer text %s\n", buff);
+            exit(1);
+        }
+    }
+
+    /* Double/Float.toString() conversions */
+    for (i = 0; doubleTexts[i].text != NULL; i++) {
+        JEMCC_DoubleToText(doubleTexts[i].val, buff);
+        if (strcmp(buff, doubleTexts[i].text) != 0) {
+            (void) fprintf(stderr, "Invalid double text %s (expected %s)\n",
+                                   buff, doubleTexts[i].text);
+            exit(1);
+        }
+    }
+    for (i = 0; floatTexts[i].text != NULL; i++) {
+        JEMCC_FloatToText(floatTexts[i].val, buff);
+        if (strcmp(buff, floatTexts[i].text) != 0) {
+            (void) fprintf(stderr, "Invalid float text %s (expected %s)\n",
+                                   buff, floatTexts[i].text);
+            exit(1);
+        }
+    }
+    JEMCC_DoubleToText(-zero, buff);
+    if (strcmp(buff, "-0.0") != 0) {
+        (void) fprintf(stderr, "Invalid negative zero text %s\n", buff);
+        exit(1);
+    }
+    JEMCC_DoubleToText(zero / zero, buff);
+    if (strcmp(buff, "NaN") != 0) {
+        (void) fprintf(stderr, "Invalid NaN text %s\n", buff);
+        exit(1);
+    }
+    JEMCC_FloatToText((jfloat) (-1.0 / zero), buff);
+    if (strcmp(buff, "-Infinity") != 0) {
+        (void) fprintf(stderr, "Invalid infinity text %s\n", buff);
+        exit(1);
+    }
+
+    /* Text parsing */
+    for (i = 0; parseTexts[i].text != NULL; i++) {
+        if (JEMCC_TextToDouble(parseTexts[i].text, &dval) != JNI_OK) {
+            (void) fprintf(stderr, "Double parse of '%s' failed\n",
+                                   parseTexts[i].text);
+            exit(1);
+        }
+        checkDouble(dval, parseTexts[i].val, parseTexts[i].text);
+    }
+    for (i = 0; invalidTexts[i] != NULL; i++) {
+        if ((JEMCC_TextToDouble(invalidTexts[i], &dval) != JNI_ERR) ||
+            (JEMCC_TextToFloat(invalidTexts[i], &fval) != JNI_ERR)) {
+            (void) fprintf(stderr, "Invalid text '%s' was parsed\n",
+                                   invalidTexts[i]);
+            exit(1);
+        }
+    }
+    if ((JEMCC_TextToDouble("1.7976931348623159e308", &dval) != JNI_OK) ||
+        (dval != 1.0 / zero)) {
+        (void) fprintf(stderr, "Overflow did not parse to infinity\n");
+        exit(1);
+    }
+    if ((JEMCC_TextToDouble("-NaN", &dval) != JNI_OK) || (dval == dval)) {
+        (void) fprintf(stderr, "Invalid NaN parse\n");
+        exit(1);
+    }
+    if ((JEMCC_TextToFloat("1.00000017881393432617187499", &fval) != JNI_OK) ||
+        (fval != 1.0000001f)) {
+        (void) fprintf(stderr, "Invalid float boundary parse\n");
+        exit(1);
+    }
+
+    /* All finite values must convert to text and back exactly */
+    for (i = 0; i < 200000; i++) {
+        dconv.bits = (((jlong) (rand() & 0x7FFF)) << 48) ^
+                     (((jlong) (rand() & 0xFFFFFF)) << 24) ^
+                     (rand() & 0xFFFFFF);
+        if ((i & 1) != 0) dconv.dval = -dconv.dval;
+        if (dconv.dval != dconv.dval) continue;
+        JEMCC_DoubleToText(dconv.dval, buff);
+        if (JEMCC_TextToDouble(buff, &dval) != JNI_OK) {
+            (void) fprintf(stderr, "Double text %s did not parse\n", buff);
+            exit(1);
+        }
+        checkDouble(dval, dconv.dval, buff);
+
+        fconv.bits = (rand() & 0xFFFF) ^ ((rand() & 0xFFFF) << 15);
+        if ((i & 2) != 0) fconv.fval = -fconv.fval;
+        if (fconv.fval != fconv.fval) continue;
+        JEMCC_FloatToText(fconv.fval, buff);
+        if ((JEMCC_TextToFloat(buff, &fval) != JNI_OK) ||
+            (memcmp(&fval, &(fconv.fval), sizeof(jfloat)) != 0)) {
+            (void) fprintf(stderr, "Float text %s did not round trip\n", buff);
+            exit(1);
+        }
+    }
+}
+
+/* Report the per-conversion time since the indicated start */
+static void reportTiming(char *name, struct timeval *start, int count) {
+    struct timeval end;
+    long elapsed;
+
+    (void) gettimeofday(&end, NULL);
+    elapsed = (end.tv_sec - start->tv_sec) * 1000000 +
+                                   (end.tv_usec - start->tv_usec);
+    (void) fprintf(stderr, "%-28s %li us, %.1f ns/conversion\n", name,
+                           elapsed, (elapsed * 1000.0) / count);
+}
+
+#define NUMERIC_BENCH_COUNT 1000000
+#define NUMERIC_BENCH_VALUES 1024
+
+/* Time the numeric text conversions, against the C library equivalents */
+void doNumericBenchmark() {
+    static jdouble values[NUMERIC_BENCH_VALUES];
+    static char texts[NUMERIC_BENCH_VALUES][32];
+    struct timeval start;
+    jdouble dval, sum = 0.0;
+    char buff[80];
+    int i;
+
+    for (i = 0; i < NUMERIC_BENCH_VALUES; i++) {
+        values[i] = (rand() - RAND_MAX / 2) / ((jdouble) (rand() + 1));
+        if ((i & 3) == 0) values[i] *= 1.0e10;
+        JEMCC_DoubleToText(values[i], texts[i]);
+    }
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        JEMCC_IntegerToText(i * 2039, 10, buff);
+    }
+    reportTiming("IntegerToText", &start, NUMERIC_BENCH_COUNT);
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        (void) sprintf(buff, "%i", i * 2039);
+    }
+    reportTiming("sprintf(%i)", &start, NUMERIC_BENCH_COUNT);
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        JEMCC_LongToText(((jlong) i) * 1000000007, 10, buff);
+    }
+    reportTiming("LongToText", &start, NUMERIC_BENCH_COUNT);
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        JEMCC_DoubleToText(values[i % NUMERIC_BENCH_VALUES], buff);
+    }
+    reportTiming("DoubleToText", &start, NUMERIC_BENCH_COUNT);
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        (void) sprintf(buff, "%.17g", values[i % NUMERIC_BENCH_VALUES]);
+    }
+    reportTiming("sprintf(%.17g)", &start, NUMERIC_BENCH_COUNT);
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        JEMCC_FloatToText((jfloat) values[i % NUMERIC_BENCH_VALUES], buff);
+    }
+    reportTiming("FloatToText", &start, NUMERIC_BENCH_COUNT);
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        (void) JEMCC_TextToDouble(texts[i % NUMERIC_BENCH_VALUES], &dval);
+        sum += dval;
+    }
+    reportTiming("TextToDouble", &start, NUMERIC_BENCH_COUNT);
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < NUMERIC_BENCH_COUNT; i++) {
+        sum += strtod(texts[i % NUMERIC_BENCH_VALUES], NULL);
+    }
+    reportTiming("strtod", &start, NUMERIC_BENCH_COUNT);
+
+    /* Use the sum, to ensure the parses are not optimized away */
+    if (sum != sum) (void) fprintf(stderr, "Unexpected parse result\n");
+}
+
 /* Local methods to avoid full library inclusion */
 void *JEMCC_Malloc(JNIEnv *env, juint size) {
 #ifdef ENABLE_ERRORSWEEP
@@ -335,19 +335,11 @@ static jint attachCurrentThread(JavaVM *vm, JNIEnv **pEnv, void *args) {
     envData->envBufferLength = 0;
     envData->parentVM = (JEM_JavaVM *) vm;
     envData->firstAllocObjectRecord = envData->lastAllocObjectRecord = NULL;
+    envData->allocBlockList = NULL;
+    envData->allocBlockPtr = envData->allocBlockEnd = NULL;
+    envData->allocLargeList = NULL;
 
-    envData->frameStackBlockSize = 1024;
-    envData->frameStackBlock =
-                    calloc((unsigned int) envData->frameStackBlockSize, 1);
-    if (envData->frameStackBlock == NULL) return JNI_ERR;
-    envData->topFrame = (JEM_VMFrameExt *) envData->frameStackBlock;
-    ((JEMCC_VMFrame *) envData->topFrame)->operandStackTop = NULL;
-    ((JEMCC_VMFrame *) envData->topFrame)->localVars = NULL;
-    envData->topFrame = (JEM_VMFrameExt *) envData->frameStackBlock;
-    envData->topFrame->opFlags = FRAME_ROOT;
-    envData->topFrame->previousFrame = NULL;
-    envData->topFrame->currentMethod = NULL;
-    envData->topFrame->firstAllocObjectRecord = NULL;
+    if (JEM_CreateFrameStack((JNIEnv *) envData) != JNI_OK) return JNI_ERR;
 
     envData->freeObjLockQueue = NULL;
     envData->objStateTxfrMonitor = JEMCC_CreateSysMonitor(NULL);
@@ -395,28 +387,24 @@ JNIEnv *createTestEnv() {
                             &(jvm->jemccClassPackageTable), 32) != JNI_OK) {
         return NULL;
     }
-    if (JEMCC_HashInitTable((JNIEnv *) envData,
-                            &(jvm->internStringTable), 32) != JNI_OK) {
+    if (JEM_InternTableInit((JNIEnv *) envData,
+                            &(jvm->internStringTable)) != JNI_OK) {
+        return NULL;
+    }
+    if (JEM_SymbolTableInit((JNIEnv *) envData,
+                            &(jvm->symbolTable)) != JNI_OK) {
         return NULL;
     }
 
     jvm->monitor = JEMCC_CreateSysMonitor(NULL);
     if (jvm->monitor == NULL) return NULL;
+    jvm->safepointMonitor = JEMCC_CreateSysMonitor(NULL);
+    if (jvm->safepointMonitor == NULL) return NULL;
 
     (void) memset(&(jvm->coreClassTbl), 0,
                   JEMCC_VM_CLASS_TBL_SIZE * sizeof(JEMCC_Class *));
 
-    envData->frameStackBlockSize = 1024;
-    envData->frameStackBlock = 
-                    calloc((unsigned int) envData->frameStackBlockSize, 1);
-    if (envData->frameStackBlock == NULL) return NULL;
-    envData->topFrame = (JEM_VMFrameExt *) envData->frameStackBlock;
-    ((JEMCC_VMFrame *) envData->topFrame)->operandStackTop = NULL;
-    ((JEMCC_VMFrame *) envData->topFrame)->localVars = NULL;
-    envData->topFrame = (JEM_VMFrameExt *) envData->frameStackBlock;
-    envData->topFrame->opFlags = FRAME_ROOT;
-    envData->topFrame->previousFrame = NULL;
-    envData->topFrame->currentMethod = NULL;
+    if (JEM_CreateFrameStack((JNIEnv *) envData) != JNI_OK) return NULL;
 
     envData->freeObjLockQueue = NULL;
     envData->objStateTxfrMonitor = JEMCC_CreateSysMonitor(NULL);
@@ -495,18 +483,16 @@ static jint classRemovalScanner(JNIEnv *env, JEMCC_HashTable *table,
  *
  * Parameters:
  *     env - the test environment being cleaned up
- *     table - the virtual machine String table being scanned/cleaned up
- *     key - ignored (internal String data)
- *     obj - the String instance to be destroyed
+ *     string - the String instance to be destroyed
  *     userData - ignored
  *
  * Returns:
- *     JNI_OK always (hash scan to continue until completion).
+ *     JNI_OK always (scan to continue until completion).
  */
-static jint stringRemovalScanner(JNIEnv *env, JEMCC_HashTable *table, 
-                                 void *key, void *obj, void *userData) {
-    JEMCC_Free(((JEMCC_ObjectExt *) obj)->objectData);
-    JEMCC_Free(obj);
+static jint stringRemovalScanner(JNIEnv *env, JEMCC_Object *string,
+                                 void *userData) {
+    /* Note: String object itself is released with the allocation blocks */
+    JEMCC_Free(((JEMCC_ObjectExt *) string)->objectData);
 
     return JNI_OK;
 }
@@ -535,9 +521,9 @@ void destroyTestEnv(JNIEnv *env) {
     }
 
     /* Destroy the intern'd String instances */
-    JEMCC_HashScan(env, &(jvm->internStringTable),
-                   stringRemovalScanner, NULL);
-    JEMCC_HashDestroyTable(&(jvm->internStringTable));
+    JEM_InternTableScan(env, &(jvm->internStringTable),
+                        stringRemovalScanner, NULL);
+    JEM_InternTableDestroy(&(jvm->internStringTable));
 
     /* Primitives must be handled specially */
     if (JVM_Class(JEMCC_Primitive_Boolean) != NULL) 
@@ -565,6 +551,9 @@ void destroyTestEnv(JNIEnv *env) {
     JEMCC_HashScan(env, &(jvm->jemccClassPackageTable),
                    classRemovalScanner, NULL);
 
+    /* All classes are gone, release the member name/descriptor symbols */
+    JEM_SymbolTableDestroy(&(jvm->symbolTable));
+
     /* Destroy the path tables, if they have been created */
     JEM_DestroyPathList(env, &(jvm->classPath));
     JEM_DestroyPathList(env, &(jvm->libPath));
@@ -572,6 +561,7 @@ void destroyTestEnv(JNIEnv *env) {
     /* Destroy the vm hash/monitor */
     JEMCC_HashDestroyTable(&(jvm->jemccClassPackageTable));
     JEMCC_DestroySysMonitor(jvm->monitor);
+    JEMCC_DestroySysMonitor(jvm->safepointMonitor);
 
     /* Finally, nuke the env/vm structures */
     JEMCC_DestroySysMonitor(envData->objStateTxfrMonitor);
@@ -583,8 +573,10 @@ void destroyTestEnv(JNIEnv *env) {
         lockEntry = nextEntry;
     }
 
+    JEM_ReleaseHeap(env);
+    JEM_ReleaseAllocationBlocks(env);
     JEMCC_Free(envData->envBuffer);
-    JEMCC_Free(envData->frameStackBlock);
+    JEM_DestroyFrameStack(env);
     JEMCC_Free(envData);
     JEMCC_Free(jvm);
 
@@ -745,7 +745,8 @@ void buildLinkTree() {
     /* Parse the ok dictionary set */
     for (i = 0; i < nOkTests; i++) {
         classData = JEM_ParseClassData(env, okTests[i].testData, 
-                                            okTests[i].testLength);
+                                            okTests[i].testLength,
+                                            JNI_FALSE);
         if (classData == NULL) {
             if (testFailureCount < 1) {
                (void) fprintf(stderr,
@@ -800,6 +801,13 @@ void JEMCC_Free(void *block) {
     free(block);
 }
 
+/* Collection safe regions are not tracked without the collector */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+}
+
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+}
+
 void JEMCC_ThrowStdThrowableIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
                                 JEMCC_Object *causeThrowable, const char *msg) {
     char *className = "unknown";
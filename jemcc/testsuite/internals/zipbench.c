@@ -0,0 +1,315 @@
+/**
+ * JEMCC benchmark program to time Zip file directory lookups.
+ * Copyright (C) 1999-2004 J.M. Heisz
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * See the file named COPYRIGHT in the root directory of the source
+ * distribution for specific references to the GNU General Public License,
+ * as well as further clarification on your rights to use this software.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "jeminc.h"
+#include <sys/time.h>
+
+/* Read the JNI/JEMCC internal details */
+#include "jem.h"
+
+/* Need the checksum method for the synthetic archive */
+#include "zlib.h"
+
+/* External elements from benchutil.c */
+extern long elapsedMillis(struct timeval *start);
+
+/* Synthetic archive layout, entries are spread across the packages */
+#define BENCH_ZIP_FILE "zipbench.zip"
+#define BENCH_PACKAGES 100
+
+/* Generate the name of the indicated entry (or a missing entry) */
+static void entryName(char *buffer, int idx, int missing) {
+    (void) sprintf(buffer, "bench/pkg%03i/%s%05i.class", idx % BENCH_PACKAGES,
+                           ((missing) ? "Missing" : "Class"), idx);
+}
+
+/* Little-endian output of the Zip header fields */
+static void put16(FILE *fp, juint val) {
+    (void) fputc(val & 0xFF, fp);
+    (void) fputc((val >> 8) & 0xFF, fp);
+}
+
+static void put32(FILE *fp, juint val) {
+    put16(fp, val & 0xFFFF);
+    put16(fp, (val >> 16) & 0xFFFF);
+}
+
+/* Write a Zip file of stored entries, the content of each is its name */
+static void writeArchive(int entryCount) {
+    juint *offsets, *crcs, offset, dirStart, dirLength;
+    char name[64];
+    int i, len;
+    FILE *fp;
+
+    offsets = (juint *) calloc(entryCount, sizeof(juint));
+    crcs = (juint *) calloc(entryCount, sizeof(juint));
+    if ((offsets == NULL) || (crcs == NULL) ||
+        ((fp = fopen(BENCH_ZIP_FILE, "wb")) == NULL)) {
+        (void) fprintf(stderr, "Error: unable to create benchmark archive\n");
+        exit(1);
+    }
+
+    /* Local headers and data */
+    offset = 0;
+    for (i = 0; i < entryCount; i++) {
+        entryName(name, i, 0);
+        len = strlen(name);
+        offsets[i] = offset;
+        crcs[i] = crc32(crc32(0L, Z_NULL, 0), (Bytef *) name, len);
+        put32(fp, 0x04034B50);
+        put16(fp, 10); put16(fp, 0); put16(fp, 0);
+        put16(fp, 0); put16(fp, 0);
+        put32(fp, crcs[i]); put32(fp, len); put32(fp, len);
+        put16(fp, len); put16(fp, 0);
+        (void) fwrite(name, 1, len, fp);
+        (void) fwrite(name, 1, len, fp);
+        offset += 30 + 2 * len;
+    }
+
+    /* Central directory */
+    dirStart = offset;
+    for (i = 0; i < entryCount; i++) {
+        entryName(name, i, 0);
+        len = strlen(name);
+        put32(fp, 0x02014B50);
+        put16(fp, 10); put16(fp, 10); put16(fp, 0); put16(fp, 0);
+        put16(fp, 0); put16(fp, 0);
+        put32(fp, crcs[i]); put32(fp, len); put32(fp, len);
+        put16(fp, len); put16(fp, 0); put16(fp, 0);
+        put16(fp, 0); put16(fp, 0); put32(fp, 0);
+        put32(fp, offsets[i]);
+        (void) fwrite(name, 1, len, fp);
+        offset += 46 + len;
+    }
+    dirLength = offset - dirStart;
+
+    /* End of central directory record */
+    put32(fp, 0x06054B50);
+    put16(fp, 0); put16(fp, 0);
+    put16(fp, entryCount); put16(fp, entryCount);
+    put32(fp, dirLength); put32(fp, dirStart);
+    put16(fp, 0);
+
+    if (fclose(fp) != 0) {
+        (void) fprintf(stderr, "Error: unable to write benchmark archive\n");
+        exit(1);
+    }
+    free(offsets);
+    free(crcs);
+}
+
+/* Directory scan callback, just counts the entries */
+static jint countEntryCB(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                         JEMCC_ZipFileEntry *zipEntry, void *userData) {
+    (*((int *) userData))++;
+    return JNI_OK;
+}
+
+/* Time the lookup of every entry (and as many missing entries) */
+static void timeLookups(JEMCC_ZipFile *zf, int entryCount, char *label) {
+    JEMCC_ZipFileEntry entry;
+    struct timeval start;
+    char name[64];
+    long elapsed;
+    int i;
+
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < entryCount; i++) {
+        entryName(name, i, 0);
+        if (JEMCC_FindZipFileEntry(NULL, zf, name, &entry,
+                                   JNI_FALSE) != JNI_OK) {
+            (void) fprintf(stderr, "Error: failed to locate %s\n", name);
+            exit(1);
+        }
+        if (entry.uncompressedSize != strlen(name)) {
+            (void) fprintf(stderr, "Error: invalid entry for %s\n", name);
+            exit(1);
+        }
+        JEMCC_ReleaseZipFileEntry(NULL, zf, &entry);
+
+        entryName(name, i, 1);
+        if (JEMCC_FindZipFileEntry(NULL, zf, name, &entry,
+                                   JNI_FALSE) != JNI_EINVAL) {
+            (void) fprintf(stderr, "Error: located missing %s\n", name);
+            exit(1);
+        }
+    }
+    elapsed = elapsedMillis(&start);
+    (void) fprintf(stderr, "%s lookups (%i hits + %i misses): %li ms\n",
+                           label, entryCount, entryCount, elapsed);
+}
+
+/* Time the reading of every entry, allocated copy versus mapped access */
+static void timeReads(JEMCC_ZipFile *zf, int entryCount) {
+    JEMCC_ZipFileEntry entry;
+    struct timeval start;
+    jboolean isMapped;
+    char name[64];
+    jbyte *data;
+    int i, mode;
+
+    for (mode = 0; mode < 2; mode++) {
+        (void) gettimeofday(&start, NULL);
+        for (i = 0; i < entryCount; i++) {
+            entryName(name, i, 0);
+            if (JEMCC_FindZipFileEntry(NULL, zf, name, &entry,
+                                       JNI_FALSE) != JNI_OK) {
+                (void) fprintf(stderr, "Error: failed to locate %s\n", name);
+                exit(1);
+            }
+            if (mode == 0) {
+                data = JEMCC_ReadZipFileEntry(NULL, zf, &entry);
+            } else {
+                data = JEM_MapZipFileEntry(NULL, zf, &entry, &isMapped);
+            }
+            if ((data == NULL) || (memcmp(data, name, strlen(name)) != 0)) {
+                (void) fprintf(stderr, "Error: unable to read %s\n", name);
+                exit(1);
+            }
+            if (mode == 0) JEMCC_Free(data);
+            JEMCC_ReleaseZipFileEntry(NULL, zf, &entry);
+        }
+        (void) fprintf(stderr, "%s reads (%i entries): %li ms\n",
+                               ((mode == 0) ? "Allocated" : "Mapped"),
+                               entryCount, elapsedMillis(&start));
+    }
+}
+
+/* Main program will time the open/lookup/scan of a large archive */
+int main(int argc, char *argv[]) {
+    int i, count, entryCount = 50000;
+    JEMCC_ZipFileEntry entry;
+    struct timeval start;
+    JEMCC_ZipFile *zf;
+    char name[64];
+    jbyte *data;
+
+    /* Allow for alternate archive sizes (limited by the 16-bit count) */
+    if (argc > 1) entryCount = atoi(argv[1]);
+    if (entryCount < BENCH_PACKAGES) entryCount = BENCH_PACKAGES;
+    if (entryCount > 65535) entryCount = 65535;
+
+    writeArchive(entryCount);
+
+    /* Prescanned directory, index is built during open */
+    (void) gettimeofday(&start, NULL);
+    if (JEMCC_OpenZipFile(NULL, BENCH_ZIP_FILE, &zf,
+                          JNI_TRUE, JNI_FALSE) != JNI_OK) {
+        (void) fprintf(stderr, "Error: unable to open benchmark archive\n");
+        exit(1);
+    }
+    (void) fprintf(stderr, "Prescan open (%i entries): %li ms\n",
+                           entryCount, elapsedMillis(&start));
+    timeLookups(zf, entryCount, "Prescan");
+    timeReads(zf, entryCount);
+
+    /* Package scans should cover the entire archive */
+    count = 0;
+    (void) gettimeofday(&start, NULL);
+    for (i = 0; i < BENCH_PACKAGES; i++) {
+        (void) sprintf(name, "bench/pkg%03i/", i);
+        if (JEMCC_ScanZipFileDirectory(NULL, zf, name, countEntryCB,
+                                       &count, JNI_FALSE) != JNI_OK) {
+            (void) fprintf(stderr, "Error: unable to scan %s\n", name);
+            exit(1);
+        }
+    }
+    (void) fprintf(stderr, "Package scans (%i packages): %li ms\n",
+                           BENCH_PACKAGES, elapsedMillis(&start));
+    if (count != entryCount) {
+        (void) fprintf(stderr, "Error: package scans found %i of %i\n",
+                               count, entryCount);
+        exit(1);
+    }
+
+    /* Verify the data of the last entry */
+    entryName(name, entryCount - 1, 0);
+    if ((JEMCC_FindZipFileEntry(NULL, zf, name, &entry,
+                                JNI_FALSE) != JNI_OK) ||
+        ((data = JEMCC_ReadZipFileEntry(NULL, zf, &entry)) == NULL) ||
+        (memcmp(data, name, strlen(name)) != 0)) {
+        (void) fprintf(stderr, "Error: unable to read %s\n", name);
+        exit(1);
+    }
+    JEMCC_Free(data);
+    JEMCC_ReleaseZipFileEntry(NULL, zf, &entry);
+    JEMCC_CloseZipFile(NULL, zf);
+
+    /* Without prescan, index is built by the first lookup */
+    (void) gettimeofday(&start, NULL);
+    if (JEMCC_OpenZipFile(NULL, BENCH_ZIP_FILE, &zf,
+                          JNI_FALSE, JNI_FALSE) != JNI_OK) {
+        (void) fprintf(stderr, "Error: unable to open benchmark archive\n");
+        exit(1);
+    }
+    timeLookups(zf, entryCount, "Non-prescan (including open)");
+    JEMCC_CloseZipFile(NULL, zf);
+
+    (void) unlink(BENCH_ZIP_FILE);
+
+    exit(0);
+}
+
+/* Local methods to avoid full library inclusion */
+void *JEMCC_Malloc(JNIEnv *env, juint size) {
+    return calloc(1, size);
+}
+
+void JEMCC_Free(void *block) {
+    free(block);
+}
+
+/* Collection safe regions are not tracked without the collector */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+}
+
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+}
+
+jbyte *JEM_EnvScratchBuffer(JNIEnv *env, jsize length) {
+    static jbyte *scratchBuffer = NULL;
+    static jsize scratchLength = 0;
+
+    if (scratchLength < length) {
+        free(scratchBuffer);
+        if ((scratchBuffer = (jbyte *) calloc(1, length)) == NULL) {
+            scratchLength = 0;
+            return NULL;
+        }
+        scratchLength = length;
+    }
+    return scratchBuffer;
+}
+
+void JEMCC_ThrowStdThrowableIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
+                                JEMCC_Object *causeThrowable, const char *msg) {
+    (void) fprintf(stderr, "Error[%i]: %s.\n", idx,
+                           (msg == NULL) ? "(null)" : msg);
+}
+
+void JEMCC_ThrowStdThrowableByName(JNIEnv *env, JEMCC_Object *src,
+                                   const char *className,
+                                   JEMCC_Object *causeThrowable,
+                                   const char *msg) {
+    (void) fprintf(stderr, "Error[%s]: %s.\n", className,
+                           (msg == NULL) ? "(null)" : msg);
+}
@@ -444,12 +444,33 @@ static char *names[] = { "zero", "one", "five", "ten",
                          "twenty", "fifty", "hundred" };
 static int sizes[] = { 0, 1, 5, 10, 20, 50, 100 };
 
+/* Directory scan callback, verifies/counts the entries of the root */
+static jint dirScanCB(JNIEnv *env, JEMCC_ZipFile *zipFile,
+                      JEMCC_ZipFileEntry *zipEntry, void *userData) {
+    int idx, *seen = (int *) userData;
+
+    for (idx = 0; idx < 7; idx++) {
+        if ((zipEntry->fileNameLength == strlen(names[idx])) &&
+            (memcmp(zipEntry->fileName, names[idx],
+                    zipEntry->fileNameLength) == 0)) break;
+    }
+    if ((idx >= 7) || ((*seen & (1 << idx)) != 0) ||
+        (zipEntry->uncompressedSize != sizes[idx])) {
+        (void) fprintf(stderr, "Error: unexpected directory scan entry\n");
+        exit(1);
+    }
+    *seen |= (1 << idx);
+
+    return JNI_OK;
+}
+
 /* Perform successful read operations for forced failure validation */
 void doValidReadScan(jboolean fullsweep) {
     JEMCC_ZipFile *zf;
     JEMCC_ZipFileEntry entry;
-    jbyte *data;
-    int mode, idx, k;
+    jbyte *data, *mapData;
+    jboolean isMapped;
+    int mode, idx, k, count, rc;
 
     /* Repeat the following with and without prescan */
     for (mode = 0; mode < 2; mode++) {
@@ -502,10 +523,72 @@ void doValidReadScan(jboolean fullsweep) {
                                        names[idx]);
                 exit(1);
             }
+
+            /* Unallocated access must match (and only map stored data) */
+            mapData = JEM_MapZipFileEntry(NULL, zf, &entry, &isMapped);
+            if (mapData == NULL) {
+                if (fullsweep == JNI_TRUE) {
+                    (void) fprintf(stderr, "Prescan: cannot map entry %s\n",
+                                           names[idx]);
+                    exit(1);
+                }
+                JEMCC_Free(data);
+                JEMCC_ReleaseZipFileEntry(NULL, zf, &entry);
+                JEMCC_CloseZipFile(NULL, zf);
+                return;
+            }
+            if (memcmp(mapData, data, sizes[idx]) != 0) {
+                (void) fprintf(stderr, "Prescan: invalid mapped data for %s\n",
+                                       names[idx]);
+                exit(1);
+            }
+            if ((isMapped == JNI_TRUE) && (entry.compressionMethod != 0)) {
+                (void) fprintf(stderr, "Prescan: compressed %s was mapped\n",
+                                       names[idx]);
+                exit(1);
+            }
             JEMCC_Free(data);
             JEMCC_ReleaseZipFileEntry(NULL, zf, &entry);
         }
 
+        /* Directory index, all entries are in the root */
+        if (JEMCC_ScanZipFileDirectory(NULL, zf, "nodir/", dirScanCB,
+                                       &count, JNI_FALSE) != JNI_EINVAL) {
+            (void) fprintf(stderr, "Error: scan of non-existent directory\n");
+            exit(1);
+        }
+        count = 0;
+        rc = JEMCC_ScanZipFileDirectory(NULL, zf, "", dirScanCB,
+                                        &count, JNI_FALSE);
+        if (rc != JNI_OK) {
+            if (fullsweep == JNI_TRUE) {
+                (void) fprintf(stderr, "Error: root directory scan failed\n");
+                exit(1);
+            }
+            JEMCC_CloseZipFile(NULL, zf);
+            return;
+        }
+        if (count != 0x7F) {
+            (void) fprintf(stderr, "Error: incomplete directory scan\n");
+            exit(1);
+        }
+
+        /* Full archive scan must see the same entry set */
+        count = 0;
+        rc = JEMCC_ScanZipFileEntries(NULL, zf, dirScanCB, &count, JNI_FALSE);
+        if (rc != JNI_OK) {
+            if (fullsweep == JNI_TRUE) {
+                (void) fprintf(stderr, "Error: archive entry scan failed\n");
+                exit(1);
+            }
+            JEMCC_CloseZipFile(NULL, zf);
+            return;
+        }
+        if (count != 0x7F) {
+            (void) fprintf(stderr, "Error: incomplete archive entry scan\n");
+            exit(1);
+        }
+
         JEMCC_CloseZipFile(NULL, zf);
     }
 }
@@ -697,6 +780,27 @@ void JEMCC_Free(void *block) {
     free(block);
 }
 
+/* Collection safe regions are not tracked without the collector */
+void JEM_GCEnterSafeRegion(JNIEnv *env) {
+}
+
+void JEM_GCLeaveSafeRegion(JNIEnv *env) {
+}
+
+jbyte *JEM_EnvScratchBuffer(JNIEnv *env, jsize length) {
+    static jbyte *scratchBuffer = NULL;
+    static jsize scratchLength = 0;
+    jbyte *newBuffer;
+
+    if (scratchLength >= length) return scratchBuffer;
+    if ((newBuffer = (jbyte *) JEMCC_Malloc(env, length)) == NULL) return NULL;
+    JEMCC_Free(scratchBuffer);
+    scratchBuffer = newBuffer;
+    scratchLength = length;
+
+    return scratchBuffer;
+}
+
 void JEMCC_ThrowStdThrowableIdx(JNIEnv *env, JEMCC_VMClassIndex idx,
                                 JEMCC_Object *causeThrowable, const char *msg) {
     char *className = "unknown";